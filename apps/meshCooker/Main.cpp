@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dart/dynamics/CookedMesh.h"
+
+/// Write a cooked copy of every mesh file given on the command line next to
+/// the file, so that MeshShape::loadMesh can skip the Assimp import. Meshes
+/// whose cooked copy is still up to date are skipped unless -f is given.
+int main(int argc, char* argv[])
+{
+  bool force = false;
+  std::vector<std::string> fileNames;
+  for(int i=1; i<argc; ++i)
+  {
+    if(std::string(argv[i])=="-f")
+      force = true;
+    else
+      fileNames.push_back(argv[i]);
+  }
+
+  if(fileNames.empty())
+  {
+    std::cout << "Usage: " << argv[0] << " [-f] mesh_file..." << std::endl;
+    return 1;
+  }
+
+  int numFailures = 0;
+  for(size_t i=0; i<fileNames.size(); ++i)
+  {
+    const std::string& fileName = fileNames[i];
+    std::string cookedFileName =
+        dart::dynamics::CookedMesh::getCookedFileName(fileName);
+
+    if(!force
+       && dart::dynamics::CookedMesh::isUpToDate(cookedFileName, fileName))
+    {
+      std::cout << "Up to date: " << cookedFileName << std::endl;
+      continue;
+    }
+
+    if(dart::dynamics::CookedMesh::cook(fileName))
+    {
+      std::cout << "Cooked: " << cookedFileName << std::endl;
+    }
+    else
+    {
+      std::cout << "Failed: " << fileName << std::endl;
+      ++numFailures;
+    }
+  }
+
+  return numFailures == 0 ? 0 : 1;
+}
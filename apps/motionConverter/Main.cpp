@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "dart/dynamics/Skeleton.h"
+#include "dart/utils/FileInfoC3D.h"
+#include "dart/utils/FileInfoDof.h"
+#include "dart/utils/FileInfoWorld.h"
+#include "dart/utils/SkelParser.h"
+
+void printUsage(const char* _program)
+{
+  std::cout << "Usage:\n"
+            << "  " << _program << " world recording.txt output_file\n"
+            << "  " << _program << " dof skeleton.skel motion.txt output_file\n"
+            << "  " << _program << " c3d markers.c3d output_file\n"
+            << "Converts FileInfoWorld, FileInfoDof and C3D files into the "
+            << "binary frame file format." << std::endl;
+}
+
+/// Convert the text formats of FileInfoWorld and FileInfoDof and C3D files
+/// into binary frame files (see dart::utils::FrameFileWriter)
+int main(int argc, char* argv[])
+{
+  if(argc < 2)
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::string type = argv[1];
+  bool result = false;
+
+  if(type == "world" && argc == 4)
+  {
+    dart::utils::FileInfoWorld file;
+    if(!file.loadFile(argv[2]))
+    {
+      std::cout << "Failed to read " << argv[2] << std::endl;
+      return 1;
+    }
+    result = file.saveBinaryFile(argv[3], file.getRecording());
+  }
+  else if(type == "dof" && argc == 5)
+  {
+    dart::dynamics::Skeleton* skel
+        = dart::utils::SkelParser::readSkeleton(argv[2]);
+    if(NULL == skel)
+    {
+      std::cout << "Failed to read " << argv[2] << std::endl;
+      return 1;
+    }
+
+    dart::utils::FileInfoDof file(skel);
+    if(!file.loadFile(argv[3]))
+    {
+      std::cout << "Failed to read " << argv[3] << " for the skeleton of "
+                << argv[2] << std::endl;
+      delete skel;
+      return 1;
+    }
+    result = file.saveBinaryFile(argv[4], 0, file.getNumFrames() - 1);
+    delete skel;
+  }
+  else if(type == "c3d" && argc == 4)
+  {
+    dart::utils::FileInfoC3D file;
+    if(!file.loadFile(argv[2]))
+    {
+      std::cout << "Failed to read " << argv[2] << std::endl;
+      return 1;
+    }
+    result = file.saveBinaryFile(argv[3], 0, file.getNumFrames() - 1);
+  }
+  else
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  if(!result)
+  {
+    std::cout << "Failed to write " << argv[argc-1] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << argv[argc-2] << " to " << argv[argc-1]
+            << std::endl;
+  return 0;
+}
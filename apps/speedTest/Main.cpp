@@ -36,14 +36,41 @@
  */
 
 #include <chrono>
+#include <cstdio>
+#include <limits>
 #include <numeric>
+#include <set>
+#include <thread>
 
 #include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/CompiledKinematics.h"
 #include "dart/dynamics/DegreeOfFreedom.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/FreeJoint.h"
 #include "dart/dynamics/Joint.h"
+#include "dart/dynamics/InverseKinematics.h"
+#include "dart/dynamics/MeshCache.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/RevoluteJoint.h"
+#include "dart/dynamics/WeldJoint.h"
+#include "dart/collision/RangeSensor.h"
+#include "dart/collision/SelfCollisionSampler.h"
+#include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/collision/fcl/FCLCollisionDetector.h"
+#include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
+#include "dart/constraint/ConstraintSolver.h"
+#include "dart/simulation/ParticleSystem.h"
+#include "dart/simulation/Recording.h"
 #include "dart/simulation/World.h"
+#include "dart/utils/BinaryParser.h"
+#include "dart/utils/FileInfoDof.h"
+#include "dart/utils/FileInfoWorld.h"
+#include "dart/utils/FrameFile.h"
 #include "dart/utils/SkelParser.h"
+#include "dart/utils/sdf/SdfParser.h"
 #include "dart/math/Helpers.h"
 #include "dart/config.h"
 
@@ -51,11 +78,14 @@ double testForwardKinematicSpeed(dart::dynamics::Skeleton* skel,
                                  bool position=true,
                                  bool velocity=true,
                                  bool acceleration=true,
+                                 bool compiled=false,
                                  size_t numTests=100000)
 {
   if(NULL==skel)
     return 0;
 
+  dart::dynamics::CompiledKinematics kinematics(skel);
+
   dart::dynamics::BodyNode* bn = skel->getBodyNode(0);
   while(bn->getNumChildBodyNodes() > 0)
     bn = bn->getChildBodyNode(0);
@@ -73,6 +103,12 @@ double testForwardKinematicSpeed(dart::dynamics::Skeleton* skel,
                           std::min(dof->getPositionUpperLimit(), 1.0)) );
     }
 
+    if(compiled)
+    {
+      kinematics.update(velocity, acceleration);
+      continue;
+    }
+
     for(size_t i=0; i<skel->getNumBodyNodes(); ++i)
     {
       if(position)
@@ -95,10 +131,13 @@ double testForwardKinematicSpeed(dart::dynamics::Skeleton* skel,
 
 void runKinematicsTest(std::vector<double>& results,
                        const std::vector<dart::simulation::World*>& worlds,
-                       bool position, bool velocity, bool acceleration)
+                       bool position, bool velocity, bool acceleration,
+                       bool compiled=false)
 {
   double totalTime = 0;
   std::cout << "Testing: ";
+  if(compiled)
+    std::cout << "(Compiled) ";
   if(position)
     std::cout << "Position ";
   if(velocity)
@@ -112,8 +151,87 @@ void runKinematicsTest(std::vector<double>& results,
   {
     dart::simulation::World* world = worlds[i];
     totalTime += testForwardKinematicSpeed(world->getSkeleton(0),
-                                        position, velocity, acceleration);
+                                        position, velocity, acceleration,
+                                        compiled);
+  }
+  results.push_back(totalTime);
+  std::cout << "Result: " << totalTime << "s" << std::endl;
+}
+
+enum StateUpdateMode
+{
+  PER_DOF,
+  PER_DOF_BATCHED,
+  WHOLE_VECTOR
+};
+
+double testStateUpdateSpeed(dart::dynamics::Skeleton* skel,
+                            StateUpdateMode mode,
+                            size_t numTests=100000)
+{
+  if(NULL==skel || skel->getNumDofs() == 0)
+    return 0;
+
+  dart::dynamics::BodyNode* bn = skel->getBodyNode(0);
+  while(bn->getNumChildBodyNodes() > 0)
+    bn = bn->getChildBodyNode(0);
+
+  Eigen::VectorXd q(skel->getNumDofs());
+  for(size_t i=0; i<skel->getNumDofs(); ++i)
+  {
+    dart::dynamics::DegreeOfFreedom* dof = skel->getDof(i);
+    q[i] = dart::math::random(std::max(dof->getPositionLowerLimit(),-1.0),
+                              std::min(dof->getPositionUpperLimit(), 1.0));
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numTests; ++i)
+  {
+    if(WHOLE_VECTOR == mode)
+    {
+      skel->setPositions(q);
+    }
+    else
+    {
+      if(PER_DOF_BATCHED == mode)
+        skel->beginStateUpdate();
+
+      // Visit the DOFs from the leaves up, so every change dirties a subtree
+      for(size_t j=skel->getNumDofs(); j-- > 0; )
+        skel->getDof(j)->setPosition(q[j]);
+
+      if(PER_DOF_BATCHED == mode)
+        skel->endStateUpdate();
+    }
+
+    // Clean the flags again so that the next iteration has to notify
+    bn->getWorldTransform();
   }
+
+  end = std::chrono::system_clock::now();
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runStateUpdateTest(std::vector<double>& results,
+                        const std::vector<dart::simulation::World*>& worlds,
+                        StateUpdateMode mode)
+{
+  double totalTime = 0;
+  std::cout << "Testing: ";
+  if(PER_DOF == mode)
+    std::cout << "Per-DOF setters\n";
+  else if(PER_DOF_BATCHED == mode)
+    std::cout << "Batched per-DOF setters\n";
+  else
+    std::cout << "Whole-vector setter\n";
+
+  for(size_t i=0; i<worlds.size(); ++i)
+    totalTime += testStateUpdateSpeed(worlds[i]->getSkeleton(0), mode);
+
   results.push_back(totalTime);
   std::cout << "Result: " << totalTime << "s" << std::endl;
 }
@@ -161,93 +279,1990 @@ void runDynamicsTest(std::vector<double>& results,
   std::cout << "Result: " << totalTime << "s" << std::endl;
 }
 
-void print_results(const std::vector<double>& result)
+double testInverseKinematicsSpeed(
+    const std::vector<dart::dynamics::Skeleton*>& workers,
+    bool batch, size_t numTargets=1000)
 {
-  double sum = std::accumulate(result.begin(), result.end(), 0.0);
-  double mean = sum/result.size();
-  std::cout << "Average: " << mean << "\n";
-  std::vector<double> diff(result.size());
-  std::transform(result.begin(), result.end(), diff.begin(),
-                 std::bind2nd(std::minus<double>(), mean));
-  double stddev = std::sqrt(std::inner_product(diff.begin(), diff.end(),
-                                        diff.begin(), 0.0)/result.size());
-  std::cout << "Std Dev: " << stddev << "\n";
+  dart::dynamics::Skeleton* skel = workers[0];
+  if(NULL==skel || skel->getNumDofs() == 0)
+    return 0;
+
+  dart::dynamics::BodyNode* bn = skel->getBodyNode(0);
+  while(bn->getNumChildBodyNodes() > 0)
+    bn = bn->getChildBodyNode(0);
+
+  // Sample reachable targets for the last BodyNode of the first chain
+  Eigen::VectorXd seed = skel->getPositions();
+  std::vector<Eigen::Isometry3d> targets;
+  for(size_t i=0; i<numTargets; ++i)
+  {
+    for(size_t j=0; j<skel->getNumDofs(); ++j)
+    {
+      dart::dynamics::DegreeOfFreedom* dof = skel->getDof(j);
+      dof->setPosition( dart::math::random(
+                          std::max(dof->getPositionLowerLimit(),-1.0),
+                          std::min(dof->getPositionUpperLimit(), 1.0)) );
+    }
+    targets.push_back(bn->getWorldTransform());
+  }
+  skel->setPositions(seed);
+
+  dart::dynamics::InverseKinematics ik(skel);
+  ik.addTarget(bn, Eigen::Isometry3d::Identity());
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  if(batch)
+  {
+    std::vector<Eigen::VectorXd> solutions;
+    ik.solveBatch(workers, targets, solutions);
+  }
+  else
+  {
+    for(size_t i=0; i<numTargets; ++i)
+    {
+      ik.setTargetTransform(0, targets[i]);
+      ik.solve(seed);
+    }
+  }
+
+  end = std::chrono::system_clock::now();
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
 }
 
-std::vector<std::string> getSceneFiles()
+void runInverseKinematicsTest(
+    std::vector<double>& results,
+    const std::vector<std::vector<dart::simulation::World*> >& workerWorlds,
+    bool batch)
 {
-  std::vector<std::string> scenes;
-  scenes.push_back(DART_DATA_PATH"skel/test/chainwhipa.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum_euler_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum_ball_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum_euler_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum_ball_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_revolute_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_eulerxyz_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint_20.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint_40.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure_euler_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure_ball_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure_euler_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure_ball_joint.skel");
-  scenes.push_back(DART_DATA_PATH"skel/fullbody1.skel");
+  double totalTime = 0;
+  std::cout << "Testing: " << (batch? "Batched" : "Serial") << "\n";
 
-  return scenes;
+  for(size_t i=0; i<workerWorlds[0].size(); ++i)
+  {
+    std::vector<dart::dynamics::Skeleton*> workers;
+    for(size_t j=0; j<workerWorlds.size(); ++j)
+      workers.push_back(workerWorlds[j][i]->getSkeleton(0));
+
+    totalTime += testInverseKinematicsSpeed(workers, batch);
+  }
+
+  results.push_back(totalTime);
+  std::cout << "Result: " << totalTime << "s" << std::endl;
 }
 
-std::vector<dart::simulation::World*> getWorlds()
+size_t computeMeshMemory(const aiScene* _mesh)
 {
-  std::vector<std::string> sceneFiles = getSceneFiles();
-  std::vector<dart::simulation::World*> worlds;
-  for(size_t i=0; i<sceneFiles.size(); ++i)
+  size_t bytes = sizeof(aiScene);
+  for(size_t i=0; i<_mesh->mNumMeshes; ++i)
   {
-    worlds.push_back(dart::utils::SkelParser::readWorld(sceneFiles[i]));
+    const aiMesh* mesh = _mesh->mMeshes[i];
+    size_t numArrays = 1;
+    if(mesh->mNormals)
+      ++numArrays;
+    bytes += sizeof(aiMesh) + numArrays*mesh->mNumVertices*sizeof(aiVector3D);
+    for(size_t j=0; j<mesh->mNumFaces; ++j)
+      bytes += sizeof(aiFace)
+               + mesh->mFaces[j].mNumIndices*sizeof(unsigned int);
   }
+  return bytes;
+}
 
-  return worlds;
+double testMeshLoadingSpeed(size_t& numImports, size_t& meshMemory,
+                            size_t numCopies=10)
+{
+  size_t startImports = dart::dynamics::MeshCache::getNumImports();
+  std::vector<dart::dynamics::Skeleton*> skels;
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numCopies; ++i)
+    skels.push_back(dart::utils::SdfParser::readSkeleton(
+                      DART_DATA_PATH"sdf/atlas/atlas_v3_no_head.sdf"));
+
+  end = std::chrono::system_clock::now();
+
+  numImports = dart::dynamics::MeshCache::getNumImports() - startImports;
+
+  // Count every distinct mesh that is alive while all the copies are loaded
+  std::set<const aiScene*> meshes;
+  for(size_t i=0; i<skels.size(); ++i)
+  {
+    for(size_t j=0; j<skels[i]->getNumBodyNodes(); ++j)
+    {
+      dart::dynamics::BodyNode* bn = skels[i]->getBodyNode(j);
+      for(size_t k=0; k<bn->getNumVisualizationShapes(); ++k)
+      {
+        dart::dynamics::MeshShape* shape =
+            dynamic_cast<dart::dynamics::MeshShape*>(
+              bn->getVisualizationShape(k));
+        if(shape && shape->getMesh())
+          meshes.insert(shape->getMesh());
+      }
+      for(size_t k=0; k<bn->getNumCollisionShapes(); ++k)
+      {
+        dart::dynamics::MeshShape* shape =
+            dynamic_cast<dart::dynamics::MeshShape*>(
+              bn->getCollisionShape(k));
+        if(shape && shape->getMesh())
+          meshes.insert(shape->getMesh());
+      }
+    }
+  }
+
+  meshMemory = 0;
+  for(std::set<const aiScene*>::iterator it = meshes.begin();
+      it != meshes.end(); ++it)
+    meshMemory += computeMeshMemory(*it);
+
+  for(size_t i=0; i<skels.size(); ++i)
+    delete skels[i];
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
 }
 
-int main(int argc, char* argv[])
+void runMeshLoadingTest(std::vector<double>& results, bool cached)
 {
-  bool test_kinematics = false;
-  for(int i=1; i<argc; ++i)
+  std::cout << "Testing: " << (cached? "Cached" : "Uncached") << "\n";
+
+  dart::dynamics::MeshCache::setEnabled(cached);
+  size_t numImports = 0;
+  size_t meshMemory = 0;
+  double time = testMeshLoadingSpeed(numImports, meshMemory);
+  dart::dynamics::MeshCache::setEnabled(true);
+
+  results.push_back(time);
+  std::cout << "Result: " << time << "s, " << numImports << " imports, "
+            << meshMemory/1024 << " KiB of mesh data" << std::endl;
+}
+
+double testParallelLoadingSpeed(size_t numThreads)
+{
+  dart::dynamics::MeshCache::setNumLoadingThreads(numThreads);
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  dart::dynamics::Skeleton* atlas = dart::utils::SdfParser::readSkeleton(
+        DART_DATA_PATH"sdf/atlas/atlas_v3_no_head.sdf");
+  dart::simulation::World* fullbody = dart::utils::SkelParser::readWorld(
+        DART_DATA_PATH"skel/fullbody1.skel");
+
+  end = std::chrono::system_clock::now();
+
+  // Deleting both releases every mesh, so the next trial starts cold
+  delete atlas;
+  delete fullbody;
+  dart::dynamics::MeshCache::setNumLoadingThreads(1);
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runParallelLoadingTest(std::vector<double>& results, size_t numThreads)
+{
+  std::cout << "Testing: " << numThreads << " loading thread(s)\n";
+  double time = testParallelLoadingSpeed(numThreads);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+enum RecordingFormat
+{
+  WORLD_TEXT,
+  WORLD_BINARY,
+  WORLD_STREAM,
+  DOF_TEXT,
+  DOF_BINARY
+};
+
+double testRecordingLoadingSpeed(dart::dynamics::Skeleton* skel,
+                                 RecordingFormat format)
+{
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  if(WORLD_TEXT == format)
   {
-    if(std::string(argv[i])=="-k")
-      test_kinematics = true;
+    dart::utils::FileInfoWorld file;
+    file.loadFile("speedTest_recording.txt");
+  }
+  else if(WORLD_BINARY == format)
+  {
+    dart::utils::FileInfoWorld file;
+    file.loadBinaryFile("speedTest_recording.bin");
+  }
+  else if(WORLD_STREAM == format)
+  {
+    // Visit every frame without holding more than one in memory
+    dart::utils::FrameFileReader reader;
+    reader.open("speedTest_recording.bin");
+    Eigen::VectorXd state;
+    double sum = 0.0;
+    while(reader.next(state))
+      sum += state.sum();
+    if(sum == 0.0)
+      std::cout << "(all states are zero)\n";
+  }
+  else if(DOF_TEXT == format)
+  {
+    dart::utils::FileInfoDof file(skel);
+    file.loadFile("speedTest_motion.txt");
+  }
+  else
+  {
+    dart::utils::FileInfoDof file(skel);
+    file.loadBinaryFile("speedTest_motion.bin");
   }
 
-  std::vector<dart::simulation::World*> worlds = getWorlds();
+  end = std::chrono::system_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
 
-  if(test_kinematics)
+void runRecordingLoadingTest(std::vector<double>& results,
+                             dart::dynamics::Skeleton* skel,
+                             RecordingFormat format)
+{
+  const char* names[] = { "World text", "World binary", "World streaming",
+                          "Dof text", "Dof binary" };
+  std::cout << "Testing: " << names[format] << "\n";
+  double time = testRecordingLoadingSpeed(skel, format);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+dart::dynamics::Skeleton* createBox(size_t index,
+                                    const Eigen::Vector3d& position)
+{
+  dart::dynamics::Skeleton* skel =
+      new dart::dynamics::Skeleton("box_" + std::to_string(index));
+  dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode("box_link");
+  dart::dynamics::FreeJoint* joint =
+      new dart::dynamics::FreeJoint("box_joint");
+  dart::dynamics::BoxShape* shape =
+      new dart::dynamics::BoxShape(Eigen::Vector3d::Constant(0.1));
+
+  bn->addVisualizationShape(shape);
+  bn->addCollisionShape(shape);
+  bn->setParentJoint(joint);
+
+  joint->setTransformFromParentBodyNode(
+        Eigen::Isometry3d(Eigen::Translation3d(position)));
+  skel->addBodyNode(bn);
+
+  return skel;
+}
+
+Eigen::Vector3d getGridPosition(size_t index)
+{
+  // Spread the boxes on a grid so that they fall without touching
+  return Eigen::Vector3d(0.5*(index%20), 0.5*((index/20)%20), 1.0);
+}
+
+double testChurnSpeed(bool queued, size_t numSkeletons = 200,
+                      size_t numSteps = 1000, size_t changesPerStep = 10)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+  world->setGravity(Eigen::Vector3d::Zero());
+  for(size_t i=0; i<numSkeletons; ++i)
+    world->addSkeleton(createBox(i, getGridPosition(i)));
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  // Retire random skeletons and spawn the same number of new ones every step
+  size_t numCreated = numSkeletons;
+  for(size_t i=0; i<numSteps; ++i)
   {
-    std::cout << "Testing Kinematics" << std::endl;
-    std::vector<double> acceleration_results;
-    std::vector<double> velocity_results;
-    std::vector<double> position_results;
+    // Consecutive indices never name the same skeleton twice within a step
+    size_t offset = static_cast<size_t>(dart::math::random(0, numSkeletons));
+    for(size_t j=0; j<changesPerStep; ++j)
+    {
+      dart::dynamics::Skeleton* retired =
+          world->getSkeleton((offset + j) % numSkeletons);
+      dart::dynamics::Skeleton* spawned =
+          createBox(numCreated, getGridPosition(numCreated));
+      ++numCreated;
+      if(queued)
+      {
+        world->queueRemoveSkeleton(retired);
+        world->queueAddSkeleton(spawned);
+      }
+      else
+      {
+        world->removeSkeleton(retired);
+        world->addSkeleton(spawned);
+      }
+    }
 
-    for(size_t i=0; i<10; ++i)
+    world->step();
+  }
+
+  end = std::chrono::system_clock::now();
+
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return 2*numSteps*changesPerStep/elapsed_seconds.count();
+}
+
+void runChurnTest(std::vector<double>& results, bool queued)
+{
+  std::cout << "Testing: " << (queued? "Queued" : "Immediate")
+            << " changes\n";
+  double rate = testChurnSpeed(queued);
+  results.push_back(rate);
+  std::cout << "Result: " << rate << " adds/removes per second" << std::endl;
+}
+
+enum CollisionDetectorType
+{
+  DART_DETECTOR,
+  FCL_MESH_DETECTOR,
+  FCL_DETECTOR
+};
+
+double testCollisionSpeed(CollisionDetectorType type, size_t numBoxes = 500,
+                          size_t numTests = 200)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+  dart::collision::CollisionDetector* detector;
+  if(DART_DETECTOR == type)
+    detector = new dart::collision::DARTCollisionDetector;
+  else if(FCL_MESH_DETECTOR == type)
+    detector = new dart::collision::FCLMeshCollisionDetector;
+  else
+    detector = new dart::collision::FCLCollisionDetector;
+  world->getConstraintSolver()->setCollisionDetector(detector);
+
+  // Pairs of overlapping boxes on a grid, so that half of the boxes touch
+  for(size_t i=0; i<numBoxes; ++i)
+  {
+    Eigen::Vector3d position = getGridPosition(i/2);
+    position[0] += 0.05*(i%2);
+    world->addSkeleton(createBox(i, position));
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  // Move one box of every pair while the others rest
+  size_t numContacts = 0;
+  for(size_t i=0; i<numTests; ++i)
+  {
+    for(size_t j=1; j<world->getNumSkeletons(); j+=2)
     {
-      std::cout << "\nTrial #" << i+1 << std::endl;
-      runKinematicsTest(acceleration_results, worlds, true, true, true);
-      runKinematicsTest(velocity_results, worlds, true, true, false);
-      runKinematicsTest(position_results, worlds, true, false, false);
+      Eigen::VectorXd q = Eigen::VectorXd::Zero(6);
+      q.tail<3>() = 0.01*Eigen::Vector3d::Random();
+      world->getSkeleton(j)->setPositions(q);
     }
 
-    std::cout << "\n\n --- Final Kinematics Results --- \n\n";
+    detector->detectCollision(true, true);
+    numContacts += detector->getNumContacts();
+  }
 
-    std::cout << "Position, Velocity, Acceleration\n";
-    print_results(acceleration_results);
+  end = std::chrono::system_clock::now();
 
-    std::cout << "\nPosition, Velocity\n";
-    print_results(velocity_results);
+  std::cout << "Contacts per test: " << numContacts/numTests << "\n";
+  delete world;
 
-    std::cout << "\nPosition\n";
-    print_results(position_results);
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runCollisionTest(std::vector<double>& results,
+                      CollisionDetectorType type)
+{
+  const char* names[] = { "DART", "FCL mesh (all pairs)",
+                          "FCL (dynamic AABB tree)" };
+  std::cout << "Testing: " << names[type] << "\n";
+  double time = testCollisionSpeed(type);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+double testBulletSpeed(bool bullet, size_t numSteps = 5000)
+{
+  // The world file asks for the Bullet collision detector
+  dart::simulation::World* world = dart::utils::SkelParser::readWorld(
+        DART_DATA_PATH"skel/bullet_collision.skel");
+  if(!bullet)
+  {
+    world->getConstraintSolver()->setCollisionDetector(
+          new dart::collision::FCLMeshCollisionDetector);
+  }
+  dart::collision::CollisionDetector* detector =
+      world->getConstraintSolver()->getCollisionDetector();
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  // Count the contacts that were already reported in the previous step
+  std::set<size_t> previousIds;
+  std::set<size_t> currentIds;
+  size_t numContacts = 0;
+  size_t numPersistent = 0;
+  for(size_t i=0; i<numSteps; ++i)
+  {
+    world->step();
+
+    currentIds.clear();
+    for(size_t j=0; j<detector->getNumContacts(); ++j)
+    {
+      size_t id = detector->getContact(j).id;
+      if(id == 0)
+        continue;
+      currentIds.insert(id);
+      numPersistent += previousIds.count(id);
+    }
+    numContacts += detector->getNumContacts();
+    previousIds.swap(currentIds);
+  }
+
+  end = std::chrono::system_clock::now();
+
+  std::cout << "Contacts per step: " << numContacts/numSteps
+            << " (" << numPersistent/numSteps << " kept from the last step)\n";
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runBulletTest(std::vector<double>& results, bool bullet)
+{
+  std::cout << "Testing: " << (bullet? "Bullet" : "FCL mesh") << "\n";
+  double time = testBulletSpeed(bullet);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+aiScene* createBoxMesh(const Eigen::Vector3d& size)
+{
+  aiScene* scene = new aiScene;
+  scene->mNumMeshes = 1;
+  scene->mMeshes = new aiMesh*[1];
+  aiMesh* mesh = new aiMesh;
+  scene->mMeshes[0] = mesh;
+
+  mesh->mNumVertices = 8;
+  mesh->mVertices = new aiVector3D[8];
+  for(unsigned int i=0; i<8; ++i)
+  {
+    mesh->mVertices[i].Set((i&1)? 0.5*size[0] : -0.5*size[0],
+                           (i&2)? 0.5*size[1] : -0.5*size[1],
+                           (i&4)? 0.5*size[2] : -0.5*size[2]);
+  }
+
+  // Two counterclockwise triangles for each side
+  const unsigned int quads[6][4] = { {0, 2, 3, 1}, {4, 5, 7, 6},
+                                     {0, 1, 5, 4}, {2, 6, 7, 3},
+                                     {0, 4, 6, 2}, {1, 3, 7, 5} };
+  mesh->mNumFaces = 12;
+  mesh->mFaces = new aiFace[12];
+  for(unsigned int i=0; i<12; ++i)
+  {
+    aiFace& face = mesh->mFaces[i];
+    face.mNumIndices = 3;
+    face.mIndices = new unsigned int[3];
+    face.mIndices[0] = quads[i/2][0];
+    face.mIndices[1] = quads[i/2][i%2 + 1];
+    face.mIndices[2] = quads[i/2][i%2 + 2];
+  }
+
+  return scene;
+}
+
+enum ConvexMeshMode
+{
+  FCL_MESH_TRIANGLES,
+  FCL_MESH_CONVEX,
+  DART_CONVEX
+};
+
+double testConvexMeshSpeed(ConvexMeshMode mode, size_t numSteps = 5000)
+{
+  dart::simulation::World* boxes = dart::utils::SkelParser::readWorld(
+        DART_DATA_PATH"skel/mesh_collision.skel");
+
+  dart::simulation::World* world = new dart::simulation::World;
+  world->setTimeStep(boxes->getTimeStep());
+  world->setGravity(boxes->getGravity());
+  if(DART_CONVEX == mode)
+  {
+    dart::collision::DARTCollisionDetector* detector =
+        new dart::collision::DARTCollisionDetector;
+    detector->setConvexMeshCollision(true);
+    world->getConstraintSolver()->setCollisionDetector(detector);
+  }
+  else
+  {
+    dart::collision::FCLMeshCollisionDetector* detector =
+        new dart::collision::FCLMeshCollisionDetector;
+    detector->setConvexMeshCollision(FCL_MESH_CONVEX == mode);
+    world->getConstraintSolver()->setCollisionDetector(detector);
+  }
+
+  // The scene only has boxes, so rebuild every body with a triangle mesh of
+  // its box
+  for(size_t i=0; i<boxes->getNumSkeletons(); ++i)
+  {
+    dart::dynamics::BodyNode* box = boxes->getSkeleton(i)->getBodyNode(0);
+    const dart::dynamics::BoxShape* boxShape =
+        static_cast<const dart::dynamics::BoxShape*>(
+          box->getCollisionShape(0));
+
+    dart::dynamics::Skeleton* skel =
+        new dart::dynamics::Skeleton(boxes->getSkeleton(i)->getName());
+    dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode(box->getName());
+    dart::dynamics::MeshShape* shape = new dart::dynamics::MeshShape(
+          Eigen::Vector3d::Ones(), createBoxMesh(boxShape->getSize()));
+    bn->addVisualizationShape(shape);
+    bn->addCollisionShape(shape);
+
+    double Ixx, Iyy, Izz, Ixy, Ixz, Iyz;
+    box->getMomentOfInertia(Ixx, Iyy, Izz, Ixy, Ixz, Iyz);
+    bn->setMass(box->getMass());
+    bn->setMomentOfInertia(Ixx, Iyy, Izz, Ixy, Ixz, Iyz);
+
+    dart::dynamics::Joint* joint;
+    if(box->getParentJoint()->getNumDofs() == 0)
+      joint = new dart::dynamics::WeldJoint;
+    else
+      joint = new dart::dynamics::FreeJoint;
+    joint->setTransformFromParentBodyNode(box->getTransform());
+    bn->setParentJoint(joint);
+    skel->addBodyNode(bn);
+
+    world->addSkeleton(skel);
+  }
+  delete boxes;
+
+  dart::collision::CollisionDetector* detector =
+      world->getConstraintSolver()->getCollisionDetector();
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  size_t numContacts = 0;
+  for(size_t i=0; i<numSteps; ++i)
+  {
+    world->step();
+    numContacts += detector->getNumContacts();
+  }
+
+  end = std::chrono::system_clock::now();
+
+  std::cout << "Contacts per step: "
+            << static_cast<double>(numContacts)/numSteps << "\n";
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runConvexMeshTest(std::vector<double>& results, ConvexMeshMode mode)
+{
+  const char* names[] = { "FCL mesh (triangles)", "FCL mesh (convex)",
+                          "DART (convex)" };
+  std::cout << "Testing: " << names[mode] << "\n";
+  double time = testConvexMeshSpeed(mode);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+double testRayCastSpeed(bool parallel, size_t numScans = 50)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+
+  // Boxes at three heights on the grid, every other one with a mesh cube on
+  // top, and a floor under them
+  dart::dynamics::MeshShape mesh(Eigen::Vector3d::Ones(),
+                                 createBoxMesh(Eigen::Vector3d::Constant(0.1)));
+  for(size_t i=0; i<400; ++i)
+  {
+    Eigen::Vector3d position = getGridPosition(i);
+    position[2] = 0.5*(i%3);
+    dart::dynamics::Skeleton* skel = createBox(i, position);
+    if(i%2 == 1)
+    {
+      dart::dynamics::Shape* shape = mesh.clone();
+      shape->setOffset(Eigen::Vector3d(0.0, 0.0, 0.1));
+      skel->getBodyNode(0)->addCollisionShape(shape);
+    }
+    world->addSkeleton(skel);
+  }
+
+  dart::dynamics::Skeleton* floor = new dart::dynamics::Skeleton("floor");
+  dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode("floor_link");
+  bn->addCollisionShape(
+        new dart::dynamics::PlaneShape(Eigen::Vector3d::UnitZ(), -0.1));
+  bn->setParentJoint(new dart::dynamics::WeldJoint);
+  floor->addBodyNode(bn);
+  world->addSkeleton(floor);
+
+  dart::collision::RayCaster caster;
+  caster.setParallel(parallel);
+  for(size_t i=0; i<world->getNumSkeletons(); ++i)
+    caster.addSkeleton(world->getSkeleton(i));
+  caster.update();
+
+  // A spinning lidar in the middle of the grid
+  dart::collision::Lidar lidar(2048, 64, 2.0*DART_PI, 0.5, 20.0);
+  const Eigen::Isometry3d transform(
+        Eigen::Translation3d(4.75, 4.75, 0.25));
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  size_t numHits = 0;
+  for(size_t i=0; i<numScans; ++i)
+    numHits += lidar.scan(caster, transform);
+
+  end = std::chrono::system_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end-start;
+
+  const double numRays = static_cast<double>(numScans)
+      * lidar.getDirections().size();
+  std::cout << "Hits per scan: " << numHits/numScans << "\n";
+  std::cout << "Rays per second: " << numRays/elapsed_seconds.count()
+            << "\n";
+  delete world;
+
+  return elapsed_seconds.count();
+}
+
+void runRayCastTest(std::vector<double>& results, bool parallel)
+{
+  std::cout << "Testing: " << (parallel? "Parallel" : "Serial") << "\n";
+  double time = testRayCastSpeed(parallel);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+enum DistanceMode
+{
+  DISTANCE_COLD,
+  DISTANCE_WARM,
+  DISTANCE_THRESHOLD
+};
+
+dart::dynamics::Skeleton* createArm(size_t numLinks)
+{
+  dart::dynamics::Skeleton* arm = new dart::dynamics::Skeleton("arm");
+  dart::dynamics::BodyNode* parent = NULL;
+  for(size_t i=0; i<numLinks; ++i)
+  {
+    const std::string suffix = "_" + std::to_string(i);
+    dart::dynamics::BodyNode* bn =
+        new dart::dynamics::BodyNode("link" + suffix);
+    dart::dynamics::BoxShape* shape =
+        new dart::dynamics::BoxShape(Eigen::Vector3d(0.08, 0.08, 0.3));
+    shape->setOffset(Eigen::Vector3d(0.0, 0.0, 0.15));
+    bn->addVisualizationShape(shape);
+    bn->addCollisionShape(shape);
+
+    // Alternate yaw and pitch joints, one link length apart
+    dart::dynamics::RevoluteJoint* joint = new dart::dynamics::RevoluteJoint(
+          i%2 == 0? Eigen::Vector3d::UnitZ() : Eigen::Vector3d::UnitY(),
+          "joint" + suffix);
+    if(parent)
+    {
+      joint->setTransformFromParentBodyNode(
+            Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.0, 0.3)));
+    }
+    bn->setParentJoint(joint);
+    if(parent)
+      parent->addChildBodyNode(bn);
+    arm->addBodyNode(bn);
+    parent = bn;
+  }
+
+  return arm;
+}
+
+double testDistanceSpeed(DistanceMode mode, size_t numSteps = 2000)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+
+  // A 7-DOF arm among boxes scattered around it, the same in every mode
+  dart::dynamics::Skeleton* arm = createArm(7);
+  world->addSkeleton(arm);
+  srand(0);
+  for(size_t i=0; i<300; ++i)
+  {
+    const double angle = dart::math::random(0.0, 2.0*DART_PI);
+    const double radius = dart::math::random(0.8, 2.5);
+    world->addSkeleton(createBox(i, Eigen::Vector3d(
+        radius*std::cos(angle), radius*std::sin(angle),
+        dart::math::random(0.0, 2.0))));
+  }
+
+  dart::collision::DARTCollisionDetector detector;
+  for(size_t i=0; i<world->getNumSkeletons(); ++i)
+    detector.addSkeleton(world->getSkeleton(i));
+
+  const double threshold = DISTANCE_THRESHOLD == mode?
+        0.05 : std::numeric_limits<double>::infinity();
+
+  std::chrono::duration<double> elapsed_seconds(0.0);
+  double sumDistances = 0.0;
+  Eigen::VectorXd q(arm->getNumDofs());
+  for(size_t i=0; i<numSteps; ++i)
+  {
+    // Sweep the arm slowly through the clutter
+    for(size_t j=0; j<arm->getNumDofs(); ++j)
+      q[j] = std::sin(0.002*i + j);
+    arm->setPositions(q);
+    arm->computeForwardKinematics(true, false, false);
+
+    // Adding the arm again drops the cached directions of its shapes
+    if(DISTANCE_COLD == mode)
+    {
+      detector.removeSkeleton(arm);
+      detector.addSkeleton(arm);
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sumDistances += std::min(detector.computeDistance(arm, NULL, threshold),
+                             threshold);
+    end = std::chrono::system_clock::now();
+    elapsed_seconds += end-start;
+  }
+
+  std::cout << "Average distance: " << sumDistances/numSteps << "\n";
+  std::cout << "Queries per second: " << numSteps/elapsed_seconds.count()
+            << "\n";
+  detector.removeAllSkeletons();
+  delete world;
+
+  return elapsed_seconds.count();
+}
+
+void runDistanceTest(std::vector<double>& results, DistanceMode mode)
+{
+  const char* names[] = { "Cold start", "Warm start",
+                          "Warm start with threshold" };
+  std::cout << "Testing: " << names[mode] << "\n";
+  double time = testDistanceSpeed(mode);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+// Time steps compared by the continuous collision detection test
+const double ccdTimeSteps[] = { 0.0005, 0.001, 0.002, 0.005, 0.01 };
+
+double testCCDSpeed(bool ccd, double timeStep, size_t& numTunneled)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+  world->setTimeStep(timeStep);
+
+  // A thin shelf with small balls thrown down at it
+  dart::dynamics::Skeleton* shelf = new dart::dynamics::Skeleton("shelf");
+  dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode("shelf_link");
+  bn->addCollisionShape(
+        new dart::dynamics::BoxShape(Eigen::Vector3d(20.0, 20.0, 0.02)));
+  bn->setParentJoint(new dart::dynamics::WeldJoint);
+  shelf->addBodyNode(bn);
+  world->addSkeleton(shelf);
+
+  std::vector<dart::dynamics::BodyNode*> balls;
+  for(size_t i=0; i<100; ++i)
+  {
+    dart::dynamics::Skeleton* skel =
+        new dart::dynamics::Skeleton("ball_" + std::to_string(i));
+    dart::dynamics::BodyNode* ball =
+        new dart::dynamics::BodyNode("ball_link");
+    ball->addCollisionShape(
+          new dart::dynamics::EllipsoidShape(Eigen::Vector3d::Constant(0.1)));
+    ball->setParentJoint(new dart::dynamics::FreeJoint);
+    ball->setCCDEnabled(ccd);
+    skel->addBodyNode(ball);
+    world->addSkeleton(skel);
+
+    Eigen::Vector6d q = Eigen::Vector6d::Zero();
+    Eigen::Vector6d dq = Eigen::Vector6d::Zero();
+    q.tail<3>() = getGridPosition(i) - Eigen::Vector3d(2.5, 2.5, 0.0);
+    q[5] = 0.5 + 0.01*i;
+    dq[5] = -20.0;
+    skel->setPositions(q);
+    skel->setVelocities(dq);
+    balls.push_back(ball);
+  }
+
+  // One second of simulation
+  const size_t numSteps = static_cast<size_t>(1.0/timeStep + 0.5);
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numSteps; ++i)
+    world->step();
+
+  end = std::chrono::system_clock::now();
+
+  numTunneled = 0;
+  for(size_t i=0; i<balls.size(); ++i)
+  {
+    if(balls[i]->getWorldTransform().translation()[2] < 0.0)
+      ++numTunneled;
+  }
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count()/numSteps;
+}
+
+void runCCDTest(std::vector<double>& results,
+                std::vector<size_t>& tunneled, bool ccd)
+{
+  std::cout << "Testing: " << (ccd? "CCD" : "Discrete") << "\n";
+  for(size_t i=0; i<results.size(); ++i)
+  {
+    size_t numTunneled;
+    double time = testCCDSpeed(ccd, ccdTimeSteps[i], numTunneled);
+    results[i] += time;
+    tunneled[i] = numTunneled;
+    std::cout << "Time step " << ccdTimeSteps[i] << "s: " << numTunneled
+              << " tunneled, " << time << "s per step\n";
+  }
+}
+
+double testSelfCollisionSamplingSpeed(dart::dynamics::Skeleton* skel,
+                                      bool parallel)
+{
+  dart::collision::SelfCollisionSampler sampler(skel);
+  sampler.setNumSamples(2000);
+  sampler.setParallel(parallel);
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  sampler.sample();
+
+  end = std::chrono::system_clock::now();
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runSelfCollisionSamplingTest(std::vector<double>& results,
+                                  dart::dynamics::Skeleton* skel,
+                                  bool parallel)
+{
+  std::cout << "Testing: " << (parallel? "Parallel" : "Serial")
+            << " sampling\n";
+  double time = testSelfCollisionSamplingSpeed(skel, parallel);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+double testSelfCollisionSpeed(dart::dynamics::Skeleton* skel,
+                              size_t numPoses = 1000)
+{
+  dart::collision::DARTCollisionDetector detector;
+  detector.addSkeleton(skel);
+
+  std::vector<Eigen::VectorXd> poses;
+  for(size_t i=0; i<numPoses; ++i)
+  {
+    Eigen::VectorXd q(skel->getNumDofs());
+    for(size_t j=0; j<skel->getNumDofs(); ++j)
+    {
+      const dart::dynamics::DegreeOfFreedom* dof = skel->getDof(j);
+      q[j] = dart::math::random(
+            std::max(dof->getPositionLowerLimit(), -DART_PI),
+            std::min(dof->getPositionUpperLimit(), DART_PI));
+    }
+    poses.push_back(q);
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numPoses; ++i)
+  {
+    skel->setPositions(poses[i]);
+    detector.detectCollision(true, false);
+  }
+
+  end = std::chrono::system_clock::now();
+
+  detector.removeAllSkeletons();
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count()/numPoses;
+}
+
+void runSelfCollisionTest(std::vector<double>& results,
+                          dart::dynamics::Skeleton* skel, bool pruned)
+{
+  std::cout << "Testing: " << (pruned? "Pruned" : "All") << " pairs\n";
+  double time = testSelfCollisionSpeed(skel);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s per pose" << std::endl;
+}
+
+dart::dynamics::Skeleton* createBin()
+{
+  // A 2 m wide floor, whose top is at z = 0, with four 3 m high walls
+  dart::dynamics::Skeleton* bin = new dart::dynamics::Skeleton("bin");
+  dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode("bin_link");
+  const Eigen::Vector3d sizes[] = { Eigen::Vector3d(2.2, 2.2, 0.1),
+                                    Eigen::Vector3d(0.1, 2.2, 3.0),
+                                    Eigen::Vector3d(0.1, 2.2, 3.0),
+                                    Eigen::Vector3d(2.2, 0.1, 3.0),
+                                    Eigen::Vector3d(2.2, 0.1, 3.0) };
+  const Eigen::Vector3d offsets[] = { Eigen::Vector3d(0.0, 0.0, -0.05),
+                                      Eigen::Vector3d(-1.05, 0.0, 1.5),
+                                      Eigen::Vector3d(1.05, 0.0, 1.5),
+                                      Eigen::Vector3d(0.0, -1.05, 1.5),
+                                      Eigen::Vector3d(0.0, 1.05, 1.5) };
+  for(size_t i=0; i<5; ++i)
+  {
+    dart::dynamics::BoxShape* shape = new dart::dynamics::BoxShape(sizes[i]);
+    shape->setOffset(offsets[i]);
+    bn->addCollisionShape(shape);
+  }
+  bn->setParentJoint(new dart::dynamics::WeldJoint);
+  bin->addBodyNode(bn);
+
+  return bin;
+}
+
+Eigen::Vector3d getParticlePosition(size_t index)
+{
+  // Layers of 15x15 spheres with some space between them
+  return Eigen::Vector3d(-0.84 + 0.12*(index%15), -0.84 + 0.12*((index/15)%15),
+                         0.06 + 0.12*(index/225));
+}
+
+double testParticleSpeed(bool particles, bool box, size_t numBodies,
+                         size_t numSteps = 500)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+  world->getConstraintSolver()->setCollisionDetector(
+        new dart::collision::DARTCollisionDetector);
+  world->addSkeleton(createBin());
+
+  const double radius = 0.05;
+  if(particles)
+  {
+    dart::simulation::ParticleSystem* system =
+        new dart::simulation::ParticleSystem;
+    for(size_t i=0; i<numBodies; ++i)
+      system->addParticle(getParticlePosition(i), radius, 0.1);
+    world->addParticleSystem(system);
+  }
+  else
+  {
+    for(size_t i=0; i<numBodies; ++i)
+    {
+      dart::dynamics::Skeleton* skel =
+          new dart::dynamics::Skeleton("sphere_" + std::to_string(i));
+      dart::dynamics::BodyNode* bn =
+          new dart::dynamics::BodyNode("sphere_link");
+      bn->addCollisionShape(new dart::dynamics::EllipsoidShape(
+                              Eigen::Vector3d::Constant(2.0*radius)));
+      bn->setMass(0.1);
+      bn->setParentJoint(new dart::dynamics::FreeJoint);
+      skel->addBodyNode(bn);
+      world->addSkeleton(skel);
+
+      Eigen::Vector6d q = Eigen::Vector6d::Zero();
+      q.tail<3>() = getParticlePosition(i);
+      skel->setPositions(q);
+    }
+  }
+
+  // A heavy box dropped on the spheres
+  if(box)
+  {
+    dart::dynamics::Skeleton* skel = createBox(0, Eigen::Vector3d(
+          0.0, 0.0, getParticlePosition(numBodies)[2] + 0.3));
+    dart::dynamics::BodyNode* bn = skel->getBodyNode(0);
+    dart::dynamics::BoxShape* shape = static_cast<dart::dynamics::BoxShape*>(
+          bn->getCollisionShape(0));
+    shape->setSize(Eigen::Vector3d(0.6, 0.6, 0.2));
+    bn->setMass(5.0);
+    world->addSkeleton(skel);
+  }
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numSteps; ++i)
+    world->step();
+
+  end = std::chrono::system_clock::now();
+
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return numBodies*numSteps/(1000.0*elapsed_seconds.count());
+}
+
+void runParticleTest(std::vector<double>& results, bool particles, bool box,
+                     size_t numBodies)
+{
+  std::cout << "Testing: " << numBodies
+            << (particles? " particles" : " skeletons")
+            << (box? " with a box" : "") << "\n";
+  double bodiesPerMs = testParticleSpeed(particles, box, numBodies);
+  results.push_back(bodiesPerMs);
+  std::cout << "Result: " << bodiesPerMs << " bodies per ms" << std::endl;
+}
+
+enum SubSteppingMode
+{
+  UNIFORM_FINE,
+  UNIFORM_COARSE,
+  MULTI_RATE
+};
+
+double testSubSteppingSpeed(SubSteppingMode mode,
+                            Eigen::VectorXd& armPositions)
+{
+  // A stiff arm that needs small time steps, next to clutter that does not
+  const double timeStep = mode == UNIFORM_FINE? 0.0002 : 0.002;
+  dart::simulation::World* world = new dart::simulation::World;
+  world->getConstraintSolver()->setCollisionDetector(
+        new dart::collision::DARTCollisionDetector);
+  world->setTimeStep(timeStep);
+
+  dart::dynamics::Skeleton* ground = new dart::dynamics::Skeleton("ground");
+  dart::dynamics::BodyNode* bn = new dart::dynamics::BodyNode("ground_link");
+  dart::dynamics::BoxShape* shape =
+      new dart::dynamics::BoxShape(Eigen::Vector3d(20.0, 20.0, 0.1));
+  shape->setOffset(Eigen::Vector3d(0.0, 0.0, -0.1));
+  bn->addCollisionShape(shape);
+  bn->setParentJoint(new dart::dynamics::WeldJoint);
+  ground->addBodyNode(bn);
+  world->addSkeleton(ground);
+
+  dart::dynamics::Skeleton* arm = createArm(6);
+  for(size_t i=0; i<arm->getNumBodyNodes(); ++i)
+  {
+    dart::dynamics::Joint* joint = arm->getBodyNode(i)->getParentJoint();
+    joint->setSpringStiffness(0, 2000.0);
+    joint->setDampingCoefficient(0, 0.5);
+  }
+  if(mode == MULTI_RATE)
+    arm->setNumSubSteps(10);
+  world->addSkeleton(arm);
+  arm->setPositions(Eigen::VectorXd::Constant(arm->getNumDofs(), 0.3));
+
+  for(size_t i=0; i<200; ++i)
+  {
+    world->addSkeleton(createBox(
+          i, getGridPosition(i) + Eigen::Vector3d(1.0, -2.5, -0.9)));
+  }
+
+  // One second of simulation
+  const size_t numSteps = static_cast<size_t>(1.0/timeStep + 0.5);
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<numSteps; ++i)
+    world->step();
+
+  end = std::chrono::system_clock::now();
+
+  armPositions = arm->getPositions();
+  delete world;
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runSubSteppingTest(std::vector<double>& results,
+                        std::vector<double>& errors, SubSteppingMode mode,
+                        const Eigen::VectorXd& reference)
+{
+  std::cout << "Testing: " << (mode == UNIFORM_FINE? "Uniform 0.2 ms" :
+                               mode == UNIFORM_COARSE? "Uniform 2 ms" :
+                                                       "Multi-rate 2 ms / 10")
+            << "\n";
+  Eigen::VectorXd armPositions;
+  double time = testSubSteppingSpeed(mode, armPositions);
+  results.push_back(time);
+  errors.push_back(reference.size()? (armPositions - reference).norm() : 0.0);
+  std::cout << "Result: " << time << "s per simulated second, arm error "
+            << errors.back() << std::endl;
+}
+
+dart::simulation::World* createNameLookupWorld(size_t numSkeletons,
+                                               size_t numBodies)
+{
+  dart::simulation::World* world = new dart::simulation::World;
+  for(size_t i=0; i<numSkeletons; ++i)
+  {
+    dart::dynamics::Skeleton* skel =
+        new dart::dynamics::Skeleton("skel_" + std::to_string(i));
+    dart::dynamics::BodyNode* parent = NULL;
+    for(size_t j=0; j<numBodies; ++j)
+    {
+      const std::string suffix = "_" + std::to_string(j);
+      dart::dynamics::BodyNode* bn =
+          new dart::dynamics::BodyNode("body" + suffix);
+      bn->setParentJoint(new dart::dynamics::RevoluteJoint(
+                           Eigen::Vector3d::UnitZ(), "joint" + suffix));
+      if(parent)
+        parent->addChildBodyNode(bn);
+      skel->addBodyNode(bn);
+      parent = bn;
+    }
+    world->addSkeleton(skel);
+  }
+
+  return world;
+}
+
+double testNameLookupSpeed(dart::simulation::World* world, bool handles,
+                           size_t numTests=2000)
+{
+  // Build every name up front so that only the lookups are timed
+  std::vector<std::string> skelNames;
+  std::vector<std::string> bodyNames;
+  std::vector<std::string> jointNames;
+  for(size_t i=0; i<world->getNumSkeletons(); ++i)
+    skelNames.push_back(world->getSkeleton(i)->getName());
+  dart::dynamics::Skeleton* first = world->getSkeleton(0);
+  for(size_t i=0; i<first->getNumBodyNodes(); ++i)
+  {
+    bodyNames.push_back(first->getBodyNode(i)->getName());
+    jointNames.push_back(first->getJoint(i)->getName());
+  }
+
+  std::vector<dart::common::NameHandle> skelHandles(
+        skelNames.begin(), skelNames.end());
+  std::vector<dart::common::NameHandle> bodyHandles(
+        bodyNames.begin(), bodyNames.end());
+  std::vector<dart::common::NameHandle> jointHandles(
+        jointNames.begin(), jointNames.end());
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  size_t numFound = 0;
+  for(size_t i=0; i<numTests; ++i)
+  {
+    for(size_t j=0; j<skelNames.size(); ++j)
+    {
+      for(size_t k=0; k<bodyNames.size(); ++k)
+      {
+        if(handles)
+        {
+          dart::dynamics::Skeleton* skel = world->getSkeleton(skelHandles[j]);
+          numFound += (NULL != skel->getBodyNode(bodyHandles[k]));
+          numFound += (NULL != skel->getJoint(jointHandles[k]));
+          numFound += (NULL != skel->getDof(jointHandles[k]));
+        }
+        else
+        {
+          dart::dynamics::Skeleton* skel = world->getSkeleton(skelNames[j]);
+          numFound += (NULL != skel->getBodyNode(bodyNames[k]));
+          numFound += (NULL != skel->getJoint(jointNames[k]));
+          numFound += (NULL != skel->getDof(jointNames[k]));
+        }
+      }
+    }
+  }
+
+  end = std::chrono::system_clock::now();
+
+  if(numFound != 3*numTests*skelNames.size()*bodyNames.size())
+    std::cout << "Some names were not found!\n";
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runNameLookupTest(std::vector<double>& results,
+                       dart::simulation::World* world, bool handles)
+{
+  std::cout << "Testing: " << (handles? "Name handles" : "Strings") << "\n";
+  double time = testNameLookupSpeed(world, handles);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+void print_results(const std::vector<double>& result)
+{
+  double sum = std::accumulate(result.begin(), result.end(), 0.0);
+  double mean = sum/result.size();
+  std::cout << "Average: " << mean << "\n";
+  std::vector<double> diff(result.size());
+  std::transform(result.begin(), result.end(), diff.begin(),
+                 std::bind2nd(std::minus<double>(), mean));
+  double stddev = std::sqrt(std::inner_product(diff.begin(), diff.end(),
+                                        diff.begin(), 0.0)/result.size());
+  std::cout << "Std Dev: " << stddev << "\n";
+}
+
+std::vector<std::string> getSceneFiles()
+{
+  std::vector<std::string> scenes;
+  scenes.push_back(DART_DATA_PATH"skel/test/chainwhipa.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum_euler_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/single_pendulum_ball_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum_euler_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/double_pendulum_ball_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_revolute_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_eulerxyz_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint_20.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/serial_chain_ball_joint_40.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure_euler_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/simple_tree_structure_ball_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure_euler_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/test/tree_structure_ball_joint.skel");
+  scenes.push_back(DART_DATA_PATH"skel/fullbody1.skel");
+
+  return scenes;
+}
+
+std::vector<dart::simulation::World*> getWorlds()
+{
+  std::vector<std::string> sceneFiles = getSceneFiles();
+  std::vector<dart::simulation::World*> worlds;
+  for(size_t i=0; i<sceneFiles.size(); ++i)
+  {
+    worlds.push_back(dart::utils::SkelParser::readWorld(sceneFiles[i]));
+  }
+
+  return worlds;
+}
+
+double testParsingSpeed(const std::vector<std::string>& sceneFiles,
+                        bool binary)
+{
+  std::vector<dart::simulation::World*> worlds;
+
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<sceneFiles.size(); ++i)
+  {
+    if(binary)
+      worlds.push_back(dart::utils::BinaryParser::readWorld(sceneFiles[i]));
+    else
+      worlds.push_back(dart::utils::SkelParser::readWorld(sceneFiles[i]));
+  }
+
+  end = std::chrono::system_clock::now();
+
+  for(size_t i=0; i<worlds.size(); ++i)
+    delete worlds[i];
+
+  std::chrono::duration<double> elapsed_seconds = end-start;
+  return elapsed_seconds.count();
+}
+
+void runParsingTest(std::vector<double>& results,
+                    const std::vector<std::string>& sceneFiles, bool binary)
+{
+  std::cout << "Testing: " << (binary? "Binary" : "XML") << "\n";
+  double time = testParsingSpeed(sceneFiles, binary);
+  results.push_back(time);
+  std::cout << "Result: " << time << "s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  bool test_kinematics = false;
+  bool test_inverse_kinematics = false;
+  bool test_state_update = false;
+  bool test_mesh_loading = false;
+  bool test_parsing = false;
+  bool test_parallel_loading = false;
+  bool test_recording_loading = false;
+  bool test_churn = false;
+  bool test_name_lookup = false;
+  bool test_collision = false;
+  bool test_bullet = false;
+  bool test_convex_meshes = false;
+  bool test_ray_casting = false;
+  bool test_distance = false;
+  bool test_ccd = false;
+  bool test_self_collision = false;
+  bool test_particles = false;
+  bool test_sub_stepping = false;
+  for(int i=1; i<argc; ++i)
+  {
+    if(std::string(argv[i])=="-k")
+      test_kinematics = true;
+    else if(std::string(argv[i])=="-s")
+      test_state_update = true;
+    else if(std::string(argv[i])=="-i")
+      test_inverse_kinematics = true;
+    else if(std::string(argv[i])=="-m")
+      test_mesh_loading = true;
+    else if(std::string(argv[i])=="-p")
+      test_parsing = true;
+    else if(std::string(argv[i])=="-l")
+      test_parallel_loading = true;
+    else if(std::string(argv[i])=="-r")
+      test_recording_loading = true;
+    else if(std::string(argv[i])=="-c")
+      test_churn = true;
+    else if(std::string(argv[i])=="-n")
+      test_name_lookup = true;
+    else if(std::string(argv[i])=="-d")
+      test_collision = true;
+    else if(std::string(argv[i])=="-b")
+      test_bullet = true;
+    else if(std::string(argv[i])=="-v")
+      test_convex_meshes = true;
+    else if(std::string(argv[i])=="-y")
+      test_ray_casting = true;
+    else if(std::string(argv[i])=="-q")
+      test_distance = true;
+    else if(std::string(argv[i])=="-t")
+      test_ccd = true;
+    else if(std::string(argv[i])=="-a")
+      test_self_collision = true;
+    else if(std::string(argv[i])=="-g")
+      test_particles = true;
+    else if(std::string(argv[i])=="-u")
+      test_sub_stepping = true;
+  }
+
+  if(test_bullet)
+  {
+#ifdef HAVE_BULLET_COLLISION
+    std::cout << "Testing Bullet Collision Detection" << std::endl;
+    std::vector<double> bullet_results;
+    std::vector<double> fcl_mesh_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runBulletTest(bullet_results, true);
+      runBulletTest(fcl_mesh_results, false);
+    }
+
+    std::cout << "\n\n --- Final Bullet Collision Detection Results --- \n\n";
+
+    std::cout << "Bullet\n";
+    print_results(bullet_results);
+
+    std::cout << "\nFCL mesh\n";
+    print_results(fcl_mesh_results);
+#else
+    std::cout << "DART was built without Bullet collision detection"
+              << std::endl;
+#endif
+
+    return 0;
+  }
+
+  if(test_ccd)
+  {
+    std::cout << "Testing Continuous Collision Detection" << std::endl;
+    const size_t numTrials = 5;
+    std::vector<double> discrete_results(5, 0.0);
+    std::vector<double> ccd_results(5, 0.0);
+    std::vector<size_t> discrete_tunneled(5, 0);
+    std::vector<size_t> ccd_tunneled(5, 0);
+
+    for(size_t i=0; i<numTrials; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runCCDTest(discrete_results, discrete_tunneled, false);
+      runCCDTest(ccd_results, ccd_tunneled, true);
+    }
+
+    std::cout << "\n\n --- Final Continuous Collision Detection Results "
+              << "--- \n\n";
+
+    // The largest time step at which no ball passes through the shelf, and
+    // what a step costs
+    for(int ccd=0; ccd<2; ++ccd)
+    {
+      const std::vector<double>& results = ccd? ccd_results : discrete_results;
+      const std::vector<size_t>& tunneled =
+          ccd? ccd_tunneled : discrete_tunneled;
+      std::cout << (ccd? "\nCCD\n" : "Discrete\n");
+      for(size_t i=0; i<results.size(); ++i)
+      {
+        std::cout << "Time step " << ccdTimeSteps[i] << "s: "
+                  << tunneled[i] << " tunneled, "
+                  << results[i]/numTrials << "s per step, "
+                  << results[i]/numTrials/ccdTimeSteps[i]
+                  << "s per simulated second\n";
+      }
+    }
+
+    return 0;
+  }
+
+  if(test_self_collision)
+  {
+    std::cout << "Testing Self Collision Pruning" << std::endl;
+    dart::dynamics::Skeleton* atlas = dart::utils::SdfParser::readSkeleton(
+          DART_DATA_PATH"sdf/atlas/atlas_v3_no_head.sdf");
+    atlas->enableSelfCollision();
+
+    std::vector<double> serial_results;
+    std::vector<double> parallel_results;
+    std::vector<double> all_results;
+    std::vector<double> pruned_results;
+
+    for(size_t i=0; i<3; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runSelfCollisionSamplingTest(serial_results, atlas, false);
+      runSelfCollisionSamplingTest(parallel_results, atlas, true);
+    }
+
+    dart::collision::SelfCollisionSampler sampler(atlas);
+    sampler.setNumSamples(2000);
+    const size_t numPairs = sampler.sample();
+    const size_t numNever =
+        sampler.getNumPairs(dart::collision::SELF_COLLISION_NEVER);
+    const size_t numAlways =
+        sampler.getNumPairs(dart::collision::SELF_COLLISION_ALWAYS);
+
+    for(size_t i=0; i<5; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      atlas->clearDisabledSelfCollisionPairs();
+      runSelfCollisionTest(all_results, atlas, false);
+      sampler.disablePairs();
+      runSelfCollisionTest(pruned_results, atlas, true);
+    }
+    delete atlas;
+
+    std::cout << "\n\n --- Final Self Collision Pruning Results --- \n\n";
+
+    std::cout << "Pairs: " << numPairs << " with collision shapes, "
+              << numNever << " never colliding, " << numAlways
+              << " always colliding, " << numPairs - numNever - numAlways
+              << " left to check\n\n";
+
+    std::cout << "Serial sampling\n";
+    print_results(serial_results);
+
+    std::cout << "\nParallel sampling\n";
+    print_results(parallel_results);
+
+    std::cout << "\nSelf collision, all pairs\n";
+    print_results(all_results);
+
+    std::cout << "\nSelf collision, pruned pairs\n";
+    print_results(pruned_results);
+
+    return 0;
+  }
+
+  if(test_sub_stepping)
+  {
+    std::cout << "Testing Multi-Rate Sub-Stepping" << std::endl;
+
+    // The arm trajectory with uniform small steps is the reference
+    Eigen::VectorXd reference;
+    testSubSteppingSpeed(UNIFORM_FINE, reference);
+
+    std::vector<std::vector<double> > results(3);
+    std::vector<std::vector<double> > errors(3);
+    for(size_t i=0; i<3; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<results.size(); ++j)
+      {
+        runSubSteppingTest(results[j], errors[j],
+                           static_cast<SubSteppingMode>(j), reference);
+      }
+    }
+
+    std::cout << "\n\n --- Final Multi-Rate Sub-Stepping Results (s per "
+              << "simulated second) --- \n\n";
+
+    const char* names[] = { "Uniform 0.2 ms", "Uniform 2 ms",
+                            "Multi-rate 2 ms, arm sub-stepped 10 times" };
+    for(size_t j=0; j<results.size(); ++j)
+    {
+      std::cout << (j? "\n" : "") << names[j] << ", arm error "
+                << errors[j].back() << "\n";
+      print_results(results[j]);
+    }
+
+    return 0;
+  }
+
+  if(test_particles)
+  {
+    std::cout << "Testing Particle Systems" << std::endl;
+    const size_t numBodies[] = { 225, 900, 4500 };
+    std::vector<std::vector<double> > particle_results(3);
+    std::vector<double> particle_box_results;
+    std::vector<double> skeleton_results;
+    std::vector<double> skeleton_box_results;
+
+    for(size_t i=0; i<3; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<3; ++j)
+        runParticleTest(particle_results[j], true, false, numBodies[j]);
+      runParticleTest(particle_box_results, true, true, numBodies[1]);
+      runParticleTest(skeleton_results, false, false, numBodies[0]);
+      runParticleTest(skeleton_box_results, false, true, numBodies[0]);
+    }
+
+    std::cout << "\n\n --- Final Particle System Results (bodies per ms) "
+              << "--- \n\n";
+
+    for(size_t j=0; j<3; ++j)
+    {
+      std::cout << (j? "\n" : "") << numBodies[j] << " particles\n";
+      print_results(particle_results[j]);
+    }
+
+    std::cout << "\n" << numBodies[1] << " particles with a box\n";
+    print_results(particle_box_results);
+
+    std::cout << "\n" << numBodies[0] << " skeletons\n";
+    print_results(skeleton_results);
+
+    std::cout << "\n" << numBodies[0] << " skeletons with a box\n";
+    print_results(skeleton_box_results);
+
+    return 0;
+  }
+
+  if(test_distance)
+  {
+    std::cout << "Testing Distance Queries" << std::endl;
+    std::vector<std::vector<double> > results(3);
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<results.size(); ++j)
+        runDistanceTest(results[j], static_cast<DistanceMode>(j));
+    }
+
+    std::cout << "\n\n --- Final Distance Query Results --- \n\n";
+
+    std::cout << "Cold start\n";
+    print_results(results[DISTANCE_COLD]);
+
+    std::cout << "\nWarm start\n";
+    print_results(results[DISTANCE_WARM]);
+
+    std::cout << "\nWarm start with threshold\n";
+    print_results(results[DISTANCE_THRESHOLD]);
+
+    return 0;
+  }
+
+  if(test_ray_casting)
+  {
+    std::cout << "Testing Ray Casting" << std::endl;
+    std::vector<double> serial_results;
+    std::vector<double> parallel_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runRayCastTest(serial_results, false);
+      runRayCastTest(parallel_results, true);
+    }
+
+    std::cout << "\n\n --- Final Ray Casting Results --- \n\n";
+
+    std::cout << "Serial\n";
+    print_results(serial_results);
+
+    std::cout << "\nParallel\n";
+    print_results(parallel_results);
+
+    return 0;
+  }
+
+  if(test_convex_meshes)
+  {
+    std::cout << "Testing Convex Mesh Collision" << std::endl;
+    std::vector<std::vector<double> > results(3);
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<results.size(); ++j)
+        runConvexMeshTest(results[j], static_cast<ConvexMeshMode>(j));
+    }
+
+    std::cout << "\n\n --- Final Convex Mesh Collision Results --- \n\n";
+
+    std::cout << "FCL mesh (triangles)\n";
+    print_results(results[FCL_MESH_TRIANGLES]);
+
+    std::cout << "\nFCL mesh (convex)\n";
+    print_results(results[FCL_MESH_CONVEX]);
+
+    std::cout << "\nDART (convex)\n";
+    print_results(results[DART_CONVEX]);
+
+    return 0;
+  }
+
+  if(test_collision)
+  {
+    std::cout << "Testing Collision Detection" << std::endl;
+    std::vector<std::vector<double> > results(3);
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<results.size(); ++j)
+        runCollisionTest(results[j], static_cast<CollisionDetectorType>(j));
+    }
+
+    std::cout << "\n\n --- Final Collision Detection Results --- \n\n";
+
+    std::cout << "DART\n";
+    print_results(results[DART_DETECTOR]);
+
+    std::cout << "\nFCL mesh (all pairs)\n";
+    print_results(results[FCL_MESH_DETECTOR]);
+
+    std::cout << "\nFCL (dynamic AABB tree)\n";
+    print_results(results[FCL_DETECTOR]);
+
+    return 0;
+  }
+
+  if(test_name_lookup)
+  {
+    std::cout << "Testing Name Lookup" << std::endl;
+
+    // 50 skeletons with 10 bodies each
+    dart::simulation::World* world = createNameLookupWorld(50, 10);
+    std::vector<double> string_results;
+    std::vector<double> handle_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runNameLookupTest(string_results, world, false);
+      runNameLookupTest(handle_results, world, true);
+    }
+
+    delete world;
+
+    std::cout << "\n\n --- Final Name Lookup Results --- \n\n";
+
+    std::cout << "Strings\n";
+    print_results(string_results);
+
+    std::cout << "\nName handles\n";
+    print_results(handle_results);
+
+    return 0;
+  }
+
+  if(test_churn)
+  {
+    std::cout << "Testing Skeleton Churn" << std::endl;
+    std::vector<double> immediate_results;
+    std::vector<double> queued_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runChurnTest(immediate_results, false);
+      runChurnTest(queued_results, true);
+    }
+
+    std::cout << "\n\n --- Final Churn Results (adds/removes per second) "
+              << "--- \n\n";
+
+    std::cout << "Immediate\n";
+    print_results(immediate_results);
+
+    std::cout << "\nQueued\n";
+    print_results(queued_results);
+
+    return 0;
+  }
+
+  if(test_recording_loading)
+  {
+    std::cout << "Testing Recording Loading" << std::endl;
+
+    // Write the same random motion in the text and the binary formats
+    const size_t numFrames = 20000;
+    const size_t numContacts = 4;
+    dart::simulation::World* world = dart::utils::SkelParser::readWorld(
+          DART_DATA_PATH"skel/fullbody1.skel");
+    std::vector<dart::dynamics::Skeleton*> skels;
+    size_t numDofs = 0;
+    for(size_t i=0; i<world->getNumSkeletons(); ++i)
+    {
+      skels.push_back(world->getSkeleton(i));
+      numDofs += world->getSkeleton(i)->getNumDofs();
+    }
+    dart::dynamics::Skeleton* skel = world->getSkeleton("fullbody1");
+
+    dart::simulation::Recording recording(skels);
+    dart::utils::FileInfoDof motion(skel);
+    for(size_t i=0; i<numFrames; ++i)
+    {
+      recording.addState(Eigen::VectorXd::Random(
+                           numDofs + 6*numContacts));
+      motion.addDof(Eigen::VectorXd::Random(skel->getNumDofs()));
+    }
+
+    dart::utils::FileInfoWorld recordingFile;
+    recordingFile.saveFile("speedTest_recording.txt", &recording);
+    recordingFile.saveBinaryFile("speedTest_recording.bin", &recording);
+    motion.saveFile("speedTest_motion.txt", 0, numFrames-1);
+    motion.saveBinaryFile("speedTest_motion.bin", 0, numFrames-1);
+
+    std::vector<std::vector<double> > results(5);
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      for(size_t j=0; j<results.size(); ++j)
+        runRecordingLoadingTest(results[j], skel,
+                                static_cast<RecordingFormat>(j));
+    }
+
+    std::remove("speedTest_recording.txt");
+    std::remove("speedTest_recording.bin");
+    std::remove("speedTest_motion.txt");
+    std::remove("speedTest_motion.bin");
+    delete world;
+
+    std::cout << "\n\n --- Final Recording Loading Results --- \n\n";
+
+    std::cout << "World text\n";
+    print_results(results[WORLD_TEXT]);
+
+    std::cout << "\nWorld binary\n";
+    print_results(results[WORLD_BINARY]);
+
+    std::cout << "\nWorld streaming\n";
+    print_results(results[WORLD_STREAM]);
+
+    std::cout << "\nDof text\n";
+    print_results(results[DOF_TEXT]);
+
+    std::cout << "\nDof binary\n";
+    print_results(results[DOF_BINARY]);
+
+    return 0;
+  }
+
+  if(test_parallel_loading)
+  {
+    std::cout << "Testing Parallel Asset Loading" << std::endl;
+    size_t numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<double> serial_results;
+    std::vector<double> parallel_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runParallelLoadingTest(serial_results, 1);
+      runParallelLoadingTest(parallel_results, numThreads);
+    }
+
+    std::cout << "\n\n --- Final Asset Loading Results --- \n\n";
+
+    std::cout << "Serial\n";
+    print_results(serial_results);
+
+    std::cout << "\nParallel (" << numThreads << " threads)\n";
+    print_results(parallel_results);
+
+    return 0;
+  }
+
+  if(test_parsing)
+  {
+    std::cout << "Testing World Parsing" << std::endl;
+
+    // Convert every scene once so that both parsers read the same worlds
+    std::vector<std::string> xmlFiles = getSceneFiles();
+    std::vector<std::string> binaryFiles;
+    for(size_t i=0; i<xmlFiles.size(); ++i)
+    {
+      dart::simulation::World* world =
+          dart::utils::SkelParser::readWorld(xmlFiles[i]);
+      std::string fileName = "speedTest_" + std::to_string(i) + ".dartbin";
+      if(dart::utils::BinaryParser::writeWorld(world, fileName))
+        binaryFiles.push_back(fileName);
+      delete world;
+    }
+
+    std::vector<double> xml_results;
+    std::vector<double> binary_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runParsingTest(xml_results, xmlFiles, false);
+      runParsingTest(binary_results, binaryFiles, true);
+    }
+
+    for(size_t i=0; i<binaryFiles.size(); ++i)
+      std::remove(binaryFiles[i].c_str());
+
+    std::cout << "\n\n --- Final World Parsing Results --- \n\n";
+
+    std::cout << "XML\n";
+    print_results(xml_results);
+
+    std::cout << "\nBinary\n";
+    print_results(binary_results);
+
+    return 0;
+  }
+
+  if(test_mesh_loading)
+  {
+    std::cout << "Testing Mesh Loading" << std::endl;
+    std::vector<double> uncached_results;
+    std::vector<double> cached_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runMeshLoadingTest(uncached_results, false);
+      runMeshLoadingTest(cached_results, true);
+    }
+
+    std::cout << "\n\n --- Final Mesh Loading Results --- \n\n";
+
+    std::cout << "Uncached\n";
+    print_results(uncached_results);
+
+    std::cout << "\nCached\n";
+    print_results(cached_results);
+
+    return 0;
+  }
+
+  std::vector<dart::simulation::World*> worlds = getWorlds();
+
+  if(test_inverse_kinematics)
+  {
+    std::cout << "Testing Inverse Kinematics" << std::endl;
+
+    // Batched solving needs one copy of every scene per thread
+    std::vector<std::vector<dart::simulation::World*> > workerWorlds;
+    workerWorlds.push_back(worlds);
+    size_t numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+    for(size_t i=1; i<numWorkers; ++i)
+      workerWorlds.push_back(getWorlds());
+
+    std::vector<double> serial_results;
+    std::vector<double> batch_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runInverseKinematicsTest(serial_results, workerWorlds, false);
+      runInverseKinematicsTest(batch_results, workerWorlds, true);
+    }
+
+    std::cout << "\n\n --- Final Inverse Kinematics Results --- \n\n";
+
+    std::cout << "Serial\n";
+    print_results(serial_results);
+
+    std::cout << "\nBatched (" << numWorkers << " workers)\n";
+    print_results(batch_results);
+
+    return 0;
+  }
+
+  if(test_state_update)
+  {
+    std::cout << "Testing State Updates" << std::endl;
+    std::vector<double> per_dof_results;
+    std::vector<double> batched_results;
+    std::vector<double> vector_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runStateUpdateTest(per_dof_results, worlds, PER_DOF);
+      runStateUpdateTest(batched_results, worlds, PER_DOF_BATCHED);
+      runStateUpdateTest(vector_results, worlds, WHOLE_VECTOR);
+    }
+
+    std::cout << "\n\n --- Final State Update Results --- \n\n";
+
+    std::cout << "Per-DOF setters\n";
+    print_results(per_dof_results);
+
+    std::cout << "\nBatched per-DOF setters\n";
+    print_results(batched_results);
+
+    std::cout << "\nWhole-vector setter\n";
+    print_results(vector_results);
+
+    return 0;
+  }
+
+  if(test_kinematics)
+  {
+    std::cout << "Testing Kinematics" << std::endl;
+    std::vector<double> acceleration_results;
+    std::vector<double> velocity_results;
+    std::vector<double> position_results;
+    std::vector<double> compiled_acceleration_results;
+    std::vector<double> compiled_velocity_results;
+    std::vector<double> compiled_position_results;
+
+    for(size_t i=0; i<10; ++i)
+    {
+      std::cout << "\nTrial #" << i+1 << std::endl;
+      runKinematicsTest(acceleration_results, worlds, true, true, true);
+      runKinematicsTest(velocity_results, worlds, true, true, false);
+      runKinematicsTest(position_results, worlds, true, false, false);
+      runKinematicsTest(compiled_acceleration_results, worlds,
+                        true, true, true, true);
+      runKinematicsTest(compiled_velocity_results, worlds,
+                        true, true, false, true);
+      runKinematicsTest(compiled_position_results, worlds,
+                        true, false, false, true);
+    }
+
+    std::cout << "\n\n --- Final Kinematics Results --- \n\n";
+
+    std::cout << "Position, Velocity, Acceleration\n";
+    print_results(acceleration_results);
+
+    std::cout << "\nPosition, Velocity\n";
+    print_results(velocity_results);
+
+    std::cout << "\nPosition\n";
+    print_results(position_results);
+
+    std::cout << "\nCompiled: Position, Velocity, Acceleration\n";
+    print_results(compiled_acceleration_results);
+
+    std::cout << "\nCompiled: Position, Velocity\n";
+    print_results(compiled_velocity_results);
+
+    std::cout << "\nCompiled: Position\n";
+    print_results(compiled_position_results);
 
     return 0;
   }
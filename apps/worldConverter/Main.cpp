@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "dart/dynamics/Skeleton.h"
+#include "dart/simulation/World.h"
+#include "dart/utils/BinaryParser.h"
+#include "dart/utils/SkelParser.h"
+#include "dart/utils/sdf/SdfParser.h"
+#include "dart/utils/urdf/DartLoader.h"
+
+bool hasExtension(const std::string& _fileName, const std::string& _extension)
+{
+  return _fileName.size() >= _extension.size()
+      && _fileName.compare(_fileName.size() - _extension.size(),
+                           _extension.size(), _extension) == 0;
+}
+
+/// Read a World from a .skel, .sdf, .world or .urdf file. Files that only
+/// describe a single model are wrapped into a World.
+dart::simulation::World* readWorld(const std::string& _fileName)
+{
+  dart::dynamics::Skeleton* skel = NULL;
+
+  if(hasExtension(_fileName, ".skel"))
+  {
+    return dart::utils::SkelParser::readWorld(_fileName);
+  }
+  else if(hasExtension(_fileName, ".sdf") || hasExtension(_fileName, ".world"))
+  {
+    dart::simulation::World* world =
+        dart::utils::SdfParser::readSdfFile(_fileName);
+    if(world)
+      return world;
+    skel = dart::utils::SdfParser::readSkeleton(_fileName);
+  }
+  else if(hasExtension(_fileName, ".urdf"))
+  {
+    dart::utils::DartLoader loader;
+    skel = loader.parseSkeleton(_fileName);
+  }
+  else
+  {
+    std::cout << "Unknown file type: " << _fileName << std::endl;
+    return NULL;
+  }
+
+  if(NULL == skel)
+    return NULL;
+
+  dart::simulation::World* world = new dart::simulation::World;
+  world->addSkeleton(skel);
+  return world;
+}
+
+/// Convert a .skel, .sdf, .world or .urdf file into the binary format of
+/// dart::utils::BinaryParser, which loads without any XML parsing.
+int main(int argc, char* argv[])
+{
+  if(argc != 3)
+  {
+    std::cout << "Usage: " << argv[0] << " input_file output_file\n"
+              << "The input can be a .skel, .sdf, .world or .urdf file."
+              << std::endl;
+    return 1;
+  }
+
+  dart::simulation::World* world = readWorld(argv[1]);
+  if(NULL == world)
+  {
+    std::cout << "Failed to read " << argv[1] << std::endl;
+    return 1;
+  }
+
+  bool result = dart::utils::BinaryParser::writeWorld(world, argv[2]);
+  delete world;
+
+  if(!result)
+  {
+    std::cout << "Failed to write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << argv[1] << " to " << argv[2] << std::endl;
+  return 0;
+}
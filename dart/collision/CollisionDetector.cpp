@@ -39,18 +39,27 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
+#include <set>
 #include <vector>
 
 #include "dart/common/Console.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Shape.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/SoftBodyNode.h"
 #include "dart/collision/CollisionNode.h"
+#include "dart/collision/dart/DARTCollide.h"
+
+// Gap below which a speculative contact has no reliable normal
+#define DART_SPECULATIVE_CONTACT_EPS 1e-9
 
 namespace dart {
 namespace collision {
 
 CollisionDetector::CollisionDetector()
-  : mNumMaxContacts(100) {
+  : mNumMaxContacts(100),
+    mTimeStep(0.001) {
 }
 
 CollisionDetector::~CollisionDetector() {
@@ -66,6 +75,7 @@ void CollisionDetector::addSkeleton(dynamics::Skeleton* _skeleton)
 
   if (containSkeleton(_skeleton) == false)
   {
+    mSkeletonIndices[_skeleton] = mSkeletons.size();
     mSkeletons.push_back(_skeleton);
     for (size_t i = 0; i < _skeleton->getNumBodyNodes(); ++i)
       addCollisionSkeletonNode(_skeleton->getBodyNode(i));
@@ -85,8 +95,16 @@ void CollisionDetector::removeSkeleton(dynamics::Skeleton* _skeleton)
 
   if (containSkeleton(_skeleton))
   {
-    mSkeletons.erase(remove(mSkeletons.begin(), mSkeletons.end(), _skeleton),
-                     mSkeletons.end());
+    // Move the last skeleton into the place of _skeleton
+    size_t index = mSkeletonIndices[_skeleton];
+    mSkeletonIndices.erase(_skeleton);
+    if (index + 1 < mSkeletons.size())
+    {
+      mSkeletons[index] = mSkeletons.back();
+      mSkeletonIndices[mSkeletons[index]] = index;
+    }
+    mSkeletons.pop_back();
+
     for (size_t i = 0; i < _skeleton->getNumBodyNodes(); ++i)
       removeCollisionSkeletonNode(_skeleton->getBodyNode(i));
   }
@@ -100,10 +118,9 @@ void CollisionDetector::removeSkeleton(dynamics::Skeleton* _skeleton)
 //==============================================================================
 void CollisionDetector::removeAllSkeletons()
 {
-  for (size_t i = 0; i < mSkeletons.size(); ++i)
-    removeSkeleton(mSkeletons[i]);
-
-  mSkeletons.clear();
+  // removeSkeleton() erases the skeleton from mSkeletons
+  while (!mSkeletons.empty())
+    removeSkeleton(mSkeletons.back());
 }
 
 void CollisionDetector::addCollisionSkeletonNode(dynamics::BodyNode* _bodyNode,
@@ -128,10 +145,6 @@ void CollisionDetector::addCollisionSkeletonNode(dynamics::BodyNode* _bodyNode,
   // Add the collision node to map (BodyNode -> CollisionNode)
   mBodyCollisionMap[_bodyNode] = collNode;
 
-  // Add collidable pairs for the collision node
-  mCollidablePairs.push_back(
-        std::vector<bool>(mCollisionNodes.size() - 1, true));
-
   if (_isRecursive) {
     for (size_t i = 0; i < _bodyNode->getNumChildBodyNodes(); i++)
       addCollisionSkeletonNode(_bodyNode->getChildBodyNode(i), true);
@@ -151,30 +164,42 @@ void CollisionDetector::removeCollisionSkeletonNode(
     return;
   }
 
-  // Update index of collision nodes.
+  // Move the last collision node into the place of collNode
   size_t iCollNode = collNode->getIndex();
-  for (size_t i = iCollNode + 1; i < mCollisionNodes.size(); ++i)
-    mCollisionNodes[i]->setIndex(mCollisionNodes[i]->getIndex() - 1);
-
-  // Remove collNode from mCollisionNodes
-  mCollisionNodes.erase(remove(mCollisionNodes.begin(), mCollisionNodes.end(),
-                               collNode),
-                        mCollisionNodes.end());
+  mCollisionNodes[iCollNode] = mCollisionNodes.back();
+  mCollisionNodes[iCollNode]->setIndex(iCollNode);
+  mCollisionNodes.pop_back();
 
   // Remove collNode-_bodyNode pair from mBodyCollisionMap
   mBodyCollisionMap.erase(_bodyNode);
 
-  // Delete collNode
-  delete collNode;
+  // Remove the disabled pairs of collNode
+  std::unordered_map<const CollisionNode*,
+                     std::unordered_set<const CollisionNode*> >::iterator
+      disabled = mDisabledPairs.find(collNode);
+  if (disabled != mDisabledPairs.end())
+  {
+    for (std::unordered_set<const CollisionNode*>::const_iterator it
+         = disabled->second.begin(); it != disabled->second.end(); ++it)
+    {
+      mDisabledPairs[*it].erase(collNode);
+      if (mDisabledPairs[*it].empty())
+        mDisabledPairs.erase(*it);
+    }
+    mDisabledPairs.erase(disabled);
+  }
 
-  // Update mCollidablePairs
-  for (size_t i = iCollNode + 1; i < mCollidablePairs.size(); ++i) {
-    for (size_t j = 0; j < iCollNode; ++j)
-      mCollidablePairs[i-1][j] = mCollidablePairs[i][j];
-    for (size_t j = iCollNode + 1; j < mCollidablePairs[i].size(); ++j)
-      mCollidablePairs[i-1][j-1] = mCollidablePairs[i][j];
+  // Remove the cached separating directions of the shapes of _bodyNode
+  for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); ++i)
+  {
+    const dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
+    mDistanceDirections.erase(shape);
+    for (auto& directions : mDistanceDirections)
+      directions.second.erase(shape);
   }
-  mCollidablePairs.pop_back();
+
+  // Delete collNode
+  delete collNode;
 
   if (_isRecursive) {
     for (size_t i = 0; i < _bodyNode->getNumChildBodyNodes(); i++)
@@ -210,6 +235,15 @@ void CollisionDetector::setNumMaxContacs(int _num) {
   mNumMaxContacts = _num;
 }
 
+void CollisionDetector::setTimeStep(double _timeStep) {
+  assert(_timeStep > 0.0 && "Time step should be positive.");
+  mTimeStep = _timeStep;
+}
+
+double CollisionDetector::getTimeStep() const {
+  return mTimeStep;
+}
+
 void CollisionDetector::enablePair(dynamics::BodyNode* _node1,
                                    dynamics::BodyNode* _node2) {
   CollisionNode* collisionNode1 = getCollisionNode(_node1);
@@ -226,6 +260,155 @@ void CollisionDetector::disablePair(dynamics::BodyNode* _node1,
     setPairCollidable(collisionNode1, collisionNode2, false);
 }
 
+//==============================================================================
+double CollisionDetector::computeDistance(dynamics::BodyNode* _node1,
+                                          dynamics::BodyNode* _node2,
+                                          DistanceResult* _result,
+                                          double _threshold)
+{
+  assert(_node1 != NULL && _node2 != NULL && "Invalid body node.");
+
+  DistanceResult result;
+  result.distance = std::numeric_limits<double>::infinity();
+  result.point1.setZero();
+  result.point2.setZero();
+  result.bodyNode1 = _node1;
+  result.bodyNode2 = _node2;
+  result.shape1 = NULL;
+  result.shape2 = NULL;
+
+  updateDistance(_node1, _node2, _threshold, &result);
+
+  if (_result)
+    *_result = result;
+
+  return result.distance;
+}
+
+//==============================================================================
+size_t CollisionDetector::detectSpeculativeContacts()
+{
+  // Pairs that already touch are left to the discrete contacts. They are
+  // only gathered once a body with CCD is found.
+  std::set<std::pair<const dynamics::BodyNode*, const dynamics::BodyNode*> >
+      touching;
+  const size_t numDiscreteContacts = mContacts.size();
+  bool isTouchingFound = false;
+
+  size_t numContacts = 0;
+  for (size_t i = 0; i < mCollisionNodes.size(); ++i)
+  {
+    const CollisionNode* node1 = mCollisionNodes[i];
+    dynamics::BodyNode* bodyNode1 = node1->getBodyNode();
+    if (!bodyNode1->isCCDEnabled() || !isCollidable(node1))
+      continue;
+
+    // Soft bodies only get discrete contacts
+    if (dynamic_cast<dynamics::SoftBodyNode*>(bodyNode1))
+      continue;
+
+    if (!isTouchingFound)
+    {
+      for (size_t k = 0; k < numDiscreteContacts; ++k)
+      {
+        touching.insert(std::make_pair(mContacts[k].bodyNode1,
+                                       mContacts[k].bodyNode2));
+        touching.insert(std::make_pair(mContacts[k].bodyNode2,
+                                       mContacts[k].bodyNode1));
+      }
+      isTouchingFound = true;
+    }
+
+    const double speed1 = computeMaxSpeed(bodyNode1);
+
+    for (size_t j = 0; j < mCollisionNodes.size(); ++j)
+    {
+      const CollisionNode* node2 = mCollisionNodes[j];
+      dynamics::BodyNode* bodyNode2 = node2->getBodyNode();
+
+      // Visit pairs of two CCD bodies once
+      if (i == j || (j < i && bodyNode2->isCCDEnabled()))
+        continue;
+
+      if (dynamic_cast<dynamics::SoftBodyNode*>(bodyNode2)
+          || !isCollidable(node1, node2)
+          || touching.count(std::make_pair(bodyNode1, bodyNode2)))
+        continue;
+
+      // Distance that the bodies may close within the time step
+      const double margin = (speed1 + computeMaxSpeed(bodyNode2)) * mTimeStep;
+      if (margin <= 0.0)
+        continue;
+
+      DistanceResult result;
+      const double distance
+          = computeDistance(bodyNode1, bodyNode2, &result, margin);
+      if (distance >= margin || distance <= DART_SPECULATIVE_CONTACT_EPS)
+        continue;
+
+      Contact contact;
+      contact.point = 0.5 * (result.point1 + result.point2);
+      contact.normal = (result.point1 - result.point2) / distance;
+      contact.force.setZero();
+      contact.bodyNode1 = bodyNode1;
+      contact.bodyNode2 = bodyNode2;
+      contact.shape1 = result.shape1;
+      contact.shape2 = result.shape2;
+      contact.penetrationDepth = -distance;
+      contact.triID1 = 0;
+      contact.triID2 = 0;
+      contact.id = 0;
+      contact.userData = NULL;
+      mContacts.push_back(contact);
+      ++numContacts;
+    }
+  }
+
+  return numContacts;
+}
+
+//==============================================================================
+double CollisionDetector::computeDistance(dynamics::Skeleton* _skeleton,
+                                          DistanceResult* _result,
+                                          double _threshold)
+{
+  assert(_skeleton != NULL && "Invalid skeleton.");
+
+  DistanceResult result;
+  result.distance = std::numeric_limits<double>::infinity();
+  result.point1.setZero();
+  result.point2.setZero();
+  result.bodyNode1 = NULL;
+  result.bodyNode2 = NULL;
+  result.shape1 = NULL;
+  result.shape2 = NULL;
+
+  for (size_t i = 0; i < _skeleton->getNumBodyNodes(); ++i)
+  {
+    const CollisionNode* node1 = getCollisionNode(_skeleton->getBodyNode(i));
+    if (node1 == NULL || !isCollidable(node1))
+      continue;
+
+    for (size_t j = 0; j < mCollisionNodes.size(); ++j)
+    {
+      const CollisionNode* node2 = mCollisionNodes[j];
+      if (node2->getBodyNode()->getSkeleton() == _skeleton
+          || !isCollidable(node1, node2))
+        continue;
+
+      // Pairs farther apart than the closest one so far are cut short
+      updateDistance(node1->getBodyNode(), node2->getBodyNode(),
+                     std::min(_threshold, result.distance), &result);
+    }
+  }
+
+  if (_result)
+    *_result = result;
+
+  return result.distance;
+}
+
+
 //==============================================================================
 bool CollisionDetector::isCollidable(const CollisionNode* _node1,
                                      const CollisionNode* _node2)
@@ -233,16 +416,32 @@ bool CollisionDetector::isCollidable(const CollisionNode* _node1,
   dynamics::BodyNode* bn1 = _node1->getBodyNode();
   dynamics::BodyNode* bn2 = _node2->getBodyNode();
 
-  if (!getPairCollidable(_node1, _node2))
+  if (!bn1->isCollidable() || !bn2->isCollidable())
     return false;
 
-  if (!bn1->isCollidable() || !bn2->isCollidable())
+  // Bodies that both stay still for a sub-step of simulation::World, where
+  // at least one of them is held, can't come into contact
+  const dynamics::Skeleton* skel1 = bn1->getSkeleton();
+  const dynamics::Skeleton* skel2 = bn2->getSkeleton();
+  if ((skel1->isHeld() || skel2->isHeld())
+      && (!skel1->isMobile() || skel1->isHeld())
+      && (!skel2->isMobile() || skel2->isHeld()))
+    return false;
+
+  if ((bn1->getCollisionCategory() & bn2->getCollisionMask()) == 0
+      || (bn2->getCollisionCategory() & bn1->getCollisionMask()) == 0)
+    return false;
+
+  if (!getPairCollidable(_node1, _node2))
     return false;
 
   if (bn1->getSkeleton() == bn2->getSkeleton())
   {
     if (bn1->getSkeleton()->isEnabledSelfCollisionCheck())
     {
+      if (!bn1->getSkeleton()->isSelfCollisionPairEnabled(bn1, bn2))
+        return false;
+
       if (isAdjacentBodies(bn1, bn2))
       {
         if (!bn1->getSkeleton()->isEnabledAdjacentBodyCheck())
@@ -259,63 +458,126 @@ bool CollisionDetector::isCollidable(const CollisionNode* _node1,
 }
 
 //==============================================================================
-bool CollisionDetector::containSkeleton(const dynamics::Skeleton* _skeleton)
+bool CollisionDetector::isCollidable(const CollisionNode* _node) const
 {
-  for (std::vector<dynamics::Skeleton*>::const_iterator it = mSkeletons.begin();
-       it != mSkeletons.end(); ++it)
-  {
-    if ((*it) == _skeleton)
-      return true;
-  }
+  dynamics::BodyNode* bn = _node->getBodyNode();
 
-  return false;
+  return bn->isCollidable()
+      && bn->getCollisionCategory() != 0 && bn->getCollisionMask() != 0;
 }
 
+//==============================================================================
+bool CollisionDetector::containSkeleton(const dynamics::Skeleton* _skeleton)
+{
+  return mSkeletonIndices.find(_skeleton) != mSkeletonIndices.end();
+}
+
+//==============================================================================
 bool CollisionDetector::getPairCollidable(const CollisionNode* _node1,
-                                          const CollisionNode* _node2)
+                                          const CollisionNode* _node2) const
 {
   assert(_node1 != _node2);
 
-  size_t index1 = _node1->getIndex();
-  size_t index2 = _node2->getIndex();
-
-  if (index1 < index2)
-    std::swap(index1, index2);
-
-  // TODO(JS): Workaround
-  // If this fuction is called before all the body nodes in the world are not
-  // added to the collision detector than it cause seg fault. We just return
-  // false in that case.
-  if (index1 > mCollidablePairs.size() - 1
-      || index2 > mCollidablePairs.size() - 1)
+  if (mDisabledPairs.empty())
     return true;
 
-  return mCollidablePairs[index1][index2];
+  std::unordered_map<const CollisionNode*,
+                     std::unordered_set<const CollisionNode*> >::const_iterator
+      disabled = mDisabledPairs.find(_node1);
+
+  return disabled == mDisabledPairs.end()
+      || disabled->second.count(_node2) == 0;
 }
 
+//==============================================================================
 void CollisionDetector::setPairCollidable(const CollisionNode* _node1,
                                           const CollisionNode* _node2,
                                           bool _val)
 {
   assert(_node1 != _node2);
 
-  size_t index1 = _node1->getIndex();
-  size_t index2 = _node2->getIndex();
-
-  if (index1 < index2)
-    std::swap(index1, index2);
+  if (!_val)
+  {
+    mDisabledPairs[_node1].insert(_node2);
+    mDisabledPairs[_node2].insert(_node1);
+    return;
+  }
 
-  // TODO(JS): Workaround
-  // If this fuction is called before all the body nodes in the world are not
-  // added to the collision detector than it cause seg fault. We just return in
-  // that case.
-  if (index1 > mCollidablePairs.size() - 1
-      || index2 > mCollidablePairs.size() - 1)
+  std::unordered_map<const CollisionNode*,
+                     std::unordered_set<const CollisionNode*> >::iterator
+      disabled1 = mDisabledPairs.find(_node1);
+  std::unordered_map<const CollisionNode*,
+                     std::unordered_set<const CollisionNode*> >::iterator
+      disabled2 = mDisabledPairs.find(_node2);
+  if (disabled1 == mDisabledPairs.end() || disabled2 == mDisabledPairs.end())
     return;
 
-  mCollidablePairs[index1][index2] = _val;
+  disabled1->second.erase(_node2);
+  if (disabled1->second.empty())
+    mDisabledPairs.erase(disabled1);
+
+  disabled2->second.erase(_node1);
+  if (disabled2->second.empty())
+    mDisabledPairs.erase(disabled2);
+}
+
+//==============================================================================
+void CollisionDetector::updateDistance(dynamics::BodyNode* _bodyNode1,
+                                       dynamics::BodyNode* _bodyNode2,
+                                       double _threshold,
+                                       DistanceResult* _result)
+{
+  for (size_t i = 0; i < _bodyNode1->getNumCollisionShapes(); ++i)
+  {
+    dynamics::Shape* shape1 = _bodyNode1->getCollisionShape(i);
+    const Eigen::Isometry3d T1 = _bodyNode1->getWorldTransform()
+                                 * shape1->getLocalTransform();
+
+    for (size_t j = 0; j < _bodyNode2->getNumCollisionShapes(); ++j)
+    {
+      dynamics::Shape* shape2 = _bodyNode2->getCollisionShape(j);
+      const Eigen::Isometry3d T2 = _bodyNode2->getWorldTransform()
+                                   * shape2->getLocalTransform();
+
+      Eigen::Vector3d point1;
+      Eigen::Vector3d point2;
+      const double distance = collision::computeDistance(
+            shape1, T1, shape2, T2, &point1, &point2,
+            &mDistanceDirections[shape1][shape2],
+            std::min(_threshold, _result->distance));
+
+      if (distance < _result->distance)
+      {
+        _result->distance = distance;
+        _result->point1 = point1;
+        _result->point2 = point2;
+        _result->bodyNode1 = _bodyNode1;
+        _result->bodyNode2 = _bodyNode2;
+        _result->shape1 = shape1;
+        _result->shape2 = shape2;
+      }
+    }
+  }
 }
 
+//==============================================================================
+double CollisionDetector::computeMaxSpeed(
+    const dynamics::BodyNode* _bodyNode) const
+{
+  // The points of the shapes are at most this far from the body origin
+  double radius = 0.0;
+  for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); ++i)
+  {
+    const dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
+    radius = std::max(radius, shape->getOffset().norm()
+                              + 0.5 * shape->getBoundingBoxDim().norm());
+  }
+
+  const Eigen::Vector6d& V = _bodyNode->getSpatialVelocity();
+  return V.tail<3>().norm() + V.head<3>().norm() * radius;
+}
+
+//==============================================================================
 bool CollisionDetector::isAdjacentBodies(const dynamics::BodyNode* _bodyNode1,
                                          const dynamics::BodyNode* _bodyNode2)
 {
@@ -331,8 +593,10 @@ bool CollisionDetector::isAdjacentBodies(const dynamics::BodyNode* _bodyNode1,
 
 CollisionNode* CollisionDetector::getCollisionNode(
     const dynamics::BodyNode* _bodyNode) {
-  if (mBodyCollisionMap.find(_bodyNode) != mBodyCollisionMap.end())
-    return mBodyCollisionMap[_bodyNode];
+  std::unordered_map<const dynamics::BodyNode*, CollisionNode*>::iterator it
+      = mBodyCollisionMap.find(_bodyNode);
+  if (it != mBodyCollisionMap.end())
+    return it->second;
   else
     return NULL;
 }
@@ -38,8 +38,10 @@
 #ifndef DART_COLLISION_COLLISIONDETECTOR_H_
 #define DART_COLLISION_COLLISIONDETECTOR_H_
 
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <map>
 
 #include <Eigen/Dense>
 
@@ -85,7 +87,8 @@ struct Contact {
   /// Second colliding shape of the first body node
   dynamics::Shape* shape2;
 
-  /// Penetration depth
+  /// Penetration depth, or the negative gap between the bodies for a
+  /// speculative contact (see CollisionDetector::detectSpeculativeContacts())
   double penetrationDepth;
 
   // TODO(JS): triID1 will be deprecated when we don't use fcl_mesh
@@ -96,12 +99,59 @@ struct Contact {
   /// \brief
   int triID2;
 
+  /// Identifier of the contact point that stays the same across time steps
+  /// for as long as the collision detector keeps tracking the point, or 0 if
+  /// the detector does not track contact points over time
+  size_t id;
+
   // TODO(JS): userData is an experimental variable.
   /// \brief User data.
   void* userData;
 };
 
+/// Result of a distance query
+struct DistanceResult {
+  // To get byte-aligned Eigen vectors
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /// Distance between the bodies, or the negative depth of their penetration
+  double distance;
+
+  /// Closest point of bodyNode1 w.r.t. the world frame
+  Eigen::Vector3d point1;
+
+  /// Closest point of bodyNode2 w.r.t. the world frame
+  Eigen::Vector3d point2;
+
+  /// First body node of the closest pair
+  dynamics::BodyNode* bodyNode1;
+
+  /// Second body node of the closest pair
+  dynamics::BodyNode* bodyNode2;
+
+  /// Closest shape of the first body node
+  dynamics::Shape* shape1;
+
+  /// Closest shape of the second body node
+  dynamics::Shape* shape2;
+};
+
 /// \brief class CollisionDetector
+///
+/// Whether two bodies are tested for collision is decided by
+/// isCollidable(), from the cheapest test to the most expensive one: both
+/// bodies must be collidable, they must not both stay still for a sub-step of
+/// simulation::World::step(), the collision category of each body must
+/// overlap the collision mask of the other (see
+/// dynamics::BodyNode::setCollisionCategory()), the pair must not be disabled
+/// with disablePair(), and bodies of the same skeleton must pass its
+/// self-collision settings, including the pairs disabled with
+/// dynamics::Skeleton::disableSelfCollisionPair().
+///
+/// Collision nodes are found through a hash map and removed by moving the
+/// last node into their place, so adding and removing a body takes constant
+/// time. Disabled pairs are kept in a hash set keyed by the collision nodes,
+/// which stay valid while other nodes come and go.
 class CollisionDetector
 {
 public:
@@ -111,6 +161,10 @@ public:
   /// \brief Destructor
   virtual ~CollisionDetector();
 
+  /// \brief Create a collision detector of the same type and with the same
+  /// settings as this one, but without any skeletons
+  virtual CollisionDetector* cloneWithoutCollisionObjects() const = 0;
+
   /// \brief Add skeleton
   virtual void addSkeleton(dynamics::Skeleton* _skeleton);
 
@@ -165,14 +219,57 @@ public:
   /// \brief
   void setNumMaxContacs(int _num);
 
-  /// \brief
+  /// \brief Set the time step of the simulation. Detectors that keep contact
+  /// points over time steps use it; the others ignore it.
+  void setTimeStep(double _timeStep);
+
+  /// \brief Get the time step of the simulation
+  double getTimeStep() const;
+
+  /// \brief Return true if _node1 and _node2 may collide
   bool isCollidable(const CollisionNode* _node1, const CollisionNode* _node2);
 
+  /// \brief Return true if _node may collide with any other node at all.
+  /// Detectors use this to skip a node before pairing it with others.
+  bool isCollidable(const CollisionNode* _node) const;
+
+  /// \brief Return the distance between the collision shapes of _node1 and
+  /// _node2, or the negative depth of their penetration. The separating
+  /// direction of every pair of shapes is kept to warm-start the next query
+  /// on the same pair. Once the distance is known to be larger than
+  /// _threshold the query stops early and returns a value larger than
+  /// _threshold, whose points are approximate.
+  double computeDistance(dynamics::BodyNode* _node1,
+                         dynamics::BodyNode* _node2,
+                         DistanceResult* _result = NULL,
+                         double _threshold
+                             = std::numeric_limits<double>::infinity());
+
+  /// \brief Add speculative contacts for the bodies with CCD enabled (see
+  /// dynamics::BodyNode::setCCDEnabled()), to be called after
+  /// detectCollision(). A pair of bodies that are not in contact yet, but
+  /// whose closest points may meet within the time step at the current
+  /// velocities, gets a contact at its closest points with the negative gap
+  /// as penetration depth. Return the number of added contacts.
+  size_t detectSpeculativeContacts();
+
+  /// \brief Return the smallest distance between the bodies of _skeleton and
+  /// the bodies of the other skeletons that they may collide with (see
+  /// isCollidable()). _result is set to the closest pair of bodies, and the
+  /// threshold tightens to the closest distance found so far.
+  double computeDistance(dynamics::Skeleton* _skeleton,
+                         DistanceResult* _result = NULL,
+                         double _threshold
+                             = std::numeric_limits<double>::infinity());
+
 protected:
   /// \brief
   virtual bool detectCollision(CollisionNode* _node1, CollisionNode* _node2,
                                bool _calculateContactPoints) = 0;
 
+  /// \brief Return the collision node of _bodyNode, or NULL if there is none
+  CollisionNode* getCollisionNode(const dynamics::BodyNode* _bodyNode);
+
   /// \brief
   std::vector<Contact> mContacts;
 
@@ -182,34 +279,56 @@ protected:
   /// \brief
   int mNumMaxContacts;
 
+  /// \brief Time step of the simulation
+  double mTimeStep;
+
   /// \brief Skeleton array
   std::vector<dynamics::Skeleton*> mSkeletons;
 
+  /// \brief Index of each skeleton in mSkeletons
+  std::unordered_map<const dynamics::Skeleton*, size_t> mSkeletonIndices;
+
 private:
   /// \brief Return true if _skeleton is contained
   bool containSkeleton(const dynamics::Skeleton* _skeleton);
 
-  /// \brief
+  /// \brief Return false if the pair was disabled by disablePair()
   bool getPairCollidable(const CollisionNode* _node1,
-                         const CollisionNode* _node2);
+                         const CollisionNode* _node2) const;
 
-  /// \brief
+  /// \brief Enable or disable the pair of _node1 and _node2
   void setPairCollidable(const CollisionNode* _node1,
                          const CollisionNode* _node2,
                          bool _val);
 
+  /// \brief Update _result if a pair of shapes of _bodyNode1 and _bodyNode2
+  /// is closer than _result->distance and _threshold
+  void updateDistance(dynamics::BodyNode* _bodyNode1,
+                      dynamics::BodyNode* _bodyNode2, double _threshold,
+                      DistanceResult* _result);
+
+  /// \brief Return an upper bound of the speed of the points of the
+  /// collision shapes of _bodyNode
+  double computeMaxSpeed(const dynamics::BodyNode* _bodyNode) const;
+
   /// \brief Return true if _bodyNode1 and _bodyNode2 are adjacent bodies
   bool isAdjacentBodies(const dynamics::BodyNode* _bodyNode1,
                         const dynamics::BodyNode* _bodyNode2);
 
   /// \brief
-  CollisionNode* getCollisionNode(const dynamics::BodyNode* _bodyNode);
-
-  /// \brief
-  std::map<const dynamics::BodyNode*, CollisionNode*> mBodyCollisionMap;
-
-  /// \brief
-  std::vector<std::vector<bool> > mCollidablePairs;
+  std::unordered_map<const dynamics::BodyNode*, CollisionNode*>
+      mBodyCollisionMap;
+
+  /// \brief Pairs disabled by disablePair(), stored in both directions
+  std::unordered_map<const CollisionNode*,
+                     std::unordered_set<const CollisionNode*> > mDisabledPairs;
+
+  /// \brief Separating directions of the convex pieces of pairs of shapes,
+  /// which warm-start the next distance query of the pair
+  std::unordered_map<const dynamics::Shape*,
+                     std::unordered_map<const dynamics::Shape*,
+                                        std::vector<Eigen::Vector3d> > >
+      mDistanceDirections;
 };
 
 }  // namespace collision
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/RangeSensor.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "dart/math/Helpers.h"
+
+namespace dart {
+namespace collision {
+
+//==============================================================================
+RangeSensor::RangeSensor(size_t _numRows, size_t _numCols,
+                         const std::vector<Eigen::Vector3d>& _directions,
+                         const std::vector<double>& _rangeScales,
+                         double _maxDistance)
+  : mNumRows(_numRows),
+    mNumCols(_numCols),
+    mDirections(_directions),
+    mRangeScales(_rangeScales),
+    mMaxDistance(_maxDistance),
+    mRanges(Eigen::MatrixXd::Constant(
+              _numRows, _numCols, std::numeric_limits<double>::infinity()))
+{
+  assert(mDirections.size() == mNumRows * mNumCols);
+  assert(mRangeScales.size() == mDirections.size());
+}
+
+//==============================================================================
+RangeSensor::~RangeSensor()
+{
+}
+
+//==============================================================================
+size_t RangeSensor::getNumRows() const
+{
+  return mNumRows;
+}
+
+//==============================================================================
+size_t RangeSensor::getNumCols() const
+{
+  return mNumCols;
+}
+
+//==============================================================================
+void RangeSensor::setMaxDistance(double _maxDistance)
+{
+  mMaxDistance = _maxDistance;
+}
+
+//==============================================================================
+double RangeSensor::getMaxDistance() const
+{
+  return mMaxDistance;
+}
+
+//==============================================================================
+const std::vector<Eigen::Vector3d>& RangeSensor::getDirections() const
+{
+  return mDirections;
+}
+
+//==============================================================================
+size_t RangeSensor::scan(const RayCaster& _rayCaster,
+                         const Eigen::Isometry3d& _transform, uint32_t _mask)
+{
+  const size_t numRays = mDirections.size();
+  mRays.resize(numRays);
+  for (size_t i = 0; i < numRays; ++i)
+  {
+    mRays[i].origin = _transform.translation();
+    mRays[i].direction = _transform.linear() * mDirections[i];
+    mRays[i].maxDistance = mMaxDistance;
+  }
+
+  const size_t numHits = _rayCaster.castRays(mRays, &mHits, _mask);
+
+  // mRanges is column-major, while the rays go row by row
+  for (size_t i = 0; i < mNumRows; ++i)
+  {
+    for (size_t j = 0; j < mNumCols; ++j)
+    {
+      const size_t index = i * mNumCols + j;
+      mRanges(i, j) = mHits[index].distance * mRangeScales[index];
+    }
+  }
+
+  return numHits;
+}
+
+//==============================================================================
+const Eigen::MatrixXd& RangeSensor::getRanges() const
+{
+  return mRanges;
+}
+
+//==============================================================================
+const std::vector<Ray>& RangeSensor::getRays() const
+{
+  return mRays;
+}
+
+//==============================================================================
+const std::vector<RayHit>& RangeSensor::getHits() const
+{
+  return mHits;
+}
+
+//==============================================================================
+Lidar::Lidar(size_t _numHorizontalRays, size_t _numVerticalRays,
+             double _horizontalFov, double _verticalFov, double _maxDistance)
+  : RangeSensor(_numVerticalRays, _numHorizontalRays,
+                computeDirections(_numHorizontalRays, _numVerticalRays,
+                                  _horizontalFov, _verticalFov),
+                std::vector<double>(_numHorizontalRays * _numVerticalRays,
+                                    1.0),
+                _maxDistance)
+{
+}
+
+//==============================================================================
+Lidar::~Lidar()
+{
+}
+
+//==============================================================================
+std::vector<Eigen::Vector3d> Lidar::computeDirections(
+    size_t _numHorizontalRays, size_t _numVerticalRays,
+    double _horizontalFov, double _verticalFov)
+{
+  // A full circle would repeat the first azimuth at the end
+  const bool fullCircle = _horizontalFov >= 2.0 * DART_PI;
+  const double azimuthStep = _numHorizontalRays < 2 ? 0.0
+      : fullCircle ? 2.0 * DART_PI / _numHorizontalRays
+                   : _horizontalFov / (_numHorizontalRays - 1);
+  const double azimuthStart = fullCircle ? -DART_PI
+      : -0.5 * azimuthStep * (_numHorizontalRays - 1);
+  const double elevationStep = _numVerticalRays < 2 ? 0.0
+      : _verticalFov / (_numVerticalRays - 1);
+  const double elevationStart = 0.5 * elevationStep * (_numVerticalRays - 1);
+
+  std::vector<Eigen::Vector3d> directions;
+  directions.reserve(_numHorizontalRays * _numVerticalRays);
+  for (size_t i = 0; i < _numVerticalRays; ++i)
+  {
+    const double elevation = elevationStart - i * elevationStep;
+    for (size_t j = 0; j < _numHorizontalRays; ++j)
+    {
+      const double azimuth = azimuthStart + j * azimuthStep;
+      directions.push_back(Eigen::Vector3d(
+          std::cos(elevation) * std::cos(azimuth),
+          std::cos(elevation) * std::sin(azimuth),
+          std::sin(elevation)));
+    }
+  }
+
+  return directions;
+}
+
+//==============================================================================
+DepthCamera::DepthCamera(size_t _width, size_t _height, double _verticalFov,
+                         double _maxDistance)
+  : RangeSensor(_height, _width,
+                computeDirections(_width, _height, _verticalFov),
+                computeRangeScales(
+                  computeDirections(_width, _height, _verticalFov)),
+                _maxDistance)
+{
+}
+
+//==============================================================================
+DepthCamera::~DepthCamera()
+{
+}
+
+//==============================================================================
+std::vector<Eigen::Vector3d> DepthCamera::computeDirections(
+    size_t _width, size_t _height, double _verticalFov)
+{
+  // Focal length in pixels
+  const double focal = 0.5 * _height / std::tan(0.5 * _verticalFov);
+
+  std::vector<Eigen::Vector3d> directions;
+  directions.reserve(_width * _height);
+  for (size_t i = 0; i < _height; ++i)
+  {
+    for (size_t j = 0; j < _width; ++j)
+    {
+      directions.push_back(Eigen::Vector3d(
+          j + 0.5 - 0.5 * _width, i + 0.5 - 0.5 * _height, focal)
+                           .normalized());
+    }
+  }
+
+  return directions;
+}
+
+//==============================================================================
+std::vector<double> DepthCamera::computeRangeScales(
+    const std::vector<Eigen::Vector3d>& _directions)
+{
+  std::vector<double> scales(_directions.size());
+  for (size_t i = 0; i < _directions.size(); ++i)
+    scales[i] = _directions[i][2];
+
+  return scales;
+}
+
+}  // namespace collision
+}  // namespace dart
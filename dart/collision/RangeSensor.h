@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_RANGESENSOR_H_
+#define DART_COLLISION_RANGESENSOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/collision/RayCaster.h"
+
+namespace dart {
+namespace collision {
+
+/// \brief class RangeSensor
+///
+/// RangeSensor measures distances along a fixed grid of directions with a
+/// RayCaster. The rays of a scan are kept between scans, so scanning does not
+/// allocate memory once the first scan is done. Lidar and DepthCamera set up
+/// the directions of the two common kinds of sensors.
+class RangeSensor
+{
+public:
+  /// \brief Constructor. _directions holds _numRows * _numCols unit
+  /// directions in the sensor frame in row-major order, and each range is the
+  /// distance along its direction times the matching entry of _rangeScales.
+  RangeSensor(size_t _numRows, size_t _numCols,
+              const std::vector<Eigen::Vector3d>& _directions,
+              const std::vector<double>& _rangeScales, double _maxDistance);
+
+  /// \brief Destructor
+  virtual ~RangeSensor();
+
+  /// \brief Get the number of rows of the grid of directions
+  size_t getNumRows() const;
+
+  /// \brief Get the number of columns of the grid of directions
+  size_t getNumCols() const;
+
+  /// \brief Set the largest distance that is measured
+  void setMaxDistance(double _maxDistance);
+
+  /// \brief Get the largest distance that is measured
+  double getMaxDistance() const;
+
+  /// \brief Get the direction of each ray in the sensor frame
+  const std::vector<Eigen::Vector3d>& getDirections() const;
+
+  /// \brief Cast the rays of the sensor from the sensor frame _transform
+  /// w.r.t. the world frame. Only the shapes of bodies whose collision
+  /// category overlaps _mask are seen. Return the number of rays that hit a
+  /// shape.
+  size_t scan(const RayCaster& _rayCaster, const Eigen::Isometry3d& _transform,
+              uint32_t _mask = 0xFFFFFFFF);
+
+  /// \brief Get the ranges of the last scan as a _numRows by _numCols
+  /// matrix. Rays that hit nothing read infinity.
+  const Eigen::MatrixXd& getRanges() const;
+
+  /// \brief Get the rays of the last scan in row-major order
+  const std::vector<Ray>& getRays() const;
+
+  /// \brief Get the hits of the last scan in row-major order
+  const std::vector<RayHit>& getHits() const;
+
+protected:
+  /// \brief Number of rows of the grid of directions
+  size_t mNumRows;
+
+  /// \brief Number of columns of the grid of directions
+  size_t mNumCols;
+
+  /// \brief Direction of each ray in the sensor frame
+  std::vector<Eigen::Vector3d> mDirections;
+
+  /// \brief Factor from the distance along each ray to its range
+  std::vector<double> mRangeScales;
+
+  /// \brief Largest distance that is measured
+  double mMaxDistance;
+
+  /// \brief Rays of the last scan
+  std::vector<Ray> mRays;
+
+  /// \brief Hits of the last scan
+  std::vector<RayHit> mHits;
+
+  /// \brief Ranges of the last scan
+  Eigen::MatrixXd mRanges;
+};
+
+/// \brief class Lidar
+///
+/// Lidar casts rays on a grid of azimuths and elevations about the z-axis of
+/// its frame, where the x-axis points at zero azimuth and elevation. Rows go
+/// from the highest elevation down, and columns from the lowest azimuth up.
+/// The ranges are the distances along the rays.
+class Lidar : public RangeSensor
+{
+public:
+  /// \brief Constructor. The azimuths span _horizontalFov centered on the
+  /// x-axis, or the full circle without repeating a ray if _horizontalFov is
+  /// 2 pi or more. The elevations span _verticalFov centered on the
+  /// xy-plane.
+  Lidar(size_t _numHorizontalRays, size_t _numVerticalRays,
+        double _horizontalFov, double _verticalFov, double _maxDistance);
+
+  /// \brief Destructor
+  virtual ~Lidar();
+
+protected:
+  /// \brief Directions of the rays on the grid of azimuths and elevations
+  static std::vector<Eigen::Vector3d> computeDirections(
+      size_t _numHorizontalRays, size_t _numVerticalRays,
+      double _horizontalFov, double _verticalFov);
+};
+
+/// \brief class DepthCamera
+///
+/// DepthCamera is a pinhole camera that looks along the z-axis of its frame,
+/// with the x-axis to the right and the y-axis down the image. The ranges are
+/// the depths of the hits along the z-axis, so they form a depth image.
+class DepthCamera : public RangeSensor
+{
+public:
+  /// \brief Constructor. _verticalFov is the angle between the top and the
+  /// bottom of the image, and pixels are square.
+  DepthCamera(size_t _width, size_t _height, double _verticalFov,
+              double _maxDistance);
+
+  /// \brief Destructor
+  virtual ~DepthCamera();
+
+protected:
+  /// \brief Directions of the pixels of a _width by _height image
+  static std::vector<Eigen::Vector3d> computeDirections(
+      size_t _width, size_t _height, double _verticalFov);
+
+  /// \brief Depth of each pixel per unit distance along its ray
+  static std::vector<double> computeRangeScales(
+      const std::vector<Eigen::Vector3d>& _directions);
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_RANGESENSOR_H_
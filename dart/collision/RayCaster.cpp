@@ -0,0 +1,962 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/RayCaster.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include <assimp/scene.h>
+
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/HeightmapShape.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/Skeleton.h"
+
+#define DART_RAY_EPS 1e-12
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// Largest number of items in a leaf of a hierarchy
+const int MAX_LEAF_SIZE = 4;
+
+/// Largest number of nodes waiting on the traversal stack
+const int MAX_STACK_SIZE = 64;
+
+typedef Eigen::Array<double, 4, 1> Array4d;
+
+//==============================================================================
+double inverse(double _value)
+{
+  // Avoid infinities, which would turn into NaNs on the faces of the boxes
+  if (std::abs(_value) < DART_RAY_EPS)
+    return _value < 0.0 ? -1.0 / DART_RAY_EPS : 1.0 / DART_RAY_EPS;
+
+  return 1.0 / _value;
+}
+
+//==============================================================================
+template <typename NodeT>
+void buildNode(const std::vector<Eigen::Vector3d>& _mins,
+               const std::vector<Eigen::Vector3d>& _maxs,
+               int _begin, int _end, std::vector<int>* _order,
+               std::vector<NodeT>* _nodes)
+{
+  const int index = static_cast<int>(_nodes->size());
+  _nodes->push_back(NodeT());
+
+  Eigen::Vector3d min = Eigen::Vector3d::Constant(
+        std::numeric_limits<double>::infinity());
+  Eigen::Vector3d max = -min;
+  Eigen::Vector3d centerMin = min;
+  Eigen::Vector3d centerMax = max;
+  for (int i = _begin; i < _end; ++i)
+  {
+    const int item = (*_order)[i];
+    min = min.cwiseMin(_mins[item]);
+    max = max.cwiseMax(_maxs[item]);
+    const Eigen::Vector3d center = _mins[item] + _maxs[item];
+    centerMin = centerMin.cwiseMin(center);
+    centerMax = centerMax.cwiseMax(center);
+  }
+
+  (*_nodes)[index].min = min;
+  (*_nodes)[index].max = max;
+  (*_nodes)[index].axis = 0;
+
+  if (_end - _begin <= MAX_LEAF_SIZE)
+  {
+    (*_nodes)[index].index = _begin;
+    (*_nodes)[index].count = _end - _begin;
+    return;
+  }
+
+  // Split at the median of the centers along the axis they spread the most
+  int axis;
+  (centerMax - centerMin).maxCoeff(&axis);
+  const int middle = (_begin + _end) / 2;
+  std::nth_element(_order->begin() + _begin, _order->begin() + middle,
+                   _order->begin() + _end,
+                   [&](int _a, int _b)
+  {
+    return _mins[_a][axis] + _maxs[_a][axis]
+        < _mins[_b][axis] + _maxs[_b][axis];
+  });
+
+  buildNode(_mins, _maxs, _begin, middle, _order, _nodes);
+  (*_nodes)[index].index = static_cast<int>(_nodes->size());
+  (*_nodes)[index].count = 0;
+  (*_nodes)[index].axis = axis;
+  buildNode(_mins, _maxs, middle, _end, _order, _nodes);
+}
+
+//==============================================================================
+/// Build a hierarchy over the boxes from _mins to _maxs. _order tells which
+/// box is at each position of the leaves.
+template <typename NodeT>
+void buildTree(const std::vector<Eigen::Vector3d>& _mins,
+               const std::vector<Eigen::Vector3d>& _maxs,
+               std::vector<int>* _order, std::vector<NodeT>* _nodes)
+{
+  const int numItems = static_cast<int>(_mins.size());
+  _order->resize(numItems);
+  for (int i = 0; i < numItems; ++i)
+    (*_order)[i] = i;
+
+  _nodes->clear();
+  if (numItems == 0)
+    return;
+
+  _nodes->reserve(2 * numItems / MAX_LEAF_SIZE + 1);
+  buildNode(_mins, _maxs, 0, numItems, _order, _nodes);
+}
+
+//==============================================================================
+/// Return true if the ray enters the box from _min to _max within _tMax
+bool intersectBounds(const Eigen::Vector3d& _min, const Eigen::Vector3d& _max,
+                     const Eigen::Vector3d& _origin,
+                     const Eigen::Vector3d& _invDirection, double _tMax,
+                     double* _tNear, double* _tFar)
+{
+  double tNear = 0.0;
+  double tFar = _tMax;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double t0 = (_min[i] - _origin[i]) * _invDirection[i];
+    const double t1 = (_max[i] - _origin[i]) * _invDirection[i];
+    tNear = std::max(tNear, std::min(t0, t1));
+    tFar = std::min(tFar, std::max(t0, t1));
+  }
+
+  *_tNear = tNear;
+  *_tFar = tFar;
+  return tNear <= tFar;
+}
+
+//==============================================================================
+bool intersectBox(const Eigen::Vector3d& _halfSize,
+                  const Eigen::Vector3d& _origin,
+                  const Eigen::Vector3d& _direction, double _tMax,
+                  double* _t, Eigen::Vector3d* _normal)
+{
+  double tNear = -std::numeric_limits<double>::infinity();
+  double tFar = std::numeric_limits<double>::infinity();
+  int axis = -1;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::abs(_direction[i]) < DART_RAY_EPS)
+    {
+      if (std::abs(_origin[i]) > _halfSize[i])
+        return false;
+      continue;
+    }
+
+    double t0 = (-_halfSize[i] - _origin[i]) / _direction[i];
+    double t1 = (_halfSize[i] - _origin[i]) / _direction[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    if (t0 > tNear)
+    {
+      tNear = t0;
+      axis = i;
+    }
+    tFar = std::min(tFar, t1);
+  }
+
+  if (axis < 0 || tNear > tFar || tNear < 0.0 || tNear > _tMax)
+    return false;
+
+  *_t = tNear;
+  _normal->setZero();
+  (*_normal)[axis] = _direction[axis] > 0.0 ? -1.0 : 1.0;
+  return true;
+}
+
+//==============================================================================
+bool intersectEllipsoid(const Eigen::Vector3d& _radii,
+                        const Eigen::Vector3d& _origin,
+                        const Eigen::Vector3d& _direction, double _tMax,
+                        double* _t, Eigen::Vector3d* _normal)
+{
+  // Intersect with the unit sphere in coordinates scaled by the radii
+  const Eigen::Vector3d o = _origin.cwiseQuotient(_radii);
+  const Eigen::Vector3d d = _direction.cwiseQuotient(_radii);
+  const double a = d.squaredNorm();
+  const double b = o.dot(d);
+  const double c = o.squaredNorm() - 1.0;
+  if (c <= 0.0)
+    return false;
+
+  const double discriminant = b * b - a * c;
+  if (discriminant < 0.0)
+    return false;
+
+  const double t = (-b - std::sqrt(discriminant)) / a;
+  if (t < 0.0 || t > _tMax)
+    return false;
+
+  const Eigen::Vector3d point = _origin + t * _direction;
+  *_t = t;
+  *_normal = point.cwiseQuotient(_radii.cwiseProduct(_radii)).normalized();
+  return true;
+}
+
+//==============================================================================
+bool intersectCylinder(double _radius, double _height,
+                       const Eigen::Vector3d& _origin,
+                       const Eigen::Vector3d& _direction, double _tMax,
+                       double* _t, Eigen::Vector3d* _normal)
+{
+  const double halfHeight = 0.5 * _height;
+  const double radius2 = _radius * _radius;
+  const double originRadius2 = _origin.head<2>().squaredNorm();
+  if (originRadius2 <= radius2 && std::abs(_origin[2]) <= halfHeight)
+    return false;
+
+  double best = std::numeric_limits<double>::infinity();
+
+  // Side
+  const double a = _direction.head<2>().squaredNorm();
+  if (a > DART_RAY_EPS)
+  {
+    const double b = _origin.head<2>().dot(_direction.head<2>());
+    const double c = originRadius2 - radius2;
+    const double discriminant = b * b - a * c;
+    if (discriminant >= 0.0)
+    {
+      const double t = (-b - std::sqrt(discriminant)) / a;
+      const double z = _origin[2] + t * _direction[2];
+      if (t >= 0.0 && std::abs(z) <= halfHeight)
+      {
+        best = t;
+        const Eigen::Vector3d point = _origin + t * _direction;
+        *_normal = Eigen::Vector3d(point[0], point[1], 0.0) / _radius;
+      }
+    }
+  }
+
+  // Caps, which can only be entered from beyond them
+  if (std::abs(_direction[2]) > DART_RAY_EPS)
+  {
+    const double side = _origin[2] > 0.0 ? 1.0 : -1.0;
+    const double t = (side * halfHeight - _origin[2]) / _direction[2];
+    if (side * _origin[2] > halfHeight && t >= 0.0 && t < best)
+    {
+      const Eigen::Vector3d point = _origin + t * _direction;
+      if (point.head<2>().squaredNorm() <= radius2)
+      {
+        best = t;
+        *_normal = Eigen::Vector3d(0.0, 0.0, side);
+      }
+    }
+  }
+
+  if (best == std::numeric_limits<double>::infinity() || best > _tMax)
+    return false;
+
+  *_t = best;
+  return true;
+}
+
+//==============================================================================
+bool intersectPlane(const Eigen::Vector3d& _planeNormal, double _offset,
+                    const Eigen::Vector3d& _origin,
+                    const Eigen::Vector3d& _direction, double _tMax,
+                    double* _t, Eigen::Vector3d* _normal)
+{
+  // The plane bounds a half-space, which rays only enter from above
+  const double height = _planeNormal.dot(_origin) - _offset;
+  const double rate = _planeNormal.dot(_direction);
+  if (height <= 0.0 || rate >= 0.0)
+    return false;
+
+  const double t = -height / rate;
+  if (t > _tMax)
+    return false;
+
+  *_t = t;
+  *_normal = _planeNormal;
+  return true;
+}
+
+//==============================================================================
+bool intersectTriangle(const Eigen::Vector3d& _a, const Eigen::Vector3d& _b,
+                       const Eigen::Vector3d& _c,
+                       const Eigen::Vector3d& _origin,
+                       const Eigen::Vector3d& _direction, double _tMax,
+                       double* _t, Eigen::Vector3d* _normal)
+{
+  const Eigen::Vector3d edge1 = _b - _a;
+  const Eigen::Vector3d edge2 = _c - _a;
+  const Eigen::Vector3d p = _direction.cross(edge2);
+  const double determinant = edge1.dot(p);
+  if (std::abs(determinant) < DART_RAY_EPS)
+    return false;
+
+  const double invDeterminant = 1.0 / determinant;
+  const Eigen::Vector3d s = _origin - _a;
+  const double u = s.dot(p) * invDeterminant;
+  if (u < 0.0 || u > 1.0)
+    return false;
+
+  const Eigen::Vector3d q = s.cross(edge1);
+  const double v = _direction.dot(q) * invDeterminant;
+  if (v < 0.0 || u + v > 1.0)
+    return false;
+
+  const double t = edge2.dot(q) * invDeterminant;
+  if (t < 0.0 || t > _tMax)
+    return false;
+
+  *_t = t;
+  *_normal = edge1.cross(edge2).normalized();
+  return true;
+}
+
+//==============================================================================
+template <typename MeshTreeT>
+bool intersectMesh(const MeshTreeT& _tree, const Eigen::Vector3d& _origin,
+                   const Eigen::Vector3d& _direction, double _tMax,
+                   double* _t, Eigen::Vector3d* _normal)
+{
+  if (_tree.nodes.empty())
+    return false;
+
+  const Eigen::Vector3d invDirection(inverse(_direction[0]),
+                                     inverse(_direction[1]),
+                                     inverse(_direction[2]));
+  bool hit = false;
+  int stack[MAX_STACK_SIZE];
+  int size = 0;
+  stack[size++] = 0;
+  while (size > 0)
+  {
+    const auto& node = _tree.nodes[stack[--size]];
+    double tNear;
+    double tFar;
+    if (!intersectBounds(node.min, node.max, _origin, invDirection, _tMax,
+                         &tNear, &tFar))
+    {
+      continue;
+    }
+
+    if (node.count > 0)
+    {
+      for (int i = node.index; i < node.index + node.count; ++i)
+      {
+        const Eigen::Vector3i& triangle = _tree.triangles[i];
+        if (intersectTriangle(_tree.vertices[triangle[0]],
+                              _tree.vertices[triangle[1]],
+                              _tree.vertices[triangle[2]],
+                              _origin, _direction, _tMax, _t, _normal))
+        {
+          _tMax = *_t;
+          hit = true;
+        }
+      }
+      continue;
+    }
+
+    // Visit the near child first
+    const int near = &node - _tree.nodes.data() + 1;
+    const int far = node.index;
+    assert(size + 2 <= MAX_STACK_SIZE);
+    stack[size++] = _direction[node.axis] < 0.0 ? near : far;
+    stack[size++] = _direction[node.axis] < 0.0 ? far : near;
+  }
+
+  return hit;
+}
+
+//==============================================================================
+bool intersectHeightmap(const dynamics::HeightmapShape* _heightmap,
+                        const Eigen::Vector3d& _origin,
+                        const Eigen::Vector3d& _direction, double _tMax,
+                        double* _t, Eigen::Vector3d* _normal)
+{
+  const Eigen::Vector3d& scale = _heightmap->getScale();
+  const int numRows = static_cast<int>(_heightmap->getNumRows());
+  const int numCols = static_cast<int>(_heightmap->getNumCols());
+  const Eigen::Vector3d corner = _heightmap->getVertex(0, 0);
+  const Eigen::Vector3d min(corner[0], corner[1],
+                            _heightmap->getMinHeight());
+  const Eigen::Vector3d max(-corner[0], -corner[1],
+                            _heightmap->getMaxHeight());
+
+  const Eigen::Vector3d invDirection(inverse(_direction[0]),
+                                     inverse(_direction[1]),
+                                     inverse(_direction[2]));
+  double tEnter;
+  double tExit;
+  if (!intersectBounds(min, max, _origin, invDirection, _tMax,
+                       &tEnter, &tExit))
+  {
+    return false;
+  }
+
+  // Walk the cells under the ray in the order the ray crosses them
+  const Eigen::Vector3d start = _origin + tEnter * _direction;
+  int col = static_cast<int>(std::floor((start[0] - min[0]) / scale[0]));
+  int row = static_cast<int>(std::floor((start[1] - min[1]) / scale[1]));
+  col = std::min(std::max(col, 0), numCols - 2);
+  row = std::min(std::max(row, 0), numRows - 2);
+
+  const double inf = std::numeric_limits<double>::infinity();
+  const int stepCol = _direction[0] > 0.0 ? 1 : -1;
+  const int stepRow = _direction[1] > 0.0 ? 1 : -1;
+  const double deltaCol = std::abs(_direction[0]) > DART_RAY_EPS
+      ? scale[0] / std::abs(_direction[0]) : inf;
+  const double deltaRow = std::abs(_direction[1]) > DART_RAY_EPS
+      ? scale[1] / std::abs(_direction[1]) : inf;
+  double nextCol = std::abs(_direction[0]) > DART_RAY_EPS
+      ? (min[0] + (col + (stepCol > 0 ? 1 : 0)) * scale[0] - _origin[0])
+        / _direction[0]
+      : inf;
+  double nextRow = std::abs(_direction[1]) > DART_RAY_EPS
+      ? (min[1] + (row + (stepRow > 0 ? 1 : 0)) * scale[1] - _origin[1])
+        / _direction[1]
+      : inf;
+
+  while (true)
+  {
+    const Eigen::Vector3d v00 = _heightmap->getVertex(row, col);
+    const Eigen::Vector3d v01 = _heightmap->getVertex(row, col + 1);
+    const Eigen::Vector3d v10 = _heightmap->getVertex(row + 1, col);
+    const Eigen::Vector3d v11 = _heightmap->getVertex(row + 1, col + 1);
+
+    bool hit = false;
+    double tMax = _tMax;
+    if (intersectTriangle(v00, v01, v11, _origin, _direction, tMax,
+                          _t, _normal))
+    {
+      tMax = *_t;
+      hit = true;
+    }
+    if (intersectTriangle(v00, v11, v10, _origin, _direction, tMax,
+                          _t, _normal))
+    {
+      hit = true;
+    }
+    if (hit)
+      return true;
+
+    if (std::min(nextCol, nextRow) > tExit)
+      return false;
+
+    if (nextCol < nextRow)
+    {
+      col += stepCol;
+      nextCol += deltaCol;
+      if (col < 0 || col > numCols - 2)
+        return false;
+    }
+    else
+    {
+      row += stepRow;
+      nextRow += deltaRow;
+      if (row < 0 || row > numRows - 2)
+        return false;
+    }
+  }
+}
+
+}  // namespace
+
+//==============================================================================
+RayCaster::RayCaster()
+  : mParallel(true)
+{
+}
+
+//==============================================================================
+RayCaster::~RayCaster()
+{
+}
+
+//==============================================================================
+void RayCaster::addSkeleton(dynamics::Skeleton* _skeleton)
+{
+  assert(_skeleton != NULL);
+
+  if (std::find(mSkeletons.begin(), mSkeletons.end(), _skeleton)
+      == mSkeletons.end())
+  {
+    mSkeletons.push_back(_skeleton);
+  }
+}
+
+//==============================================================================
+void RayCaster::removeSkeleton(dynamics::Skeleton* _skeleton)
+{
+  mSkeletons.erase(std::remove(mSkeletons.begin(), mSkeletons.end(),
+                               _skeleton),
+                   mSkeletons.end());
+
+  // The bodies of _skeleton may be deleted before the next update()
+  mItems.clear();
+  mNodes.clear();
+  mPlanes.clear();
+}
+
+//==============================================================================
+void RayCaster::removeAllSkeletons()
+{
+  mSkeletons.clear();
+  mItems.clear();
+  mNodes.clear();
+  mPlanes.clear();
+  mMeshTrees.clear();
+}
+
+//==============================================================================
+size_t RayCaster::getNumSkeletons() const
+{
+  return mSkeletons.size();
+}
+
+//==============================================================================
+void RayCaster::update()
+{
+  using namespace dynamics;
+
+  std::vector<std::shared_ptr<MeshTree> > previousMeshTrees;
+  previousMeshTrees.swap(mMeshTrees);
+
+  std::vector<Item> items;
+  std::vector<Eigen::Vector3d> mins;
+  std::vector<Eigen::Vector3d> maxs;
+  mPlanes.clear();
+
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    Skeleton* skeleton = mSkeletons[i];
+    for (size_t j = 0; j < skeleton->getNumBodyNodes(); ++j)
+    {
+      BodyNode* bodyNode = skeleton->getBodyNode(j);
+      const Eigen::Isometry3d& bodyTransform = bodyNode->getWorldTransform();
+      for (size_t k = 0; k < bodyNode->getNumCollisionShapes(); ++k)
+      {
+        Shape* shape = bodyNode->getCollisionShape(k);
+        const Eigen::Isometry3d transform
+            = bodyTransform * shape->getLocalTransform();
+
+        Item item;
+        item.bodyNode = bodyNode;
+        item.shape = shape;
+        item.rotation = transform.linear();
+        item.translation = transform.translation();
+        item.meshTree = NULL;
+
+        // Bounding box of the shape in its own frame
+        Eigen::Vector3d min;
+        Eigen::Vector3d max;
+        switch (shape->getShapeType())
+        {
+          case Shape::BOX:
+            max = 0.5 * static_cast<BoxShape*>(shape)->getSize();
+            min = -max;
+            break;
+          case Shape::ELLIPSOID:
+            max = 0.5 * static_cast<EllipsoidShape*>(shape)->getSize();
+            min = -max;
+            break;
+          case Shape::CYLINDER:
+          {
+            const CylinderShape* cylinder
+                = static_cast<CylinderShape*>(shape);
+            max = Eigen::Vector3d(cylinder->getRadius(),
+                                  cylinder->getRadius(),
+                                  0.5 * cylinder->getHeight());
+            min = -max;
+            break;
+          }
+          case Shape::PLANE:
+            mPlanes.push_back(item);
+            continue;
+          case Shape::MESH:
+            item.meshTree = getMeshTree(static_cast<MeshShape*>(shape),
+                                        &previousMeshTrees);
+            if (item.meshTree->nodes.empty())
+              continue;
+            min = item.meshTree->nodes[0].min;
+            max = item.meshTree->nodes[0].max;
+            break;
+          case Shape::HEIGHTMAP:
+          {
+            const HeightmapShape* heightmap
+                = static_cast<HeightmapShape*>(shape);
+            min = heightmap->getVertex(0, 0);
+            max = -min;
+            min[2] = heightmap->getMinHeight();
+            max[2] = heightmap->getMaxHeight();
+            break;
+          }
+          default:
+            continue;
+        }
+
+        // Bounding box in the world frame
+        const Eigen::Vector3d center
+            = transform * Eigen::Vector3d(0.5 * (min + max));
+        const Eigen::Vector3d extent
+            = item.rotation.cwiseAbs() * Eigen::Vector3d(0.5 * (max - min));
+        items.push_back(item);
+        mins.push_back(center - extent);
+        maxs.push_back(center + extent);
+      }
+    }
+  }
+
+  std::vector<int> order;
+  buildTree(mins, maxs, &order, &mNodes);
+  mItems.resize(items.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    mItems[i] = items[order[i]];
+}
+
+//==============================================================================
+void RayCaster::setParallel(bool _parallel)
+{
+  mParallel = _parallel;
+}
+
+//==============================================================================
+bool RayCaster::isParallel() const
+{
+  return mParallel;
+}
+
+//==============================================================================
+bool RayCaster::castRay(const Ray& _ray, RayHit* _hit, uint32_t _mask) const
+{
+  return castPacket(&_ray, 1, _hit, _mask) > 0;
+}
+
+//==============================================================================
+size_t RayCaster::castRays(const Ray* _rays, size_t _numRays, RayHit* _hits,
+                           uint32_t _mask) const
+{
+  const int numPackets = static_cast<int>((_numRays + 3) / 4);
+  int numHits = 0;
+
+#pragma omp parallel for schedule(dynamic, 64) reduction(+:numHits) \
+    if(mParallel && numPackets > 1)
+  for (int i = 0; i < numPackets; ++i)
+  {
+    const size_t first = 4 * static_cast<size_t>(i);
+    numHits += castPacket(_rays + first, std::min<size_t>(4, _numRays - first),
+                          _hits + first, _mask);
+  }
+
+  return static_cast<size_t>(numHits);
+}
+
+//==============================================================================
+size_t RayCaster::castRays(const std::vector<Ray>& _rays,
+                           std::vector<RayHit>* _hits, uint32_t _mask) const
+{
+  _hits->resize(_rays.size());
+  if (_rays.empty())
+    return 0;
+
+  return castRays(_rays.data(), _rays.size(), _hits->data(), _mask);
+}
+
+//==============================================================================
+size_t RayCaster::castPacket(const Ray* _rays, size_t _numRays, RayHit* _hits,
+                             uint32_t _mask) const
+{
+  assert(_numRays >= 1 && _numRays <= 4);
+  const int numRays = static_cast<int>(_numRays);
+
+  // Lanes past the last ray repeat it, and their results are not kept
+  Array4d originX;
+  Array4d originY;
+  Array4d originZ;
+  Array4d invDirectionX;
+  Array4d invDirectionY;
+  Array4d invDirectionZ;
+  Array4d best;
+  for (int i = 0; i < 4; ++i)
+  {
+    const Ray& ray = _rays[std::min(i, numRays - 1)];
+    originX[i] = ray.origin[0];
+    originY[i] = ray.origin[1];
+    originZ[i] = ray.origin[2];
+    invDirectionX[i] = inverse(ray.direction[0]);
+    invDirectionY[i] = inverse(ray.direction[1]);
+    invDirectionZ[i] = inverse(ray.direction[2]);
+    best[i] = ray.maxDistance;
+  }
+
+  for (int i = 0; i < numRays; ++i)
+  {
+    _hits[i].distance = std::numeric_limits<double>::infinity();
+    _hits[i].normal.setZero();
+    _hits[i].bodyNode = NULL;
+    _hits[i].shape = NULL;
+  }
+
+  for (size_t i = 0; i < mPlanes.size(); ++i)
+  {
+    if (!(mPlanes[i].bodyNode->getCollisionCategory() & _mask))
+      continue;
+
+    for (int j = 0; j < numRays; ++j)
+    {
+      if (intersect(mPlanes[i], _rays[j], &_hits[j]))
+        best[j] = _hits[j].distance;
+    }
+  }
+
+  if (!mNodes.empty())
+  {
+    const Eigen::Vector3d& direction = _rays[0].direction;
+    int stack[MAX_STACK_SIZE];
+    int size = 0;
+    stack[size++] = 0;
+    while (size > 0)
+    {
+      const int index = stack[--size];
+      const Node& node = mNodes[index];
+
+      // Slab test of all the rays at once
+      Array4d t0 = (node.min[0] - originX) * invDirectionX;
+      Array4d t1 = (node.max[0] - originX) * invDirectionX;
+      Array4d tNear = t0.min(t1).max(0.0);
+      Array4d tFar = t0.max(t1).min(best);
+      t0 = (node.min[1] - originY) * invDirectionY;
+      t1 = (node.max[1] - originY) * invDirectionY;
+      tNear = tNear.max(t0.min(t1));
+      tFar = tFar.min(t0.max(t1));
+      t0 = (node.min[2] - originZ) * invDirectionZ;
+      t1 = (node.max[2] - originZ) * invDirectionZ;
+      tNear = tNear.max(t0.min(t1));
+      tFar = tFar.min(t0.max(t1));
+
+      const Eigen::Array<bool, 4, 1> active = tNear <= tFar;
+      if (!active.head(numRays).any())
+        continue;
+
+      if (node.count > 0)
+      {
+        for (int i = node.index; i < node.index + node.count; ++i)
+        {
+          const Item& item = mItems[i];
+          if (!(item.bodyNode->getCollisionCategory() & _mask))
+            continue;
+
+          for (int j = 0; j < numRays; ++j)
+          {
+            if (active[j] && intersect(item, _rays[j], &_hits[j]))
+              best[j] = _hits[j].distance;
+          }
+        }
+        continue;
+      }
+
+      // Visit the child nearer to the first ray first
+      assert(size + 2 <= MAX_STACK_SIZE);
+      if (direction[node.axis] < 0.0)
+      {
+        stack[size++] = index + 1;
+        stack[size++] = node.index;
+      }
+      else
+      {
+        stack[size++] = node.index;
+        stack[size++] = index + 1;
+      }
+    }
+  }
+
+  size_t numHits = 0;
+  for (int i = 0; i < numRays; ++i)
+  {
+    if (_hits[i].bodyNode)
+      ++numHits;
+  }
+
+  return numHits;
+}
+
+//==============================================================================
+bool RayCaster::intersect(const Item& _item, const Ray& _ray,
+                          RayHit* _hit) const
+{
+  using namespace dynamics;
+
+  const double tMax = std::min(_hit->distance, _ray.maxDistance);
+  const Eigen::Vector3d origin
+      = _item.rotation.transpose() * (_ray.origin - _item.translation);
+  const Eigen::Vector3d direction = _item.rotation.transpose() * _ray.direction;
+
+  double t;
+  Eigen::Vector3d normal;
+  bool hit = false;
+  switch (_item.shape->getShapeType())
+  {
+    case Shape::BOX:
+      hit = intersectBox(0.5 * static_cast<BoxShape*>(_item.shape)->getSize(),
+                         origin, direction, tMax, &t, &normal);
+      break;
+    case Shape::ELLIPSOID:
+      hit = intersectEllipsoid(
+            0.5 * static_cast<EllipsoidShape*>(_item.shape)->getSize(),
+            origin, direction, tMax, &t, &normal);
+      break;
+    case Shape::CYLINDER:
+    {
+      const CylinderShape* cylinder
+          = static_cast<CylinderShape*>(_item.shape);
+      hit = intersectCylinder(cylinder->getRadius(), cylinder->getHeight(),
+                              origin, direction, tMax, &t, &normal);
+      break;
+    }
+    case Shape::PLANE:
+    {
+      const PlaneShape* plane = static_cast<PlaneShape*>(_item.shape);
+      hit = intersectPlane(plane->getNormal(), plane->getOffset(),
+                           origin, direction, tMax, &t, &normal);
+      break;
+    }
+    case Shape::MESH:
+      hit = intersectMesh(*_item.meshTree, origin, direction, tMax,
+                          &t, &normal);
+      break;
+    case Shape::HEIGHTMAP:
+      hit = intersectHeightmap(static_cast<HeightmapShape*>(_item.shape),
+                               origin, direction, tMax, &t, &normal);
+      break;
+    default:
+      break;
+  }
+
+  if (!hit)
+    return false;
+
+  // Triangles are hit from either side, so face the normal to the ray
+  if (normal.dot(direction) > 0.0)
+    normal = -normal;
+
+  _hit->distance = t;
+  _hit->normal = _item.rotation * normal;
+  _hit->bodyNode = _item.bodyNode;
+  _hit->shape = _item.shape;
+  return true;
+}
+
+//==============================================================================
+const RayCaster::MeshTree* RayCaster::getMeshTree(
+    const dynamics::MeshShape* _mesh,
+    std::vector<std::shared_ptr<MeshTree> >* _previous)
+{
+  const aiScene* scene = _mesh->getMesh();
+  const Eigen::Vector3d& scale = _mesh->getScale();
+
+  // Shapes of the same mesh share its triangles
+  for (size_t i = 0; i < mMeshTrees.size(); ++i)
+  {
+    if (mMeshTrees[i]->mesh == scene && mMeshTrees[i]->scale == scale)
+      return mMeshTrees[i].get();
+  }
+
+  for (size_t i = 0; i < _previous->size(); ++i)
+  {
+    if ((*_previous)[i]->mesh == scene && (*_previous)[i]->scale == scale)
+    {
+      mMeshTrees.push_back((*_previous)[i]);
+      return mMeshTrees.back().get();
+    }
+  }
+
+  std::shared_ptr<MeshTree> tree = std::make_shared<MeshTree>();
+  tree->mesh = scene;
+  tree->scale = scale;
+
+  std::vector<Eigen::Vector3i> triangles;
+  for (unsigned int i = 0; scene && i < scene->mNumMeshes; ++i)
+  {
+    const aiMesh* mesh = scene->mMeshes[i];
+    const int offset = static_cast<int>(tree->vertices.size());
+    for (unsigned int j = 0; j < mesh->mNumVertices; ++j)
+    {
+      const aiVector3D& vertex = mesh->mVertices[j];
+      tree->vertices.push_back(Eigen::Vector3d(vertex.x * scale[0],
+                                               vertex.y * scale[1],
+                                               vertex.z * scale[2]));
+    }
+    for (unsigned int j = 0; j < mesh->mNumFaces; ++j)
+    {
+      const aiFace& face = mesh->mFaces[j];
+      if (face.mNumIndices != 3)
+        continue;
+      triangles.push_back(Eigen::Vector3i(offset + face.mIndices[0],
+                                          offset + face.mIndices[1],
+                                          offset + face.mIndices[2]));
+    }
+  }
+
+  std::vector<Eigen::Vector3d> mins(triangles.size());
+  std::vector<Eigen::Vector3d> maxs(triangles.size());
+  for (size_t i = 0; i < triangles.size(); ++i)
+  {
+    const Eigen::Vector3d& a = tree->vertices[triangles[i][0]];
+    const Eigen::Vector3d& b = tree->vertices[triangles[i][1]];
+    const Eigen::Vector3d& c = tree->vertices[triangles[i][2]];
+    mins[i] = a.cwiseMin(b).cwiseMin(c);
+    maxs[i] = a.cwiseMax(b).cwiseMax(c);
+  }
+
+  std::vector<int> order;
+  buildTree(mins, maxs, &order, &tree->nodes);
+  tree->triangles.resize(triangles.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    tree->triangles[i] = triangles[order[i]];
+
+  mMeshTrees.push_back(tree);
+  return tree.get();
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_RAYCASTER_H_
+#define DART_COLLISION_RAYCASTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+struct aiScene;
+
+namespace dart {
+namespace dynamics {
+class BodyNode;
+class HeightmapShape;
+class MeshShape;
+class Shape;
+class Skeleton;
+}  // namespace dynamics
+}  // namespace dart
+
+namespace dart {
+namespace collision {
+
+/// Ray in world coordinates
+struct Ray
+{
+  /// Start of the ray
+  Eigen::Vector3d origin;
+
+  /// Unit direction of the ray
+  Eigen::Vector3d direction;
+
+  /// Hits farther than this distance from the origin are ignored
+  double maxDistance;
+};
+
+/// Closest hit of a ray
+struct RayHit
+{
+  /// Distance from the origin of the ray to the hit, or infinity if the ray
+  /// hit nothing
+  double distance;
+
+  /// Unit normal of the surface at the hit w.r.t. the world frame, facing the
+  /// origin of the ray
+  Eigen::Vector3d normal;
+
+  /// Body node that was hit, or NULL if the ray hit nothing
+  dynamics::BodyNode* bodyNode;
+
+  /// Collision shape that was hit, or NULL if the ray hit nothing
+  dynamics::Shape* shape;
+};
+
+/// \brief class RayCaster
+///
+/// RayCaster casts rays against the collision shapes of skeletons. Boxes,
+/// ellipsoids, cylinders, meshes and heightmaps are kept in a bounding volume
+/// hierarchy over the world, and the triangles of every mesh are kept in a
+/// hierarchy of their own that is shared by the shapes of the same mesh.
+/// Planes are unbounded, so every ray is tested against them.
+///
+/// Rays are traced in packets of four that traverse the hierarchy together,
+/// which is fast for the coherent rays of range sensors (see RangeSensor).
+/// Batches of rays are spread over OpenMP threads unless parallel casting is
+/// disabled.
+///
+/// The hierarchy is built from the transforms of the bodies at the time of
+/// update(), which must be called again once the bodies move or skeletons are
+/// added or removed. A ray that starts inside a closed shape does not hit
+/// that shape, while the triangles of meshes and heightmaps are hit from
+/// either side.
+class RayCaster
+{
+public:
+  /// \brief Constructor
+  RayCaster();
+
+  /// \brief Destructor
+  virtual ~RayCaster();
+
+  /// \brief Add the collision shapes of _skeleton
+  void addSkeleton(dynamics::Skeleton* _skeleton);
+
+  /// \brief Remove the collision shapes of _skeleton
+  void removeSkeleton(dynamics::Skeleton* _skeleton);
+
+  /// \brief Remove all skeletons
+  void removeAllSkeletons();
+
+  /// \brief Get the number of skeletons
+  size_t getNumSkeletons() const;
+
+  /// \brief Rebuild the hierarchy from the current transforms of the bodies
+  void update();
+
+  /// \brief Set whether batches of rays are cast on OpenMP threads
+  void setParallel(bool _parallel);
+
+  /// \brief Return true if batches of rays are cast on OpenMP threads
+  bool isParallel() const;
+
+  /// \brief Cast a single ray. Only the shapes of bodies whose collision
+  /// category overlaps _mask are hit. Return true if the ray hit a shape.
+  bool castRay(const Ray& _ray, RayHit* _hit,
+               uint32_t _mask = 0xFFFFFFFF) const;
+
+  /// \brief Cast _numRays rays and write their hits to _hits, which must hold
+  /// _numRays hits. Only the shapes of bodies whose collision category
+  /// overlaps _mask are hit. Return the number of rays that hit a shape.
+  size_t castRays(const Ray* _rays, size_t _numRays, RayHit* _hits,
+                  uint32_t _mask = 0xFFFFFFFF) const;
+
+  /// \brief Cast _rays and write their hits to _hits, which is resized to the
+  /// number of rays. Return the number of rays that hit a shape.
+  size_t castRays(const std::vector<Ray>& _rays, std::vector<RayHit>* _hits,
+                  uint32_t _mask = 0xFFFFFFFF) const;
+
+protected:
+  /// \brief Node of a bounding volume hierarchy. The nodes are stored in
+  /// depth-first order, so the first child of an inner node follows it.
+  struct Node
+  {
+    /// Lower corner of the bounding box
+    Eigen::Vector3d min;
+
+    /// Upper corner of the bounding box
+    Eigen::Vector3d max;
+
+    /// Index of the second child of an inner node, or of the first item of a
+    /// leaf
+    int index;
+
+    /// Number of items of a leaf, or 0 for an inner node
+    int count;
+
+    /// Axis along which the children of an inner node were split
+    int axis;
+  };
+
+  /// \brief Triangles of a scaled mesh in a hierarchy of their own
+  struct MeshTree
+  {
+    /// Mesh the tree was built from
+    const aiScene* mesh;
+
+    /// Scale the tree was built with
+    Eigen::Vector3d scale;
+
+    /// Scaled vertices
+    std::vector<Eigen::Vector3d> vertices;
+
+    /// Triangles in the order of the leaves of the tree
+    std::vector<Eigen::Vector3i> triangles;
+
+    /// Hierarchy over the triangles
+    std::vector<Node> nodes;
+  };
+
+  /// \brief Collision shape in the hierarchy over the world
+  struct Item
+  {
+    /// Body node of the shape
+    dynamics::BodyNode* bodyNode;
+
+    /// Shape itself
+    dynamics::Shape* shape;
+
+    /// Rotation of the shape w.r.t. the world frame
+    Eigen::Matrix3d rotation;
+
+    /// Position of the shape w.r.t. the world frame
+    Eigen::Vector3d translation;
+
+    /// Triangles of a mesh shape, or NULL for other shapes
+    const MeshTree* meshTree;
+  };
+
+  /// \brief Trace up to four rays from _rays through the hierarchy
+  size_t castPacket(const Ray* _rays, size_t _numRays, RayHit* _hits,
+                    uint32_t _mask) const;
+
+  /// \brief Intersect a ray with _item, and update _hit if the intersection
+  /// is closer than _hit->distance
+  bool intersect(const Item& _item, const Ray& _ray, RayHit* _hit) const;
+
+  /// \brief Return the triangles of _mesh from mMeshTrees or _previous, or
+  /// build them if neither has them
+  const MeshTree* getMeshTree(
+      const dynamics::MeshShape* _mesh,
+      std::vector<std::shared_ptr<MeshTree> >* _previous);
+
+  /// \brief Skeletons whose shapes are cast against
+  std::vector<dynamics::Skeleton*> mSkeletons;
+
+  /// \brief Bounded shapes in the order of the leaves of mNodes
+  std::vector<Item> mItems;
+
+  /// \brief Hierarchy over mItems
+  std::vector<Node> mNodes;
+
+  /// \brief Planes, which are tested against every ray
+  std::vector<Item> mPlanes;
+
+  /// \brief Triangle hierarchies of the meshes in use
+  std::vector<std::shared_ptr<MeshTree> > mMeshTrees;
+
+  /// \brief True if batches of rays are cast on OpenMP threads
+  bool mParallel;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_RAYCASTER_H_
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/SelfCollisionSampler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "dart/collision/dart/DARTCollide.h"
+#include "dart/common/Console.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/Shape.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/math/MathTypes.h"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+//==============================================================================
+bool collideBodyNodes(const dynamics::BodyNode* _bodyNode1,
+                      const dynamics::BodyNode* _bodyNode2,
+                      std::vector<Contact>* _contacts)
+{
+  for (size_t i = 0; i < _bodyNode1->getNumCollisionShapes(); ++i)
+  {
+    const dynamics::Shape* shape1 = _bodyNode1->getCollisionShape(i);
+    const Eigen::Isometry3d T1 = _bodyNode1->getWorldTransform()
+                                 * shape1->getLocalTransform();
+
+    for (size_t j = 0; j < _bodyNode2->getNumCollisionShapes(); ++j)
+    {
+      const dynamics::Shape* shape2 = _bodyNode2->getCollisionShape(j);
+      const Eigen::Isometry3d T2 = _bodyNode2->getWorldTransform()
+                                   * shape2->getLocalTransform();
+
+      _contacts->clear();
+      if (collide(shape1, T1, shape2, T2, _contacts) > 0)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
+//==============================================================================
+SelfCollisionSampler::SelfCollisionSampler(dynamics::Skeleton* _skeleton)
+  : mSkeleton(_skeleton),
+    mNumSamples(10000),
+    mSeed(0),
+    mParallel(true)
+{
+  assert(_skeleton);
+}
+
+//==============================================================================
+SelfCollisionSampler::~SelfCollisionSampler()
+{
+}
+
+//==============================================================================
+dynamics::Skeleton* SelfCollisionSampler::getSkeleton() const
+{
+  return mSkeleton;
+}
+
+//==============================================================================
+void SelfCollisionSampler::setNumSamples(size_t _numSamples)
+{
+  mNumSamples = _numSamples;
+}
+
+//==============================================================================
+size_t SelfCollisionSampler::getNumSamples() const
+{
+  return mNumSamples;
+}
+
+//==============================================================================
+void SelfCollisionSampler::setSeed(unsigned int _seed)
+{
+  mSeed = _seed;
+}
+
+//==============================================================================
+unsigned int SelfCollisionSampler::getSeed() const
+{
+  return mSeed;
+}
+
+//==============================================================================
+void SelfCollisionSampler::setParallel(bool _parallel)
+{
+  mParallel = _parallel;
+}
+
+//==============================================================================
+bool SelfCollisionSampler::isParallel() const
+{
+  return mParallel;
+}
+
+//==============================================================================
+size_t SelfCollisionSampler::sample()
+{
+  mPairs.clear();
+
+  if (mNumSamples == 0)
+  {
+    dtwarn << "[SelfCollisionSampler::sample] At least one sample is "
+           << "required.\n";
+    return 0;
+  }
+
+  // Pairs of body nodes that both have collision shapes
+  std::vector<size_t> bodies;
+  for (size_t i = 0; i < mSkeleton->getNumBodyNodes(); ++i)
+  {
+    dynamics::BodyNode* bodyNode = mSkeleton->getBodyNode(i);
+    if (bodyNode->getNumCollisionShapes() == 0)
+      continue;
+
+    bodies.push_back(i);
+
+    // Decompose the meshes once here, since the clones share the
+    // decompositions of the shapes they were cloned from
+    for (size_t j = 0; j < bodyNode->getNumCollisionShapes(); ++j)
+    {
+      const dynamics::MeshShape* mesh
+          = dynamic_cast<const dynamics::MeshShape*>(
+              bodyNode->getCollisionShape(j));
+      if (mesh)
+        mesh->getConvexDecomposition();
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t> > indices;
+  for (size_t i = 0; i < bodies.size(); ++i)
+    for (size_t j = i + 1; j < bodies.size(); ++j)
+      indices.push_back(std::make_pair(bodies[i], bodies[j]));
+
+  if (indices.empty())
+    return 0;
+
+  // Sampling ranges of the DOFs
+  const size_t numDofs = mSkeleton->getNumDofs();
+  Eigen::VectorXd lower(numDofs);
+  Eigen::VectorXd upper(numDofs);
+  for (size_t i = 0; i < numDofs; ++i)
+  {
+    const dynamics::DegreeOfFreedom* dof = mSkeleton->getDof(i);
+    lower[i] = std::max(dof->getPositionLowerLimit(), -DART_PI);
+    upper[i] = std::min(dof->getPositionUpperLimit(), DART_PI);
+    if (lower[i] > upper[i])
+      upper[i] = lower[i];
+  }
+
+  // Each thread poses a clone of its own
+  int numThreads = 1;
+#ifdef _OPENMP
+  if (mParallel)
+    numThreads = std::max(1, omp_get_max_threads());
+#endif
+  numThreads = std::min(numThreads, static_cast<int>(mNumSamples));
+
+  std::vector<dynamics::Skeleton*> clones(numThreads);
+  std::vector<std::vector<size_t> > counts(numThreads);
+  for (int i = 0; i < numThreads; ++i)
+  {
+    clones[i] = mSkeleton->clone();
+    counts[i].assign(indices.size(), 0);
+  }
+
+  const int numSamples = static_cast<int>(mNumSamples);
+
+#pragma omp parallel num_threads(numThreads)
+  {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+    dynamics::Skeleton* skeleton = clones[thread];
+    std::vector<size_t>& count = counts[thread];
+    std::vector<Contact> contacts;
+    Eigen::VectorXd positions(numDofs);
+
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < numSamples; ++i)
+    {
+      std::mt19937 random(mSeed + static_cast<unsigned int>(i));
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      for (size_t j = 0; j < numDofs; ++j)
+        positions[j] = lower[j] + uniform(random) * (upper[j] - lower[j]);
+      skeleton->setPositions(positions);
+
+      for (size_t j = 0; j < indices.size(); ++j)
+      {
+        if (collideBodyNodes(skeleton->getBodyNode(indices[j].first),
+                             skeleton->getBodyNode(indices[j].second),
+                             &contacts))
+        {
+          ++count[j];
+        }
+      }
+    }
+  }
+
+  mPairs.resize(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    SelfCollisionPair& pair = mPairs[i];
+    pair.bodyNode1 = mSkeleton->getBodyNode(indices[i].first);
+    pair.bodyNode2 = mSkeleton->getBodyNode(indices[i].second);
+    pair.numCollisions = 0;
+    for (int j = 0; j < numThreads; ++j)
+      pair.numCollisions += counts[j][i];
+
+    if (pair.numCollisions == 0)
+      pair.type = SELF_COLLISION_NEVER;
+    else if (pair.numCollisions == mNumSamples)
+      pair.type = SELF_COLLISION_ALWAYS;
+    else
+      pair.type = SELF_COLLISION_SOMETIMES;
+  }
+
+  for (int i = 0; i < numThreads; ++i)
+    delete clones[i];
+
+  return mPairs.size();
+}
+
+//==============================================================================
+const std::vector<SelfCollisionPair>& SelfCollisionSampler::getPairs() const
+{
+  return mPairs;
+}
+
+//==============================================================================
+size_t SelfCollisionSampler::getNumPairs(SelfCollisionType _type) const
+{
+  size_t numPairs = 0;
+  for (size_t i = 0; i < mPairs.size(); ++i)
+  {
+    if (mPairs[i].type == _type)
+      ++numPairs;
+  }
+
+  return numPairs;
+}
+
+//==============================================================================
+size_t SelfCollisionSampler::disablePairs()
+{
+  size_t numDisabled = 0;
+  for (size_t i = 0; i < mPairs.size(); ++i)
+  {
+    const SelfCollisionPair& pair = mPairs[i];
+    if (pair.type == SELF_COLLISION_SOMETIMES)
+      continue;
+
+    mSkeleton->disableSelfCollisionPair(pair.bodyNode1, pair.bodyNode2);
+    ++numDisabled;
+  }
+
+  return numDisabled;
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_SELFCOLLISIONSAMPLER_H_
+#define DART_COLLISION_SELFCOLLISIONSAMPLER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace dart {
+namespace dynamics {
+class BodyNode;
+class Skeleton;
+}  // namespace dynamics
+}  // namespace dart
+
+namespace dart {
+namespace collision {
+
+/// How often a pair of body nodes collided over the sampled configurations
+enum SelfCollisionType
+{
+  /// The pair never collided
+  SELF_COLLISION_NEVER,
+
+  /// The pair collided in every configuration
+  SELF_COLLISION_ALWAYS,
+
+  /// The pair collided in some configurations
+  SELF_COLLISION_SOMETIMES
+};
+
+/// Pair of body nodes of a skeleton and their sampled collisions
+struct SelfCollisionPair
+{
+  /// First body node of the pair
+  dynamics::BodyNode* bodyNode1;
+
+  /// Second body node of the pair, which comes after bodyNode1 in the
+  /// skeleton
+  dynamics::BodyNode* bodyNode2;
+
+  /// Number of sampled configurations in which the pair collided
+  size_t numCollisions;
+
+  /// Classification of the pair
+  SelfCollisionType type;
+};
+
+/// \brief class SelfCollisionSampler
+///
+/// SelfCollisionSampler finds the pairs of body nodes of a skeleton that do
+/// not need to be checked for self collision. It poses clones of the skeleton
+/// in random configurations, drawn uniformly within the position limits of
+/// each DegreeOfFreedom, and collides the collision shapes of every pair of
+/// body nodes. Pairs that never collide, and pairs that collide in every
+/// configuration (such as overlapping neighbours), are disabled on the
+/// skeleton by disablePairs(), so the collision detector no longer generates
+/// them (see Skeleton::disableSelfCollisionPair()). The result can be stored
+/// with the model by utils::SrdfParser.
+///
+/// Unbounded DOFs are sampled in [-pi, pi]. The positions of the skeleton
+/// itself are left untouched. Sampling is spread over OpenMP threads, each of
+/// which owns a clone of the skeleton, unless parallel sampling is disabled.
+/// Every sample has a random stream of its own, so the result only depends on
+/// the seed and not on the number of threads.
+///
+/// A pair that never collides over the samples may still collide in a rare
+/// configuration, so the number of samples should be large enough to cover
+/// the workspace of the skeleton.
+class SelfCollisionSampler
+{
+public:
+  /// \brief Constructor
+  explicit SelfCollisionSampler(dynamics::Skeleton* _skeleton);
+
+  /// \brief Destructor
+  virtual ~SelfCollisionSampler();
+
+  /// \brief Get the skeleton
+  dynamics::Skeleton* getSkeleton() const;
+
+  /// \brief Set the number of sampled configurations
+  void setNumSamples(size_t _numSamples);
+
+  /// \brief Get the number of sampled configurations
+  size_t getNumSamples() const;
+
+  /// \brief Set the seed of the random configurations
+  void setSeed(unsigned int _seed);
+
+  /// \brief Get the seed of the random configurations
+  unsigned int getSeed() const;
+
+  /// \brief Set whether configurations are sampled on OpenMP threads
+  void setParallel(bool _parallel);
+
+  /// \brief Return true if configurations are sampled on OpenMP threads
+  bool isParallel() const;
+
+  /// \brief Sample the configurations and classify every pair of body nodes
+  /// that both have collision shapes. Return the number of pairs.
+  size_t sample();
+
+  /// \brief Get the pairs classified by the last call to sample()
+  const std::vector<SelfCollisionPair>& getPairs() const;
+
+  /// \brief Get the number of pairs of the last call to sample() that are of
+  /// _type
+  size_t getNumPairs(SelfCollisionType _type) const;
+
+  /// \brief Disable the pairs that never or always collided on the skeleton.
+  /// Return the number of disabled pairs.
+  size_t disablePairs();
+
+protected:
+  /// \brief Skeleton to sample
+  dynamics::Skeleton* mSkeleton;
+
+  /// \brief Number of sampled configurations
+  size_t mNumSamples;
+
+  /// \brief Seed of the random configurations
+  unsigned int mSeed;
+
+  /// \brief Whether configurations are sampled on OpenMP threads
+  bool mParallel;
+
+  /// \brief Pairs classified by the last call to sample()
+  std::vector<SelfCollisionPair> mPairs;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_SELFCOLLISIONSAMPLER_H_
@@ -106,7 +106,9 @@ struct CollisionFilter : public btOverlapFilterCallback
 };
 
 //==============================================================================
-BulletCollisionDetector::BulletCollisionDetector() : CollisionDetector()
+BulletCollisionDetector::BulletCollisionDetector()
+  : CollisionDetector(),
+    mNextContactId(1)
 {
 //  btVector3 worldAabbMin(-1000, -1000, -1000);
 //  btVector3 worldAabbMax(1000, 1000, 1000);
@@ -132,6 +134,15 @@ BulletCollisionDetector::~BulletCollisionDetector()
 {
 }
 
+//==============================================================================
+CollisionDetector* BulletCollisionDetector::cloneWithoutCollisionObjects() const
+{
+  BulletCollisionDetector* collisionDetector = new BulletCollisionDetector();
+  collisionDetector->setNumMaxContacs(mNumMaxContacts);
+  collisionDetector->setTimeStep(mTimeStep);
+  return collisionDetector;
+}
+
 //==============================================================================
 CollisionNode* BulletCollisionDetector::createCollisionNode(
     dynamics::BodyNode* _bodyNode)
@@ -150,18 +161,47 @@ CollisionNode* BulletCollisionDetector::createCollisionNode(
   return collNode;
 }
 
+//==============================================================================
+void BulletCollisionDetector::removeCollisionSkeletonNode(
+    dynamics::BodyNode* _bodyNode, bool _isRecursive)
+{
+  // Take the objects out of the collision world before the node deletes them
+  BulletCollisionNode* collNode =
+      static_cast<BulletCollisionNode*>(getCollisionNode(_bodyNode));
+  if (collNode != NULL)
+  {
+    for (int i = 0; i < collNode->getNumBulletCollisionObjects(); ++i)
+    {
+      btCollisionObject* collObj = collNode->getBulletCollisionObject(i);
+      mBulletCollisionWorld->removeCollisionObject(collObj);
+
+      // A new object may reuse the address, so forget the object's contacts
+      auto it = mTrackedContacts.begin();
+      while (it != mTrackedContacts.end())
+      {
+        if (it->first.first == collObj || it->first.second == collObj)
+          it = mTrackedContacts.erase(it);
+        else
+          ++it;
+      }
+    }
+  }
+
+  CollisionDetector::removeCollisionSkeletonNode(_bodyNode, _isRecursive);
+}
+
 //==============================================================================
 bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
                                               bool _calculateContactPoints)
 {
-  // Update all the transformations of the collision nodes
+  // Update the transformations of the collision nodes that moved
   for (size_t i = 0; i < mCollisionNodes.size(); ++i)
     static_cast<BulletCollisionNode*>(
         mCollisionNodes[i])->updateBulletCollisionObjects();
 
   // Setting up broadphase collision detection options
   btDispatcherInfo& dispatchInfo = mBulletCollisionWorld->getDispatchInfo();
-  dispatchInfo.m_timeStep  = 0.001;
+  dispatchInfo.m_timeStep  = mTimeStep;
   dispatchInfo.m_stepCount = 0;
   // dispatchInfo.m_debugDraw = getDebugDrawer();
 
@@ -178,6 +218,7 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
     mCollisionNodes[i]->getBodyNode()->setColliding(false);
 
   // Add all the contacts to mContacts
+  std::map<ObjectPair, std::vector<TrackedContact> > trackedContacts;
   int numManifolds = mBulletCollisionWorld->getDispatcher()->getNumManifolds();
   btDispatcher* dispatcher = mBulletCollisionWorld->getDispatcher();
   for (int i = 0; i < numManifolds; ++i)
@@ -192,10 +233,47 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
     BulletUserData* userDataB
         = static_cast<BulletUserData*>(obB->getUserPointer());
 
+    const ObjectPair objects(obA, obB);
+    auto previous = mTrackedContacts.find(objects);
+    std::vector<TrackedContact>& current = trackedContacts[objects];
+    const double threshold = contactManifold->getContactBreakingThreshold();
+
     int numContacts = contactManifold->getNumContacts();
     for (int j = 0; j < numContacts; j++)
     {
-      btManifoldPoint& cp = contactManifold->getContactPoint(j);
+      const btManifoldPoint& cp = contactManifold->getContactPoint(j);
+
+      // Take over the identifier of the nearest old point of the same objects
+      // within the distance at which Bullet stops matching points
+      TrackedContact tracked;
+      tracked.mLocalPoint = convertVector3(cp.m_localPointA);
+      tracked.mId = 0;
+      if (previous != mTrackedContacts.end())
+      {
+        TrackedContact* nearest = NULL;
+        double nearestDistance = threshold * threshold;
+        for (size_t k = 0; k < previous->second.size(); ++k)
+        {
+          TrackedContact& old = previous->second[k];
+          const double distance
+              = (old.mLocalPoint - tracked.mLocalPoint).squaredNorm();
+          if (old.mId != 0 && distance < nearestDistance)
+          {
+            nearest = &old;
+            nearestDistance = distance;
+          }
+        }
+
+        // An old point is taken over by one new point at most
+        if (nearest != NULL)
+        {
+          tracked.mId = nearest->mId;
+          nearest->mId = 0;
+        }
+      }
+      if (tracked.mId == 0)
+        tracked.mId = mNextContactId++;
+      current.push_back(tracked);
 
       Contact contactPair;
       contactPair.point            = convertVector3(cp.getPositionWorldOnA());
@@ -203,6 +281,9 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
       contactPair.penetrationDepth = -cp.m_distance1;
       contactPair.bodyNode1   = userDataA->btCollNode->getBodyNode();
       contactPair.bodyNode2   = userDataB->btCollNode->getBodyNode();
+      contactPair.shape1      = userDataA->shape;
+      contactPair.shape2      = userDataB->shape;
+      contactPair.id          = tracked.mId;
 
       mContacts.push_back(contactPair);
 
@@ -212,6 +293,8 @@ bool BulletCollisionDetector::detectCollision(bool _checkAllCollisions,
     }
   }
 
+  mTrackedContacts.swap(trackedContacts);
+
   // Return true if there are contacts
   return !mContacts.empty();
 }
@@ -61,10 +61,21 @@ public:
   /// @brief Destructor
   virtual ~BulletCollisionDetector();
 
+  // Documentation inherited
+  virtual CollisionDetector* cloneWithoutCollisionObjects() const;
+
   /// \copydoc CollisionDetector::createCollisionNode
   virtual CollisionNode* createCollisionNode(dynamics::BodyNode* _bodyNode);
 
+  /// \copydoc CollisionDetector::removeCollisionSkeletonNode
+  virtual void removeCollisionSkeletonNode(dynamics::BodyNode* _bodyNode,
+                                           bool _isRecursive = false);
+
   /// \copydoc CollisionDetector::detectCollision
+  ///
+  /// A contact point that stays within the contact breaking threshold of a
+  /// point of the same objects from the previous call is reported with the
+  /// same Contact::id.
   virtual bool detectCollision(bool _checkAllCollisions,
                                bool _calculateContactPoints);
 
@@ -74,8 +85,33 @@ protected:
   virtual bool detectCollision(CollisionNode* _node1, CollisionNode* _node2,
                                bool _calculateContactPoints);
 
+  /// @brief Contact point reported by the last call of detectCollision()
+  struct TrackedContact
+  {
+    /// @brief Contact point w.r.t. the first collision object
+    Eigen::Vector3d mLocalPoint;
+
+    /// @brief Identifier of the contact point
+    size_t mId;
+  };
+
+  /// @brief Pair of colliding Bullet collision objects
+  typedef std::pair<const btCollisionObject*, const btCollisionObject*>
+      ObjectPair;
+
   /// @brief Bullet collision world
   btCollisionWorld* mBulletCollisionWorld;
+
+  /// @brief Identifier to give to the next new contact point
+  size_t mNextContactId;
+
+  /// @brief Contact points of each pair of colliding objects found by the last
+  /// call of detectCollision(). A new contact point gets the identifier of the
+  /// nearest old point of the same pair, the way Bullet matches the points of
+  /// its persistent manifolds. The identifiers are kept here rather than in
+  /// the user persistent data of the manifold points, which is reserved for
+  /// the contact callbacks of applications.
+  std::map<ObjectPair, std::vector<TrackedContact> > mTrackedContacts;
 };
 
 }  // namespace collision
@@ -53,7 +53,10 @@ namespace collision {
 
 //==============================================================================
 BulletCollisionNode::BulletCollisionNode(dynamics::BodyNode* _bodyNode)
-  : CollisionNode(_bodyNode)
+  : CollisionNode(_bodyNode),
+    mIsTransformDirty(true),
+    mTransformUpdatedConnection(_bodyNode->onTransformUpdated.connect(
+        [this](const dynamics::Entity*) { mIsTransformDirty = true; }))
 {
   for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); i++)
   {
@@ -179,11 +182,22 @@ BulletCollisionNode::BulletCollisionNode(dynamics::BodyNode* _bodyNode)
 //==============================================================================
 BulletCollisionNode::~BulletCollisionNode()
 {
+  for (size_t i = 0; i < mbtCollsionObjects.size(); ++i)
+  {
+    delete static_cast<BulletUserData*>(
+          mbtCollsionObjects[i]->getUserPointer());
+    delete mbtCollsionObjects[i]->getCollisionShape();
+    delete mbtCollsionObjects[i];
+  }
 }
 
 //==============================================================================
 void BulletCollisionNode::updateBulletCollisionObjects()
 {
+  // Resting bodies keep the transforms Bullet already has
+  if (!mIsTransformDirty)
+    return;
+
   for (size_t i = 0; i < mbtCollsionObjects.size(); ++i)
   {
     BulletUserData* userData =
@@ -193,6 +207,15 @@ void BulletCollisionNode::updateBulletCollisionObjects()
                                      shape->getLocalTransform());
     mbtCollsionObjects[i]->setWorldTransform(T);
   }
+
+  // Cleared after getTransform() so that the next move raises the signal
+  mIsTransformDirty = false;
+}
+
+//==============================================================================
+bool BulletCollisionNode::isTransformDirty() const
+{
+  return mIsTransformDirty;
 }
 
 //==============================================================================
@@ -43,6 +43,7 @@
 #include <btBulletCollisionCommon.h>
 #include <Eigen/Dense>
 
+#include "dart/common/Signal.h"
 #include "dart/dynamics/Shape.h"
 #include "dart/collision/CollisionNode.h"
 
@@ -75,9 +76,14 @@ public:
     /// @brief Destructor
     virtual ~BulletCollisionNode();
 
-    /// @brief Update transformation of all the bullet collision objects.
+    /// @brief Update transformation of all the bullet collision objects. This
+    /// does nothing unless the body node moved since the last update.
     void updateBulletCollisionObjects();
 
+    /// @brief Return true if the body node moved since the last update of the
+    /// bullet collision objects
+    bool isTransformDirty() const;
+
     /// @brief Get number of bullet collision objects
     int getNumBulletCollisionObjects() const;
 
@@ -87,6 +93,12 @@ public:
 private:
     /// @brief Bullet collision objects
     std::vector<btCollisionObject*> mbtCollsionObjects;
+
+    /// @brief Whether the body node moved since the last update
+    bool mIsTransformDirty;
+
+    /// @brief Connection to the transform updated signal of the body node
+    common::ScopedConnection mTransformUpdatedConnection;
 };
 
 /// @brief Create Bullet mesh from assimp3 mesh
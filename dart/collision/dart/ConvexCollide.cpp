@@ -0,0 +1,881 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/ConvexCollide.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+// Maximum number of iterations of GJK and EPA
+const int GJK_MAX_ITERATIONS = 64;
+const int EPA_MAX_ITERATIONS = 64;
+
+// Relative tolerance of the termination tests of GJK and EPA
+const double CONVEX_COLLISION_EPS = 1e-6;
+
+// Maximum number of contacts between two convex pieces
+const size_t MAX_CONVEX_CONTACTS = 4;
+
+/// Point of the Minkowski difference of two shapes, which remembers the
+/// points of the shapes it was made from
+struct SupportPoint
+{
+  Eigen::Vector3d mPoint;
+  Eigen::Vector3d mPoint0;
+  Eigen::Vector3d mPoint1;
+};
+
+//==============================================================================
+SupportPoint computeSupport(const SupportFunction& _support0,
+                            const SupportFunction& _support1,
+                            const Eigen::Vector3d& _direction)
+{
+  SupportPoint result;
+  result.mPoint0 = _support0(_direction);
+  result.mPoint1 = _support1(-_direction);
+  result.mPoint = result.mPoint0 - result.mPoint1;
+  return result;
+}
+
+//==============================================================================
+// Find the point of the segment, triangle, or tetrahedron of _simplex that is
+// closest to the origin, and shrink _simplex to the smallest face that
+// contains it. Return false if the origin is inside the tetrahedron.
+bool reduceSimplex(std::vector<SupportPoint>* _simplex, Eigen::Vector3d* _v);
+
+//==============================================================================
+void reduceSegment(std::vector<SupportPoint>* _simplex, Eigen::Vector3d* _v)
+{
+  const Eigen::Vector3d& a = (*_simplex)[0].mPoint;
+  const Eigen::Vector3d ab = (*_simplex)[1].mPoint - a;
+  const double t = -a.dot(ab);
+  if (t <= 0.0)
+  {
+    _simplex->resize(1);
+    *_v = a;
+    return;
+  }
+
+  const double abab = ab.squaredNorm();
+  if (t >= abab)
+  {
+    _simplex->erase(_simplex->begin());
+    *_v = (*_simplex)[0].mPoint;
+    return;
+  }
+
+  *_v = a + (t / abab) * ab;
+}
+
+//==============================================================================
+// Closest point of the triangle to the origin, following the Voronoi region
+// tests of Ericson, "Real-Time Collision Detection", Section 5.1.5
+void reduceTriangle(std::vector<SupportPoint>* _simplex, Eigen::Vector3d* _v)
+{
+  const SupportPoint A = (*_simplex)[0];
+  const SupportPoint B = (*_simplex)[1];
+  const SupportPoint C = (*_simplex)[2];
+  const Eigen::Vector3d& a = A.mPoint;
+  const Eigen::Vector3d& b = B.mPoint;
+  const Eigen::Vector3d& c = C.mPoint;
+  const Eigen::Vector3d ab = b - a;
+  const Eigen::Vector3d ac = c - a;
+  const Eigen::Vector3d ap = -a;
+
+  const double d1 = ab.dot(ap);
+  const double d2 = ac.dot(ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+  {
+    *_simplex = {A};
+    *_v = a;
+    return;
+  }
+
+  const Eigen::Vector3d bp = -b;
+  const double d3 = ab.dot(bp);
+  const double d4 = ac.dot(bp);
+  if (d3 >= 0.0 && d4 <= d3)
+  {
+    *_simplex = {B};
+    *_v = b;
+    return;
+  }
+
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+  {
+    *_simplex = {A, B};
+    *_v = a + d1 / (d1 - d3) * ab;
+    return;
+  }
+
+  const Eigen::Vector3d cp = -c;
+  const double d5 = ab.dot(cp);
+  const double d6 = ac.dot(cp);
+  if (d6 >= 0.0 && d5 <= d6)
+  {
+    *_simplex = {C};
+    *_v = c;
+    return;
+  }
+
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+  {
+    *_simplex = {A, C};
+    *_v = a + d2 / (d2 - d6) * ac;
+    return;
+  }
+
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+  {
+    *_simplex = {B, C};
+    *_v = b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+    return;
+  }
+
+  const double denom = va + vb + vc;
+  if (denom == 0.0)
+  {
+    // Degenerate triangle, so the closest point lies on one of its edges
+    std::vector<SupportPoint> best;
+    double bestDistance = std::numeric_limits<double>::infinity();
+    const std::vector<SupportPoint> edges[3] = {{A, B}, {B, C}, {A, C}};
+    for (const std::vector<SupportPoint>& edge : edges)
+    {
+      std::vector<SupportPoint> simplex = edge;
+      Eigen::Vector3d v;
+      reduceSegment(&simplex, &v);
+      if (v.squaredNorm() < bestDistance)
+      {
+        bestDistance = v.squaredNorm();
+        best = simplex;
+        *_v = v;
+      }
+    }
+    *_simplex = best;
+    return;
+  }
+
+  *_v = a + (vb / denom) * ab + (vc / denom) * ac;
+}
+
+//==============================================================================
+bool reduceTetrahedron(std::vector<SupportPoint>* _simplex,
+                       Eigen::Vector3d* _v)
+{
+  const std::vector<SupportPoint> points = *_simplex;
+  static const int faces[4][4] = {
+    {0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+
+  // A flat tetrahedron can not enclose the origin, but rounding makes the
+  // side tests below unreliable, so its closest face is taken instead
+  const Eigen::Vector3d ab = points[1].mPoint - points[0].mPoint;
+  const Eigen::Vector3d ac = points[2].mPoint - points[0].mPoint;
+  const Eigen::Vector3d ad = points[3].mPoint - points[0].mPoint;
+  const double size = std::max(ab.norm(), std::max(ac.norm(), ad.norm()));
+  const bool isFlat = std::abs(ab.cross(ac).dot(ad))
+                      <= CONVEX_COLLISION_EPS * size * size * size;
+
+  bool isOutside = false;
+  double bestDistance = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < 4; ++i)
+  {
+    const Eigen::Vector3d& a = points[faces[i][0]].mPoint;
+    const Eigen::Vector3d& b = points[faces[i][1]].mPoint;
+    const Eigen::Vector3d& c = points[faces[i][2]].mPoint;
+    const Eigen::Vector3d& d = points[faces[i][3]].mPoint;
+    const Eigen::Vector3d n = (b - a).cross(c - a);
+
+    // The origin is outside of this face if it is on the other side of the
+    // face plane than the fourth point
+    const double signOrigin = n.dot(-a);
+    const double signOpposite = n.dot(d - a);
+    if (!isFlat && signOrigin * signOpposite >= 0.0)
+      continue;
+
+    isOutside = true;
+    std::vector<SupportPoint> simplex = {
+      points[faces[i][0]], points[faces[i][1]], points[faces[i][2]]};
+    Eigen::Vector3d v;
+    reduceTriangle(&simplex, &v);
+    if (v.squaredNorm() < bestDistance)
+    {
+      bestDistance = v.squaredNorm();
+      *_simplex = simplex;
+      *_v = v;
+    }
+  }
+
+  return isOutside;
+}
+
+//==============================================================================
+bool reduceSimplex(std::vector<SupportPoint>* _simplex, Eigen::Vector3d* _v)
+{
+  switch (_simplex->size())
+  {
+    case 1:
+      *_v = (*_simplex)[0].mPoint;
+      return true;
+    case 2:
+      reduceSegment(_simplex, _v);
+      return true;
+    case 3:
+      reduceTriangle(_simplex, _v);
+      return true;
+    default:
+      return reduceTetrahedron(_simplex, _v);
+  }
+}
+
+//==============================================================================
+// Run GJK and return true if the origin is inside the Minkowski difference.
+// On success, _simplex is a tetrahedron that contains the origin.
+bool runGjk(const SupportFunction& _support0,
+            const SupportFunction& _support1,
+            std::vector<SupportPoint>* _simplex)
+{
+  _simplex->clear();
+
+  Eigen::Vector3d v = computeSupport(_support0, _support1,
+                                     Eigen::Vector3d::UnitX()).mPoint;
+  if (v.isZero())
+    v = Eigen::Vector3d::UnitX();
+
+  double scale = v.norm();
+  for (int i = 0; i < GJK_MAX_ITERATIONS; ++i)
+  {
+    const SupportPoint w = computeSupport(_support0, _support1, -v);
+    scale = std::max(scale, w.mPoint.norm());
+
+    // The support point does not pass the origin, so the origin is outside
+    if (v.dot(w.mPoint) > 0.0)
+      return false;
+
+    // No progress toward the origin, so the shapes are at most touching
+    if (v.squaredNorm() - v.dot(w.mPoint)
+        <= CONVEX_COLLISION_EPS * CONVEX_COLLISION_EPS * v.squaredNorm())
+      return false;
+
+    _simplex->push_back(w);
+    if (!reduceSimplex(_simplex, &v))
+      return true;
+
+    // The origin is on the simplex
+    if (v.norm() <= CONVEX_COLLISION_EPS * scale)
+      break;
+  }
+
+  if (v.norm() > CONVEX_COLLISION_EPS * scale)
+    return false;
+
+  // The origin is on a face, an edge, or a vertex of the simplex, so blow the
+  // simplex up to a tetrahedron around it
+  static const Eigen::Vector3d axes[3] = {
+    Eigen::Vector3d::UnitX(), Eigen::Vector3d::UnitY(),
+    Eigen::Vector3d::UnitZ()};
+  const double tolerance = CONVEX_COLLISION_EPS * scale;
+
+  if (_simplex->size() == 1)
+  {
+    for (int i = 0; i < 6 && _simplex->size() == 1; ++i)
+    {
+      const Eigen::Vector3d dir = (i % 2 == 0 ? 1.0 : -1.0) * axes[i / 2];
+      const SupportPoint w = computeSupport(_support0, _support1, dir);
+      if ((w.mPoint - (*_simplex)[0].mPoint).norm() > tolerance)
+        _simplex->push_back(w);
+    }
+  }
+
+  if (_simplex->size() == 2)
+  {
+    const Eigen::Vector3d d
+        = (*_simplex)[1].mPoint - (*_simplex)[0].mPoint;
+    int minAxis;
+    d.cwiseAbs().minCoeff(&minAxis);
+    const Eigen::Vector3d e1 = d.cross(axes[minAxis]).normalized();
+    const Eigen::Vector3d e2 = d.cross(e1).normalized();
+    const Eigen::Vector3d dirs[4] = {e1, -e1, e2, -e2};
+    for (int i = 0; i < 4 && _simplex->size() == 2; ++i)
+    {
+      const SupportPoint w = computeSupport(_support0, _support1, dirs[i]);
+      const Eigen::Vector3d& a = (*_simplex)[0].mPoint;
+      if ((w.mPoint - a).cross(d).norm() > tolerance * d.norm())
+        _simplex->push_back(w);
+    }
+  }
+
+  if (_simplex->size() == 3)
+  {
+    const Eigen::Vector3d& a = (*_simplex)[0].mPoint;
+    const Eigen::Vector3d n = ((*_simplex)[1].mPoint - a).cross(
+        (*_simplex)[2].mPoint - a).normalized();
+    for (int i = 0; i < 2 && _simplex->size() == 3; ++i)
+    {
+      const SupportPoint w = computeSupport(_support0, _support1,
+                                            i == 0 ? n : Eigen::Vector3d(-n));
+      if (std::abs(n.dot(w.mPoint - a)) > tolerance)
+        _simplex->push_back(w);
+    }
+  }
+
+  // The Minkowski difference is flat, so the shapes only touch
+  return _simplex->size() == 4;
+}
+
+/// Face of the polytope that EPA expands
+struct PolytopeFace
+{
+  int mVertices[3];
+  Eigen::Vector3d mNormal;
+  double mDistance;
+};
+
+//==============================================================================
+bool makePolytopeFace(const std::vector<SupportPoint>& _vertices,
+                      int _a, int _b, int _c, PolytopeFace* _face)
+{
+  const Eigen::Vector3d& a = _vertices[_a].mPoint;
+  const Eigen::Vector3d n = (_vertices[_b].mPoint - a).cross(
+        _vertices[_c].mPoint - a);
+  const double norm = n.norm();
+  if (norm == 0.0)
+    return false;
+
+  _face->mVertices[0] = _a;
+  _face->mVertices[1] = _b;
+  _face->mVertices[2] = _c;
+  _face->mNormal = n / norm;
+  _face->mDistance = _face->mNormal.dot(a);
+  return true;
+}
+
+//==============================================================================
+// Run EPA from a tetrahedron that contains the origin, and return the face of
+// the Minkowski difference that is closest to the origin
+void runEpa(const SupportFunction& _support0,
+            const SupportFunction& _support1,
+            const std::vector<SupportPoint>& _simplex,
+            Eigen::Vector3d* _normal, double* _depth,
+            Eigen::Vector3d* _point)
+{
+  std::vector<SupportPoint> vertices = _simplex;
+  std::vector<PolytopeFace> faces;
+
+  // Orient the faces of the tetrahedron outward
+  static const int tetrahedron[4][4] = {
+    {0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+  for (int i = 0; i < 4; ++i)
+  {
+    int a = tetrahedron[i][0];
+    int b = tetrahedron[i][1];
+    int c = tetrahedron[i][2];
+    const Eigen::Vector3d n = (vertices[b].mPoint - vertices[a].mPoint).cross(
+          vertices[c].mPoint - vertices[a].mPoint);
+    if (n.dot(vertices[tetrahedron[i][3]].mPoint - vertices[a].mPoint) > 0.0)
+      std::swap(b, c);
+
+    PolytopeFace face;
+    if (makePolytopeFace(vertices, a, b, c, &face))
+      faces.push_back(face);
+  }
+
+  double scale = 0.0;
+  for (const SupportPoint& vertex : vertices)
+    scale = std::max(scale, vertex.mPoint.norm());
+
+  size_t closest = 0;
+  for (int iteration = 0; iteration < EPA_MAX_ITERATIONS; ++iteration)
+  {
+    closest = 0;
+    for (size_t i = 1; i < faces.size(); ++i)
+    {
+      if (faces[i].mDistance < faces[closest].mDistance)
+        closest = i;
+    }
+
+    const PolytopeFace face = faces[closest];
+    const SupportPoint w = computeSupport(_support0, _support1, face.mNormal);
+    if (face.mNormal.dot(w.mPoint) - face.mDistance
+        <= CONVEX_COLLISION_EPS * std::max(scale, 1e-12))
+      break;
+
+    // Remove the faces that see the new point, and keep the edges on the
+    // boundary of the removed region. An edge is on the boundary if only one
+    // of its two faces was removed.
+    const int index = static_cast<int>(vertices.size());
+    vertices.push_back(w);
+    std::map<std::pair<int, int>, bool> horizon;
+    std::vector<PolytopeFace> kept;
+    kept.reserve(faces.size());
+    for (const PolytopeFace& f : faces)
+    {
+      if (f.mNormal.dot(w.mPoint - vertices[f.mVertices[0]].mPoint) <= 0.0)
+      {
+        kept.push_back(f);
+        continue;
+      }
+
+      for (int j = 0; j < 3; ++j)
+      {
+        const int u = f.mVertices[j];
+        const int v = f.mVertices[(j + 1) % 3];
+        std::map<std::pair<int, int>, bool>::iterator twin
+            = horizon.find(std::make_pair(v, u));
+        if (twin != horizon.end())
+          horizon.erase(twin);
+        else
+          horizon[std::make_pair(u, v)] = true;
+      }
+    }
+
+    if (horizon.empty())
+      break;
+
+    faces.swap(kept);
+    for (const auto& edge : horizon)
+    {
+      PolytopeFace newFace;
+      if (makePolytopeFace(vertices, edge.first.first, edge.first.second,
+                           index, &newFace))
+      {
+        faces.push_back(newFace);
+      }
+    }
+
+    if (faces.empty())
+      return;
+
+    scale = std::max(scale, w.mPoint.norm());
+  }
+
+  closest = 0;
+  for (size_t i = 1; i < faces.size(); ++i)
+  {
+    if (faces[i].mDistance < faces[closest].mDistance)
+      closest = i;
+  }
+  const PolytopeFace& face = faces[closest];
+
+  // Barycentric coordinates of the projection of the origin on the face
+  const SupportPoint& A = vertices[face.mVertices[0]];
+  const SupportPoint& B = vertices[face.mVertices[1]];
+  const SupportPoint& C = vertices[face.mVertices[2]];
+  const Eigen::Vector3d p = face.mDistance * face.mNormal;
+  const Eigen::Vector3d v0 = B.mPoint - A.mPoint;
+  const Eigen::Vector3d v1 = C.mPoint - A.mPoint;
+  const Eigen::Vector3d v2 = p - A.mPoint;
+  const double d00 = v0.dot(v0);
+  const double d01 = v0.dot(v1);
+  const double d11 = v1.dot(v1);
+  const double d20 = v2.dot(v0);
+  const double d21 = v2.dot(v1);
+  const double denom = d00 * d11 - d01 * d01;
+  double v = 1.0 / 3.0;
+  double w = 1.0 / 3.0;
+  if (denom != 0.0)
+  {
+    v = (d11 * d20 - d01 * d21) / denom;
+    w = (d00 * d21 - d01 * d20) / denom;
+  }
+  const double u = 1.0 - v - w;
+
+  const Eigen::Vector3d point0 = u * A.mPoint0 + v * B.mPoint0 + w * C.mPoint0;
+  const Eigen::Vector3d point1 = u * A.mPoint1 + v * B.mPoint1 + w * C.mPoint1;
+
+  *_normal = -face.mNormal;
+  *_depth = std::max(face.mDistance, 0.0);
+  *_point = 0.5 * (point0 + point1);
+}
+
+//==============================================================================
+SupportFunction makeHullSupport(const math::ConvexHull& _hull,
+                                const Eigen::Isometry3d& _T)
+{
+  return [&_hull, &_T](const Eigen::Vector3d& _direction)
+  {
+    return Eigen::Vector3d(
+          _T * _hull.getSupportPoint(_T.linear().transpose() * _direction));
+  };
+}
+
+//==============================================================================
+// Bounding sphere of the hull in world coordinates, for early rejection
+void computeBoundingSphere(const math::ConvexHull& _hull,
+                           const Eigen::Isometry3d& _T,
+                           Eigen::Vector3d* _center, double* _radius)
+{
+  const Eigen::Vector3d center = _hull.computeCenter();
+  double radius = 0.0;
+  for (const Eigen::Vector3d& vertex : _hull.getVertices())
+    radius = std::max(radius, (vertex - center).squaredNorm());
+
+  *_center = _T * center;
+  *_radius = std::sqrt(radius);
+}
+
+//==============================================================================
+// Add the vertices of _hull0 that are inside _hull1 and no deeper than _depth
+// below the support plane _offset of _hull1 along _normal
+void findContactCandidates(const math::ConvexHull& _hull0,
+                           const Eigen::Isometry3d& _T0,
+                           const math::ConvexHull& _hull1,
+                           const Eigen::Isometry3d& _T1,
+                           const Eigen::Vector3d& _normal, double _offset,
+                           double _depth, double _tolerance,
+                           std::vector<Contact>* _candidates)
+{
+  if (!_hull1.hasVolume())
+    return;
+
+  const Eigen::Isometry3d T10 = _T1.inverse() * _T0;
+  for (const Eigen::Vector3d& vertex : _hull0.getVertices())
+  {
+    const Eigen::Vector3d point = _T0 * vertex;
+    const double depth = _offset - _normal.dot(point);
+    if (depth < -_tolerance || depth > _depth + _tolerance)
+      continue;
+
+    if (_hull1.computeSignedDistance(T10 * vertex) > _tolerance)
+      continue;
+
+    Contact candidate;
+    candidate.point = point;
+    candidate.penetrationDepth = std::min(std::max(depth, 0.0), _depth);
+    _candidates->push_back(candidate);
+  }
+}
+
+//==============================================================================
+// Points of the two shapes that make up the point _v of the simplex
+void computeWitnessPoints(const std::vector<SupportPoint>& _simplex,
+                          const Eigen::Vector3d& _v,
+                          Eigen::Vector3d* _point0, Eigen::Vector3d* _point1)
+{
+  // Barycentric coordinates of _v on the segment or the triangle
+  Eigen::Vector3d weights(1.0, 0.0, 0.0);
+  if (_simplex.size() == 2)
+  {
+    const Eigen::Vector3d ab = _simplex[1].mPoint - _simplex[0].mPoint;
+    const double abab = ab.squaredNorm();
+    const double t = abab > 0.0 ? (_v - _simplex[0].mPoint).dot(ab) / abab
+                                : 0.0;
+    weights << 1.0 - t, t, 0.0;
+  }
+  else if (_simplex.size() >= 3)
+  {
+    const Eigen::Vector3d ab = _simplex[1].mPoint - _simplex[0].mPoint;
+    const Eigen::Vector3d ac = _simplex[2].mPoint - _simplex[0].mPoint;
+    const Eigen::Vector3d ap = _v - _simplex[0].mPoint;
+    const double d00 = ab.dot(ab);
+    const double d01 = ab.dot(ac);
+    const double d11 = ac.dot(ac);
+    const double d20 = ap.dot(ab);
+    const double d21 = ap.dot(ac);
+    const double denom = d00 * d11 - d01 * d01;
+    if (denom > 0.0)
+    {
+      const double v = (d11 * d20 - d01 * d21) / denom;
+      const double w = (d00 * d21 - d01 * d20) / denom;
+      weights << 1.0 - v - w, v, w;
+    }
+  }
+
+  _point0->setZero();
+  _point1->setZero();
+  for (size_t i = 0; i < _simplex.size() && i < 3; ++i)
+  {
+    *_point0 += weights[i] * _simplex[i].mPoint0;
+    *_point1 += weights[i] * _simplex[i].mPoint1;
+  }
+}
+
+}  // anonymous namespace
+
+//==============================================================================
+double computeDistance(const SupportFunction& _support0,
+                       const SupportFunction& _support1,
+                       Eigen::Vector3d* _point0, Eigen::Vector3d* _point1,
+                       Eigen::Vector3d* _direction, double _threshold)
+{
+  std::vector<SupportPoint> simplex;
+  simplex.reserve(4);
+
+  // Start from the support point along the last separating direction, which
+  // is already the closest point when the shapes barely moved
+  const Eigen::Vector3d guess
+      = (_direction && !_direction->isZero()) ? *_direction
+                                              : Eigen::Vector3d::UnitX();
+  simplex.push_back(computeSupport(_support0, _support1, -guess));
+  Eigen::Vector3d v = simplex[0].mPoint;
+  double scale = std::max(v.norm(), 1.0);
+
+  bool separated = false;
+  bool inside = false;
+  for (int i = 0; i < GJK_MAX_ITERATIONS; ++i)
+  {
+    if (v.norm() <= CONVEX_COLLISION_EPS * scale)
+      break;
+
+    const SupportPoint w = computeSupport(_support0, _support1, -v);
+    scale = std::max(scale, w.mPoint.norm());
+
+    // The support plane bounds the distance from below
+    const double vw = v.dot(w.mPoint);
+    if (vw > _threshold * v.norm())
+    {
+      computeWitnessPoints(simplex, v, _point0, _point1);
+      if (_direction)
+        *_direction = v;
+      return vw / v.norm();
+    }
+
+    // The squared distance is known up to the relative tolerance. Support
+    // points far from the origin add rounding errors, so a tighter test
+    // could stall on large shapes.
+    if (v.squaredNorm() - vw <= CONVEX_COLLISION_EPS * v.squaredNorm())
+    {
+      separated = true;
+      break;
+    }
+
+    simplex.push_back(w);
+    if (!reduceSimplex(&simplex, &v))
+    {
+      inside = true;
+      break;
+    }
+  }
+
+  if (separated || (!inside && v.norm() > CONVEX_COLLISION_EPS * scale))
+  {
+    computeWitnessPoints(simplex, v, _point0, _point1);
+    if (_direction)
+      *_direction = v;
+    return v.norm();
+  }
+
+  // The shapes intersect, so their signed distance is the negative depth of
+  // the penetration
+  Eigen::Vector3d normal;
+  Eigen::Vector3d point;
+  double depth;
+  if (!computePenetration(_support0, _support1, &normal, &depth, &point))
+  {
+    // The shapes only touch
+    computeWitnessPoints(simplex, v, _point0, _point1);
+    return 0.0;
+  }
+
+  *_point0 = point - 0.5 * depth * normal;
+  *_point1 = point + 0.5 * depth * normal;
+  if (_direction)
+    *_direction = normal;
+  return -depth;
+}
+
+//==============================================================================
+bool computePenetration(const SupportFunction& _support0,
+                        const SupportFunction& _support1,
+                        Eigen::Vector3d* _normal, double* _depth,
+                        Eigen::Vector3d* _point)
+{
+  std::vector<SupportPoint> simplex;
+  simplex.reserve(4);
+  if (!runGjk(_support0, _support1, &simplex))
+    return false;
+
+  runEpa(_support0, _support1, simplex, _normal, _depth, _point);
+  return true;
+}
+
+//==============================================================================
+void selectContacts(std::vector<Contact>* _contacts, size_t _maxNumContacts,
+                    double _tolerance)
+{
+  if (_contacts->empty())
+    return;
+
+  // Keep the deepest contact, and then the ones farthest from those kept so
+  // far, so that the contact patch keeps its extent
+  std::vector<Contact> candidates;
+  candidates.swap(*_contacts);
+
+  size_t deepest = 0;
+  for (size_t i = 1; i < candidates.size(); ++i)
+  {
+    if (candidates[i].penetrationDepth > candidates[deepest].penetrationDepth)
+      deepest = i;
+  }
+  _contacts->push_back(candidates[deepest]);
+  candidates.erase(candidates.begin() + deepest);
+
+  while (_contacts->size() < _maxNumContacts && !candidates.empty())
+  {
+    size_t farthest = 0;
+    double farthestDistance = -1.0;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      double distance = std::numeric_limits<double>::infinity();
+      for (size_t j = 0; j < _contacts->size(); ++j)
+      {
+        distance = std::min(
+              distance,
+              (candidates[i].point - (*_contacts)[j].point).squaredNorm());
+      }
+
+      if (distance > farthestDistance)
+      {
+        farthest = i;
+        farthestDistance = distance;
+      }
+    }
+
+    if (farthestDistance <= _tolerance * _tolerance)
+      break;
+
+    _contacts->push_back(candidates[farthest]);
+    candidates.erase(candidates.begin() + farthest);
+  }
+}
+
+//==============================================================================
+int collideConvexHulls(const math::ConvexHull& _hull0,
+                       const Eigen::Isometry3d& _T0,
+                       const math::ConvexHull& _hull1,
+                       const Eigen::Isometry3d& _T1,
+                       std::vector<Contact>* _result)
+{
+  if (_hull0.isEmpty() || _hull1.isEmpty())
+    return 0;
+
+  Eigen::Vector3d center0;
+  Eigen::Vector3d center1;
+  double radius0;
+  double radius1;
+  computeBoundingSphere(_hull0, _T0, &center0, &radius0);
+  computeBoundingSphere(_hull1, _T1, &center1, &radius1);
+  if ((center0 - center1).norm() > radius0 + radius1)
+    return 0;
+
+  const SupportFunction support0 = makeHullSupport(_hull0, _T0);
+  const SupportFunction support1 = makeHullSupport(_hull1, _T1);
+
+  Eigen::Vector3d normal;
+  Eigen::Vector3d point;
+  double depth;
+  if (!computePenetration(support0, support1, &normal, &depth, &point))
+    return 0;
+
+  // Vertices of either hull that are inside the other hull form the contact
+  // patch. The first hull separates by moving along the normal, so its
+  // vertices are measured from the highest point of the second hull, and the
+  // vertices of the second hull from the lowest point of the first hull.
+  const double tolerance
+      = CONVEX_COLLISION_EPS * std::max(radius0 + radius1, 1.0);
+  std::vector<Contact> candidates;
+  const double offset1 = normal.dot(support1(normal));
+  findContactCandidates(_hull0, _T0, _hull1, _T1, normal, offset1, depth,
+                        tolerance, &candidates);
+  const double offset0 = -normal.dot(support0(-normal));
+  findContactCandidates(_hull1, _T1, _hull0, _T0, -normal, offset0, depth,
+                        tolerance, &candidates);
+
+  if (candidates.empty())
+  {
+    Contact candidate;
+    candidate.point = point;
+    candidate.penetrationDepth = depth;
+    candidates.push_back(candidate);
+  }
+
+  selectContacts(&candidates, MAX_CONVEX_CONTACTS, tolerance);
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    candidates[i].normal = normal;
+    _result->push_back(candidates[i]);
+  }
+
+  return static_cast<int>(candidates.size());
+}
+
+//==============================================================================
+int collideConvexHullSphere(const math::ConvexHull& _hull0,
+                            const Eigen::Isometry3d& _T0,
+                            double _r1, const Eigen::Isometry3d& _T1,
+                            std::vector<Contact>* _result)
+{
+  if (_hull0.isEmpty())
+    return 0;
+
+  Eigen::Vector3d center0;
+  double radius0;
+  computeBoundingSphere(_hull0, _T0, &center0, &radius0);
+  const Eigen::Vector3d center1 = _T1.translation();
+  if ((center0 - center1).norm() > radius0 + _r1)
+    return 0;
+
+  const SupportFunction support0 = makeHullSupport(_hull0, _T0);
+  const SupportFunction support1
+      = [&center1, _r1](const Eigen::Vector3d& _direction)
+  {
+    const double norm = _direction.norm();
+    if (norm == 0.0)
+      return center1;
+    return Eigen::Vector3d(center1 + (_r1 / norm) * _direction);
+  };
+
+  Contact contact;
+  if (!computePenetration(support0, support1, &contact.normal,
+                          &contact.penetrationDepth, &contact.point))
+  {
+    return 0;
+  }
+
+  _result->push_back(contact);
+  return 1;
+}
+
+}  // namespace collision
+}  // namespace dart
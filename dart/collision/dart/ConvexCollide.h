@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_CONVEXCOLLIDE_H_
+#define DART_COLLISION_DART_CONVEXCOLLIDE_H_
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/ConvexHull.h"
+#include "dart/collision/CollisionDetector.h"
+
+namespace dart {
+namespace collision {
+
+/// Support function of a convex shape, which returns the point of the shape
+/// that is farthest along a direction. Both are in world coordinates.
+typedef std::function<Eigen::Vector3d(const Eigen::Vector3d&)>
+    SupportFunction;
+
+/// Return true if the convex shapes of _support0 and _support1 intersect.
+/// Intersection is decided with GJK, and the penetration is then found with
+/// EPA: _normal is the direction in which the first shape must move by
+/// _depth to separate the shapes, and _point lies halfway between the
+/// deepest points of the shapes. The outputs are only set on intersection.
+bool computePenetration(const SupportFunction& _support0,
+                        const SupportFunction& _support1,
+                        Eigen::Vector3d* _normal, double* _depth,
+                        Eigen::Vector3d* _point);
+
+/// Return the distance between the convex shapes of _support0 and _support1,
+/// or the negative depth of their penetration if they intersect. _point0 and
+/// _point1 are set to the closest points of the shapes, or to their deepest
+/// points in each other. _direction warm-starts GJK unless it is NULL or
+/// zero, and is set to the direction in which the first shape is separated
+/// from the second one, so that repeated queries on slowly moving shapes take
+/// few iterations. GJK stops early once the distance is known to be larger
+/// than _threshold, and returns a lower bound larger than _threshold.
+double computeDistance(const SupportFunction& _support0,
+                       const SupportFunction& _support1,
+                       Eigen::Vector3d* _point0, Eigen::Vector3d* _point1,
+                       Eigen::Vector3d* _direction = NULL,
+                       double _threshold
+                           = std::numeric_limits<double>::infinity());
+
+/// Reduce _contacts to at most _maxNumContacts contacts. The deepest contact
+/// is kept first, and then the contacts farthest from the kept ones, until
+/// the remaining ones are within _tolerance of a kept one.
+void selectContacts(std::vector<Contact>* _contacts, size_t _maxNumContacts,
+                    double _tolerance);
+
+/// Collide two convex hulls. Up to four contact points are taken from the
+/// vertices of each hull that are inside the other one, so that faces
+/// resting on each other get a stable contact patch.
+int collideConvexHulls(const math::ConvexHull& _hull0,
+                       const Eigen::Isometry3d& _T0,
+                       const math::ConvexHull& _hull1,
+                       const Eigen::Isometry3d& _T1,
+                       std::vector<Contact>* _result);
+
+/// Collide a convex hull with a sphere of radius _r1
+int collideConvexHullSphere(const math::ConvexHull& _hull0,
+                            const Eigen::Isometry3d& _T0,
+                            double _r1, const Eigen::Isometry3d& _T1,
+                            std::vector<Contact>* _result);
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_CONVEXCOLLIDE_H_
@@ -36,12 +36,18 @@
 
 #include "dart/collision/dart/DARTCollide.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 #include "dart/math/Helpers.h"
 #include "dart/dynamics/BoxShape.h"
 #include "dart/dynamics/EllipsoidShape.h"
 #include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/HeightmapShape.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/collision/dart/ConvexCollide.h"
 
 namespace dart {
 namespace collision {
@@ -1215,6 +1221,637 @@ int collideCylinderPlane(const double& cyl_rad, const double& half_height, const
   return 0;
 }
 
+// Convex hull of a box of the given size centered at the origin
+static math::ConvexHull computeBoxHull(const Eigen::Vector3d& _size)
+{
+  std::vector<Eigen::Vector3d> corners;
+  corners.reserve(8);
+  for (int i = 0; i < 8; ++i)
+  {
+    corners.push_back(0.5 * Eigen::Vector3d((i & 1) ? _size[0] : -_size[0],
+                                            (i & 2) ? _size[1] : -_size[1],
+                                            (i & 4) ? _size[2] : -_size[2]));
+  }
+
+  return math::ConvexHull(corners);
+}
+
+// Every vertex of the hull below the plane is a contact
+static int collideConvexHullPlane(const math::ConvexHull& _hull,
+                                  const Eigen::Isometry3d& _T0,
+                                  const dynamics::PlaneShape* _plane,
+                                  const Eigen::Isometry3d& _T1,
+                                  std::vector<Contact>* _result)
+{
+  const Eigen::Vector3d normal = _T1.linear() * _plane->getNormal();
+  const double offset = normal.dot(_T1.translation()) + _plane->getOffset();
+
+  int numContacts = 0;
+  const std::vector<Eigen::Vector3d>& vertices = _hull.getVertices();
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    const Eigen::Vector3d point = _T0 * vertices[i];
+    const double depth = offset - normal.dot(point);
+    if (depth <= 0.0)
+      continue;
+
+    Contact contact;
+    contact.point = point;
+    contact.normal = normal;
+    contact.penetrationDepth = depth;
+    _result->push_back(contact);
+    ++numContacts;
+  }
+
+  return numContacts;
+}
+
+int collideMesh(const dynamics::MeshShape* _mesh0,
+                const Eigen::Isometry3d& _T0,
+                const dynamics::Shape* _shape1, const Eigen::Isometry3d& _T1,
+                std::vector<Contact>* _result)
+{
+  const std::vector<math::ConvexHull>& pieces0
+      = _mesh0->getConvexDecomposition();
+
+  std::vector<math::ConvexHull> boxHull;
+  const std::vector<math::ConvexHull>* pieces1 = &boxHull;
+  switch(_shape1->getShapeType())
+  {
+    case dynamics::Shape::BOX:
+    {
+      const dynamics::BoxShape* box1 = static_cast<const dynamics::BoxShape*>(_shape1);
+      boxHull.push_back(computeBoxHull(box1->getSize()));
+      break;
+    }
+    case dynamics::Shape::ELLIPSOID:
+    {
+      const dynamics::EllipsoidShape* ellipsoid1 = static_cast<const dynamics::EllipsoidShape*>(_shape1);
+      int numContacts = 0;
+      for (size_t i = 0; i < pieces0.size(); ++i)
+      {
+        numContacts += collideConvexHullSphere(
+              pieces0[i], _T0, ellipsoid1->getSize()[0] * 0.5, _T1, _result);
+      }
+      return numContacts;
+    }
+    case dynamics::Shape::CYLINDER:
+    {
+      //----------------------------------------------------------
+      // NOT SUPPORT CYLINDER
+      //----------------------------------------------------------
+      const dynamics::CylinderShape* cylinder1 = static_cast<const dynamics::CylinderShape*>(_shape1);
+
+      Eigen::Vector3d dimTemp(cylinder1->getRadius() * sqrt(2.0),
+                              cylinder1->getRadius() * sqrt(2.0),
+                              cylinder1->getHeight());
+      boxHull.push_back(computeBoxHull(dimTemp));
+      break;
+    }
+    case dynamics::Shape::MESH:
+    {
+      const dynamics::MeshShape* mesh1 = static_cast<const dynamics::MeshShape*>(_shape1);
+      pieces1 = &mesh1->getConvexDecomposition();
+      break;
+    }
+    case dynamics::Shape::PLANE:
+    {
+      const dynamics::PlaneShape* plane1 = static_cast<const dynamics::PlaneShape*>(_shape1);
+      int numContacts = 0;
+      for (size_t i = 0; i < pieces0.size(); ++i)
+      {
+        numContacts += collideConvexHullPlane(pieces0[i], _T0, plane1, _T1,
+                                              _result);
+      }
+      return numContacts;
+    }
+    default:
+      // Other shapes, such as heightmaps and soft meshes, are not supported
+      return 0;
+  }
+
+  int numContacts = 0;
+  for (size_t i = 0; i < pieces0.size(); ++i)
+  {
+    for (size_t j = 0; j < pieces1->size(); ++j)
+    {
+      numContacts += collideConvexHulls(pieces0[i], _T0, (*pieces1)[j], _T1,
+                                        _result);
+    }
+  }
+
+  return numContacts;
+}
+
+// Convex hull of a cylinder along the z-axis
+static math::ConvexHull computeCylinderHull(double _radius, double _height)
+{
+  const int numSegments = 16;
+  std::vector<Eigen::Vector3d> points;
+  points.reserve(2 * numSegments);
+  for (int i = 0; i < numSegments; ++i)
+  {
+    const double angle = 2.0 * DART_PI * i / numSegments;
+    const double x = _radius * std::cos(angle);
+    const double y = _radius * std::sin(angle);
+    points.push_back(Eigen::Vector3d(x, y, -0.5 * _height));
+    points.push_back(Eigen::Vector3d(x, y, 0.5 * _height));
+  }
+
+  return math::ConvexHull(points);
+}
+
+// Collide a heightmap with convex hulls. Vertices of a hull that are below the
+// terrain and samples of the terrain that are inside a hull make the
+// contacts, so only the cells under the hull are visited.
+static int collideHeightmapHulls(const dynamics::HeightmapShape* _heightmap,
+                                 const Eigen::Isometry3d& _T0,
+                                 const std::vector<math::ConvexHull>& _hulls,
+                                 const Eigen::Isometry3d& _T1,
+                                 std::vector<Contact>* _result)
+{
+  const Eigen::Isometry3d T01 = _T0.inverse() * _T1;
+  const Eigen::Isometry3d T10 = T01.inverse();
+  int numContacts = 0;
+
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<Contact> contacts;
+  for (size_t i = 0; i < _hulls.size(); ++i)
+  {
+    const math::ConvexHull& hull = _hulls[i];
+    if (hull.isEmpty())
+      continue;
+
+    // Vertices of the hull in the frame of the heightmap
+    vertices.clear();
+    Eigen::Vector3d min = Eigen::Vector3d::Constant(
+          std::numeric_limits<double>::infinity());
+    Eigen::Vector3d max = -min;
+    for (size_t j = 0; j < hull.getVertices().size(); ++j)
+    {
+      vertices.push_back(T01 * hull.getVertices()[j]);
+      min = min.cwiseMin(vertices.back());
+      max = max.cwiseMax(vertices.back());
+    }
+
+    if (min[2] > _heightmap->getMaxHeight()
+        || max[2] < _heightmap->getMinHeight())
+    {
+      continue;
+    }
+
+    contacts.clear();
+    for (size_t j = 0; j < vertices.size(); ++j)
+    {
+      const Eigen::Vector3d& v = vertices[j];
+      double height;
+      Eigen::Vector3d normal;
+      if (!_heightmap->computeHeight(v[0], v[1], &height, &normal)
+          || v[2] >= height)
+      {
+        continue;
+      }
+
+      Contact contact;
+      contact.point = _T0 * v;
+      contact.normal = -(_T0.linear() * normal);
+      contact.penetrationDepth = (height - v[2]) * normal[2];
+      contacts.push_back(contact);
+    }
+
+    size_t rowBegin;
+    size_t colBegin;
+    size_t rowEnd;
+    size_t colEnd;
+    if (hull.hasVolume()
+        && _heightmap->getCellRange(min.head<2>(), max.head<2>(),
+                                    &rowBegin, &colBegin, &rowEnd, &colEnd))
+    {
+      for (size_t row = rowBegin; row <= rowEnd; ++row)
+      {
+        for (size_t col = colBegin; col <= colEnd; ++col)
+        {
+          const Eigen::Vector3d p = _heightmap->getVertex(row, col);
+          if (p[2] < min[2])
+            continue;
+
+          // The face of the hull that the sample is closest to pushes it out
+          const Eigen::Vector3d q = T10 * p;
+          double distance = -std::numeric_limits<double>::infinity();
+          size_t face = 0;
+          for (size_t k = 0; k < hull.getFaces().size(); ++k)
+          {
+            const double d = hull.getFaceNormal(k).dot(q)
+                - hull.getFaceOffset(k);
+            if (d > distance)
+            {
+              distance = d;
+              face = k;
+            }
+          }
+
+          // Samples on the boundary of the hull do not push it out
+          if (distance > -DART_COLLISION_EPS)
+            continue;
+
+          Contact contact;
+          contact.point = _T0 * p;
+          contact.normal = _T1.linear() * hull.getFaceNormal(face);
+          contact.penetrationDepth = -distance;
+          contacts.push_back(contact);
+        }
+      }
+    }
+
+    selectContacts(&contacts, 4, DART_COLLISION_EPS);
+    _result->insert(_result->end(), contacts.begin(), contacts.end());
+    numContacts += contacts.size();
+  }
+
+  return numContacts;
+}
+
+// Collide a heightmap with a sphere through the triangles under the sphere
+static int collideHeightmapSphere(const dynamics::HeightmapShape* _heightmap,
+                                  const Eigen::Isometry3d& _T0,
+                                  double _r1, const Eigen::Isometry3d& _T1,
+                                  std::vector<Contact>* _result)
+{
+  const Eigen::Vector3d c = _T0.inverse() * _T1.translation();
+  if (c[2] - _r1 > _heightmap->getMaxHeight()
+      || c[2] + _r1 < _heightmap->getMinHeight())
+  {
+    return 0;
+  }
+
+  size_t rowBegin;
+  size_t colBegin;
+  size_t rowEnd;
+  size_t colEnd;
+  const Eigen::Vector2d radius = Eigen::Vector2d::Constant(_r1);
+  if (!_heightmap->getCellRange(c.head<2>() - radius, c.head<2>() + radius,
+                                &rowBegin, &colBegin, &rowEnd, &colEnd))
+  {
+    return 0;
+  }
+
+  // Edges and vertices are only used when the sphere is over no triangle.
+  // Otherwise the shared edges of flat cells would tilt the normals.
+  std::vector<Contact> contacts;
+  std::vector<Contact> edgeContacts;
+  for (size_t row = rowBegin; row < rowEnd; ++row)
+  {
+    for (size_t col = colBegin; col < colEnd; ++col)
+    {
+      const Eigen::Vector3d v00 = _heightmap->getVertex(row, col);
+      const Eigen::Vector3d v01 = _heightmap->getVertex(row, col + 1);
+      const Eigen::Vector3d v10 = _heightmap->getVertex(row + 1, col);
+      const Eigen::Vector3d v11 = _heightmap->getVertex(row + 1, col + 1);
+      const Eigen::Vector3d* triangles[2][3] = {
+        {&v00, &v01, &v11}, {&v00, &v11, &v10}};
+
+      for (int i = 0; i < 2; ++i)
+      {
+        const Eigen::Vector3d& a = *triangles[i][0];
+        const Eigen::Vector3d& b = *triangles[i][1];
+        const Eigen::Vector3d& e = *triangles[i][2];
+        const Eigen::Vector3d n = (b - a).cross(e - a).normalized();
+        const double height = n.dot(c - a);
+        if (height >= _r1)
+          continue;
+
+        // Barycentric coordinates of the projection of the center
+        const Eigen::Vector3d p = c - height * n;
+        const double area = (b - a).cross(e - a).dot(n);
+        const double u = (e - b).cross(p - b).dot(n) / area;
+        const double v = (a - e).cross(p - e).dot(n) / area;
+        const double w = 1.0 - u - v;
+
+        Contact contact;
+        if (u >= 0.0 && v >= 0.0 && w >= 0.0)
+        {
+          // Above or below the inside of the triangle
+          contact.point = _T0 * p;
+          contact.normal = -(_T0.linear() * n);
+          contact.penetrationDepth = _r1 - height;
+          contacts.push_back(contact);
+        }
+        else
+        {
+          // Next to an edge or a vertex. Below the plane, one of the
+          // neighboring triangles reports the contact.
+          if (height < 0.0)
+            continue;
+
+          Eigen::Vector3d closest = a;
+          double best = std::numeric_limits<double>::infinity();
+          const Eigen::Vector3d* edges[3][2] = {{&a, &b}, {&b, &e}, {&e, &a}};
+          for (int j = 0; j < 3; ++j)
+          {
+            const Eigen::Vector3d& s = *edges[j][0];
+            const Eigen::Vector3d d = *edges[j][1] - s;
+            const double t = std::min(std::max(
+                  (c - s).dot(d) / d.squaredNorm(), 0.0), 1.0);
+            const Eigen::Vector3d q = s + t * d;
+            if ((c - q).squaredNorm() < best)
+            {
+              best = (c - q).squaredNorm();
+              closest = q;
+            }
+          }
+
+          const double distance = std::sqrt(best);
+          if (distance >= _r1)
+            continue;
+
+          const Eigen::Vector3d up
+              = distance > DART_COLLISION_EPS
+                ? Eigen::Vector3d((c - closest) / distance) : n;
+          contact.point = _T0 * closest;
+          contact.normal = -(_T0.linear() * up);
+          contact.penetrationDepth = _r1 - distance;
+          edgeContacts.push_back(contact);
+        }
+      }
+    }
+  }
+
+  if (contacts.empty())
+    contacts.swap(edgeContacts);
+  selectContacts(&contacts, 4, DART_COLLISION_EPS);
+  _result->insert(_result->end(), contacts.begin(), contacts.end());
+  return contacts.size();
+}
+
+int collideHeightmap(const dynamics::HeightmapShape* _heightmap0,
+                     const Eigen::Isometry3d& _T0,
+                     const dynamics::Shape* _shape1,
+                     const Eigen::Isometry3d& _T1,
+                     std::vector<Contact>* _result)
+{
+  switch(_shape1->getShapeType())
+  {
+    case dynamics::Shape::BOX:
+    {
+      const dynamics::BoxShape* box1 = static_cast<const dynamics::BoxShape*>(_shape1);
+      const std::vector<math::ConvexHull> hulls(
+            1, computeBoxHull(box1->getSize()));
+      return collideHeightmapHulls(_heightmap0, _T0, hulls, _T1, _result);
+    }
+    case dynamics::Shape::ELLIPSOID:
+    {
+      const dynamics::EllipsoidShape* ellipsoid1 = static_cast<const dynamics::EllipsoidShape*>(_shape1);
+      return collideHeightmapSphere(_heightmap0, _T0,
+                                    ellipsoid1->getSize()[0] * 0.5, _T1,
+                                    _result);
+    }
+    case dynamics::Shape::CYLINDER:
+    {
+      const dynamics::CylinderShape* cylinder1 = static_cast<const dynamics::CylinderShape*>(_shape1);
+      const std::vector<math::ConvexHull> hulls(
+            1, computeCylinderHull(cylinder1->getRadius(),
+                                   cylinder1->getHeight()));
+      return collideHeightmapHulls(_heightmap0, _T0, hulls, _T1, _result);
+    }
+    case dynamics::Shape::MESH:
+    {
+      const dynamics::MeshShape* mesh1 = static_cast<const dynamics::MeshShape*>(_shape1);
+      return collideHeightmapHulls(_heightmap0, _T0,
+                                   mesh1->getConvexDecomposition(), _T1,
+                                   _result);
+    }
+    default:
+      return false;
+  }
+}
+
+namespace {
+
+// Convex piece of a shape for distance queries, with a bounding sphere in
+// world coordinates to skip pairs of pieces that are too far apart
+struct DistancePiece
+{
+  SupportFunction support;
+  Eigen::Vector3d center;
+  double radius;
+};
+
+}  // anonymous namespace
+
+// Split _shape into convex pieces in world coordinates. The support functions
+// only capture pointers, so _shape and _T must outlive the pieces. Return
+// false if the distance to _shape can not be computed with support functions.
+static bool computeDistancePieces(const dynamics::Shape* _shape,
+                                  const Eigen::Isometry3d& _T,
+                                  std::vector<DistancePiece>* _pieces)
+{
+  const Eigen::Isometry3d* T = &_T;
+  DistancePiece piece;
+  piece.center = _T.translation();
+
+  switch(_shape->getShapeType())
+  {
+    case dynamics::Shape::BOX:
+    {
+      const Eigen::Vector3d* size
+          = &static_cast<const dynamics::BoxShape*>(_shape)->getSize();
+      piece.support = [size, T](const Eigen::Vector3d& _direction)
+      {
+        const Eigen::Vector3d local = T->linear().transpose() * _direction;
+        Eigen::Vector3d point;
+        for (int i = 0; i < 3; ++i)
+          point[i] = local[i] < 0.0 ? -0.5 * (*size)[i] : 0.5 * (*size)[i];
+        return Eigen::Vector3d(*T * point);
+      };
+      piece.radius = 0.5 * size->norm();
+      _pieces->push_back(piece);
+      return true;
+    }
+    case dynamics::Shape::ELLIPSOID:
+    {
+      const Eigen::Vector3d* size
+          = &static_cast<const dynamics::EllipsoidShape*>(_shape)->getSize();
+      piece.support = [size, T](const Eigen::Vector3d& _direction)
+      {
+        const Eigen::Vector3d radii = 0.5 * (*size);
+        const Eigen::Vector3d scaled = radii.cwiseProduct(
+              T->linear().transpose() * _direction);
+        const double norm = scaled.norm();
+        if (norm == 0.0)
+          return Eigen::Vector3d(T->translation());
+        const Eigen::Vector3d point = radii.cwiseProduct(scaled) / norm;
+        return Eigen::Vector3d(*T * point);
+      };
+      piece.radius = 0.5 * size->maxCoeff();
+      _pieces->push_back(piece);
+      return true;
+    }
+    case dynamics::Shape::CYLINDER:
+    {
+      const dynamics::CylinderShape* cylinder
+          = static_cast<const dynamics::CylinderShape*>(_shape);
+      piece.support = [cylinder, T](const Eigen::Vector3d& _direction)
+      {
+        const Eigen::Vector3d local = T->linear().transpose() * _direction;
+        const double lateral = local.head<2>().norm();
+        Eigen::Vector3d point = Eigen::Vector3d::Zero();
+        if (lateral > 0.0)
+        {
+          point.head<2>()
+              = (cylinder->getRadius() / lateral) * local.head<2>();
+        }
+        point[2] = local[2] < 0.0 ? -0.5 * cylinder->getHeight()
+                                  : 0.5 * cylinder->getHeight();
+        return Eigen::Vector3d(*T * point);
+      };
+      piece.radius = Eigen::Vector2d(cylinder->getRadius(),
+                                     0.5 * cylinder->getHeight()).norm();
+      _pieces->push_back(piece);
+      return true;
+    }
+    case dynamics::Shape::MESH:
+    {
+      const std::vector<math::ConvexHull>& hulls
+          = static_cast<const dynamics::MeshShape*>(_shape)
+            ->getConvexDecomposition();
+      for (size_t i = 0; i < hulls.size(); ++i)
+      {
+        const math::ConvexHull* hull = &hulls[i];
+        piece.support = [hull, T](const Eigen::Vector3d& _direction)
+        {
+          return Eigen::Vector3d(
+                *T * hull->getSupportPoint(T->linear().transpose()
+                                           * _direction));
+        };
+        const Eigen::Vector3d center = hull->computeCenter();
+        piece.radius = 0.0;
+        for (size_t j = 0; j < hull->getVertices().size(); ++j)
+        {
+          piece.radius = std::max(
+                piece.radius, (hull->getVertices()[j] - center).norm());
+        }
+        piece.center = _T * center;
+        _pieces->push_back(piece);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Signed distance from the pieces of a shape to the plane through _T with
+// local normal _normal and offset _offset
+static double computePlaneDistance(const std::vector<DistancePiece>& _pieces,
+                                   const Eigen::Vector3d& _normal,
+                                   double _offset, const Eigen::Isometry3d& _T,
+                                   Eigen::Vector3d* _point,
+                                   Eigen::Vector3d* _planePoint)
+{
+  const Eigen::Vector3d normal = _T.linear() * _normal;
+  const double offset = _offset + normal.dot(_T.translation());
+
+  double distance = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < _pieces.size(); ++i)
+  {
+    const Eigen::Vector3d point = _pieces[i].support(-normal);
+    const double pieceDistance = normal.dot(point) - offset;
+    if (pieceDistance < distance)
+    {
+      distance = pieceDistance;
+      *_point = point;
+      *_planePoint = point - pieceDistance * normal;
+    }
+  }
+
+  return distance;
+}
+
+double computeDistance(const dynamics::Shape* _shape0,
+                       const Eigen::Isometry3d& _T0,
+                       const dynamics::Shape* _shape1,
+                       const Eigen::Isometry3d& _T1,
+                       Eigen::Vector3d* _point0, Eigen::Vector3d* _point1,
+                       std::vector<Eigen::Vector3d>* _directions,
+                       double _threshold)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  const bool isPlane0 = _shape0->getShapeType() == dynamics::Shape::PLANE;
+  const bool isPlane1 = _shape1->getShapeType() == dynamics::Shape::PLANE;
+
+  std::vector<DistancePiece> pieces0;
+  std::vector<DistancePiece> pieces1;
+  if (isPlane0 && isPlane1)
+    return inf;
+  if (!isPlane0 && !computeDistancePieces(_shape0, _T0, &pieces0))
+    return inf;
+  if (!isPlane1 && !computeDistancePieces(_shape1, _T1, &pieces1))
+    return inf;
+
+  if (isPlane0)
+  {
+    const dynamics::PlaneShape* plane0
+        = static_cast<const dynamics::PlaneShape*>(_shape0);
+    return computePlaneDistance(pieces1, plane0->getNormal(),
+                                plane0->getOffset(), _T0, _point1, _point0);
+  }
+
+  if (isPlane1)
+  {
+    const dynamics::PlaneShape* plane1
+        = static_cast<const dynamics::PlaneShape*>(_shape1);
+    return computePlaneDistance(pieces0, plane1->getNormal(),
+                                plane1->getOffset(), _T1, _point0, _point1);
+  }
+
+  // One cached direction for each pair of pieces
+  const size_t numPairs = pieces0.size() * pieces1.size();
+  if (_directions && _directions->size() != numPairs)
+    _directions->assign(numPairs, Eigen::Vector3d::Zero());
+
+  double distance = inf;
+  for (size_t i = 0; i < pieces0.size(); ++i)
+  {
+    for (size_t j = 0; j < pieces1.size(); ++j)
+    {
+      const double bound = std::min(distance, _threshold);
+
+      // The bounding spheres give a lower bound of the distance of the pieces
+      const Eigen::Vector3d diff = pieces0[i].center - pieces1[j].center;
+      const double centerDistance = diff.norm();
+      const double lowerBound
+          = centerDistance - pieces0[i].radius - pieces1[j].radius;
+      if (lowerBound > bound)
+      {
+        if (lowerBound < distance && centerDistance > 0.0)
+        {
+          const Eigen::Vector3d dir = diff / centerDistance;
+          distance = lowerBound;
+          *_point0 = pieces0[i].center - pieces0[i].radius * dir;
+          *_point1 = pieces1[j].center + pieces1[j].radius * dir;
+        }
+        continue;
+      }
+
+      Eigen::Vector3d point0;
+      Eigen::Vector3d point1;
+      Eigen::Vector3d* direction
+          = _directions ? &(*_directions)[i * pieces1.size() + j] : NULL;
+      const double pieceDistance
+          = computeDistance(pieces0[i].support, pieces1[j].support,
+                            &point0, &point1, direction, bound);
+      if (pieceDistance < distance)
+      {
+        distance = pieceDistance;
+        *_point0 = point0;
+        *_point1 = point1;
+      }
+    }
+  }
+
+  return distance;
+}
+
 int collide(const dynamics::Shape* _shape0, const Eigen::Isometry3d& _T0,
             const dynamics::Shape* _shape1, const Eigen::Isometry3d& _T1,
             std::vector<Contact>* _result)
@@ -1222,6 +1859,42 @@ int collide(const dynamics::Shape* _shape0, const Eigen::Isometry3d& _T0,
   dynamics::Shape::ShapeType LeftType = _shape0->getShapeType();
   dynamics::Shape::ShapeType RightType = _shape1->getShapeType();
 
+  if (LeftType == dynamics::Shape::HEIGHTMAP)
+  {
+    return collideHeightmap(
+          static_cast<const dynamics::HeightmapShape*>(_shape0), _T0,
+          _shape1, _T1, _result);
+  }
+
+  if (RightType == dynamics::Shape::HEIGHTMAP)
+  {
+    const size_t first = _result->size();
+    const int numContacts = collideHeightmap(
+          static_cast<const dynamics::HeightmapShape*>(_shape1), _T1,
+          _shape0, _T0, _result);
+    for (size_t i = first; i < _result->size(); ++i)
+      (*_result)[i].normal = -(*_result)[i].normal;
+    return numContacts;
+  }
+
+  // Meshes collide through the convex pieces of their decomposition
+  if (LeftType == dynamics::Shape::MESH)
+  {
+    return collideMesh(static_cast<const dynamics::MeshShape*>(_shape0), _T0,
+                       _shape1, _T1, _result);
+  }
+
+  if (RightType == dynamics::Shape::MESH)
+  {
+    const size_t first = _result->size();
+    const int numContacts = collideMesh(
+          static_cast<const dynamics::MeshShape*>(_shape1), _T1,
+          _shape0, _T0, _result);
+    for (size_t i = first; i < _result->size(); ++i)
+      (*_result)[i].normal = -(*_result)[i].normal;
+    return numContacts;
+  }
+
   switch(LeftType)
   {
     case dynamics::Shape::BOX:
@@ -37,6 +37,7 @@
 #ifndef DART_COLLISION_DART_DARTCOLLIDE_H_
 #define DART_COLLISION_DART_DARTCOLLIDE_H_
 
+#include <limits>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -46,6 +47,8 @@
 namespace dart {
 namespace dynamics {
 class Shape;
+class MeshShape;
+class HeightmapShape;
 }  // namespace dynamics
 }  // namespace dart
 
@@ -56,6 +59,39 @@ int collide(const dynamics::Shape* _shape0, const Eigen::Isometry3d& _T0,
             const dynamics::Shape* _shape1, const Eigen::Isometry3d& _T1,
             std::vector<Contact>* _result);
 
+/// Return the distance between _shape0 and _shape1, or the negative depth of
+/// their penetration, over all pairs of their convex pieces. _point0 and
+/// _point1 are set to the closest points of the shapes. _directions caches
+/// the separating direction of each pair of pieces to warm-start the next
+/// query, and may be NULL. Pairs whose bounding spheres are farther apart
+/// than _threshold are skipped, so a distance larger than _threshold is only
+/// a lower bound, and its points are approximate. Return infinity if the
+/// distance to either shape can not be computed.
+double computeDistance(const dynamics::Shape* _shape0,
+                       const Eigen::Isometry3d& _T0,
+                       const dynamics::Shape* _shape1,
+                       const Eigen::Isometry3d& _T1,
+                       Eigen::Vector3d* _point0, Eigen::Vector3d* _point1,
+                       std::vector<Eigen::Vector3d>* _directions = NULL,
+                       double _threshold
+                           = std::numeric_limits<double>::infinity());
+
+/// Collide each convex piece of the decomposition of _mesh0 with _shape1,
+/// which may be a box, ellipsoid, cylinder, plane or another mesh. Other
+/// shapes produce no contacts.
+int collideMesh(const dynamics::MeshShape* _mesh0,
+                const Eigen::Isometry3d& _T0,
+                const dynamics::Shape* _shape1, const Eigen::Isometry3d& _T1,
+                std::vector<Contact>* _result);
+
+/// Collide _heightmap0 with _shape1, visiting only the cells of the grid
+/// under _shape1
+int collideHeightmap(const dynamics::HeightmapShape* _heightmap0,
+                     const Eigen::Isometry3d& _T0,
+                     const dynamics::Shape* _shape1,
+                     const Eigen::Isometry3d& _T1,
+                     std::vector<Contact>* _result);
+
 int collideBoxBox(const Eigen::Vector3d& size0, const Eigen::Isometry3d& T0,
                   const Eigen::Vector3d& size1, const Eigen::Isometry3d& T1,
                   std::vector<Contact>* result);
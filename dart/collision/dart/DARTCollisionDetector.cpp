@@ -40,20 +40,38 @@
 
 #include "dart/dynamics/Shape.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/MeshShape.h"
 #include "dart/collision/dart/DARTCollide.h"
 
 namespace dart {
 namespace collision {
 
 DARTCollisionDetector::DARTCollisionDetector()
-  : CollisionDetector() {
+  : CollisionDetector(),
+    mConvexMeshCollision(false) {
 }
 
 DARTCollisionDetector::~DARTCollisionDetector() {
 }
 
+CollisionDetector* DARTCollisionDetector::cloneWithoutCollisionObjects() const {
+  DARTCollisionDetector* collisionDetector = new DARTCollisionDetector();
+  collisionDetector->setNumMaxContacs(mNumMaxContacts);
+  collisionDetector->setConvexMeshCollision(mConvexMeshCollision);
+  return collisionDetector;
+}
+
 CollisionNode* DARTCollisionDetector::createCollisionNode(
     dynamics::BodyNode* _bodyNode) {
+  // Decompose meshes into convex pieces now rather than at the first contact
+  if (mConvexMeshCollision) {
+    for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); ++i) {
+      dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
+      if (shape->getShapeType() == dynamics::Shape::MESH)
+        static_cast<dynamics::MeshShape*>(shape)->getConvexDecomposition();
+    }
+  }
+
   return new CollisionNode(_bodyNode);
 }
 
@@ -68,6 +86,10 @@ bool DARTCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
   std::vector<Contact> contacts;
 
   for (size_t i = 0; i < mCollisionNodes.size(); i++) {
+    // Skip nodes that can not collide with anything before pairing them
+    if (!isCollidable(mCollisionNodes[i]))
+      continue;
+
     for (size_t j = i + 1; j < mCollisionNodes.size(); j++) {
       CollisionNode* collNode1 = mCollisionNodes[i];
       CollisionNode* collNode2 = mCollisionNodes[j];
@@ -79,6 +101,10 @@ bool DARTCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
 
       for (size_t k = 0; k < BodyNode1->getNumCollisionShapes(); k++) {
         for (size_t l = 0; l < BodyNode2->getNumCollisionShapes(); l++) {
+          if (isSkipped(BodyNode1->getCollisionShape(k),
+                        BodyNode2->getCollisionShape(l)))
+            continue;
+
           int currContactNum = mContacts.size();
 
           contacts.clear();
@@ -97,6 +123,7 @@ bool DARTCollisionDetector::detectCollision(bool /*_checkAllCollisions*/,
             contactPair = contacts[m];
             contactPair.bodyNode1 = BodyNode1;
             contactPair.bodyNode2 = BodyNode2;
+            contactPair.id = 0;
             assert(contactPair.bodyNode1 != NULL);
             assert(contactPair.bodyNode2 != NULL);
 
@@ -145,6 +172,10 @@ bool DARTCollisionDetector::detectCollision(CollisionNode* _collNode1,
 
   for (size_t i = 0; i < BodyNode1->getNumCollisionShapes(); i++) {
     for (size_t j = 0; j < BodyNode2->getNumCollisionShapes(); j++) {
+      if (isSkipped(BodyNode1->getCollisionShape(i),
+                    BodyNode2->getCollisionShape(j)))
+        continue;
+
       collide(BodyNode1->getCollisionShape(i),
               BodyNode1->getTransform()
               * BodyNode1->getCollisionShape(i)->getLocalTransform(),
@@ -158,5 +189,22 @@ bool DARTCollisionDetector::detectCollision(CollisionNode* _collNode1,
   return contacts.size() > 0 ? true : false;
 }
 
+void DARTCollisionDetector::setConvexMeshCollision(bool _convex) {
+  mConvexMeshCollision = _convex;
+}
+
+bool DARTCollisionDetector::isConvexMeshCollision() const {
+  return mConvexMeshCollision;
+}
+
+bool DARTCollisionDetector::isSkipped(const dynamics::Shape* _shape1,
+                                      const dynamics::Shape* _shape2) const {
+  if (mConvexMeshCollision)
+    return false;
+
+  return _shape1->getShapeType() == dynamics::Shape::MESH
+      || _shape2->getShapeType() == dynamics::Shape::MESH;
+}
+
 }  // namespace collision
 }  // namespace dart
@@ -51,6 +51,9 @@ public:
   /// \brief Default destructor
   virtual ~DARTCollisionDetector();
 
+  // Documentation inherited
+  virtual CollisionDetector* cloneWithoutCollisionObjects() const;
+
   // Documentation inherited
   virtual CollisionNode* createCollisionNode(dynamics::BodyNode* _bodyNode);
 
@@ -58,11 +61,27 @@ public:
   virtual bool detectCollision(bool _checkAllCollisions,
                                bool _calculateContactPoints);
 
+  /// Set whether MeshShapes collide through the convex pieces of their
+  /// decomposition (see MeshShape::getConvexDecomposition()). When this is
+  /// off, which is the default, MeshShapes are ignored by this detector.
+  void setConvexMeshCollision(bool _convex);
+
+  /// Return true if MeshShapes collide through their convex pieces
+  bool isConvexMeshCollision() const;
+
 protected:
   // Documentation inherited
   virtual bool detectCollision(CollisionNode* _collNode1,
                                CollisionNode* _collNode2,
                                bool _calculateContactPoints);
+
+  /// Return true if the pair of shapes is skipped because one of them is a
+  /// MeshShape and convex mesh collision is off
+  bool isSkipped(const dynamics::Shape* _shape1,
+                 const dynamics::Shape* _shape2) const;
+
+  /// Whether MeshShapes collide through their convex pieces
+  bool mConvexMeshCollision;
 };
 
 }  // namespace collision
@@ -43,20 +43,47 @@
 #include "dart/dynamics/BodyNode.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/collision/fcl/FCLCollisionNode.h"
+#include "dart/collision/dart/DARTCollide.h"
 
 namespace dart {
 namespace collision {
 
 FCLCollisionDetector::FCLCollisionDetector()
-  : CollisionDetector() {
+  : CollisionDetector(),
+    mBroadPhaseManager(new fcl::DynamicAABBTreeCollisionManager()) {
 }
 
 FCLCollisionDetector::~FCLCollisionDetector() {
+  delete mBroadPhaseManager;
+}
+
+CollisionDetector* FCLCollisionDetector::cloneWithoutCollisionObjects() const {
+  FCLCollisionDetector* collisionDetector = new FCLCollisionDetector();
+  collisionDetector->setNumMaxContacs(mNumMaxContacts);
+  return collisionDetector;
 }
 
 CollisionNode* FCLCollisionDetector::createCollisionNode(
     dynamics::BodyNode* _bodyNode) {
-  return new FCLCollisionNode(_bodyNode);
+  FCLCollisionNode* collNode = new FCLCollisionNode(_bodyNode);
+
+  for (int i = 0; i < collNode->getNumCollisionGeometries(); ++i)
+    mBroadPhaseManager->registerObject(collNode->getCollisionObject(i));
+
+  return collNode;
+}
+
+void FCLCollisionDetector::removeCollisionSkeletonNode(
+    dynamics::BodyNode* _bodyNode, bool _isRecursive) {
+  // Take the objects out of the tree before the node deletes them
+  FCLCollisionNode* collNode =
+      static_cast<FCLCollisionNode*>(getCollisionNode(_bodyNode));
+  if (collNode != NULL) {
+    for (int i = 0; i < collNode->getNumCollisionGeometries(); ++i)
+      mBroadPhaseManager->unregisterObject(collNode->getCollisionObject(i));
+  }
+
+  CollisionDetector::removeCollisionSkeletonNode(_bodyNode, _isRecursive);
 }
 
 bool FCLCollisionDetector::detectCollision(bool _checkAllCollisions,
@@ -68,82 +95,21 @@ bool FCLCollisionDetector::detectCollision(bool _checkAllCollisions,
   for (size_t i = 0; i < mCollisionNodes.size(); i++)
     mCollisionNodes[i]->getBodyNode()->setColliding(false);
 
-  fcl::CollisionResult result;
-
   // only evaluate contact points if data structure for returning the contact
   // points was provided
-  fcl::CollisionRequest request;
-  request.enable_contact = _calculateContactPoints;
-  request.num_max_contacts = mNumMaxContacts;
-  //    request.enable_cost;
-  //    request.num_max_cost_sources;
-  //    request.use_approximate_cost;
+  mRequest.enable_contact = _calculateContactPoints;
+  mRequest.num_max_contacts = mNumMaxContacts;
 
+  // Refit only the objects that moved since the last call
+  mMovedObjects.clear();
   for (size_t i = 0; i < mCollisionNodes.size(); i++) {
-    for (size_t j = i + 1; j < mCollisionNodes.size(); j++) {
-      result.clear();
-      FCLCollisionNode* collNode1 =
-          static_cast<FCLCollisionNode*>(mCollisionNodes[i]);
-      FCLCollisionNode* collNode2 =
-          static_cast<FCLCollisionNode*>(mCollisionNodes[j]);
-
-      if (!isCollidable(collNode1, collNode2))
-        continue;
-
-      for (int k = 0; k < collNode1->getNumCollisionGeometries(); k++) {
-        for (int l = 0; l < collNode2->getNumCollisionGeometries(); l++) {
-          int currContactNum = mContacts.size();
-          fcl::collide(collNode1->getCollisionGeometry(k),
-                       collNode1->getFCLTransform(k),
-                       collNode2->getCollisionGeometry(l),
-                       collNode2->getFCLTransform(l),
-                       request, result);
-
-          unsigned int numContacts = result.numContacts();
-
-          for (unsigned int m = 0; m < numContacts; ++m) {
-            const fcl::Contact& contact = result.getContact(m);
-
-            Contact contactPair;
-            contactPair.point(0) = contact.pos[0];
-            contactPair.point(1) = contact.pos[1];
-            contactPair.point(2) = contact.pos[2];
-            contactPair.normal(0) = contact.normal[0];
-            contactPair.normal(1) = contact.normal[1];
-            contactPair.normal(2) = contact.normal[2];
-            contactPair.bodyNode1 = findCollisionNode(contact.o1)->getBodyNode();
-            contactPair.bodyNode2 = findCollisionNode(contact.o2)->getBodyNode();
-            assert(contactPair.bodyNode1 != NULL);
-            assert(contactPair.bodyNode2 != NULL);
-//            contactPair.bdID1 =
-//                collisionNodePair.collisionNode1->getBodyNodeID();
-//            contactPair.bdID2 =
-//                collisionNodePair.collisionNode2->getBodyNodeID();
-            contactPair.penetrationDepth = contact.penetration_depth;
-
-            mContacts.push_back(contactPair);
-          }
-
-          std::vector<bool>markForDeletion(numContacts, false);
-          for (size_t m = 0; m < numContacts; m++) {
-            for (size_t n = m + 1; n < numContacts; n++) {
-              Eigen::Vector3d diff =
-                  mContacts[currContactNum + m].point -
-                  mContacts[currContactNum + n].point;
-              if (diff.dot(diff) < 1e-6) {
-                markForDeletion[m] = true;
-                break;
-              }
-            }
-          }
-          for (int m = numContacts - 1; m >= 0; m--) {
-            if (markForDeletion[m])
-              mContacts.erase(mContacts.begin() + currContactNum + m);
-          }
-        }
-      }
-    }
+    static_cast<FCLCollisionNode*>(
+          mCollisionNodes[i])->updateCollisionObjects(&mMovedObjects);
   }
+  if (!mMovedObjects.empty())
+    mBroadPhaseManager->update(mMovedObjects);
+
+  mBroadPhaseManager->collide(this, collisionCallback);
 
   for (size_t i = 0; i < mContacts.size(); ++i)
   {
@@ -155,6 +121,93 @@ bool FCLCollisionDetector::detectCollision(bool _checkAllCollisions,
   return !mContacts.empty();
 }
 
+bool FCLCollisionDetector::collisionCallback(fcl::CollisionObject* _o1,
+                                             fcl::CollisionObject* _o2,
+                                             void* _data) {
+  FCLCollisionDetector* cd = static_cast<FCLCollisionDetector*>(_data);
+  FCLUserData* userData1 = static_cast<FCLUserData*>(_o1->getUserData());
+  FCLUserData* userData2 = static_cast<FCLUserData*>(_o2->getUserData());
+  assert(userData1 != NULL);
+  assert(userData2 != NULL);
+
+  // Shapes of the same body do not collide with each other
+  if (userData1->fclCollNode == userData2->fclCollNode)
+    return false;
+
+  if (!cd->isCollidable(userData1->fclCollNode, userData2->fclCollNode))
+    return false;
+
+  // Heightmaps collide through the cells of their grids
+  if (userData1->shape->getShapeType() == dynamics::Shape::HEIGHTMAP
+      || userData2->shape->getShapeType() == dynamics::Shape::HEIGHTMAP) {
+    std::vector<Contact> contacts;
+    collide(userData1->shape,
+            userData1->bodyNode->getTransform()
+            * userData1->shape->getLocalTransform(),
+            userData2->shape,
+            userData2->bodyNode->getTransform()
+            * userData2->shape->getLocalTransform(),
+            &contacts);
+    for (size_t m = 0; m < contacts.size(); ++m) {
+      contacts[m].bodyNode1 = userData1->bodyNode;
+      contacts[m].bodyNode2 = userData2->bodyNode;
+      contacts[m].shape1 = userData1->shape;
+      contacts[m].shape2 = userData2->shape;
+      contacts[m].id = 0;
+      cd->mContacts.push_back(contacts[m]);
+    }
+    return false;
+  }
+
+  cd->mResult.clear();
+  fcl::collide(_o1, _o2, cd->mRequest, cd->mResult);
+
+  int currContactNum = cd->mContacts.size();
+  unsigned int numContacts = cd->mResult.numContacts();
+
+  for (unsigned int m = 0; m < numContacts; ++m) {
+    const fcl::Contact& contact = cd->mResult.getContact(m);
+
+    Contact contactPair;
+    contactPair.point(0) = contact.pos[0];
+    contactPair.point(1) = contact.pos[1];
+    contactPair.point(2) = contact.pos[2];
+    contactPair.normal(0) = contact.normal[0];
+    contactPair.normal(1) = contact.normal[1];
+    contactPair.normal(2) = contact.normal[2];
+    // The user data of the objects tells their bodies, even if their
+    // collision meshes are shared with other nodes
+    contactPair.bodyNode1 = userData1->bodyNode;
+    contactPair.bodyNode2 = userData2->bodyNode;
+    assert(contactPair.bodyNode1 != NULL);
+    assert(contactPair.bodyNode2 != NULL);
+    contactPair.penetrationDepth = contact.penetration_depth;
+    contactPair.id = 0;
+
+    cd->mContacts.push_back(contactPair);
+  }
+
+  std::vector<bool>markForDeletion(numContacts, false);
+  for (size_t m = 0; m < numContacts; m++) {
+    for (size_t n = m + 1; n < numContacts; n++) {
+      Eigen::Vector3d diff =
+          cd->mContacts[currContactNum + m].point -
+          cd->mContacts[currContactNum + n].point;
+      if (diff.dot(diff) < 1e-6) {
+        markForDeletion[m] = true;
+        break;
+      }
+    }
+  }
+  for (int m = numContacts - 1; m >= 0; m--) {
+    if (markForDeletion[m])
+      cd->mContacts.erase(cd->mContacts.begin() + currContactNum + m);
+  }
+
+  // Keep visiting the overlapping pairs
+  return false;
+}
+
 bool FCLCollisionDetector::detectCollision(CollisionNode* _node1,
                                            CollisionNode* _node2,
                                            bool _calculateContactPoints) {
@@ -177,5 +230,12 @@ CollisionNode* FCLCollisionDetector::findCollisionNode(
   return NULL;
 }
 
+CollisionNode* FCLCollisionDetector::findCollisionNode(
+    const fcl::CollisionObject* _fclCollObj) const {
+  FCLUserData* userData
+      = static_cast<FCLUserData*>(_fclCollObj->getUserData());
+  return userData ? userData->fclCollNode : NULL;
+}
+
 }  // namespace collision
 }  // namespace dart
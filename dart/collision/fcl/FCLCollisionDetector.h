@@ -38,7 +38,11 @@
 #ifndef DART_COLLISION_FCL_FCLCOLLISIONDETECTOR_H_
 #define DART_COLLISION_FCL_FCLCOLLISIONDETECTOR_H_
 
+#include <vector>
+
+#include <fcl/collision_data.h>
 #include <fcl/collision_object.h>
+#include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
 
 #include "dart/collision/CollisionDetector.h"
 
@@ -47,7 +51,11 @@ namespace collision {
 
 class FCLCollisionNode;
 
-/// \brief
+/// \brief class FCLCollisionDetector
+///
+/// Every collision shape is an fcl::CollisionObject in a dynamic AABB tree.
+/// Each step only the objects that moved are refitted in the tree, and only
+/// the shapes whose bounding boxes overlap are passed to fcl::collide().
 class FCLCollisionDetector : public CollisionDetector {
 public:
   /// \brief
@@ -56,9 +64,16 @@ public:
   /// \brief
   virtual ~FCLCollisionDetector();
 
+  // Documentation inherited
+  virtual CollisionDetector* cloneWithoutCollisionObjects() const;
+
   // Documentation inherited
   virtual CollisionNode* createCollisionNode(dynamics::BodyNode* _bodyNode);
 
+  // Documentation inherited
+  virtual void removeCollisionSkeletonNode(dynamics::BodyNode* _bodyNode,
+                                           bool _isRecursive = false);
+
   // Documentation inherited
   virtual bool detectCollision(bool _checkAllCollisions,
                                bool _calculateContactPoints);
@@ -66,9 +81,32 @@ public:
   CollisionNode* findCollisionNode(
       const fcl::CollisionGeometry* _fclCollGeom) const;
 
+  /// \brief Return the collision node that owns _fclCollObj in constant time
+  CollisionNode* findCollisionNode(
+      const fcl::CollisionObject* _fclCollObj) const;
+
 protected:
   virtual bool detectCollision(CollisionNode* _node1, CollisionNode* _node2,
                                bool _calculateContactPoints);
+
+private:
+  /// \brief Narrowphase check of a pair of objects with overlapping bounding
+  /// boxes. _data is the FCLCollisionDetector.
+  static bool collisionCallback(fcl::CollisionObject* _o1,
+                                fcl::CollisionObject* _o2,
+                                void* _data);
+
+  /// \brief Broadphase manager of the collision objects of all the nodes
+  fcl::DynamicAABBTreeCollisionManager* mBroadPhaseManager;
+
+  /// \brief Collision objects that moved since the last detectCollision()
+  std::vector<fcl::CollisionObject*> mMovedObjects;
+
+  /// \brief Request for the narrowphase checks of detectCollision()
+  fcl::CollisionRequest mRequest;
+
+  /// \brief Result of a narrowphase check, reused for every pair
+  fcl::CollisionResult mResult;
 };
 
 }  // namespace collision
@@ -36,6 +36,11 @@
 
 #include "dart/collision/fcl/FCLCollisionNode.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
 #include <assimp/scene.h>
 #include <fcl/shape/geometric_shapes.h>
 #include <fcl/shape/geometric_shape_to_BVH_model.h>
@@ -45,16 +50,86 @@
 #include "dart/dynamics/EllipsoidShape.h"
 #include "dart/dynamics/CylinderShape.h"
 #include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/HeightmapShape.h"
 
 namespace dart {
 namespace collision {
 
+namespace {
+
+/// Collision mesh created for a MeshShape along with the mesh data it was
+/// created from
+struct SharedMeshEntry
+{
+  std::weak_ptr<const aiScene> mScene;
+  std::weak_ptr<fcl::BVHModel<fcl::OBBRSS> > mMesh;
+};
+
+} // anonymous namespace
+
+//==============================================================================
+/// Return the collision mesh of _shape. MeshShapes that share their mesh data
+/// (e.g., meshes loaded through dynamics::MeshCache) also share their
+/// collision meshes as long as the scale matches.
+static std::shared_ptr<fcl::BVHModel<fcl::OBBRSS> > getSharedMesh(
+    const dynamics::MeshShape* _shape)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<const aiScene*, std::vector<double> >,
+                  SharedMeshEntry> sharedMeshes;
+
+  const std::shared_ptr<const aiScene>& scene = _shape->getSharedMesh();
+  const Eigen::Vector3d& scale = _shape->getScale();
+  std::vector<double> parameters(scale.data(), scale.data() + 3);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::shared_ptr<fcl::BVHModel<fcl::OBBRSS> > mesh;
+  auto it = sharedMeshes.find(std::make_pair(scene.get(), parameters));
+  if (it != sharedMeshes.end())
+  {
+    mesh = it->second.mMesh.lock();
+
+    // The address of released mesh data may have been reused
+    if (mesh && it->second.mScene.lock() == scene)
+      return mesh;
+  }
+
+  // Drop the entries of collision meshes that are no longer in use
+  for (it = sharedMeshes.begin(); it != sharedMeshes.end();)
+  {
+    if (it->second.mMesh.expired())
+      it = sharedMeshes.erase(it);
+    else
+      ++it;
+  }
+
+  mesh.reset(createMesh<fcl::OBBRSS>(scale[0], scale[1], scale[2],
+                                     scene.get()));
+
+  SharedMeshEntry& entry
+      = sharedMeshes[std::make_pair(scene.get(), parameters)];
+  entry.mScene = scene;
+  entry.mMesh = mesh;
+
+  return mesh;
+}
+
+//==============================================================================
+static fcl::Transform3f convertTransform(const Eigen::Isometry3d& _T)
+{
+  return fcl::Transform3f(
+        fcl::Matrix3f(_T(0, 0), _T(0, 1), _T(0, 2),
+                      _T(1, 0), _T(1, 1), _T(1, 2),
+                      _T(2, 0), _T(2, 1), _T(2, 2)),
+        fcl::Vec3f(_T(0, 3), _T(1, 3), _T(2, 3)));
+}
+
 //==============================================================================
 FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
   : CollisionNode(_bodyNode) {
   for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); i++) {
     dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
-    mShapes.push_back(shape);
     switch (shape->getShapeType()) {
       case dynamics::Shape::BOX: {
         dynamics::BoxShape* box
@@ -89,12 +164,24 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
         dynamics::MeshShape* shapeMesh
             = dynamic_cast<dynamics::MeshShape *>(shape);
 
-        if (shapeMesh)
-          mCollisionGeometries.push_back(
-                createMesh<fcl::OBBRSS>(shapeMesh->getScale()[0],
-                                        shapeMesh->getScale()[1],
-                                        shapeMesh->getScale()[2],
-                                        shapeMesh->getMesh()));
+        if (shapeMesh) {
+          mGeometryOwners.push_back(getSharedMesh(shapeMesh));
+          mCollisionGeometries.push_back(mGeometryOwners.back().get());
+        }
+        break;
+      }
+      case dynamics::Shape::HEIGHTMAP: {
+        // The broadphase only needs the bounds of the terrain, and
+        // FCLCollisionDetector collides the terrain through its grid
+        dynamics::HeightmapShape* heightmap
+            = static_cast<dynamics::HeightmapShape*>(shape);
+        const double height = 2.0 * std::max(
+              std::abs(heightmap->getMinHeight()),
+              std::abs(heightmap->getMaxHeight()));
+        mCollisionGeometries.push_back(
+              new fcl::Box(heightmap->getBoundingBoxDim()[0],
+                           heightmap->getBoundingBoxDim()[1],
+                           std::max(height, 1e-3)));
         break;
       }
       default: {
@@ -104,11 +191,45 @@ FCLCollisionNode::FCLCollisionNode(dynamics::BodyNode* _bodyNode)
         break;
       }
     }
+
+    // Geometries that are not shared are owned by this node alone
+    if (mGeometryOwners.size() < mCollisionGeometries.size())
+      mGeometryOwners.emplace_back(mCollisionGeometries.back());
+
+    // Keep mShapes parallel to mCollisionGeometries
+    if (mShapes.size() < mCollisionGeometries.size())
+      mShapes.push_back(shape);
+  }
+
+  // Create the collision objects for broadphase collision managers. Each one
+  // shares the ownership of its geometry.
+  for (size_t i = 0; i < mCollisionGeometries.size(); ++i) {
+    std::shared_ptr<fcl::CollisionGeometry> owner = mGeometryOwners[i];
+    boost::shared_ptr<fcl::CollisionGeometry> geometry(
+          owner.get(), [owner](fcl::CollisionGeometry*) {});
+
+    fcl::CollisionObject* collObj
+        = new fcl::CollisionObject(geometry, getFCLTransform(i));
+    collObj->computeAABB();
+
+    FCLUserData* userData = new FCLUserData;
+    userData->bodyNode = _bodyNode;
+    userData->shape = mShapes[i];
+    userData->fclCollNode = this;
+    collObj->setUserData(userData);
+
+    mCollisionObjects.push_back(collObj);
+    mTransforms.push_back(_bodyNode->getTransform()
+                          * mShapes[i]->getLocalTransform());
   }
 }
 
 //==============================================================================
 FCLCollisionNode::~FCLCollisionNode() {
+  for (size_t i = 0; i < mCollisionObjects.size(); ++i) {
+    delete static_cast<FCLUserData*>(mCollisionObjects[i]->getUserData());
+    delete mCollisionObjects[i];
+  }
 }
 
 //==============================================================================
@@ -123,14 +244,31 @@ fcl::CollisionGeometry*FCLCollisionNode::getCollisionGeometry(int _idx) const {
 
 //==============================================================================
 fcl::Transform3f FCLCollisionNode::getFCLTransform(int _idx) const {
-  Eigen::Isometry3d worldTrans = mBodyNode->getTransform()
-                                 * mShapes[_idx]->getLocalTransform();
+  return convertTransform(mBodyNode->getTransform()
+                          * mShapes[_idx]->getLocalTransform());
+}
 
-  return fcl::Transform3f(
-        fcl::Matrix3f(worldTrans(0, 0), worldTrans(0, 1), worldTrans(0, 2),
-                      worldTrans(1, 0), worldTrans(1, 1), worldTrans(1, 2),
-                      worldTrans(2, 0), worldTrans(2, 1), worldTrans(2, 2)),
-        fcl::Vec3f(worldTrans(0, 3), worldTrans(1, 3), worldTrans(2, 3)));
+//==============================================================================
+fcl::CollisionObject* FCLCollisionNode::getCollisionObject(int _idx) const {
+  return mCollisionObjects[_idx];
+}
+
+//==============================================================================
+void FCLCollisionNode::updateCollisionObjects(
+    std::vector<fcl::CollisionObject*>* _movedObjects) {
+  for (size_t i = 0; i < mCollisionObjects.size(); ++i) {
+    Eigen::Isometry3d worldTrans = mBodyNode->getTransform()
+                                   * mShapes[i]->getLocalTransform();
+
+    // Resting bodies keep their bounding boxes and their place in the tree
+    if (worldTrans.matrix() == mTransforms[i].matrix())
+      continue;
+
+    mTransforms[i] = worldTrans;
+    mCollisionObjects[i]->setTransform(convertTransform(worldTrans));
+    mCollisionObjects[i]->computeAABB();
+    _movedObjects->push_back(mCollisionObjects[i]);
+  }
 }
 
 //==============================================================================
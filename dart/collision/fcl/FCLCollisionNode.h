@@ -37,11 +37,13 @@
 #ifndef DART_COLLISION_FCL_FCLCOLLISIONNODE_H_
 #define DART_COLLISION_FCL_FCLCOLLISIONNODE_H_
 
+#include <memory>
 #include <vector>
 
 #include <assimp/scene.h>
 #include <Eigen/Dense>
 #include <fcl/collision.h>
+#include <fcl/collision_object.h>
 #include <fcl/BVH/BVH_model.h>
 
 #include "dart/collision/CollisionNode.h"
@@ -56,6 +58,15 @@ class Shape;
 namespace dart {
 namespace collision {
 
+class FCLCollisionNode;
+
+/// \brief Data attached to the fcl::CollisionObject of each collision shape
+struct FCLUserData {
+  dynamics::BodyNode* bodyNode;
+  dynamics::Shape* shape;
+  FCLCollisionNode* fclCollNode;
+};
+
 /// \brief
 class FCLCollisionNode : public CollisionNode {
 public:
@@ -74,12 +85,34 @@ public:
   /// \brief
   fcl::Transform3f getFCLTransform(int _idx) const;
 
+  /// \brief Get the collision object of the _idx-th collision geometry. Its
+  /// user data is an FCLUserData.
+  fcl::CollisionObject* getCollisionObject(int _idx) const;
+
+  /// \brief Update the transforms and the bounding boxes of the collision
+  /// objects that moved since the last update, and append them to
+  /// _movedObjects
+  void updateCollisionObjects(
+      std::vector<fcl::CollisionObject*>* _movedObjects);
+
 private:
   /// \brief
   std::vector<fcl::CollisionGeometry*> mCollisionGeometries;
 
+  /// \brief Ownership of mCollisionGeometries. The collision meshes of
+  /// MeshShapes are shared with other FCLCollisionNodes whose shapes hold the
+  /// same mesh data.
+  std::vector<std::shared_ptr<fcl::CollisionGeometry> > mGeometryOwners;
+
   /// \brief
   std::vector<dynamics::Shape*> mShapes;
+
+  /// \brief Collision object of each collision geometry
+  std::vector<fcl::CollisionObject*> mCollisionObjects;
+
+  /// \brief World transforms of mCollisionObjects at the last update
+  std::vector<Eigen::Isometry3d,
+              Eigen::aligned_allocator<Eigen::Isometry3d> > mTransforms;
 };
 
 /// \brief
@@ -45,6 +45,7 @@
 #include "dart/renderer/LoadOpengl.h"
 #include "dart/math/Helpers.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/SoftBodyNode.h"
 #include "dart/dynamics/PointMass.h"
 #include "dart/collision/CollisionNode.h"
@@ -56,6 +57,7 @@ namespace collision {
 
 //==============================================================================
 FCLMeshCollisionDetector::FCLMeshCollisionDetector()
+  : mConvexMeshCollision(false)
 {
 }
 
@@ -64,10 +66,31 @@ FCLMeshCollisionDetector::~FCLMeshCollisionDetector()
 {
 }
 
+//==============================================================================
+CollisionDetector*
+FCLMeshCollisionDetector::cloneWithoutCollisionObjects() const
+{
+  FCLMeshCollisionDetector* collisionDetector = new FCLMeshCollisionDetector();
+  collisionDetector->setNumMaxContacs(mNumMaxContacts);
+  collisionDetector->setConvexMeshCollision(mConvexMeshCollision);
+  return collisionDetector;
+}
+
 //==============================================================================
 CollisionNode*FCLMeshCollisionDetector::createCollisionNode(
     dynamics::BodyNode* _bodyNode)
 {
+  // Decompose meshes into convex pieces now rather than at the first contact
+  if (mConvexMeshCollision)
+  {
+    for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); ++i)
+    {
+      dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
+      if (shape->getShapeType() == dynamics::Shape::MESH)
+        static_cast<dynamics::MeshShape*>(shape)->getConvexDecomposition();
+    }
+  }
+
   return new FCLMeshCollisionNode(_bodyNode);
 }
 
@@ -97,6 +120,10 @@ bool FCLMeshCollisionDetector::detectCollision(bool _checkAllCollisions,
 
   for (size_t i = 0; i < mCollisionNodes.size(); i++)
   {
+    // Skip nodes that can not collide with anything before pairing them
+    if (!isCollidable(mCollisionNodes[i]))
+      continue;
+
     FCLMeshCollisionNode1
         = static_cast<FCLMeshCollisionNode*>(mCollisionNodes[i]);
     for (size_t j = i + 1; j < mCollisionNodes.size(); j++)
@@ -110,7 +137,8 @@ bool FCLMeshCollisionDetector::detectCollision(bool _checkAllCollisions,
           = _calculateContactPoints ? &mContacts : NULL;
       if (FCLMeshCollisionNode1->detectCollision(FCLMeshCollisionNode2,
                                                  contactPoints,
-                                                 mNumMaxContacts))
+                                                 mNumMaxContacts,
+                                                 mConvexMeshCollision))
       {
         collision = true;
         mCollisionNodes[i]->getBodyNode()->setColliding(true);
@@ -137,7 +165,19 @@ bool FCLMeshCollisionDetector::detectCollision(CollisionNode* _node1,
   return collisionNode1->detectCollision(
         collisionNode2,
         _calculateContactPoints ? &mContacts : NULL,
-        mNumMaxContacts);
+        mNumMaxContacts, mConvexMeshCollision);
+}
+
+//==============================================================================
+void FCLMeshCollisionDetector::setConvexMeshCollision(bool _convex)
+{
+  mConvexMeshCollision = _convex;
+}
+
+//==============================================================================
+bool FCLMeshCollisionDetector::isConvexMeshCollision() const
+{
+  return mConvexMeshCollision;
 }
 
 //==============================================================================
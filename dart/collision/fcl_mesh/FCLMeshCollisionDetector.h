@@ -59,6 +59,9 @@ public:
   /// Destructor
   virtual ~FCLMeshCollisionDetector();
 
+  // Documentation inherited
+  virtual CollisionDetector* cloneWithoutCollisionObjects() const;
+
   // Documentation inherited
   virtual CollisionNode* createCollisionNode(dynamics::BodyNode* _bodyNode);
 
@@ -70,8 +73,21 @@ public:
   virtual bool detectCollision(CollisionNode* _node1, CollisionNode* _node2,
                                bool _calculateContactPoints);
 
+  /// Set whether MeshShapes collide through the convex pieces of their
+  /// decomposition (see MeshShape::getConvexDecomposition()) instead of
+  /// triangle by triangle. This gives fewer and steadier contacts for meshes
+  /// that are close to convex. Off by default.
+  void setConvexMeshCollision(bool _convex);
+
+  /// Return true if MeshShapes collide through their convex pieces
+  bool isConvexMeshCollision() const;
+
   ///
   void draw();
+
+protected:
+  /// Whether MeshShapes collide through their convex pieces
+  bool mConvexMeshCollision;
 };
 
 }  // namespace collision
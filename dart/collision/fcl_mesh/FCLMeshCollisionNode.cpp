@@ -38,6 +38,8 @@
 #include "dart/collision/fcl_mesh/FCLMeshCollisionNode.h"
 
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <vector>
 
 #include <fcl/shape/geometric_shapes.h>
@@ -54,10 +56,94 @@
 #include "dart/renderer/LoadOpengl.h"
 #include "dart/collision/fcl_mesh/CollisionShapes.h"
 #include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
+#include "dart/collision/dart/DARTCollide.h"
 
 namespace dart {
 namespace collision {
 
+namespace {
+
+/// Collision mesh created for a MeshShape along with the mesh data it was
+/// created from
+struct SharedMeshEntry
+{
+  std::weak_ptr<const aiScene> mScene;
+  std::weak_ptr<fcl::BVHModel<fcl::OBBRSS> > mMesh;
+};
+
+} // anonymous namespace
+
+//==============================================================================
+/// Return the collision mesh of _shape placed at _transform. MeshShapes that
+/// share their mesh data (e.g., the shapes of cloned Skeletons) also share
+/// their collision meshes as long as the scale and the transform match.
+static std::shared_ptr<fcl::BVHModel<fcl::OBBRSS> > getSharedMesh(
+    const dynamics::MeshShape* _shape, const fcl::Transform3f& _transform)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<const aiScene*, std::vector<double> >,
+                  SharedMeshEntry> sharedMeshes;
+
+  const std::shared_ptr<const aiScene>& scene = _shape->getSharedMesh();
+  const Eigen::Vector3d& scale = _shape->getScale();
+  const Eigen::Isometry3d& tf = _shape->getLocalTransform();
+
+  std::vector<double> parameters(scale.data(), scale.data() + 3);
+  parameters.insert(parameters.end(), tf.data(), tf.data() + 16);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::shared_ptr<fcl::BVHModel<fcl::OBBRSS> > mesh;
+  auto it = sharedMeshes.find(std::make_pair(scene.get(), parameters));
+  if (it != sharedMeshes.end())
+  {
+    mesh = it->second.mMesh.lock();
+
+    // The address of released mesh data may have been reused
+    if (mesh && it->second.mScene.lock() == scene)
+      return mesh;
+  }
+
+  // Drop the entries of collision meshes that are no longer in use
+  for (it = sharedMeshes.begin(); it != sharedMeshes.end();)
+  {
+    if (it->second.mMesh.expired())
+      it = sharedMeshes.erase(it);
+    else
+      ++it;
+  }
+
+  mesh.reset(createMesh<fcl::OBBRSS>(scale[0], scale[1], scale[2],
+                                     scene.get(), _transform));
+
+  SharedMeshEntry& entry
+      = sharedMeshes[std::make_pair(scene.get(), parameters)];
+  entry.mScene = scene;
+  entry.mMesh = mesh;
+
+  return mesh;
+}
+
+//==============================================================================
+/// Return true if the pair of shapes can collide through convex pieces, i.e.,
+/// if one of them is of type _type and the other is a convex primitive or a
+/// MeshShape
+static bool isConvexPair(const dynamics::Shape* _shape1,
+                         const dynamics::Shape* _shape2,
+                         dynamics::Shape::ShapeType _type)
+{
+  using dart::dynamics::Shape;
+
+  const Shape::ShapeType type1 = _shape1->getShapeType();
+  const Shape::ShapeType type2 = _shape2->getShapeType();
+  if (type1 != _type && type2 != _type)
+    return false;
+
+  const Shape::ShapeType other = (type1 == _type) ? type2 : type1;
+  return other == Shape::MESH || other == Shape::BOX
+      || other == Shape::ELLIPSOID || other == Shape::CYLINDER;
+}
+
 //==============================================================================
 FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
   : CollisionNode(_bodyNode)
@@ -116,11 +202,8 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
       case dynamics::Shape::MESH:
       {
         MeshShape* shapeMesh = static_cast<MeshShape*>(shape);
-        mMeshes.push_back(createMesh<fcl::OBBRSS>(shapeMesh->getScale()[0],
-                                                  shapeMesh->getScale()[1],
-                                                  shapeMesh->getScale()[2],
-                                                  shapeMesh->getMesh(),
-                                                  shapeT));
+        mMeshOwners.push_back(getSharedMesh(shapeMesh, shapeT));
+        mMeshes.push_back(mMeshOwners.back().get());
         break;
       }
       case dynamics::Shape::SOFT_MESH:
@@ -130,6 +213,13 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
                             softMeshShape->getAssimpMesh(), shapeT));
         break;
       }
+      case dynamics::Shape::HEIGHTMAP:
+      {
+        // Heightmaps collide through their grids rather than a collision
+        // mesh, which would be huge for a large terrain
+        mMeshes.push_back(NULL);
+        break;
+      }
       default:
       {
         std::cout << "ERROR: Collision checking does not support "
@@ -137,20 +227,23 @@ FCLMeshCollisionNode::FCLMeshCollisionNode(dynamics::BodyNode* _bodyNode)
         break;
       }
     }
+
+    // Collision meshes that are not shared are owned by this node alone
+    if (mMeshOwners.size() < mMeshes.size())
+      mMeshOwners.emplace_back(mMeshes.back());
   }
 }
 
 //==============================================================================
 FCLMeshCollisionNode::~FCLMeshCollisionNode()
 {
-  for (size_t i = 0; i < mMeshes.size(); i++)
-    delete mMeshes[i];
 }
 
 //==============================================================================
 bool FCLMeshCollisionNode::detectCollision(FCLMeshCollisionNode* _otherNode,
                                            std::vector<Contact>* _contactPoints,
-                                           int _num_max_contact)
+                                           int _num_max_contact,
+                                           bool _convexMeshes)
 {
   evalRT();
   _otherNode->evalRT();
@@ -160,6 +253,41 @@ bool FCLMeshCollisionNode::detectCollision(FCLMeshCollisionNode* _otherNode,
   {
     for (size_t j = 0; j < _otherNode->mMeshes.size(); j++)
     {
+      const dynamics::Shape* shape1 = getBodyNode()->getCollisionShape(i);
+      const dynamics::Shape* shape2
+          = _otherNode->getBodyNode()->getCollisionShape(j);
+      if (isConvexPair(shape1, shape2, dynamics::Shape::HEIGHTMAP)
+          || (_convexMeshes
+              && isConvexPair(shape1, shape2, dynamics::Shape::MESH)))
+      {
+        std::vector<Contact> convexContacts;
+        collide(shape1, mWorldTrans * shape1->getLocalTransform(),
+                shape2, _otherNode->mWorldTrans * shape2->getLocalTransform(),
+                &convexContacts);
+        if (convexContacts.empty())
+          continue;
+
+        collision = true;
+        if (!_contactPoints)
+          return true;
+
+        for (size_t k = 0; k < convexContacts.size(); k++)
+        {
+          Contact& contact = convexContacts[k];
+          contact.bodyNode1 = this->getBodyNode();
+          contact.bodyNode2 = _otherNode->getBodyNode();
+          contact.shape1 = contact.bodyNode1->getCollisionShape(i);
+          contact.shape2 = contact.bodyNode2->getCollisionShape(j);
+          contact.id = 0;
+          _contactPoints->push_back(contact);
+        }
+        continue;
+      }
+
+      // Heightmaps only collide with the shapes above
+      if (!mMeshes[i] || !_otherNode->mMeshes[j])
+        continue;
+
       fcl::CollisionResult res;
       fcl::CollisionRequest req;
 
@@ -208,6 +336,7 @@ bool FCLMeshCollisionNode::detectCollision(FCLMeshCollisionNode* _otherNode,
         pair1.penetrationDepth = res.getContact(k).penetration_depth;
         pair1.shape1 = pair1.bodyNode1->getCollisionShape(i);
         pair1.shape2 = pair1.bodyNode2->getCollisionShape(j);
+        pair1.id = 0;
         pair2 = pair1;
         int contactResult =
             evalContactPosition(res.getContact(k), mMeshes[i],
@@ -434,6 +563,9 @@ void FCLMeshCollisionNode::drawCollisionSkeletonNode(bool _bTrans)
   glBegin(GL_TRIANGLES);
   for (size_t i = 0; i < mMeshes.size(); i++)
   {
+    if (!mMeshes[i])
+      continue;
+
     for (int j = 0; j < mMeshes[i]->num_tris; j++)
     {
       fcl::Triangle tri = mMeshes[i]->tri_indices[j];
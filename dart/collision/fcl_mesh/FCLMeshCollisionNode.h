@@ -38,6 +38,7 @@
 #ifndef DART_COLLISION_FCLMESH_FCLMESHCOLLISIONNODE_H_
 #define DART_COLLISION_FCLMESH_FCLMESHCOLLISIONNODE_H_
 
+#include <memory>
 #include <vector>
 
 #include <assimp/mesh.h>
@@ -80,10 +81,14 @@ public:
   ///
   Eigen::Isometry3d mWorldTrans;
 
-  ///
+  /// Detect collisions with _otherNode. If _convexMeshes is true, pairs
+  /// that involve a MeshShape collide through the convex pieces of the
+  /// meshes instead of their triangles. Pairs that involve a HeightmapShape
+  /// always collide through the cells of its grid.
   virtual bool detectCollision(FCLMeshCollisionNode* _otherNode,
                                std::vector<Contact>* _contactPoints,
-                               int _max_num_contact);
+                               int _max_num_contact,
+                               bool _convexMeshes = false);
   ///
   void updateShape();
 
@@ -106,6 +111,10 @@ public:
   void drawCollisionSkeletonNode(bool _bTrans = true);
 
 private:
+  /// Ownership of mMeshes. The collision meshes of MeshShapes are shared with
+  /// other FCLMeshCollisionNodes whose shapes hold the same mesh data.
+  std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBRSS> > > mMeshOwners;
+
   ///
   static int FFtest(
       const fcl::Vec3f& r1, const fcl::Vec3f& r2, const fcl::Vec3f& r3,
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/common/NameHandle.h"
+
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace dart {
+namespace common {
+
+//==============================================================================
+/// Process-wide table of interned names, with the number of handles to each.
+/// Elements of an unordered_map keep their addresses when the map grows, so
+/// handles can point into it.
+static std::unordered_map<std::string, std::atomic<size_t> >& getInternedNames()
+{
+  static std::unordered_map<std::string, std::atomic<size_t> > names;
+  return names;
+}
+
+//==============================================================================
+static std::mutex& getInternedNamesMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+//==============================================================================
+NameHandle::NameHandle()
+  : mEntry(NULL)
+{
+}
+
+//==============================================================================
+NameHandle::NameHandle(const std::string& _name)
+  : mEntry(NULL)
+{
+  if (_name.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(getInternedNamesMutex());
+  mEntry = &*getInternedNames().emplace(std::piecewise_construct,
+                                        std::forward_as_tuple(_name),
+                                        std::forward_as_tuple(0)).first;
+  ++mEntry->second;
+}
+
+//==============================================================================
+NameHandle::NameHandle(const NameHandle& _other)
+  : mEntry(_other.mEntry)
+{
+  acquire();
+}
+
+//==============================================================================
+NameHandle::~NameHandle()
+{
+  release();
+}
+
+//==============================================================================
+NameHandle& NameHandle::operator=(const NameHandle& _other)
+{
+  if (mEntry != _other.mEntry)
+  {
+    release();
+    mEntry = _other.mEntry;
+    acquire();
+  }
+
+  return *this;
+}
+
+//==============================================================================
+NameHandle NameHandle::find(const std::string& _name)
+{
+  NameHandle handle;
+
+  if (_name.empty())
+    return handle;
+
+  std::lock_guard<std::mutex> lock(getInternedNamesMutex());
+  std::unordered_map<std::string, std::atomic<size_t> >& names
+      = getInternedNames();
+  std::unordered_map<std::string, std::atomic<size_t> >::iterator it
+      = names.find(_name);
+
+  if (it != names.end())
+  {
+    handle.mEntry = &*it;
+    ++handle.mEntry->second;
+  }
+
+  return handle;
+}
+
+//==============================================================================
+void NameHandle::acquire()
+{
+  // The source handle holds a reference, so the entry cannot be erased
+  // meanwhile and no lock is needed
+  if (mEntry)
+    ++mEntry->second;
+}
+
+//==============================================================================
+void NameHandle::release()
+{
+  if (NULL == mEntry)
+    return;
+
+  // Dropping any reference but the last one does not touch the table
+  size_t count = mEntry->second.load();
+  while (count > 1)
+  {
+    if (mEntry->second.compare_exchange_weak(count, count - 1))
+    {
+      mEntry = NULL;
+      return;
+    }
+  }
+
+  // Other handles can only be created from this one, or from the name while
+  // holding the lock, so the count can not drop to zero behind our back
+  std::lock_guard<std::mutex> lock(getInternedNamesMutex());
+  if (1 == mEntry->second--)
+  {
+    std::unordered_map<std::string, std::atomic<size_t> >& names
+        = getInternedNames();
+    names.erase(names.find(mEntry->first));
+  }
+
+  mEntry = NULL;
+}
+
+//==============================================================================
+const std::string& NameHandle::str() const
+{
+  static const std::string emptyName;
+
+  return mEntry ? mEntry->first : emptyName;
+}
+
+//==============================================================================
+bool NameHandle::empty() const
+{
+  return mEntry == NULL;
+}
+
+//==============================================================================
+size_t NameHandle::hash() const
+{
+  return std::hash<const Entry*>()(mEntry);
+}
+
+//==============================================================================
+bool NameHandle::operator==(const NameHandle& _other) const
+{
+  return mEntry == _other.mEntry;
+}
+
+//==============================================================================
+bool NameHandle::operator!=(const NameHandle& _other) const
+{
+  return mEntry != _other.mEntry;
+}
+
+//==============================================================================
+bool NameHandle::operator<(const NameHandle& _other) const
+{
+  return std::less<const Entry*>()(mEntry, _other.mEntry);
+}
+
+}  // namespace common
+}  // namespace dart
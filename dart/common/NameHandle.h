@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COMMON_NAMEHANDLE_H_
+#define DART_COMMON_NAMEHANDLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace dart {
+namespace common {
+
+/// \brief class NameHandle
+///
+/// A NameHandle refers to one copy of a string that is shared by the whole
+/// process. Creating a handle hashes the string once; after that, comparing
+/// and hashing handles only compares pointers. Use it for names that are
+/// looked up repeatedly:
+/// \code{.cpp}
+/// common::NameHandle hand("hand");
+///
+/// // No string is hashed or compared here
+/// BodyNode* bodyNode = skeleton->getBodyNode(hand);
+/// \endcode
+///
+/// An interned string is released when the last handle to it is destroyed.
+class NameHandle
+{
+public:
+  /// Create a handle to the empty name
+  NameHandle();
+
+  /// Intern _name, if it is not interned yet, and create a handle to it
+  explicit NameHandle(const std::string& _name);
+
+  /// Copy constructor. Does not lock the table of interned names.
+  NameHandle(const NameHandle& _other);
+
+  /// Destructor. Releases the interned name if this is its last handle.
+  ~NameHandle();
+
+  /// Assignment operator
+  NameHandle& operator=(const NameHandle& _other);
+
+  /// Create a handle to _name only if it is already interned. Otherwise, a
+  /// handle to the empty name is returned and nothing is interned.
+  static NameHandle find(const std::string& _name);
+
+  /// Get the name
+  const std::string& str() const;
+
+  /// Return true if this is a handle to the empty name
+  bool empty() const;
+
+  /// Get a hash value of the name. Equal names have equal hash values.
+  size_t hash() const;
+
+  /// Return true if both handles refer to the same name
+  bool operator==(const NameHandle& _other) const;
+
+  /// Return true if the handles refer to different names
+  bool operator!=(const NameHandle& _other) const;
+
+  /// Order handles by the address of their interned strings. This ordering is
+  /// not alphabetical and can change between runs.
+  bool operator<(const NameHandle& _other) const;
+
+private:
+  /// An interned string and the number of handles to it
+  typedef std::pair<const std::string, std::atomic<size_t> > Entry;
+
+  /// Add a reference to mEntry, if it is not NULL
+  void acquire();
+
+  /// Drop the reference to mEntry, if it is not NULL, and erase the entry
+  /// from the table if that was the last reference
+  void release();
+
+  /// Interned string, or NULL for the empty name
+  Entry* mEntry;
+};
+
+}  // namespace common
+}  // namespace dart
+
+namespace std {
+
+/// Hash function for using NameHandle as the key of unordered containers
+template <>
+struct hash<dart::common::NameHandle>
+{
+  size_t operator()(const dart::common::NameHandle& _name) const
+  {
+    return _name.hash();
+  }
+};
+
+}  // namespace std
+
+#endif  // DART_COMMON_NAMEHANDLE_H_
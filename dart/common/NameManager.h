@@ -38,9 +38,10 @@
 #ifndef DART_COMMON_NAMEMANAGER_H_
 #define DART_COMMON_NAMEMANAGER_H_
 
-#include <map>
-#include <sstream>
+#include <string>
+#include <unordered_map>
 #include "dart/common/Console.h"
+#include "dart/common/NameHandle.h"
 
 namespace dart {
 namespace common {
@@ -63,6 +64,13 @@ namespace common {
 ///
 /// bodyNode->setName(name);
 /// \endcode
+///
+/// Objects can also be found through a NameHandle, which does not hash or
+/// compare any string:
+/// \code{.cpp}
+/// NameHandle link("Link");
+/// BodyNode* found = nameMgr.getObject(link);
+/// \endcode
 template <typename T>
 class NameManager
 {
@@ -120,12 +128,13 @@ public:
     std::string newName;
     do
     {
-      std::stringstream ss;
+      const std::string number = std::to_string(count++);
+      newName = mPrefix;
       if(mNameBeforeNumber)
-          ss << mPrefix << _name << mInfix << count++ << mAffix;
+        newName.append(_name).append(mInfix).append(number);
       else
-          ss << mPrefix << count++ << mInfix << _name << mAffix;
-      newName = ss.str();
+        newName.append(number).append(mInfix).append(_name);
+      newName.append(mAffix);
     } while (hasName(newName));
 
     dtwarn << "The name '" << _name << "' is a duplicate, "
@@ -159,7 +168,9 @@ public:
       return false;
     }
 
-    mMap.insert(std::pair<std::string, T*>(_name, _obj));
+    const NameHandle handle(_name);
+    mMap.insert(std::make_pair(_name, std::make_pair(_obj, handle)));
+    mHandleMap.insert(std::make_pair(handle, _obj));
 
     return true;
   }
@@ -167,11 +178,14 @@ public:
   /// Remove an object from the map based on its name
   bool removeName(const std::string& _name)
   {
-    typename std::map<std::string, T*>::iterator it = mMap.find(_name);
+    typename std::unordered_map<std::string, Entry>::iterator it =
+        mMap.find(_name);
 
     if (it == mMap.end())
       return false;
 
+    // Erase through the stored handle so the name is not interned again
+    mHandleMap.erase(it->second.second);
     mMap.erase(it);
 
     return true;
@@ -181,6 +195,7 @@ public:
   void clear()
   {
     mMap.clear();
+    mHandleMap.clear();
   }
 
   /// Return true if the name is contained
@@ -189,6 +204,12 @@ public:
     return (mMap.find(_name) != mMap.end());
   }
 
+  /// Return true if the name is contained
+  bool hasName(const NameHandle& _name) const
+  {
+    return (mHandleMap.find(_name) != mHandleMap.end());
+  }
+
   /// Get the number of the objects currently stored by the NameManager
   size_t getCount() const
   {
@@ -202,10 +223,26 @@ public:
   ///   The object if it exists, or NULL if it does not exist
   T* getObject(const std::string& _name) const
   {
-    typename std::map<std::string, T*>::const_iterator result =
+    typename std::unordered_map<std::string, Entry>::const_iterator result =
         mMap.find(_name);
 
     if (result != mMap.end())
+      return result->second.first;
+    else
+      return NULL;
+  }
+
+  /// Get object by given name handle without any string work
+  /// \param[in] _name
+  ///   Handle to the name of the requested object
+  /// \return
+  ///   The object if it exists, or NULL if it does not exist
+  T* getObject(const NameHandle& _name) const
+  {
+    typename std::unordered_map<NameHandle, T*>::const_iterator result =
+        mHandleMap.find(_name);
+
+    if (result != mHandleMap.end())
       return result->second;
     else
       return NULL;
@@ -226,8 +263,14 @@ public:
   }
 
 protected:
+  /// An object and the handle to its name
+  typedef std::pair<T*, NameHandle> Entry;
+
   /// Map of objects that have been added to the NameManager
-  std::map<std::string, T*> mMap;
+  std::unordered_map<std::string, Entry> mMap;
+
+  /// The same objects as mMap, keyed by the interned handles of their names
+  std::unordered_map<NameHandle, T*> mHandleMap;
 
   /// String which will be used as a name for any object which is passed in with
   /// an empty string name
@@ -376,6 +376,10 @@ public:
   template <typename... ArgTypes>
   void raise(ArgTypes&&... _args)
   {
+    // Signals are raised on every state change, but most of them have no slot
+    if (mConnectionBodies.empty())
+      return;
+
     for (auto itr = mConnectionBodies.begin(); itr != mConnectionBodies.end(); )
     {
       if ((*itr)->isConnected())
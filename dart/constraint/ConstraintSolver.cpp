@@ -66,6 +66,8 @@ ConstraintSolver::ConstraintSolver(double _timeStep)
     mLCPSolver(new DantzigLCPSolver(mTimeStep))
 {
   assert(_timeStep > 0.0);
+
+  mCollisionDetector->setTimeStep(mTimeStep);
 }
 
 //==============================================================================
@@ -80,17 +82,11 @@ void ConstraintSolver::addSkeleton(Skeleton* _skeleton)
   assert(_skeleton != NULL
       && "Null pointer skeleton is now allowed to add to ConstraintSover.");
 
-  if (containSkeleton(_skeleton) == false)
+  if (checkAndAddSkeleton(_skeleton))
   {
-    mSkeletons.push_back(_skeleton);
     mCollisionDetector->addSkeleton(_skeleton);
     mConstrainedGroups.reserve(mSkeletons.size());
   }
-  else
-  {
-    dtwarn << "Skeleton [" << _skeleton->getName()
-           << "] is already in ConstraintSolver." << std::endl;
-  }
 }
 
 //==============================================================================
@@ -104,18 +100,12 @@ void ConstraintSolver::addSkeletons(const std::vector<Skeleton*>& _skeletons)
     assert(*it != NULL
         && "Null pointer skeleton is now allowed to add to ConstraintSover.");
 
-    if (containSkeleton(*it) == false)
+    if (checkAndAddSkeleton(*it))
     {
-      mSkeletons.push_back(*it);
       mCollisionDetector->addSkeleton(*it);
 
       ++numAddedSkeletons;
     }
-    else
-    {
-      dtwarn << "Skeleton [" << (*it)->getName()
-             << "] is already in ConstraintSolver." << std::endl;
-    }
   }
 
   mConstrainedGroups.reserve(mSkeletons.size());
@@ -129,8 +119,7 @@ void ConstraintSolver::removeSkeleton(Skeleton* _skeleton)
 
   if (containSkeleton(_skeleton))
   {
-    mSkeletons.erase(remove(mSkeletons.begin(), mSkeletons.end(), _skeleton),
-                     mSkeletons.end());
+    eraseSkeleton(_skeleton);
     mCollisionDetector->removeSkeleton(_skeleton);
     mConstrainedGroups.reserve(mSkeletons.size());
   }
@@ -155,8 +144,7 @@ void ConstraintSolver::removeSkeletons(
 
     if (containSkeleton(*it))
     {
-      mSkeletons.erase(remove(mSkeletons.begin(), mSkeletons.end(), *it),
-                       mSkeletons.end());
+      eraseSkeleton(*it);
       mCollisionDetector->removeSkeleton(*it);
 
       ++numRemovedSkeletons;
@@ -176,6 +164,7 @@ void ConstraintSolver::removeAllSkeletons()
 {
   mCollisionDetector->removeAllSkeletons();
   mSkeletons.clear();
+  mSkeletonIndices.clear();
 }
 
 //==============================================================================
@@ -224,6 +213,8 @@ void ConstraintSolver::setTimeStep(double _timeStep)
 
   if (mLCPSolver)
     mLCPSolver->setTimeStep(mTimeStep);
+
+  mCollisionDetector->setTimeStep(mTimeStep);
 }
 
 //==============================================================================
@@ -238,6 +229,8 @@ void ConstraintSolver::setCollisionDetector(
 {
   assert(_collisionDetector && "Invalid collision detector.");
 
+  _collisionDetector->setTimeStep(mTimeStep);
+
   // Add skeletons in the constraint solver to new collision detector
   for (size_t i = 0; i < mSkeletons.size(); ++i)
     _collisionDetector->addSkeleton(mSkeletons[i]);
@@ -276,14 +269,7 @@ bool ConstraintSolver::containSkeleton(const Skeleton* _skeleton) const
 {
   assert(_skeleton != NULL && "Not allowed to insert null pointer skeleton.");
 
-  for (std::vector<Skeleton*>::const_iterator it = mSkeletons.begin();
-       it != mSkeletons.end(); ++it)
-  {
-    if ((*it) == _skeleton)
-      return true;
-  }
-
-  return false;
+  return mSkeletonIndices.find(_skeleton) != mSkeletonIndices.end();
 }
 
 //==============================================================================
@@ -291,6 +277,7 @@ bool ConstraintSolver::checkAndAddSkeleton(Skeleton* _skeleton)
 {
   if (!containSkeleton(_skeleton))
   {
+    mSkeletonIndices[_skeleton] = mSkeletons.size();
     mSkeletons.push_back(_skeleton);
     return true;
   }
@@ -302,6 +289,23 @@ bool ConstraintSolver::checkAndAddSkeleton(Skeleton* _skeleton)
   }
 }
 
+//==============================================================================
+void ConstraintSolver::eraseSkeleton(const Skeleton* _skeleton)
+{
+  std::unordered_map<const Skeleton*, size_t>::iterator it
+      = mSkeletonIndices.find(_skeleton);
+  assert(it != mSkeletonIndices.end());
+
+  size_t index = it->second;
+  mSkeletonIndices.erase(it);
+  if (index + 1 < mSkeletons.size())
+  {
+    mSkeletons[index] = mSkeletons.back();
+    mSkeletonIndices[mSkeletons[index]] = index;
+  }
+  mSkeletons.pop_back();
+}
+
 //==============================================================================
 bool ConstraintSolver::containConstraint(const ConstraintBase* _constraint) const
 {
@@ -347,6 +351,7 @@ void ConstraintSolver::updateConstraints()
   //----------------------------------------------------------------------------
   mCollisionDetector->clearAllContacts();
   mCollisionDetector->detectCollision(true, true);
+  mCollisionDetector->detectSpeculativeContacts();
 
   // Destroy previous contact constraints
   for (const auto& contactConstraint : mContactConstraints)
@@ -403,6 +408,10 @@ void ConstraintSolver::updateConstraints()
   // Create new joint limit constraints
   for (const auto& skel : mSkeletons)
   {
+    // Skip the skeletons held still by the World for this sub-step
+    if (skel->isHeld())
+      continue;
+
     const size_t numBodyNodes = skel->getNumBodyNodes();
     for (size_t i = 0; i < numBodyNodes; i++)
     {
@@ -433,6 +442,9 @@ void ConstraintSolver::updateConstraints()
   // Create new joint limit constraints
   for (const auto& skel : mSkeletons)
   {
+    if (skel->isHeld())
+      continue;
+
     const size_t numBodyNodes = skel->getNumBodyNodes();
     for (size_t i = 0; i < numBodyNodes; i++)
     {
@@ -37,6 +37,7 @@
 #ifndef DART_CONSTRAINT_CONSTRAINTSOVER_H_
 #define DART_CONSTRAINT_CONSTRAINTSOVER_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -124,6 +125,10 @@ private:
   /// Add skeleton if the constraint is not contained in this solver
   bool checkAndAddSkeleton(dynamics::Skeleton* _skeleton);
 
+  /// Remove the skeleton from mSkeletons by moving the last skeleton into its
+  /// place. The skeleton must be contained in this solver.
+  void eraseSkeleton(const dynamics::Skeleton* _skeleton);
+
   /// Check if the constraint is contained in this solver
   bool containConstraint(const ConstraintBase* _constraint) const;
 
@@ -154,6 +159,9 @@ private:
   /// Skeleton list
   std::vector<dynamics::Skeleton*> mSkeletons;
 
+  /// Index of each skeleton in mSkeletons
+  std::unordered_map<const dynamics::Skeleton*, size_t> mSkeletonIndices;
+
   /// Contact constraints those are automatically created
   std::vector<ContactConstraint*> mContactConstraints;
 
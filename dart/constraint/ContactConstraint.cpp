@@ -430,9 +430,17 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       // Bouncing
       //------------------------------------------------------------------------
       // A. Penetration correction
+      const bool isSpeculative = mContacts[i]->penetrationDepth < 0.0;
       double bouncingVelocity = mContacts[i]->penetrationDepth
                                 - mErrorAllowance;
-      if (bouncingVelocity < 0.0)
+      if (isSpeculative)
+      {
+        // Speculative contact: the bodies may approach by the gap within the
+        // time step, so they stop where they touch
+        bouncingVelocity
+            = mContacts[i]->penetrationDepth * _info->invTimeStep;
+      }
+      else if (bouncingVelocity < 0.0)
       {
         bouncingVelocity = 0.0;
       }
@@ -444,7 +452,7 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       }
 
       // B. Restitution
-      if (mIsBounceOn)
+      if (mIsBounceOn && !isSpeculative)
       {
         double& negativeRelativeVel = _info->b[index];
         double restitutionVel = negativeRelativeVel * mRestitutionCoeff;
@@ -498,9 +506,15 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       // Bouncing
       //------------------------------------------------------------------------
       // A. Penetration correction
+      const bool isSpeculative = mContacts[i]->penetrationDepth < 0.0;
       double bouncingVelocity = mContacts[i]->penetrationDepth
                                 - DART_ERROR_ALLOWANCE;
-      if (bouncingVelocity < 0.0)
+      if (isSpeculative)
+      {
+        bouncingVelocity
+            = mContacts[i]->penetrationDepth * _info->invTimeStep;
+      }
+      else if (bouncingVelocity < 0.0)
       {
         bouncingVelocity = 0.0;
       }
@@ -512,7 +526,7 @@ void ContactConstraint::getInformation(ConstraintInfo* _info)
       }
 
       // B. Restitution
-      if (mIsBounceOn)
+      if (mIsBounceOn && !isSpeculative)
       {
         double& negativeRelativeVel = _info->b[i];
         double restitutionVel = negativeRelativeVel * mRestitutionCoeff;
@@ -756,10 +770,12 @@ void ContactConstraint::getRelVelocity(double* _relVel)
   {
     _relVel[i] = 0.0;
 
-    if (mBodyNode1->isReactive())
+    // A body of a skeleton held still by the World during a sub-step does not
+    // react, but keeps moving at the velocity of its last step
+    if (mBodyNode1->isReactive() || mBodyNode1->getSkeleton()->isHeld())
       _relVel[i] -= mJacobians1[i].dot(mBodyNode1->getSpatialVelocity());
 
-    if (mBodyNode2->isReactive())
+    if (mBodyNode2->isReactive() || mBodyNode2->getSkeleton()->isHeld())
       _relVel[i] -= mJacobians2[i].dot(mBodyNode2->getSpatialVelocity());
 
 //    std::cout << "_relVel[i + _idx]: " << _relVel[i + _idx] << std::endl;
@@ -913,7 +913,8 @@ void SoftContactConstraint::getRelVelocity(double* _vel)
     }
     else
     {
-      if (mBodyNode1->isReactive())
+      // Held bodies keep their velocity (see ContactConstraint)
+      if (mBodyNode1->isReactive() || mBodyNode1->getSkeleton()->isHeld())
         _vel[i] -= mJacobians1[i].dot(mBodyNode1->getSpatialVelocity());
     }
 
@@ -923,7 +924,7 @@ void SoftContactConstraint::getRelVelocity(double* _vel)
     }
     else
     {
-      if (mBodyNode2->isReactive())
+      if (mBodyNode2->isReactive() || mBodyNode2->getSkeleton()->isHeld())
         _vel[i] -= mJacobians2[i].dot(mBodyNode2->getSpatialVelocity());
     }
 
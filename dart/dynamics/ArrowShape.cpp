@@ -70,6 +70,18 @@ ArrowShape::ArrowShape(const Eigen::Vector3d& _tail,
   configureArrow(mTail, mHead, mProperties);
 }
 
+//==============================================================================
+Shape* ArrowShape::clone() const
+{
+  // The arrow modifies its own mesh whenever it is reconfigured, so the copy
+  // needs a mesh of its own.
+  size_t resolution = mMesh->mMeshes[1]->mNumVertices / 2;
+  ArrowShape* arrow = new ArrowShape(mTail, mHead, mProperties, mColor,
+                                     resolution);
+  arrow->setLocalTransform(mTransform);
+  return arrow;
+}
+
 //==============================================================================
 void ArrowShape::setPositions(const Eigen::Vector3d& _tail,
                               const Eigen::Vector3d& _head)
@@ -365,6 +377,7 @@ void ArrowShape::instantiate(size_t resolution)
   }
 
   mMesh = scene;
+  mSharedMesh.reset(scene);
 
   setColor(mColor);
 }
@@ -76,6 +76,9 @@ public:
              const Eigen::Vector4d& _color=Eigen::Vector4d(0.5,0.5,1.0,1.0),
              size_t _resolution=10);
 
+  // Documentation inherited.
+  Shape* clone() const override;
+
   /// Set the positions of the tail and head of the arrow without changing any
   /// settings
   void setPositions(const Eigen::Vector3d& _tail, const Eigen::Vector3d& _head);
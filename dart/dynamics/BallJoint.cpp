@@ -57,6 +57,14 @@ BallJoint::~BallJoint()
 {
 }
 
+//==============================================================================
+Joint* BallJoint::clone() const
+{
+  BallJoint* joint = new BallJoint(mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 Eigen::Isometry3d BallJoint::convertToTransform(
     const Eigen::Vector3d& _positions)
@@ -113,7 +121,9 @@ Eigen::Matrix<double, 6, 3> BallJoint::getLocalJacobianStatic(
 //==============================================================================
 void BallJoint::integratePositions(double _dt)
 {
-  mR.linear() = mR.linear()
+  // The positions may have been written through the state buffer of the
+  // Skeleton, so mR is not trusted here
+  mR.linear() = convertToRotation(getPositionsStatic())
       * convertToRotation(getLocalJacobianStatic().topRows<3>()
                           * getVelocitiesStatic() * _dt);
 
@@ -54,6 +54,9 @@ public:
   /// Destructor
   virtual ~BallJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   /// Convert a rotation into a 3D vector that can be used to set the positions
   /// of a BallJoint. The positions returned by this function will result in a
   /// relative transform of
@@ -38,6 +38,7 @@
 #include "dart/dynamics/BodyNode.h"
 
 #include <algorithm>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -92,6 +93,9 @@ BodyNode::BodyNode(const std::string& _name)
     mFrictionCoeff(DART_DEFAULT_FRICTION_COEFF),
     mRestitutionCoeff(DART_DEFAULT_RESTITUTION_COEFF),
     mIsCollidable(true),
+    mCollisionCategory(1u),
+    mCollisionMask(0xFFFFFFFFu),
+    mIsCCDEnabled(false),
     mIsColliding(false),
     mSkeleton(NULL),
     mParentJoint(NULL),
@@ -152,6 +156,14 @@ BodyNode::~BodyNode()
   delete mParentJoint;
 }
 
+//==============================================================================
+BodyNode* BodyNode::clone() const
+{
+  BodyNode* bodyNode = new BodyNode(mName);
+  bodyNode->copyPropertiesAndState(this);
+  return bodyNode;
+}
+
 //==============================================================================
 const std::string& BodyNode::setName(const std::string& _name)
 {
@@ -219,6 +231,42 @@ void BodyNode::setCollidable(bool _isCollidable)
   mIsCollidable = _isCollidable;
 }
 
+//==============================================================================
+void BodyNode::setCollisionCategory(uint32_t _category)
+{
+  mCollisionCategory = _category;
+}
+
+//==============================================================================
+uint32_t BodyNode::getCollisionCategory() const
+{
+  return mCollisionCategory;
+}
+
+//==============================================================================
+void BodyNode::setCollisionMask(uint32_t _mask)
+{
+  mCollisionMask = _mask;
+}
+
+//==============================================================================
+uint32_t BodyNode::getCollisionMask() const
+{
+  return mCollisionMask;
+}
+
+//==============================================================================
+void BodyNode::setCCDEnabled(bool _isCCDEnabled)
+{
+  mIsCCDEnabled = _isCCDEnabled;
+}
+
+//==============================================================================
+bool BodyNode::isCCDEnabled() const
+{
+  return mIsCCDEnabled;
+}
+
 //==============================================================================
 void BodyNode::setMass(double _mass)
 {
@@ -1154,6 +1202,63 @@ void BodyNode::setExtTorque(const Eigen::Vector3d& _torque, bool _isLocal)
     mSkeleton->mIsExternalForcesDirty = true;
 }
 
+//==============================================================================
+void BodyNode::copyPropertiesAndState(const BodyNode* _otherBodyNode)
+{
+  assert(_otherBodyNode);
+
+  mGravityMode      = _otherBodyNode->mGravityMode;
+  mI                = _otherBodyNode->mI;
+  mCenterOfMass     = _otherBodyNode->mCenterOfMass;
+  mIxx              = _otherBodyNode->mIxx;
+  mIyy              = _otherBodyNode->mIyy;
+  mIzz              = _otherBodyNode->mIzz;
+  mIxy              = _otherBodyNode->mIxy;
+  mIxz              = _otherBodyNode->mIxz;
+  mIyz              = _otherBodyNode->mIyz;
+  mMass             = _otherBodyNode->mMass;
+  mFrictionCoeff    = _otherBodyNode->mFrictionCoeff;
+  mRestitutionCoeff = _otherBodyNode->mRestitutionCoeff;
+  mIsCollidable     = _otherBodyNode->mIsCollidable;
+  mCollisionCategory = _otherBodyNode->mCollisionCategory;
+  mCollisionMask    = _otherBodyNode->mCollisionMask;
+  mIsCCDEnabled     = _otherBodyNode->mIsCCDEnabled;
+  mFext             = _otherBodyNode->mFext;
+
+  // A shape may be used both for visualization and for collision
+  std::map<const Shape*, Shape*> clonedShapes;
+
+  for (size_t i = 0; i < _otherBodyNode->mVizShapes.size(); ++i)
+  {
+    const Shape* shape = _otherBodyNode->mVizShapes[i];
+    Shape* clonedShape = cloneShape(shape);
+    clonedShapes[shape] = clonedShape;
+    addVisualizationShape(clonedShape);
+  }
+
+  for (size_t i = 0; i < _otherBodyNode->mColShapes.size(); ++i)
+  {
+    const Shape* shape = _otherBodyNode->mColShapes[i];
+    std::map<const Shape*, Shape*>::const_iterator it
+        = clonedShapes.find(shape);
+    addCollisionShape(it != clonedShapes.end() ? it->second
+                                               : cloneShape(shape));
+  }
+
+  for (size_t i = 0; i < _otherBodyNode->mMarkers.size(); ++i)
+  {
+    const Marker* marker = _otherBodyNode->mMarkers[i];
+    addMarker(new Marker(marker->getName(), marker->getLocalPosition(), this,
+                         marker->getConstraintType()));
+  }
+}
+
+//==============================================================================
+Shape* BodyNode::cloneShape(const Shape* _shape)
+{
+  return _shape->clone();
+}
+
 //==============================================================================
 void BodyNode::init(Skeleton* _skeleton)
 {
@@ -1215,7 +1320,8 @@ void BodyNode::processNewEntity(Entity* _newChildEntity)
   // TODO: Looks redundant
 
   // Check if it's already accounted for in our Non-BodyNode Entities
-  if(mNonBodyNodeEntities.find(_newChildEntity) != mNonBodyNodeEntities.end())
+  if(find(mNonBodyNodeEntities.begin(), mNonBodyNodeEntities.end(),
+          _newChildEntity) != mNonBodyNodeEntities.end())
   {
     dtwarn << "[BodyNode::processNewEntity(~)] Attempting to add an Entity '"
            << _newChildEntity->getName() << "' as a child Entity of '"
@@ -1224,7 +1330,7 @@ void BodyNode::processNewEntity(Entity* _newChildEntity)
   }
 
   // Add it to the Non-BodyNode Entities
-  mNonBodyNodeEntities.insert(_newChildEntity);
+  mNonBodyNodeEntities.push_back(_newChildEntity);
 }
 
 //==============================================================================
@@ -1236,9 +1342,11 @@ void BodyNode::processRemovedEntity(Entity* _oldChildEntity)
   if(it != mChildBodyNodes.end())
     mChildBodyNodes.erase(it);
 
-  if(find(mNonBodyNodeEntities.begin(), mNonBodyNodeEntities.end(),
-          _oldChildEntity) != mNonBodyNodeEntities.end())
-    mNonBodyNodeEntities.erase(_oldChildEntity);
+  std::vector<Entity*>::iterator entity = find(mNonBodyNodeEntities.begin(),
+                                               mNonBodyNodeEntities.end(),
+                                               _oldChildEntity);
+  if(entity != mNonBodyNodeEntities.end())
+    mNonBodyNodeEntities.erase(entity);
 }
 
 //==============================================================================
@@ -1288,6 +1396,8 @@ void BodyNode::notifyTransformUpdate()
 
   for(Entity* entity : mNonBodyNodeEntities)
     entity->notifyTransformUpdate();
+
+  mTransformUpdatedSignal.raise(this);
 }
 
 //==============================================================================
@@ -1762,7 +1872,8 @@ bool BodyNode::isImpulseReponsible() const
 //==============================================================================
 bool BodyNode::isReactive() const
 {
-  if (mSkeleton->isMobile() && getNumDependentGenCoords() > 0)
+  if (mSkeleton->isMobile() && !mSkeleton->isHeld()
+      && getNumDependentGenCoords() > 0)
   {
     // Check if all the ancestor joints are motion prescribed.
     const BodyNode* body = this;
@@ -38,6 +38,7 @@
 #ifndef DART_DYNAMICS_BODYNODE_H_
 #define DART_DYNAMICS_BODYNODE_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -82,6 +83,12 @@ public:
   /// Destructor
   virtual ~BodyNode();
 
+  /// Create a copy of this BodyNode with the same inertia, shapes, markers and
+  /// external force. The copy has no parent Joint and is not attached to any
+  /// Skeleton. Shapes are cloned with Shape::clone(), so mesh data is shared
+  /// between this BodyNode and the copy.
+  virtual BodyNode* clone() const;
+
   /// Set name. If the name is already taken, this will return an altered
   /// version which will be used by the Skeleton
   const std::string& setName(const std::string& _name);
@@ -103,6 +110,30 @@ public:
   /// \param[in] _isCollidable True to enable collisions
   void setCollidable(bool _isCollidable);
 
+  /// Set the collision categories that this body belongs to, as a bitfield.
+  /// Two bodies are only tested for collision if the categories of each one
+  /// overlap the collision mask of the other. The default category is 1.
+  void setCollisionCategory(uint32_t _category);
+
+  /// Return the collision categories that this body belongs to
+  uint32_t getCollisionCategory() const;
+
+  /// Set the collision categories that this body can collide with, as a
+  /// bitfield. The default mask contains every category.
+  void setCollisionMask(uint32_t _mask);
+
+  /// Return the collision categories that this body can collide with
+  uint32_t getCollisionMask() const;
+
+  /// Set whether contacts of this body are predicted over the time step.
+  /// Bodies that may reach each other within the next step are then given
+  /// speculative contacts, which stop fast bodies at the surface instead of
+  /// letting them tunnel through thin objects. Disabled by default.
+  void setCCDEnabled(bool _isCCDEnabled);
+
+  /// Return true if contacts of this body are predicted over the time step
+  bool isCCDEnabled() const;
+
   /// Set the mass of the bodynode
   void setMass(double _mass);
 
@@ -747,9 +778,10 @@ public:
 
   /// Return true if the body can react to force or constraint impulse.
   ///
-  /// A body node is reactive if the skeleton is mobile and the number of
-  /// dependent generalized coordinates is non zero. BodyNode::init() should be
-  /// called first to update the number of dependent generalized coordinates.
+  /// A body node is reactive if the skeleton is mobile and not held still by
+  /// simulation::World for a sub-step, and the number of dependent
+  /// generalized coordinates is non zero. BodyNode::init() should be called
+  /// first to update the number of dependent generalized coordinates.
   bool isReactive() const;
 
   /// Set constraint impulse
@@ -820,6 +852,14 @@ protected:
   /// Initialize the vector members with proper sizes.
   virtual void init(Skeleton* _skeleton);
 
+  /// Copy the properties, shapes, markers and external force of
+  /// _otherBodyNode into this BodyNode. Used by clone().
+  virtual void copyPropertiesAndState(const BodyNode* _otherBodyNode);
+
+  /// Create a copy of _shape that belongs to this BodyNode. Used by
+  /// copyPropertiesAndState().
+  virtual Shape* cloneShape(const Shape* _shape);
+
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
@@ -1045,6 +1085,15 @@ protected:
   /// Indicating whether this node is collidable.
   bool mIsCollidable;
 
+  /// Collision categories that this node belongs to
+  uint32_t mCollisionCategory;
+
+  /// Collision categories that this node can collide with
+  uint32_t mCollisionMask;
+
+  /// Whether contacts of this node are predicted over the time step
+  bool mIsCCDEnabled;
+
   /// Whether the node is currently in collision with another node.
   bool mIsColliding;
 
@@ -1066,7 +1115,7 @@ protected:
 
   /// Array of child Entities that are not BodyNodes. Organizing them separately
   /// allows some performance optimizations.
-  std::set<Entity*> mNonBodyNodeEntities;
+  std::vector<Entity*> mNonBodyNodeEntities;
 
   /// List of markers associated
   std::vector<Marker*> mMarkers;
@@ -56,6 +56,13 @@ BoxShape::BoxShape(const Eigen::Vector3d& _size)
 BoxShape::~BoxShape() {
 }
 
+Shape* BoxShape::clone() const {
+  BoxShape* box = new BoxShape(mSize);
+  box->setRGBA(mColor);
+  box->setLocalTransform(mTransform);
+  return box;
+}
+
 void BoxShape::setDim(const Eigen::Vector3d& _size) {
   setSize(_size);
 }
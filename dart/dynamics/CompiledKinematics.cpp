@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/CompiledKinematics.h"
+
+#include <map>
+#include <typeinfo>
+
+#include "dart/common/Console.h"
+#include "dart/math/Geometry.h"
+#include "dart/math/Helpers.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Joint.h"
+#include "dart/dynamics/WeldJoint.h"
+#include "dart/dynamics/RevoluteJoint.h"
+#include "dart/dynamics/PrismaticJoint.h"
+#include "dart/dynamics/ScrewJoint.h"
+#include "dart/dynamics/Skeleton.h"
+
+namespace dart {
+namespace dynamics {
+
+//==============================================================================
+CompiledKinematics::CompiledKinematics(Skeleton* _skeleton)
+  : mSkeleton(_skeleton),
+    mNumGenericRecords(0)
+{
+  assert(_skeleton != nullptr);
+  compile();
+}
+
+//==============================================================================
+CompiledKinematics::~CompiledKinematics()
+{
+}
+
+//==============================================================================
+void CompiledKinematics::compile()
+{
+  const size_t numBodyNodes = mSkeleton->getNumBodyNodes();
+
+  std::map<const BodyNode*, int> indices;
+  for (size_t i = 0; i < numBodyNodes; ++i)
+    indices[mSkeleton->getBodyNode(i)] = static_cast<int>(i);
+
+  mRecords.resize(numBodyNodes);
+  mNumGenericRecords = 0;
+
+  for (size_t i = 0; i < numBodyNodes; ++i)
+  {
+    BodyNode* bodyNode = mSkeleton->getBodyNode(i);
+    Joint* joint = bodyNode->getParentJoint();
+    Record& record = mRecords[i];
+
+    const BodyNode* parent = bodyNode->getParentBodyNode();
+    record.mParent = (parent == nullptr) ? -1 : indices[parent];
+    record.mJoint = joint;
+    record.mNumDofs = joint->getNumDofs();
+    record.mIndexInSkeleton
+        = record.mNumDofs > 0 ? joint->getIndexInSkeleton(0) : 0;
+    record.mParentToJoint = joint->getTransformFromParentBodyNode();
+    record.mJointToChild = joint->getTransformFromChildBodyNode().inverse();
+    record.mAxis.setZero();
+    record.mPitch = 0.0;
+    record.mJacobian.setZero();
+
+    // The ordering of the BodyNodes must have parents first, since the loop
+    // in compute() relies on it
+    assert(record.mParent < static_cast<int>(i));
+
+    // Only the exact types are compiled. Derived classes may override the
+    // local kinematics, so they are treated as generic joints.
+    const std::type_info& type = typeid(*joint);
+    if (type == typeid(WeldJoint))
+    {
+      record.mType = WELD;
+      record.mParentToJoint = record.mParentToJoint * record.mJointToChild;
+    }
+    else if (type == typeid(RevoluteJoint))
+    {
+      record.mType = REVOLUTE;
+      record.mAxis = static_cast<RevoluteJoint*>(joint)->getAxis();
+      record.mJacobian = math::AdTAngular(
+            joint->getTransformFromChildBodyNode(), record.mAxis);
+    }
+    else if (type == typeid(PrismaticJoint))
+    {
+      record.mType = PRISMATIC;
+      record.mAxis = static_cast<PrismaticJoint*>(joint)->getAxis();
+      record.mJacobian = math::AdTLinear(
+            joint->getTransformFromChildBodyNode(), record.mAxis);
+    }
+    else if (type == typeid(ScrewJoint))
+    {
+      ScrewJoint* screwJoint = static_cast<ScrewJoint*>(joint);
+      record.mType = SCREW;
+      record.mAxis = screwJoint->getAxis();
+      record.mPitch = screwJoint->getPitch() / DART_2PI;
+
+      Eigen::Vector6d S;
+      S.head<3>() = record.mAxis;
+      S.tail<3>() = record.mAxis * record.mPitch;
+      record.mJacobian = math::AdT(joint->getTransformFromChildBodyNode(), S);
+    }
+    else
+    {
+      record.mType = GENERIC;
+      ++mNumGenericRecords;
+    }
+  }
+
+  mWorldTransforms.resize(numBodyNodes, Eigen::Isometry3d::Identity());
+  mVelocities.resize(numBodyNodes, Eigen::Vector6d::Zero());
+  mAccelerations.resize(numBodyNodes, Eigen::Vector6d::Zero());
+}
+
+//==============================================================================
+Skeleton* CompiledKinematics::getSkeleton() const
+{
+  return mSkeleton;
+}
+
+//==============================================================================
+size_t CompiledKinematics::getNumRecords() const
+{
+  return mRecords.size();
+}
+
+//==============================================================================
+const CompiledKinematics::Record& CompiledKinematics::getRecord(
+    size_t _index) const
+{
+  assert(_index < mRecords.size());
+  return mRecords[_index];
+}
+
+//==============================================================================
+bool CompiledKinematics::isFullyCompiled() const
+{
+  return mNumGenericRecords == 0;
+}
+
+//==============================================================================
+void CompiledKinematics::update(bool _updateVelocities,
+                                bool _updateAccelerations)
+{
+  mPositions = mSkeleton->getPositions();
+  if (_updateVelocities || _updateAccelerations)
+    mVelocitiesBuffer = mSkeleton->getVelocities();
+  if (_updateAccelerations)
+    mAccelerationsBuffer = mSkeleton->getAccelerations();
+
+  compute(mPositions, mVelocitiesBuffer, mAccelerationsBuffer,
+          _updateVelocities || _updateAccelerations, _updateAccelerations);
+}
+
+//==============================================================================
+void CompiledKinematics::update(const Eigen::VectorXd& _positions,
+                                const Eigen::VectorXd& _velocities,
+                                const Eigen::VectorXd& _accelerations,
+                                bool _updateVelocities,
+                                bool _updateAccelerations)
+{
+  _updateVelocities = _updateVelocities || _updateAccelerations;
+
+  if (static_cast<size_t>(_positions.size()) != mSkeleton->getNumDofs()
+      || (_updateVelocities
+          && static_cast<size_t>(_velocities.size())
+             != mSkeleton->getNumDofs())
+      || (_updateAccelerations
+          && static_cast<size_t>(_accelerations.size())
+             != mSkeleton->getNumDofs()))
+  {
+    dterr << "[CompiledKinematics::update] The size of the generalized "
+          << "vectors does not match the number of DOFs ("
+          << mSkeleton->getNumDofs() << ") of Skeleton ["
+          << mSkeleton->getName() << "].\n";
+    return;
+  }
+
+  // Generic joints compute their local kinematics from their own state
+  if (mNumGenericRecords > 0)
+  {
+    for (size_t i = 0; i < mRecords.size(); ++i)
+    {
+      const Record& record = mRecords[i];
+      if (record.mType != GENERIC || record.mNumDofs == 0)
+        continue;
+
+      record.mJoint->setPositions(
+            _positions.segment(record.mIndexInSkeleton, record.mNumDofs));
+      if (_updateVelocities)
+        record.mJoint->setVelocities(
+              _velocities.segment(record.mIndexInSkeleton, record.mNumDofs));
+      if (_updateAccelerations)
+        record.mJoint->setAccelerations(
+              _accelerations.segment(record.mIndexInSkeleton,
+                                     record.mNumDofs));
+    }
+  }
+
+  compute(_positions, _velocities, _accelerations,
+          _updateVelocities, _updateAccelerations);
+}
+
+//==============================================================================
+const Eigen::Isometry3d& CompiledKinematics::getWorldTransform(
+    size_t _index) const
+{
+  assert(_index < mWorldTransforms.size());
+  return mWorldTransforms[_index];
+}
+
+//==============================================================================
+const Eigen::Vector6d& CompiledKinematics::getSpatialVelocity(
+    size_t _index) const
+{
+  assert(_index < mVelocities.size());
+  return mVelocities[_index];
+}
+
+//==============================================================================
+const Eigen::Vector6d& CompiledKinematics::getSpatialAcceleration(
+    size_t _index) const
+{
+  assert(_index < mAccelerations.size());
+  return mAccelerations[_index];
+}
+
+//==============================================================================
+void CompiledKinematics::compute(const Eigen::VectorXd& _positions,
+                                 const Eigen::VectorXd& _velocities,
+                                 const Eigen::VectorXd& _accelerations,
+                                 bool _updateVelocities,
+                                 bool _updateAccelerations)
+{
+  Eigen::Isometry3d T;
+  Eigen::Vector6d relV;
+
+  for (size_t i = 0; i < mRecords.size(); ++i)
+  {
+    const Record& record = mRecords[i];
+    const size_t index = record.mIndexInSkeleton;
+
+    // Local transform
+    switch (record.mType)
+    {
+      case WELD:
+        T = record.mParentToJoint;
+        break;
+      case REVOLUTE:
+        T = record.mParentToJoint
+            * math::expAngular(record.mAxis * _positions[index])
+            * record.mJointToChild;
+        break;
+      case PRISMATIC:
+        T = record.mParentToJoint
+            * Eigen::Translation3d(record.mAxis * _positions[index])
+            * record.mJointToChild;
+        break;
+      case SCREW:
+      {
+        Eigen::Isometry3d screw = math::expAngular(record.mAxis
+                                                   * _positions[index]);
+        screw.translation() = record.mAxis * (record.mPitch
+                                              * _positions[index]);
+        T = record.mParentToJoint * screw * record.mJointToChild;
+        break;
+      }
+      default:
+        T = record.mJoint->getLocalTransform();
+        break;
+    }
+
+    if (record.mParent < 0)
+      mWorldTransforms[i] = T;
+    else
+      mWorldTransforms[i] = mWorldTransforms[record.mParent] * T;
+
+    if (!_updateVelocities)
+      continue;
+
+    // Local velocity
+    if (record.mType == GENERIC)
+      relV = record.mJoint->getLocalSpatialVelocity();
+    else if (record.mType == WELD)
+      relV.setZero();
+    else
+      relV = record.mJacobian * _velocities[index];
+
+    if (record.mParent < 0)
+      mVelocities[i] = relV;
+    else
+      mVelocities[i] = math::AdInvT(T, mVelocities[record.mParent]) + relV;
+
+    if (!_updateAccelerations)
+      continue;
+
+    // Local acceleration. The Jacobians of the compiled joints are constant,
+    // so only the generic joints contribute a time derivative term.
+    Eigen::Vector6d& A = mAccelerations[i];
+    if (record.mParent < 0)
+      A.setZero();
+    else
+      A = math::AdInvT(T, mAccelerations[record.mParent]);
+
+    if (record.mType == GENERIC)
+      A += record.mJoint->getLocalSpatialAcceleration();
+    else if (record.mType != WELD)
+      A += record.mJacobian * _accelerations[index];
+
+    if (record.mType != WELD)
+      A += math::ad(mVelocities[i], relV);
+  }
+}
+
+}  // namespace dynamics
+}  // namespace dart
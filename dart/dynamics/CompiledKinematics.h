@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_COMPILEDKINEMATICS_H_
+#define DART_DYNAMICS_COMPILEDKINEMATICS_H_
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include "dart/math/MathTypes.h"
+
+namespace dart {
+namespace dynamics {
+
+class BodyNode;
+class Joint;
+class Skeleton;
+
+/// The CompiledKinematics class evaluates the forward kinematics of a Skeleton
+/// without going through the lazy Frame machinery. compile() flattens the
+/// tree into an array of records sorted so that parents come before their
+/// children, and update() computes the world transform, spatial velocity and
+/// spatial acceleration of every BodyNode in one pass over that array.
+///
+/// Weld, revolute, prismatic and screw joints are compiled into closed-form
+/// records and never go through a virtual call. Other joint types fall back
+/// on the Joint's own (virtual) local kinematics, so every Skeleton is
+/// supported and the results always match the ones of the BodyNodes.
+///
+/// The results are stored in this object; the BodyNodes of the Skeleton are
+/// not modified. compile() must be called again whenever the structure of the
+/// Skeleton or the fixed properties of its joints (axes, offsets) change.
+class CompiledKinematics
+{
+public:
+  /// Type of a compiled record
+  enum JointType
+  {
+    WELD,
+    REVOLUTE,
+    PRISMATIC,
+    SCREW,
+    GENERIC
+  };
+
+  /// Compiled form of a BodyNode and its parent Joint
+  struct Record
+  {
+    /// Index of the parent record, or -1 for a root
+    int mParent;
+
+    /// How the local kinematics are computed
+    JointType mType;
+
+    /// Index of the first generalized coordinate of the Joint
+    size_t mIndexInSkeleton;
+
+    /// Number of generalized coordinates of the Joint
+    size_t mNumDofs;
+
+    /// Joint that GENERIC records defer to
+    Joint* mJoint;
+
+    /// Transform from the parent BodyNode to the Joint. For WELD records this
+    /// is the full, constant local transform.
+    Eigen::Isometry3d mParentToJoint;
+
+    /// Transform from the Joint to the child BodyNode
+    Eigen::Isometry3d mJointToChild;
+
+    /// Unit axis of REVOLUTE, PRISMATIC and SCREW records
+    Eigen::Vector3d mAxis;
+
+    /// Translation per radian of SCREW records
+    double mPitch;
+
+    /// Constant local Jacobian of single-DOF records, in the child frame
+    Eigen::Vector6d mJacobian;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /// Constructor. Compiles _skeleton right away.
+  explicit CompiledKinematics(Skeleton* _skeleton);
+
+  /// Destructor
+  virtual ~CompiledKinematics();
+
+  /// Rebuild the records from the current structure of the Skeleton
+  void compile();
+
+  /// Return the Skeleton that was compiled
+  Skeleton* getSkeleton() const;
+
+  /// Return the number of records, which equals the number of BodyNodes
+  size_t getNumRecords() const;
+
+  /// Return a record. Record i describes BodyNode i of the Skeleton.
+  const Record& getRecord(size_t _index) const;
+
+  /// Return true if no record needs a virtual call
+  bool isFullyCompiled() const;
+
+  /// Compute the kinematics from the current generalized positions,
+  /// velocities and accelerations of the Skeleton
+  void update(bool _updateVelocities = true,
+              bool _updateAccelerations = true);
+
+  /// Compute the kinematics for the given generalized positions, velocities
+  /// and accelerations. _velocities and _accelerations are only read if the
+  /// corresponding quantities are updated. Joints of GENERIC records are set
+  /// to their part of the vectors.
+  void update(const Eigen::VectorXd& _positions,
+              const Eigen::VectorXd& _velocities,
+              const Eigen::VectorXd& _accelerations,
+              bool _updateVelocities = true,
+              bool _updateAccelerations = true);
+
+  /// World transform of BodyNode _index computed by the last update()
+  const Eigen::Isometry3d& getWorldTransform(size_t _index) const;
+
+  /// Spatial velocity of BodyNode _index, in its own frame, computed by the
+  /// last update()
+  const Eigen::Vector6d& getSpatialVelocity(size_t _index) const;
+
+  /// Spatial acceleration of BodyNode _index, in its own frame, computed by
+  /// the last update()
+  const Eigen::Vector6d& getSpatialAcceleration(size_t _index) const;
+
+protected:
+  /// Compute the kinematics from the given vectors
+  void compute(const Eigen::VectorXd& _positions,
+               const Eigen::VectorXd& _velocities,
+               const Eigen::VectorXd& _accelerations,
+               bool _updateVelocities,
+               bool _updateAccelerations);
+
+  /// Skeleton that was compiled
+  Skeleton* mSkeleton;
+
+  /// Records in topological order
+  std::vector<Record, Eigen::aligned_allocator<Record> > mRecords;
+
+  /// Number of GENERIC records
+  size_t mNumGenericRecords;
+
+  /// World transform of every BodyNode
+  std::vector<Eigen::Isometry3d,
+              Eigen::aligned_allocator<Eigen::Isometry3d> > mWorldTransforms;
+
+  /// Spatial velocity of every BodyNode
+  std::vector<Eigen::Vector6d,
+              Eigen::aligned_allocator<Eigen::Vector6d> > mVelocities;
+
+  /// Spatial acceleration of every BodyNode
+  std::vector<Eigen::Vector6d,
+              Eigen::aligned_allocator<Eigen::Vector6d> > mAccelerations;
+
+  /// Generalized positions read by update()
+  Eigen::VectorXd mPositions;
+
+  /// Generalized velocities read by update()
+  Eigen::VectorXd mVelocitiesBuffer;
+
+  /// Generalized accelerations read by update()
+  Eigen::VectorXd mAccelerationsBuffer;
+
+public:
+  // To get byte-aligned Eigen vectors
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+}  // namespace dynamics
+}  // namespace dart
+
+#endif  // DART_DYNAMICS_COMPILEDKINEMATICS_H_
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/CookedMesh.h"
+
+#include <sys/stat.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "dart/common/Console.h"
+#include "dart/dynamics/MeshShape.h"
+
+namespace dart {
+namespace dynamics {
+
+namespace {
+
+const char COOKED_MESH_MAGIC[8] = {'D', 'A', 'R', 'T', 'M', 'S', 'H', '\0'};
+const uint32_t COOKED_MESH_VERSION = 1;
+const uint32_t COOKED_MESH_BYTE_ORDER = 0x01020304;
+
+enum CookedMeshFlags
+{
+  HAS_NORMALS = 1 << 0,
+  HAS_COLORS  = 1 << 1
+};
+
+/// Beginning of a cooked mesh file
+struct CookedMeshHeader
+{
+  char mMagic[8];
+  uint32_t mVersion;
+  uint32_t mByteOrder;
+  uint64_t mSourceSize;
+  int64_t mSourceTime;
+  uint32_t mNumMeshes;
+  uint32_t mPadding;
+};
+
+/// Beginning of each sub-mesh. It is followed by mNumVertices vertices,
+/// optionally as many normals and colors, and 3 * mNumFaces indices.
+struct CookedSubMesh
+{
+  uint32_t mNumVertices;
+  uint32_t mNumFaces;
+  uint32_t mFlags;
+  uint32_t mPadding;
+};
+
+static_assert(sizeof(aiVector3D) == 3 * sizeof(float),
+              "Cooked meshes require single precision Assimp vectors");
+static_assert(sizeof(aiColor4D) == 4 * sizeof(float),
+              "Cooked meshes require single precision Assimp colors");
+
+//==============================================================================
+bool getFileStatus(const std::string& _fileName,
+                   uint64_t& _size, int64_t& _time)
+{
+  struct stat status;
+  if (stat(_fileName.c_str(), &status) != 0)
+    return false;
+
+  _size = static_cast<uint64_t>(status.st_size);
+  _time = static_cast<int64_t>(status.st_mtime);
+  return true;
+}
+
+//==============================================================================
+bool readHeader(std::istream& _in, CookedMeshHeader& _header)
+{
+  _in.read(reinterpret_cast<char*>(&_header), sizeof(_header));
+  if (!_in)
+    return false;
+
+  return std::memcmp(_header.mMagic, COOKED_MESH_MAGIC, 8) == 0
+      && _header.mVersion == COOKED_MESH_VERSION
+      && _header.mByteOrder == COOKED_MESH_BYTE_ORDER;
+}
+
+//==============================================================================
+bool isHeaderUpToDate(const CookedMeshHeader& _header,
+                      const std::string& _sourceFileName)
+{
+  uint64_t size;
+  int64_t time;
+
+  // A cooked file may be shipped without its source file
+  if (!getFileStatus(_sourceFileName, size, time))
+    return true;
+
+  return size == _header.mSourceSize && time == _header.mSourceTime;
+}
+
+}  // namespace
+
+//==============================================================================
+std::string CookedMesh::getCookedFileName(const std::string& _fileName)
+{
+  return _fileName + ".dartmesh";
+}
+
+//==============================================================================
+bool CookedMesh::cook(const std::string& _fileName)
+{
+  const aiScene* mesh = MeshShape::importMesh(_fileName);
+  if (nullptr == mesh)
+    return false;
+
+  bool result = write(mesh, _fileName, getCookedFileName(_fileName));
+  delete mesh;
+
+  return result;
+}
+
+//==============================================================================
+bool CookedMesh::write(const aiScene* _mesh,
+                       const std::string& _sourceFileName,
+                       const std::string& _cookedFileName)
+{
+  assert(_mesh);
+
+  CookedMeshHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.mMagic, COOKED_MESH_MAGIC, 8);
+  header.mVersion = COOKED_MESH_VERSION;
+  header.mByteOrder = COOKED_MESH_BYTE_ORDER;
+  header.mNumMeshes = _mesh->mNumMeshes;
+  if (!getFileStatus(_sourceFileName, header.mSourceSize, header.mSourceTime))
+  {
+    dterr << "[CookedMesh::write] Could not find the source file '"
+          << _sourceFileName << "'.\n";
+    return false;
+  }
+
+  std::ofstream out(_cookedFileName.c_str(), std::ios::binary);
+  if (!out)
+  {
+    dterr << "[CookedMesh::write] Could not open '" << _cookedFileName
+          << "' for writing.\n";
+    return false;
+  }
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<uint32_t> indices;
+  for (size_t i = 0; i < _mesh->mNumMeshes; ++i)
+  {
+    const aiMesh* mesh = _mesh->mMeshes[i];
+
+    indices.clear();
+    indices.reserve(3 * mesh->mNumFaces);
+    for (size_t j = 0; j < mesh->mNumFaces; ++j)
+    {
+      const aiFace& face = mesh->mFaces[j];
+      if (face.mNumIndices != 3)
+        continue;
+
+      indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+    }
+
+    if (indices.size() != 3 * mesh->mNumFaces)
+    {
+      dtwarn << "[CookedMesh::write] Skipping "
+             << mesh->mNumFaces - indices.size() / 3 << " faces of '"
+             << _sourceFileName << "' that are not triangles.\n";
+    }
+
+    CookedSubMesh subMesh;
+    subMesh.mNumVertices = mesh->mNumVertices;
+    subMesh.mNumFaces = indices.size() / 3;
+    subMesh.mFlags = 0;
+    subMesh.mPadding = 0;
+    if (mesh->mNormals)
+      subMesh.mFlags |= HAS_NORMALS;
+    if (mesh->mColors[0])
+      subMesh.mFlags |= HAS_COLORS;
+
+    out.write(reinterpret_cast<const char*>(&subMesh), sizeof(subMesh));
+    out.write(reinterpret_cast<const char*>(mesh->mVertices),
+              mesh->mNumVertices * sizeof(aiVector3D));
+    if (mesh->mNormals)
+      out.write(reinterpret_cast<const char*>(mesh->mNormals),
+                mesh->mNumVertices * sizeof(aiVector3D));
+    if (mesh->mColors[0])
+      out.write(reinterpret_cast<const char*>(mesh->mColors[0]),
+                mesh->mNumVertices * sizeof(aiColor4D));
+    out.write(reinterpret_cast<const char*>(indices.data()),
+              indices.size() * sizeof(uint32_t));
+  }
+
+  if (!out)
+  {
+    dterr << "[CookedMesh::write] Failed to write '" << _cookedFileName
+          << "'.\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+const aiScene* CookedMesh::read(const std::string& _cookedFileName,
+                                const std::string& _sourceFileName)
+{
+  std::ifstream in(_cookedFileName.c_str(), std::ios::binary);
+  if (!in)
+    return nullptr;
+
+  CookedMeshHeader header;
+  if (!readHeader(in, header))
+  {
+    dtwarn << "[CookedMesh::read] '" << _cookedFileName << "' is not a "
+           << "cooked mesh of this version. It will be ignored.\n";
+    return nullptr;
+  }
+
+  if (!isHeaderUpToDate(header, _sourceFileName))
+  {
+    dtwarn << "[CookedMesh::read] '" << _cookedFileName << "' is out of "
+           << "date. '" << _sourceFileName << "' will be loaded instead.\n";
+    return nullptr;
+  }
+
+  // Every count is checked against the bytes left in the file before
+  // anything is allocated for it, so a corrupted file can not request huge
+  // allocations
+  const std::streamoff begin = in.tellg();
+  in.seekg(0, std::ios::end);
+  uint64_t remaining = static_cast<uint64_t>(in.tellg() - begin);
+  in.seekg(begin);
+
+  if (static_cast<uint64_t>(header.mNumMeshes) * sizeof(CookedSubMesh)
+      > remaining)
+  {
+    dterr << "[CookedMesh::read] '" << _cookedFileName << "' claims "
+          << header.mNumMeshes << " meshes, which do not fit in the file.\n";
+    return nullptr;
+  }
+
+  aiScene* scene = new aiScene;
+  scene->mNumMeshes = header.mNumMeshes;
+  scene->mMeshes = new aiMesh*[header.mNumMeshes];
+  for (size_t i = 0; i < header.mNumMeshes; ++i)
+    scene->mMeshes[i] = nullptr;
+
+  scene->mNumMaterials = 1;
+  scene->mMaterials = new aiMaterial*[1];
+  scene->mMaterials[0] = new aiMaterial;
+
+  // The vertices were pre-transformed while cooking, so a single root node
+  // holds all the meshes
+  aiNode* node = new aiNode;
+  node->mNumMeshes = header.mNumMeshes;
+  node->mMeshes = new unsigned int[header.mNumMeshes];
+  for (size_t i = 0; i < header.mNumMeshes; ++i)
+    node->mMeshes[i] = i;
+  scene->mRootNode = node;
+
+  std::vector<uint32_t> indices;
+  for (size_t i = 0; i < header.mNumMeshes; ++i)
+  {
+    CookedSubMesh subMesh;
+    in.read(reinterpret_cast<char*>(&subMesh), sizeof(subMesh));
+    if (!in)
+      break;
+    remaining -= sizeof(subMesh);
+
+    uint64_t vertexSize = sizeof(aiVector3D);
+    if (subMesh.mFlags & HAS_NORMALS)
+      vertexSize += sizeof(aiVector3D);
+    if (subMesh.mFlags & HAS_COLORS)
+      vertexSize += sizeof(aiColor4D);
+
+    const uint64_t size = subMesh.mNumVertices * vertexSize
+        + static_cast<uint64_t>(subMesh.mNumFaces) * 3 * sizeof(uint32_t);
+    if (size > remaining)
+    {
+      dterr << "[CookedMesh::read] Mesh " << i << " of '" << _cookedFileName
+            << "' claims " << subMesh.mNumVertices << " vertices and "
+            << subMesh.mNumFaces << " faces, which do not fit in the file.\n";
+      delete scene;
+      return nullptr;
+    }
+    remaining -= size;
+
+    aiMesh* mesh = new aiMesh;
+    scene->mMeshes[i] = mesh;
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mMaterialIndex = 0;
+
+    mesh->mNumVertices = subMesh.mNumVertices;
+    mesh->mVertices = new aiVector3D[subMesh.mNumVertices];
+    in.read(reinterpret_cast<char*>(mesh->mVertices),
+            subMesh.mNumVertices * sizeof(aiVector3D));
+
+    if (subMesh.mFlags & HAS_NORMALS)
+    {
+      mesh->mNormals = new aiVector3D[subMesh.mNumVertices];
+      in.read(reinterpret_cast<char*>(mesh->mNormals),
+              subMesh.mNumVertices * sizeof(aiVector3D));
+    }
+
+    if (subMesh.mFlags & HAS_COLORS)
+    {
+      mesh->mColors[0] = new aiColor4D[subMesh.mNumVertices];
+      in.read(reinterpret_cast<char*>(mesh->mColors[0]),
+              subMesh.mNumVertices * sizeof(aiColor4D));
+    }
+
+    indices.resize(3 * subMesh.mNumFaces);
+    in.read(reinterpret_cast<char*>(indices.data()),
+            indices.size() * sizeof(uint32_t));
+    if (!in)
+      break;
+
+    mesh->mNumFaces = subMesh.mNumFaces;
+    mesh->mFaces = new aiFace[subMesh.mNumFaces];
+    for (size_t j = 0; j < subMesh.mNumFaces; ++j)
+    {
+      aiFace& face = mesh->mFaces[j];
+      face.mNumIndices = 3;
+      face.mIndices = new unsigned int[3];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        face.mIndices[k] = indices[3 * j + k];
+        if (face.mIndices[k] >= subMesh.mNumVertices)
+          in.setstate(std::ios::failbit);
+      }
+    }
+  }
+
+  if (!in)
+  {
+    dtwarn << "[CookedMesh::read] '" << _cookedFileName << "' is corrupted. "
+           << "It will be ignored.\n";
+    delete scene;
+    return nullptr;
+  }
+
+  return scene;
+}
+
+//==============================================================================
+bool CookedMesh::isUpToDate(const std::string& _cookedFileName,
+                            const std::string& _sourceFileName)
+{
+  std::ifstream in(_cookedFileName.c_str(), std::ios::binary);
+  if (!in)
+    return false;
+
+  CookedMeshHeader header;
+  return readHeader(in, header) && isHeaderUpToDate(header, _sourceFileName);
+}
+
+}  // namespace dynamics
+}  // namespace dart
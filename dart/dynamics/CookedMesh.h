@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_COOKEDMESH_H_
+#define DART_DYNAMICS_COOKEDMESH_H_
+
+#include <string>
+
+#include <assimp/scene.h>
+
+namespace dart {
+namespace dynamics {
+
+/// CookedMesh reads and writes precooked mesh files. A cooked file holds the
+/// triangles, normals and vertex colors of a mesh after Assimp has imported
+/// and post-processed it, so loading it does not need Assimp at all.
+///
+/// The file is a fixed header followed by one record per sub-mesh, each
+/// followed by its raw arrays. The arrays have the layout Assimp uses in
+/// memory, so each one is read with a single copy and nothing is parsed.
+/// The header stores the size and modification time of the source file. A
+/// cooked file is ignored once its source file changes.
+///
+/// Material properties are not cooked. Cooked meshes are rendered with the
+/// color of their shape or their vertex colors.
+class CookedMesh
+{
+public:
+  /// Get the name of the cooked copy of _fileName
+  static std::string getCookedFileName(const std::string& _fileName);
+
+  /// Import _fileName and write the result to getCookedFileName(_fileName).
+  /// Returns false if the file can not be imported or written.
+  static bool cook(const std::string& _fileName);
+
+  /// Write _mesh to _cookedFileName. _sourceFileName is the file _mesh was
+  /// imported from. Non-triangular faces are skipped.
+  static bool write(const aiScene* _mesh,
+                    const std::string& _sourceFileName,
+                    const std::string& _cookedFileName);
+
+  /// Read the mesh in _cookedFileName. Returns nullptr if the file does not
+  /// exist, is not a cooked mesh, or is older than _sourceFileName. The
+  /// caller takes ownership of the returned aiScene.
+  static const aiScene* read(const std::string& _cookedFileName,
+                             const std::string& _sourceFileName);
+
+  /// Return true if _cookedFileName can be used in place of _sourceFileName
+  static bool isUpToDate(const std::string& _cookedFileName,
+                         const std::string& _sourceFileName);
+};
+
+}  // namespace dynamics
+}  // namespace dart
+
+#endif  // DART_DYNAMICS_COOKEDMESH_H_
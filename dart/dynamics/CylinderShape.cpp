@@ -52,6 +52,13 @@ CylinderShape::CylinderShape(double _radius, double _height)
   computeVolume();
 }
 
+Shape* CylinderShape::clone() const {
+  CylinderShape* cylinder = new CylinderShape(mRadius, mHeight);
+  cylinder->setRGBA(mColor);
+  cylinder->setLocalTransform(mTransform);
+  return cylinder;
+}
+
 double CylinderShape::getRadius() const {
   return mRadius;
 }
@@ -50,6 +50,9 @@ public:
   /// \brief Constructor.
   CylinderShape(double _radius, double _height);
 
+  // Documentation inherited.
+  virtual Shape* clone() const;
+
   /// \brief
   double getRadius() const;
 
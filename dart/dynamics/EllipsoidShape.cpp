@@ -51,6 +51,13 @@ EllipsoidShape::EllipsoidShape(const Eigen::Vector3d& _size)
 EllipsoidShape::~EllipsoidShape() {
 }
 
+Shape* EllipsoidShape::clone() const {
+  EllipsoidShape* ellipsoid = new EllipsoidShape(mSize);
+  ellipsoid->setRGBA(mColor);
+  ellipsoid->setLocalTransform(mTransform);
+  return ellipsoid;
+}
+
 void EllipsoidShape::setDim(const Eigen::Vector3d& _size) {
   setSize(_size);
 }
@@ -52,6 +52,9 @@ public:
   /// \brief Destructor.
   virtual ~EllipsoidShape();
 
+  // Documentation inherited.
+  virtual Shape* clone() const;
+
   /// \brief Set size of this box.
   /// \warning Don't use me any more
   DEPRECATED(4.0)
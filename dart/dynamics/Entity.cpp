@@ -34,6 +34,8 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
 #include "dart/common/Console.h"
 #include "dart/dynamics/Entity.h"
 #include "dart/dynamics/Frame.h"
@@ -45,7 +47,7 @@ namespace dart {
 namespace dynamics {
 
 //==============================================================================
-typedef std::set<Entity*> EntityPtrSet;
+typedef std::vector<Entity*> EntityPtrArray;
 
 //==============================================================================
 template <typename T>
@@ -288,21 +290,20 @@ void Entity::changeParentFrame(Frame* _newParentFrame)
 
   const Frame* oldParentFrame = mParentFrame;
 
-  if (!mAmQuiet && nullptr != mParentFrame)
+  if (!mAmQuiet && nullptr != mParentFrame
+      && mParentFrame->mChildEntitySet.erase(this) > 0)
   {
-    EntityPtrSet::iterator it = mParentFrame->mChildEntities.find(this);
-    if (it != mParentFrame->mChildEntities.end())
-    {
-      mParentFrame->mChildEntities.erase(it);
-      mParentFrame->processRemovedEntity(this);
-    }
+    EntityPtrArray& siblings = mParentFrame->mChildEntities;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    mParentFrame->processRemovedEntity(this);
   }
 
   mParentFrame =_newParentFrame;
 
   if (!mAmQuiet && nullptr != mParentFrame)
   {
-    mParentFrame->mChildEntities.insert(this);
+    if (mParentFrame->mChildEntitySet.insert(this).second)
+      mParentFrame->mChildEntities.push_back(this);
     mParentFrame->processNewEntity(this);
     notifyTransformUpdate();
   }
@@ -60,6 +60,15 @@ EulerJoint::~EulerJoint()
 {
 }
 
+//==============================================================================
+Joint* EulerJoint::clone() const
+{
+  EulerJoint* joint = new EulerJoint(mName);
+  joint->setAxisOrder(mAxisOrder, false);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void EulerJoint::setAxisOrder(EulerJoint::AxisOrder _order, bool _renameDofs)
 {
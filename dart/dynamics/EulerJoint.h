@@ -61,6 +61,9 @@ public:
   /// Destructor
   virtual ~EulerJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   /// Set the axis order
   /// \param[in] _order Axis order
   /// \param[in] _renameDofs If true, the names of dofs in this joint will be
@@ -35,6 +35,9 @@
  */
 
 #include "dart/dynamics/Frame.h"
+
+#include <algorithm>
+
 #include "dart/dynamics/Shape.h"
 #include "dart/renderer/RenderInterface.h"
 #include "dart/common/Console.h"
@@ -42,8 +45,8 @@
 namespace dart {
 namespace dynamics {
 
-typedef std::set<Entity*> EntityPtrSet;
-typedef std::set<Frame*> FramePtrSet;
+typedef std::vector<Entity*> EntityPtrArray;
+typedef std::vector<Frame*> FramePtrArray;
 
 //==============================================================================
 Frame::Frame(Frame* _refFrame, const std::string& _name)
@@ -66,18 +69,12 @@ Frame::~Frame()
 
   // Inform all child entities that this Frame is disappearing by setting their
   // reference frames to the World frame.
-  EntityPtrSet::iterator it=mChildEntities.begin(), end=mChildEntities.end();
-  while( it != end )
-    (*(it++))->changeParentFrame(Frame::World());
+  const EntityPtrArray children = mChildEntities;
+  for(Entity* entity : children)
+    entity->changeParentFrame(Frame::World());
   // Note: When we instruct an Entity to change its parent Frame, it will erase
-  // itself from this Frame's mChildEntities list. This would invalidate the
-  // 'it' and clobber our attempt to iterate through the std::set if we applied
-  // changeParentFrame(~) directly to the 'it' iterator. So instead we use the
-  // post-increment operator to iterate 'it' forward and we apply
-  // changeParentFrame(~) to the temporary iterator created by the
-  // post-increment operator. Put simply: we increment 'it' forward once and
-  // then apply changeParentFrame(~) to the pointer that 'it' held just before
-  // it incremented.
+  // itself from this Frame's mChildEntities list, which would invalidate any
+  // iterator into it. So we iterate over a copy of the list instead.
 
   // Free the memory of the visualization shapes
   for(size_t i=0; i<mVizShapes.size(); ++i)
@@ -377,27 +374,42 @@ Eigen::Vector3d Frame::getAngularAcceleration(
   return getSpatialAcceleration(_relativeTo, _inCoordinatesOf).head<3>();
 }
 
+//==============================================================================
+template <typename T>
+static std::vector<const T*> convertToConstArray(const std::vector<T*>& _array)
+{
+  return std::vector<const T*>(_array.begin(), _array.end());
+}
+
 //==============================================================================
 template <typename T>
 static std::set<const T*> convertToConstSet(const std::set<T*>& _set)
 {
-  std::set<const T*> const_set;
-  for(const auto& element : _set)
-    const_set.insert(element);
+  return std::set<const T*>(_set.begin(), _set.end());
+}
+
+//==============================================================================
+const std::vector<Entity*>& Frame::getChildEntityArray()
+{
+  return mChildEntities;
+}
 
-  return const_set;
+//==============================================================================
+std::vector<const Entity*> Frame::getChildEntityArray() const
+{
+  return convertToConstArray<Entity>(mChildEntities);
 }
 
 //==============================================================================
 const std::set<Entity*>& Frame::getChildEntities()
 {
-  return mChildEntities;
+  return mChildEntitySet;
 }
 
 //==============================================================================
-const std::set<const Entity*> Frame::getChildEntities() const
+std::set<const Entity*> Frame::getChildEntities() const
 {
-  return convertToConstSet<Entity>(mChildEntities);
+  return convertToConstSet<Entity>(mChildEntitySet);
 }
 
 //==============================================================================
@@ -407,15 +419,27 @@ size_t Frame::getNumChildEntities() const
 }
 
 //==============================================================================
-const std::set<Frame*>& Frame::getChildFrames()
+const std::vector<Frame*>& Frame::getChildFrameArray()
 {
   return mChildFrames;
 }
 
+//==============================================================================
+std::vector<const Frame*> Frame::getChildFrameArray() const
+{
+  return convertToConstArray<Frame>(mChildFrames);
+}
+
+//==============================================================================
+const std::set<Frame*>& Frame::getChildFrames()
+{
+  return mChildFrameSet;
+}
+
 //==============================================================================
 std::set<const Frame*> Frame::getChildFrames() const
 {
-  return convertToConstSet<Frame>(mChildFrames);
+  return convertToConstSet<Frame>(mChildFrameSet);
 }
 
 //==============================================================================
@@ -532,11 +556,10 @@ void Frame::changeParentFrame(Frame* _newParentFrame)
     }
   }
 
-  if(mParentFrame)
+  if(mParentFrame && mParentFrame->mChildFrameSet.erase(this) > 0)
   {
-    FramePtrSet::iterator it = mParentFrame->mChildFrames.find(this);
-    if(it != mParentFrame->mChildFrames.end())
-      mParentFrame->mChildFrames.erase(it);
+    FramePtrArray& siblings = mParentFrame->mChildFrames;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), this));
   }
 
   if(nullptr==_newParentFrame)
@@ -545,8 +568,8 @@ void Frame::changeParentFrame(Frame* _newParentFrame)
     return;
   }
 
-  if(!mAmQuiet)
-    _newParentFrame->mChildFrames.insert(this);
+  if(!mAmQuiet && _newParentFrame->mChildFrameSet.insert(this).second)
+    _newParentFrame->mChildFrames.push_back(this);
   Entity::changeParentFrame(_newParentFrame);
 }
 
@@ -38,9 +38,11 @@
 #define DART_DYNAMICS_FRAME_H_
 
 #include <set>
+#include <vector>
 
 #include <Eigen/Geometry>
 
+#include "dart/common/Deprecated.h"
 #include "dart/dynamics/Entity.h"
 #include "dart/math/MathTypes.h"
 
@@ -196,29 +198,48 @@ public:
   // Relationships
   //--------------------------------------------------------------------------
 
-  /// Get a container with the Entities that are children of this Frame.
-  /// std::set is used because Entities may be arbitrarily added and removed
-  /// from a parent Frame, and each entry should be unique. std::set makes this
-  /// procedure easier.
-  const std::set<Entity*>& getChildEntities();
+  /// Get a container with the Entities that are children of this Frame, in
+  /// the order they were added. Each entry is unique. A flat array is used
+  /// because the children are visited on every state change, while Entities
+  /// are only rarely added or removed.
+  const std::vector<Entity*>& getChildEntityArray();
 
   /// Get a container with the Entities that are children of this Frame. Note
   /// that this is version is slightly less efficient than the non-const version
-  /// because it needs to rebuild a set where each pointer is converted to be a
-  /// const pointer.
-  const std::set<const Entity*> getChildEntities() const;
+  /// because it needs to rebuild an array where each pointer is converted to be
+  /// a const pointer.
+  std::vector<const Entity*> getChildEntityArray() const;
+
+  /// Get a set with the Entities that are children of this Frame. Use
+  /// getChildEntityArray() instead.
+  DEPRECATED(4.3)
+  const std::set<Entity*>& getChildEntities();
+
+  /// Get a set with the Entities that are children of this Frame, converted
+  /// to const pointers. Use getChildEntityArray() instead.
+  DEPRECATED(4.3)
+  std::set<const Entity*> getChildEntities() const;
 
   /// Get the number of Entities that are currently children of this Frame.
   size_t getNumChildEntities() const;
 
-  /// Get a container with the Frames that are children of this Frame.
-  /// std::set is used because Frames may be arbitrarily added and removed
-  /// from a parent Frame, and each entry should be unique.
-  const std::set<Frame*>& getChildFrames();
+  /// Get a container with the Frames that are children of this Frame, in the
+  /// order they were added. Each entry is unique.
+  const std::vector<Frame*>& getChildFrameArray();
 
   /// Get a container with the Frames that are children of this Frame. Note
   /// that this version is less efficient than the non-const version because
-  /// it needs to rebuild a set so that the entries are const.
+  /// it needs to rebuild an array so that the entries are const.
+  std::vector<const Frame*> getChildFrameArray() const;
+
+  /// Get a set with the Frames that are children of this Frame. Use
+  /// getChildFrameArray() instead.
+  DEPRECATED(4.3)
+  const std::set<Frame*>& getChildFrames();
+
+  /// Get a set with the Frames that are children of this Frame, converted to
+  /// const pointers. Use getChildFrameArray() instead.
+  DEPRECATED(4.3)
   std::set<const Frame*> getChildFrames() const;
 
   /// Get the number of Frames that are currently children of this Frame.
@@ -281,10 +302,17 @@ protected:
   mutable Eigen::Vector6d mAcceleration;
 
   /// Container of this Frame's child Frames.
-  std::set<Frame*> mChildFrames;
+  std::vector<Frame*> mChildFrames;
 
   /// Container of this Frame's child Entities.
-  std::set<Entity*> mChildEntities;
+  std::vector<Entity*> mChildEntities;
+
+  /// Set with the same Frames as mChildFrames, kept for getChildFrames()
+  std::set<Frame*> mChildFrameSet;
+
+  /// Set with the same Entities as mChildEntities, kept for
+  /// getChildEntities()
+  std::set<Entity*> mChildEntitySet;
 
 private:
   /// Contains whether or not this is the World Frame
@@ -57,6 +57,14 @@ FreeJoint::~FreeJoint()
 {
 }
 
+//==============================================================================
+Joint* FreeJoint::clone() const
+{
+  FreeJoint* joint = new FreeJoint(mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 Eigen::Vector6d FreeJoint::convertToPositions(const Eigen::Isometry3d& _tf)
 {
@@ -127,6 +135,9 @@ void FreeJoint::integratePositions(double _dt)
 {
   const Eigen::Vector6d& velocities = getVelocitiesStatic();
 
+  // The positions may have been written through the state buffer of the
+  // Skeleton, so mQ is not trusted here
+  mQ = convertToTransform(getPositionsStatic());
   mQ.linear() = mQ.linear()
                 * math::expMapRot(getLocalJacobianStatic().topLeftCorner<3,3>()
                                   * velocities.head<3>() * _dt);
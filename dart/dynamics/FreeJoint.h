@@ -56,6 +56,9 @@ public:
   /// Destructor
   virtual ~FreeJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   /// Convert a transform into a 6D vector that can be used to set the positions
   /// of a FreeJoint. The positions returned by this function will result in a
   /// relative transform of
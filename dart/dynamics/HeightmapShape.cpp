@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/HeightmapShape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dart/common/Console.h"
+#include "dart/renderer/RenderInterface.h"
+
+namespace dart {
+namespace dynamics {
+
+//==============================================================================
+static std::shared_ptr<const float> copyHeights(
+    const std::vector<float>& _heights)
+{
+  float* heights = new float[_heights.size()];
+  std::copy(_heights.begin(), _heights.end(), heights);
+  return std::shared_ptr<const float>(heights, std::default_delete<float[]>());
+}
+
+//==============================================================================
+HeightmapShape::HeightmapShape(size_t _numRows, size_t _numCols,
+                               const std::vector<float>& _heights,
+                               const Eigen::Vector3d& _scale)
+  : Shape(HEIGHTMAP),
+    mNumRows(_numRows),
+    mNumCols(_numCols),
+    mHeights(copyHeights(_heights)),
+    mScale(_scale)
+{
+  assert(_numRows >= 2 && _numCols >= 2);
+  assert(_heights.size() == _numRows * _numCols);
+  assert(_scale[0] > 0.0);
+  assert(_scale[1] > 0.0);
+  assert(_scale[2] > 0.0);
+  updateBounds();
+  computeVolume();
+}
+
+//==============================================================================
+HeightmapShape::HeightmapShape(size_t _numRows, size_t _numCols,
+                               const std::shared_ptr<const float>& _heights,
+                               const Eigen::Vector3d& _scale)
+  : Shape(HEIGHTMAP),
+    mNumRows(_numRows),
+    mNumCols(_numCols),
+    mHeights(_heights),
+    mScale(_scale)
+{
+  assert(_numRows >= 2 && _numCols >= 2);
+  assert(_heights != nullptr);
+  assert(_scale[0] > 0.0);
+  assert(_scale[1] > 0.0);
+  assert(_scale[2] > 0.0);
+  updateBounds();
+  computeVolume();
+}
+
+//==============================================================================
+HeightmapShape::~HeightmapShape()
+{
+}
+
+//==============================================================================
+Shape* HeightmapShape::clone() const
+{
+  HeightmapShape* heightmap
+      = new HeightmapShape(mNumRows, mNumCols, mHeights, mScale);
+  heightmap->setRGBA(mColor);
+  heightmap->setLocalTransform(mTransform);
+  return heightmap;
+}
+
+//==============================================================================
+void HeightmapShape::draw(renderer::RenderInterface* _ri,
+                          const Eigen::Vector4d& _color,
+                          bool _useDefaultColor) const
+{
+  if (!_ri)
+    return;
+
+  if (!_useDefaultColor)
+    _ri->setPenColor(_color);
+  else
+    _ri->setPenColor(mColor);
+  _ri->pushMatrix();
+  _ri->transform(mTransform);
+  _ri->drawHeightmap(mNumRows, mNumCols, mHeights.get(), mScale);
+  _ri->popMatrix();
+}
+
+//==============================================================================
+Eigen::Matrix3d HeightmapShape::computeInertia(double _mass) const
+{
+  const double l = mBoundingBoxDim[0];
+  const double h = mBoundingBoxDim[1];
+  const double w = mBoundingBoxDim[2];
+
+  Eigen::Matrix3d inertia = Eigen::Matrix3d::Identity();
+  inertia(0, 0) = _mass / 12.0 * (h * h + w * w);
+  inertia(1, 1) = _mass / 12.0 * (l * l + w * w);
+  inertia(2, 2) = _mass / 12.0 * (l * l + h * h);
+
+  return inertia;
+}
+
+//==============================================================================
+size_t HeightmapShape::getNumRows() const
+{
+  return mNumRows;
+}
+
+//==============================================================================
+size_t HeightmapShape::getNumCols() const
+{
+  return mNumCols;
+}
+
+//==============================================================================
+const float* HeightmapShape::getHeights() const
+{
+  return mHeights.get();
+}
+
+//==============================================================================
+const std::shared_ptr<const float>& HeightmapShape::getSharedHeights() const
+{
+  return mHeights;
+}
+
+//==============================================================================
+float HeightmapShape::getHeight(size_t _row, size_t _col) const
+{
+  assert(_row < mNumRows && _col < mNumCols);
+  return mHeights.get()[_row * mNumCols + _col];
+}
+
+//==============================================================================
+void HeightmapShape::setScale(const Eigen::Vector3d& _scale)
+{
+  assert(_scale[0] > 0.0);
+  assert(_scale[1] > 0.0);
+  assert(_scale[2] > 0.0);
+  mScale = _scale;
+  updateBounds();
+  computeVolume();
+}
+
+//==============================================================================
+const Eigen::Vector3d& HeightmapShape::getScale() const
+{
+  return mScale;
+}
+
+//==============================================================================
+double HeightmapShape::getMinHeight() const
+{
+  return mMinHeight * mScale[2];
+}
+
+//==============================================================================
+double HeightmapShape::getMaxHeight() const
+{
+  return mMaxHeight * mScale[2];
+}
+
+//==============================================================================
+Eigen::Vector3d HeightmapShape::getVertex(size_t _row, size_t _col) const
+{
+  return Eigen::Vector3d(
+        (_col - 0.5 * (mNumCols - 1)) * mScale[0],
+        (_row - 0.5 * (mNumRows - 1)) * mScale[1],
+        getHeight(_row, _col) * mScale[2]);
+}
+
+//==============================================================================
+bool HeightmapShape::computeHeight(double _x, double _y, double* _height,
+                                   Eigen::Vector3d* _normal) const
+{
+  // Position in units of cells from sample (0, 0)
+  const double u = _x / mScale[0] + 0.5 * (mNumCols - 1);
+  const double v = _y / mScale[1] + 0.5 * (mNumRows - 1);
+  if (!(u >= 0.0 && u <= mNumCols - 1 && v >= 0.0 && v <= mNumRows - 1))
+    return false;
+
+  const size_t col = std::min(static_cast<size_t>(u), mNumCols - 2);
+  const size_t row = std::min(static_cast<size_t>(v), mNumRows - 2);
+  const double fu = u - col;
+  const double fv = v - row;
+
+  const double h00 = getHeight(row, col);
+  const double h01 = getHeight(row, col + 1);
+  const double h10 = getHeight(row + 1, col);
+  const double h11 = getHeight(row + 1, col + 1);
+
+  // Slopes of the triangle along x and y
+  double dhdu;
+  double dhdv;
+  if (fu >= fv)
+  {
+    dhdu = h01 - h00;
+    dhdv = h11 - h01;
+  }
+  else
+  {
+    dhdu = h11 - h10;
+    dhdv = h10 - h00;
+  }
+
+  *_height = (h00 + fu * dhdu + fv * dhdv) * mScale[2];
+
+  if (_normal)
+  {
+    *_normal = Eigen::Vector3d(-dhdu * mScale[2] / mScale[0],
+                               -dhdv * mScale[2] / mScale[1],
+                               1.0).normalized();
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool HeightmapShape::getCellRange(const Eigen::Vector2d& _min,
+                                  const Eigen::Vector2d& _max,
+                                  size_t* _rowBegin, size_t* _colBegin,
+                                  size_t* _rowEnd, size_t* _colEnd) const
+{
+  const double uMin = _min[0] / mScale[0] + 0.5 * (mNumCols - 1);
+  const double uMax = _max[0] / mScale[0] + 0.5 * (mNumCols - 1);
+  const double vMin = _min[1] / mScale[1] + 0.5 * (mNumRows - 1);
+  const double vMax = _max[1] / mScale[1] + 0.5 * (mNumRows - 1);
+  if (uMax < 0.0 || vMax < 0.0
+      || uMin > mNumCols - 1 || vMin > mNumRows - 1)
+  {
+    return false;
+  }
+
+  *_colBegin = static_cast<size_t>(std::max(std::floor(uMin), 0.0));
+  *_rowBegin = static_cast<size_t>(std::max(std::floor(vMin), 0.0));
+  *_colEnd = std::min(static_cast<size_t>(std::floor(uMax)) + 1,
+                      mNumCols - 1);
+  *_rowEnd = std::min(static_cast<size_t>(std::floor(vMax)) + 1,
+                      mNumRows - 1);
+
+  // A rectangle on the far edge of the grid still touches the last cell
+  *_colBegin = std::min(*_colBegin, mNumCols - 2);
+  *_rowBegin = std::min(*_rowBegin, mNumRows - 2);
+
+  return true;
+}
+
+//==============================================================================
+std::shared_ptr<const float> HeightmapShape::loadHeights(
+    const std::string& _fileName, size_t _numHeights)
+{
+  const size_t size = _numHeights * sizeof(float);
+
+#ifndef _WIN32
+  int fd = ::open(_fileName.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat status;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= size
+        && size > 0)
+    {
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (data != MAP_FAILED)
+    {
+      return std::shared_ptr<const float>(
+            static_cast<const float*>(data),
+            [size](const float* _data)
+            { munmap(const_cast<float*>(_data), size); });
+    }
+  }
+#endif
+
+  std::ifstream file(_fileName.c_str(), std::ios::binary);
+  std::vector<float> heights(_numHeights);
+  if (!file
+      || !file.read(reinterpret_cast<char*>(heights.data()), size))
+  {
+    dterr << "[HeightmapShape::loadHeights] Fail to read " << _numHeights
+          << " heights from [" << _fileName << "].\n";
+    return nullptr;
+  }
+
+  return copyHeights(heights);
+}
+
+//==============================================================================
+void HeightmapShape::computeVolume()
+{
+  // Use bounding box to represent the terrain
+  mVolume = mBoundingBoxDim[0] * mBoundingBoxDim[1] * mBoundingBoxDim[2];
+}
+
+//==============================================================================
+void HeightmapShape::updateBounds()
+{
+  const float* heights = mHeights.get();
+  const float* end = heights + mNumRows * mNumCols;
+  mMinHeight = *std::min_element(heights, end);
+  mMaxHeight = *std::max_element(heights, end);
+
+  mBoundingBoxDim[0] = (mNumCols - 1) * mScale[0];
+  mBoundingBoxDim[1] = (mNumRows - 1) * mScale[1];
+  mBoundingBoxDim[2] = (mMaxHeight - mMinHeight) * mScale[2];
+}
+
+}  // namespace dynamics
+}  // namespace dart
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_HEIGHTMAPSHAPE_H_
+#define DART_DYNAMICS_HEIGHTMAPSHAPE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dart/dynamics/Shape.h"
+
+namespace dart {
+namespace dynamics {
+
+/// HeightmapShape represents a terrain by its heights on a regular grid. The
+/// grid lies on the xy-plane of the shape frame, centered at the origin, and
+/// the heights are along the z-axis. Sample (row, col) is at
+/// x = (col - (numCols - 1) / 2) * scale.x and
+/// y = (row - (numRows - 1) / 2) * scale.y, and its height is
+/// heights[row * numCols + col] * scale.z.
+///
+/// Each cell of the grid is split into two triangles along the diagonal from
+/// sample (row, col) to sample (row + 1, col + 1).
+///
+/// The heights are stored as floats and can be shared with other shapes,
+/// including clones. loadHeights() maps a file of heights into memory, so
+/// that a large terrain can be split into tiles that are backed by files
+/// rather than copies in memory.
+class HeightmapShape : public Shape
+{
+public:
+  /// Constructor. _heights holds _numRows * _numCols heights in row-major
+  /// order, and the grid needs at least two rows and two columns.
+  HeightmapShape(size_t _numRows, size_t _numCols,
+                 const std::vector<float>& _heights,
+                 const Eigen::Vector3d& _scale = Eigen::Vector3d::Ones());
+
+  /// Constructor. _heights may be shared with other shapes, and it may be
+  /// mapped from a file by loadHeights().
+  HeightmapShape(size_t _numRows, size_t _numCols,
+                 const std::shared_ptr<const float>& _heights,
+                 const Eigen::Vector3d& _scale = Eigen::Vector3d::Ones());
+
+  /// Destructor
+  virtual ~HeightmapShape();
+
+  // Documentation inherited.
+  virtual Shape* clone() const override;
+
+  // Documentation inherited.
+  void draw(renderer::RenderInterface* _ri = NULL,
+            const Eigen::Vector4d& _col = Eigen::Vector4d::Ones(),
+            bool _default = true) const;
+
+  /// The inertia is that of the bounding box of the terrain
+  virtual Eigen::Matrix3d computeInertia(double _mass) const;
+
+  /// Get the number of rows of the grid, i.e., of samples along y
+  size_t getNumRows() const;
+
+  /// Get the number of columns of the grid, i.e., of samples along x
+  size_t getNumCols() const;
+
+  /// Get the unscaled heights in row-major order
+  const float* getHeights() const;
+
+  /// Get the storage of the heights
+  const std::shared_ptr<const float>& getSharedHeights() const;
+
+  /// Get the unscaled height of sample (_row, _col)
+  float getHeight(size_t _row, size_t _col) const;
+
+  /// Set the spacing of the samples along x and y, and the scale of the
+  /// heights
+  void setScale(const Eigen::Vector3d& _scale);
+
+  /// Get the spacing of the samples along x and y, and the scale of the
+  /// heights
+  const Eigen::Vector3d& getScale() const;
+
+  /// Get the lowest scaled height
+  double getMinHeight() const;
+
+  /// Get the highest scaled height
+  double getMaxHeight() const;
+
+  /// Get the position of sample (_row, _col) in the shape frame
+  Eigen::Vector3d getVertex(size_t _row, size_t _col) const;
+
+  /// Compute the height of the terrain at (_x, _y), and the upward unit normal
+  /// of the triangle there if _normal is not NULL. Return false if the point
+  /// is outside of the grid.
+  bool computeHeight(double _x, double _y, double* _height,
+                     Eigen::Vector3d* _normal = NULL) const;
+
+  /// Get the range of cells that overlap the rectangle [_min, _max] of the
+  /// xy-plane. Cells from (_rowBegin, _colBegin) to (_rowEnd - 1,
+  /// _colEnd - 1) overlap it. Return false if no cell does.
+  bool getCellRange(const Eigen::Vector2d& _min, const Eigen::Vector2d& _max,
+                    size_t* _rowBegin, size_t* _colBegin,
+                    size_t* _rowEnd, size_t* _colEnd) const;
+
+  /// Load _numHeights floats of the native byte order from a raw file. The
+  /// file is mapped into memory where that is supported, and it is read
+  /// otherwise. Return NULL if the file can not be read or is too small.
+  static std::shared_ptr<const float> loadHeights(
+      const std::string& _fileName, size_t _numHeights);
+
+protected:
+  // Documentation inherited.
+  void computeVolume();
+
+  /// Update the height range and the bounding box
+  void updateBounds();
+
+  /// Number of samples along y
+  size_t mNumRows;
+
+  /// Number of samples along x
+  size_t mNumCols;
+
+  /// Unscaled heights in row-major order
+  std::shared_ptr<const float> mHeights;
+
+  /// Spacing of the samples along x and y, and scale of the heights
+  Eigen::Vector3d mScale;
+
+  /// Lowest unscaled height
+  float mMinHeight;
+
+  /// Highest unscaled height
+  float mMaxHeight;
+
+public:
+  // To get byte-aligned Eigen vectors
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+}  // namespace dynamics
+}  // namespace dart
+
+#endif  // DART_DYNAMICS_HEIGHTMAPSHAPE_H_
@@ -0,0 +1,559 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/InverseKinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "dart/common/Console.h"
+#include "dart/math/Geometry.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/Skeleton.h"
+
+namespace dart {
+namespace dynamics {
+
+//==============================================================================
+InverseKinematics::InverseKinematics(Skeleton* _skeleton)
+  : mSkeleton(_skeleton),
+    mUseAllDofs(true),
+    mMaxIterations(100),
+    mTolerance(1e-6),
+    mDamping(1e-2),
+    mMaxStepSize(0.5),
+    mRespectLimits(true),
+    mLastError(0.0),
+    mLastNumIterations(0)
+{
+  assert(mSkeleton != nullptr);
+}
+
+//==============================================================================
+InverseKinematics::~InverseKinematics()
+{
+}
+
+//==============================================================================
+Skeleton* InverseKinematics::getSkeleton() const
+{
+  return mSkeleton;
+}
+
+//==============================================================================
+size_t InverseKinematics::addTarget(BodyNode* _bodyNode,
+                                    const Eigen::Isometry3d& _transform,
+                                    const Eigen::Vector3d& _offset,
+                                    const Eigen::Vector6d& _weights)
+{
+  assert(_bodyNode != nullptr);
+  assert(_bodyNode->getSkeleton() == mSkeleton);
+
+  Target target;
+  target.mBodyNode  = _bodyNode;
+  target.mOffset    = _offset;
+  target.mTransform = _transform;
+  target.mWeights   = _weights;
+  mTargets.push_back(target);
+
+  return mTargets.size() - 1;
+}
+
+//==============================================================================
+void InverseKinematics::setTargetTransform(size_t _index,
+                                           const Eigen::Isometry3d& _transform)
+{
+  assert(_index < mTargets.size());
+  mTargets[_index].mTransform = _transform;
+}
+
+//==============================================================================
+void InverseKinematics::setTargetWeights(size_t _index,
+                                         const Eigen::Vector6d& _weights)
+{
+  assert(_index < mTargets.size());
+  mTargets[_index].mWeights = _weights;
+}
+
+//==============================================================================
+const InverseKinematics::Target& InverseKinematics::getTarget(
+    size_t _index) const
+{
+  assert(_index < mTargets.size());
+  return mTargets[_index];
+}
+
+//==============================================================================
+size_t InverseKinematics::getNumTargets() const
+{
+  return mTargets.size();
+}
+
+//==============================================================================
+void InverseKinematics::clearTargets()
+{
+  mTargets.clear();
+}
+
+//==============================================================================
+void InverseKinematics::setDofs(const std::vector<size_t>& _dofs)
+{
+  mUseAllDofs = false;
+  mDofs = _dofs;
+}
+
+//==============================================================================
+void InverseKinematics::useAllDofs()
+{
+  mUseAllDofs = true;
+  mDofs.clear();
+}
+
+//==============================================================================
+const std::vector<size_t>& InverseKinematics::getDofs() const
+{
+  return mDofs;
+}
+
+//==============================================================================
+void InverseKinematics::setMaxIterations(size_t _maxIterations)
+{
+  mMaxIterations = _maxIterations;
+}
+
+//==============================================================================
+size_t InverseKinematics::getMaxIterations() const
+{
+  return mMaxIterations;
+}
+
+//==============================================================================
+void InverseKinematics::setTolerance(double _tolerance)
+{
+  assert(_tolerance >= 0.0);
+  mTolerance = _tolerance;
+}
+
+//==============================================================================
+double InverseKinematics::getTolerance() const
+{
+  return mTolerance;
+}
+
+//==============================================================================
+void InverseKinematics::setDamping(double _damping)
+{
+  assert(_damping > 0.0);
+  mDamping = _damping;
+}
+
+//==============================================================================
+double InverseKinematics::getDamping() const
+{
+  return mDamping;
+}
+
+//==============================================================================
+void InverseKinematics::setMaxStepSize(double _maxStepSize)
+{
+  assert(_maxStepSize > 0.0);
+  mMaxStepSize = _maxStepSize;
+}
+
+//==============================================================================
+double InverseKinematics::getMaxStepSize() const
+{
+  return mMaxStepSize;
+}
+
+//==============================================================================
+void InverseKinematics::setRespectLimits(bool _respectLimits)
+{
+  mRespectLimits = _respectLimits;
+}
+
+//==============================================================================
+bool InverseKinematics::isRespectingLimits() const
+{
+  return mRespectLimits;
+}
+
+//==============================================================================
+bool InverseKinematics::solve()
+{
+  mLastNumIterations = 0;
+
+  if (mTargets.empty())
+  {
+    mLastError = 0.0;
+    return true;
+  }
+
+  prepare();
+
+  const size_t numDofs = mDofs.size();
+  readPositions(mPositions);
+
+  double error = computeError();
+  double damping = mDamping;
+
+  for (size_t i = 0; i < mMaxIterations && error > mTolerance; ++i)
+  {
+    ++mLastNumIterations;
+
+    computeJacobian();
+
+    // Solve the damped least squares problem, (J^T J + d^2 I) dq = J^T e, in
+    // whichever of its two equivalent forms has the smaller normal matrix.
+    // When the candidate step would push a DOF through its limit, the DOF is
+    // pinned by removing its column and the step is computed once more.
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      if (mJacobian.rows() <= mJacobian.cols())
+      {
+        mNormalMatrix.noalias() = mJacobian * mJacobian.transpose();
+        mNormalMatrix.diagonal().array() += damping * damping;
+        mFactorization.compute(mNormalMatrix);
+        mWork = mFactorization.solve(mError);
+        mStep.noalias() = mJacobian.transpose() * mWork;
+      }
+      else
+      {
+        mNormalMatrix.noalias() = mJacobian.transpose() * mJacobian;
+        mNormalMatrix.diagonal().array() += damping * damping;
+        mFactorization.compute(mNormalMatrix);
+        mWork.noalias() = mJacobian.transpose() * mError;
+        mStep = mFactorization.solve(mWork);
+      }
+
+      const double maxStep = mStep.cwiseAbs().maxCoeff();
+      if (maxStep > mMaxStepSize)
+        mStep *= mMaxStepSize / maxStep;
+
+      mCandidate = mPositions + mStep;
+
+      if (!mRespectLimits)
+        break;
+
+      bool pinned = false;
+      for (size_t j = 0; j < numDofs; ++j)
+      {
+        if (mCandidate[j] < mLowerLimits[j])
+        {
+          mCandidate[j] = mLowerLimits[j];
+          mJacobian.col(j).setZero();
+          pinned = true;
+        }
+        else if (mCandidate[j] > mUpperLimits[j])
+        {
+          mCandidate[j] = mUpperLimits[j];
+          mJacobian.col(j).setZero();
+          pinned = true;
+        }
+      }
+
+      if (!pinned)
+        break;
+    }
+
+    if (mRespectLimits)
+    {
+      mCandidate = mCandidate.cwiseMax(mLowerLimits).cwiseMin(mUpperLimits);
+    }
+
+    writePositions(mCandidate);
+    const double candidateError = computeError();
+
+    if (candidateError < error)
+    {
+      // Accept the step and move toward Gauss-Newton
+      mPositions = mCandidate;
+      error = candidateError;
+      damping = std::max(0.5 * damping, 1e-8);
+    }
+    else
+    {
+      // Reject the step and move toward gradient descent
+      writePositions(mPositions);
+      error = computeError();
+      damping *= 4.0;
+
+      if (damping > 1e8)
+        break;
+    }
+  }
+
+  mLastError = error;
+
+  return error <= mTolerance;
+}
+
+//==============================================================================
+bool InverseKinematics::solve(const Eigen::VectorXd& _initialPositions)
+{
+  if (static_cast<size_t>(_initialPositions.size()) != mSkeleton->getNumDofs())
+  {
+    dterr << "[InverseKinematics::solve] The size of the initial positions ("
+          << _initialPositions.size() << ") does not match the number of "
+          << "DOFs of Skeleton [" << mSkeleton->getName() << "] ("
+          << mSkeleton->getNumDofs() << ").\n";
+    return false;
+  }
+
+  mSkeleton->setPositions(_initialPositions);
+
+  return solve();
+}
+
+//==============================================================================
+double InverseKinematics::getError() const
+{
+  return mLastError;
+}
+
+//==============================================================================
+size_t InverseKinematics::getNumIterations() const
+{
+  return mLastNumIterations;
+}
+
+//==============================================================================
+size_t InverseKinematics::solveBatch(
+    const std::vector<Skeleton*>& _workers,
+    const std::vector<Eigen::Isometry3d>& _transforms,
+    std::vector<Eigen::VectorXd>& _solutions,
+    std::vector<double>* _errors) const
+{
+  _solutions.resize(_transforms.size());
+  if (_errors)
+    _errors->resize(_transforms.size());
+
+  if (_workers.empty())
+  {
+    dterr << "[InverseKinematics::solveBatch] At least one worker Skeleton is "
+          << "required.\n";
+    return 0;
+  }
+
+  if (mTargets.empty())
+  {
+    dterr << "[InverseKinematics::solveBatch] The solver has no target.\n";
+    return 0;
+  }
+
+  // Make sure every worker can hold the problem before spawning threads
+  for (size_t i = 0; i < _workers.size(); ++i)
+  {
+    const Skeleton* worker = _workers[i];
+
+    bool compatible = worker->getNumDofs() == mSkeleton->getNumDofs();
+    for (size_t j = 0; compatible && j < mTargets.size(); ++j)
+    {
+      compatible = worker->getBodyNode(mTargets[j].mBodyNode->getName())
+                   != nullptr;
+    }
+
+    if (!compatible)
+    {
+      dterr << "[InverseKinematics::solveBatch] Worker Skeleton #" << i
+            << " [" << worker->getName() << "] does not match Skeleton ["
+            << mSkeleton->getName() << "].\n";
+      return 0;
+    }
+  }
+
+  const Eigen::VectorXd seed = mSkeleton->getPositions();
+  const int numProblems = static_cast<int>(_transforms.size());
+  const int numWorkers = static_cast<int>(_workers.size());
+  int numConverged = 0;
+
+#pragma omp parallel num_threads(numWorkers) reduction(+:numConverged)
+  {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+    // Each thread owns a solver, so its workspace is reused across problems
+    InverseKinematics ik(_workers[thread]);
+    ik.copySettingsFrom(*this);
+
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < numProblems; ++i)
+    {
+      ik.setTargetTransform(0, _transforms[i]);
+
+      if (ik.solve(seed))
+        ++numConverged;
+
+      _solutions[i] = ik.mSkeletonPositions;
+      if (_errors)
+        (*_errors)[i] = ik.mLastError;
+    }
+  }
+
+  return static_cast<size_t>(numConverged);
+}
+
+//==============================================================================
+void InverseKinematics::prepare()
+{
+  const size_t numSkelDofs = mSkeleton->getNumDofs();
+
+  if (mUseAllDofs && mDofs.size() != numSkelDofs)
+  {
+    mDofs.resize(numSkelDofs);
+    for (size_t i = 0; i < numSkelDofs; ++i)
+      mDofs[i] = i;
+  }
+
+  const size_t numDofs = mDofs.size();
+  const size_t numRows = 6 * mTargets.size();
+
+  mDofColumns.assign(numSkelDofs, -1);
+  mLowerLimits.resize(numDofs);
+  mUpperLimits.resize(numDofs);
+  for (size_t i = 0; i < numDofs; ++i)
+  {
+    assert(mDofs[i] < numSkelDofs);
+    const DegreeOfFreedom* dof = mSkeleton->getDof(mDofs[i]);
+    mDofColumns[mDofs[i]] = static_cast<int>(i);
+    mLowerLimits[i] = dof->getPositionLowerLimit();
+    mUpperLimits[i] = dof->getPositionUpperLimit();
+  }
+
+  // These are no-ops unless the problem size changed since the last solve
+  mJacobian.resize(numRows, numDofs);
+  mError.resize(numRows);
+  mSkeletonPositions.resize(numSkelDofs);
+  for (size_t i = 0; i < numSkelDofs; ++i)
+    mSkeletonPositions[i] = mSkeleton->getDof(i)->getPosition();
+}
+
+//==============================================================================
+bool InverseKinematics::copySettingsFrom(const InverseKinematics& _other)
+{
+  mTargets.clear();
+  for (size_t i = 0; i < _other.mTargets.size(); ++i)
+  {
+    const Target& target = _other.mTargets[i];
+    BodyNode* bodyNode = mSkeleton->getBodyNode(target.mBodyNode->getName());
+    if (nullptr == bodyNode)
+      return false;
+
+    addTarget(bodyNode, target.mTransform, target.mOffset, target.mWeights);
+  }
+
+  mUseAllDofs    = _other.mUseAllDofs;
+  mDofs          = _other.mDofs;
+  mMaxIterations = _other.mMaxIterations;
+  mTolerance     = _other.mTolerance;
+  mDamping       = _other.mDamping;
+  mMaxStepSize   = _other.mMaxStepSize;
+  mRespectLimits = _other.mRespectLimits;
+
+  return true;
+}
+
+//==============================================================================
+double InverseKinematics::computeError()
+{
+  for (size_t i = 0; i < mTargets.size(); ++i)
+  {
+    const Target& target = mTargets[i];
+    const Eigen::Isometry3d& T = target.mBodyNode->getWorldTransform();
+
+    mError.segment<3>(6*i)
+        = math::logMap(target.mTransform.linear() * T.linear().transpose());
+    mError.segment<3>(6*i + 3)
+        = target.mTransform.translation() - T * target.mOffset;
+    mError.segment<6>(6*i).array() *= target.mWeights.array();
+  }
+
+  return mError.norm();
+}
+
+//==============================================================================
+void InverseKinematics::computeJacobian()
+{
+  mJacobian.setZero();
+
+  for (size_t i = 0; i < mTargets.size(); ++i)
+  {
+    const Target& target = mTargets[i];
+    const BodyNode* bodyNode = target.mBodyNode;
+    const math::Jacobian& J = bodyNode->getWorldJacobian();
+    const Eigen::Vector3d r
+        = bodyNode->getWorldTransform().linear() * target.mOffset;
+
+    for (size_t j = 0; j < bodyNode->getNumDependentGenCoords(); ++j)
+    {
+      const int col = mDofColumns[bodyNode->getDependentGenCoordIndex(j)];
+      if (col < 0)
+        continue;
+
+      // The linear velocity of the offset point is v + w x r
+      mJacobian.block<3,1>(6*i, col)
+          = target.mWeights.head<3>().cwiseProduct(J.block<3,1>(0, j));
+      mJacobian.block<3,1>(6*i + 3, col)
+          = target.mWeights.tail<3>().cwiseProduct(
+              J.block<3,1>(3, j) - r.cross(J.block<3,1>(0, j)));
+    }
+  }
+}
+
+//==============================================================================
+void InverseKinematics::readPositions(Eigen::VectorXd& _positions) const
+{
+  _positions.resize(mDofs.size());
+  for (size_t i = 0; i < mDofs.size(); ++i)
+    _positions[i] = mSkeletonPositions[mDofs[i]];
+}
+
+//==============================================================================
+void InverseKinematics::writePositions(const Eigen::VectorXd& _positions)
+{
+  for (size_t i = 0; i < mDofs.size(); ++i)
+    mSkeletonPositions[mDofs[i]] = _positions[i];
+
+  mSkeleton->setPositions(mSkeletonPositions);
+}
+
+}  // namespace dynamics
+}  // namespace dart
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_INVERSEKINEMATICS_H_
+#define DART_DYNAMICS_INVERSEKINEMATICS_H_
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.h"
+
+namespace dart {
+namespace dynamics {
+
+class BodyNode;
+class Skeleton;
+
+/// The InverseKinematics class solves pose targets on one or more BodyNodes of
+/// a Skeleton using damped least squares with Levenberg-Marquardt style damping
+/// adaptation. The solver only touches the generalized positions of the
+/// Skeleton and respects the position limits of each DegreeOfFreedom.
+///
+/// All matrices and vectors that are needed while iterating are owned by the
+/// InverseKinematics object and are reused across calls to solve(), so an
+/// instance should be kept around instead of being recreated for each query.
+///
+/// For reachability maps and similar workloads, solveBatch() solves many
+/// independent targets in parallel (when DART is built with OpenMP). Since a
+/// Skeleton caches its kinematic quantities, each thread needs a Skeleton of
+/// its own; those are passed in by the caller.
+class InverseKinematics
+{
+public:
+  /// A pose target for a point that is rigidly attached to a BodyNode
+  struct Target
+  {
+    /// BodyNode that the target is attached to
+    BodyNode* mBodyNode;
+
+    /// Offset of the target point, expressed in the Frame of mBodyNode
+    Eigen::Vector3d mOffset;
+
+    /// Desired world transform of the target point. The rotation part is the
+    /// desired orientation of mBodyNode.
+    Eigen::Isometry3d mTransform;
+
+    /// Weights of the error components. The first three entries weigh the
+    /// angular error and the last three weigh the linear error, which matches
+    /// the row layout of math::Jacobian. Set the angular weights to zero for a
+    /// position-only target.
+    Eigen::Vector6d mWeights;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /// Constructor
+  explicit InverseKinematics(Skeleton* _skeleton);
+
+  /// Destructor
+  virtual ~InverseKinematics();
+
+  /// Return the Skeleton that this solver operates on
+  Skeleton* getSkeleton() const;
+
+  //--------------------------------------------------------------------------
+  // Targets
+  //--------------------------------------------------------------------------
+
+  /// Add a pose target and return its index
+  size_t addTarget(BodyNode* _bodyNode,
+                   const Eigen::Isometry3d& _transform,
+                   const Eigen::Vector3d& _offset = Eigen::Vector3d::Zero(),
+                   const Eigen::Vector6d& _weights = Eigen::Vector6d::Ones());
+
+  /// Change the desired world transform of an existing target
+  void setTargetTransform(size_t _index, const Eigen::Isometry3d& _transform);
+
+  /// Change the error weights of an existing target
+  void setTargetWeights(size_t _index, const Eigen::Vector6d& _weights);
+
+  /// Return a target
+  const Target& getTarget(size_t _index) const;
+
+  /// Return the number of targets
+  size_t getNumTargets() const;
+
+  /// Remove all the targets
+  void clearTargets();
+
+  //--------------------------------------------------------------------------
+  // Solver settings
+  //--------------------------------------------------------------------------
+
+  /// Set the generalized coordinates (indices in the Skeleton) that the solver
+  /// is allowed to change. By default, every DegreeOfFreedom is used.
+  void setDofs(const std::vector<size_t>& _dofs);
+
+  /// Use every DegreeOfFreedom of the Skeleton
+  void useAllDofs();
+
+  /// Return the generalized coordinates that the solver is allowed to change
+  const std::vector<size_t>& getDofs() const;
+
+  /// Set the maximum number of iterations of solve()
+  void setMaxIterations(size_t _maxIterations);
+
+  /// Return the maximum number of iterations of solve()
+  size_t getMaxIterations() const;
+
+  /// Set the tolerance on the weighted error norm at which solve() stops
+  void setTolerance(double _tolerance);
+
+  /// Return the tolerance on the weighted error norm
+  double getTolerance() const;
+
+  /// Set the initial damping factor of the least squares problem. The damping
+  /// is adapted while iterating.
+  void setDamping(double _damping);
+
+  /// Return the initial damping factor
+  double getDamping() const;
+
+  /// Set the largest change of a single generalized coordinate per iteration
+  void setMaxStepSize(double _maxStepSize);
+
+  /// Return the largest change of a single generalized coordinate per
+  /// iteration
+  double getMaxStepSize() const;
+
+  /// Set whether the position limits of the DegreesOfFreedom are enforced
+  void setRespectLimits(bool _respectLimits);
+
+  /// Return true if the position limits of the DegreesOfFreedom are enforced
+  bool isRespectingLimits() const;
+
+  //--------------------------------------------------------------------------
+  // Solving
+  //--------------------------------------------------------------------------
+
+  /// Solve for the targets starting from the current positions of the
+  /// Skeleton. The best positions found are left in the Skeleton. Return true
+  /// if the weighted error norm got below the tolerance.
+  bool solve();
+
+  /// Same as solve(), but start from _initialPositions
+  bool solve(const Eigen::VectorXd& _initialPositions);
+
+  /// Return the weighted error norm reached by the last call to solve()
+  double getError() const;
+
+  /// Return the number of iterations taken by the last call to solve()
+  size_t getNumIterations() const;
+
+  /// Solve many independent problems in parallel. Problem i uses the targets
+  /// of this solver, except that the transform of target 0 is replaced by
+  /// _transforms[i]. Every problem starts from the current positions of the
+  /// Skeleton of this solver.
+  ///
+  /// _workers must hold Skeletons that are structurally identical to the
+  /// Skeleton of this solver (e.g., loaded from the same file); one of them is
+  /// used by each thread, so the number of workers caps the number of threads.
+  /// The Skeleton of this solver may be one of the workers.
+  ///
+  /// The solution of problem i is written to _solutions[i] and its weighted
+  /// error norm to (*_errors)[i] if _errors is not nullptr. Return the number
+  /// of problems that converged.
+  size_t solveBatch(const std::vector<Skeleton*>& _workers,
+                    const std::vector<Eigen::Isometry3d>& _transforms,
+                    std::vector<Eigen::VectorXd>& _solutions,
+                    std::vector<double>* _errors = nullptr) const;
+
+protected:
+  /// Size the workspace and read the position limits of the active DOFs
+  void prepare();
+
+  /// Copy the targets and settings of _other while remapping its targets onto
+  /// the BodyNodes of the Skeleton of this solver. Return false if a BodyNode
+  /// could not be found.
+  bool copySettingsFrom(const InverseKinematics& _other);
+
+  /// Fill mError with the weighted error of every target and return its norm
+  double computeError();
+
+  /// Fill mJacobian with the weighted Jacobian of every target
+  void computeJacobian();
+
+  /// Read the positions of the active DOFs into _positions
+  void readPositions(Eigen::VectorXd& _positions) const;
+
+  /// Write the positions of the active DOFs from _positions
+  void writePositions(const Eigen::VectorXd& _positions);
+
+  /// Skeleton that this solver operates on
+  Skeleton* mSkeleton;
+
+  /// Pose targets
+  std::vector<Target, Eigen::aligned_allocator<Target> > mTargets;
+
+  /// True if every DegreeOfFreedom of the Skeleton is active
+  bool mUseAllDofs;
+
+  /// Indices of the generalized coordinates that the solver may change
+  std::vector<size_t> mDofs;
+
+  /// Map from generalized coordinate index in the Skeleton to column in
+  /// mJacobian, or -1 if the coordinate is not active
+  std::vector<int> mDofColumns;
+
+  /// Lower position limit of each active DOF
+  Eigen::VectorXd mLowerLimits;
+
+  /// Upper position limit of each active DOF
+  Eigen::VectorXd mUpperLimits;
+
+  /// Maximum number of iterations
+  size_t mMaxIterations;
+
+  /// Tolerance on the weighted error norm
+  double mTolerance;
+
+  /// Initial damping factor
+  double mDamping;
+
+  /// Largest change of a single coordinate per iteration
+  double mMaxStepSize;
+
+  /// True if position limits are enforced
+  bool mRespectLimits;
+
+  /// Weighted error norm reached by the last solve
+  double mLastError;
+
+  /// Number of iterations taken by the last solve
+  size_t mLastNumIterations;
+
+  //--------------------------------------------------------------------------
+  // Workspace, reused across calls to solve()
+  //--------------------------------------------------------------------------
+
+  /// Stacked weighted Jacobian of all targets (6 * #targets by #active DOFs)
+  Eigen::MatrixXd mJacobian;
+
+  /// Stacked weighted error of all targets
+  Eigen::VectorXd mError;
+
+  /// Normal matrix of the damped least squares problem
+  Eigen::MatrixXd mNormalMatrix;
+
+  /// Factorization of mNormalMatrix
+  Eigen::LDLT<Eigen::MatrixXd> mFactorization;
+
+  /// Intermediate solution of the damped least squares problem
+  Eigen::VectorXd mWork;
+
+  /// Step of the active DOFs
+  Eigen::VectorXd mStep;
+
+  /// Accepted positions of the active DOFs
+  Eigen::VectorXd mPositions;
+
+  /// Candidate positions of the active DOFs
+  Eigen::VectorXd mCandidate;
+
+  /// Full position vector of the Skeleton that is written back in one go
+  Eigen::VectorXd mSkeletonPositions;
+
+public:
+  // To get byte-aligned Eigen vectors
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+}  // namespace dynamics
+}  // namespace dart
+
+#endif  // DART_DYNAMICS_INVERSEKINEMATICS_H_
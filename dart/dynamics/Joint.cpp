@@ -70,6 +70,9 @@ Joint::Joint(const std::string& _name)
     mNeedPrimaryAccelerationUpdate(true),
     mIsLocalJacobianDirty(true),
     mIsLocalJacobianTimeDerivDirty(true),
+    mIsPositionUpdatePending(false),
+    mIsVelocityUpdatePending(false),
+    mIsAccelerationUpdatePending(false),
     mIsPositionLimited(true)
 {
 }
@@ -79,6 +82,24 @@ Joint::~Joint()
 {
 }
 
+//==============================================================================
+void Joint::copyPropertiesAndState(const Joint* _otherJoint)
+{
+  assert(_otherJoint);
+  assert(getNumDofs() == _otherJoint->getNumDofs());
+
+  mActuatorType = _otherJoint->mActuatorType;
+  mIsPositionLimited = _otherJoint->mIsPositionLimited;
+  setTransformFromParentBodyNode(_otherJoint->mT_ParentBodyToJoint);
+  setTransformFromChildBodyNode(_otherJoint->mT_ChildBodyToJoint);
+
+  for (size_t i = 0; i < getNumDofs(); ++i)
+  {
+    const DegreeOfFreedom* otherDof = _otherJoint->getDof(i);
+    getDof(i)->setName(otherDof->getName(), otherDof->isNamePreserved());
+  }
+}
+
 //==============================================================================
 const std::string& Joint::setName(const std::string& _name, bool _renameDofs)
 {
@@ -351,6 +372,21 @@ void Joint::updateArticulatedInertia() const
 //==============================================================================
 void Joint::notifyPositionUpdate()
 {
+  mIsLocalJacobianDirty = true;
+  mIsLocalJacobianTimeDerivDirty = true;
+  mNeedPrimaryAccelerationUpdate = true;
+
+  mNeedTransformUpdate = true;
+  mNeedSpatialVelocityUpdate = true;
+  mNeedSpatialAccelerationUpdate = true;
+
+  // The rest of the Skeleton is notified once the batch is over
+  if(mSkeleton && mSkeleton->isUpdatingState())
+  {
+    mIsPositionUpdatePending = true;
+    return;
+  }
+
   if(mChildBodyNode)
   {
     mChildBodyNode->notifyTransformUpdate();
@@ -360,14 +396,6 @@ void Joint::notifyPositionUpdate()
     mChildBodyNode->mIsWorldJacobianClassicDerivDirty = true;
   }
 
-  mIsLocalJacobianDirty = true;
-  mIsLocalJacobianTimeDerivDirty = true;
-  mNeedPrimaryAccelerationUpdate = true;
-
-  mNeedTransformUpdate = true;
-  mNeedSpatialVelocityUpdate = true;
-  mNeedSpatialAccelerationUpdate = true;
-
   if(mSkeleton)
   {
     mSkeleton->notifyArticulatedInertiaUpdate();
@@ -378,23 +406,35 @@ void Joint::notifyPositionUpdate()
 //==============================================================================
 void Joint::notifyVelocityUpdate()
 {
-  if(mChildBodyNode)
-    mChildBodyNode->notifyVelocityUpdate();
-
   mIsLocalJacobianTimeDerivDirty = true;
 
   mNeedSpatialVelocityUpdate = true;
   mNeedSpatialAccelerationUpdate = true;
+
+  if(mSkeleton && mSkeleton->isUpdatingState())
+  {
+    mIsVelocityUpdatePending = true;
+    return;
+  }
+
+  if(mChildBodyNode)
+    mChildBodyNode->notifyVelocityUpdate();
 }
 
 //==============================================================================
 void Joint::notifyAccelerationUpdate()
 {
-  if(mChildBodyNode)
-    mChildBodyNode->notifyAccelerationUpdate();
-
   mNeedSpatialAccelerationUpdate = true;
   mNeedPrimaryAccelerationUpdate = true;
+
+  if(mSkeleton && mSkeleton->isUpdatingState())
+  {
+    mIsAccelerationUpdatePending = true;
+    return;
+  }
+
+  if(mChildBodyNode)
+    mChildBodyNode->notifyAccelerationUpdate();
 }
 
 }  // namespace dynamics
@@ -130,6 +130,10 @@ public:
   /// Destructor
   virtual ~Joint();
 
+  /// Create a copy of this Joint with the same properties and state. The copy
+  /// is not attached to any BodyNode or Skeleton.
+  virtual Joint* clone() const = 0;
+
   /// \brief Set joint name and return the name.
   /// \param[in] _renameDofs If true, the names of the joint's degrees of
   /// freedom will be updated by calling updateDegreeOfFreedomNames().
@@ -211,6 +215,15 @@ public:
   /// Get an unique index in skeleton of a generalized coordinate in this joint
   virtual size_t getIndexInSkeleton(size_t _index) const = 0;
 
+  /// Make this joint keep its generalized positions, velocities,
+  /// accelerations, forces and commands in the arrays that start at the given
+  /// pointers, after copying the current values there. If _positions is
+  /// nullptr, the joint goes back to its own storage. Skeleton::init() uses
+  /// this to gather the state of all its joints in one contiguous buffer.
+  virtual void setStateStorage(double* _positions, double* _velocities,
+                               double* _accelerations, double* _forces,
+                               double* _commands) = 0;
+
   /// Get number of generalized coordinates
   DEPRECATED(4.1)
   virtual size_t getDof() const = 0;
@@ -575,6 +588,10 @@ protected:
   /// called with _renameDofs set to true.
   virtual void updateDegreeOfFreedomNames() = 0;
 
+  /// Copy the properties and the state of _otherJoint into this Joint. Used by
+  /// clone(); _otherJoint must be of the same type as this Joint.
+  virtual void copyPropertiesAndState(const Joint* _otherJoint);
+
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
@@ -839,6 +856,18 @@ protected:
   /// since the last position or velocity change
   mutable bool mIsLocalJacobianTimeDerivDirty;
 
+  /// True iff this joint's position changed during a batched state update of
+  /// its Skeleton, and the BodyNodes have not been notified yet
+  bool mIsPositionUpdatePending;
+
+  /// True iff this joint's velocity changed during a batched state update of
+  /// its Skeleton, and the BodyNodes have not been notified yet
+  bool mIsVelocityUpdatePending;
+
+  /// True iff this joint's acceleration changed during a batched state update
+  /// of its Skeleton, and the BodyNodes have not been notified yet
+  bool mIsAccelerationUpdatePending;
+
   /// Transmitting wrench from parent body to child body expressed in child body
   DEPRECATED(4.3)
   Eigen::Vector6d mWrench;
@@ -79,6 +79,17 @@ LineSegmentShape::LineSegmentShape(const Eigen::Vector3d& _v1,
   computeVolume();
 }
 
+//==============================================================================
+Shape* LineSegmentShape::clone() const
+{
+  LineSegmentShape* lineSegment = new LineSegmentShape(mThickness);
+  lineSegment->mVertices = mVertices;
+  lineSegment->mConnections = mConnections;
+  lineSegment->setRGBA(mColor);
+  lineSegment->setLocalTransform(mTransform);
+  return lineSegment;
+}
+
 //==============================================================================
 void LineSegmentShape::setThickness(float _thickness)
 {
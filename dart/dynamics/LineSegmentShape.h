@@ -56,6 +56,9 @@ public:
   LineSegmentShape(const Eigen::Vector3d& _v1, const Eigen::Vector3d& _v2,
                    float _thickness = 1.0f);
 
+  // Documentation inherited.
+  virtual Shape* clone() const override;
+
   /// Set the line thickness/width for rendering
   void setThickness(float _thickness);
 
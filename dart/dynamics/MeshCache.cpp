@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/MeshCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "dart/dynamics/MeshShape.h"
+
+namespace dart {
+namespace dynamics {
+
+namespace {
+
+//==============================================================================
+struct CacheEntry
+{
+  CacheEntry() : mLoading(false), mNumWaiting(0) {}
+
+  /// The mesh, while any MeshShape holds it
+  std::weak_ptr<const aiScene> mScene;
+
+  /// True while a thread is importing the file of this entry
+  bool mLoading;
+
+  /// Number of threads waiting for the import of this entry
+  size_t mNumWaiting;
+};
+
+//==============================================================================
+struct CacheRegistry
+{
+  CacheRegistry()
+    : mEnabled(true), mNumLoadingThreads(1), mNumRequests(0), mNumImports(0)
+  {
+  }
+
+  std::mutex mMutex;
+  std::condition_variable mLoaded;
+  std::map<std::string, CacheEntry> mEntries;
+  bool mEnabled;
+  size_t mNumLoadingThreads;
+  size_t mNumRequests;
+  size_t mNumImports;
+};
+
+//==============================================================================
+CacheRegistry& getRegistry()
+{
+  static CacheRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+//==============================================================================
+std::shared_ptr<const aiScene> MeshCache::load(const std::string& _fileName)
+{
+  CacheRegistry& registry = getRegistry();
+  std::unique_lock<std::mutex> lock(registry.mMutex);
+  ++registry.mNumRequests;
+
+  if (!registry.mEnabled)
+  {
+    ++registry.mNumImports;
+    lock.unlock();
+    return import(_fileName);
+  }
+
+  // std::map never moves its elements, so the entry stays valid while the
+  // lock is released below
+  CacheEntry& entry = registry.mEntries[_fileName];
+  ++entry.mNumWaiting;
+  while (entry.mLoading)
+    registry.mLoaded.wait(lock);
+  --entry.mNumWaiting;
+
+  std::shared_ptr<const aiScene> scene = entry.mScene.lock();
+  if (scene)
+    return scene;
+
+  // Import without holding the lock so that other files can be loaded in the
+  // meantime
+  entry.mLoading = true;
+  ++registry.mNumImports;
+  lock.unlock();
+
+  scene = import(_fileName);
+
+  lock.lock();
+  entry.mScene = scene;
+  entry.mLoading = false;
+  registry.mLoaded.notify_all();
+
+  return scene;
+}
+
+//==============================================================================
+std::vector<std::shared_ptr<const aiScene> > MeshCache::loadAll(
+    const std::vector<std::string>& _fileNames)
+{
+  std::vector<std::shared_ptr<const aiScene> > scenes(_fileNames.size());
+
+  size_t numThreads;
+  {
+    CacheRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    if (!registry.mEnabled)
+      return scenes;
+    numThreads = registry.mNumLoadingThreads;
+  }
+
+  // Give every distinct file to exactly one thread, so that no thread blocks
+  // on an import that another thread of this call is running
+  std::vector<std::string> uniqueNames;
+  std::vector<size_t> uniqueIndices(_fileNames.size());
+  std::map<std::string, size_t> indexOfName;
+  for (size_t i = 0; i < _fileNames.size(); ++i)
+  {
+    std::pair<std::map<std::string, size_t>::iterator, bool> inserted
+        = indexOfName.insert(std::make_pair(_fileNames[i], uniqueNames.size()));
+    if (inserted.second)
+      uniqueNames.push_back(_fileNames[i]);
+    uniqueIndices[i] = inserted.first->second;
+  }
+
+  if (0 == numThreads)
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  numThreads = std::min(numThreads, uniqueNames.size());
+
+  std::vector<std::shared_ptr<const aiScene> > uniqueScenes(
+      uniqueNames.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]()
+  {
+    for (size_t i = next++; i < uniqueNames.size(); i = next++)
+      uniqueScenes[i] = load(uniqueNames[i]);
+  };
+
+  // The calling thread takes part in the loading as well
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numThreads; ++i)
+    threads.push_back(std::thread(worker));
+  worker();
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  for (size_t i = 0; i < _fileNames.size(); ++i)
+    scenes[i] = uniqueScenes[uniqueIndices[i]];
+
+  return scenes;
+}
+
+//==============================================================================
+void MeshCache::setNumLoadingThreads(size_t _numThreads)
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  registry.mNumLoadingThreads = _numThreads;
+}
+
+//==============================================================================
+size_t MeshCache::getNumLoadingThreads()
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  return registry.mNumLoadingThreads;
+}
+
+//==============================================================================
+void MeshCache::setEnabled(bool _enabled)
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  registry.mEnabled = _enabled;
+}
+
+//==============================================================================
+bool MeshCache::isEnabled()
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  return registry.mEnabled;
+}
+
+//==============================================================================
+size_t MeshCache::getNumMeshes()
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+
+  size_t numMeshes = 0;
+  std::map<std::string, CacheEntry>::iterator it = registry.mEntries.begin();
+  while (it != registry.mEntries.end())
+  {
+    if (!it->second.mScene.expired())
+    {
+      ++numMeshes;
+      ++it;
+    }
+    else if (!it->second.mLoading && 0 == it->second.mNumWaiting)
+    {
+      // No thread refers to this entry, so it is safe to drop it
+      registry.mEntries.erase(it++);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  return numMeshes;
+}
+
+//==============================================================================
+size_t MeshCache::getNumRequests()
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  return registry.mNumRequests;
+}
+
+//==============================================================================
+size_t MeshCache::getNumImports()
+{
+  CacheRegistry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mMutex);
+  return registry.mNumImports;
+}
+
+//==============================================================================
+std::shared_ptr<const aiScene> MeshCache::import(const std::string& _fileName)
+{
+  const aiScene* scene = MeshShape::loadMesh(_fileName);
+  if (nullptr == scene)
+    return std::shared_ptr<const aiScene>();
+
+  return std::shared_ptr<const aiScene>(scene);
+}
+
+}  // namespace dynamics
+}  // namespace dart
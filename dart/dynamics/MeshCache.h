@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_MESHCACHE_H_
+#define DART_DYNAMICS_MESHCACHE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <assimp/scene.h>
+
+namespace dart {
+namespace dynamics {
+
+/// MeshCache shares imported mesh files between all the MeshShapes of the
+/// process. A file is imported the first time it is requested and handed out
+/// again for as long as any MeshShape still holds it; once the last holder
+/// releases it, the mesh is freed and the next request imports it again.
+///
+/// The cache is keyed by file name only, because the imported aiScene does
+/// not depend on the scale. Each MeshShape applies its own scale, and the
+/// collision detectors share the structures they derive from a mesh between
+/// shapes with the same aiScene and scale.
+///
+/// All functions are thread-safe. Concurrent requests for the same file wait
+/// for a single import. The parsers use loadAll() to import every mesh of a
+/// file up front, on as many threads as setNumLoadingThreads() allows, before
+/// they build any Skeleton.
+class MeshCache
+{
+public:
+  /// Get the mesh stored in _fileName, importing it only if it is not loaded
+  /// yet. File names are compared as given. Returns nullptr if the file can
+  /// not be loaded.
+  static std::shared_ptr<const aiScene> load(const std::string& _fileName);
+
+  /// Load every file of _fileNames on up to getNumLoadingThreads() threads
+  /// and return the meshes in the same order. Each distinct file is imported
+  /// at most once. The meshes stay in the cache for as long as the returned
+  /// pointers are held, so later calls to load() for the same files return
+  /// immediately. While sharing is disabled, nothing could be reused, so this
+  /// returns nullptrs without importing anything.
+  static std::vector<std::shared_ptr<const aiScene> > loadAll(
+      const std::vector<std::string>& _fileNames);
+
+  /// Set the number of threads that loadAll() may use. Zero uses one thread
+  /// per hardware core. The default is one, which imports the files one
+  /// after another on the calling thread.
+  static void setNumLoadingThreads(size_t _numThreads);
+
+  /// Get the number of threads that loadAll() may use, as given to
+  /// setNumLoadingThreads()
+  static size_t getNumLoadingThreads();
+
+  /// Enable or disable sharing. While disabled, load() imports a new copy of
+  /// the file on every call, like MeshShape::loadMesh does. Enabled by default.
+  static void setEnabled(bool _enabled);
+
+  /// Return true if loaded meshes are shared
+  static bool isEnabled();
+
+  /// Get the number of distinct meshes that are currently held by the cache
+  static size_t getNumMeshes();
+
+  /// Get the number of calls to load() so far
+  static size_t getNumRequests();
+
+  /// Get the number of files that load() actually had to import so far
+  static size_t getNumImports();
+
+private:
+  /// Import _fileName into a reference counted aiScene
+  static std::shared_ptr<const aiScene> import(const std::string& _fileName);
+};
+
+}  // namespace dynamics
+}  // namespace dart
+
+#endif  // DART_DYNAMICS_MESHCACHE_H_
@@ -39,6 +39,8 @@
 
 #include <iostream>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <string>
 
 #include <assimp/Importer.hpp>
@@ -47,6 +49,7 @@
 
 #include "dart/renderer/RenderInterface.h"
 #include "dart/common/Console.h"
+#include "dart/dynamics/CookedMesh.h"
 
 // We define our own constructor for aiScene, because it seems to be missing
 // from the standard assimp library
@@ -129,9 +132,34 @@ aiMaterial::~aiMaterial()
 namespace dart {
 namespace dynamics {
 
-MeshShape::MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh)
+MeshShape::MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh,
+                     const std::string& _path)
   : Shape(MESH),
     mMesh(_mesh),
+    mSharedMesh(_mesh),
+    mMeshPath(_path),
+    mDisplayList(0),
+    mScale(_scale)
+{
+  assert(_scale[0] > 0.0);
+  assert(_scale[1] > 0.0);
+  assert(_scale[2] > 0.0);
+
+  if(nullptr == mMesh)
+    return;
+
+  _updateBoundingBoxDim();
+  computeVolume();
+  initMeshes();
+}
+
+MeshShape::MeshShape(const Eigen::Vector3d& _scale,
+                     const std::shared_ptr<const aiScene>& _mesh,
+                     const std::string& _path)
+  : Shape(MESH),
+    mMesh(_mesh.get()),
+    mSharedMesh(_mesh),
+    mMeshPath(_path),
     mDisplayList(0),
     mScale(_scale)
 {
@@ -148,28 +176,60 @@ MeshShape::MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh)
 }
 
 MeshShape::~MeshShape() {
-  delete mMesh;
+}
+
+Shape* MeshShape::clone() const {
+  MeshShape* mesh = new MeshShape(mScale, mSharedMesh, mMeshPath);
+  mesh->setRGBA(mColor);
+  mesh->setLocalTransform(mTransform);
+  mesh->setDisplayList(mDisplayList);
+  mesh->mConvexDecomposition = std::atomic_load(&mConvexDecomposition);
+  return mesh;
 }
 
 const aiScene* MeshShape::getMesh() const {
   return mMesh;
 }
 
+const std::shared_ptr<const aiScene>& MeshShape::getSharedMesh() const {
+  return mSharedMesh;
+}
+
 void MeshShape::setMesh(const aiScene* _mesh) {
-  mMesh = _mesh;
+  if (_mesh == mMesh)
+    return;
 
-  if(nullptr == _mesh)
+  setMesh(std::shared_ptr<const aiScene>(_mesh));
+}
+
+void MeshShape::setMesh(const std::shared_ptr<const aiScene>& _mesh) {
+  mMesh = _mesh.get();
+  mSharedMesh = _mesh;
+  std::atomic_store(&mConvexDecomposition,
+                    std::shared_ptr<const std::vector<math::ConvexHull> >());
+
+  if(nullptr == mMesh)
     return;
 
   _updateBoundingBoxDim();
   computeVolume();
 }
 
+const std::string& MeshShape::getMeshPath() const {
+  return mMeshPath;
+}
+
+void MeshShape::setMeshPath(const std::string& _path) {
+  mMeshPath = _path;
+}
+
 void MeshShape::setScale(const Eigen::Vector3d& _scale) {
   assert(_scale[0] > 0.0);
   assert(_scale[1] > 0.0);
   assert(_scale[2] > 0.0);
   mScale = _scale;
+  std::atomic_store(&mConvexDecomposition,
+                    std::shared_ptr<const std::vector<math::ConvexHull> >());
   computeVolume();
 }
 
@@ -217,6 +277,110 @@ Eigen::Matrix3d MeshShape::computeInertia(double _mass) const {
   return inertia;
 }
 
+namespace {
+
+/// Convex decomposition computed for a mesh along with the mesh data it was
+/// computed from
+struct SharedDecompositionEntry {
+  std::weak_ptr<const aiScene> mScene;
+  std::weak_ptr<const std::vector<math::ConvexHull> > mHulls;
+};
+
+} // anonymous namespace
+
+/// Return the convex decomposition of _scene scaled by _scale. All the
+/// MeshShapes with the same aiScene, scale and parameters share one
+/// decomposition, which is computed once while the others wait for it.
+static std::shared_ptr<const std::vector<math::ConvexHull> >
+getSharedConvexDecomposition(const std::shared_ptr<const aiScene>& _scene,
+                             const Eigen::Vector3d& _scale,
+                             size_t _maxNumHulls, double _concavity) {
+  static std::mutex mutex;
+  static std::map<std::pair<const aiScene*, std::vector<double> >,
+                  SharedDecompositionEntry> decompositions;
+
+  typedef std::vector<math::ConvexHull> Hulls;
+  if (!_scene)
+    return std::make_shared<const Hulls>();
+
+  std::vector<double> parameters(_scale.data(), _scale.data() + 3);
+  parameters.push_back(static_cast<double>(_maxNumHulls));
+  parameters.push_back(_concavity);
+  const std::pair<const aiScene*, std::vector<double> > key(_scene.get(),
+                                                            parameters);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = decompositions.find(key);
+  if (it != decompositions.end()) {
+    std::shared_ptr<const Hulls> hulls = it->second.mHulls.lock();
+
+    // The address of released mesh data may have been reused
+    if (hulls && it->second.mScene.lock() == _scene)
+      return hulls;
+  }
+
+  // Drop the entries of decompositions that are no longer in use
+  for (it = decompositions.begin(); it != decompositions.end();) {
+    if (it->second.mHulls.expired())
+      it = decompositions.erase(it);
+    else
+      ++it;
+  }
+
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<Eigen::Vector3i> triangles;
+  for (unsigned int i = 0; i < _scene->mNumMeshes; i++) {
+    const aiMesh* mesh = _scene->mMeshes[i];
+    const int offset = vertices.size();
+    for (unsigned int j = 0; j < mesh->mNumVertices; j++) {
+      const aiVector3D& vertex = mesh->mVertices[j];
+      vertices.push_back(Eigen::Vector3d(vertex.x * _scale[0],
+                                         vertex.y * _scale[1],
+                                         vertex.z * _scale[2]));
+    }
+    for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
+      const aiFace& face = mesh->mFaces[j];
+      if (face.mNumIndices != 3)
+        continue;
+      triangles.push_back(Eigen::Vector3i(offset + face.mIndices[0],
+                                          offset + face.mIndices[1],
+                                          offset + face.mIndices[2]));
+    }
+  }
+
+  std::shared_ptr<const Hulls> hulls = std::make_shared<const Hulls>(
+      math::computeConvexDecomposition(vertices, triangles, _maxNumHulls,
+                                       _concavity));
+
+  SharedDecompositionEntry& entry = decompositions[key];
+  entry.mScene = _scene;
+  entry.mHulls = hulls;
+
+  return hulls;
+}
+
+const std::vector<math::ConvexHull>& MeshShape::getConvexDecomposition()
+    const {
+  std::shared_ptr<const std::vector<math::ConvexHull> > hulls
+      = std::atomic_load(&mConvexDecomposition);
+
+  // Use the default parameters of computeConvexDecomposition()
+  if (!hulls) {
+    hulls = getSharedConvexDecomposition(mSharedMesh, mScale, 16, 0.05);
+    std::atomic_store(&mConvexDecomposition, hulls);
+  }
+
+  return *hulls;
+}
+
+void MeshShape::computeConvexDecomposition(size_t _maxNumHulls,
+                                           double _concavity) {
+  std::atomic_store(&mConvexDecomposition,
+                    getSharedConvexDecomposition(mSharedMesh, mScale,
+                                                 _maxNumHulls, _concavity));
+}
+
 void MeshShape::computeVolume() {
   // Use bounding box to represent the mesh
   double l = mScale[0] * mBoundingBoxDim[0];
@@ -256,6 +420,16 @@ void MeshShape::_updateBoundingBoxDim() {
 }
 
 const aiScene* MeshShape::loadMesh(const std::string& _fileName) {
+  // Skip the import if an up-to-date cooked copy of the file exists
+  const aiScene* scene
+      = CookedMesh::read(CookedMesh::getCookedFileName(_fileName), _fileName);
+  if (scene)
+    return scene;
+
+  return importMesh(_fileName);
+}
+
+const aiScene* MeshShape::importMesh(const std::string& _fileName) {
   aiPropertyStore* propertyStore = aiCreatePropertyStore();
   // remove points and lines
   aiSetImportPropertyInteger(propertyStore,
@@ -269,11 +443,14 @@ const aiScene* MeshShape::loadMesh(const std::string& _fileName) {
                                    aiProcess_SortByPType            |
                                    aiProcess_OptimizeMeshes,
                                    NULL, propertyStore);
+  aiReleasePropertyStore(propertyStore);
   if(!scene)
+  {
     dtwarn << "[MeshShape] Assimp could not load file: '" << _fileName << "'. "
            << "This will likely result in a segmentation fault "
            << "if you attempt to use the nullptr we return." << std::endl;
-  aiReleasePropertyStore(propertyStore);
+    return nullptr;
+  }
 
   // Assimp rotates collada files such that the up-axis (specified in the
   // collada file) aligns with assimp's y-axis. Here we are reverting this
@@ -38,10 +38,13 @@
 #ifndef DART_DYNAMICS_MESHSHAPE_H_
 #define DART_DYNAMICS_MESHSHAPE_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <assimp/scene.h>
 
+#include "dart/math/ConvexHull.h"
 #include "dart/dynamics/Shape.h"
 
 namespace dart {
@@ -50,18 +53,42 @@ namespace dynamics {
 /// \brief
 class MeshShape : public Shape {
 public:
-  /// \brief Constructor.
-  MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh);
+  /// \brief Constructor. The MeshShape takes ownership of _mesh. _path is the
+  /// file the mesh was loaded from, if any.
+  MeshShape(const Eigen::Vector3d& _scale, const aiScene* _mesh,
+            const std::string& _path = std::string());
+
+  /// \brief Constructor. _mesh may be shared with other MeshShapes. _path is
+  /// the file the mesh was loaded from, if any.
+  MeshShape(const Eigen::Vector3d& _scale,
+            const std::shared_ptr<const aiScene>& _mesh,
+            const std::string& _path = std::string());
 
   /// \brief Destructor.
   virtual ~MeshShape();
 
+  /// \brief Create a MeshShape that shares the mesh data of this one.
+  virtual Shape* clone() const;
+
   /// \brief
   const aiScene* getMesh() const;
 
-  /// \brief
+  /// \brief Get the mesh data together with its ownership.
+  const std::shared_ptr<const aiScene>& getSharedMesh() const;
+
+  /// \brief Set the mesh. The MeshShape takes ownership of _mesh.
   void setMesh(const aiScene* _mesh);
 
+  /// \brief Set the mesh. _mesh may be shared with other MeshShapes.
+  void setMesh(const std::shared_ptr<const aiScene>& _mesh);
+
+  /// \brief Get the file the mesh was loaded from. Empty if the mesh was not
+  /// loaded from a file.
+  const std::string& getMeshPath() const;
+
+  /// \brief Set the file the mesh was loaded from.
+  void setMeshPath(const std::string& _path);
+
   /// \brief
   void setScale(const Eigen::Vector3d& _scale);
 
@@ -79,12 +106,28 @@ public:
             const Eigen::Vector4d& _col = Eigen::Vector4d::Ones(),
             bool _default = true) const;
 
-  /// \brief
+  /// \brief Load the mesh in _fileName. An up-to-date cooked copy of the file
+  /// (see CookedMesh) is read instead if it exists.
   static const aiScene* loadMesh(const std::string& _fileName);
 
+  /// \brief Import _fileName with Assimp, ignoring any cooked copy of it.
+  static const aiScene* importMesh(const std::string& _fileName);
+
   // Documentation inherited.
   virtual Eigen::Matrix3d computeInertia(double _mass) const;
 
+  /// \brief Get the convex pieces that approximate the scaled mesh. They are
+  /// computed by computeConvexDecomposition() with its default parameters on
+  /// first use, and shared with every MeshShape that has the same aiScene and
+  /// scale. Safe to call from several threads at once.
+  const std::vector<math::ConvexHull>& getConvexDecomposition() const;
+
+  /// \brief Approximate the scaled mesh with at most _maxNumHulls convex
+  /// hulls (see math::computeConvexDecomposition()). A _maxNumHulls of one
+  /// gives the convex hull of the mesh.
+  void computeConvexDecomposition(size_t _maxNumHulls = 16,
+                                  double _concavity = 0.05);
+
 protected:
   // Documentation inherited.
   virtual void computeVolume();
@@ -94,15 +137,28 @@ private:
   void _updateBoundingBoxDim();
 
 protected:
-  /// \brief
+  /// \brief Mesh data, owned by mSharedMesh
   const aiScene* mMesh;
 
+  /// \brief Reference counted ownership of mMesh. Clones of this MeshShape
+  /// hold the same aiScene.
+  std::shared_ptr<const aiScene> mSharedMesh;
+
+  /// \brief File the mesh was loaded from
+  std::string mMeshPath;
+
   /// \brief OpenGL DisplayList id for rendering
   int mDisplayList;
 
   /// \brief Scale
   Eigen::Vector3d mScale;
 
+  /// \brief Convex pieces of the scaled mesh, shared with other MeshShapes of
+  /// the same aiScene and scale. Only accessed through std::atomic_load() and
+  /// std::atomic_store(), since getConvexDecomposition() fills it in lazily.
+  mutable std::shared_ptr<const std::vector<math::ConvexHull> >
+      mConvexDecomposition;
+
 public:
   // To get byte-aligned Eigen vectors
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
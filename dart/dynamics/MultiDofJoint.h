@@ -38,6 +38,7 @@
 #define DART_DYNAMICS_MULTIDOFJOINT_H_
 
 #include <iostream>
+#include <new>
 #include <string>
 
 #include "dart/config.h"
@@ -65,6 +66,13 @@ public:
   /// Destructor
   virtual ~MultiDofJoint();
 
+  /// Not copyable, because the state Maps may view mLocalState of the
+  /// original. Use clone() instead.
+  MultiDofJoint(const MultiDofJoint&) = delete;
+
+  /// Not assignable, for the same reason
+  MultiDofJoint& operator=(const MultiDofJoint&) = delete;
+
   //----------------------------------------------------------------------------
   // Interface for generalized coordinates
   //----------------------------------------------------------------------------
@@ -88,6 +96,11 @@ public:
   // Documentation inherited
   virtual size_t getIndexInSkeleton(size_t _index) const;
 
+  // Documentation inherited
+  void setStateStorage(double* _positions, double* _velocities,
+                       double* _accelerations, double* _forces,
+                       double* _commands) override;
+
   //----------------------------------------------------------------------------
   // Command
   //----------------------------------------------------------------------------
@@ -213,20 +226,24 @@ public:
   /// Fixed-size version of setPositions()
   virtual void setPositionsStatic(const Eigen::Matrix<double, DOF, 1>& _positions);
 
-  /// Fixed-size version of getPositions()
-  const Eigen::Matrix<double, DOF, 1>& getPositionsStatic() const;
+  /// Fixed-size version of getPositions(). The returned view reads the
+  /// positions in place, so it follows later changes to them.
+  Eigen::Map<const Eigen::Matrix<double, DOF, 1> > getPositionsStatic() const;
 
   /// Fixed-size version of setVelocities()
   void setVelocitiesStatic(const Eigen::Matrix<double, DOF, 1>& _velocities);
 
-  /// Fixed-size version of getVelocities()
-  const Eigen::Matrix<double, DOF, 1>& getVelocitiesStatic() const;
+  /// Fixed-size version of getVelocities(). The returned view reads the
+  /// velocities in place, so it follows later changes to them.
+  Eigen::Map<const Eigen::Matrix<double, DOF, 1> > getVelocitiesStatic() const;
 
   /// Fixed-size version of setAccelerations()
   void setAccelerationsStatic(const Eigen::Matrix<double, DOF, 1>& _accels);
 
-  /// Fixed-size version of getAccelerations()
-  const Eigen::Matrix<double, DOF, 1>& getAccelerationsStatic() const;
+  /// Fixed-size version of getAccelerations(). The returned view reads the
+  /// accelerations in place, so it follows later changes to them.
+  Eigen::Map<const Eigen::Matrix<double, DOF, 1> >
+  getAccelerationsStatic() const;
 
   //----------------------------------------------------------------------------
   // Force
@@ -343,6 +360,9 @@ public:
   virtual Eigen::Vector6d getBodyConstraintWrench() const override;
 
 protected:
+  // Documentation inherited
+  virtual void copyPropertiesAndState(const Joint* _otherJoint) override;
+
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
@@ -518,15 +538,22 @@ protected:
   /// Array of DegreeOfFreedom objects
   DegreeOfFreedom* mDofs[DOF];
 
-  /// Command
-  Eigen::Matrix<double, DOF, 1> mCommands;
+  /// Positions, velocities, accelerations, forces and commands (one per
+  /// column) of this Joint while it does not use the state buffer of a
+  /// Skeleton
+  Eigen::Matrix<double, DOF, 5> mLocalState;
+
+  /// Command. Views into mLocalState or into the state buffer of the
+  /// Skeleton.
+  Eigen::Map<Eigen::Matrix<double, DOF, 1> > mCommands;
 
   //----------------------------------------------------------------------------
   // Configuration
   //----------------------------------------------------------------------------
 
-  /// Position
-  Eigen::Matrix<double, DOF, 1> mPositions;
+  /// Position. Views into mLocalState or into the state buffer of the
+  /// Skeleton.
+  Eigen::Map<Eigen::Matrix<double, DOF, 1> > mPositions;
 
   /// Lower limit of position
   Eigen::Matrix<double, DOF, 1> mPositionLowerLimits;
@@ -541,8 +568,9 @@ protected:
   // Velocity
   //----------------------------------------------------------------------------
 
-  /// Generalized velocity
-  Eigen::Matrix<double, DOF, 1> mVelocities;
+  /// Generalized velocity. Views into mLocalState or into the state buffer of the
+  /// Skeleton.
+  Eigen::Map<Eigen::Matrix<double, DOF, 1> > mVelocities;
 
   /// Min value allowed.
   Eigen::Matrix<double, DOF, 1> mVelocityLowerLimits;
@@ -557,8 +585,9 @@ protected:
   // Acceleration
   //----------------------------------------------------------------------------
 
-  /// Generalized acceleration
-  Eigen::Matrix<double, DOF, 1> mAccelerations;
+  /// Generalized acceleration. Views into mLocalState or into the state buffer of the
+  /// Skeleton.
+  Eigen::Map<Eigen::Matrix<double, DOF, 1> > mAccelerations;
 
   /// Min value allowed.
   Eigen::Matrix<double, DOF, 1> mAccelerationLowerLimits;
@@ -573,8 +602,9 @@ protected:
   // Force
   //----------------------------------------------------------------------------
 
-  /// Generalized force
-  Eigen::Matrix<double, DOF, 1> mForces;
+  /// Generalized force. Views into mLocalState or into the state buffer of the
+  /// Skeleton.
+  Eigen::Map<Eigen::Matrix<double, DOF, 1> > mForces;
 
   /// Min value allowed.
   Eigen::Matrix<double, DOF, 1> mForceLowerLimits;
@@ -751,20 +781,21 @@ private:
 template <size_t DOF>
 MultiDofJoint<DOF>::MultiDofJoint(const std::string& _name)
   : Joint(_name),
-    mCommands(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
-    mPositions(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
+    mLocalState(Eigen::Matrix<double, DOF, 5>::Zero()),
+    mCommands(mLocalState.col(4).data()),
+    mPositions(mLocalState.col(0).data()),
     mPositionLowerLimits(Eigen::Matrix<double, DOF, 1>::Constant(-DART_DBL_INF)),
     mPositionUpperLimits(Eigen::Matrix<double, DOF, 1>::Constant(DART_DBL_INF)),
     mPositionDeriv(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
-    mVelocities(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
+    mVelocities(mLocalState.col(1).data()),
     mVelocityLowerLimits(Eigen::Matrix<double, DOF, 1>::Constant(-DART_DBL_INF)),
     mVelocityUpperLimits(Eigen::Matrix<double, DOF, 1>::Constant(DART_DBL_INF)),
     mVelocitiesDeriv(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
-    mAccelerations(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
+    mAccelerations(mLocalState.col(2).data()),
     mAccelerationLowerLimits(Eigen::Matrix<double, DOF, 1>::Constant(-DART_DBL_INF)),
     mAccelerationUpperLimits(Eigen::Matrix<double, DOF, 1>::Constant(DART_DBL_INF)),
     mAccelerationsDeriv(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
-    mForces(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
+    mForces(mLocalState.col(3).data()),
     mForceLowerLimits(Eigen::Matrix<double, DOF, 1>::Constant(-DART_DBL_INF)),
     mForceUpperLimits(Eigen::Matrix<double, DOF, 1>::Constant(DART_DBL_INF)),
     mForcesDeriv(Eigen::Matrix<double, DOF, 1>::Constant(0.0)),
@@ -855,6 +886,48 @@ size_t MultiDofJoint<DOF>::getIndexInSkeleton(size_t _index) const
   return mDofs[_index]->mIndexInSkeleton;
 }
 
+//==============================================================================
+template <size_t DOF>
+void MultiDofJoint<DOF>::setStateStorage(double* _positions,
+                                         double* _velocities,
+                                         double* _accelerations,
+                                         double* _forces,
+                                         double* _commands)
+{
+  typedef Eigen::Map<Eigen::Matrix<double, DOF, 1> > VectorMap;
+
+  if (nullptr == _positions)
+  {
+    _positions     = mLocalState.col(0).data();
+    _velocities    = mLocalState.col(1).data();
+    _accelerations = mLocalState.col(2).data();
+    _forces        = mLocalState.col(3).data();
+    _commands      = mLocalState.col(4).data();
+  }
+
+  assert(_velocities && _accelerations && _forces && _commands);
+
+  VectorMap positions(_positions);
+  VectorMap velocities(_velocities);
+  VectorMap accelerations(_accelerations);
+  VectorMap forces(_forces);
+  VectorMap commands(_commands);
+
+  positions     = mPositions;
+  velocities    = mVelocities;
+  accelerations = mAccelerations;
+  forces        = mForces;
+  commands      = mCommands;
+
+  // Re-seat the maps. This is the way Eigen recommends to change the array
+  // that a Map views.
+  new (&mPositions) VectorMap(_positions);
+  new (&mVelocities) VectorMap(_velocities);
+  new (&mAccelerations) VectorMap(_accelerations);
+  new (&mForces) VectorMap(_forces);
+  new (&mCommands) VectorMap(_commands);
+}
+
 //==============================================================================
 template <size_t DOF>
 void MultiDofJoint<DOF>::setCommand(size_t _index, double _position)
@@ -1275,10 +1348,10 @@ void MultiDofJoint<DOF>::setPositionsStatic(
 
 //==============================================================================
 template <size_t DOF>
-const Eigen::Matrix<double, DOF, 1>&
+Eigen::Map<const Eigen::Matrix<double, DOF, 1> >
 MultiDofJoint<DOF>::getPositionsStatic() const
 {
-  return mPositions;
+  return Eigen::Map<const Eigen::Matrix<double, DOF, 1> >(mPositions.data());
 }
 
 //==============================================================================
@@ -1292,10 +1365,10 @@ void MultiDofJoint<DOF>::setVelocitiesStatic(
 
 //==============================================================================
 template <size_t DOF>
-const Eigen::Matrix<double, DOF, 1>&
+Eigen::Map<const Eigen::Matrix<double, DOF, 1> >
 MultiDofJoint<DOF>::getVelocitiesStatic() const
 {
-  return mVelocities;
+  return Eigen::Map<const Eigen::Matrix<double, DOF, 1> >(mVelocities.data());
 }
 
 //==============================================================================
@@ -1309,10 +1382,10 @@ void MultiDofJoint<DOF>::setAccelerationsStatic(
 
 //==============================================================================
 template <size_t DOF>
-const Eigen::Matrix<double, DOF, 1>&
+Eigen::Map<const Eigen::Matrix<double, DOF, 1> >
 MultiDofJoint<DOF>::getAccelerationsStatic() const
 {
-  return mAccelerations;
+  return Eigen::Map<const Eigen::Matrix<double, DOF, 1> >(mAccelerations.data());
 }
 
 //==============================================================================
@@ -1767,6 +1840,38 @@ MultiDofJoint<DOF>::getInvProjArtInertiaImplicit() const
   return mInvProjArtInertiaImplicit;
 }
 
+//==============================================================================
+template <size_t DOF>
+void MultiDofJoint<DOF>::copyPropertiesAndState(const Joint* _otherJoint)
+{
+  Joint::copyPropertiesAndState(_otherJoint);
+
+  const MultiDofJoint<DOF>* other
+      = static_cast<const MultiDofJoint<DOF>*>(_otherJoint);
+
+  mPositions     = other->mPositions;
+  mVelocities    = other->mVelocities;
+  mAccelerations = other->mAccelerations;
+  mForces        = other->mForces;
+  mCommands      = other->mCommands;
+
+  mPositionLowerLimits     = other->mPositionLowerLimits;
+  mPositionUpperLimits     = other->mPositionUpperLimits;
+  mVelocityLowerLimits     = other->mVelocityLowerLimits;
+  mVelocityUpperLimits     = other->mVelocityUpperLimits;
+  mAccelerationLowerLimits = other->mAccelerationLowerLimits;
+  mAccelerationUpperLimits = other->mAccelerationUpperLimits;
+  mForceLowerLimits        = other->mForceLowerLimits;
+  mForceUpperLimits        = other->mForceUpperLimits;
+
+  mSpringStiffness    = other->mSpringStiffness;
+  mRestPosition       = other->mRestPosition;
+  mDampingCoefficient = other->mDampingCoefficient;
+  mFrictions          = other->mFrictions;
+
+  notifyPositionUpdate();
+}
+
 //==============================================================================
 template <size_t DOF>
 void MultiDofJoint<DOF>::updateLocalSpatialVelocity() const
@@ -60,6 +60,31 @@ PlanarJoint::~PlanarJoint()
 {
 }
 
+//==============================================================================
+Joint* PlanarJoint::clone() const
+{
+  PlanarJoint* joint = new PlanarJoint(mName);
+
+  switch (mPlaneType)
+  {
+    case PT_XY:
+      joint->setXYPlane(false);
+      break;
+    case PT_YZ:
+      joint->setYZPlane(false);
+      break;
+    case PT_ZX:
+      joint->setZXPlane(false);
+      break;
+    case PT_ARBITRARY:
+      joint->setArbitraryPlane(mTransAxis1, mTransAxis2, false);
+      break;
+  }
+
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void PlanarJoint::setXYPlane(bool _renameDofs)
 {
@@ -68,6 +68,9 @@ public:
   /// Destructor
   virtual ~PlanarJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   /// \brief Set plane type as XY-plane
   /// \param[in] _renameDofs If true, the names of dofs in this joint will be
   /// renmaed according to the plane type.
@@ -58,6 +58,15 @@ PlaneShape::PlaneShape(const Eigen::Vector3d& _normal,
 {
 }
 
+//==============================================================================
+Shape* PlaneShape::clone() const
+{
+  PlaneShape* plane = new PlaneShape(mNormal, mOffset);
+  plane->setRGBA(mColor);
+  plane->setLocalTransform(mTransform);
+  return plane;
+}
+
 //==============================================================================
 void PlaneShape::draw(renderer::RenderInterface* _ri,
                       const Eigen::Vector4d& _color,
@@ -53,6 +53,9 @@ public:
   /// Constructor
   PlaneShape(const Eigen::Vector3d& _normal, const Eigen::Vector3d& _point);
 
+  // Documentation inherited.
+  virtual Shape* clone() const override;
+
   // Documentation inherited.
   // TODO(JS): Not implemented yet
   void draw(renderer::RenderInterface* _ri = NULL,
@@ -59,6 +59,14 @@ PrismaticJoint::~PrismaticJoint()
 {
 }
 
+//==============================================================================
+Joint* PrismaticJoint::clone() const
+{
+  PrismaticJoint* joint = new PrismaticJoint(mAxis, mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void PrismaticJoint::setAxis(const Eigen::Vector3d& _axis)
 {
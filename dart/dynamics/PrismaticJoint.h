@@ -57,6 +57,9 @@ public:
   /// Destructor
   virtual ~PrismaticJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   ///
   void setAxis(const Eigen::Vector3d& _axis);
 
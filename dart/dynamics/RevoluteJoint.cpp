@@ -61,6 +61,14 @@ RevoluteJoint::~RevoluteJoint()
 {
 }
 
+//==============================================================================
+Joint* RevoluteJoint::clone() const
+{
+  RevoluteJoint* joint = new RevoluteJoint(mAxis, mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void RevoluteJoint::setAxis(const Eigen::Vector3d& _axis)
 {
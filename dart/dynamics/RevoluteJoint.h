@@ -57,6 +57,9 @@ public:
   /// Destructor
   virtual ~RevoluteJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   ///
   void setAxis(const Eigen::Vector3d& _axis);
 
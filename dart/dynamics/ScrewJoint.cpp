@@ -62,6 +62,14 @@ ScrewJoint::~ScrewJoint()
 {
 }
 
+//==============================================================================
+Joint* ScrewJoint::clone() const
+{
+  ScrewJoint* joint = new ScrewJoint(mAxis, mPitch, mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void ScrewJoint::setAxis(const Eigen::Vector3d& _axis)
 {
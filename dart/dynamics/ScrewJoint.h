@@ -58,6 +58,9 @@ public:
   /// Destructor
   virtual ~ScrewJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   ///
   void setAxis(const Eigen::Vector3d& _axis);
 
@@ -65,7 +65,8 @@ public:
     PLANE,
     MESH,
     SOFT_MESH,
-    LINE_SEGMENT
+    LINE_SEGMENT,
+    HEIGHTMAP
   };
 
   /// \brief Constructor
@@ -74,6 +75,11 @@ public:
   /// \brief Destructor
   virtual ~Shape();
 
+  /// \brief Create a copy of this shape with the same geometry, color and
+  /// local transformation. Read-only geometric data (e.g., the meshes of
+  /// MeshShape) is shared with the copy rather than duplicated.
+  virtual Shape* clone() const = 0;
+
   /// \brief Set RGB color components (leave alpha alone). Identical to
   /// setRGB(const Eigen::Vector3d&)
   void setColor(const Eigen::Vector3d& _color);
@@ -49,20 +49,21 @@ namespace dynamics {
 SingleDofJoint::SingleDofJoint(const std::string& _name)
   : Joint(_name),
     mDof(createDofPointer(_name, 0)),
-    mCommand(0.0),
-    mPosition(0.0),
+    mLocalState(Eigen::Matrix<double, 1, 5>::Zero()),
+    mCommand(&mLocalState[4]),
+    mPosition(&mLocalState[0]),
     mPositionLowerLimit(-DART_DBL_INF),
     mPositionUpperLimit(DART_DBL_INF),
     mPositionDeriv(0.0),
-    mVelocity(0.0),
+    mVelocity(&mLocalState[1]),
     mVelocityLowerLimit(-DART_DBL_INF),
     mVelocityUpperLimit(DART_DBL_INF),
     mVelocityDeriv(0.0),
-    mAcceleration(0.0),
+    mAcceleration(&mLocalState[2]),
     mAccelerationLowerLimit(-DART_DBL_INF),
     mAccelerationUpperLimit(DART_DBL_INF),
     mAccelerationDeriv(0.0),
-    mForce(0.0),
+    mForce(&mLocalState[3]),
     mForceLowerLimit(-DART_DBL_INF),
     mForceUpperLimit(DART_DBL_INF),
     mForceDeriv(0.0),
@@ -128,6 +129,35 @@ size_t SingleDofJoint::getIndexInSkeleton(size_t _index) const
   return mDof->mIndexInSkeleton;
 }
 
+//==============================================================================
+void SingleDofJoint::setStateStorage(double* _positions, double* _velocities,
+                                     double* _accelerations, double* _forces,
+                                     double* _commands)
+{
+  if (nullptr == _positions)
+  {
+    _positions     = &mLocalState[0];
+    _velocities    = &mLocalState[1];
+    _accelerations = &mLocalState[2];
+    _forces        = &mLocalState[3];
+    _commands      = &mLocalState[4];
+  }
+
+  assert(_velocities && _accelerations && _forces && _commands);
+
+  *_positions     = *mPosition;
+  *_velocities    = *mVelocity;
+  *_accelerations = *mAcceleration;
+  *_forces        = *mForce;
+  *_commands      = *mCommand;
+
+  mPosition     = _positions;
+  mVelocity     = _velocities;
+  mAcceleration = _accelerations;
+  mForce        = _forces;
+  mCommand      = _commands;
+}
+
 //==============================================================================
 DegreeOfFreedom* SingleDofJoint::getDof(size_t _index)
 {
@@ -154,7 +184,7 @@ void SingleDofJoint::setCommand(size_t _index, double _command)
     return;
   }
 
-  mCommand = _command;
+  *mCommand = _command;
 }
 
 //==============================================================================
@@ -167,7 +197,7 @@ double SingleDofJoint::getCommand(size_t _index) const
     return 0.0;
   }
 
-  return mCommand;
+  return *mCommand;
 }
 
 //==============================================================================
@@ -181,19 +211,19 @@ void SingleDofJoint::setCommands(const Eigen::VectorXd& _commands)
     return;
   }
 
-  mCommand = _commands[0];
+  *mCommand = _commands[0];
 }
 
 //==============================================================================
 Eigen::VectorXd SingleDofJoint::getCommands() const
 {
-  return Eigen::Matrix<double, 1, 1>::Constant(mCommand);
+  return Eigen::Matrix<double, 1, 1>::Constant(*mCommand);
 }
 
 //==============================================================================
 void SingleDofJoint::resetCommands()
 {
-  mCommand = 0.0;
+  *mCommand = 0.0;
 }
 
 //==============================================================================
@@ -412,7 +442,7 @@ void SingleDofJoint::setAcceleration(size_t _index, double _acceleration)
 
 #if DART_MAJOR_VERSION == 4
   if (mActuatorType == ACCELERATION)
-    mCommand = getAccelerationStatic();
+    *mCommand = getAccelerationStatic();
 #endif
 }
 
@@ -443,7 +473,7 @@ void SingleDofJoint::setAccelerations(const Eigen::VectorXd& _accelerations)
 
 #if DART_MAJOR_VERSION == 4
   if (mActuatorType == ACCELERATION)
-    mCommand = getAccelerationStatic();
+    *mCommand = getAccelerationStatic();
 #endif
 }
 
@@ -516,40 +546,40 @@ double SingleDofJoint::getAccelerationUpperLimit(size_t _index) const
 //==============================================================================
 void SingleDofJoint::setPositionStatic(const double& _position)
 {
-  mPosition = _position;
+  *mPosition = _position;
   notifyPositionUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getPositionStatic() const
 {
-  return mPosition;
+  return *mPosition;
 }
 
 //==============================================================================
 void SingleDofJoint::setVelocityStatic(const double& _velocity)
 {
-  mVelocity = _velocity;
+  *mVelocity = _velocity;
   notifyVelocityUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getVelocityStatic() const
 {
-  return mVelocity;
+  return *mVelocity;
 }
 
 //==============================================================================
 void SingleDofJoint::setAccelerationStatic(const double& _acceleration)
 {
-  mAcceleration = _acceleration;
+  *mAcceleration = _acceleration;
   notifyAccelerationUpdate();
 }
 
 //==============================================================================
 const double& SingleDofJoint::getAccelerationStatic() const
 {
-  return mAcceleration;
+  return *mAcceleration;
 }
 
 //==============================================================================
@@ -561,11 +591,11 @@ void SingleDofJoint::setForce(size_t _index, double _force)
     return;
   }
 
-  mForce = _force;
+  *mForce = _force;
 
 #if DART_MAJOR_VERSION == 4
   if (mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
 #endif
   // TODO: Remove at DART 5.0.
 }
@@ -579,7 +609,7 @@ double SingleDofJoint::getForce(size_t _index)
     return 0.0;
   }
 
-  return mForce;
+  return *mForce;
 }
 
 //==============================================================================
@@ -592,11 +622,11 @@ void SingleDofJoint::setForces(const Eigen::VectorXd& _forces)
     return;
   }
 
-  mForce = _forces[0];
+  *mForce = _forces[0];
 
 #if DART_MAJOR_VERSION == 4
   if (mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
 #endif
   // TODO: Remove at DART 5.0.
 }
@@ -604,17 +634,17 @@ void SingleDofJoint::setForces(const Eigen::VectorXd& _forces)
 //==============================================================================
 Eigen::VectorXd SingleDofJoint::getForces() const
 {
-  return Eigen::Matrix<double, 1, 1>::Constant(mForce);
+  return Eigen::Matrix<double, 1, 1>::Constant(*mForce);
 }
 
 //==============================================================================
 void SingleDofJoint::resetForces()
 {
-  mForce = 0.0;
+  *mForce = 0.0;
 
 #if DART_MAJOR_VERSION == 4
   if (mActuatorType == FORCE)
-    mCommand = mForce;
+    *mCommand = *mForce;
 #endif
 }
 
@@ -908,6 +938,36 @@ void SingleDofJoint::updateDegreeOfFreedomNames()
     mDof->setName(mName, false);
 }
 
+//==============================================================================
+void SingleDofJoint::copyPropertiesAndState(const Joint* _otherJoint)
+{
+  Joint::copyPropertiesAndState(_otherJoint);
+
+  const SingleDofJoint* other = static_cast<const SingleDofJoint*>(_otherJoint);
+
+  *mPosition     = *other->mPosition;
+  *mVelocity     = *other->mVelocity;
+  *mAcceleration = *other->mAcceleration;
+  *mForce        = *other->mForce;
+  *mCommand      = *other->mCommand;
+
+  mPositionLowerLimit     = other->mPositionLowerLimit;
+  mPositionUpperLimit     = other->mPositionUpperLimit;
+  mVelocityLowerLimit     = other->mVelocityLowerLimit;
+  mVelocityUpperLimit     = other->mVelocityUpperLimit;
+  mAccelerationLowerLimit = other->mAccelerationLowerLimit;
+  mAccelerationUpperLimit = other->mAccelerationUpperLimit;
+  mForceLowerLimit        = other->mForceLowerLimit;
+  mForceUpperLimit        = other->mForceUpperLimit;
+
+  mSpringStiffness    = other->mSpringStiffness;
+  mRestPosition       = other->mRestPosition;
+  mDampingCoefficient = other->mDampingCoefficient;
+  mFriction           = other->mFriction;
+
+  notifyPositionUpdate();
+}
+
 //==============================================================================
 void SingleDofJoint::updateLocalSpatialVelocity() const
 {
@@ -931,7 +991,7 @@ void SingleDofJoint::updateLocalPrimaryAcceleration() const
 Eigen::Vector6d SingleDofJoint::getBodyConstraintWrench() const
 {
   assert(mChildBodyNode);
-  return mChildBodyNode->getBodyForce() - getLocalJacobianStatic() * mForce;
+  return mChildBodyNode->getBodyForce() - getLocalJacobianStatic() * (*mForce);
 }
 
 //==============================================================================
@@ -1365,20 +1425,20 @@ void SingleDofJoint::updateTotalForce(const Eigen::Vector6d& _bodyForce,
   switch (mActuatorType)
   {
     case FORCE:
-      mForce = mCommand;
+      *mForce = *mCommand;
       updateTotalForceDynamic(_bodyForce, _timeStep);
       break;
     case PASSIVE:
     case SERVO:
-      mForce = 0.0;
+      *mForce = 0.0;
       updateTotalForceDynamic(_bodyForce, _timeStep);
       break;
     case ACCELERATION:
-      setAccelerationStatic(mCommand);
+      setAccelerationStatic(*mCommand);
       updateTotalForceKinematic(_bodyForce, _timeStep);
       break;
     case VELOCITY:
-      setAccelerationStatic( (mCommand - getVelocityStatic()) / _timeStep );
+      setAccelerationStatic( (*mCommand - getVelocityStatic()) / _timeStep );
       updateTotalForceKinematic(_bodyForce, _timeStep);
       break;
     case LOCKED:
@@ -1404,7 +1464,7 @@ void SingleDofJoint::updateTotalForceDynamic(
   const double dampingForce = -mDampingCoefficient * getVelocityStatic();
 
   // Compute alpha
-  mTotalForce = mForce + springForce + dampingForce
+  mTotalForce = *mForce + springForce + dampingForce
                 - getLocalJacobianStatic().dot(_bodyForce);
 }
 
@@ -1551,13 +1611,13 @@ void SingleDofJoint::updateForceID(const Eigen::Vector6d& _bodyForce,
                                    bool _withDampingForces,
                                    bool _withSpringForces)
 {
-  mForce = getLocalJacobianStatic().dot(_bodyForce);
+  *mForce = getLocalJacobianStatic().dot(_bodyForce);
 
   // Damping force
   if (_withDampingForces)
   {
     const double dampingForce = -mDampingCoefficient * getVelocityStatic();
-    mForce -= dampingForce;
+    *mForce -= dampingForce;
   }
 
   // Spring force
@@ -1566,7 +1626,7 @@ void SingleDofJoint::updateForceID(const Eigen::Vector6d& _bodyForce,
     const double nextPosition = getPositionStatic()
                               + _timeStep*getVelocityStatic();
     const double springForce = -mSpringStiffness*(nextPosition - mRestPosition);
-    mForce -= springForce;
+    *mForce -= springForce;
   }
 }
 
@@ -1648,13 +1708,13 @@ void SingleDofJoint::updateConstrainedTermsDynamic(double _timeStep)
 
   setVelocityStatic(getVelocityStatic() + mVelocityChange);
   setAccelerationStatic(getAccelerationStatic() + mVelocityChange*invTimeStep);
-  mForce        += mConstraintImpulse*invTimeStep;
+  *mForce        += mConstraintImpulse*invTimeStep;
 }
 
 //==============================================================================
 void SingleDofJoint::updateConstrainedTermsKinematic(double _timeStep)
 {
-  mForce += mImpulse / _timeStep;
+  *mForce += mImpulse / _timeStep;
 }
 
 //==============================================================================
@@ -1700,7 +1760,7 @@ void SingleDofJoint::updateTotalForceForInvMassMatrix(
     const Eigen::Vector6d& _bodyForce)
 {
   // Compute alpha
-  mInvM_a = mForce - getLocalJacobianStatic().dot(_bodyForce);
+  mInvM_a = *mForce - getLocalJacobianStatic().dot(_bodyForce);
 }
 
 //==============================================================================
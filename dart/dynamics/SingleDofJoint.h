@@ -58,6 +58,13 @@ public:
   /// Destructor
   virtual ~SingleDofJoint();
 
+  /// Not copyable, because mPosition and the other state pointers may point
+  /// into mLocalState of the original. Use clone() instead.
+  SingleDofJoint(const SingleDofJoint&) = delete;
+
+  /// Not assignable, for the same reason
+  SingleDofJoint& operator=(const SingleDofJoint&) = delete;
+
   // Documentation inherited
   DEPRECATED(4.1)
   virtual size_t getDof() const;
@@ -71,6 +78,11 @@ public:
   // Documentation inherited
   size_t getIndexInSkeleton(size_t _index) const override;
 
+  // Documentation inherited
+  void setStateStorage(double* _positions, double* _velocities,
+                       double* _accelerations, double* _forces,
+                       double* _commands) override;
+
   //----------------------------------------------------------------------------
   // Command
   //----------------------------------------------------------------------------
@@ -336,6 +348,9 @@ protected:
   // Documentation inherited
   virtual void updateDegreeOfFreedomNames();
 
+  // Documentation inherited
+  virtual void copyPropertiesAndState(const Joint* _otherJoint) override;
+
   //----------------------------------------------------------------------------
   /// \{ \name Recursive dynamics routines
   //----------------------------------------------------------------------------
@@ -509,15 +524,21 @@ protected:
   /// \brief DegreeOfFreedom pointer
   DegreeOfFreedom* mDof;
 
-  /// Command
-  double mCommand;
+  /// Position, velocity, acceleration, force and command of this Joint while
+  /// it does not use the state buffer of a Skeleton
+  Eigen::Matrix<double, 1, 5> mLocalState;
+
+  /// Command. Points into mLocalState or into the state buffer of the
+  /// Skeleton.
+  double* mCommand;
 
   //----------------------------------------------------------------------------
   // Configuration
   //----------------------------------------------------------------------------
 
-  /// Position
-  double mPosition;
+  /// Position. Points into mLocalState or into the state buffer of the
+  /// Skeleton.
+  double* mPosition;
 
   /// Lower limit of position
   double mPositionLowerLimit;
@@ -532,8 +553,9 @@ protected:
   // Velocity
   //----------------------------------------------------------------------------
 
-  /// Generalized velocity
-  double mVelocity;
+  /// Generalized velocity. Points into mLocalState or into the state buffer of the
+  /// Skeleton.
+  double* mVelocity;
 
   /// Min value allowed.
   double mVelocityLowerLimit;
@@ -548,8 +570,9 @@ protected:
   // Acceleration
   //----------------------------------------------------------------------------
 
-  /// Generalized acceleration
-  double mAcceleration;
+  /// Generalized acceleration. Points into mLocalState or into the state buffer of the
+  /// Skeleton.
+  double* mAcceleration;
 
   /// Min value allowed.
   double mAccelerationLowerLimit;
@@ -564,8 +587,9 @@ protected:
   // Force
   //----------------------------------------------------------------------------
 
-  /// Generalized force
-  double mForce;
+  /// Generalized force. Points into mLocalState or into the state buffer of the
+  /// Skeleton.
+  double* mForce;
 
   /// Min value allowed.
   double mForceLowerLimit;
@@ -38,6 +38,7 @@
 #include "dart/dynamics/Skeleton.h"
 
 #include <algorithm>
+#include <map>
 #include <queue>
 #include <string>
 #include <vector>
@@ -66,6 +67,8 @@ Skeleton::Skeleton(const std::string& _name)
     mNameMgrForSoftBodyNodes("BodyNode"),
     mIsMobile(true),
     mTimeStep(0.001),
+    mNumSubSteps(1),
+    mIsHeld(false),
     mGravity(Eigen::Vector3d(0.0, 0.0, -9.81)),
     mTotalMass(0.0),
     mIsArticulatedInertiaDirty(true),
@@ -79,6 +82,7 @@ Skeleton::Skeleton(const std::string& _name)
     mIsExternalForcesDirty(true),
     mIsDampingForcesDirty(true),
     mIsImpulseApplied(false),
+    mStateUpdateDepth(0),
     mUnionRootSkeleton(this),
     mUnionSize(1)
 {
@@ -94,6 +98,70 @@ Skeleton::~Skeleton()
   }
 }
 
+//==============================================================================
+Skeleton* Skeleton::clone() const
+{
+  Skeleton* skel = new Skeleton(mName);
+  skel->mIsMobile = mIsMobile;
+  skel->mNumSubSteps = mNumSubSteps;
+  skel->mEnabledSelfCollisionCheck = mEnabledSelfCollisionCheck;
+  skel->mEnabledAdjacentBodyCheck = mEnabledAdjacentBodyCheck;
+
+  std::map<const BodyNode*, BodyNode*> clonedBodyNodes;
+  for (size_t i = 0; i < mBodyNodes.size(); ++i)
+  {
+    const BodyNode* bodyNode = mBodyNodes[i];
+    BodyNode* clonedBodyNode = bodyNode->clone();
+    clonedBodyNode->setParentJoint(bodyNode->getParentJoint()->clone());
+    clonedBodyNodes[bodyNode] = clonedBodyNode;
+  }
+
+  // Connect the children in their original order so that init() arranges the
+  // copied BodyNodes the same way as ours
+  for (size_t i = 0; i < mBodyNodes.size(); ++i)
+  {
+    const BodyNode* bodyNode = mBodyNodes[i];
+    BodyNode* clonedBodyNode = clonedBodyNodes[bodyNode];
+    for (size_t j = 0; j < bodyNode->mChildBodyNodes.size(); ++j)
+    {
+      clonedBodyNode->addChildBodyNode(
+            clonedBodyNodes[bodyNode->mChildBodyNodes[j]]);
+    }
+
+    skel->addBodyNode(clonedBodyNode);
+  }
+
+  skel->init(mTimeStep, mGravity);
+
+  for (const auto& disabled : mDisabledSelfCollisionPairs)
+  {
+    for (const BodyNode* bodyNode : disabled.second)
+    {
+      skel->mDisabledSelfCollisionPairs[clonedBodyNodes[disabled.first]]
+          .insert(clonedBodyNodes[bodyNode]);
+    }
+  }
+
+  // init() clears the forces, so they are restored afterwards
+  for (size_t i = 0; i < mBodyNodes.size(); ++i)
+  {
+    const BodyNode* bodyNode = mBodyNodes[i];
+    BodyNode* clonedBodyNode = clonedBodyNodes[bodyNode];
+    clonedBodyNode->mFext = bodyNode->mFext;
+
+    const Joint* joint = bodyNode->getParentJoint();
+    if (joint->getNumDofs() == 0)
+      continue;
+
+    Joint* clonedJoint = clonedBodyNode->getParentJoint();
+    clonedJoint->setForces(joint->getForces());
+    clonedJoint->setCommands(joint->getCommands());
+  }
+  skel->mIsExternalForcesDirty = true;
+
+  return skel;
+}
+
 //==============================================================================
 void Skeleton::setName(const std::string& _name)
 {
@@ -188,6 +256,78 @@ bool Skeleton::isEnabledAdjacentBodyCheck() const
   return mEnabledAdjacentBodyCheck;
 }
 
+//==============================================================================
+void Skeleton::disableSelfCollisionPair(const BodyNode* _bodyNode1,
+                                        const BodyNode* _bodyNode2)
+{
+  assert(_bodyNode1->getSkeleton() == this
+         && _bodyNode2->getSkeleton() == this);
+
+  mDisabledSelfCollisionPairs[_bodyNode1].insert(_bodyNode2);
+  mDisabledSelfCollisionPairs[_bodyNode2].insert(_bodyNode1);
+}
+
+//==============================================================================
+void Skeleton::enableSelfCollisionPair(const BodyNode* _bodyNode1,
+                                       const BodyNode* _bodyNode2)
+{
+  std::unordered_map<const BodyNode*,
+                     std::unordered_set<const BodyNode*> >::iterator it1
+      = mDisabledSelfCollisionPairs.find(_bodyNode1);
+  if (it1 == mDisabledSelfCollisionPairs.end())
+    return;
+
+  it1->second.erase(_bodyNode2);
+  if (it1->second.empty())
+    mDisabledSelfCollisionPairs.erase(it1);
+
+  std::unordered_map<const BodyNode*,
+                     std::unordered_set<const BodyNode*> >::iterator it2
+      = mDisabledSelfCollisionPairs.find(_bodyNode2);
+  it2->second.erase(_bodyNode1);
+  if (it2->second.empty())
+    mDisabledSelfCollisionPairs.erase(it2);
+}
+
+//==============================================================================
+bool Skeleton::isSelfCollisionPairEnabled(const BodyNode* _bodyNode1,
+                                          const BodyNode* _bodyNode2) const
+{
+  if (mDisabledSelfCollisionPairs.empty())
+    return true;
+
+  std::unordered_map<const BodyNode*,
+                     std::unordered_set<const BodyNode*> >::const_iterator it
+      = mDisabledSelfCollisionPairs.find(_bodyNode1);
+  if (it == mDisabledSelfCollisionPairs.end())
+    return true;
+
+  return it->second.find(_bodyNode2) == it->second.end();
+}
+
+//==============================================================================
+std::vector<std::pair<BodyNode*, BodyNode*> >
+    Skeleton::getDisabledSelfCollisionPairs() const
+{
+  std::vector<std::pair<BodyNode*, BodyNode*> > pairs;
+  for (size_t i = 0; i < mBodyNodes.size(); ++i)
+  {
+    for (size_t j = i + 1; j < mBodyNodes.size(); ++j)
+    {
+      if (!isSelfCollisionPairEnabled(mBodyNodes[i], mBodyNodes[j]))
+        pairs.push_back(std::make_pair(mBodyNodes[i], mBodyNodes[j]));
+    }
+  }
+
+  return pairs;
+}
+
+//==============================================================================
+void Skeleton::clearDisabledSelfCollisionPairs()
+{
+  mDisabledSelfCollisionPairs.clear();
+}
+
 //==============================================================================
 void Skeleton::setMobile(bool _isMobile)
 {
@@ -214,6 +354,31 @@ double Skeleton::getTimeStep() const
   return mTimeStep;
 }
 
+//==============================================================================
+void Skeleton::setNumSubSteps(size_t _numSubSteps)
+{
+  assert(_numSubSteps > 0 && "Number of sub-steps should be positive.");
+  mNumSubSteps = _numSubSteps;
+}
+
+//==============================================================================
+size_t Skeleton::getNumSubSteps() const
+{
+  return mNumSubSteps;
+}
+
+//==============================================================================
+bool Skeleton::isHeld() const
+{
+  return mIsHeld;
+}
+
+//==============================================================================
+void Skeleton::setHeld(bool _isHeld)
+{
+  mIsHeld = _isHeld;
+}
+
 //==============================================================================
 void Skeleton::setGravity(const Eigen::Vector3d& _gravity)
 {
@@ -345,6 +510,31 @@ const SoftBodyNode* Skeleton::getSoftBodyNode(const std::string& _name) const
   return mNameMgrForSoftBodyNodes.getObject(_name);
 }
 
+//==============================================================================
+BodyNode* Skeleton::getBodyNode(const common::NameHandle& _name)
+{
+  return mNameMgrForBodyNodes.getObject(_name);
+}
+
+//==============================================================================
+const BodyNode* Skeleton::getBodyNode(const common::NameHandle& _name) const
+{
+  return mNameMgrForBodyNodes.getObject(_name);
+}
+
+//==============================================================================
+SoftBodyNode* Skeleton::getSoftBodyNode(const common::NameHandle& _name)
+{
+  return mNameMgrForSoftBodyNodes.getObject(_name);
+}
+
+//==============================================================================
+const SoftBodyNode* Skeleton::getSoftBodyNode(
+    const common::NameHandle& _name) const
+{
+  return mNameMgrForSoftBodyNodes.getObject(_name);
+}
+
 //==============================================================================
 size_t Skeleton::getNumJoints() const
 {
@@ -426,6 +616,42 @@ const Marker* Skeleton::getMarker(const std::string& _name) const
   return const_cast<Skeleton*>(this)->getMarker(_name);
 }
 
+//==============================================================================
+Joint* Skeleton::getJoint(const common::NameHandle& _name)
+{
+  return mNameMgrForJoints.getObject(_name);
+}
+
+//==============================================================================
+const Joint* Skeleton::getJoint(const common::NameHandle& _name) const
+{
+  return mNameMgrForJoints.getObject(_name);
+}
+
+//==============================================================================
+DegreeOfFreedom* Skeleton::getDof(const common::NameHandle& _name)
+{
+  return mNameMgrForDofs.getObject(_name);
+}
+
+//==============================================================================
+const DegreeOfFreedom* Skeleton::getDof(const common::NameHandle& _name) const
+{
+  return mNameMgrForDofs.getObject(_name);
+}
+
+//==============================================================================
+Marker* Skeleton::getMarker(const common::NameHandle& _name)
+{
+  return mNameMgrForMarkers.getObject(_name);
+}
+
+//==============================================================================
+const Marker* Skeleton::getMarker(const common::NameHandle& _name) const
+{
+  return mNameMgrForMarkers.getObject(_name);
+}
+
 //==============================================================================
 void Skeleton::init(double _timeStep, const Eigen::Vector3d& _gravity)
 {
@@ -478,6 +704,26 @@ void Skeleton::init(double _timeStep, const Eigen::Vector3d& _gravity)
     mNumDofs += joint->getNumDofs();
   }
 
+  // Gather the state of all the joints in one buffer. The joints copy their
+  // current values from wherever they are stored now, which may be the
+  // previous buffer, so that one is only released after the swap.
+  Eigen::VectorXd stateBuffer = Eigen::VectorXd::Zero(5 * mNumDofs);
+  double* buffer = stateBuffer.data();
+  for (const auto& bodyNode : mBodyNodes)
+  {
+    Joint* joint = bodyNode->getParentJoint();
+    if (joint->getNumDofs() == 0)
+      continue;
+
+    const size_t index = joint->getIndexInSkeleton(0);
+    joint->setStateStorage(buffer + index,
+                           buffer + mNumDofs + index,
+                           buffer + 2 * mNumDofs + index,
+                           buffer + 3 * mNumDofs + index,
+                           buffer + 4 * mNumDofs + index);
+  }
+  mStateBuffer.swap(stateBuffer);
+
   // Compute transformations, velocities, and partial accelerations
 //  computeForwardDynamicsRecursionPartA(); // No longer needed with auto-update
 
@@ -524,6 +770,175 @@ GenCoordInfo Skeleton::getGenCoordInfo(size_t _index) const
   return mGenCoordInfos[_index];
 }
 
+//==============================================================================
+void Skeleton::beginStateUpdate()
+{
+  ++mStateUpdateDepth;
+}
+
+//==============================================================================
+void Skeleton::endStateUpdate()
+{
+  if (0 == mStateUpdateDepth)
+  {
+    dtwarn << "[Skeleton::endStateUpdate] Skeleton [" << getName() << "] has "
+           << "no batch of state changes to end.\n";
+    return;
+  }
+
+  if (--mStateUpdateDepth > 0)
+    return;
+
+  // A position change also invalidates the velocities and accelerations, and
+  // a velocity change also invalidates the accelerations. Parents come before
+  // their children, so a subtree is visited at most once.
+  for (const auto& bodyNode : mBodyNodes)
+  {
+    Joint* joint = bodyNode->getParentJoint();
+
+    if (joint->mIsPositionUpdatePending)
+      joint->notifyPositionUpdate();
+    else if (joint->mIsVelocityUpdatePending)
+      joint->notifyVelocityUpdate();
+    else if (joint->mIsAccelerationUpdatePending)
+      joint->notifyAccelerationUpdate();
+
+    joint->mIsPositionUpdatePending = false;
+    joint->mIsVelocityUpdatePending = false;
+    joint->mIsAccelerationUpdatePending = false;
+  }
+}
+
+//==============================================================================
+bool Skeleton::isUpdatingState() const
+{
+  return mStateUpdateDepth > 0;
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getPositionsMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data(), mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getVelocitiesMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data() + mNumDofs,
+                                           mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getAccelerationsMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data() + 2 * mNumDofs,
+                                           mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getForcesMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data() + 3 * mNumDofs,
+                                           mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getCommandsMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data() + 4 * mNumDofs,
+                                           mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> Skeleton::getStateMap() const
+{
+  return Eigen::Map<const Eigen::VectorXd>(mStateBuffer.data(), 2 * mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutablePositionsMap()
+{
+  if (!isUpdatingState())
+  {
+    dterr << "[Skeleton::getMutablePositionsMap] Skeleton [" << getName()
+          << "] is not in a batch of state changes. Call beginStateUpdate() "
+          << "first, or the changes will not be noticed.\n";
+    assert(false);
+  }
+
+  for (const auto& bodyNode : mBodyNodes)
+    bodyNode->getParentJoint()->notifyPositionUpdate();
+
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data(), mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutableVelocitiesMap()
+{
+  if (!isUpdatingState())
+  {
+    dterr << "[Skeleton::getMutableVelocitiesMap] Skeleton [" << getName()
+          << "] is not in a batch of state changes. Call beginStateUpdate() "
+          << "first, or the changes will not be noticed.\n";
+    assert(false);
+  }
+
+  for (const auto& bodyNode : mBodyNodes)
+    bodyNode->getParentJoint()->notifyVelocityUpdate();
+
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data() + mNumDofs, mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutableAccelerationsMap()
+{
+  if (!isUpdatingState())
+  {
+    dterr << "[Skeleton::getMutableAccelerationsMap] Skeleton [" << getName()
+          << "] is not in a batch of state changes. Call beginStateUpdate() "
+          << "first, or the changes will not be noticed.\n";
+    assert(false);
+  }
+
+  for (const auto& bodyNode : mBodyNodes)
+    bodyNode->getParentJoint()->notifyAccelerationUpdate();
+
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data() + 2 * mNumDofs,
+                                     mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutableForcesMap()
+{
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data() + 3 * mNumDofs,
+                                     mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutableCommandsMap()
+{
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data() + 4 * mNumDofs,
+                                     mNumDofs);
+}
+
+//==============================================================================
+Eigen::Map<Eigen::VectorXd> Skeleton::getMutableStateMap()
+{
+  if (!isUpdatingState())
+  {
+    dterr << "[Skeleton::getMutableStateMap] Skeleton [" << getName()
+          << "] is not in a batch of state changes. Call beginStateUpdate() "
+          << "first, or the changes will not be noticed.\n";
+    assert(false);
+  }
+
+  // A position change also invalidates everything that depends on velocities
+  for (const auto& bodyNode : mBodyNodes)
+    bodyNode->getParentJoint()->notifyPositionUpdate();
+
+  return Eigen::Map<Eigen::VectorXd>(mStateBuffer.data(), 2 * mNumDofs);
+}
+
 //==============================================================================
 void Skeleton::setCommand(size_t _index, double _command)
 {
@@ -565,21 +980,7 @@ void Skeleton::setCommands(const Eigen::VectorXd& _commands)
 //==============================================================================
 Eigen::VectorXd Skeleton::getCommands() const
 {
-  Eigen::VectorXd commands(getNumDofs());
-
-  for (const auto& bodyNode : mBodyNodes)
-  {
-    const Joint* joint = bodyNode->getParentJoint();
-    const size_t dof   = joint->getNumDofs();
-
-    if (dof)
-    {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
-      commands.segment(index, dof) = joint->getCommands();
-    }
-  }
-
-  return commands;
+  return getCommandsMap();
 }
 
 //==============================================================================
@@ -608,6 +1009,12 @@ double Skeleton::getPosition(size_t _index) const
 //==============================================================================
 void Skeleton::setPositions(const Eigen::VectorXd& _positions)
 {
+  assert(static_cast<size_t>(_positions.size()) == getNumDofs());
+
+  beginStateUpdate();
+
+  // Go through the joints rather than writing the state buffer directly, so
+  // that joints which cache something derived from their positions stay in sync
   for (const auto& bodyNode : mBodyNodes)
   {
     Joint*       joint = bodyNode->getParentJoint();
@@ -615,30 +1022,18 @@ void Skeleton::setPositions(const Eigen::VectorXd& _positions)
 
     if (dof)
     {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
+      size_t index = joint->getIndexInSkeleton(0);
       joint->setPositions(_positions.segment(index, dof));
     }
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
 Eigen::VectorXd Skeleton::getPositions() const
 {
-  Eigen::VectorXd q(getNumDofs());
-
-  for (const auto& bodyNode : mBodyNodes)
-  {
-    const Joint* joint = bodyNode->getParentJoint();
-    const size_t dof   = joint->getNumDofs();
-
-    if (dof)
-    {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
-      q.segment(index, dof) = joint->getPositions();
-    }
-  }
-
-  return q;
+  return getPositionsMap();
 }
 
 //==============================================================================
@@ -666,18 +1061,26 @@ void Skeleton::setPositionSegment(const std::vector<size_t>& _id,
     return;
   }
 
+  beginStateUpdate();
+
   for (size_t i = 0; i < _id.size(); ++i)
   {
     DegreeOfFreedom* dof = getDof(_id[i]);
     dof->setPosition(_positions[i]);
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
 void Skeleton::resetPositions()
 {
+  beginStateUpdate();
+
   for (size_t i = 0; i < mBodyNodes.size(); ++i)
     mBodyNodes[i]->getParentJoint()->resetPositions();
+
+  endStateUpdate();
 }
 
 //==============================================================================
@@ -731,6 +1134,10 @@ double Skeleton::getVelocity(size_t _index) const
 //==============================================================================
 void Skeleton::setVelocities(const Eigen::VectorXd& _velocities)
 {
+  assert(static_cast<size_t>(_velocities.size()) == getNumDofs());
+
+  beginStateUpdate();
+
   for (const auto& bodyNode : mBodyNodes)
   {
     Joint*       joint = bodyNode->getParentJoint();
@@ -738,10 +1145,12 @@ void Skeleton::setVelocities(const Eigen::VectorXd& _velocities)
 
     if (dof)
     {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
+      size_t index = joint->getIndexInSkeleton(0);
       joint->setVelocities(_velocities.segment(index, dof));
     }
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
@@ -757,31 +1166,21 @@ void Skeleton::setVelocitySegment(const std::vector<size_t>& _id,
     return;
   }
 
+  beginStateUpdate();
+
   for (size_t i=0; i<_id.size(); ++i)
   {
     DegreeOfFreedom* dof = getDof(_id[i]);
     dof->setVelocity(_velocities[i]);
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
 Eigen::VectorXd Skeleton::getVelocities() const
 {
-  Eigen::VectorXd dq(getNumDofs());
-
-  for (const auto& bodyNode : mBodyNodes)
-  {
-    const Joint* joint = bodyNode->getParentJoint();
-    const size_t dof   = joint->getNumDofs();
-
-    if (dof)
-    {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
-      dq.segment(index, dof) = joint->getVelocities();
-    }
-  }
-
-  return dq;
+  return getVelocitiesMap();
 }
 
 //==============================================================================
@@ -801,8 +1200,12 @@ Eigen::VectorXd Skeleton::getVelocitySegment(const std::vector<size_t>& _id) con
 //==============================================================================
 void Skeleton::resetVelocities()
 {
+  beginStateUpdate();
+
   for (size_t i = 0; i < mBodyNodes.size(); ++i)
     mBodyNodes[i]->getParentJoint()->resetVelocities();
+
+  endStateUpdate();
 }
 
 //==============================================================================
@@ -856,6 +1259,8 @@ double Skeleton::getAcceleration(size_t _index) const
 //==============================================================================
 void Skeleton::setAccelerations(const Eigen::VectorXd& _accelerations)
 {
+  beginStateUpdate();
+
   for (const auto& bodyNode : mBodyNodes)
   {
     Joint*       joint = bodyNode->getParentJoint();
@@ -867,6 +1272,8 @@ void Skeleton::setAccelerations(const Eigen::VectorXd& _accelerations)
       joint->setAccelerations(_accelerations.segment(index, dof));
     }
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
@@ -882,31 +1289,21 @@ void Skeleton::setAccelerationSegment(const std::vector<size_t>& _id,
     return;
   }
 
+  beginStateUpdate();
+
   for (size_t i=0; i<_id.size(); ++i)
   {
     DegreeOfFreedom* dof = getDof(_id[i]);
     dof->setAcceleration(_accelerations[i]);
   }
+
+  endStateUpdate();
 }
 
 //==============================================================================
 Eigen::VectorXd Skeleton::getAccelerations() const
 {
-  Eigen::VectorXd ddq(getNumDofs());
-
-  for (const auto& bodyNode : mBodyNodes)
-  {
-    const Joint* joint = bodyNode->getParentJoint();
-    const size_t dof   = joint->getNumDofs();
-
-    if (dof)
-    {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
-      ddq.segment(index, dof) = joint->getAccelerations();
-    }
-  }
-
-  return ddq;
+  return getAccelerationsMap();
 }
 
 //==============================================================================
@@ -926,8 +1323,12 @@ Eigen::VectorXd Skeleton::getAccelerationSegment(const std::vector<size_t>& _id)
 //==============================================================================
 void Skeleton::resetAccelerations()
 {
+  beginStateUpdate();
+
   for (size_t i = 0; i < mBodyNodes.size(); ++i)
     mBodyNodes[i]->getParentJoint()->resetAccelerations();
+
+  endStateUpdate();
 }
 
 //==============================================================================
@@ -965,21 +1366,7 @@ void Skeleton::setForces(const Eigen::VectorXd& _forces)
 //==============================================================================
 Eigen::VectorXd Skeleton::getForces() const
 {
-  Eigen::VectorXd forces(getNumDofs());
-
-  for (const auto& bodyNode : mBodyNodes)
-  {
-    const Joint* joint = bodyNode->getParentJoint();
-    const size_t dof   = joint->getNumDofs();
-
-    if (dof)
-    {
-      size_t index = joint->getDof(0)->getIndexInSkeleton();
-      forces.segment(index, dof) = joint->getForces();
-    }
-  }
-
-  return forces;
+  return getForcesMap();
 }
 
 //==============================================================================
@@ -1100,44 +1487,29 @@ Eigen::VectorXd Skeleton::getJointConstraintImpulses() const
 //==============================================================================
 void Skeleton::setState(const Eigen::VectorXd& _state)
 {
-  assert(_state.size() % 2 == 0);
-
-  size_t index = 0;
-  size_t dof = 0;
-  size_t halfSize = _state.size() / 2;
-  Joint* joint;
+  assert(static_cast<size_t>(_state.size()) == 2 * getNumDofs());
 
-  for (size_t i = 0; i < mBodyNodes.size(); ++i)
-  {
-    joint = mBodyNodes[i]->getParentJoint();
-
-    dof = joint->getNumDofs();
-
-    if (dof)
-    {
-      joint->setPositions(_state.segment(index, dof));
-      joint->setVelocities(_state.segment(index + halfSize, dof));
+  const size_t numDofs = getNumDofs();
 
-      index += dof;
-    }
-  }
+  beginStateUpdate();
+  setPositions(_state.head(numDofs));
+  setVelocities(_state.tail(numDofs));
+  endStateUpdate();
 }
 
 //==============================================================================
 Eigen::VectorXd Skeleton::getState() const
 {
-  Eigen::VectorXd state(2 * getNumDofs());
-
-  state << getPositions(), getVelocities();
-
-  return state;
+  return getStateMap();
 }
 
 //==============================================================================
 void Skeleton::integratePositions(double _dt)
 {
+  beginStateUpdate();
   for (size_t i = 0; i < mBodyNodes.size(); ++i)
     mBodyNodes[i]->getParentJoint()->integratePositions(_dt);
+  endStateUpdate();
 
   for (size_t i = 0; i < mSoftBodyNodes.size(); ++i)
   {
@@ -1149,8 +1521,10 @@ void Skeleton::integratePositions(double _dt)
 //==============================================================================
 void Skeleton::integrateVelocities(double _dt)
 {
+  beginStateUpdate();
   for (size_t i = 0; i < mBodyNodes.size(); ++i)
     mBodyNodes[i]->getParentJoint()->integrateVelocities(_dt);
+  endStateUpdate();
 
   for (size_t i = 0; i < mSoftBodyNodes.size(); ++i)
   {
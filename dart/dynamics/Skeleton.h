@@ -38,8 +38,11 @@
 #ifndef DART_DYNAMICS_SKELETON_H_
 #define DART_DYNAMICS_SKELETON_H_
 
-#include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <Eigen/Dense>
 
@@ -52,6 +55,9 @@ namespace dart {
 namespace renderer {
 class RenderInterface;
 }  // namespace renderer
+namespace simulation {
+class World;
+}  // namespace simulation
 }  // namespace dart
 
 namespace dart {
@@ -85,6 +91,13 @@ public:
   /// Destructor
   virtual ~Skeleton();
 
+  /// Create a deep copy of this Skeleton including the state of its joints
+  /// and the external forces on its bodies. The copy is initialized with the
+  /// time step and gravity of this Skeleton. Read-only geometric data, such as
+  /// the meshes of MeshShapes, is shared between this Skeleton and the copy,
+  /// so the cost of a copy does not depend on the size of its meshes.
+  Skeleton* clone() const;
+
   //----------------------------------------------------------------------------
   // Properties
   //----------------------------------------------------------------------------
@@ -108,6 +121,29 @@ public:
   /// bodies
   bool isEnabledAdjacentBodyCheck() const;
 
+  /// Never check the pair of _bodyNode1 and _bodyNode2 for self collision,
+  /// for example because they can not touch in any configuration (see
+  /// collision::SelfCollisionSampler). The pair is copied by clone().
+  void disableSelfCollisionPair(const BodyNode* _bodyNode1,
+                                const BodyNode* _bodyNode2);
+
+  /// Check the pair of _bodyNode1 and _bodyNode2 for self collision again
+  void enableSelfCollisionPair(const BodyNode* _bodyNode1,
+                               const BodyNode* _bodyNode2);
+
+  /// Return false if the pair of _bodyNode1 and _bodyNode2 was disabled by
+  /// disableSelfCollisionPair()
+  bool isSelfCollisionPairEnabled(const BodyNode* _bodyNode1,
+                                  const BodyNode* _bodyNode2) const;
+
+  /// Return the pairs disabled by disableSelfCollisionPair(), each once and
+  /// with the earlier body of the skeleton first, in the order of the bodies
+  std::vector<std::pair<BodyNode*, BodyNode*> >
+      getDisabledSelfCollisionPairs() const;
+
+  /// Enable all the pairs disabled by disableSelfCollisionPair()
+  void clearDisabledSelfCollisionPairs();
+
   /// Set whether this skeleton will be updated by forward dynamics.
   /// \param[in] _isMobile True if this skeleton is mobile.
   void setMobile(bool _isMobile);
@@ -123,6 +159,20 @@ public:
   /// Get time step.
   double getTimeStep() const;
 
+  /// Set the number of steps that this skeleton takes for each step of the
+  /// World, so that a stiff skeleton can use a smaller time step than the
+  /// rest of the world (see simulation::World::step()). The default is 1.
+  void setNumSubSteps(size_t _numSubSteps);
+
+  /// Get the number of steps that this skeleton takes for each step of the
+  /// World
+  size_t getNumSubSteps() const;
+
+  /// Return true while simulation::World::step() holds this skeleton still
+  /// for a sub-step in which it does not step. A held skeleton keeps its
+  /// mobility, but its bodies are not reactive until it is released.
+  bool isHeld() const;
+
   /// Set 3-dim gravitational acceleration. The gravity is used for
   /// calculating gravity force vector of the skeleton.
   void setGravity(const Eigen::Vector3d& _gravity);
@@ -180,6 +230,18 @@ public:
   /// Get const soft body node whose name is _name
   const SoftBodyNode* getSoftBodyNode(const std::string& _name) const;
 
+  /// Get body node whose name is _name without any string work
+  BodyNode* getBodyNode(const common::NameHandle& _name);
+
+  /// Get const body node whose name is _name without any string work
+  const BodyNode* getBodyNode(const common::NameHandle& _name) const;
+
+  /// Get soft body node whose name is _name without any string work
+  SoftBodyNode* getSoftBodyNode(const common::NameHandle& _name);
+
+  /// Get const soft body node whose name is _name without any string work
+  const SoftBodyNode* getSoftBodyNode(const common::NameHandle& _name) const;
+
   /// Get number of joints
   size_t getNumJoints() const;
 
@@ -213,6 +275,24 @@ public:
   /// Get const marker whose name is _name
   const Marker* getMarker(const std::string& _name) const;
 
+  /// Get joint whose name is _name without any string work
+  Joint* getJoint(const common::NameHandle& _name);
+
+  /// Get const joint whose name is _name without any string work
+  const Joint* getJoint(const common::NameHandle& _name) const;
+
+  /// Get degree of freedom whose name is _name without any string work
+  DegreeOfFreedom* getDof(const common::NameHandle& _name);
+
+  /// Get const degree of freedom whose name is _name without any string work
+  const DegreeOfFreedom* getDof(const common::NameHandle& _name) const;
+
+  /// Get marker whose name is _name without any string work
+  Marker* getMarker(const common::NameHandle& _name);
+
+  /// Get const marker whose name is _name without any string work
+  const Marker* getMarker(const common::NameHandle& _name) const;
+
   //----------------------------------------------------------------------------
   // Initialization
   //----------------------------------------------------------------------------
@@ -239,6 +319,89 @@ public:
   DEPRECATED(4.3)
   GenCoordInfo getGenCoordInfo(size_t _index) const;
 
+  //----------------------------------------------------------------------------
+  /// \{ \name Batched state update
+  //----------------------------------------------------------------------------
+
+  /// Start a batch of state changes. Until the matching endStateUpdate(),
+  /// changing a generalized position, velocity or acceleration only marks its
+  /// Joint, and the BodyNodes are notified once at the end of the batch
+  /// instead of once per change. Batches may be nested; only the outermost
+  /// endStateUpdate() notifies the BodyNodes.
+  ///
+  /// The kinematic quantities of the BodyNodes (transforms, velocities,
+  /// accelerations, Jacobians) must not be read inside a batch, since they
+  /// are not invalidated until it ends. The whole-vector setters, such as
+  /// setPositions(), use a batch internally.
+  void beginStateUpdate();
+
+  /// End a batch of state changes started by beginStateUpdate()
+  void endStateUpdate();
+
+  /// Return true if a batch of state changes is in progress
+  bool isUpdatingState() const;
+
+  /// \}
+
+  //----------------------------------------------------------------------------
+  /// \{ \name State views
+  //----------------------------------------------------------------------------
+
+  // The generalized positions, velocities, accelerations, forces and commands
+  // of all the joints are stored back to back in one buffer owned by the
+  // Skeleton, in the order of the DOF indices. The views below read and write
+  // that buffer directly, without copying or allocating. They stay valid until
+  // the next call to init().
+
+  /// Get a read-only view of the generalized positions
+  Eigen::Map<const Eigen::VectorXd> getPositionsMap() const;
+
+  /// Get a read-only view of the generalized velocities
+  Eigen::Map<const Eigen::VectorXd> getVelocitiesMap() const;
+
+  /// Get a read-only view of the generalized accelerations
+  Eigen::Map<const Eigen::VectorXd> getAccelerationsMap() const;
+
+  /// Get a read-only view of the generalized forces
+  Eigen::Map<const Eigen::VectorXd> getForcesMap() const;
+
+  /// Get a read-only view of the commands
+  Eigen::Map<const Eigen::VectorXd> getCommandsMap() const;
+
+  /// Get a read-only view of the state, which is the generalized positions
+  /// followed by the generalized velocities, like getState()
+  Eigen::Map<const Eigen::VectorXd> getStateMap() const;
+
+  /// Get a writable view of the generalized positions. All the positions are
+  /// considered changed, so this must be called between beginStateUpdate()
+  /// and endStateUpdate(), and the view must not be written after the batch
+  /// ends. Writes go straight to the state buffer without calling
+  /// Joint::setPositions(); use setPositions() when that matters.
+  Eigen::Map<Eigen::VectorXd> getMutablePositionsMap();
+
+  /// Get a writable view of the generalized velocities. The same rules as for
+  /// getMutablePositionsMap() apply.
+  Eigen::Map<Eigen::VectorXd> getMutableVelocitiesMap();
+
+  /// Get a writable view of the generalized accelerations. The same rules as
+  /// for getMutablePositionsMap() apply.
+  Eigen::Map<Eigen::VectorXd> getMutableAccelerationsMap();
+
+  /// Get a writable view of the generalized forces. No batch is needed since
+  /// nothing depends on the forces, but unlike setForces(), writing through
+  /// the view does not update the commands of FORCE actuated joints.
+  Eigen::Map<Eigen::VectorXd> getMutableForcesMap();
+
+  /// Get a writable view of the commands. No batch is needed.
+  Eigen::Map<Eigen::VectorXd> getMutableCommandsMap();
+
+  /// Get a writable view of the state, which is the generalized positions
+  /// followed by the generalized velocities. The same rules as for
+  /// getMutablePositionsMap() apply.
+  Eigen::Map<Eigen::VectorXd> getMutableStateMap();
+
+  /// \}
+
   //----------------------------------------------------------------------------
   /// \{ \name Command
   //----------------------------------------------------------------------------
@@ -856,8 +1019,13 @@ public:
   friend class SoftBodyNode;
   friend class Joint;
   friend class DegreeOfFreedom;
+  friend class simulation::World;
 
 protected:
+  /// Hold this skeleton still, or release it. Used by simulation::World
+  /// while it sub-steps other skeletons.
+  void setHeld(bool _isHeld);
+
   /// Register a joint with the Skeleton. Internal use only.
   void registerJoint(Joint* _newJoint);
 
@@ -962,6 +1130,11 @@ protected:
   /// True if self collision check is enabled including adjacent bodies
   bool mEnabledAdjacentBodyCheck;
 
+  /// Pairs of bodies that are never checked for self collision, stored in
+  /// both directions
+  std::unordered_map<const BodyNode*, std::unordered_set<const BodyNode*> >
+      mDisabledSelfCollisionPairs;
+
   /// List of body nodes in the skeleton.
   std::vector<BodyNode*> mBodyNodes;
 
@@ -991,6 +1164,12 @@ protected:
   /// Time step for implicit joint damping force.
   double mTimeStep;
 
+  /// Number of steps for each step of the World
+  size_t mNumSubSteps;
+
+  /// Whether the World holds this skeleton still for the current sub-step
+  bool mIsHeld;
+
   /// Gravity vector.
   Eigen::Vector3d mGravity;
 
@@ -1062,6 +1241,14 @@ protected:
   /// Flag for status of impulse testing.
   bool mIsImpulseApplied;
 
+  /// Number of nested batches of state changes in progress
+  size_t mStateUpdateDepth;
+
+  /// Generalized positions, velocities, accelerations, forces and commands of
+  /// all the joints, each block being getNumDofs() long. The joints keep their
+  /// state in this buffer once init() has been called.
+  Eigen::VectorXd mStateBuffer;
+
   //----------------------------------------------------------------------------
   // Union finding
   //----------------------------------------------------------------------------
@@ -74,6 +74,14 @@ SoftBodyNode::~SoftBodyNode()
     delete mPointMasses[i];
 }
 
+//==============================================================================
+SoftBodyNode* SoftBodyNode::clone() const
+{
+  SoftBodyNode* softBodyNode = new SoftBodyNode(mName);
+  softBodyNode->copyPropertiesAndState(this);
+  return softBodyNode;
+}
+
 //==============================================================================
 size_t SoftBodyNode::getNumPointMasses() const
 {
@@ -119,6 +127,56 @@ void SoftBodyNode::init(Skeleton* _skeleton)
 //  BodyNode::addCollisionShape(mSoftCollShape);
 }
 
+//==============================================================================
+void SoftBodyNode::copyPropertiesAndState(const BodyNode* _otherBodyNode)
+{
+  const SoftBodyNode* other = static_cast<const SoftBodyNode*>(_otherBodyNode);
+
+  mKv        = other->mKv;
+  mKe        = other->mKe;
+  mDampCoeff = other->mDampCoeff;
+  mFaces     = other->mFaces;
+
+  // The PointMasses have to exist before the SoftMeshShapes are rebuilt by
+  // BodyNode::copyPropertiesAndState()
+  std::map<const PointMass*, size_t> indices;
+  for (size_t i = 0; i < other->mPointMasses.size(); ++i)
+  {
+    const PointMass* otherPointMass = other->mPointMasses[i];
+    PointMass* pointMass = new PointMass(this);
+    pointMass->setMass(otherPointMass->getMass());
+    pointMass->setRestingPosition(otherPointMass->getRestingPosition());
+    pointMass->setPositions(otherPointMass->getPositions());
+    pointMass->setVelocities(otherPointMass->getVelocities());
+    addPointMass(pointMass);
+    indices[otherPointMass] = i;
+  }
+
+  for (size_t i = 0; i < other->mPointMasses.size(); ++i)
+  {
+    const PointMass* otherPointMass = other->mPointMasses[i];
+    for (int j = 0; j < otherPointMass->getNumConnectedPointMasses(); ++j)
+    {
+      size_t index = indices[otherPointMass->getConnectedPointMass(j)];
+      mPointMasses[i]->addConnectedPointMass(mPointMasses[index]);
+    }
+  }
+
+  BodyNode::copyPropertiesAndState(_otherBodyNode);
+}
+
+//==============================================================================
+Shape* SoftBodyNode::cloneShape(const Shape* _shape)
+{
+  if (_shape->getShapeType() != Shape::SOFT_MESH)
+    return BodyNode::cloneShape(_shape);
+
+  SoftMeshShape* softMeshShape = new SoftMeshShape(this);
+  softMeshShape->setRGBA(_shape->getRGBA());
+  softMeshShape->setLocalTransform(_shape->getLocalTransform());
+  return softMeshShape;
+}
+
 //==============================================================================
 //void SoftBodyNode::aggregateGenCoords(std::vector<GenCoord*>* _genCoords)
 //{
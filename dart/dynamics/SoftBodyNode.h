@@ -75,6 +75,10 @@ public:
   /// \brief
   virtual ~SoftBodyNode();
 
+  /// Create a copy of this SoftBodyNode including its PointMasses. The
+  /// SoftMeshShapes of the copy are rebuilt from the copied PointMasses.
+  virtual SoftBodyNode* clone() const override;
+
   /// Get the update notifier for the PointMasses of this SoftBodyNode
   PointMassNotifier* getNotifier();
 
@@ -139,6 +143,12 @@ protected:
   // Documentation inherited.
   virtual void init(Skeleton* _skeleton);
 
+  // Documentation inherited.
+  virtual void copyPropertiesAndState(const BodyNode* _otherBodyNode) override;
+
+  // Documentation inherited.
+  virtual Shape* cloneShape(const Shape* _shape) override;
+
   // Documentation inherited.
 //  virtual void aggregateGenCoords(std::vector<GenCoord*>* _genCoords);
 
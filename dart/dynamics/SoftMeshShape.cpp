@@ -60,6 +60,14 @@ SoftMeshShape::~SoftMeshShape()
   delete mAssimpMesh;
 }
 
+Shape* SoftMeshShape::clone() const
+{
+  SoftMeshShape* softMesh = new SoftMeshShape(mSoftBodyNode);
+  softMesh->setRGBA(mColor);
+  softMesh->setLocalTransform(mTransform);
+  return softMesh;
+}
+
 const aiMesh* SoftMeshShape::getAssimpMesh() const
 {
   return mAssimpMesh;
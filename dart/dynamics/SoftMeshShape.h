@@ -56,6 +56,10 @@ public:
   /// \brief Destructor.
   virtual ~SoftMeshShape();
 
+  /// \brief Create a SoftMeshShape for the same SoftBodyNode. Use
+  /// SoftBodyNode::clone() to copy the soft body itself.
+  virtual Shape* clone() const;
+
   /// \brief
   const aiMesh* getAssimpMesh() const;
 
@@ -57,6 +57,14 @@ TranslationalJoint::~TranslationalJoint()
 {
 }
 
+//==============================================================================
+Joint* TranslationalJoint::clone() const
+{
+  TranslationalJoint* joint = new TranslationalJoint(mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 Eigen::Matrix<double, 6, 3> TranslationalJoint::getLocalJacobianStatic(
     const Eigen::Vector3d& /*_positions*/) const
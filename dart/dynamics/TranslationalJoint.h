@@ -54,6 +54,9 @@ public:
   /// Destructor
   virtual ~TranslationalJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   // Documentation inherited
   Eigen::Matrix<double, 6, 3> getLocalJacobianStatic(
       const Eigen::Vector3d& _positions) const override;
@@ -62,6 +62,16 @@ UniversalJoint::~UniversalJoint()
 {
 }
 
+//==============================================================================
+Joint* UniversalJoint::clone() const
+{
+  UniversalJoint* joint = new UniversalJoint(getAxis1(), getAxis2(), mName);
+  joint->setAxis1(mAxis[0]);
+  joint->setAxis2(mAxis[1]);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void UniversalJoint::setAxis1(const Eigen::Vector3d& _axis)
 {
@@ -58,6 +58,9 @@ public:
   /// Destructor
   virtual ~UniversalJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   ///
   void setAxis1(const Eigen::Vector3d& _axis);
 
@@ -55,6 +55,14 @@ WeldJoint::~WeldJoint()
 {
 }
 
+//==============================================================================
+Joint* WeldJoint::clone() const
+{
+  WeldJoint* joint = new WeldJoint(mName);
+  joint->copyPropertiesAndState(this);
+  return joint;
+}
+
 //==============================================================================
 void WeldJoint::setTransformFromParentBodyNode(const Eigen::Isometry3d& _T)
 {
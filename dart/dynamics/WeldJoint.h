@@ -56,6 +56,9 @@ public:
   /// Destructor
   virtual ~WeldJoint();
 
+  // Documentation inherited
+  virtual Joint* clone() const override;
+
   // Documentation inherited
   virtual void setTransformFromParentBodyNode(const Eigen::Isometry3d& _T) override;
 
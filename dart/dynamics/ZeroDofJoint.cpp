@@ -95,6 +95,12 @@ size_t ZeroDofJoint::getIndexInSkeleton(size_t _index) const
   return 0;
 }
 
+//==============================================================================
+void ZeroDofJoint::setStateStorage(double*, double*, double*, double*, double*)
+{
+  // Do nothing
+}
+
 //==============================================================================
 void ZeroDofJoint::setCommand(size_t /*_index*/, double /*_command*/)
 {
@@ -80,6 +80,11 @@ public:
   // Documentation inherited
   virtual size_t getIndexInSkeleton(size_t _index) const;
 
+  // Documentation inherited
+  virtual void setStateStorage(double* _positions, double* _velocities,
+                               double* _accelerations, double* _forces,
+                               double* _commands);
+
   //----------------------------------------------------------------------------
   // Command
   //----------------------------------------------------------------------------
@@ -0,0 +1,809 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/math/ConvexHull.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace dart {
+namespace math {
+
+namespace {
+
+/// Triangle of a hull under construction
+struct HullFace
+{
+  /// Vertices of the triangle in counterclockwise order
+  Eigen::Vector3i mVertices;
+
+  /// Outward unit normal
+  Eigen::Vector3d mNormal;
+
+  /// Offset of the plane of the triangle
+  double mOffset;
+
+  /// Points that are outside the hull on this side of the triangle
+  std::vector<int> mOutsidePoints;
+
+  /// Whether the triangle is still part of the hull
+  bool mIsAlive;
+
+  /// Last search for visible triangles that reached this triangle
+  size_t mVisitId;
+};
+
+/// Key of the directed edge from _a to _b
+uint64_t getEdgeKey(int _a, int _b)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(_a)) << 32)
+      | static_cast<uint32_t>(_b);
+}
+
+/// Create the face (_a, _b, _c) of the hull of _points
+HullFace createFace(const std::vector<Eigen::Vector3d>& _points,
+                    int _a, int _b, int _c)
+{
+  HullFace face;
+  face.mVertices = Eigen::Vector3i(_a, _b, _c);
+  face.mNormal = (_points[_b] - _points[_a]).cross(_points[_c] - _points[_a]);
+  double norm = face.mNormal.norm();
+  if (norm > 0.0)
+    face.mNormal /= norm;
+  face.mOffset = face.mNormal.dot(_points[_a]);
+  face.mIsAlive = true;
+  face.mVisitId = 0;
+  return face;
+}
+
+/// Return the index of the point of _points that is farthest from _point
+size_t findFarthestPoint(const std::vector<Eigen::Vector3d>& _points,
+                         const Eigen::Vector3d& _point, double* _distance)
+{
+  size_t farthest = 0;
+  *_distance = -1.0;
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    double distance = (_points[i] - _point).norm();
+    if (distance > *_distance)
+    {
+      *_distance = distance;
+      farthest = i;
+    }
+  }
+  return farthest;
+}
+
+/// Add _point to the outside points of the face of _faces[_begin, _end) that
+/// it is farthest above. Points below all the faces are dropped.
+void assignOutsidePoint(const std::vector<Eigen::Vector3d>& _points,
+                        int _point, std::vector<HullFace>* _faces,
+                        size_t _begin, size_t _end, double _eps)
+{
+  size_t farthest = _end;
+  double maxDistance = _eps;
+  for (size_t i = _begin; i < _end; ++i)
+  {
+    const HullFace& face = (*_faces)[i];
+    double distance = face.mNormal.dot(_points[_point]) - face.mOffset;
+    if (distance > maxDistance)
+    {
+      maxDistance = distance;
+      farthest = i;
+    }
+  }
+
+  if (farthest != _end)
+    (*_faces)[farthest].mOutsidePoints.push_back(_point);
+}
+
+} // anonymous namespace
+
+//==============================================================================
+ConvexHull::ConvexHull()
+{
+}
+
+//==============================================================================
+ConvexHull::ConvexHull(const std::vector<Eigen::Vector3d>& _points)
+{
+  if (_points.empty())
+    return;
+
+  // Points closer than this to a plane are considered to be on the plane
+  Eigen::Vector3d lower = _points[0];
+  Eigen::Vector3d upper = _points[0];
+  for (size_t i = 1; i < _points.size(); ++i)
+  {
+    lower = lower.cwiseMin(_points[i]);
+    upper = upper.cwiseMax(_points[i]);
+  }
+  const double eps = 1e-9 * (upper - lower).norm();
+
+  // Two points at the ends of the widest extent of the points
+  double distance;
+  size_t i1 = findFarthestPoint(_points, _points[0], &distance);
+  size_t i0 = findFarthestPoint(_points, _points[i1], &distance);
+  if (distance <= eps)
+  {
+    mVertices.push_back(_points[i0]);
+    return;
+  }
+
+  // The point farthest from their line
+  const Eigen::Vector3d axis = (_points[i1] - _points[i0]) / distance;
+  size_t i2 = 0;
+  distance = -1.0;
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    double lineDistance = axis.cross(_points[i] - _points[i0]).norm();
+    if (lineDistance > distance)
+    {
+      distance = lineDistance;
+      i2 = i;
+    }
+  }
+  if (distance <= eps)
+  {
+    mVertices.push_back(_points[i0]);
+    mVertices.push_back(_points[i1]);
+    return;
+  }
+
+  // The point farthest from their plane
+  const Eigen::Vector3d normal
+      = axis.cross(_points[i2] - _points[i0]).normalized();
+  size_t i3 = 0;
+  distance = -1.0;
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    double planeDistance = std::abs(normal.dot(_points[i] - _points[i0]));
+    if (planeDistance > distance)
+    {
+      distance = planeDistance;
+      i3 = i;
+    }
+  }
+  if (distance <= eps)
+  {
+    // Flat hulls only need their points for support mapping
+    mVertices = _points;
+    return;
+  }
+
+  // Start from the tetrahedron with outward facing triangles
+  const int tetrahedron[4] = { static_cast<int>(i0), static_cast<int>(i1),
+                               static_cast<int>(i2), static_cast<int>(i3) };
+  const Eigen::Vector3d center = 0.25 * (_points[i0] + _points[i1]
+                                         + _points[i2] + _points[i3]);
+  std::vector<HullFace> faces;
+  std::unordered_map<uint64_t, size_t> edgeFaces;
+  for (int i = 0; i < 4; ++i)
+  {
+    int a = tetrahedron[i];
+    int b = tetrahedron[(i + 1) % 4];
+    int c = tetrahedron[(i + 2) % 4];
+    HullFace face = createFace(_points, a, b, c);
+    if (face.mNormal.dot(center) > face.mOffset)
+      face = createFace(_points, a, c, b);
+    for (int k = 0; k < 3; ++k)
+    {
+      edgeFaces[getEdgeKey(face.mVertices[k], face.mVertices[(k + 1) % 3])]
+          = faces.size();
+    }
+    faces.push_back(face);
+  }
+
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    if (i != i0 && i != i1 && i != i2 && i != i3)
+      assignOutsidePoint(_points, i, &faces, 0, faces.size(), eps);
+  }
+
+  // Quickhull: extend the hull to the farthest outside point of a face until
+  // no face has outside points left
+  std::vector<size_t> pendingFaces;
+  for (size_t i = 0; i < faces.size(); ++i)
+    pendingFaces.push_back(i);
+
+  std::vector<size_t> visibleFaces;
+  std::vector<std::pair<int, int> > horizon;
+  std::vector<int> orphanPoints;
+  size_t visitId = 0;
+  while (!pendingFaces.empty())
+  {
+    const size_t start = pendingFaces.back();
+    pendingFaces.pop_back();
+    if (!faces[start].mIsAlive || faces[start].mOutsidePoints.empty())
+      continue;
+
+    // The farthest outside point becomes a vertex of the hull
+    int apex = faces[start].mOutsidePoints[0];
+    double maxDistance = -1.0;
+    for (size_t i = 0; i < faces[start].mOutsidePoints.size(); ++i)
+    {
+      int point = faces[start].mOutsidePoints[i];
+      double distance = faces[start].mNormal.dot(_points[point]);
+      if (distance > maxDistance)
+      {
+        maxDistance = distance;
+        apex = point;
+      }
+    }
+
+    // Walk over the faces that can see the apex and collect the edges
+    // between them and the faces that can not
+    ++visitId;
+    visibleFaces.assign(1, start);
+    faces[start].mVisitId = visitId;
+    horizon.clear();
+    for (size_t i = 0; i < visibleFaces.size(); ++i)
+    {
+      const Eigen::Vector3i vertices = faces[visibleFaces[i]].mVertices;
+      for (int k = 0; k < 3; ++k)
+      {
+        const int a = vertices[k];
+        const int b = vertices[(k + 1) % 3];
+        const size_t neighbor = edgeFaces[getEdgeKey(b, a)];
+        HullFace& face = faces[neighbor];
+        if (face.mVisitId == visitId)
+          continue;
+
+        if (face.mNormal.dot(_points[apex]) - face.mOffset > eps)
+        {
+          face.mVisitId = visitId;
+          visibleFaces.push_back(neighbor);
+        }
+        else
+        {
+          horizon.push_back(std::make_pair(a, b));
+        }
+      }
+    }
+
+    // Remove the visible faces and keep their outside points
+    orphanPoints.clear();
+    for (size_t i = 0; i < visibleFaces.size(); ++i)
+    {
+      HullFace& face = faces[visibleFaces[i]];
+      for (size_t j = 0; j < face.mOutsidePoints.size(); ++j)
+      {
+        if (face.mOutsidePoints[j] != apex)
+          orphanPoints.push_back(face.mOutsidePoints[j]);
+      }
+      face.mOutsidePoints.clear();
+      face.mIsAlive = false;
+      for (int k = 0; k < 3; ++k)
+      {
+        edgeFaces.erase(getEdgeKey(face.mVertices[k],
+                                   face.mVertices[(k + 1) % 3]));
+      }
+    }
+
+    // Close the hole with triangles from its border to the apex
+    const size_t firstNewFace = faces.size();
+    for (size_t i = 0; i < horizon.size(); ++i)
+    {
+      HullFace face = createFace(_points, horizon[i].first,
+                                 horizon[i].second, apex);
+      for (int k = 0; k < 3; ++k)
+      {
+        edgeFaces[getEdgeKey(face.mVertices[k], face.mVertices[(k + 1) % 3])]
+            = faces.size();
+      }
+      pendingFaces.push_back(faces.size());
+      faces.push_back(face);
+    }
+
+    for (size_t i = 0; i < orphanPoints.size(); ++i)
+    {
+      assignOutsidePoint(_points, orphanPoints[i], &faces,
+                         firstNewFace, faces.size(), eps);
+    }
+  }
+
+  // Keep only the points that ended up on the hull
+  std::vector<int> newIndices(_points.size(), -1);
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    if (!faces[i].mIsAlive)
+      continue;
+
+    Eigen::Vector3i triangle;
+    for (int k = 0; k < 3; ++k)
+    {
+      int& newIndex = newIndices[faces[i].mVertices[k]];
+      if (newIndex < 0)
+      {
+        newIndex = static_cast<int>(mVertices.size());
+        mVertices.push_back(_points[faces[i].mVertices[k]]);
+      }
+      triangle[k] = newIndex;
+    }
+    mFaces.push_back(triangle);
+    mNormals.push_back(faces[i].mNormal);
+    mOffsets.push_back(faces[i].mOffset);
+  }
+}
+
+//==============================================================================
+const std::vector<Eigen::Vector3d>& ConvexHull::getVertices() const
+{
+  return mVertices;
+}
+
+//==============================================================================
+const std::vector<Eigen::Vector3i>& ConvexHull::getFaces() const
+{
+  return mFaces;
+}
+
+//==============================================================================
+const Eigen::Vector3d& ConvexHull::getFaceNormal(size_t _index) const
+{
+  assert(_index < mNormals.size());
+  return mNormals[_index];
+}
+
+//==============================================================================
+double ConvexHull::getFaceOffset(size_t _index) const
+{
+  assert(_index < mOffsets.size());
+  return mOffsets[_index];
+}
+
+//==============================================================================
+bool ConvexHull::isEmpty() const
+{
+  return mVertices.empty();
+}
+
+//==============================================================================
+bool ConvexHull::hasVolume() const
+{
+  return !mFaces.empty();
+}
+
+//==============================================================================
+const Eigen::Vector3d& ConvexHull::getSupportPoint(
+    const Eigen::Vector3d& _direction) const
+{
+  assert(!mVertices.empty());
+
+  size_t support = 0;
+  double maxDistance = _direction.dot(mVertices[0]);
+  for (size_t i = 1; i < mVertices.size(); ++i)
+  {
+    double distance = _direction.dot(mVertices[i]);
+    if (distance > maxDistance)
+    {
+      maxDistance = distance;
+      support = i;
+    }
+  }
+
+  return mVertices[support];
+}
+
+//==============================================================================
+double ConvexHull::computeSignedDistance(const Eigen::Vector3d& _point) const
+{
+  if (mFaces.empty())
+    return std::numeric_limits<double>::infinity();
+
+  double distance = -std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < mFaces.size(); ++i)
+    distance = std::max(distance, mNormals[i].dot(_point) - mOffsets[i]);
+
+  return distance;
+}
+
+//==============================================================================
+double ConvexHull::computeVolume() const
+{
+  double volume = 0.0;
+  for (size_t i = 0; i < mFaces.size(); ++i)
+  {
+    const Eigen::Vector3i& face = mFaces[i];
+    volume += mVertices[face[0]].dot(
+          mVertices[face[1]].cross(mVertices[face[2]]));
+  }
+
+  return volume / 6.0;
+}
+
+//==============================================================================
+Eigen::Vector3d ConvexHull::computeCenter() const
+{
+  Eigen::Vector3d center = Eigen::Vector3d::Zero();
+  for (size_t i = 0; i < mVertices.size(); ++i)
+    center += mVertices[i];
+
+  if (!mVertices.empty())
+    center /= static_cast<double>(mVertices.size());
+
+  return center;
+}
+
+namespace {
+
+/// Part of a mesh that is approximated by one convex hull
+struct ConvexPiece
+{
+  /// Corners of the triangles of the piece, three per triangle
+  std::vector<Eigen::Vector3d> mCorners;
+
+  /// Normals of the planes that cut the piece out of the mesh
+  std::vector<Eigen::Vector3d> mCutNormals;
+
+  /// Offsets of the planes that cut the piece out of the mesh
+  std::vector<double> mCutOffsets;
+
+  /// Convex hull of the triangles
+  ConvexHull mHull;
+
+  /// Volume of the hull
+  double mHullVolume;
+
+  /// Volume of the hull that is not enclosed by the triangles
+  double mExcessVolume;
+
+  /// Whether the piece may still be split
+  bool mIsSplittable;
+};
+
+/// Compute the hull of _piece and how well it approximates the triangles
+void updatePiece(ConvexPiece* _piece)
+{
+  _piece->mHull = ConvexHull(_piece->mCorners);
+  _piece->mHullVolume = _piece->mHull.computeVolume();
+  _piece->mIsSplittable = _piece->mHullVolume > 0.0;
+
+  // The triangles of a piece that was cut out of a closed mesh leave holes
+  // in the cut planes. Measuring the enclosed volume from a point on the cut
+  // planes ignores those holes, because the missing caps lie in planes
+  // through the point.
+  const Eigen::Vector3d center = _piece->mHull.computeCenter();
+  const double regularization = 1e-6;
+  Eigen::Matrix3d A = regularization * Eigen::Matrix3d::Identity();
+  Eigen::Vector3d b = regularization * center;
+  for (size_t i = 0; i < _piece->mCutNormals.size(); ++i)
+  {
+    A += _piece->mCutNormals[i] * _piece->mCutNormals[i].transpose();
+    b += _piece->mCutOffsets[i] * _piece->mCutNormals[i];
+  }
+  const Eigen::Vector3d reference = A.ldlt().solve(b);
+
+  double enclosedVolume = 0.0;
+  for (size_t i = 0; i + 2 < _piece->mCorners.size(); i += 3)
+  {
+    enclosedVolume += (_piece->mCorners[i] - reference).dot(
+          (_piece->mCorners[i + 1] - reference).cross(
+            _piece->mCorners[i + 2] - reference));
+  }
+  enclosedVolume = std::abs(enclosedVolume) / 6.0;
+
+  _piece->mExcessVolume
+      = std::max(_piece->mHullVolume - enclosedVolume, 0.0);
+}
+
+/// Add the triangles of the polygon _polygon to _corners
+void addPolygon(const std::vector<Eigen::Vector3d>& _polygon,
+                std::vector<Eigen::Vector3d>* _corners)
+{
+  for (size_t i = 2; i < _polygon.size(); ++i)
+  {
+    _corners->push_back(_polygon[0]);
+    _corners->push_back(_polygon[i - 1]);
+    _corners->push_back(_polygon[i]);
+  }
+}
+
+/// Cut _piece with the plane where coordinate _axis equals _offset into the
+/// part below the plane, _below, and the part above it, _above
+void splitPiece(const ConvexPiece& _piece, int _axis, double _offset,
+                ConvexPiece* _below, ConvexPiece* _above)
+{
+  _below->mCorners.clear();
+  _above->mCorners.clear();
+
+  std::vector<Eigen::Vector3d> belowPolygon;
+  std::vector<Eigen::Vector3d> abovePolygon;
+  for (size_t i = 0; i + 2 < _piece.mCorners.size(); i += 3)
+  {
+    // Triangles in the plane bound the side that their normal points away
+    // from
+    const Eigen::Vector3d* corners = &_piece.mCorners[i];
+    if (corners[0][_axis] == _offset && corners[1][_axis] == _offset
+        && corners[2][_axis] == _offset)
+    {
+      const double normal
+          = (corners[1] - corners[0]).cross(corners[2] - corners[0])[_axis];
+      std::vector<Eigen::Vector3d>& sideCorners
+          = normal > 0.0 ? _below->mCorners : _above->mCorners;
+      sideCorners.insert(sideCorners.end(), corners, corners + 3);
+      continue;
+    }
+
+    belowPolygon.clear();
+    abovePolygon.clear();
+    for (size_t k = 0; k < 3; ++k)
+    {
+      const Eigen::Vector3d& p = _piece.mCorners[i + k];
+      const Eigen::Vector3d& q = _piece.mCorners[i + (k + 1) % 3];
+      const double sp = p[_axis] - _offset;
+      const double sq = q[_axis] - _offset;
+
+      if (sp <= 0.0)
+        belowPolygon.push_back(p);
+      if (sp >= 0.0)
+        abovePolygon.push_back(p);
+
+      // The edge crosses the plane
+      if ((sp < 0.0 && sq > 0.0) || (sp > 0.0 && sq < 0.0))
+      {
+        const Eigen::Vector3d crossing = p + (sp / (sp - sq)) * (q - p);
+        belowPolygon.push_back(crossing);
+        abovePolygon.push_back(crossing);
+      }
+    }
+    addPolygon(belowPolygon, &_below->mCorners);
+    addPolygon(abovePolygon, &_above->mCorners);
+  }
+
+  _below->mCutNormals = _piece.mCutNormals;
+  _below->mCutOffsets = _piece.mCutOffsets;
+  _below->mCutNormals.push_back(Eigen::Vector3d::Unit(_axis));
+  _below->mCutOffsets.push_back(_offset);
+  _above->mCutNormals = _below->mCutNormals;
+  _above->mCutOffsets = _below->mCutOffsets;
+
+  updatePiece(_below);
+  updatePiece(_above);
+}
+
+/// Find the root of _index in the disjoint sets of _parents
+size_t findRoot(std::vector<size_t>* _parents, size_t _index)
+{
+  while ((*_parents)[_index] != _index)
+  {
+    (*_parents)[_index] = (*_parents)[(*_parents)[_index]];
+    _index = (*_parents)[_index];
+  }
+  return _index;
+}
+
+/// Group the triangles into the connected parts of the mesh. Vertices at the
+/// same position connect triangles even if their indices differ.
+std::vector<std::vector<size_t> > findConnectedParts(
+    const std::vector<Eigen::Vector3d>& _vertices,
+    const std::vector<Eigen::Vector3i>& _triangles)
+{
+  std::map<std::tuple<double, double, double>, size_t> positions;
+  std::vector<size_t> parents(_vertices.size());
+  for (size_t i = 0; i < _vertices.size(); ++i)
+  {
+    const Eigen::Vector3d& v = _vertices[i];
+    parents[i] = positions.insert(std::make_pair(
+        std::make_tuple(v[0], v[1], v[2]), i)).first->second;
+  }
+
+  for (size_t i = 0; i < _triangles.size(); ++i)
+  {
+    size_t root0 = findRoot(&parents, _triangles[i][0]);
+    for (int k = 1; k < 3; ++k)
+    {
+      size_t root = findRoot(&parents, _triangles[i][k]);
+      if (root != root0)
+        parents[root] = root0;
+    }
+  }
+
+  std::map<size_t, size_t> partIndices;
+  std::vector<std::vector<size_t> > parts;
+  for (size_t i = 0; i < _triangles.size(); ++i)
+  {
+    size_t root = findRoot(&parents, _triangles[i][0]);
+    std::map<size_t, size_t>::iterator it = partIndices.find(root);
+    if (it == partIndices.end())
+    {
+      it = partIndices.insert(std::make_pair(root, parts.size())).first;
+      parts.push_back(std::vector<size_t>());
+    }
+    parts[it->second].push_back(i);
+  }
+
+  return parts;
+}
+
+/// Merge _parts into _maxNumParts groups of neighboring parts
+void mergeParts(const std::vector<Eigen::Vector3d>& _vertices,
+                const std::vector<Eigen::Vector3i>& _triangles,
+                size_t _maxNumParts, std::vector<std::vector<size_t> >* _parts)
+{
+  if (_parts->size() <= _maxNumParts)
+    return;
+
+  // Order the parts along the longest extent of the mesh
+  Eigen::Vector3d lower = _vertices[0];
+  Eigen::Vector3d upper = _vertices[0];
+  for (size_t i = 1; i < _vertices.size(); ++i)
+  {
+    lower = lower.cwiseMin(_vertices[i]);
+    upper = upper.cwiseMax(_vertices[i]);
+  }
+  int axis;
+  (upper - lower).maxCoeff(&axis);
+
+  std::vector<std::pair<double, size_t> > order;
+  for (size_t i = 0; i < _parts->size(); ++i)
+  {
+    const Eigen::Vector3i& triangle = _triangles[(*_parts)[i][0]];
+    order.push_back(std::make_pair(_vertices[triangle[0]][axis], i));
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<std::vector<size_t> > groups(_maxNumParts);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    std::vector<size_t>& group = groups[i * _maxNumParts / order.size()];
+    const std::vector<size_t>& part = (*_parts)[order[i].second];
+    group.insert(group.end(), part.begin(), part.end());
+  }
+  _parts->swap(groups);
+}
+
+} // anonymous namespace
+
+//==============================================================================
+std::vector<ConvexHull> computeConvexDecomposition(
+    const std::vector<Eigen::Vector3d>& _vertices,
+    const std::vector<Eigen::Vector3i>& _triangles,
+    size_t _maxNumHulls, double _concavity)
+{
+  std::vector<ConvexHull> hulls;
+
+  if (_triangles.empty() || _maxNumHulls <= 1)
+  {
+    if (!_vertices.empty())
+      hulls.push_back(ConvexHull(_vertices));
+    return hulls;
+  }
+
+  // Separate parts of the mesh get their own hulls
+  std::vector<std::vector<size_t> > parts
+      = findConnectedParts(_vertices, _triangles);
+  mergeParts(_vertices, _triangles, _maxNumHulls, &parts);
+
+  std::vector<ConvexPiece> pieces(parts.size());
+  for (size_t i = 0; i < parts.size(); ++i)
+  {
+    for (size_t j = 0; j < parts[i].size(); ++j)
+    {
+      for (int k = 0; k < 3; ++k)
+        pieces[i].mCorners.push_back(_vertices[_triangles[parts[i][j]][k]]);
+    }
+    updatePiece(&pieces[i]);
+  }
+
+  // Cut planes that are tried on each axis
+  const int numCandidates = 3;
+
+  ConvexPiece below;
+  ConvexPiece above;
+  ConvexPiece bestBelow;
+  ConvexPiece bestAbove;
+  while (pieces.size() < _maxNumHulls)
+  {
+    // Find the piece that its hull approximates worst
+    size_t worst = pieces.size();
+    double maxExcessVolume = 0.0;
+    for (size_t i = 0; i < pieces.size(); ++i)
+    {
+      const ConvexPiece& piece = pieces[i];
+      if (piece.mIsSplittable
+          && piece.mExcessVolume > _concavity * piece.mHullVolume
+          && piece.mExcessVolume > maxExcessVolume)
+      {
+        maxExcessVolume = piece.mExcessVolume;
+        worst = i;
+      }
+    }
+    if (worst == pieces.size())
+      break;
+
+    // Cut it with the axis aligned plane that leaves the least excess volume
+    ConvexPiece& piece = pieces[worst];
+    Eigen::Vector3d lower = piece.mHull.getVertices()[0];
+    Eigen::Vector3d upper = lower;
+    for (size_t i = 1; i < piece.mHull.getVertices().size(); ++i)
+    {
+      lower = lower.cwiseMin(piece.mHull.getVertices()[i]);
+      upper = upper.cwiseMax(piece.mHull.getVertices()[i]);
+    }
+
+    // Some shapes, like rings, only get better after more than one cut, so
+    // the best cut is taken even if it does not reduce the excess volume
+    double minExcessVolume = std::numeric_limits<double>::infinity();
+    bool isSplit = false;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      for (int i = 1; i <= numCandidates; ++i)
+      {
+        const double offset = lower[axis] + (upper[axis] - lower[axis])
+                              * i / (numCandidates + 1);
+        splitPiece(piece, axis, offset, &below, &above);
+        if (below.mHull.isEmpty() || above.mHull.isEmpty())
+          continue;
+
+        const double excessVolume = below.mExcessVolume + above.mExcessVolume;
+        if (excessVolume < minExcessVolume)
+        {
+          minExcessVolume = excessVolume;
+          std::swap(below, bestBelow);
+          std::swap(above, bestAbove);
+          isSplit = true;
+        }
+      }
+    }
+
+    if (!isSplit)
+    {
+      piece.mIsSplittable = false;
+      continue;
+    }
+
+    piece = bestBelow;
+    pieces.push_back(bestAbove);
+  }
+
+  hulls.reserve(pieces.size());
+  for (size_t i = 0; i < pieces.size(); ++i)
+  {
+    if (!pieces[i].mHull.isEmpty())
+      hulls.push_back(pieces[i].mHull);
+  }
+
+  return hulls;
+}
+
+}  // namespace math
+}  // namespace dart
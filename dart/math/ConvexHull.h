@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_MATH_CONVEXHULL_H_
+#define DART_MATH_CONVEXHULL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace dart {
+namespace math {
+
+/// ConvexHull is the smallest convex polytope that contains a set of points.
+/// The faces are triangles whose vertices are ordered counterclockwise when
+/// seen from outside the hull.
+///
+/// Points that are all on one plane (or one line) have no volume. The hull of
+/// such points keeps the points as its vertices but has no faces, which is
+/// enough for getSupportPoint().
+class ConvexHull
+{
+public:
+  /// Create an empty hull
+  ConvexHull();
+
+  /// Compute the convex hull of _points
+  explicit ConvexHull(const std::vector<Eigen::Vector3d>& _points);
+
+  /// Get the vertices of the hull
+  const std::vector<Eigen::Vector3d>& getVertices() const;
+
+  /// Get the faces of the hull as indices into getVertices()
+  const std::vector<Eigen::Vector3i>& getFaces() const;
+
+  /// Get the outward unit normal of face _index
+  const Eigen::Vector3d& getFaceNormal(size_t _index) const;
+
+  /// Get the distance of the plane of face _index from the origin along the
+  /// face normal
+  double getFaceOffset(size_t _index) const;
+
+  /// Return true if the hull has no vertices
+  bool isEmpty() const;
+
+  /// Return true if the hull has faces, i.e., if it has a volume
+  bool hasVolume() const;
+
+  /// Get the vertex of the hull that is farthest along _direction
+  const Eigen::Vector3d& getSupportPoint(const Eigen::Vector3d& _direction)
+      const;
+
+  /// Get the signed distance from _point to the hull, which is negative
+  /// inside. Outside the hull, the result is the distance to the farthest
+  /// face plane, which can be less than the distance to the hull near its
+  /// edges and vertices.
+  double computeSignedDistance(const Eigen::Vector3d& _point) const;
+
+  /// Compute the volume of the hull
+  double computeVolume() const;
+
+  /// Compute the centroid of the vertices of the hull
+  Eigen::Vector3d computeCenter() const;
+
+private:
+  /// Vertices of the hull
+  std::vector<Eigen::Vector3d> mVertices;
+
+  /// Triangles of the hull
+  std::vector<Eigen::Vector3i> mFaces;
+
+  /// Outward unit normals of the triangles
+  std::vector<Eigen::Vector3d> mNormals;
+
+  /// Offsets of the planes of the triangles
+  std::vector<double> mOffsets;
+};
+
+/// Approximate the triangle mesh of _vertices and _triangles with at most
+/// _maxNumHulls convex hulls. Pieces of the mesh are split in two along their
+/// longest side for as long as the hull of some piece is larger than the
+/// volume enclosed by its triangles by more than _concavity times the volume
+/// of the hull. The piece with the largest difference is split first. A
+/// _maxNumHulls of one gives the convex hull of the whole mesh.
+std::vector<ConvexHull> computeConvexDecomposition(
+    const std::vector<Eigen::Vector3d>& _vertices,
+    const std::vector<Eigen::Vector3i>& _triangles,
+    size_t _maxNumHulls = 16, double _concavity = 0.05);
+
+}  // namespace math
+}  // namespace dart
+
+#endif  // DART_MATH_CONVEXHULL_H_
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_OPTIMIZER_AUTODIFFFUNCTION_H_
+#define DART_OPTIMIZER_AUTODIFFFUNCTION_H_
+
+#include <Eigen/Dense>
+
+#include "dart/optimizer/Dual.h"
+#include "dart/optimizer/Function.h"
+
+namespace dart {
+namespace optimizer {
+
+/// \brief Function whose gradient is computed exactly by forward-mode
+/// automatic differentiation.
+///
+/// The Functor must provide a const call operator template over the scalar
+/// type:
+/// \code
+/// struct Rosenbrock
+/// {
+///   template <typename Scalar>
+///   Scalar operator()(
+///       const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& _x) const
+///   {
+///     const Scalar a = Scalar(1.0) - _x[0];
+///     const Scalar b = _x[1] - _x[0] * _x[0];
+///     return a * a + 100.0 * b * b;
+///   }
+/// };
+///
+/// AutoDiffFunction<Rosenbrock> f;
+/// \endcode
+///
+/// The gradient takes one Dual evaluation per dependent variable (see
+/// Function::setDependentVariables), and those evaluations are spread over
+/// OpenMP threads unless parallel evaluation is disabled. The call operator of
+/// the Functor must therefore be safe to call concurrently.
+template <class Functor>
+class AutoDiffFunction : public Function
+{
+public:
+  typedef Eigen::Matrix<Dual, Eigen::Dynamic, 1> DualVector;
+
+  /// \brief Constructor
+  explicit AutoDiffFunction(const Functor& _functor = Functor(),
+                            bool _parallel = true);
+
+  /// \brief Destructor
+  virtual ~AutoDiffFunction();
+
+  /// \copydoc Function::eval
+  virtual double eval(Eigen::Map<const Eigen::VectorXd>& _x);
+
+  /// \copydoc Function::evalGradient
+  virtual void evalGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                            Eigen::Map<Eigen::VectorXd> _grad);
+
+  /// \copydoc Function::evalSparseGradient
+  virtual void evalSparseGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                                  Eigen::Map<Eigen::VectorXd> _values);
+
+  /// \brief Set whether the gradient evaluations run on OpenMP threads
+  void setParallel(bool _parallel);
+
+  /// \brief Return true if the gradient evaluations run on OpenMP threads
+  bool isParallel() const;
+
+  /// \brief Get the functor
+  Functor& getFunctor();
+
+  /// \brief Get the functor
+  const Functor& getFunctor() const;
+
+protected:
+  /// \brief Functor that is differentiated
+  Functor mFunctor;
+
+  /// \brief True if the gradient evaluations run on OpenMP threads
+  bool mParallel;
+
+  /// \brief Workspace for eval()
+  Eigen::VectorXd mX;
+};
+
+//==============================================================================
+template <class Functor>
+AutoDiffFunction<Functor>::AutoDiffFunction(const Functor& _functor,
+                                            bool _parallel)
+  : Function(),
+    mFunctor(_functor),
+    mParallel(_parallel)
+{
+}
+
+//==============================================================================
+template <class Functor>
+AutoDiffFunction<Functor>::~AutoDiffFunction()
+{
+}
+
+//==============================================================================
+template <class Functor>
+double AutoDiffFunction<Functor>::eval(Eigen::Map<const Eigen::VectorXd>& _x)
+{
+  mX = _x;
+  return mFunctor(mX);
+}
+
+//==============================================================================
+template <class Functor>
+void AutoDiffFunction<Functor>::evalGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _grad)
+{
+  if (isDense())
+  {
+    evalSparseGradient(_x, _grad);
+    return;
+  }
+
+  Eigen::VectorXd values(mDependentVariables.size());
+  evalSparseGradient(
+        _x, Eigen::Map<Eigen::VectorXd>(values.data(), values.size()));
+
+  _grad.setZero();
+  for (size_t i = 0; i < mDependentVariables.size(); ++i)
+    _grad[mDependentVariables[i]] = values[i];
+}
+
+//==============================================================================
+template <class Functor>
+void AutoDiffFunction<Functor>::evalSparseGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _values)
+{
+  const int n = static_cast<int>(_x.size());
+  const int numVars = static_cast<int>(getNumDependentVariables(n));
+
+#pragma omp parallel if(mParallel)
+  {
+    // Every thread seeds its own copy of the point
+    DualVector x(n);
+    for (int i = 0; i < n; ++i)
+      x[i] = Dual(_x[i]);
+
+#pragma omp for schedule(static)
+    for (int i = 0; i < numVars; ++i)
+    {
+      const size_t index = isDense() ? i : mDependentVariables[i];
+
+      x[index].mDerivative = 1.0;
+      _values[i] = mFunctor(x).mDerivative;
+      x[index].mDerivative = 0.0;
+    }
+  }
+}
+
+//==============================================================================
+template <class Functor>
+void AutoDiffFunction<Functor>::setParallel(bool _parallel)
+{
+  mParallel = _parallel;
+}
+
+//==============================================================================
+template <class Functor>
+bool AutoDiffFunction<Functor>::isParallel() const
+{
+  return mParallel;
+}
+
+//==============================================================================
+template <class Functor>
+Functor& AutoDiffFunction<Functor>::getFunctor()
+{
+  return mFunctor;
+}
+
+//==============================================================================
+template <class Functor>
+const Functor& AutoDiffFunction<Functor>::getFunctor() const
+{
+  return mFunctor;
+}
+
+}  // namespace optimizer
+}  // namespace dart
+
+#endif  // DART_OPTIMIZER_AUTODIFFFUNCTION_H_
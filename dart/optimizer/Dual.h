@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_OPTIMIZER_DUAL_H_
+#define DART_OPTIMIZER_DUAL_H_
+
+#include <cmath>
+#include <ostream>
+
+#include <Eigen/Core>
+
+namespace dart {
+namespace optimizer {
+
+/// \brief Dual number for forward-mode automatic differentiation.
+///
+/// A Dual carries a value and the derivative of that value with respect to a
+/// single seed direction. Writing a function template over its scalar type
+/// and evaluating it with Duals yields the directional derivative alongside
+/// the value, exact up to rounding. See AutoDiffFunction.
+class Dual
+{
+public:
+  /// \brief Constructor. Implicit so that constants mix with Duals.
+  Dual(double _value = 0.0, double _derivative = 0.0)
+    : mValue(_value), mDerivative(_derivative) {}
+
+  Dual& operator+=(const Dual& _other)
+  {
+    mValue += _other.mValue;
+    mDerivative += _other.mDerivative;
+    return *this;
+  }
+
+  Dual& operator-=(const Dual& _other)
+  {
+    mValue -= _other.mValue;
+    mDerivative -= _other.mDerivative;
+    return *this;
+  }
+
+  Dual& operator*=(const Dual& _other)
+  {
+    mDerivative = mDerivative * _other.mValue + mValue * _other.mDerivative;
+    mValue *= _other.mValue;
+    return *this;
+  }
+
+  Dual& operator/=(const Dual& _other)
+  {
+    mDerivative = (mDerivative * _other.mValue - mValue * _other.mDerivative)
+                  / (_other.mValue * _other.mValue);
+    mValue /= _other.mValue;
+    return *this;
+  }
+
+  /// \brief Value
+  double mValue;
+
+  /// \brief Derivative of the value along the seed direction
+  double mDerivative;
+};
+
+inline Dual operator-(const Dual& _a)
+{
+  return Dual(-_a.mValue, -_a.mDerivative);
+}
+
+inline Dual operator+(const Dual& _a)
+{
+  return _a;
+}
+
+inline Dual operator+(Dual _a, const Dual& _b) { return _a += _b; }
+inline Dual operator-(Dual _a, const Dual& _b) { return _a -= _b; }
+inline Dual operator*(Dual _a, const Dual& _b) { return _a *= _b; }
+inline Dual operator/(Dual _a, const Dual& _b) { return _a /= _b; }
+
+inline Dual operator+(Dual _a, double _b) { return _a += Dual(_b); }
+inline Dual operator-(Dual _a, double _b) { return _a -= Dual(_b); }
+inline Dual operator*(const Dual& _a, double _b)
+{
+  return Dual(_a.mValue * _b, _a.mDerivative * _b);
+}
+inline Dual operator/(const Dual& _a, double _b)
+{
+  return Dual(_a.mValue / _b, _a.mDerivative / _b);
+}
+
+inline Dual operator+(double _a, const Dual& _b) { return Dual(_a) += _b; }
+inline Dual operator-(double _a, const Dual& _b) { return Dual(_a) -= _b; }
+inline Dual operator*(double _a, const Dual& _b) { return _b * _a; }
+inline Dual operator/(double _a, const Dual& _b) { return Dual(_a) /= _b; }
+
+// Comparisons only look at the value, so branches in a differentiated
+// function follow the same path as they would with doubles
+inline bool operator==(const Dual& _a, const Dual& _b)
+{ return _a.mValue == _b.mValue; }
+inline bool operator!=(const Dual& _a, const Dual& _b)
+{ return _a.mValue != _b.mValue; }
+inline bool operator<(const Dual& _a, const Dual& _b)
+{ return _a.mValue < _b.mValue; }
+inline bool operator>(const Dual& _a, const Dual& _b)
+{ return _a.mValue > _b.mValue; }
+inline bool operator<=(const Dual& _a, const Dual& _b)
+{ return _a.mValue <= _b.mValue; }
+inline bool operator>=(const Dual& _a, const Dual& _b)
+{ return _a.mValue >= _b.mValue; }
+
+inline std::ostream& operator<<(std::ostream& _os, const Dual& _a)
+{
+  return _os << _a.mValue << " + " << _a.mDerivative << "e";
+}
+
+//------------------------------------------------------------------------------
+// Elementary functions. These are found through argument-dependent lookup, so
+// generic code should call them unqualified after "using std::sin;" etc.
+//------------------------------------------------------------------------------
+
+inline Dual sin(const Dual& _a)
+{
+  return Dual(std::sin(_a.mValue), std::cos(_a.mValue) * _a.mDerivative);
+}
+
+inline Dual cos(const Dual& _a)
+{
+  return Dual(std::cos(_a.mValue), -std::sin(_a.mValue) * _a.mDerivative);
+}
+
+inline Dual tan(const Dual& _a)
+{
+  const double t = std::tan(_a.mValue);
+  return Dual(t, (1.0 + t * t) * _a.mDerivative);
+}
+
+inline Dual asin(const Dual& _a)
+{
+  return Dual(std::asin(_a.mValue),
+              _a.mDerivative / std::sqrt(1.0 - _a.mValue * _a.mValue));
+}
+
+inline Dual acos(const Dual& _a)
+{
+  return Dual(std::acos(_a.mValue),
+              -_a.mDerivative / std::sqrt(1.0 - _a.mValue * _a.mValue));
+}
+
+inline Dual atan(const Dual& _a)
+{
+  return Dual(std::atan(_a.mValue),
+              _a.mDerivative / (1.0 + _a.mValue * _a.mValue));
+}
+
+inline Dual atan2(const Dual& _y, const Dual& _x)
+{
+  const double d = _x.mValue * _x.mValue + _y.mValue * _y.mValue;
+  return Dual(std::atan2(_y.mValue, _x.mValue),
+              (_x.mValue * _y.mDerivative - _y.mValue * _x.mDerivative) / d);
+}
+
+inline Dual exp(const Dual& _a)
+{
+  const double e = std::exp(_a.mValue);
+  return Dual(e, e * _a.mDerivative);
+}
+
+inline Dual log(const Dual& _a)
+{
+  return Dual(std::log(_a.mValue), _a.mDerivative / _a.mValue);
+}
+
+inline Dual sqrt(const Dual& _a)
+{
+  const double s = std::sqrt(_a.mValue);
+  return Dual(s, 0.5 * _a.mDerivative / s);
+}
+
+inline Dual pow(const Dual& _a, double _b)
+{
+  return Dual(std::pow(_a.mValue, _b),
+              _b * std::pow(_a.mValue, _b - 1.0) * _a.mDerivative);
+}
+
+inline Dual pow(const Dual& _a, const Dual& _b)
+{
+  const double p = std::pow(_a.mValue, _b.mValue);
+  return Dual(p, p * (_b.mDerivative * std::log(_a.mValue)
+                      + _b.mValue * _a.mDerivative / _a.mValue));
+}
+
+inline Dual abs(const Dual& _a)
+{
+  return _a.mValue < 0.0 ? -_a : _a;
+}
+
+inline Dual abs2(const Dual& _a)
+{
+  return _a * _a;
+}
+
+inline const Dual& conj(const Dual& _a)
+{
+  return _a;
+}
+
+inline const Dual& real(const Dual& _a)
+{
+  return _a;
+}
+
+inline Dual imag(const Dual&)
+{
+  return Dual(0.0);
+}
+
+}  // namespace optimizer
+}  // namespace dart
+
+namespace Eigen {
+
+/// \brief Lets Eigen matrices hold dart::optimizer::Dual
+template<>
+struct NumTraits<dart::optimizer::Dual> : NumTraits<double>
+{
+  typedef dart::optimizer::Dual Real;
+  typedef dart::optimizer::Dual NonInteger;
+  typedef dart::optimizer::Dual Nested;
+  typedef dart::optimizer::Dual Literal;
+
+  enum
+  {
+    IsComplex = 0,
+    IsInteger = 0,
+    IsSigned = 1,
+    RequireInitialization = 1,
+    ReadCost = 2,
+    AddCost = 2,
+    MulCost = 4
+  };
+};
+
+}  // namespace Eigen
+
+#endif  // DART_OPTIMIZER_DUAL_H_
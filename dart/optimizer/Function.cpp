@@ -37,6 +37,8 @@
 
 #include "dart/optimizer/Function.h"
 
+#include <cassert>
+
 #include "dart/common/Console.h"
 
 namespace dart {
@@ -59,6 +61,26 @@ void Function::evalGradient(Eigen::Map<const Eigen::VectorXd>& _x,
   dterr << "Gradient is not provided. Use gradient-free algorithm.\n";
 }
 
+//==============================================================================
+void Function::evalSparseGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                                  Eigen::Map<Eigen::VectorXd> _values)
+{
+  const size_t n = _x.size();
+  assert(static_cast<size_t>(_values.size()) == getNumDependentVariables(n));
+
+  if (isDense())
+  {
+    evalGradient(_x, _values);
+    return;
+  }
+
+  mGradient.resize(n);
+  evalGradient(_x, Eigen::Map<Eigen::VectorXd>(mGradient.data(), n));
+
+  for (size_t i = 0; i < mDependentVariables.size(); ++i)
+    _values[i] = mGradient[mDependentVariables[i]];
+}
+
 //==============================================================================
 void Function::evalHessian(Eigen::Map<const Eigen::VectorXd>& _x,
                            Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess)
@@ -66,6 +88,93 @@ void Function::evalHessian(Eigen::Map<const Eigen::VectorXd>& _x,
   dterr << "Hessian is not provided. Use Hessian-free algorithm.\n";
 }
 
+//==============================================================================
+void Function::evalGradientByFiniteDifference(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _grad,
+    double _step,
+    bool _parallel)
+{
+  assert(_grad.size() == _x.size());
+
+  if (isDense())
+  {
+    evalSparseGradientByFiniteDifference(_x, _grad, _step, _parallel);
+    return;
+  }
+
+  Eigen::VectorXd values(mDependentVariables.size());
+  evalSparseGradientByFiniteDifference(
+        _x, Eigen::Map<Eigen::VectorXd>(values.data(), values.size()),
+        _step, _parallel);
+
+  _grad.setZero();
+  for (size_t i = 0; i < mDependentVariables.size(); ++i)
+    _grad[mDependentVariables[i]] = values[i];
+}
+
+//==============================================================================
+void Function::evalSparseGradientByFiniteDifference(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _values,
+    double _step,
+    bool _parallel)
+{
+  assert(_step > 0.0);
+
+  const int n = static_cast<int>(_x.size());
+  const int numVars = static_cast<int>(getNumDependentVariables(n));
+  assert(_values.size() == numVars);
+
+  const double* data = _x.data();
+
+#pragma omp parallel if(_parallel)
+  {
+    // Every thread perturbs its own copy of the point
+    Eigen::VectorXd perturbed(_x);
+    Eigen::Map<const Eigen::VectorXd> xp(perturbed.data(), n);
+
+#pragma omp for schedule(static)
+    for (int i = 0; i < numVars; ++i)
+    {
+      const size_t index = isDense() ? i : mDependentVariables[i];
+
+      perturbed[index] = data[index] + _step;
+      const double forward = eval(xp);
+
+      perturbed[index] = data[index] - _step;
+      const double backward = eval(xp);
+
+      perturbed[index] = data[index];
+      _values[i] = (forward - backward) / (2.0 * _step);
+    }
+  }
+}
+
+//==============================================================================
+size_t Function::getNumDependentVariables(size_t _dim) const
+{
+  return isDense() ? _dim : mDependentVariables.size();
+}
+
+//==============================================================================
+void Function::setDependentVariables(const std::vector<size_t>& _indices)
+{
+  mDependentVariables = _indices;
+}
+
+//==============================================================================
+const std::vector<size_t>& Function::getDependentVariables() const
+{
+  return mDependentVariables;
+}
+
+//==============================================================================
+bool Function::isDense() const
+{
+  return mDependentVariables.empty();
+}
+
 //==============================================================================
 MultiFunction::MultiFunction()
 {
@@ -57,14 +57,69 @@ public:
   /// \brief Evaluate and return the objective function at the point x
   virtual double eval(Eigen::Map<const Eigen::VectorXd>& _x) = 0;
 
-  /// \brief Evaluate and return the objective function at the point x
+  /// \brief Evaluate the gradient of the function at the point x
   virtual void evalGradient(Eigen::Map<const Eigen::VectorXd>& _x,
                             Eigen::Map<Eigen::VectorXd> _grad);
 
+  /// \brief Evaluate the partial derivatives of the function with respect to
+  /// the dependent variables (see setDependentVariables()) at the point x.
+  /// _values[i] is the derivative with respect to the i-th dependent
+  /// variable, or to the i-th variable if the function is dense. The default
+  /// implementation gathers the entries from evalGradient(), so functions
+  /// with few dependent variables should override this to avoid the cost of
+  /// a dense gradient.
+  virtual void evalSparseGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                                  Eigen::Map<Eigen::VectorXd> _values);
+
   /// \brief Evaluate and return the objective function at the point x
   virtual void evalHessian(
       Eigen::Map<const Eigen::VectorXd>& _x,
       Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess);
+
+  /// \brief Approximate the gradient at the point x by central finite
+  /// differences with step size _step. Only the dependent variables are
+  /// perturbed; the other entries of _grad are set to zero. If _parallel is
+  /// true, the perturbed evaluations are spread over OpenMP threads, which
+  /// requires eval() to be safe to call concurrently. Functions that have no
+  /// analytic gradient can call this from evalGradient().
+  void evalGradientByFiniteDifference(Eigen::Map<const Eigen::VectorXd>& _x,
+                                      Eigen::Map<Eigen::VectorXd> _grad,
+                                      double _step = 1e-6,
+                                      bool _parallel = false);
+
+  /// \brief Same as evalGradientByFiniteDifference(), but only writes the
+  /// partial derivatives with respect to the dependent variables, in the
+  /// layout of evalSparseGradient()
+  void evalSparseGradientByFiniteDifference(
+      Eigen::Map<const Eigen::VectorXd>& _x,
+      Eigen::Map<Eigen::VectorXd> _values,
+      double _step = 1e-6,
+      bool _parallel = false);
+
+  /// \brief Return the number of partial derivatives written by
+  /// evalSparseGradient() for a point of dimension _dim
+  size_t getNumDependentVariables(size_t _dim) const;
+
+  /// \brief Set the indices of the variables that this function depends on.
+  /// Solvers that support sparse Jacobians (e.g., IpoptSolver) only use these
+  /// entries of the gradient, and the differentiation helpers only perturb
+  /// these variables. An empty list, which is the default, means that the
+  /// function depends on every variable.
+  void setDependentVariables(const std::vector<size_t>& _indices);
+
+  /// \brief Get the indices of the variables that this function depends on.
+  /// An empty list means that the function depends on every variable.
+  const std::vector<size_t>& getDependentVariables() const;
+
+  /// \brief Return true if this function depends on every variable
+  bool isDense() const;
+
+protected:
+  /// \brief Indices of the variables that this function depends on
+  std::vector<size_t> mDependentVariables;
+
+  /// \brief Workspace for the default evalSparseGradient()
+  Eigen::VectorXd mGradient;
 };
 
 /// \brief class MultiFunction
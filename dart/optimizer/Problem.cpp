@@ -62,6 +62,20 @@ Problem::~Problem()
 {
 }
 
+//==============================================================================
+void Problem::setDimension(size_t _dim)
+{
+  if (_dim == mDimension)
+    return;
+
+  mDimension = _dim;
+
+  mInitialGuess = Eigen::VectorXd::Zero(mDimension);
+  mLowerBounds = Eigen::VectorXd::Constant(mDimension, -HUGE_VAL);
+  mUpperBounds = Eigen::VectorXd::Constant(mDimension,  HUGE_VAL);
+  mOptimalSolution = Eigen::VectorXd::Zero(mDimension);
+}
+
 //==============================================================================
 size_t Problem::getDimension() const
 {
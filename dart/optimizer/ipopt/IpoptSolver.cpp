@@ -65,6 +65,11 @@ IpoptSolver::IpoptSolver(Problem* _problem)
   mIpoptApp->Options()->SetStringValue("mu_strategy", "adaptive");
   mIpoptApp->Options()->SetStringValue("output_file", "ipopt.out");
 
+  // Function does not provide the Hessian of the Lagrangian, so let Ipopt
+  // build a quasi-Newton approximation from the gradients
+  mIpoptApp->Options()->SetStringValue("hessian_approximation",
+                                       "limited-memory");
+
   // Intialize the IpoptApplication and process the options
   Ipopt::ApplicationReturnStatus status = mIpoptApp->Initialize();
   if (status != Ipopt::Solve_Succeeded)
@@ -109,18 +114,21 @@ bool DartTNLP::get_nlp_info(Ipopt::Index& n,
                             Ipopt::Index& nnz_h_lag,
                             Ipopt::TNLP::IndexStyleEnum& index_style)
 {
-  // The problem described in HS071_NLP.hpp has 4 variables, x[0] through x[3]
   n = mProblem->getDimension();
 
-  // one equality constraint and one inequality constraint
   m = mProblem->getNumEqConstraints() + mProblem->getNumIneqConstraints();
 
-  // in this example the Jacobian is dense and contains 8 nonzeros
-  nnz_jac_g = n * m;
+  // Each constraint contributes one nonzero per variable it depends on, so
+  // problems that declare their sparsity get sparse linear algebra in Ipopt
+  nnz_jac_g = 0;
+  for (size_t i = 0; i < mProblem->getNumEqConstraints(); ++i)
+    nnz_jac_g += getNumNonzeros(mProblem->getEqConstraint(i));
+  for (size_t i = 0; i < mProblem->getNumIneqConstraints(); ++i)
+    nnz_jac_g += getNumNonzeros(mProblem->getIneqConstraint(i));
 
-  // the Hessian is also dense and has 16 total nonzeros, but we
-  // only need the lower left corner (since it is symmetric)
-  nnz_h_lag = n * n * m;
+  // The Hessian of the Lagrangian is approximated by Ipopt (see the
+  // hessian_approximation option), so there is no structure to report
+  nnz_h_lag = 0;
 
   // use the C style indexing (0-based)
   index_style = Ipopt::TNLP::C_STYLE;
@@ -232,12 +240,11 @@ bool DartTNLP::eval_grad_f(Ipopt::Index _n,
                            bool _new_x,
                            Ipopt::Number* _grad_f)
 {
-  if (_new_x)
-  {
-    Eigen::Map<const Eigen::VectorXd> x(_x, _n);
-    Eigen::Map<Eigen::VectorXd> grad(_grad_f, _n);
-    mProblem->getObjective()->evalGradient(x, grad);
-  }
+  // _grad_f is not cached by Ipopt, so it has to be filled even if _x has
+  // been seen before
+  Eigen::Map<const Eigen::VectorXd> x(_x, _n);
+  Eigen::Map<Eigen::VectorXd> grad(_grad_f, _n);
+  mProblem->getObjective()->evalGradient(x, grad);
 
   return true;
 }
@@ -294,44 +301,90 @@ bool DartTNLP::eval_jac_g(Ipopt::Index _n,
   if (_values == NULL)
   {
     // return the structure of the Jacobian
-
-    // Assume the gradient is dense
     size_t idx = 0;
-    for (int i = 0; i < _m; ++i)
+    Ipopt::Index row = 0;
+
+    for (size_t i = 0; i < mProblem->getNumEqConstraints(); ++i)
+    {
+      setStructure(mProblem->getEqConstraint(i), row++, _n, idx,
+                   _iRow, _jCol);
+    }
+
+    for (size_t i = 0; i < mProblem->getNumIneqConstraints(); ++i)
     {
-      for (int j = 0; j < _n; ++j)
-      {
-        _iRow[idx] = i;
-        _jCol[idx] = j;
-        idx++;
-      }
+      setStructure(mProblem->getIneqConstraint(i), row++, _n, idx,
+                   _iRow, _jCol);
     }
+
+    assert(static_cast<Ipopt::Index>(idx) == _nele_jac);
   }
   else
   {
     // return the values of the Jacobian of the constraints
     size_t idx = 0;
     Eigen::Map<const Eigen::VectorXd> x(_x, _n);
-    Eigen::Map<Eigen::VectorXd> grad(NULL, 0);
 
-    // Evaluate function values for equality constraints
     for (size_t i = 0; i < mProblem->getNumEqConstraints(); ++i)
-    {
-      new (&grad)Eigen::Map<Eigen::VectorXd>(_values + idx, _n);
-      mProblem->getEqConstraint(i)->evalGradient(x, grad);
-      idx += _n;
-    }
+      setValues(mProblem->getEqConstraint(i), x, idx, _values);
 
-    // Evaluate function values for inequality constraints
     for (size_t i = 0; i < mProblem->getNumIneqConstraints(); ++i)
+      setValues(mProblem->getIneqConstraint(i), x, idx, _values);
+
+    assert(static_cast<Ipopt::Index>(idx) == _nele_jac);
+  }
+
+  return true;
+}
+
+//==============================================================================
+Ipopt::Index DartTNLP::getNumNonzeros(const Function* _constraint) const
+{
+  if (_constraint->isDense())
+    return mProblem->getDimension();
+
+  return _constraint->getDependentVariables().size();
+}
+
+//==============================================================================
+void DartTNLP::setStructure(const Function* _constraint,
+                            Ipopt::Index _row,
+                            Ipopt::Index _n,
+                            size_t& _idx,
+                            Ipopt::Index* _iRow,
+                            Ipopt::Index* _jCol) const
+{
+  if (_constraint->isDense())
+  {
+    for (Ipopt::Index j = 0; j < _n; ++j)
     {
-      new (&grad)Eigen::Map<Eigen::VectorXd>(_values + idx, _n);
-      mProblem->getIneqConstraint(i)->evalGradient(x, grad);
-      idx += _n;
+      _iRow[_idx] = _row;
+      _jCol[_idx] = j;
+      _idx++;
     }
+    return;
   }
 
-  return true;
+  const std::vector<size_t>& vars = _constraint->getDependentVariables();
+  for (size_t j = 0; j < vars.size(); ++j)
+  {
+    _iRow[_idx] = _row;
+    _jCol[_idx] = static_cast<Ipopt::Index>(vars[j]);
+    _idx++;
+  }
+}
+
+//==============================================================================
+void DartTNLP::setValues(Function* _constraint,
+                         Eigen::Map<const Eigen::VectorXd>& _x,
+                         size_t& _idx,
+                         Ipopt::Number* _values)
+{
+  // The nonzeros of the row are written in place, in the order of
+  // setStructure()
+  const size_t numValues = _constraint->getNumDependentVariables(_x.size());
+  Eigen::Map<Eigen::VectorXd> values(_values + _idx, numValues);
+  _constraint->evalSparseGradient(_x, values);
+  _idx += numValues;
 }
 
 //==============================================================================
@@ -52,6 +52,7 @@
 namespace dart {
 namespace optimizer {
 
+class Function;
 class Problem;
 class DartTNLP;
 
@@ -177,6 +178,23 @@ public:
                                  Ipopt::IpoptCalculatedQuantities* _ip_cq);
 
 private:
+  /// \brief Return the number of Jacobian nonzeros of a constraint
+  Ipopt::Index getNumNonzeros(const Function* _constraint) const;
+
+  /// \brief Write the Jacobian structure of a constraint starting at _idx
+  void setStructure(const Function* _constraint,
+                    Ipopt::Index _row,
+                    Ipopt::Index _n,
+                    size_t& _idx,
+                    Ipopt::Index* _iRow,
+                    Ipopt::Index* _jCol) const;
+
+  /// \brief Write the Jacobian values of a constraint starting at _idx
+  void setValues(Function* _constraint,
+                 Eigen::Map<const Eigen::VectorXd>& _x,
+                 size_t& _idx,
+                 Ipopt::Number* _values);
+
   /// \brief DART optimization problem
   Problem* mProblem;
 
@@ -0,0 +1,651 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/MultipleShootingProblem.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "dart/common/Console.h"
+#include "dart/math/MathTypes.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/simulation/World.h"
+
+namespace dart {
+namespace planning {
+
+//==============================================================================
+/// Return true if _world and _other have the same state layout
+static bool haveSameStructure(const simulation::World* _world,
+                              const simulation::World* _other)
+{
+  if (_world->getNumSkeletons() != _other->getNumSkeletons())
+    return false;
+
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    const dynamics::Skeleton* skel = _world->getSkeleton(i);
+    const dynamics::Skeleton* otherSkel = _other->getSkeleton(i);
+    if (skel->isMobile() != otherSkel->isMobile()
+        || skel->getNumDofs() != otherSkel->getNumDofs())
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+MultipleShootingProblem::MultipleShootingProblem(
+    const std::vector<simulation::World*>& _workers,
+    size_t _controlledSkeleton,
+    size_t _numSegments,
+    size_t _stepsPerSegment)
+  : optimizer::Problem(0),
+    mWorkers(_workers),
+    mOwnedWorker(nullptr),
+    mControlledSkeleton(_controlledSkeleton),
+    mNumSegments(_numSegments),
+    mStepsPerSegment(_stepsPerSegment),
+    mStateDim(0),
+    mControlDim(0),
+    mControlWeight(1.0),
+    mFiniteDifferenceStep(1e-6)
+{
+  assert(!mWorkers.empty());
+  assert(mNumSegments > 0);
+  assert(mStepsPerSegment > 0);
+
+  simulation::World* world = mWorkers[0];
+  assert(mControlledSkeleton < world->getNumSkeletons());
+
+  for (size_t i = 0; i < world->getNumSkeletons(); ++i)
+  {
+    if (world->getSkeleton(i)->isMobile())
+      mStateDim += 2 * world->getSkeleton(i)->getNumDofs();
+  }
+  mControlDim = world->getSkeleton(mControlledSkeleton)->getNumDofs();
+
+  for (size_t i = 1; i < mWorkers.size(); ++i)
+  {
+    if (!haveSameStructure(world, mWorkers[i]))
+    {
+      dterr << "[MultipleShootingProblem] Worker World #" << i << " does not "
+            << "match the first World. Only the first World will be used.\n";
+      mWorkers.resize(1);
+      break;
+    }
+  }
+
+  // Layout of the variables and initial guess: every segment starts from the
+  // current state with zero control
+  setDimension((mNumSegments + 1) * mStateDim + mNumSegments * mControlDim);
+
+  Eigen::VectorXd state;
+  getWorldState(world, state);
+
+  // Simulate a clone so that the state and time of the World of the caller
+  // are kept
+  mOwnedWorker = world->clone();
+  mWorkers[0] = mOwnedWorker;
+
+  Eigen::VectorXd guess = Eigen::VectorXd::Zero(mDimension);
+  for (size_t s = 0; s <= mNumSegments; ++s)
+    guess.segment(getStateIndex(s), mStateDim) = state;
+  setInitialGuess(guess);
+
+  Eigen::VectorXd lower = Eigen::VectorXd::Constant(mDimension, -DART_DBL_INF);
+  Eigen::VectorXd upper = Eigen::VectorXd::Constant(mDimension,  DART_DBL_INF);
+  lower.head(mStateDim) = state;
+  upper.head(mStateDim) = state;
+  setLowerBounds(lower);
+  setUpperBounds(upper);
+
+  // Objective and continuity constraints
+  optimizer::Function* objective = new ShootingControlEffort(this);
+  mFunctions.push_back(objective);
+  setObjective(objective);
+
+  for (size_t s = 0; s < mNumSegments; ++s)
+  {
+    for (size_t i = 0; i < mStateDim; ++i)
+    {
+      optimizer::Function* constraint = new ShootingDefectConstraint(this, s, i);
+      mFunctions.push_back(constraint);
+      addEqConstraint(constraint);
+    }
+  }
+
+  mSegmentEnds.resize(mNumSegments);
+  mStateJacobians.resize(mNumSegments);
+  mControlJacobians.resize(mNumSegments);
+}
+
+//==============================================================================
+MultipleShootingProblem::~MultipleShootingProblem()
+{
+  for (size_t i = 0; i < mFunctions.size(); ++i)
+    delete mFunctions[i];
+
+  delete mOwnedWorker;
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getNumSegments() const
+{
+  return mNumSegments;
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getNumStepsPerSegment() const
+{
+  return mStepsPerSegment;
+}
+
+//==============================================================================
+double MultipleShootingProblem::getSegmentDuration() const
+{
+  return mStepsPerSegment * mWorkers[0]->getTimeStep();
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getStateDimension() const
+{
+  return mStateDim;
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getControlDimension() const
+{
+  return mControlDim;
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getStateIndex(size_t _segment) const
+{
+  assert(_segment <= mNumSegments);
+  return _segment * (mStateDim + mControlDim);
+}
+
+//==============================================================================
+size_t MultipleShootingProblem::getControlIndex(size_t _segment) const
+{
+  assert(_segment < mNumSegments);
+  return _segment * (mStateDim + mControlDim) + mStateDim;
+}
+
+//==============================================================================
+void MultipleShootingProblem::setGoalState(const Eigen::VectorXd& _goal)
+{
+  assert(static_cast<size_t>(_goal.size()) == mStateDim);
+
+  const size_t index = getStateIndex(mNumSegments);
+  mLowerBounds.segment(index, mStateDim) = _goal;
+  mUpperBounds.segment(index, mStateDim) = _goal;
+  mInitialGuess.segment(index, mStateDim) = _goal;
+}
+
+//==============================================================================
+void MultipleShootingProblem::setControlLimits(const Eigen::VectorXd& _lower,
+                                               const Eigen::VectorXd& _upper)
+{
+  assert(static_cast<size_t>(_lower.size()) == mControlDim);
+  assert(static_cast<size_t>(_upper.size()) == mControlDim);
+
+  for (size_t s = 0; s < mNumSegments; ++s)
+  {
+    const size_t index = getControlIndex(s);
+    mLowerBounds.segment(index, mControlDim) = _lower;
+    mUpperBounds.segment(index, mControlDim) = _upper;
+    mInitialGuess.segment(index, mControlDim)
+        = mInitialGuess.segment(index, mControlDim).cwiseMax(_lower)
+                                                   .cwiseMin(_upper);
+  }
+}
+
+//==============================================================================
+void MultipleShootingProblem::setControlWeight(double _weight)
+{
+  mControlWeight = _weight;
+}
+
+//==============================================================================
+double MultipleShootingProblem::getControlWeight() const
+{
+  return mControlWeight;
+}
+
+//==============================================================================
+void MultipleShootingProblem::setFiniteDifferenceStep(double _step)
+{
+  assert(_step > 0.0);
+  mFiniteDifferenceStep = _step;
+  mDerivativePoint.resize(0);
+}
+
+//==============================================================================
+double MultipleShootingProblem::getFiniteDifferenceStep() const
+{
+  return mFiniteDifferenceStep;
+}
+
+//==============================================================================
+const Eigen::VectorXd& MultipleShootingProblem::getSegmentEndState(
+    const Eigen::VectorXd& _x, size_t _segment)
+{
+  return getSegmentEndState(
+        Eigen::Map<const Eigen::VectorXd>(_x.data(), _x.size()), _segment);
+}
+
+//==============================================================================
+const Eigen::VectorXd& MultipleShootingProblem::getSegmentEndState(
+    const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment)
+{
+  assert(_segment < mNumSegments);
+  updateRollouts(_x, _segment);
+  return mSegmentEnds[_segment];
+}
+
+//==============================================================================
+const Eigen::MatrixXd& MultipleShootingProblem::getStateJacobian(
+    const Eigen::VectorXd& _x, size_t _segment)
+{
+  return getStateJacobian(
+        Eigen::Map<const Eigen::VectorXd>(_x.data(), _x.size()), _segment);
+}
+
+//==============================================================================
+const Eigen::MatrixXd& MultipleShootingProblem::getStateJacobian(
+    const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment)
+{
+  assert(_segment < mNumSegments);
+  updateDerivatives(_x, _segment);
+  return mStateJacobians[_segment];
+}
+
+//==============================================================================
+const Eigen::MatrixXd& MultipleShootingProblem::getControlJacobian(
+    const Eigen::VectorXd& _x, size_t _segment)
+{
+  return getControlJacobian(
+        Eigen::Map<const Eigen::VectorXd>(_x.data(), _x.size()), _segment);
+}
+
+//==============================================================================
+const Eigen::MatrixXd& MultipleShootingProblem::getControlJacobian(
+    const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment)
+{
+  assert(_segment < mNumSegments);
+  updateDerivatives(_x, _segment);
+  return mControlJacobians[_segment];
+}
+
+//==============================================================================
+Eigen::MatrixXd MultipleShootingProblem::rollout(const Eigen::VectorXd& _x)
+{
+  assert(static_cast<size_t>(_x.size()) == mDimension);
+
+  simulation::World* world = mWorkers[0];
+  dynamics::Skeleton* skel = world->getSkeleton(mControlledSkeleton);
+
+  Eigen::MatrixXd states(mStateDim, mNumSegments * mStepsPerSegment);
+  Eigen::VectorXd state = _x.head(mStateDim);
+  setWorldState(world, state);
+
+  for (size_t s = 0; s < mNumSegments; ++s)
+  {
+    const Eigen::VectorXd control = _x.segment(getControlIndex(s), mControlDim);
+    for (size_t k = 0; k < mStepsPerSegment; ++k)
+    {
+      skel->setForces(control);
+      world->step();
+      getWorldState(world, state);
+      states.col(s * mStepsPerSegment + k) = state;
+    }
+  }
+
+  return states;
+}
+
+//==============================================================================
+void MultipleShootingProblem::setWorldState(simulation::World* _world,
+                                            const Eigen::VectorXd& _state) const
+{
+  size_t index = 0;
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    dynamics::Skeleton* skel = _world->getSkeleton(i);
+    if (!skel->isMobile())
+      continue;
+
+    const size_t dim = 2 * skel->getNumDofs();
+    skel->setState(_state.segment(index, dim));
+    index += dim;
+  }
+}
+
+//==============================================================================
+void MultipleShootingProblem::getWorldState(const simulation::World* _world,
+                                            Eigen::VectorXd& _state) const
+{
+  _state.resize(mStateDim);
+
+  size_t index = 0;
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    const dynamics::Skeleton* skel = _world->getSkeleton(i);
+    if (!skel->isMobile())
+      continue;
+
+    const size_t dim = 2 * skel->getNumDofs();
+    _state.segment(index, dim) = skel->getState();
+    index += dim;
+  }
+}
+
+//==============================================================================
+void MultipleShootingProblem::simulateSegment(simulation::World* _world,
+                                              const Eigen::VectorXd& _start,
+                                              const Eigen::VectorXd& _control,
+                                              Eigen::VectorXd& _end) const
+{
+  dynamics::Skeleton* skel = _world->getSkeleton(mControlledSkeleton);
+
+  setWorldState(_world, _start);
+  for (size_t k = 0; k < mStepsPerSegment; ++k)
+  {
+    skel->setForces(_control);
+    _world->step();
+  }
+  getWorldState(_world, _end);
+}
+
+//==============================================================================
+bool MultipleShootingProblem::isSegmentCached(
+    const Eigen::VectorXd& _cachedPoint,
+    const Eigen::Map<const Eigen::VectorXd>& _x,
+    size_t _segment) const
+{
+  if (_cachedPoint.size() != _x.size())
+    return false;
+
+  // x_s and u_s are adjacent
+  const size_t index = getStateIndex(_segment);
+  const size_t size = mStateDim + mControlDim;
+  return _cachedPoint.segment(index, size) == _x.segment(index, size);
+}
+
+//==============================================================================
+void MultipleShootingProblem::updateRollouts(
+    const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment)
+{
+  assert(static_cast<size_t>(_x.size()) == mDimension);
+
+  if (isSegmentCached(mRolloutPoint, _x, _segment))
+    return;
+
+  // Simulate every stale segment in one parallel batch, since the solver
+  // asks for the other segments at the same point next
+  std::vector<size_t> segments;
+  for (size_t s = 0; s < mNumSegments; ++s)
+  {
+    if (!isSegmentCached(mRolloutPoint, _x, s))
+      segments.push_back(s);
+  }
+
+  const int numSegments = static_cast<int>(segments.size());
+  const int numWorkers = static_cast<int>(mWorkers.size());
+
+#pragma omp parallel num_threads(numWorkers)
+  {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    simulation::World* world = mWorkers[thread];
+
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < numSegments; ++i)
+    {
+      const size_t s = segments[i];
+      simulateSegment(world,
+                      _x.segment(getStateIndex(s), mStateDim),
+                      _x.segment(getControlIndex(s), mControlDim),
+                      mSegmentEnds[s]);
+    }
+  }
+
+  mRolloutPoint = _x;
+}
+
+//==============================================================================
+void MultipleShootingProblem::updateDerivatives(
+    const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment)
+{
+  if (isSegmentCached(mDerivativePoint, _x, _segment))
+    return;
+
+  // Forward differences are taken around the nominal rollouts, which every
+  // perturbed simulation shares
+  updateRollouts(_x, _segment);
+
+  std::vector<size_t> segments;
+  for (size_t s = 0; s < mNumSegments; ++s)
+  {
+    if (isSegmentCached(mDerivativePoint, _x, s))
+      continue;
+
+    segments.push_back(s);
+    mStateJacobians[s].resize(mStateDim, mStateDim);
+    mControlJacobians[s].resize(mStateDim, mControlDim);
+  }
+
+  // One job per segment and perturbed variable, so the work balances even
+  // when there are fewer segments than threads
+  const size_t numColumns = mStateDim + mControlDim;
+  const int numJobs = static_cast<int>(segments.size() * numColumns);
+  const int numWorkers = static_cast<int>(mWorkers.size());
+  const double h = mFiniteDifferenceStep;
+
+#pragma omp parallel num_threads(numWorkers)
+  {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    simulation::World* world = mWorkers[thread];
+    Eigen::VectorXd start;
+    Eigen::VectorXd control;
+    Eigen::VectorXd end;
+
+#pragma omp for schedule(dynamic)
+    for (int job = 0; job < numJobs; ++job)
+    {
+      const size_t s = segments[job / numColumns];
+      const size_t j = job % numColumns;
+
+      start = _x.segment(getStateIndex(s), mStateDim);
+      control = _x.segment(getControlIndex(s), mControlDim);
+
+      if (j < mStateDim)
+        start[j] += h;
+      else
+        control[j - mStateDim] += h;
+
+      simulateSegment(world, start, control, end);
+
+      if (j < mStateDim)
+        mStateJacobians[s].col(j) = (end - mSegmentEnds[s]) / h;
+      else
+        mControlJacobians[s].col(j - mStateDim) = (end - mSegmentEnds[s]) / h;
+    }
+  }
+
+  mDerivativePoint = _x;
+}
+
+//==============================================================================
+ShootingDefectConstraint::ShootingDefectConstraint(
+    MultipleShootingProblem* _problem, size_t _segment, size_t _component)
+  : optimizer::Function(),
+    mProblem(_problem),
+    mSegment(_segment),
+    mComponent(_component)
+{
+  const size_t stateDim = mProblem->getStateDimension();
+  const size_t controlDim = mProblem->getControlDimension();
+
+  // x_s and u_s are adjacent, followed by the matching component of x_{s+1}
+  std::vector<size_t> vars;
+  vars.reserve(stateDim + controlDim + 1);
+  const size_t start = mProblem->getStateIndex(mSegment);
+  for (size_t i = 0; i < stateDim + controlDim; ++i)
+    vars.push_back(start + i);
+  vars.push_back(mProblem->getStateIndex(mSegment + 1) + mComponent);
+  setDependentVariables(vars);
+}
+
+//==============================================================================
+ShootingDefectConstraint::~ShootingDefectConstraint()
+{
+}
+
+//==============================================================================
+double ShootingDefectConstraint::eval(Eigen::Map<const Eigen::VectorXd>& _x)
+{
+  return mProblem->getSegmentEndState(_x, mSegment)[mComponent]
+         - _x[mProblem->getStateIndex(mSegment + 1) + mComponent];
+}
+
+//==============================================================================
+void ShootingDefectConstraint::evalGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _grad)
+{
+  const std::vector<size_t>& vars = getDependentVariables();
+  Eigen::VectorXd values(vars.size());
+  evalSparseGradient(_x, Eigen::Map<Eigen::VectorXd>(values.data(),
+                                                      values.size()));
+
+  _grad.setZero();
+  for (size_t i = 0; i < vars.size(); ++i)
+    _grad[vars[i]] = values[i];
+}
+
+//==============================================================================
+void ShootingDefectConstraint::evalSparseGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _values)
+{
+  const size_t stateDim = mProblem->getStateDimension();
+  const size_t controlDim = mProblem->getControlDimension();
+
+  // In the order of the dependent variables: x_s, u_s, then the matching
+  // component of x_{s+1}
+  _values.head(stateDim)
+      = mProblem->getStateJacobian(_x, mSegment).row(mComponent).transpose();
+  _values.segment(stateDim, controlDim)
+      = mProblem->getControlJacobian(_x, mSegment).row(mComponent).transpose();
+  _values[stateDim + controlDim] = -1.0;
+}
+
+//==============================================================================
+ShootingControlEffort::ShootingControlEffort(MultipleShootingProblem* _problem)
+  : optimizer::Function(),
+    mProblem(_problem)
+{
+  std::vector<size_t> vars;
+  for (size_t s = 0; s < mProblem->getNumSegments(); ++s)
+  {
+    const size_t start = mProblem->getControlIndex(s);
+    for (size_t i = 0; i < mProblem->getControlDimension(); ++i)
+      vars.push_back(start + i);
+  }
+  setDependentVariables(vars);
+}
+
+//==============================================================================
+ShootingControlEffort::~ShootingControlEffort()
+{
+}
+
+//==============================================================================
+double ShootingControlEffort::eval(Eigen::Map<const Eigen::VectorXd>& _x)
+{
+  const double scale = mProblem->getControlWeight()
+                       * mProblem->getSegmentDuration();
+  const size_t controlDim = mProblem->getControlDimension();
+
+  double sum = 0.0;
+  for (size_t s = 0; s < mProblem->getNumSegments(); ++s)
+    sum += _x.segment(mProblem->getControlIndex(s), controlDim).squaredNorm();
+
+  return 0.5 * scale * sum;
+}
+
+//==============================================================================
+void ShootingControlEffort::evalGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _grad)
+{
+  const double scale = mProblem->getControlWeight()
+                       * mProblem->getSegmentDuration();
+  const size_t controlDim = mProblem->getControlDimension();
+
+  _grad.setZero();
+  for (size_t s = 0; s < mProblem->getNumSegments(); ++s)
+  {
+    const size_t index = mProblem->getControlIndex(s);
+    _grad.segment(index, controlDim) = scale * _x.segment(index, controlDim);
+  }
+}
+
+//==============================================================================
+void ShootingControlEffort::evalSparseGradient(
+    Eigen::Map<const Eigen::VectorXd>& _x,
+    Eigen::Map<Eigen::VectorXd> _values)
+{
+  const double scale = mProblem->getControlWeight()
+                       * mProblem->getSegmentDuration();
+  const size_t controlDim = mProblem->getControlDimension();
+
+  for (size_t s = 0; s < mProblem->getNumSegments(); ++s)
+  {
+    _values.segment(s * controlDim, controlDim)
+        = scale * _x.segment(mProblem->getControlIndex(s), controlDim);
+  }
+}
+
+}  // namespace planning
+}  // namespace dart
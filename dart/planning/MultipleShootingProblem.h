@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_MULTIPLESHOOTINGPROBLEM_H_
+#define DART_PLANNING_MULTIPLESHOOTINGPROBLEM_H_
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/optimizer/Function.h"
+#include "dart/optimizer/Problem.h"
+
+namespace dart {
+namespace simulation {
+class World;
+}  // namespace simulation
+}  // namespace dart
+
+namespace dart {
+namespace planning {
+
+/// \brief Trajectory optimization problem transcribed by multiple shooting.
+///
+/// The horizon of numSegments * stepsPerSegment World steps is split into
+/// segments. The optimization variables are the World state at the start of
+/// every segment plus the final state, and one generalized force vector of the
+/// controlled Skeleton per segment, held constant over the segment:
+///
+///   [x_0, u_0, x_1, u_1, ..., x_{S-1}, u_{S-1}, x_S]
+///
+/// where the World state x is the concatenation of Skeleton::getState() of
+/// every mobile Skeleton. Continuity is enforced by one equality constraint
+/// per state component and segment, F(x_s, u_s) - x_{s+1} = 0, where F
+/// simulates the World over the segment. Each of those constraints depends on
+/// a single block of variables, which is declared through
+/// Function::setDependentVariables so IpoptSolver sees the block-sparse
+/// Jacobian. x_0 is fixed to the current state of the World by the bounds.
+///
+/// All segments are simulated independently, and so are the finite
+/// differences that provide the dynamics derivatives. Both are spread over
+/// OpenMP threads, one worker World per thread. The worker Worlds must be
+/// structurally identical (e.g., loaded from the same file); the first one is
+/// the World whose current state is the start of the trajectory. That World is
+/// left untouched: its state is read by the constructor, and a clone of it
+/// (see World::clone()) is simulated in its place. The other workers are
+/// stepped, so their state and time change with every evaluation. Rollouts
+/// and derivatives are cached per segment, keyed by the start state and
+/// control of the segment, so the many constraint Functions evaluated by a
+/// solver at the same point share one batch of simulations, and each of them
+/// only compares and writes its own block of variables.
+///
+/// The default objective is the control effort,
+/// 0.5 * w * sum_s |u_s|^2 * stepsPerSegment * dt.
+class MultipleShootingProblem : public optimizer::Problem
+{
+public:
+  /// \brief Constructor
+  MultipleShootingProblem(const std::vector<simulation::World*>& _workers,
+                          size_t _controlledSkeleton,
+                          size_t _numSegments,
+                          size_t _stepsPerSegment);
+
+  /// \brief Destructor
+  virtual ~MultipleShootingProblem();
+
+  //------------------------------ Layout --------------------------------------
+  /// \brief Get the number of shooting segments
+  size_t getNumSegments() const;
+
+  /// \brief Get the number of World steps per segment
+  size_t getNumStepsPerSegment() const;
+
+  /// \brief Get the duration of one segment
+  double getSegmentDuration() const;
+
+  /// \brief Get the dimension of the World state
+  size_t getStateDimension() const;
+
+  /// \brief Get the dimension of the control of one segment
+  size_t getControlDimension() const;
+
+  /// \brief Get the index of the first entry of the state at the start of
+  /// _segment. _segment may be getNumSegments() for the final state.
+  size_t getStateIndex(size_t _segment) const;
+
+  /// \brief Get the index of the first entry of the control of _segment
+  size_t getControlIndex(size_t _segment) const;
+
+  //------------------------------ Settings ------------------------------------
+  /// \brief Fix the final state through the bounds
+  void setGoalState(const Eigen::VectorXd& _goal);
+
+  /// \brief Bound the control of every segment
+  void setControlLimits(const Eigen::VectorXd& _lower,
+                        const Eigen::VectorXd& _upper);
+
+  /// \brief Set the weight of the control effort objective
+  void setControlWeight(double _weight);
+
+  /// \brief Get the weight of the control effort objective
+  double getControlWeight() const;
+
+  /// \brief Set the step size of the finite differences
+  void setFiniteDifferenceStep(double _step);
+
+  /// \brief Get the step size of the finite differences
+  double getFiniteDifferenceStep() const;
+
+  //----------------------------- Evaluation -----------------------------------
+  /// \brief Get the state reached at the end of _segment when simulating it
+  /// from the variables _x
+  const Eigen::VectorXd& getSegmentEndState(const Eigen::VectorXd& _x,
+                                            size_t _segment);
+
+  /// \copydoc getSegmentEndState
+  const Eigen::VectorXd& getSegmentEndState(
+      const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment);
+
+  /// \brief Get the derivative of the end state of _segment with respect to
+  /// its start state
+  const Eigen::MatrixXd& getStateJacobian(const Eigen::VectorXd& _x,
+                                          size_t _segment);
+
+  /// \copydoc getStateJacobian
+  const Eigen::MatrixXd& getStateJacobian(
+      const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment);
+
+  /// \brief Get the derivative of the end state of _segment with respect to
+  /// its control
+  const Eigen::MatrixXd& getControlJacobian(const Eigen::VectorXd& _x,
+                                            size_t _segment);
+
+  /// \copydoc getControlJacobian
+  const Eigen::MatrixXd& getControlJacobian(
+      const Eigen::Map<const Eigen::VectorXd>& _x, size_t _segment);
+
+  /// \brief Simulate the whole horizon in one go from x_0 with the controls
+  /// in _x, and return the state after every World step, one per column
+  Eigen::MatrixXd rollout(const Eigen::VectorXd& _x);
+
+protected:
+  /// \brief Set the state of every mobile Skeleton of _world
+  void setWorldState(simulation::World* _world,
+                     const Eigen::VectorXd& _state) const;
+
+  /// \brief Get the state of every mobile Skeleton of _world
+  void getWorldState(const simulation::World* _world,
+                     Eigen::VectorXd& _state) const;
+
+  /// \brief Simulate one segment on _world
+  void simulateSegment(simulation::World* _world,
+                       const Eigen::VectorXd& _start,
+                       const Eigen::VectorXd& _control,
+                       Eigen::VectorXd& _end) const;
+
+  /// \brief Return true if the start state and the control of _segment are
+  /// the same in _x and in _cachedPoint. A segment only depends on those, so
+  /// this is all that needs comparing to reuse its cached simulations.
+  bool isSegmentCached(const Eigen::VectorXd& _cachedPoint,
+                       const Eigen::Map<const Eigen::VectorXd>& _x,
+                       size_t _segment) const;
+
+  /// \brief Simulate every segment whose variables changed since the last
+  /// rollout, unless _segment is cached
+  void updateRollouts(const Eigen::Map<const Eigen::VectorXd>& _x,
+                      size_t _segment);
+
+  /// \brief Compute the derivatives of every segment whose variables changed
+  /// since the last computation, unless _segment is cached
+  void updateDerivatives(const Eigen::Map<const Eigen::VectorXd>& _x,
+                         size_t _segment);
+
+  /// \brief Worker Worlds, one per thread
+  std::vector<simulation::World*> mWorkers;
+
+  /// \brief Clone of the first World given to the constructor, which is the
+  /// first worker
+  simulation::World* mOwnedWorker;
+
+  /// \brief Index of the controlled Skeleton in the Worlds
+  size_t mControlledSkeleton;
+
+  /// \brief Number of shooting segments
+  size_t mNumSegments;
+
+  /// \brief Number of World steps per segment
+  size_t mStepsPerSegment;
+
+  /// \brief Dimension of the World state
+  size_t mStateDim;
+
+  /// \brief Dimension of the control of one segment
+  size_t mControlDim;
+
+  /// \brief Weight of the control effort objective
+  double mControlWeight;
+
+  /// \brief Step size of the finite differences
+  double mFiniteDifferenceStep;
+
+  /// \brief Point at which mSegmentEnds was computed
+  Eigen::VectorXd mRolloutPoint;
+
+  /// \brief Point at which the segment Jacobians were computed
+  Eigen::VectorXd mDerivativePoint;
+
+  /// \brief State at the end of every segment
+  std::vector<Eigen::VectorXd> mSegmentEnds;
+
+  /// \brief Derivative of the end state of every segment w.r.t. its start
+  std::vector<Eigen::MatrixXd> mStateJacobians;
+
+  /// \brief Derivative of the end state of every segment w.r.t. its control
+  std::vector<Eigen::MatrixXd> mControlJacobians;
+
+  /// \brief Objective and constraint Functions owned by this problem
+  std::vector<optimizer::Function*> mFunctions;
+};
+
+/// \brief One component of the continuity constraint of a segment
+class ShootingDefectConstraint : public optimizer::Function
+{
+public:
+  /// \brief Constructor
+  ShootingDefectConstraint(MultipleShootingProblem* _problem,
+                           size_t _segment, size_t _component);
+
+  /// \brief Destructor
+  virtual ~ShootingDefectConstraint();
+
+  /// \copydoc Function::eval
+  virtual double eval(Eigen::Map<const Eigen::VectorXd>& _x);
+
+  /// \copydoc Function::evalGradient
+  virtual void evalGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                            Eigen::Map<Eigen::VectorXd> _grad);
+
+  /// \copydoc Function::evalSparseGradient
+  virtual void evalSparseGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                                  Eigen::Map<Eigen::VectorXd> _values);
+
+protected:
+  /// \brief Problem that this constraint belongs to
+  MultipleShootingProblem* mProblem;
+
+  /// \brief Segment of this constraint
+  size_t mSegment;
+
+  /// \brief State component of this constraint
+  size_t mComponent;
+};
+
+/// \brief Control effort objective of a MultipleShootingProblem
+class ShootingControlEffort : public optimizer::Function
+{
+public:
+  /// \brief Constructor
+  explicit ShootingControlEffort(MultipleShootingProblem* _problem);
+
+  /// \brief Destructor
+  virtual ~ShootingControlEffort();
+
+  /// \copydoc Function::eval
+  virtual double eval(Eigen::Map<const Eigen::VectorXd>& _x);
+
+  /// \copydoc Function::evalGradient
+  virtual void evalGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                            Eigen::Map<Eigen::VectorXd> _grad);
+
+  /// \copydoc Function::evalSparseGradient
+  virtual void evalSparseGradient(Eigen::Map<const Eigen::VectorXd>& _x,
+                                  Eigen::Map<Eigen::VectorXd> _values);
+
+protected:
+  /// \brief Problem that this objective belongs to
+  MultipleShootingProblem* mProblem;
+};
+
+}  // namespace planning
+}  // namespace dart
+
+#endif  // DART_PLANNING_MULTIPLESHOOTINGPROBLEM_H_
@@ -46,6 +46,7 @@
 #include "dart/dynamics/EllipsoidShape.h"
 #include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/LineSegmentShape.h"
+#include "dart/dynamics/HeightmapShape.h"
 #include "dart/renderer/LoadOpengl.h"
 #include "dart/renderer/OpenGLRenderInterface.h"
 
@@ -455,6 +456,9 @@ void OpenGLRenderInterface::compileList(dynamics::Shape* _shape) {
         case dynamics::Shape::LINE_SEGMENT:
             // Do nothing
             break;
+        case dynamics::Shape::HEIGHTMAP:
+            // Do nothing
+            break;
     }
 }
 
@@ -577,6 +581,14 @@ void OpenGLRenderInterface::draw(dynamics::Shape* _shape) {
           static_cast<dynamics::LineSegmentShape*>(_shape);
         drawLineSegments(lineSegments->getVertices(),
                          lineSegments->getConnections());
+        break;
+      }
+      case dynamics::Shape::HEIGHTMAP: {
+        dynamics::HeightmapShape* heightmap =
+          static_cast<dynamics::HeightmapShape*>(_shape);
+        drawHeightmap(heightmap->getNumRows(), heightmap->getNumCols(),
+                      heightmap->getHeights(), heightmap->getScale());
+        break;
       }
     }
 
@@ -599,6 +611,46 @@ void OpenGLRenderInterface::drawLineSegments(
   glEnd();
 }
 
+void OpenGLRenderInterface::drawHeightmap(
+    size_t _numRows, size_t _numCols, const float* _heights,
+    const Eigen::Vector3d& _scale)
+{
+  // Sample (row, col) of the grid, centered on the origin
+  auto vertex = [&](size_t _row, size_t _col)
+  {
+    return Eigen::Vector3d((_col - 0.5 * (_numCols - 1)) * _scale[0],
+                           (_row - 0.5 * (_numRows - 1)) * _scale[1],
+                           _heights[_row * _numCols + _col] * _scale[2]);
+  };
+
+  // Two triangles per cell, split along the same diagonal as for collisions
+  glBegin(GL_TRIANGLES);
+  for(size_t row = 0; row + 1 < _numRows; ++row)
+  {
+    for(size_t col = 0; col + 1 < _numCols; ++col)
+    {
+      const Eigen::Vector3d v00 = vertex(row, col);
+      const Eigen::Vector3d v01 = vertex(row, col + 1);
+      const Eigen::Vector3d v10 = vertex(row + 1, col);
+      const Eigen::Vector3d v11 = vertex(row + 1, col + 1);
+      const Eigen::Vector3d* triangles[2][3] = {
+        {&v00, &v01, &v11}, {&v00, &v11, &v10}};
+      for(size_t i = 0; i < 2; ++i)
+      {
+        const Eigen::Vector3d& a = *triangles[i][0];
+        const Eigen::Vector3d& b = *triangles[i][1];
+        const Eigen::Vector3d& c = *triangles[i][2];
+        const Eigen::Vector3d n = (b - a).cross(c - a).normalized();
+        glNormal3d(n[0], n[1], n[2]);
+        glVertex3d(a[0], a[1], a[2]);
+        glVertex3d(b[0], b[1], b[2]);
+        glVertex3d(c[0], c[1], c[2]);
+      }
+    }
+  }
+  glEnd();
+}
+
 void OpenGLRenderInterface::setPenColor(const Eigen::Vector4d& _col) {
     glColor4d(_col[0], _col[1], _col[2], _col[3]);
 }
@@ -99,6 +99,9 @@ public:
     virtual void drawList(GLuint index);
     virtual void drawLineSegments(const std::vector<Eigen::Vector3d>& _vertices,
                                   const std::vector<Eigen::Vector2i>& _connections) override;
+    virtual void drawHeightmap(size_t _numRows, size_t _numCols,
+                               const float* _heights,
+                               const Eigen::Vector3d& _scale) override;
 
     virtual void setPenColor(const Eigen::Vector4d& _col);
     virtual void setPenColor(const Eigen::Vector3d& _col);
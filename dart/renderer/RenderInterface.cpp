@@ -144,6 +144,10 @@ void RenderInterface::drawLineSegments(const std::vector<Eigen::Vector3d>&, cons
 {
 }
 
+void RenderInterface::drawHeightmap(size_t, size_t, const float*, const Eigen::Vector3d&)
+{
+}
+
 unsigned int RenderInterface::compileDisplayList(const Eigen::Vector3d& _size, const aiScene* _mesh)
 {
     return 0;
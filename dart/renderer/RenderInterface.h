@@ -108,6 +108,9 @@ public:
     virtual void drawList(unsigned int index);
     virtual void drawLineSegments(const std::vector<Eigen::Vector3d>& _vertices,
                                   const std::vector<Eigen::Vector2i>& _connections);
+    virtual void drawHeightmap(size_t _numRows, size_t _numCols,
+                               const float* _heights,
+                               const Eigen::Vector3d& _scale);
 
     virtual unsigned int compileDisplayList(const Eigen::Vector3d& _size, const aiScene* _mesh);
 
@@ -0,0 +1,1028 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/simulation/ParticleSystem.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "dart/collision/CollisionDetector.h"
+#include "dart/collision/dart/DARTCollide.h"
+#include "dart/common/Console.h"
+#include "dart/constraint/ContactConstraint.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/Skeleton.h"
+
+// Gap, relative to the sum of the radii, below which a speculative contact is
+// created between two particles or between a particle and a plane
+#define DART_PARTICLE_SPECULATIVE_MARGIN 0.1
+
+#define DART_PARTICLE_ERROR_REDUCTION_PARAMETER   0.2
+#define DART_PARTICLE_MAX_ERROR_REDUCTION_VELOCITY 1.0
+#define DART_PARTICLE_BOUNCING_VELOCITY_THRESHOLD 1e-1
+
+namespace dart {
+namespace simulation {
+
+//==============================================================================
+ParticleSystem::ParticleSystem(const std::string& _name)
+  : mName(_name),
+    mFrictionCoeff(1.0),
+    mRestitutionCoeff(0.0),
+    mNumIterations(10),
+    mParallel(true),
+    mCellSize(1.0),
+    mSphere(new dynamics::EllipsoidShape(Eigen::Vector3d::Ones()))
+{
+}
+
+//==============================================================================
+ParticleSystem::~ParticleSystem()
+{
+  delete mSphere;
+}
+
+//==============================================================================
+ParticleSystem* ParticleSystem::clone() const
+{
+  ParticleSystem* particles = new ParticleSystem(mName);
+
+  particles->mPositionX = mPositionX;
+  particles->mPositionY = mPositionY;
+  particles->mPositionZ = mPositionZ;
+  particles->mVelocityX = mVelocityX;
+  particles->mVelocityY = mVelocityY;
+  particles->mVelocityZ = mVelocityZ;
+  particles->mAngularVelocityX = mAngularVelocityX;
+  particles->mAngularVelocityY = mAngularVelocityY;
+  particles->mAngularVelocityZ = mAngularVelocityZ;
+  particles->mRadius = mRadius;
+  particles->mInvMass = mInvMass;
+  particles->mInvInertia = mInvInertia;
+
+  particles->mFrictionCoeff = mFrictionCoeff;
+  particles->mRestitutionCoeff = mRestitutionCoeff;
+  particles->mNumIterations = mNumIterations;
+  particles->mParallel = mParallel;
+
+  return particles;
+}
+
+//==============================================================================
+void ParticleSystem::setName(const std::string& _name)
+{
+  mName = _name;
+}
+
+//==============================================================================
+const std::string& ParticleSystem::getName() const
+{
+  return mName;
+}
+
+//==============================================================================
+size_t ParticleSystem::addParticle(const Eigen::Vector3d& _position,
+                                   double _radius, double _mass)
+{
+  assert(_radius > 0.0 && "Radius of particle should be positive.");
+  assert(_mass > 0.0 && "Mass of particle should be positive.");
+
+  mPositionX.push_back(_position[0]);
+  mPositionY.push_back(_position[1]);
+  mPositionZ.push_back(_position[2]);
+  mVelocityX.push_back(0.0);
+  mVelocityY.push_back(0.0);
+  mVelocityZ.push_back(0.0);
+  mAngularVelocityX.push_back(0.0);
+  mAngularVelocityY.push_back(0.0);
+  mAngularVelocityZ.push_back(0.0);
+  mRadius.push_back(_radius);
+  mInvMass.push_back(1.0 / _mass);
+  // Solid sphere
+  mInvInertia.push_back(1.0 / (0.4 * _mass * _radius * _radius));
+
+  return mRadius.size() - 1;
+}
+
+//==============================================================================
+void ParticleSystem::removeParticle(size_t _index)
+{
+  assert(_index < getNumParticles());
+
+  std::vector<double>* arrays[] = {
+    &mPositionX, &mPositionY, &mPositionZ,
+    &mVelocityX, &mVelocityY, &mVelocityZ,
+    &mAngularVelocityX, &mAngularVelocityY, &mAngularVelocityZ,
+    &mRadius, &mInvMass, &mInvInertia
+  };
+
+  for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); ++i)
+  {
+    std::vector<double>& array = *arrays[i];
+    array[_index] = array.back();
+    array.pop_back();
+  }
+
+  clearContacts();
+}
+
+//==============================================================================
+void ParticleSystem::removeAllParticles()
+{
+  mPositionX.clear();
+  mPositionY.clear();
+  mPositionZ.clear();
+  mVelocityX.clear();
+  mVelocityY.clear();
+  mVelocityZ.clear();
+  mAngularVelocityX.clear();
+  mAngularVelocityY.clear();
+  mAngularVelocityZ.clear();
+  mRadius.clear();
+  mInvMass.clear();
+  mInvInertia.clear();
+
+  clearContacts();
+}
+
+//==============================================================================
+size_t ParticleSystem::getNumParticles() const
+{
+  return mRadius.size();
+}
+
+//==============================================================================
+double ParticleSystem::getRadius(size_t _index) const
+{
+  assert(_index < getNumParticles());
+  return mRadius[_index];
+}
+
+//==============================================================================
+double ParticleSystem::getMass(size_t _index) const
+{
+  assert(_index < getNumParticles());
+  return 1.0 / mInvMass[_index];
+}
+
+//==============================================================================
+void ParticleSystem::setPosition(size_t _index,
+                                 const Eigen::Vector3d& _position)
+{
+  assert(_index < getNumParticles());
+  mPositionX[_index] = _position[0];
+  mPositionY[_index] = _position[1];
+  mPositionZ[_index] = _position[2];
+}
+
+//==============================================================================
+Eigen::Vector3d ParticleSystem::getPosition(size_t _index) const
+{
+  assert(_index < getNumParticles());
+  return Eigen::Vector3d(mPositionX[_index], mPositionY[_index],
+                         mPositionZ[_index]);
+}
+
+//==============================================================================
+void ParticleSystem::setVelocity(size_t _index,
+                                 const Eigen::Vector3d& _velocity)
+{
+  assert(_index < getNumParticles());
+  mVelocityX[_index] = _velocity[0];
+  mVelocityY[_index] = _velocity[1];
+  mVelocityZ[_index] = _velocity[2];
+}
+
+//==============================================================================
+Eigen::Vector3d ParticleSystem::getVelocity(size_t _index) const
+{
+  assert(_index < getNumParticles());
+  return Eigen::Vector3d(mVelocityX[_index], mVelocityY[_index],
+                         mVelocityZ[_index]);
+}
+
+//==============================================================================
+void ParticleSystem::setAngularVelocity(size_t _index,
+                                        const Eigen::Vector3d& _velocity)
+{
+  assert(_index < getNumParticles());
+  mAngularVelocityX[_index] = _velocity[0];
+  mAngularVelocityY[_index] = _velocity[1];
+  mAngularVelocityZ[_index] = _velocity[2];
+}
+
+//==============================================================================
+Eigen::Vector3d ParticleSystem::getAngularVelocity(size_t _index) const
+{
+  assert(_index < getNumParticles());
+  return Eigen::Vector3d(mAngularVelocityX[_index], mAngularVelocityY[_index],
+                         mAngularVelocityZ[_index]);
+}
+
+//==============================================================================
+void ParticleSystem::setFrictionCoeff(double _coeff)
+{
+  assert(_coeff >= 0.0 && "Coefficient of friction should be non-negative.");
+  mFrictionCoeff = _coeff;
+}
+
+//==============================================================================
+double ParticleSystem::getFrictionCoeff() const
+{
+  return mFrictionCoeff;
+}
+
+//==============================================================================
+void ParticleSystem::setRestitutionCoeff(double _coeff)
+{
+  assert(0.0 <= _coeff && _coeff <= 1.0
+         && "Coefficient of restitution should be in range of [0, 1].");
+  mRestitutionCoeff = _coeff;
+}
+
+//==============================================================================
+double ParticleSystem::getRestitutionCoeff() const
+{
+  return mRestitutionCoeff;
+}
+
+//==============================================================================
+void ParticleSystem::setNumIterations(size_t _numIterations)
+{
+  mNumIterations = _numIterations;
+}
+
+//==============================================================================
+size_t ParticleSystem::getNumIterations() const
+{
+  return mNumIterations;
+}
+
+//==============================================================================
+void ParticleSystem::setParallel(bool _parallel)
+{
+  mParallel = _parallel;
+}
+
+//==============================================================================
+bool ParticleSystem::isParallel() const
+{
+  return mParallel;
+}
+
+//==============================================================================
+void ParticleSystem::integrateVelocities(const Eigen::Vector3d& _gravity,
+                                         double _timeStep)
+{
+  const Eigen::Vector3d dv = _gravity * _timeStep;
+  const size_t numParticles = getNumParticles();
+
+  for (size_t i = 0; i < numParticles; ++i)
+  {
+    mVelocityX[i] += dv[0];
+    mVelocityY[i] += dv[1];
+    mVelocityZ[i] += dv[2];
+  }
+}
+
+//==============================================================================
+size_t ParticleSystem::detectContacts(
+    const std::vector<dynamics::Skeleton*>& _skeletons)
+{
+  clearContacts();
+
+  if (getNumParticles() == 0)
+    return 0;
+
+  updateGrid();
+  detectParticleContacts();
+
+  for (size_t i = 0; i < _skeletons.size(); ++i)
+  {
+    dynamics::Skeleton* skel = _skeletons[i];
+
+    for (size_t j = 0; j < skel->getNumBodyNodes(); ++j)
+    {
+      dynamics::BodyNode* bodyNode = skel->getBodyNode(j);
+
+      if (bodyNode->isCollidable() && bodyNode->getNumCollisionShapes() > 0)
+        detectBodyContacts(bodyNode);
+    }
+  }
+
+  return getNumContacts();
+}
+
+//==============================================================================
+void ParticleSystem::solveContacts(double _timeStep)
+{
+  const size_t numContacts = mContactParticle1.size();
+
+  if (numContacts == 0)
+    return;
+
+  const double invTimeStep = 1.0 / _timeStep;
+  const double errorAllowance
+      = constraint::ContactConstraint::getErrorAllowance();
+
+  // Mass splitting: each contact sees its particles with their mass divided
+  // by their number of contacts, and the impulses of all contacts are summed
+  mNumParticleContacts.assign(getNumParticles(), 0.0);
+  for (size_t c = 0; c < numContacts; ++c)
+  {
+    mNumParticleContacts[mContactParticle1[c]] += 1.0;
+    if (mContactParticle2[c] >= 0)
+      mNumParticleContacts[mContactParticle2[c]] += 1.0;
+  }
+
+  mContactTargetVelocity.resize(numContacts);
+  mContactNormalMass.resize(numContacts);
+  mContactTangentMass.resize(numContacts);
+  mContactNormalImpulse.assign(numContacts, 0.0);
+  mContactTangentImpulseX.assign(numContacts, 0.0);
+  mContactTangentImpulseY.assign(numContacts, 0.0);
+  mContactTangentImpulseZ.assign(numContacts, 0.0);
+  mContactImpulseX.resize(numContacts);
+  mContactImpulseY.resize(numContacts);
+  mContactImpulseZ.resize(numContacts);
+
+  // Inverse effective masses of the particles
+  for (size_t c = 0; c < numContacts; ++c)
+  {
+    const int a = mContactParticle1[c];
+    const int b = mContactParticle2[c];
+
+    mContactNormalMass[c] = mNumParticleContacts[a] * mInvMass[a];
+    mContactTangentMass[c] = mNumParticleContacts[a]
+        * (mInvMass[a] + mRadius[a] * mRadius[a] * mInvInertia[a]);
+
+    if (b >= 0)
+    {
+      mContactNormalMass[c] += mNumParticleContacts[b] * mInvMass[b];
+      mContactTangentMass[c] += mNumParticleContacts[b]
+          * (mInvMass[b] + mRadius[b] * mRadius[b] * mInvInertia[b]);
+    }
+  }
+
+  // Inverse effective masses of the reactive bodies, split among the
+  // contacts of their skeletons
+  updateBodyResponses();
+  for (size_t i = 0; i < mGroupContacts.size(); ++i)
+  {
+    const std::vector<size_t>& contacts = mGroupContacts[i];
+    const double numGroupContacts = static_cast<double>(contacts.size());
+
+    for (size_t j = 0; j < contacts.size(); ++j)
+    {
+      const size_t c = mBodyContacts[contacts[j]];
+      const Eigen::Vector3d normal(mContactNormalX[c], mContactNormalY[c],
+                                   mContactNormalZ[c]);
+      const Eigen::Matrix3d response
+          = mGroupResponses[i].block<3, 3>(3 * j, 3 * j);
+      const double normalResponse = normal.dot(response * normal);
+
+      mContactNormalMass[c] += numGroupContacts * normalResponse;
+      mContactTangentMass[c] += numGroupContacts * 0.5
+          * (response.trace() - normalResponse);
+    }
+  }
+
+  for (size_t c = 0; c < numContacts; ++c)
+  {
+    const int a = mContactParticle1[c];
+    const int b = mContactParticle2[c];
+
+    mContactNormalMass[c] = 1.0 / mContactNormalMass[c];
+    mContactTangentMass[c] = 1.0 / mContactTangentMass[c];
+
+    double normalVelocity = mContactNormalX[c] * mVelocityX[a]
+                            + mContactNormalY[c] * mVelocityY[a]
+                            + mContactNormalZ[c] * mVelocityZ[a];
+
+    if (b >= 0)
+    {
+      normalVelocity -= mContactNormalX[c] * mVelocityX[b]
+                        + mContactNormalY[c] * mVelocityY[b]
+                        + mContactNormalZ[c] * mVelocityZ[b];
+    }
+    else
+    {
+      normalVelocity -= mContactNormalX[c] * mContactVelocityX[c]
+                        + mContactNormalY[c] * mContactVelocityY[c]
+                        + mContactNormalZ[c] * mContactVelocityZ[c];
+    }
+
+    // Normal velocity to reach: close the gap of a speculative contact, or
+    // push the particles apart to reduce the penetration
+    const double depth = mContactDepth[c];
+    double targetVelocity;
+    if (depth < 0.0)
+    {
+      targetVelocity = depth * invTimeStep;
+    }
+    else
+    {
+      targetVelocity = std::min(
+            std::max(depth - errorAllowance, 0.0)
+            * DART_PARTICLE_ERROR_REDUCTION_PARAMETER * invTimeStep,
+            DART_PARTICLE_MAX_ERROR_REDUCTION_VELOCITY);
+
+      const double restitutionVelocity
+          = -normalVelocity * mContactRestitution[c];
+      if (restitutionVelocity > DART_PARTICLE_BOUNCING_VELOCITY_THRESHOLD)
+        targetVelocity = std::max(targetVelocity, restitutionVelocity);
+    }
+
+    mContactTargetVelocity[c] = targetVelocity;
+  }
+
+  const int numContactsInt = static_cast<int>(numContacts);
+
+  for (size_t iteration = 0; iteration < mNumIterations; ++iteration)
+  {
+    // Impulses of all contacts from the velocities of the last iteration
+#pragma omp parallel for schedule(static) if(mParallel)
+    for (int c = 0; c < numContactsInt; ++c)
+    {
+      const int a = mContactParticle1[c];
+      const int b = mContactParticle2[c];
+      const double nx = mContactNormalX[c];
+      const double ny = mContactNormalY[c];
+      const double nz = mContactNormalZ[c];
+
+      // Relative velocity at the contact point, whose arm is -radius * normal
+      // from the first particle and radius * normal from the second
+      double ra = mRadius[a];
+      double vx = mVelocityX[a]
+          - ra * (mAngularVelocityY[a] * nz - mAngularVelocityZ[a] * ny);
+      double vy = mVelocityY[a]
+          - ra * (mAngularVelocityZ[a] * nx - mAngularVelocityX[a] * nz);
+      double vz = mVelocityZ[a]
+          - ra * (mAngularVelocityX[a] * ny - mAngularVelocityY[a] * nx);
+
+      if (b >= 0)
+      {
+        const double rb = mRadius[b];
+        vx -= mVelocityX[b]
+            + rb * (mAngularVelocityY[b] * nz - mAngularVelocityZ[b] * ny);
+        vy -= mVelocityY[b]
+            + rb * (mAngularVelocityZ[b] * nx - mAngularVelocityX[b] * nz);
+        vz -= mVelocityZ[b]
+            + rb * (mAngularVelocityX[b] * ny - mAngularVelocityY[b] * nx);
+      }
+      else
+      {
+        vx -= mContactVelocityX[c];
+        vy -= mContactVelocityY[c];
+        vz -= mContactVelocityZ[c];
+      }
+
+      // Normal impulse
+      const double vn = vx * nx + vy * ny + vz * nz;
+      const double oldNormalImpulse = mContactNormalImpulse[c];
+      const double normalImpulse = std::max(
+            oldNormalImpulse
+            + mContactNormalMass[c] * (mContactTargetVelocity[c] - vn), 0.0);
+      const double dn = normalImpulse - oldNormalImpulse;
+      mContactNormalImpulse[c] = normalImpulse;
+
+      // Friction impulse, limited to the friction cone
+      const double tangentMass = mContactTangentMass[c];
+      double tx = mContactTangentImpulseX[c] - tangentMass * (vx - vn * nx);
+      double ty = mContactTangentImpulseY[c] - tangentMass * (vy - vn * ny);
+      double tz = mContactTangentImpulseZ[c] - tangentMass * (vz - vn * nz);
+      const double maxTangentImpulse = mContactFriction[c] * normalImpulse;
+      const double tangentImpulse = std::sqrt(tx * tx + ty * ty + tz * tz);
+      if (tangentImpulse > maxTangentImpulse)
+      {
+        const double scale = maxTangentImpulse / tangentImpulse;
+        tx *= scale;
+        ty *= scale;
+        tz *= scale;
+      }
+
+      mContactImpulseX[c] = dn * nx + tx - mContactTangentImpulseX[c];
+      mContactImpulseY[c] = dn * ny + ty - mContactTangentImpulseY[c];
+      mContactImpulseZ[c] = dn * nz + tz - mContactTangentImpulseZ[c];
+      mContactTangentImpulseX[c] = tx;
+      mContactTangentImpulseY[c] = ty;
+      mContactTangentImpulseZ[c] = tz;
+    }
+
+    // Apply the impulses, to the first particle at -radius * normal and to
+    // the second at radius * normal
+    for (size_t c = 0; c < numContacts; ++c)
+    {
+      const Eigen::Vector3d normal(mContactNormalX[c], mContactNormalY[c],
+                                   mContactNormalZ[c]);
+      const Eigen::Vector3d impulse(mContactImpulseX[c], mContactImpulseY[c],
+                                    mContactImpulseZ[c]);
+      const int a = mContactParticle1[c];
+      const int b = mContactParticle2[c];
+
+      applyImpulse(a, impulse, -mRadius[a] * normal);
+      if (b >= 0)
+        applyImpulse(b, -impulse, mRadius[b] * normal);
+    }
+
+    // The reactive bodies take the opposite impulses
+    for (size_t i = 0; i < mGroupContacts.size(); ++i)
+    {
+      const std::vector<size_t>& contacts = mGroupContacts[i];
+      Eigen::VectorXd impulses(3 * contacts.size());
+
+      for (size_t j = 0; j < contacts.size(); ++j)
+      {
+        const size_t c = mBodyContacts[contacts[j]];
+        impulses.segment<3>(3 * j) << mContactImpulseX[c], mContactImpulseY[c],
+                                      mContactImpulseZ[c];
+      }
+
+      const Eigen::VectorXd velocityChanges = mGroupResponses[i] * impulses;
+
+      for (size_t j = 0; j < contacts.size(); ++j)
+      {
+        const size_t c = mBodyContacts[contacts[j]];
+        mContactVelocityX[c] += velocityChanges[3 * j];
+        mContactVelocityY[c] += velocityChanges[3 * j + 1];
+        mContactVelocityZ[c] += velocityChanges[3 * j + 2];
+      }
+    }
+  }
+
+  // Apply the total impulses to the reactive bodies as constraint impulses
+  for (size_t i = 0; i < mBodyContacts.size(); ++i)
+  {
+    const size_t c = mBodyContacts[i];
+    const Eigen::Vector3d impulse
+        = mContactNormalImpulse[c] * Eigen::Vector3d(mContactNormalX[c],
+                                                     mContactNormalY[c],
+                                                     mContactNormalZ[c])
+          + Eigen::Vector3d(mContactTangentImpulseX[c],
+                            mContactTangentImpulseY[c],
+                            mContactTangentImpulseZ[c]);
+
+    mBodyContactNodes[i]->addConstraintImpulse(-impulse,
+                                               mBodyContactPoints[i],
+                                               false, false);
+  }
+
+  for (size_t i = 0; i < mGroupSkeletons.size(); ++i)
+    mGroupSkeletons[i]->setImpulseApplied(true);
+}
+
+//==============================================================================
+void ParticleSystem::updateBodyResponses()
+{
+  mGroupResponses.resize(mGroupSkeletons.size());
+
+  for (size_t i = 0; i < mGroupSkeletons.size(); ++i)
+  {
+    dynamics::Skeleton* skel = mGroupSkeletons[i];
+    const std::vector<size_t>& contacts = mGroupContacts[i];
+
+    // Take the constraint impulses of the constraint solver into the
+    // velocities first, so that the particles see them
+    if (skel->isImpulseApplied())
+    {
+      skel->computeImpulseForwardDynamics();
+      skel->setImpulseApplied(false);
+    }
+    skel->clearConstraintImpulses();
+
+    for (size_t j = 0; j < contacts.size(); ++j)
+    {
+      dynamics::BodyNode* bodyNode = mBodyContactNodes[contacts[j]];
+      const Eigen::Vector3d& point = mBodyContactPoints[contacts[j]];
+      const Eigen::Vector3d velocity
+          = bodyNode->getLinearVelocity(bodyNode->getTransform().inverse()
+                                        * point);
+      const size_t c = mBodyContacts[contacts[j]];
+      mContactVelocityX[c] = velocity[0];
+      mContactVelocityY[c] = velocity[1];
+      mContactVelocityZ[c] = velocity[2];
+    }
+
+    // Velocity changes of all contact points of the skeleton due to the
+    // opposite of a unit impulse on the particle of each contact, along each
+    // axis, as a ContactConstraint computes them
+    Eigen::MatrixXd& response = mGroupResponses[i];
+    response.resize(3 * contacts.size(), 3 * contacts.size());
+
+    for (size_t j = 0; j < contacts.size(); ++j)
+    {
+      dynamics::BodyNode* bodyNode = mBodyContactNodes[contacts[j]];
+      const Eigen::Isometry3d& T = bodyNode->getTransform();
+      const Eigen::Vector3d bodyPoint
+          = T.inverse() * mBodyContactPoints[contacts[j]];
+
+      for (size_t k = 0; k < 3; ++k)
+      {
+        const Eigen::Vector3d bodyDirection
+            = -T.linear().transpose().col(k);
+        Eigen::Vector6d impulse;
+        impulse.head<3>() = bodyPoint.cross(bodyDirection);
+        impulse.tail<3>() = bodyDirection;
+
+        skel->updateBiasImpulse(bodyNode, impulse);
+        skel->updateVelocityChange();
+
+        for (size_t l = 0; l < contacts.size(); ++l)
+        {
+          dynamics::BodyNode* otherBodyNode = mBodyContactNodes[contacts[l]];
+          const Eigen::Isometry3d& otherT = otherBodyNode->getTransform();
+          const Eigen::Vector3d otherBodyPoint
+              = otherT.inverse() * mBodyContactPoints[contacts[l]];
+          const Eigen::Vector6d& velocityChange
+              = otherBodyNode->getBodyVelocityChange();
+
+          response.block<3, 1>(3 * l, 3 * j + k)
+              = otherT.linear()
+                * (velocityChange.tail<3>()
+                   + velocityChange.head<3>().cross(otherBodyPoint));
+        }
+      }
+    }
+
+    skel->clearConstraintImpulses();
+  }
+}
+
+//==============================================================================
+void ParticleSystem::integratePositions(double _timeStep)
+{
+  const size_t numParticles = getNumParticles();
+
+  for (size_t i = 0; i < numParticles; ++i)
+  {
+    mPositionX[i] += mVelocityX[i] * _timeStep;
+    mPositionY[i] += mVelocityY[i] * _timeStep;
+    mPositionZ[i] += mVelocityZ[i] * _timeStep;
+  }
+}
+
+//==============================================================================
+size_t ParticleSystem::getNumContacts() const
+{
+  return mContactParticle1.size();
+}
+
+//==============================================================================
+size_t ParticleSystem::getNumBodyContacts() const
+{
+  return mBodyContacts.size();
+}
+
+//==============================================================================
+void ParticleSystem::updateGrid()
+{
+  const size_t numParticles = getNumParticles();
+
+  const double maxRadius = *std::max_element(mRadius.begin(), mRadius.end());
+  mCellSize = 2.0 * maxRadius * (1.0 + DART_PARTICLE_SPECULATIVE_MARGIN);
+
+  // At least twice as many buckets as particles, and a power of two so that
+  // the hash is reduced by a mask
+  size_t numBuckets = 1;
+  while (numBuckets < 2 * numParticles)
+    numBuckets <<= 1;
+
+  mBucketStarts.assign(numBuckets + 1, 0);
+  mParticleBuckets.resize(numParticles);
+  mBucketParticles.resize(numParticles);
+
+  // Counting sort of the particles by their buckets
+  for (size_t i = 0; i < numParticles; ++i)
+  {
+    const Eigen::Vector3d position(mPositionX[i], mPositionY[i],
+                                   mPositionZ[i]);
+    mParticleBuckets[i] = static_cast<uint32_t>(getBucket(getCell(position)));
+    ++mBucketStarts[mParticleBuckets[i] + 1];
+  }
+
+  for (size_t i = 0; i < numBuckets; ++i)
+    mBucketStarts[i + 1] += mBucketStarts[i];
+
+  std::vector<uint32_t> next(mBucketStarts.begin(), mBucketStarts.end() - 1);
+  for (size_t i = 0; i < numParticles; ++i)
+    mBucketParticles[next[mParticleBuckets[i]]++] = static_cast<uint32_t>(i);
+}
+
+//==============================================================================
+Eigen::Vector3i ParticleSystem::getCell(const Eigen::Vector3d& _point) const
+{
+  return Eigen::Vector3i(static_cast<int>(std::floor(_point[0] / mCellSize)),
+                         static_cast<int>(std::floor(_point[1] / mCellSize)),
+                         static_cast<int>(std::floor(_point[2] / mCellSize)));
+}
+
+//==============================================================================
+size_t ParticleSystem::getBucket(const Eigen::Vector3i& _cell) const
+{
+  const uint32_t hash = (static_cast<uint32_t>(_cell[0]) * 73856093u)
+                        ^ (static_cast<uint32_t>(_cell[1]) * 19349663u)
+                        ^ (static_cast<uint32_t>(_cell[2]) * 83492791u);
+
+  return hash & static_cast<uint32_t>(mBucketStarts.size() - 2);
+}
+
+//==============================================================================
+void ParticleSystem::detectParticleContacts()
+{
+  const size_t numParticles = getNumParticles();
+  const Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+
+  size_t buckets[27];
+
+  for (size_t i = 0; i < numParticles; ++i)
+  {
+    const Eigen::Vector3d position1(mPositionX[i], mPositionY[i],
+                                    mPositionZ[i]);
+    const Eigen::Vector3i cell = getCell(position1);
+
+    // Buckets of the 27 cells around the particle, where several cells may
+    // share a bucket
+    size_t numBuckets = 0;
+    for (int x = -1; x <= 1; ++x)
+    {
+      for (int y = -1; y <= 1; ++y)
+      {
+        for (int z = -1; z <= 1; ++z)
+        {
+          const size_t bucket
+              = getBucket(cell + Eigen::Vector3i(x, y, z));
+          if (std::find(buckets, buckets + numBuckets, bucket)
+              == buckets + numBuckets)
+          {
+            buckets[numBuckets++] = bucket;
+          }
+        }
+      }
+    }
+
+    for (size_t k = 0; k < numBuckets; ++k)
+    {
+      for (uint32_t l = mBucketStarts[buckets[k]];
+           l < mBucketStarts[buckets[k] + 1]; ++l)
+      {
+        const size_t j = mBucketParticles[l];
+
+        // Each pair once
+        if (j <= i)
+          continue;
+
+        const Eigen::Vector3d diff = position1 - getPosition(j);
+        const double radii = mRadius[i] + mRadius[j];
+        const double margin = DART_PARTICLE_SPECULATIVE_MARGIN * radii;
+        const double distanceSquared = diff.squaredNorm();
+
+        if (distanceSquared >= (radii + margin) * (radii + margin))
+          continue;
+
+        const double distance = std::sqrt(distanceSquared);
+        const Eigen::Vector3d normal = distance > 1e-12
+            ? Eigen::Vector3d(diff / distance) : Eigen::Vector3d::UnitZ();
+
+        addContact(static_cast<int>(i), static_cast<int>(j), normal,
+                   radii - distance, zero, mFrictionCoeff,
+                   mRestitutionCoeff * mRestitutionCoeff);
+      }
+    }
+  }
+}
+
+//==============================================================================
+void ParticleSystem::detectBodyContacts(dynamics::BodyNode* _bodyNode)
+{
+  const size_t numParticles = getNumParticles();
+  std::vector<collision::Contact> contacts;
+
+  for (size_t i = 0; i < _bodyNode->getNumCollisionShapes(); ++i)
+  {
+    const dynamics::Shape* shape = _bodyNode->getCollisionShape(i);
+    const Eigen::Isometry3d T
+        = _bodyNode->getTransform() * shape->getLocalTransform();
+
+    if (shape->getShapeType() == dynamics::Shape::PLANE)
+    {
+      const dynamics::PlaneShape* plane
+          = static_cast<const dynamics::PlaneShape*>(shape);
+      const Eigen::Vector3d normal = T.linear() * plane->getNormal();
+      const double offset = plane->getOffset() + normal.dot(T.translation());
+
+      for (size_t j = 0; j < numParticles; ++j)
+      {
+        const Eigen::Vector3d position = getPosition(j);
+        const double distance = normal.dot(position) - offset;
+        const double gap = distance - mRadius[j];
+
+        if (gap < DART_PARTICLE_SPECULATIVE_MARGIN * mRadius[j])
+        {
+          addBodyContact(j, _bodyNode, position - distance * normal, normal,
+                         -gap);
+        }
+      }
+
+      continue;
+    }
+
+    // Radius of the bounding sphere of the shape, or infinity to test every
+    // particle
+    double boundingRadius = std::numeric_limits<double>::infinity();
+    switch (shape->getShapeType())
+    {
+      case dynamics::Shape::BOX:
+        boundingRadius = 0.5 * static_cast<const dynamics::BoxShape*>(
+                               shape)->getSize().norm();
+        break;
+      case dynamics::Shape::ELLIPSOID:
+        boundingRadius = 0.5 * static_cast<const dynamics::EllipsoidShape*>(
+                               shape)->getSize().maxCoeff();
+        break;
+      case dynamics::Shape::CYLINDER:
+      {
+        const dynamics::CylinderShape* cylinder
+            = static_cast<const dynamics::CylinderShape*>(shape);
+        boundingRadius = std::sqrt(cylinder->getRadius()
+                                   * cylinder->getRadius()
+                                   + 0.25 * cylinder->getHeight()
+                                   * cylinder->getHeight());
+        break;
+      }
+      default:
+        break;
+    }
+
+    for (size_t j = 0; j < numParticles; ++j)
+    {
+      const Eigen::Vector3d position = getPosition(j);
+      const double radius = boundingRadius + mRadius[j];
+
+      if ((position - T.translation()).squaredNorm() >= radius * radius)
+        continue;
+
+      Eigen::Isometry3d particleTransform = Eigen::Isometry3d::Identity();
+      particleTransform.translation() = position;
+      mSphere->setSize(Eigen::Vector3d::Constant(2.0 * mRadius[j]));
+
+      contacts.clear();
+      if (collision::collide(mSphere, particleTransform, shape, T, &contacts)
+          == 0)
+      {
+        continue;
+      }
+
+      // The deepest contact, whose normal points from the body to the
+      // particle
+      size_t deepest = 0;
+      for (size_t k = 1; k < contacts.size(); ++k)
+      {
+        if (contacts[k].penetrationDepth > contacts[deepest].penetrationDepth)
+          deepest = k;
+      }
+
+      addBodyContact(j, _bodyNode, contacts[deepest].point,
+                     contacts[deepest].normal,
+                     contacts[deepest].penetrationDepth);
+    }
+  }
+}
+
+//==============================================================================
+void ParticleSystem::addBodyContact(size_t _particle,
+                                    dynamics::BodyNode* _bodyNode,
+                                    const Eigen::Vector3d& _point,
+                                    const Eigen::Vector3d& _normal,
+                                    double _depth)
+{
+  // The velocities of reactive bodies are read when the contacts are solved
+  if (_bodyNode->isReactive())
+  {
+    dynamics::Skeleton* skel = _bodyNode->getSkeleton();
+    const size_t group = std::find(mGroupSkeletons.begin(),
+                                   mGroupSkeletons.end(), skel)
+                         - mGroupSkeletons.begin();
+    if (group == mGroupSkeletons.size())
+    {
+      mGroupSkeletons.push_back(skel);
+      mGroupContacts.push_back(std::vector<size_t>());
+    }
+
+    mGroupContacts[group].push_back(mBodyContacts.size());
+    mBodyContacts.push_back(mContactParticle1.size());
+    mBodyContactNodes.push_back(_bodyNode);
+    mBodyContactPoints.push_back(_point);
+    mBodyContactGroups.push_back(group);
+  }
+
+  const Eigen::Vector3d velocity = _bodyNode->getLinearVelocity(
+        _bodyNode->getTransform().inverse() * _point);
+
+  addContact(static_cast<int>(_particle), -1, _normal, _depth, velocity,
+             std::min(mFrictionCoeff, _bodyNode->getFrictionCoeff()),
+             mRestitutionCoeff * _bodyNode->getRestitutionCoeff());
+}
+
+//==============================================================================
+void ParticleSystem::addContact(int _particle1, int _particle2,
+                                const Eigen::Vector3d& _normal, double _depth,
+                                const Eigen::Vector3d& _velocity2,
+                                double _frictionCoeff,
+                                double _restitutionCoeff)
+{
+  mContactParticle1.push_back(_particle1);
+  mContactParticle2.push_back(_particle2);
+  mContactNormalX.push_back(_normal[0]);
+  mContactNormalY.push_back(_normal[1]);
+  mContactNormalZ.push_back(_normal[2]);
+  mContactVelocityX.push_back(_velocity2[0]);
+  mContactVelocityY.push_back(_velocity2[1]);
+  mContactVelocityZ.push_back(_velocity2[2]);
+  mContactDepth.push_back(_depth);
+  mContactFriction.push_back(_frictionCoeff);
+  mContactRestitution.push_back(_restitutionCoeff);
+}
+
+//==============================================================================
+void ParticleSystem::applyImpulse(size_t _index,
+                                  const Eigen::Vector3d& _impulse,
+                                  const Eigen::Vector3d& _arm)
+{
+  const double invMass = mInvMass[_index];
+  mVelocityX[_index] += invMass * _impulse[0];
+  mVelocityY[_index] += invMass * _impulse[1];
+  mVelocityZ[_index] += invMass * _impulse[2];
+
+  const Eigen::Vector3d angularImpulse = _arm.cross(_impulse);
+  const double invInertia = mInvInertia[_index];
+  mAngularVelocityX[_index] += invInertia * angularImpulse[0];
+  mAngularVelocityY[_index] += invInertia * angularImpulse[1];
+  mAngularVelocityZ[_index] += invInertia * angularImpulse[2];
+}
+
+//==============================================================================
+void ParticleSystem::clearContacts()
+{
+  mContactParticle1.clear();
+  mContactParticle2.clear();
+  mContactNormalX.clear();
+  mContactNormalY.clear();
+  mContactNormalZ.clear();
+  mContactVelocityX.clear();
+  mContactVelocityY.clear();
+  mContactVelocityZ.clear();
+  mContactDepth.clear();
+  mContactFriction.clear();
+  mContactRestitution.clear();
+
+  mBodyContacts.clear();
+  mBodyContactNodes.clear();
+  mBodyContactPoints.clear();
+  mBodyContactGroups.clear();
+  mGroupSkeletons.clear();
+  mGroupContacts.clear();
+}
+
+}  // namespace simulation
+}  // namespace dart
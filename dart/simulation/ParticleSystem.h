@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_SIMULATION_PARTICLESYSTEM_H_
+#define DART_SIMULATION_PARTICLESYSTEM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace dart {
+namespace dynamics {
+class BodyNode;
+class EllipsoidShape;
+class Skeleton;
+}  // namespace dynamics
+}  // namespace dart
+
+namespace dart {
+namespace simulation {
+
+/// \brief class ParticleSystem
+///
+/// ParticleSystem simulates large numbers of small rigid spheres, such as the
+/// grains of a granular material or the parts in a bin, much faster than one
+/// Skeleton with a FreeJoint per sphere. The state of the particles is kept
+/// in flat arrays with one array per coordinate, so the particles are
+/// integrated and solved by simple loops over contiguous memory.
+///
+/// Contacts are found through a uniform hash grid whose cells are as wide as
+/// the largest particle, so each particle is only tested against the
+/// particles of its own and the 26 neighbouring cells. Particles are also
+/// tested against the collision shapes of the skeletons of the world.
+///
+/// All contacts are solved together by a fixed number of Jacobi iterations
+/// with mass splitting, each iteration being a loop over the contacts that
+/// runs on OpenMP threads unless parallel solving is disabled. Bodies that
+/// react to impulses (see dynamics::BodyNode::isReactive()) take part in the
+/// iterations through the velocity change of their skeleton due to a unit
+/// impulse at each contact, as computed for a constraint, and the resulting
+/// impulses are applied to them as constraint impulses. The particles are
+/// solved after the constraint::ConstraintSolver, and see the velocities of
+/// the skeletons that it computed.
+///
+/// Particles of different particle systems do not collide with each other.
+/// Planes, boxes, ellipsoids and cylinders are culled by their bounds, while
+/// every particle is tested against other shapes.
+///
+/// Removing a particle moves the last particle into its place, so particle
+/// indices are only stable while no particle is removed.
+class ParticleSystem
+{
+public:
+  /// \brief Constructor
+  explicit ParticleSystem(const std::string& _name = "particles");
+
+  /// \brief Destructor
+  virtual ~ParticleSystem();
+
+  /// \brief Create a copy of this particle system with the same particles and
+  /// settings, but without contacts
+  ParticleSystem* clone() const;
+
+  /// \brief Set the name
+  void setName(const std::string& _name);
+
+  /// \brief Get the name
+  const std::string& getName() const;
+
+  //--------------------------------------------------------------------------
+  // Particles
+  //--------------------------------------------------------------------------
+
+  /// \brief Add a particle of _radius and _mass at _position, at rest. Return
+  /// the index of the particle.
+  size_t addParticle(const Eigen::Vector3d& _position, double _radius,
+                     double _mass);
+
+  /// \brief Remove the particle _index by moving the last particle into its
+  /// place
+  void removeParticle(size_t _index);
+
+  /// \brief Remove all particles
+  void removeAllParticles();
+
+  /// \brief Get the number of particles
+  size_t getNumParticles() const;
+
+  /// \brief Get the radius of particle _index
+  double getRadius(size_t _index) const;
+
+  /// \brief Get the mass of particle _index
+  double getMass(size_t _index) const;
+
+  /// \brief Set the position of particle _index
+  void setPosition(size_t _index, const Eigen::Vector3d& _position);
+
+  /// \brief Get the position of particle _index
+  Eigen::Vector3d getPosition(size_t _index) const;
+
+  /// \brief Set the linear velocity of particle _index
+  void setVelocity(size_t _index, const Eigen::Vector3d& _velocity);
+
+  /// \brief Get the linear velocity of particle _index
+  Eigen::Vector3d getVelocity(size_t _index) const;
+
+  /// \brief Set the angular velocity of particle _index
+  void setAngularVelocity(size_t _index, const Eigen::Vector3d& _velocity);
+
+  /// \brief Get the angular velocity of particle _index
+  Eigen::Vector3d getAngularVelocity(size_t _index) const;
+
+  //--------------------------------------------------------------------------
+  // Properties
+  //--------------------------------------------------------------------------
+
+  /// \brief Set the coefficient of friction of the particles. Contacts with
+  /// bodies use the smaller coefficient of the two.
+  void setFrictionCoeff(double _coeff);
+
+  /// \brief Get the coefficient of friction of the particles
+  double getFrictionCoeff() const;
+
+  /// \brief Set the coefficient of restitution of the particles. Contacts
+  /// with bodies use the product of the coefficients of the two.
+  void setRestitutionCoeff(double _coeff);
+
+  /// \brief Get the coefficient of restitution of the particles
+  double getRestitutionCoeff() const;
+
+  /// \brief Set the number of iterations of the particle solver
+  void setNumIterations(size_t _numIterations);
+
+  /// \brief Get the number of iterations of the particle solver
+  size_t getNumIterations() const;
+
+  /// \brief Set whether the particle solver runs on OpenMP threads
+  void setParallel(bool _parallel);
+
+  /// \brief Return true if the particle solver runs on OpenMP threads
+  bool isParallel() const;
+
+  //--------------------------------------------------------------------------
+  // Simulation
+  //--------------------------------------------------------------------------
+
+  /// \brief Add the velocity change due to _gravity over _timeStep
+  void integrateVelocities(const Eigen::Vector3d& _gravity, double _timeStep);
+
+  /// \brief Find the contacts between the particles and between the
+  /// particles and the bodies of _skeletons. Return the number of contacts.
+  size_t detectContacts(const std::vector<dynamics::Skeleton*>& _skeletons);
+
+  /// \brief Solve the contacts found by the last call to detectContacts().
+  /// The impulses on reactive bodies are added to their constraint impulses,
+  /// and their skeletons are marked as having impulses applied.
+  void solveContacts(double _timeStep);
+
+  /// \brief Move the particles by their velocities over _timeStep
+  void integratePositions(double _timeStep);
+
+  /// \brief Get the number of contacts found by the last call to
+  /// detectContacts(), including the contacts with reactive bodies
+  size_t getNumContacts() const;
+
+  /// \brief Get the number of contacts with reactive bodies found by the last
+  /// call to detectContacts()
+  size_t getNumBodyContacts() const;
+
+protected:
+  /// \brief Sort the particles into the cells of the hash grid
+  void updateGrid();
+
+  /// \brief Get the hash grid cell of _point
+  Eigen::Vector3i getCell(const Eigen::Vector3d& _point) const;
+
+  /// \brief Get the bucket of the hash grid that holds _cell
+  size_t getBucket(const Eigen::Vector3i& _cell) const;
+
+  /// \brief Find the contacts between the particles
+  void detectParticleContacts();
+
+  /// \brief Find the contacts between the particles and _bodyNode
+  void detectBodyContacts(dynamics::BodyNode* _bodyNode);
+
+  /// \brief Add a contact of particle _particle with _bodyNode at _point. The
+  /// normal points from the body to the particle. A negative _depth is the
+  /// gap of a speculative contact.
+  void addBodyContact(size_t _particle, dynamics::BodyNode* _bodyNode,
+                      const Eigen::Vector3d& _point,
+                      const Eigen::Vector3d& _normal, double _depth);
+
+  /// \brief Add a contact between particles _particle1 and _particle2 (or a
+  /// body moving at _velocity2 if _particle2 is -1). The normal points from
+  /// the second particle (or the body) to the first.
+  void addContact(int _particle1, int _particle2,
+                  const Eigen::Vector3d& _normal, double _depth,
+                  const Eigen::Vector3d& _velocity2, double _frictionCoeff,
+                  double _restitutionCoeff);
+
+  /// \brief Apply _impulse to particle _index at _arm from its center
+  void applyImpulse(size_t _index, const Eigen::Vector3d& _impulse,
+                    const Eigen::Vector3d& _arm);
+
+  /// \brief Update the velocities of the reactive bodies at their contacts,
+  /// and their changes due to unit impulses at the contacts
+  void updateBodyResponses();
+
+  /// \brief Remove all contacts
+  void clearContacts();
+
+  /// \brief Name
+  std::string mName;
+
+  /// \brief Positions of the particles
+  std::vector<double> mPositionX, mPositionY, mPositionZ;
+
+  /// \brief Linear velocities of the particles
+  std::vector<double> mVelocityX, mVelocityY, mVelocityZ;
+
+  /// \brief Angular velocities of the particles
+  std::vector<double> mAngularVelocityX, mAngularVelocityY, mAngularVelocityZ;
+
+  /// \brief Radii of the particles
+  std::vector<double> mRadius;
+
+  /// \brief Inverse masses of the particles
+  std::vector<double> mInvMass;
+
+  /// \brief Inverse moments of inertia of the particles
+  std::vector<double> mInvInertia;
+
+  /// \brief Coefficient of friction
+  double mFrictionCoeff;
+
+  /// \brief Coefficient of restitution
+  double mRestitutionCoeff;
+
+  /// \brief Number of iterations of the particle solver
+  size_t mNumIterations;
+
+  /// \brief Whether the particle solver runs on OpenMP threads
+  bool mParallel;
+
+  /// \brief Width of the cells of the hash grid
+  double mCellSize;
+
+  /// \brief Bucket of the hash grid of each particle
+  std::vector<uint32_t> mParticleBuckets;
+
+  /// \brief First entry of mBucketParticles of each bucket, followed by the
+  /// number of particles
+  std::vector<uint32_t> mBucketStarts;
+
+  /// \brief Particles sorted by their buckets
+  std::vector<uint32_t> mBucketParticles;
+
+  /// \brief Contacts solved by the particle solver: first and second
+  /// particle, where the second is -1 for a body
+  std::vector<int> mContactParticle1, mContactParticle2;
+
+  /// \brief Contact normals, from the second particle to the first
+  std::vector<double> mContactNormalX, mContactNormalY, mContactNormalZ;
+
+  /// \brief Velocities of the bodies at the contacts with bodies
+  std::vector<double> mContactVelocityX, mContactVelocityY, mContactVelocityZ;
+
+  /// \brief Penetration depths, or the negative gaps of speculative contacts
+  std::vector<double> mContactDepth;
+
+  /// \brief Coefficients of friction and restitution of the contacts
+  std::vector<double> mContactFriction, mContactRestitution;
+
+  /// \brief Normal velocity that each contact has to reach
+  std::vector<double> mContactTargetVelocity;
+
+  /// \brief Effective masses of the contacts along the normal and along the
+  /// tangent plane
+  std::vector<double> mContactNormalMass, mContactTangentMass;
+
+  /// \brief Accumulated normal impulses of the contacts
+  std::vector<double> mContactNormalImpulse;
+
+  /// \brief Accumulated tangential impulses of the contacts
+  std::vector<double> mContactTangentImpulseX, mContactTangentImpulseY,
+                      mContactTangentImpulseZ;
+
+  /// \brief Impulses of the contacts in the current iteration
+  std::vector<double> mContactImpulseX, mContactImpulseY, mContactImpulseZ;
+
+  /// \brief Number of contacts of each particle in the particle solver
+  std::vector<double> mNumParticleContacts;
+
+  /// \brief Contacts with reactive bodies
+  std::vector<size_t> mBodyContacts;
+
+  /// \brief Bodies of the contacts with reactive bodies
+  std::vector<dynamics::BodyNode*> mBodyContactNodes;
+
+  /// \brief Points of the contacts with reactive bodies
+  std::vector<Eigen::Vector3d> mBodyContactPoints;
+
+  /// \brief Group of each contact with a reactive body
+  std::vector<size_t> mBodyContactGroups;
+
+  /// \brief Skeleton of each group of contacts with reactive bodies
+  std::vector<dynamics::Skeleton*> mGroupSkeletons;
+
+  /// \brief Contacts with reactive bodies of each group, as indices into
+  /// mBodyContacts
+  std::vector<std::vector<size_t> > mGroupContacts;
+
+  /// \brief Velocity changes of the contact points of each group due to unit
+  /// impulses on the particles at the contacts of the group
+  std::vector<Eigen::MatrixXd> mGroupResponses;
+
+  /// \brief Sphere used to collide the particles with the bodies
+  dynamics::EllipsoidShape* mSphere;
+};
+
+}  // namespace simulation
+}  // namespace dart
+
+#endif  // DART_SIMULATION_PARTICLESYSTEM_H_
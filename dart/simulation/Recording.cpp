@@ -131,6 +131,12 @@ Eigen::Vector3d Recording::getContactForce(int _frameIdx, int _contactIdx) const
   return mBakedStates[_frameIdx].segment(totalDofs + _contactIdx * 6 + 3, 3);
 }
 
+//==============================================================================
+const Eigen::VectorXd& Recording::getState(int _frameIdx) const
+{
+  return mBakedStates[_frameIdx];
+}
+
 //==============================================================================
 void Recording::clear() {
   mBakedStates.clear();
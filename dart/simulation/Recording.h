@@ -97,6 +97,11 @@ public:
   /// _frameIdx
   Eigen::Vector3d getContactForce(int _frameIdx, int _contactIdx) const;
 
+  /// \brief Get the whole state at frame number _frameIdx: the generalized
+  /// coordinates of all the skeletons followed by the point and the force of
+  /// each contact
+  const Eigen::VectorXd& getState(int _frameIdx) const;
+
   /// \brief Clear the saved histories
   void clear();  
 
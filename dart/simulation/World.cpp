@@ -42,7 +42,9 @@
 
 #include "dart/simulation/World.h"
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -50,6 +52,8 @@
 #include "dart/integration/SemiImplicitEulerIntegrator.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/constraint/ConstraintSolver.h"
+#include "dart/collision/CollisionDetector.h"
+#include "dart/simulation/ParticleSystem.h"
 
 namespace dart {
 namespace simulation {
@@ -57,6 +61,8 @@ namespace simulation {
 //==============================================================================
 World::World()
   : mNameMgrForSkeletons("skeleton"),
+    mIsIndicesDirty(false),
+    mIsRecordingDirty(false),
     mGravity(0.0, 0.0, -9.81),
     mTimeStep(0.001),
     mTime(0.0),
@@ -79,6 +85,16 @@ World::~World()
   {
     delete (*it);
   }
+
+  // Skeletons that were queued but never added are owned by the world as well
+  for (size_t i = 0; i < mSkeletonsToAdd.size(); ++i)
+  {
+    if (!hasSkeleton(mSkeletonsToAdd[i]))
+      delete mSkeletonsToAdd[i];
+  }
+
+  for (size_t i = 0; i < mParticleSystems.size(); ++i)
+    delete mParticleSystems[i];
 }
 
 //==============================================================================
@@ -92,7 +108,7 @@ void World::setTimeStep(double _timeStep)
   for (std::vector<dynamics::Skeleton*>::iterator it = mSkeletons.begin();
        it != mSkeletons.end(); ++it)
   {
-    (*it)->setTimeStep(_timeStep);
+    (*it)->setTimeStep(_timeStep / (*it)->getNumSubSteps());
   }
 }
 
@@ -112,24 +128,123 @@ void World::reset()
 
 //==============================================================================
 void World::step(bool _resetCommand)
+{
+  commitSkeletonChanges();
+
+  // The step is split into as many sub-steps as the mobile skeleton with the
+  // most sub-steps takes
+  size_t numSubSteps = 1;
+  std::set<size_t> rates;
+  for (auto& skel : mSkeletons)
+  {
+    const double timeStep = mTimeStep / skel->getNumSubSteps();
+    if (skel->getTimeStep() != timeStep)
+      skel->setTimeStep(timeStep);
+
+    if (skel->isMobile())
+    {
+      numSubSteps = std::max(numSubSteps, skel->getNumSubSteps());
+      rates.insert(skel->getNumSubSteps());
+    }
+  }
+
+  if (rates.empty())
+    rates.insert(1);
+
+  // Every skeleton steps in the first sub-step, which is the synchronization
+  // point: all of them are reactive and solved together, at the smallest time
+  // step, so that contacts between skeletons of different rates and with the
+  // particle systems exchange momentum. In the other sub-steps, the skeletons
+  // due to step are solved and integrated in groups of equal time step, from
+  // the slowest to the fastest, so that the constraint solver always uses the
+  // time step of the skeletons it integrates. The other skeletons are held
+  // still meanwhile, and act as obstacles moving at their last velocity.
+  mConstraintSolver->setTimeStep(mTimeStep / numSubSteps);
+  stepSkeletons(true);
+
+  for (size_t i = 1; i < numSubSteps; ++i)
+  {
+    for (const size_t rate : rates)
+    {
+      // A skeleton with n sub-steps steps in n of the sub-steps, spread
+      // evenly over the step
+      if ((i * rate) % numSubSteps >= rate)
+        continue;
+
+      bool isAnyHeld = false;
+      for (auto& skel : mSkeletons)
+      {
+        if (skel->isMobile() && skel->getNumSubSteps() != rate)
+        {
+          skel->setHeld(true);
+          isAnyHeld = true;
+        }
+      }
+
+      mConstraintSolver->setTimeStep(mTimeStep / rate);
+      stepSkeletons(false);
+
+      if (isAnyHeld)
+      {
+        for (auto& skel : mSkeletons)
+          skel->setHeld(false);
+      }
+    }
+  }
+
+  mConstraintSolver->setTimeStep(mTimeStep);
+
+  if (_resetCommand)
+  {
+    for (auto& skel : mSkeletons)
+    {
+      if (!skel->isMobile())
+        continue;
+
+      skel->resetForces();
+      skel->clearExternalForces();
+//    skel->clearConstraintImpulses();
+      skel->resetCommands();
+    }
+  }
+
+  mTime += mTimeStep;
+  mFrame++;
+}
+
+//==============================================================================
+void World::stepSkeletons(bool _stepParticles)
 {
   // Integrate velocity for unconstrained skeletons
   for (auto& skel : mSkeletons)
   {
-    if (!skel->isMobile())
+    if (!skel->isMobile() || skel->isHeld())
       continue;
 
     skel->computeForwardDynamicsRecursionPartB();
-    skel->integrateVelocities(mTimeStep);
+    skel->integrateVelocities(skel->getTimeStep());
   }
 
   // Detect activated constraints and compute constraint impulses
   mConstraintSolver->solve();
 
+  // Solve the particles, which add their impulses on the skeletons to the
+  // constraint impulses
+  if (_stepParticles)
+  {
+    for (auto& particles : mParticleSystems)
+    {
+      particles->integrateVelocities(mGravity, mTimeStep);
+      particles->detectContacts(mSkeletons);
+      particles->solveContacts(mTimeStep);
+      particles->integratePositions(mTimeStep);
+    }
+  }
+
   // Compute velocity changes given constraint impulses
   for (auto& skel : mSkeletons)
   {
-    if (!skel->isMobile())
+    if (!skel->isMobile() || skel->isHeld())
       continue;
 
     if (skel->isImpulseApplied())
@@ -138,19 +253,8 @@ void World::step(bool _resetCommand)
       skel->setImpulseApplied(false);
     }
 
-    skel->integratePositions(mTimeStep);
-
-    if (_resetCommand)
-    {
-      skel->resetForces();
-      skel->clearExternalForces();
-//    skel->clearConstraintImpulses();
-      skel->resetCommands();
-    }
+    skel->integratePositions(skel->getTimeStep());
   }
-
-  mTime += mTimeStep;
-  mFrame++;
 }
 
 //==============================================================================
@@ -171,6 +275,29 @@ int World::getSimFrames() const
   return mFrame;
 }
 
+//==============================================================================
+World* World::clone() const
+{
+  World* worldClone = new World();
+
+  worldClone->setGravity(mGravity);
+  worldClone->setTimeStep(mTimeStep);
+  worldClone->getConstraintSolver()->setCollisionDetector(
+        mConstraintSolver->getCollisionDetector()
+        ->cloneWithoutCollisionObjects());
+
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+    worldClone->addSkeleton(mSkeletons[i]->clone());
+
+  for (size_t i = 0; i < mParticleSystems.size(); ++i)
+    worldClone->addParticleSystem(mParticleSystems[i]->clone());
+
+  worldClone->mTime = mTime;
+  worldClone->mFrame = mFrame;
+
+  return worldClone;
+}
+
 //==============================================================================
 void World::setGravity(const Eigen::Vector3d& _gravity)
 {
@@ -203,6 +330,12 @@ dynamics::Skeleton* World::getSkeleton(const std::string& _name) const
   return mNameMgrForSkeletons.getObject(_name);
 }
 
+//==============================================================================
+dynamics::Skeleton* World::getSkeleton(const common::NameHandle& _name) const
+{
+  return mNameMgrForSkeletons.getObject(_name);
+}
+
 //==============================================================================
 size_t World::getNumSkeletons() const
 {
@@ -221,22 +354,23 @@ std::string World::addSkeleton(dynamics::Skeleton* _skeleton)
   }
 
   // If mSkeletons already has _skeleton, then we do nothing.
-  if (find(mSkeletons.begin(), mSkeletons.end(), _skeleton) != mSkeletons.end())
+  if (hasSkeleton(_skeleton))
   {
     std::cout << "Skeleton [" << _skeleton->getName()
               << "] is already in the world." << std::endl;
     return _skeleton->getName();
   }
 
+  mSkeletonIndices[_skeleton] = mSkeletons.size();
   mSkeletons.push_back(_skeleton);
   _skeleton->setName(mNameMgrForSkeletons.issueNewNameAndAdd(
                        _skeleton->getName(), _skeleton));
-  _skeleton->init(mTimeStep, mGravity);
-  mIndices.push_back(mIndices.back() + _skeleton->getNumDofs());
+  _skeleton->init(mTimeStep / _skeleton->getNumSubSteps(), mGravity);
   mConstraintSolver->addSkeleton(_skeleton);
 
-  // Update recording
-  mRecording->updateNumGenCoords(mSkeletons);
+  // mIndices and the recording are updated once they are needed
+  mIsIndicesDirty = true;
+  mIsRecordingDirty = true;
 
   return _skeleton->getName();
 }
@@ -246,44 +380,32 @@ void World::withdrawSkeleton(dynamics::Skeleton *_skeleton)
 {
   assert(_skeleton != NULL && "Attempted to remove NULL Skeleton from world");
 
-  // Find index of _skeleton in mSkeleton.
-  size_t i = 0;
-  for (; i < mSkeletons.size(); ++i)
-  {
-    if (mSkeletons[i] == _skeleton)
-      break;
-  }
-
-  // If i is equal to the number of skeletons, then _skeleton is not in
-  // mSkeleton. We do nothing.
-  if (i == mSkeletons.size())
+  // If _skeleton is not in mSkeletons, then we do nothing.
+  std::unordered_map<const dynamics::Skeleton*, size_t>::iterator it
+      = mSkeletonIndices.find(_skeleton);
+  if (it == mSkeletonIndices.end())
   {
     dtwarn << "Skeleton [" << _skeleton->getName()
            << "] is not in the world.\n";
     return;
   }
 
-  // Update mIndices.
-  for (++i; i < mSkeletons.size() - 1; ++i)
-    mIndices[i] = mIndices[i+1] - _skeleton->getNumDofs();
-  mIndices.pop_back();
-
   // Remove _skeleton from constraint handler.
   mConstraintSolver->removeSkeleton(_skeleton);
 
-  // Remove _skeleton in mSkeletons and delete it.
-  mSkeletons.erase(remove(mSkeletons.begin(), mSkeletons.end(), _skeleton),
-                   mSkeletons.end());
-  // TODO(MXG): This approach invalidates the indices of all Skeletons in the
-  // vector that came after the one that was deleted. Now if the user attempts
-  // to access those Skeletons by their previously assigned indices, it will not
-  // work correctly. This isn't really a problem since the user has the freedom
-  // to always access Skeletons by name, but it might be worth mentioning in
-  // documentation that the user cannot expect the index of a Skeleton to remain
-  // valid after a deletion has happened.
+  // Move the last skeleton into the place of _skeleton
+  size_t index = it->second;
+  mSkeletonIndices.erase(it);
+  if (index + 1 < mSkeletons.size())
+  {
+    mSkeletons[index] = mSkeletons.back();
+    mSkeletonIndices[mSkeletons[index]] = index;
+  }
+  mSkeletons.pop_back();
 
-  // Update recording
-  mRecording->updateNumGenCoords(mSkeletons);
+  // mIndices and the recording are updated once they are needed
+  mIsIndicesDirty = true;
+  mIsRecordingDirty = true;
 
   // Remove from NameManager
   mNameMgrForSkeletons.removeName(_skeleton->getName());
@@ -305,7 +427,7 @@ std::set<dynamics::Skeleton*> World::withdrawAllSkeletons()
     ptrs.insert(*it);
 
   while (getNumSkeletons() > 0)
-    withdrawSkeleton(getSkeleton(0));
+    withdrawSkeleton(mSkeletons.back());
 
   return ptrs;
 }
@@ -314,12 +436,127 @@ std::set<dynamics::Skeleton*> World::withdrawAllSkeletons()
 void World::removeAllSkeletons()
 {
   while (getNumSkeletons() > 0)
-    removeSkeleton(getSkeleton(0));
+    removeSkeleton(mSkeletons.back());
+}
+
+//==============================================================================
+void World::addParticleSystem(ParticleSystem* _particles)
+{
+  assert(_particles != NULL && "Attempted to add NULL particle system.");
+
+  if (std::find(mParticleSystems.begin(), mParticleSystems.end(), _particles)
+      != mParticleSystems.end())
+  {
+    dtwarn << "Particle system [" << _particles->getName()
+           << "] is already in the world." << std::endl;
+    return;
+  }
+
+  mParticleSystems.push_back(_particles);
+}
+
+//==============================================================================
+void World::removeParticleSystem(ParticleSystem* _particles)
+{
+  std::vector<ParticleSystem*>::iterator it
+      = std::find(mParticleSystems.begin(), mParticleSystems.end(),
+                  _particles);
+
+  if (it == mParticleSystems.end())
+  {
+    dtwarn << "Particle system [" << _particles->getName()
+           << "] is not in the world." << std::endl;
+    return;
+  }
+
+  mParticleSystems.erase(it);
+  delete _particles;
+}
+
+//==============================================================================
+size_t World::getNumParticleSystems() const
+{
+  return mParticleSystems.size();
+}
+
+//==============================================================================
+ParticleSystem* World::getParticleSystem(size_t _index) const
+{
+  assert(_index < mParticleSystems.size());
+  return mParticleSystems[_index];
+}
+
+//==============================================================================
+bool World::hasSkeleton(const dynamics::Skeleton* _skeleton) const
+{
+  return mSkeletonIndices.find(_skeleton) != mSkeletonIndices.end();
+}
+
+//==============================================================================
+void World::queueAddSkeleton(dynamics::Skeleton* _skeleton)
+{
+  assert(_skeleton != NULL && "Attempted to queue NULL skeleton.");
+
+  if (NULL == _skeleton)
+  {
+    dtwarn << "Attempting to queue a nullptr Skeleton to the world!\n";
+    return;
+  }
+
+  // The world deletes queued skeletons, so each one may be queued only once
+  if (std::find(mSkeletonsToAdd.begin(), mSkeletonsToAdd.end(), _skeleton)
+      != mSkeletonsToAdd.end())
+  {
+    dtwarn << "Skeleton [" << _skeleton->getName()
+           << "] is already queued to be added to the world." << std::endl;
+    return;
+  }
+
+  mSkeletonsToAdd.push_back(_skeleton);
+}
+
+//==============================================================================
+void World::queueRemoveSkeleton(dynamics::Skeleton* _skeleton)
+{
+  assert(_skeleton != NULL && "Attempted to queue NULL skeleton.");
+
+  if (NULL == _skeleton)
+  {
+    dtwarn << "Attempting to queue a nullptr Skeleton for removal!\n";
+    return;
+  }
+
+  mSkeletonsToRemove.push_back(_skeleton);
+}
+
+//==============================================================================
+void World::commitSkeletonChanges()
+{
+  if (mSkeletonsToAdd.empty() && mSkeletonsToRemove.empty())
+    return;
+
+  for (size_t i = 0; i < mSkeletonsToAdd.size(); ++i)
+    addSkeleton(mSkeletonsToAdd[i]);
+  mSkeletonsToAdd.clear();
+
+  for (size_t i = 0; i < mSkeletonsToRemove.size(); ++i)
+  {
+    // Only delete the skeletons that are owned by this world
+    if (hasSkeleton(mSkeletonsToRemove[i]))
+      removeSkeleton(mSkeletonsToRemove[i]);
+    else
+      dtwarn << "Skeleton [" << mSkeletonsToRemove[i]->getName()
+             << "] was queued for removal but is not in the world.\n";
+  }
+  mSkeletonsToRemove.clear();
 }
 
 //==============================================================================
 int World::getIndex(int _index) const
 {
+  if (mIsIndicesDirty)
+    updateIndices();
+
   return mIndices[_index];
 }
 
@@ -338,6 +575,12 @@ dynamics::Entity* World::getEntity(const std::string& _name) const
   return mNameMgrForEntities.getObject(_name);
 }
 
+//==============================================================================
+dynamics::Entity* World::getEntity(const common::NameHandle& _name) const
+{
+  return mNameMgrForEntities.getObject(_name);
+}
+
 //==============================================================================
 size_t World::getNumEntities() const
 {
@@ -449,14 +692,31 @@ void World::bake()
     state.segment(begin, 3)     = cd->getContact(i).point;
     state.segment(begin + 3, 3) = cd->getContact(i).force;
   }
-  mRecording->addState(state);
+  getRecording()->addState(state);
 }
 
 //==============================================================================
 Recording* World::getRecording()
 {
+  if (mIsRecordingDirty)
+  {
+    mRecording->updateNumGenCoords(mSkeletons);
+    mIsRecordingDirty = false;
+  }
+
   return mRecording;
 }
 
+//==============================================================================
+void World::updateIndices() const
+{
+  mIndices.resize(mSkeletons.size() + 1);
+  mIndices[0] = 0;
+  for (size_t i = 0; i < mSkeletons.size(); ++i)
+    mIndices[i + 1] = mIndices[i] + mSkeletons[i]->getNumDofs();
+
+  mIsIndicesDirty = false;
+}
+
 }  // namespace simulation
 }  // namespace dart
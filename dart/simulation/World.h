@@ -44,6 +44,7 @@
 #define DART_SIMULATION_WORLD_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <set>
 
@@ -72,6 +73,8 @@ class ConstraintSolver;
 
 namespace simulation {
 
+class ParticleSystem;
+
 /// class World
 class World : public virtual common::Subject
 {
@@ -86,6 +89,13 @@ public:
   /// Destructor
   virtual ~World();
 
+  /// Create a copy of this World with clones of all its Skeletons (see
+  /// Skeleton::clone()) and ParticleSystems, and a collision detector of the
+  /// same type. As with addSkeleton(), the joint forces of the copied
+  /// Skeletons are cleared. Entities and manually added constraints are not
+  /// copied.
+  World* clone() const;
+
   //--------------------------------------------------------------------------
   // Properties
   //--------------------------------------------------------------------------
@@ -106,7 +116,9 @@ public:
   // Structural Properties
   //--------------------------------------------------------------------------
 
-  /// Get the indexed skeleton
+  /// Get the indexed skeleton. Removing a skeleton moves the last skeleton
+  /// into its place, so keep the Skeleton pointer or its name rather than its
+  /// index to refer to a skeleton across removals.
   dynamics::Skeleton* getSkeleton(size_t _index) const;
 
   /// Find a Skeleton by name
@@ -114,6 +126,11 @@ public:
   /// \return If the skeleton does not exist then return NULL.
   dynamics::Skeleton* getSkeleton(const std::string& _name) const;
 
+  /// Find a Skeleton by name without any string work
+  /// \param[in] The handle to the name of the Skeleton you are looking for.
+  /// \return If the skeleton does not exist then return NULL.
+  dynamics::Skeleton* getSkeleton(const common::NameHandle& _name) const;
+
   /// Get the number of skeletons
   size_t getNumSkeletons() const;
 
@@ -132,6 +149,35 @@ public:
   /// Remove all the skeletons in this world and delete them
   void removeAllSkeletons();
 
+  /// Return true if _skeleton is in this world
+  bool hasSkeleton(const dynamics::Skeleton* _skeleton) const;
+
+  /// Add a skeleton to this world at the beginning of the next step(). The
+  /// world owns _skeleton from this call on.
+  void queueAddSkeleton(dynamics::Skeleton* _skeleton);
+
+  /// Remove a skeleton from this world and delete it at the beginning of the
+  /// next step()
+  void queueRemoveSkeleton(dynamics::Skeleton* _skeleton);
+
+  /// Apply the queued additions and then the queued removals of skeletons.
+  /// step() calls this, so it only needs to be called to see the changes
+  /// before the next step.
+  void commitSkeletonChanges();
+
+  /// Add a particle system to this world. The world owns _particles from this
+  /// call on.
+  void addParticleSystem(ParticleSystem* _particles);
+
+  /// Remove a particle system from this world and delete it
+  void removeParticleSystem(ParticleSystem* _particles);
+
+  /// Get the number of particle systems
+  size_t getNumParticleSystems() const;
+
+  /// Get the indexed particle system
+  ParticleSystem* getParticleSystem(size_t _index) const;
+
   /// Get the dof index for the indexed skeleton
   int getIndex(int _index) const;
 
@@ -141,6 +187,9 @@ public:
   /// Find an Entity by name
   dynamics::Entity* getEntity(const std::string& _name) const;
 
+  /// Find an Entity by name without any string work
+  dynamics::Entity* getEntity(const common::NameHandle& _name) const;
+
   /// Get the number of Entities
   size_t getNumEntities() const;
 
@@ -174,6 +223,19 @@ public:
   void reset();
 
   /// Calculate the dynamics and integrate the world for one step
+  ///
+  /// A skeleton with more than one sub-step (see
+  /// dynamics::Skeleton::setNumSubSteps()) takes that many steps of its own,
+  /// shorter time step, spread evenly over the sub-steps of the world, whose
+  /// number is the largest number of sub-steps of a mobile skeleton. All the
+  /// skeletons and the particle systems step together in the first sub-step,
+  /// where contacts between skeletons of different rates are solved with
+  /// every skeleton reactive, at the smallest time step. In the other
+  /// sub-steps, the skeletons due to step are solved in groups of equal time
+  /// step, from the slowest to the fastest, while the other skeletons are
+  /// held still (see dynamics::Skeleton::isHeld()): they do not react, but
+  /// their bodies keep their velocity in contacts. Pairs of bodies that all
+  /// stay still are not tested for collision.
   /// \param[in} _resetCommand True if you want to reset to zero the joint
   /// command after simulation step.
   void step(bool _resetCommand = true);
@@ -201,12 +263,32 @@ public:
   Recording* getRecording();
 
 protected:
+  /// Recompute mIndices from the current dofs of the skeletons
+  void updateIndices() const;
+
+  /// Integrate the mobile skeletons that are not held over their own time
+  /// steps, solving their constraints, and the particle systems if
+  /// _stepParticles is true
+  void stepSkeletons(bool _stepParticles);
+
   /// Skeletones in this world
   std::vector<dynamics::Skeleton*> mSkeletons;
 
+  /// Index of each Skeleton in mSkeletons
+  std::unordered_map<const dynamics::Skeleton*, size_t> mSkeletonIndices;
+
+  /// Skeletons waiting to be added by commitSkeletonChanges()
+  std::vector<dynamics::Skeleton*> mSkeletonsToAdd;
+
+  /// Skeletons waiting to be removed by commitSkeletonChanges()
+  std::vector<dynamics::Skeleton*> mSkeletonsToRemove;
+
   /// NameManager for keeping track of Skeletons
   dart::common::NameManager<dynamics::Skeleton> mNameMgrForSkeletons;
 
+  /// Particle systems in this world
+  std::vector<ParticleSystem*> mParticleSystems;
+
   /// Entities in this world
   std::vector<dynamics::Entity*> mEntities;
 
@@ -216,8 +298,14 @@ protected:
   /// The first indeices of each skeleton's dof in mDofs
   ///
   /// For example, if this world has three skeletons and their dof are
-  /// 6, 1 and 2 then the mIndices goes like this: [0 6 7].
-  std::vector<int> mIndices;
+  /// 6, 1 and 2 then the mIndices goes like this: [0 6 7 9].
+  mutable std::vector<int> mIndices;
+
+  /// True if mIndices needs to be recomputed
+  mutable bool mIsIndicesDirty;
+
+  /// True if the dofs of mRecording need to be updated
+  bool mIsRecordingDirty;
 
   /// Gravity
   Eigen::Vector3d mGravity;
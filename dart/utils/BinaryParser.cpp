@@ -0,0 +1,1267 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/BinaryParser.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dart/common/Console.h"
+#include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/collision/fcl/FCLCollisionDetector.h"
+#include "dart/collision/fcl_mesh/FCLMeshCollisionDetector.h"
+#ifdef HAVE_BULLET_COLLISION
+  #include "dart/collision/bullet/BulletCollisionDetector.h"
+#endif
+#include "dart/constraint/ConstraintSolver.h"
+#include "dart/dynamics/BallJoint.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/EulerJoint.h"
+#include "dart/dynamics/FreeJoint.h"
+#include "dart/dynamics/HeightmapShape.h"
+#include "dart/dynamics/LineSegmentShape.h"
+#include "dart/dynamics/Marker.h"
+#include "dart/dynamics/MeshCache.h"
+#include "dart/dynamics/MeshShape.h"
+#include "dart/dynamics/PlanarJoint.h"
+#include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/PointMass.h"
+#include "dart/dynamics/PrismaticJoint.h"
+#include "dart/dynamics/RevoluteJoint.h"
+#include "dart/dynamics/ScrewJoint.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/SoftBodyNode.h"
+#include "dart/dynamics/SoftMeshShape.h"
+#include "dart/dynamics/TranslationalJoint.h"
+#include "dart/dynamics/UniversalJoint.h"
+#include "dart/dynamics/WeldJoint.h"
+#include "dart/simulation/World.h"
+
+namespace dart {
+namespace utils {
+
+namespace {
+
+const char BINARY_MAGIC[8] = {'D', 'A', 'R', 'T', 'B', 'I', 'N', '\0'};
+const uint32_t BINARY_VERSION = 2;
+const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+enum ContentType
+{
+  CONTENT_WORLD,
+  CONTENT_SKELETON
+};
+
+enum CollisionDetectorType
+{
+  DETECTOR_FCL_MESH,
+  DETECTOR_FCL,
+  DETECTOR_DART,
+  DETECTOR_BULLET
+};
+
+enum JointType
+{
+  JOINT_WELD,
+  JOINT_REVOLUTE,
+  JOINT_PRISMATIC,
+  JOINT_SCREW,
+  JOINT_UNIVERSAL,
+  JOINT_BALL,
+  JOINT_EULER,
+  JOINT_TRANSLATIONAL,
+  JOINT_PLANAR,
+  JOINT_FREE
+};
+
+//==============================================================================
+/// Sequential writer of plain values
+class BinaryWriter
+{
+public:
+  explicit BinaryWriter(const std::string& _filename)
+    : mOut(_filename.c_str(), std::ios::binary)
+  {
+  }
+
+  bool isGood() const
+  {
+    return mOut.good();
+  }
+
+  template <typename T>
+  void write(const T& _value)
+  {
+    mOut.write(reinterpret_cast<const char*>(&_value), sizeof(T));
+  }
+
+  void writeBool(bool _value)
+  {
+    write<uint8_t>(_value ? 1 : 0);
+  }
+
+  void writeSize(size_t _value)
+  {
+    write<uint32_t>(static_cast<uint32_t>(_value));
+  }
+
+  void writeString(const std::string& _value)
+  {
+    writeSize(_value.size());
+    mOut.write(_value.data(), _value.size());
+  }
+
+  template <int Rows, int Cols>
+  void writeMatrix(const Eigen::Matrix<double, Rows, Cols>& _value)
+  {
+    mOut.write(reinterpret_cast<const char*>(_value.data()),
+               Rows * Cols * sizeof(double));
+  }
+
+  void writeIsometry(const Eigen::Isometry3d& _value)
+  {
+    writeMatrix(_value.matrix());
+  }
+
+private:
+  std::ofstream mOut;
+};
+
+//==============================================================================
+/// Sequential reader of plain values from a memory block. Reading past the
+/// end of the block marks the reader as failed and returns default values.
+class BinaryReader
+{
+public:
+  BinaryReader(const char* _data, size_t _size)
+    : mData(_data), mSize(_size), mOffset(0), mGood(true)
+  {
+  }
+
+  bool isGood() const
+  {
+    return mGood;
+  }
+
+  void fail()
+  {
+    mGood = false;
+  }
+
+  template <typename T>
+  T read()
+  {
+    T value = T();
+    const char* data = take(sizeof(T));
+    if (data)
+      std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  bool readBool()
+  {
+    return read<uint8_t>() != 0;
+  }
+
+  size_t readSize()
+  {
+    return read<uint32_t>();
+  }
+
+  std::string readString()
+  {
+    size_t size = readSize();
+    const char* data = take(size);
+    return data ? std::string(data, size) : std::string();
+  }
+
+  template <int Rows, int Cols>
+  Eigen::Matrix<double, Rows, Cols> readMatrix()
+  {
+    Eigen::Matrix<double, Rows, Cols> value
+        = Eigen::Matrix<double, Rows, Cols>::Zero();
+    const char* data = take(Rows * Cols * sizeof(double));
+    if (data)
+      std::memcpy(value.data(), data, Rows * Cols * sizeof(double));
+    return value;
+  }
+
+  Eigen::Vector3d readVector3d()
+  {
+    return readMatrix<3, 1>();
+  }
+
+  Eigen::Isometry3d readIsometry()
+  {
+    Eigen::Isometry3d value;
+    value.matrix() = readMatrix<4, 4>();
+    return value;
+  }
+
+private:
+  const char* take(size_t _size)
+  {
+    if (!mGood || _size > mSize - mOffset)
+    {
+      mGood = false;
+      return nullptr;
+    }
+
+    const char* data = mData + mOffset;
+    mOffset += _size;
+    return data;
+  }
+
+  const char* mData;
+  size_t mSize;
+  size_t mOffset;
+  bool mGood;
+};
+
+//==============================================================================
+/// Read-only view of a whole file. The file is memory mapped where possible
+/// and read into a buffer otherwise.
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& _filename)
+    : mData(nullptr), mSize(0), mIsMapped(false)
+  {
+#ifndef _WIN32
+    int fd = open(_filename.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      struct stat status;
+      if (fstat(fd, &status) == 0 && status.st_size > 0)
+      {
+        void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+                          fd, 0);
+        if (data != MAP_FAILED)
+        {
+          mData = static_cast<const char*>(data);
+          mSize = status.st_size;
+          mIsMapped = true;
+        }
+      }
+      close(fd);
+    }
+    if (mIsMapped)
+      return;
+#endif
+
+    std::ifstream in(_filename.c_str(), std::ios::binary | std::ios::ate);
+    if (!in)
+      return;
+
+    mBuffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!mBuffer.empty() && in.read(&mBuffer[0], mBuffer.size()))
+    {
+      mData = &mBuffer[0];
+      mSize = mBuffer.size();
+    }
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    if (mIsMapped)
+      munmap(const_cast<char*>(mData), mSize);
+#endif
+  }
+
+  const char* getData() const
+  {
+    return mData;
+  }
+
+  size_t getSize() const
+  {
+    return mSize;
+  }
+
+private:
+  const char* mData;
+  size_t mSize;
+  bool mIsMapped;
+  std::vector<char> mBuffer;
+};
+
+//==============================================================================
+void writeHeader(BinaryWriter& _out, ContentType _content)
+{
+  for (size_t i = 0; i < 8; ++i)
+    _out.write(BINARY_MAGIC[i]);
+  _out.write<uint32_t>(BINARY_VERSION);
+  _out.write<uint32_t>(BINARY_BYTE_ORDER);
+  _out.write<uint32_t>(_content);
+}
+
+//==============================================================================
+bool readHeader(BinaryReader& _in, ContentType _content,
+                const std::string& _filename)
+{
+  char magic[8];
+  for (size_t i = 0; i < 8; ++i)
+    magic[i] = _in.read<char>();
+  uint32_t version = _in.read<uint32_t>();
+  uint32_t byteOrder = _in.read<uint32_t>();
+  uint32_t content = _in.read<uint32_t>();
+
+  if (!_in.isGood() || std::memcmp(magic, BINARY_MAGIC, 8) != 0)
+  {
+    dterr << "[BinaryParser] '" << _filename << "' is not a binary DART "
+          << "file.\n";
+    return false;
+  }
+
+  if (version != BINARY_VERSION || byteOrder != BINARY_BYTE_ORDER)
+  {
+    dterr << "[BinaryParser] '" << _filename << "' was written by another "
+          << "version of DART or on a machine of different byte order.\n";
+    return false;
+  }
+
+  if (content != static_cast<uint32_t>(_content))
+  {
+    dterr << "[BinaryParser] '" << _filename << "' does not contain a "
+          << (_content == CONTENT_WORLD ? "World" : "Skeleton") << ".\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool writeJoint(BinaryWriter& _out, dynamics::Joint* _joint)
+{
+  using namespace dynamics;
+
+  if (dynamic_cast<WeldJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_WELD);
+  }
+  else if (RevoluteJoint* revolute = dynamic_cast<RevoluteJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_REVOLUTE);
+    _out.writeMatrix(revolute->getAxis());
+  }
+  else if (PrismaticJoint* prismatic = dynamic_cast<PrismaticJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_PRISMATIC);
+    _out.writeMatrix(prismatic->getAxis());
+  }
+  else if (ScrewJoint* screw = dynamic_cast<ScrewJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_SCREW);
+    _out.writeMatrix(screw->getAxis());
+    _out.write<double>(screw->getPitch());
+  }
+  else if (UniversalJoint* universal = dynamic_cast<UniversalJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_UNIVERSAL);
+    _out.writeMatrix(universal->getAxis1());
+    _out.writeMatrix(universal->getAxis2());
+  }
+  else if (dynamic_cast<BallJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_BALL);
+  }
+  else if (EulerJoint* euler = dynamic_cast<EulerJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_EULER);
+    _out.write<int32_t>(euler->getAxisOrder());
+  }
+  else if (dynamic_cast<TranslationalJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_TRANSLATIONAL);
+  }
+  else if (PlanarJoint* planar = dynamic_cast<PlanarJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_PLANAR);
+    _out.write<int32_t>(planar->getPlaneType());
+    _out.writeMatrix(planar->getTranslationalAxis1());
+    _out.writeMatrix(planar->getTranslationalAxis2());
+  }
+  else if (dynamic_cast<FreeJoint*>(_joint))
+  {
+    _out.write<uint32_t>(JOINT_FREE);
+  }
+  else
+  {
+    dterr << "[BinaryParser::writeJoint] Unsupported type of Joint ["
+          << _joint->getName() << "].\n";
+    return false;
+  }
+
+  _out.writeString(_joint->getName());
+  _out.writeIsometry(_joint->getTransformFromParentBodyNode());
+  _out.writeIsometry(_joint->getTransformFromChildBodyNode());
+  _out.write<int32_t>(_joint->getActuatorType());
+  _out.writeBool(_joint->isPositionLimited());
+
+  _out.writeSize(_joint->getNumDofs());
+  for (size_t i = 0; i < _joint->getNumDofs(); ++i)
+  {
+    const DegreeOfFreedom* dof = _joint->getDof(i);
+    _out.writeString(dof->getName());
+    _out.writeBool(dof->isNamePreserved());
+
+    _out.write<double>(_joint->getPosition(i));
+    _out.write<double>(_joint->getVelocity(i));
+    _out.write<double>(_joint->getPositionLowerLimit(i));
+    _out.write<double>(_joint->getPositionUpperLimit(i));
+    _out.write<double>(_joint->getVelocityLowerLimit(i));
+    _out.write<double>(_joint->getVelocityUpperLimit(i));
+    _out.write<double>(_joint->getAccelerationLowerLimit(i));
+    _out.write<double>(_joint->getAccelerationUpperLimit(i));
+    _out.write<double>(_joint->getForceLowerLimit(i));
+    _out.write<double>(_joint->getForceUpperLimit(i));
+    _out.write<double>(_joint->getSpringStiffness(i));
+    _out.write<double>(_joint->getRestPosition(i));
+    _out.write<double>(_joint->getDampingCoefficient(i));
+    _out.write<double>(_joint->getCoulombFriction(i));
+  }
+
+  return true;
+}
+
+//==============================================================================
+dynamics::Joint* readJoint(BinaryReader& _in)
+{
+  using namespace dynamics;
+
+  Joint* joint = nullptr;
+  uint32_t type = _in.read<uint32_t>();
+  switch (type)
+  {
+    case JOINT_WELD:
+      joint = new WeldJoint;
+      break;
+    case JOINT_REVOLUTE:
+      joint = new RevoluteJoint(_in.readVector3d());
+      break;
+    case JOINT_PRISMATIC:
+      joint = new PrismaticJoint(_in.readVector3d());
+      break;
+    case JOINT_SCREW:
+    {
+      Eigen::Vector3d axis = _in.readVector3d();
+      double pitch = _in.read<double>();
+      joint = new ScrewJoint(axis, pitch);
+      break;
+    }
+    case JOINT_UNIVERSAL:
+    {
+      UniversalJoint* universal = new UniversalJoint;
+      universal->setAxis1(_in.readVector3d());
+      universal->setAxis2(_in.readVector3d());
+      joint = universal;
+      break;
+    }
+    case JOINT_BALL:
+      joint = new BallJoint;
+      break;
+    case JOINT_EULER:
+    {
+      EulerJoint* euler = new EulerJoint;
+      euler->setAxisOrder(
+            static_cast<EulerJoint::AxisOrder>(_in.read<int32_t>()));
+      joint = euler;
+      break;
+    }
+    case JOINT_TRANSLATIONAL:
+      joint = new TranslationalJoint;
+      break;
+    case JOINT_PLANAR:
+    {
+      PlanarJoint* planar = new PlanarJoint;
+      int32_t planeType = _in.read<int32_t>();
+      Eigen::Vector3d transAxis1 = _in.readVector3d();
+      Eigen::Vector3d transAxis2 = _in.readVector3d();
+      if (PlanarJoint::PT_XY == planeType)
+        planar->setXYPlane();
+      else if (PlanarJoint::PT_YZ == planeType)
+        planar->setYZPlane();
+      else if (PlanarJoint::PT_ZX == planeType)
+        planar->setZXPlane();
+      else
+        planar->setArbitraryPlane(transAxis1, transAxis2);
+      joint = planar;
+      break;
+    }
+    case JOINT_FREE:
+      joint = new FreeJoint;
+      break;
+    default:
+      _in.fail();
+      return nullptr;
+  }
+
+  joint->setName(_in.readString());
+  joint->setTransformFromParentBodyNode(_in.readIsometry());
+  joint->setTransformFromChildBodyNode(_in.readIsometry());
+  joint->setActuatorType(
+        static_cast<Joint::ActuatorType>(_in.read<int32_t>()));
+  joint->setPositionLimited(_in.readBool());
+
+  size_t numDofs = _in.readSize();
+  if (numDofs != joint->getNumDofs())
+  {
+    _in.fail();
+    delete joint;
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < numDofs; ++i)
+  {
+    std::string name = _in.readString();
+    bool isNamePreserved = _in.readBool();
+    joint->getDof(i)->setName(name, isNamePreserved);
+
+    joint->setPosition(i, _in.read<double>());
+    joint->setVelocity(i, _in.read<double>());
+    joint->setPositionLowerLimit(i, _in.read<double>());
+    joint->setPositionUpperLimit(i, _in.read<double>());
+    joint->setVelocityLowerLimit(i, _in.read<double>());
+    joint->setVelocityUpperLimit(i, _in.read<double>());
+    joint->setAccelerationLowerLimit(i, _in.read<double>());
+    joint->setAccelerationUpperLimit(i, _in.read<double>());
+    joint->setForceLowerLimit(i, _in.read<double>());
+    joint->setForceUpperLimit(i, _in.read<double>());
+    joint->setSpringStiffness(i, _in.read<double>());
+    joint->setRestPosition(i, _in.read<double>());
+    joint->setDampingCoefficient(i, _in.read<double>());
+    joint->setCoulombFriction(i, _in.read<double>());
+  }
+
+  return joint;
+}
+
+//==============================================================================
+void writeShape(BinaryWriter& _out, const dynamics::Shape* _shape)
+{
+  using namespace dynamics;
+
+  _out.write<int32_t>(_shape->getShapeType());
+  _out.writeIsometry(_shape->getLocalTransform());
+  _out.writeMatrix(_shape->getRGBA());
+
+  switch (_shape->getShapeType())
+  {
+    case Shape::BOX:
+      _out.writeMatrix(static_cast<const BoxShape*>(_shape)->getSize());
+      break;
+    case Shape::ELLIPSOID:
+      _out.writeMatrix(static_cast<const EllipsoidShape*>(_shape)->getSize());
+      break;
+    case Shape::CYLINDER:
+    {
+      const CylinderShape* cylinder = static_cast<const CylinderShape*>(_shape);
+      _out.write<double>(cylinder->getRadius());
+      _out.write<double>(cylinder->getHeight());
+      break;
+    }
+    case Shape::PLANE:
+    {
+      const PlaneShape* plane = static_cast<const PlaneShape*>(_shape);
+      _out.writeMatrix(plane->getNormal());
+      _out.write<double>(plane->getOffset());
+      break;
+    }
+    case Shape::MESH:
+    {
+      const MeshShape* mesh = static_cast<const MeshShape*>(_shape);
+      _out.writeMatrix(mesh->getScale());
+      _out.writeString(mesh->getMeshPath());
+      break;
+    }
+    case Shape::SOFT_MESH:
+      // Soft meshes are rebuilt from the PointMasses of their SoftBodyNode
+      break;
+    case Shape::LINE_SEGMENT:
+    {
+      const LineSegmentShape* lines
+          = static_cast<const LineSegmentShape*>(_shape);
+      _out.write<float>(lines->getThickness());
+      const std::vector<Eigen::Vector3d>& vertices = lines->getVertices();
+      _out.writeSize(vertices.size());
+      for (size_t i = 0; i < vertices.size(); ++i)
+        _out.writeMatrix(vertices[i]);
+      const std::vector<Eigen::Vector2i>& connections
+          = lines->getConnections();
+      _out.writeSize(connections.size());
+      for (size_t i = 0; i < connections.size(); ++i)
+      {
+        _out.write<int32_t>(connections[i][0]);
+        _out.write<int32_t>(connections[i][1]);
+      }
+      break;
+    }
+    case Shape::HEIGHTMAP:
+    {
+      const HeightmapShape* heightmap
+          = static_cast<const HeightmapShape*>(_shape);
+      _out.writeSize(heightmap->getNumRows());
+      _out.writeSize(heightmap->getNumCols());
+      _out.writeMatrix(heightmap->getScale());
+      const float* heights = heightmap->getHeights();
+      size_t numHeights = heightmap->getNumRows() * heightmap->getNumCols();
+      for (size_t i = 0; i < numHeights; ++i)
+        _out.write<float>(heights[i]);
+      break;
+    }
+  }
+}
+
+//==============================================================================
+dynamics::Shape* readShape(BinaryReader& _in, dynamics::BodyNode* _bodyNode)
+{
+  using namespace dynamics;
+
+  int32_t type = _in.read<int32_t>();
+  Eigen::Isometry3d transform = _in.readIsometry();
+  Eigen::Vector4d color = _in.readMatrix<4, 1>();
+
+  Shape* shape = nullptr;
+  switch (type)
+  {
+    case Shape::BOX:
+      shape = new BoxShape(_in.readVector3d());
+      break;
+    case Shape::ELLIPSOID:
+      shape = new EllipsoidShape(_in.readVector3d());
+      break;
+    case Shape::CYLINDER:
+    {
+      double radius = _in.read<double>();
+      double height = _in.read<double>();
+      shape = new CylinderShape(radius, height);
+      break;
+    }
+    case Shape::PLANE:
+    {
+      Eigen::Vector3d normal = _in.readVector3d();
+      double offset = _in.read<double>();
+      shape = new PlaneShape(normal, offset);
+      break;
+    }
+    case Shape::MESH:
+    {
+      Eigen::Vector3d scale = _in.readVector3d();
+      std::string path = _in.readString();
+      std::shared_ptr<const aiScene> mesh = MeshCache::load(path);
+      if (!mesh)
+      {
+        dterr << "[BinaryParser::readShape] Fail to load model[" << path
+              << "].\n";
+        return nullptr;
+      }
+      shape = new MeshShape(scale, mesh, path);
+      break;
+    }
+    case Shape::SOFT_MESH:
+    {
+      SoftBodyNode* softBodyNode = dynamic_cast<SoftBodyNode*>(_bodyNode);
+      if (!softBodyNode)
+      {
+        _in.fail();
+        return nullptr;
+      }
+      shape = new SoftMeshShape(softBodyNode);
+      break;
+    }
+    case Shape::LINE_SEGMENT:
+    {
+      LineSegmentShape* lines = new LineSegmentShape(_in.read<float>());
+      size_t numVertices = _in.readSize();
+      for (size_t i = 0; i < numVertices && _in.isGood(); ++i)
+        lines->addVertex(_in.readVector3d());
+
+      // addVertex() connects each vertex to the previous one, so replace
+      // those connections with the stored ones
+      while (!lines->getConnections().empty())
+        lines->removeConnection(lines->getConnections().size() - 1);
+      size_t numConnections = _in.readSize();
+      for (size_t i = 0; i < numConnections && _in.isGood(); ++i)
+      {
+        int32_t idx1 = _in.read<int32_t>();
+        int32_t idx2 = _in.read<int32_t>();
+
+        // A connection to a missing vertex would be dereferenced when the
+        // shape is drawn or collided
+        const int32_t numStored
+            = static_cast<int32_t>(lines->getVertices().size());
+        if (idx1 < 0 || idx1 >= numStored || idx2 < 0 || idx2 >= numStored)
+        {
+          delete lines;
+          _in.fail();
+          return nullptr;
+        }
+
+        lines->addConnection(idx1, idx2);
+      }
+      shape = lines;
+      break;
+    }
+    case Shape::HEIGHTMAP:
+    {
+      size_t numRows = _in.readSize();
+      size_t numCols = _in.readSize();
+      Eigen::Vector3d scale = _in.readVector3d();
+      std::vector<float> heights;
+      for (size_t i = 0; i < numRows * numCols && _in.isGood(); ++i)
+        heights.push_back(_in.read<float>());
+      if (!_in.isGood() || numRows < 2 || numCols < 2)
+      {
+        _in.fail();
+        return nullptr;
+      }
+      shape = new HeightmapShape(numRows, numCols, heights, scale);
+      break;
+    }
+    default:
+      _in.fail();
+      return nullptr;
+  }
+
+  shape->setLocalTransform(transform);
+  shape->setRGBA(color);
+  return shape;
+}
+
+//==============================================================================
+bool writeBodyNode(BinaryWriter& _out, dynamics::BodyNode* _bodyNode,
+                   int _parentIndex)
+{
+  using namespace dynamics;
+
+  SoftBodyNode* softBodyNode = dynamic_cast<SoftBodyNode*>(_bodyNode);
+  _out.writeBool(softBodyNode != nullptr);
+  _out.write<int32_t>(_parentIndex);
+
+  if (!writeJoint(_out, _bodyNode->getParentJoint()))
+    return false;
+
+  _out.writeString(_bodyNode->getName());
+  _out.writeBool(_bodyNode->getGravityMode());
+  _out.writeBool(_bodyNode->isCollidable());
+  _out.write<uint32_t>(_bodyNode->getCollisionCategory());
+  _out.write<uint32_t>(_bodyNode->getCollisionMask());
+  _out.write<double>(_bodyNode->getMass());
+  _out.writeMatrix(_bodyNode->getLocalCOM());
+  double Ixx, Iyy, Izz, Ixy, Ixz, Iyz;
+  _bodyNode->getMomentOfInertia(Ixx, Iyy, Izz, Ixy, Ixz, Iyz);
+  _out.write<double>(Ixx);
+  _out.write<double>(Iyy);
+  _out.write<double>(Izz);
+  _out.write<double>(Ixy);
+  _out.write<double>(Ixz);
+  _out.write<double>(Iyz);
+  _out.write<double>(_bodyNode->getFrictionCoeff());
+  _out.write<double>(_bodyNode->getRestitutionCoeff());
+
+  if (softBodyNode)
+  {
+    _out.write<double>(softBodyNode->getVertexSpringStiffness());
+    _out.write<double>(softBodyNode->getEdgeSpringStiffness());
+    _out.write<double>(softBodyNode->getDampingCoefficient());
+
+    std::map<const PointMass*, size_t> indices;
+    size_t numPointMasses = softBodyNode->getNumPointMasses();
+    _out.writeSize(numPointMasses);
+    for (size_t i = 0; i < numPointMasses; ++i)
+    {
+      const PointMass* pointMass = softBodyNode->getPointMass(i);
+      indices[pointMass] = i;
+      _out.write<double>(pointMass->getMass());
+      _out.writeMatrix(pointMass->getRestingPosition());
+      _out.writeMatrix(pointMass->getPositions());
+      _out.writeMatrix(pointMass->getVelocities());
+    }
+
+    for (size_t i = 0; i < numPointMasses; ++i)
+    {
+      const PointMass* pointMass = softBodyNode->getPointMass(i);
+      _out.writeSize(pointMass->getNumConnectedPointMasses());
+      for (int j = 0; j < pointMass->getNumConnectedPointMasses(); ++j)
+        _out.writeSize(indices[pointMass->getConnectedPointMass(j)]);
+    }
+
+    _out.writeSize(softBodyNode->getNumFaces());
+    for (size_t i = 0; i < softBodyNode->getNumFaces(); ++i)
+    {
+      const Eigen::Vector3i& face = softBodyNode->getFace(i);
+      for (size_t j = 0; j < 3; ++j)
+        _out.write<int32_t>(face[j]);
+    }
+  }
+
+  // Shapes that are used for both visualization and collision are stored
+  // once
+  std::vector<Shape*> shapes;
+  std::vector<size_t> vizIndices;
+  std::vector<size_t> colIndices;
+  std::map<Shape*, size_t> shapeIndices;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    bool isViz = (0 == i);
+    size_t numShapes = isViz ? _bodyNode->getNumVisualizationShapes()
+                             : _bodyNode->getNumCollisionShapes();
+    for (size_t j = 0; j < numShapes; ++j)
+    {
+      Shape* shape = isViz ? _bodyNode->getVisualizationShape(j)
+                           : _bodyNode->getCollisionShape(j);
+
+      MeshShape* mesh = dynamic_cast<MeshShape*>(shape);
+      if (mesh && mesh->getMeshPath().empty())
+      {
+        dtwarn << "[BinaryParser::writeBodyNode] A MeshShape of BodyNode ["
+               << _bodyNode->getName() << "] was not loaded from a file and "
+               << "will be skipped.\n";
+        continue;
+      }
+
+      std::map<Shape*, size_t>::iterator it = shapeIndices.find(shape);
+      if (it == shapeIndices.end())
+      {
+        it = shapeIndices.insert(std::make_pair(shape, shapes.size())).first;
+        shapes.push_back(shape);
+      }
+      (isViz ? vizIndices : colIndices).push_back(it->second);
+    }
+  }
+
+  _out.writeSize(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i)
+    writeShape(_out, shapes[i]);
+  _out.writeSize(vizIndices.size());
+  for (size_t i = 0; i < vizIndices.size(); ++i)
+    _out.writeSize(vizIndices[i]);
+  _out.writeSize(colIndices.size());
+  for (size_t i = 0; i < colIndices.size(); ++i)
+    _out.writeSize(colIndices[i]);
+
+  _out.writeSize(_bodyNode->getNumMarkers());
+  for (size_t i = 0; i < _bodyNode->getNumMarkers(); ++i)
+  {
+    const Marker* marker = _bodyNode->getMarker(i);
+    _out.writeString(marker->getName());
+    _out.writeMatrix(marker->getLocalPosition());
+    _out.write<int32_t>(marker->getConstraintType());
+  }
+
+  return true;
+}
+
+//==============================================================================
+dynamics::BodyNode* readBodyNode(BinaryReader& _in, int& _parentIndex)
+{
+  using namespace dynamics;
+
+  bool isSoft = _in.readBool();
+  _parentIndex = _in.read<int32_t>();
+
+  Joint* joint = readJoint(_in);
+  if (!joint)
+    return nullptr;
+
+  SoftBodyNode* softBodyNode = isSoft ? new SoftBodyNode : nullptr;
+  BodyNode* bodyNode = isSoft ? softBodyNode : new BodyNode;
+  bodyNode->setParentJoint(joint);
+
+  bodyNode->setName(_in.readString());
+  bodyNode->setGravityMode(_in.readBool());
+  bodyNode->setCollidable(_in.readBool());
+  bodyNode->setCollisionCategory(_in.read<uint32_t>());
+  bodyNode->setCollisionMask(_in.read<uint32_t>());
+  bodyNode->setMass(_in.read<double>());
+  bodyNode->setLocalCOM(_in.readVector3d());
+  double I[6];
+  for (size_t i = 0; i < 6; ++i)
+    I[i] = _in.read<double>();
+  bodyNode->setMomentOfInertia(I[0], I[1], I[2], I[3], I[4], I[5]);
+  bodyNode->setFrictionCoeff(_in.read<double>());
+  bodyNode->setRestitutionCoeff(_in.read<double>());
+
+  if (softBodyNode)
+  {
+    softBodyNode->setVertexSpringStiffness(_in.read<double>());
+    softBodyNode->setEdgeSpringStiffness(_in.read<double>());
+    softBodyNode->setDampingCoefficient(_in.read<double>());
+
+    size_t numPointMasses = _in.readSize();
+    for (size_t i = 0; i < numPointMasses && _in.isGood(); ++i)
+    {
+      PointMass* pointMass = new PointMass(softBodyNode);
+      pointMass->setMass(_in.read<double>());
+      pointMass->setRestingPosition(_in.readVector3d());
+      pointMass->setPositions(_in.readVector3d());
+      pointMass->setVelocities(_in.readVector3d());
+      softBodyNode->addPointMass(pointMass);
+    }
+
+    for (size_t i = 0; i < numPointMasses && _in.isGood(); ++i)
+    {
+      size_t numConnected = _in.readSize();
+      for (size_t j = 0; j < numConnected && _in.isGood(); ++j)
+      {
+        size_t index = _in.readSize();
+        if (index >= numPointMasses)
+        {
+          _in.fail();
+          break;
+        }
+        softBodyNode->getPointMass(i)->addConnectedPointMass(
+              softBodyNode->getPointMass(index));
+      }
+    }
+
+    size_t numFaces = _in.readSize();
+    for (size_t i = 0; i < numFaces && _in.isGood(); ++i)
+    {
+      Eigen::Vector3i face;
+      for (size_t j = 0; j < 3; ++j)
+        face[j] = _in.read<int32_t>();
+      softBodyNode->addFace(face);
+    }
+  }
+
+  // The shapes are owned here until they are attached to the BodyNode
+  std::vector<std::unique_ptr<Shape> > shapes;
+  size_t numShapes = _in.readSize();
+  for (size_t i = 0; i < numShapes && _in.isGood(); ++i)
+    shapes.push_back(std::unique_ptr<Shape>(readShape(_in, bodyNode)));
+
+  std::vector<bool> attached(shapes.size(), false);
+
+  for (size_t i = 0; i < 2 && _in.isGood(); ++i)
+  {
+    size_t numIndices = _in.readSize();
+    for (size_t j = 0; j < numIndices && _in.isGood(); ++j)
+    {
+      size_t index = _in.readSize();
+      if (index >= shapes.size())
+      {
+        _in.fail();
+        break;
+      }
+
+      // Meshes that could not be loaded are left out
+      if (!shapes[index])
+        continue;
+
+      if (0 == i)
+        bodyNode->addVisualizationShape(shapes[index].get());
+      else
+        bodyNode->addCollisionShape(shapes[index].get());
+      attached[index] = true;
+    }
+  }
+
+  // The BodyNode deletes the attached shapes, while the others are deleted
+  // along with the shapes array
+  for (size_t i = 0; i < shapes.size(); ++i)
+  {
+    if (attached[i])
+      shapes[i].release();
+  }
+
+  size_t numMarkers = _in.readSize();
+  for (size_t i = 0; i < numMarkers && _in.isGood(); ++i)
+  {
+    std::string name = _in.readString();
+    Eigen::Vector3d position = _in.readVector3d();
+    Marker::ConstraintType type
+        = static_cast<Marker::ConstraintType>(_in.read<int32_t>());
+    bodyNode->addMarker(new Marker(name, position, bodyNode, type));
+  }
+
+  if (!_in.isGood())
+  {
+    delete bodyNode;
+    return nullptr;
+  }
+
+  return bodyNode;
+}
+
+//==============================================================================
+bool writeSkeletonData(BinaryWriter& _out, dynamics::Skeleton* _skeleton)
+{
+  _out.writeString(_skeleton->getName());
+  _out.writeBool(_skeleton->isMobile());
+  _out.writeBool(_skeleton->isEnabledSelfCollisionCheck());
+  _out.writeBool(_skeleton->isEnabledAdjacentBodyCheck());
+
+  std::map<const dynamics::BodyNode*, int> indices;
+  _out.writeSize(_skeleton->getNumBodyNodes());
+  for (size_t i = 0; i < _skeleton->getNumBodyNodes(); ++i)
+  {
+    dynamics::BodyNode* bodyNode = _skeleton->getBodyNode(i);
+    indices[bodyNode] = i;
+
+    // Parents precede their children in a Skeleton
+    int parentIndex = -1;
+    if (bodyNode->getParentBodyNode())
+      parentIndex = indices[bodyNode->getParentBodyNode()];
+
+    if (!writeBodyNode(_out, bodyNode, parentIndex))
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+dynamics::Skeleton* readSkeletonData(BinaryReader& _in)
+{
+  dynamics::Skeleton* skeleton = new dynamics::Skeleton(_in.readString());
+  skeleton->setMobile(_in.readBool());
+  bool isSelfCollisionEnabled = _in.readBool();
+  bool isAdjacentBodyCheckEnabled = _in.readBool();
+  if (isSelfCollisionEnabled)
+    skeleton->enableSelfCollision(isAdjacentBodyCheckEnabled);
+
+  size_t numBodyNodes = _in.readSize();
+  std::vector<dynamics::BodyNode*> bodyNodes;
+  for (size_t i = 0; i < numBodyNodes && _in.isGood(); ++i)
+  {
+    int parentIndex = -1;
+    dynamics::BodyNode* bodyNode = readBodyNode(_in, parentIndex);
+    if (!bodyNode)
+      break;
+
+    if (parentIndex >= static_cast<int>(bodyNodes.size()))
+    {
+      _in.fail();
+      delete bodyNode;
+      break;
+    }
+
+    if (parentIndex >= 0)
+      bodyNodes[parentIndex]->addChildBodyNode(bodyNode);
+    skeleton->addBodyNode(bodyNode);
+    bodyNodes.push_back(bodyNode);
+  }
+
+  if (!_in.isGood())
+  {
+    delete skeleton;
+    return nullptr;
+  }
+
+  return skeleton;
+}
+
+//==============================================================================
+CollisionDetectorType getCollisionDetectorType(
+    const collision::CollisionDetector* _detector)
+{
+  if (dynamic_cast<const collision::FCLMeshCollisionDetector*>(_detector))
+    return DETECTOR_FCL_MESH;
+  if (dynamic_cast<const collision::FCLCollisionDetector*>(_detector))
+    return DETECTOR_FCL;
+  if (dynamic_cast<const collision::DARTCollisionDetector*>(_detector))
+    return DETECTOR_DART;
+#ifdef HAVE_BULLET_COLLISION
+  if (dynamic_cast<const collision::BulletCollisionDetector*>(_detector))
+    return DETECTOR_BULLET;
+#endif
+
+  return DETECTOR_FCL_MESH;
+}
+
+//==============================================================================
+collision::CollisionDetector* createCollisionDetector(uint32_t _type)
+{
+  switch (_type)
+  {
+    case DETECTOR_FCL:
+      return new collision::FCLCollisionDetector();
+    case DETECTOR_DART:
+      return new collision::DARTCollisionDetector();
+#ifdef HAVE_BULLET_COLLISION
+    case DETECTOR_BULLET:
+      return new collision::BulletCollisionDetector();
+#endif
+    default:
+      return new collision::FCLMeshCollisionDetector();
+  }
+}
+
+}  // namespace
+
+//==============================================================================
+bool BinaryParser::writeWorld(simulation::World* _world,
+                              const std::string& _filename)
+{
+  assert(_world);
+
+  BinaryWriter out(_filename);
+  writeHeader(out, CONTENT_WORLD);
+
+  out.write<double>(_world->getTimeStep());
+  out.writeMatrix(_world->getGravity());
+  out.write<double>(_world->getTime());
+  out.write<uint32_t>(getCollisionDetectorType(
+        _world->getConstraintSolver()->getCollisionDetector()));
+
+  out.writeSize(_world->getNumSkeletons());
+  for (size_t i = 0; i < _world->getNumSkeletons(); ++i)
+  {
+    if (!writeSkeletonData(out, _world->getSkeleton(i)))
+      return false;
+  }
+
+  if (!out.isGood())
+  {
+    dterr << "[BinaryParser::writeWorld] Failed to write '" << _filename
+          << "'.\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool BinaryParser::writeSkeleton(dynamics::Skeleton* _skeleton,
+                                 const std::string& _filename)
+{
+  assert(_skeleton);
+
+  BinaryWriter out(_filename);
+  writeHeader(out, CONTENT_SKELETON);
+
+  if (!writeSkeletonData(out, _skeleton))
+    return false;
+
+  if (!out.isGood())
+  {
+    dterr << "[BinaryParser::writeSkeleton] Failed to write '" << _filename
+          << "'.\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+simulation::World* BinaryParser::readWorld(const std::string& _filename)
+{
+  MappedFile file(_filename);
+  if (!file.getData())
+  {
+    dterr << "[BinaryParser::readWorld] Could not read '" << _filename
+          << "'.\n";
+    return nullptr;
+  }
+
+  BinaryReader in(file.getData(), file.getSize());
+  if (!readHeader(in, CONTENT_WORLD, _filename))
+    return nullptr;
+
+  simulation::World* world = new simulation::World;
+  world->setTimeStep(in.read<double>());
+  world->setGravity(in.readVector3d());
+  double time = in.read<double>();
+  world->getConstraintSolver()->setCollisionDetector(
+        createCollisionDetector(in.read<uint32_t>()));
+
+  size_t numSkeletons = in.readSize();
+  for (size_t i = 0; i < numSkeletons && in.isGood(); ++i)
+  {
+    dynamics::Skeleton* skeleton = readSkeletonData(in);
+    if (skeleton)
+      world->addSkeleton(skeleton);
+  }
+
+  if (!in.isGood())
+  {
+    dterr << "[BinaryParser::readWorld] '" << _filename << "' is "
+          << "corrupted.\n";
+    delete world;
+    return nullptr;
+  }
+
+  world->setTime(time);
+
+  return world;
+}
+
+//==============================================================================
+dynamics::Skeleton* BinaryParser::readSkeleton(const std::string& _filename)
+{
+  MappedFile file(_filename);
+  if (!file.getData())
+  {
+    dterr << "[BinaryParser::readSkeleton] Could not read '" << _filename
+          << "'.\n";
+    return nullptr;
+  }
+
+  BinaryReader in(file.getData(), file.getSize());
+  if (!readHeader(in, CONTENT_SKELETON, _filename))
+    return nullptr;
+
+  dynamics::Skeleton* skeleton = readSkeletonData(in);
+  if (!skeleton)
+  {
+    dterr << "[BinaryParser::readSkeleton] '" << _filename << "' is "
+          << "corrupted.\n";
+    return nullptr;
+  }
+
+  skeleton->init();
+
+  return skeleton;
+}
+
+}  // namespace utils
+}  // namespace dart
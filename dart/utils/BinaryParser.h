@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_UTILS_BINARYPARSER_H_
+#define DART_UTILS_BINARYPARSER_H_
+
+#include <string>
+
+namespace dart {
+
+namespace dynamics {
+class Skeleton;
+}  // namespace dynamics
+
+namespace simulation {
+class World;
+}  // namespace simulation
+
+namespace utils {
+
+/// BinaryParser reads and writes Worlds and Skeletons in a compact binary
+/// format. It stores the same structure that the XML formats describe
+/// (bodies, joints, shapes, inertias, limits, markers, soft bodies and
+/// collision flags) together with the positions and velocities of every
+/// degree of freedom.
+///
+/// The file is read through a memory mapping where the platform supports it.
+/// Values are stored in native byte order and copied out without any string
+/// parsing; names are stored with their length. Files written on a machine of
+/// a different byte order are rejected.
+///
+/// Meshes are stored by file name, so MeshShapes that were not loaded from a
+/// file (see MeshShape::getMeshPath()) are skipped with a warning.
+class BinaryParser
+{
+public:
+  /// Write _world to _filename. Returns false if the file can not be written.
+  static bool writeWorld(simulation::World* _world,
+                         const std::string& _filename);
+
+  /// Write _skeleton to _filename. Returns false if the file can not be
+  /// written.
+  static bool writeSkeleton(dynamics::Skeleton* _skeleton,
+                            const std::string& _filename);
+
+  /// Read a World written by writeWorld(). Returns nullptr on failure.
+  static simulation::World* readWorld(const std::string& _filename);
+
+  /// Read a Skeleton written by writeSkeleton(). Returns nullptr on failure.
+  static dynamics::Skeleton* readSkeleton(const std::string& _filename);
+};
+
+}  // namespace utils
+}  // namespace dart
+
+#endif  // DART_UTILS_BINARYPARSER_H_
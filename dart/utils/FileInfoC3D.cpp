@@ -36,7 +36,10 @@
 
 #include "dart/utils/FileInfoC3D.h"
 #include "dart/utils/C3D.h"
+#include "dart/utils/FrameFile.h"
+#include "dart/common/Console.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace dart {
@@ -80,6 +83,67 @@ bool FileInfoC3D::saveFile(const char* _fName, int _start, int _end, double _sam
     }
 }
 
+bool FileInfoC3D::loadBinaryFile(const char* _fName)
+{
+    FrameFileReader reader;
+    if( !reader.open(_fName) )
+        return false;
+
+    if( reader.getContent() != FRAME_FILE_C3D || reader.getLayout().size() != 1 ){
+        dterr << "[FileInfoC3D::loadBinaryFile] [" << _fName << "] does not "
+              << "hold marker data.\n";
+        return false;
+    }
+
+    int nMarkers = reader.getLayout()[0];
+    Eigen::EIGEN_VV_VEC3D data(reader.getNumFrames());
+    Eigen::VectorXd frame;
+    for( size_t i = 0; i < data.size(); i++ ){
+        if( !reader.readFrame(i, frame) || frame.size() != 3*nMarkers )
+            return false;
+        data[i].resize(nMarkers);
+        for( int j = 0; j < nMarkers; j++ )
+            data[i][j] = frame.segment<3>(3*j);
+    }
+
+    mData.swap(data);
+    mNumFrames = mData.size();
+    mNumMarkers = nMarkers;
+    mFPS = reader.getFrameRate();
+
+    std::string text = _fName;
+    int lastSlash = text.find_last_of("/");
+    text = text.substr(lastSlash+1);
+    strcpy(mFileName, text.c_str());
+    return true;
+}
+
+bool FileInfoC3D::saveBinaryFile(const char* _fName, int _start, int _end)
+{
+    int first = _start<mNumFrames?_start:mNumFrames-1;
+    int last = _end<mNumFrames?_end:mNumFrames-1;
+
+    FrameFileWriter writer(_fName, FRAME_FILE_C3D, std::vector<size_t>(1, mNumMarkers), mFPS);
+    if( !writer.isOpen() )
+        return false;
+
+    Eigen::VectorXd frame(3*mNumMarkers);
+    for( int i = std::max(first, 0); i <= last; i++ ){
+        for( int j = 0; j < mNumMarkers; j++ )
+            frame.segment<3>(3*j) = mData[i][j];
+        writer.addFrame(frame);
+    }
+
+    if( !writer.close() )
+        return false;
+
+    std::string text = _fName;
+    int lastSlash = text.find_last_of("/");
+    text = text.substr(lastSlash+1);
+    strcpy(mFileName, text.c_str());
+    return true;
+}
+
 } // namespace utils
 } // namespace dart
 
@@ -60,6 +60,14 @@ public:
 
     virtual bool loadFile(const char*);
     virtual bool saveFile(const char*, int _start, int _end, double _sampleRate = 1); ///< Note: down sampling not implemented yet
+
+    /// Load a file written by saveBinaryFile()
+    virtual bool loadBinaryFile(const char*);
+
+    /// Save in the binary frame file format (see FrameFileWriter), which loads
+    /// much faster than C3D and can be read frame by frame with
+    /// FrameFileReader.
+    virtual bool saveBinaryFile(const char*, int _start, int _end);
     
 protected:
     int mNumMarkers;
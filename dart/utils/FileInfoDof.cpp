@@ -39,10 +39,12 @@
 #include <fstream>
 #include <string>
 
+#include "dart/common/Console.h"
 #include "dart/dynamics/DegreeOfFreedom.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/dynamics/Joint.h"
 #include "dart/simulation/Recording.h"
+#include "dart/utils/FrameFile.h"
 
 namespace dart {
 namespace utils {
@@ -157,6 +159,73 @@ bool FileInfoDof::saveFile(const char* _fName, size_t _start, size_t _end,
   return true;
 }
 
+//==============================================================================
+bool FileInfoDof::loadBinaryFile(const char* _fName)
+{
+  FrameFileReader reader;
+  if (!reader.open(_fName))
+    return false;
+
+  if (reader.getContent() != FRAME_FILE_DOF || reader.getLayout().size() != 1)
+  {
+    dterr << "[FileInfoDof::loadBinaryFile] [" << _fName << "] does not "
+          << "hold skeleton poses.\n";
+    return false;
+  }
+
+  size_t nDof = reader.getLayout()[0];
+  if (mSkel == NULL || mSkel->getNumDofs() != nDof)
+    return false;
+
+  mNumFrames = reader.getNumFrames();
+  mDofs.resize(mNumFrames);
+  for (size_t j = 0; j < mNumFrames; j++)
+  {
+    if (!reader.readFrame(j, mDofs[j])
+        || static_cast<size_t>(mDofs[j].size()) != nDof)
+    {
+      mDofs.clear();
+      mNumFrames = 0;
+      return false;
+    }
+  }
+
+  mFPS = reader.getFrameRate();
+
+  std::string text = _fName;
+  int lastSlash = text.find_last_of("/");
+  text = text.substr(lastSlash+1);
+  strcpy(mFileName, text.c_str());
+  return true;
+}
+
+//==============================================================================
+bool FileInfoDof::saveBinaryFile(const char* _fName, size_t _start,
+                                 size_t _end)
+{
+  if (_end < _start) return false;
+
+  size_t first = _start < mNumFrames ? _start : mNumFrames - 1;
+  size_t last = _end < mNumFrames ? _end : mNumFrames - 1;
+
+  FrameFileWriter writer(_fName, FRAME_FILE_DOF,
+                         std::vector<size_t>(1, mSkel->getNumDofs()), mFPS);
+  if (!writer.isOpen())
+    return false;
+
+  for (size_t i = first; i <= last && mNumFrames > 0; i++)
+    writer.addFrame(mDofs[i]);
+
+  if (!writer.close())
+    return false;
+
+  std::string text = _fName;
+  size_t lastSlash = text.find_last_of("/");
+  text = text.substr(lastSlash + 1);
+  std::strcpy(mFileName, text.c_str());
+  return true;
+}
+
 //==============================================================================
 void FileInfoDof::addDof(const Eigen::VectorXd& _dofs)
 {
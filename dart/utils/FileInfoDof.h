@@ -67,6 +67,14 @@ public:
   bool saveFile(const char* _fileName, size_t _start, size_t _end,
                 double _sampleRate = 1.0);
 
+  /// \brief Load a file written by saveBinaryFile()
+  bool loadBinaryFile(const char* _fileName);
+
+  /// \brief Save file in the binary frame file format (see FrameFileWriter),
+  /// which loads much faster than the text format and can be read frame by
+  /// frame with FrameFileReader
+  bool saveBinaryFile(const char* _fileName, size_t _start, size_t _end);
+
   /// \brief Add Dof
   void addDof(const Eigen::VectorXd& _dofs);
 
@@ -39,7 +39,9 @@
 #include <fstream>
 #include <string>
 
+#include "dart/common/Console.h"
 #include "dart/simulation/Recording.h"
+#include "dart/utils/FrameFile.h"
 
 namespace dart {
 namespace utils {
@@ -166,6 +168,67 @@ bool FileInfoWorld::saveFile(const char* _fName, simulation::Recording* _record)
   return true;
 }
 
+//==============================================================================
+bool FileInfoWorld::loadBinaryFile(const char* _fName)
+{
+  FrameFileReader reader;
+  if (!reader.open(_fName))
+    return false;
+
+  if (reader.getContent() != FRAME_FILE_WORLD)
+  {
+    dterr << "[FileInfoWorld::loadBinaryFile] [" << _fName << "] does not "
+          << "hold a world recording.\n";
+    return false;
+  }
+
+  std::vector<int> numDofsForSkels(reader.getLayout().begin(),
+                                   reader.getLayout().end());
+
+  // Release the previous recording
+  delete mRecord;
+
+  mRecord = new simulation::Recording(numDofsForSkels);
+
+  Eigen::VectorXd state;
+  while (reader.next(state))
+    mRecord->addState(state);
+
+  if (static_cast<size_t>(mRecord->getNumFrames()) != reader.getNumFrames())
+    return false;
+
+  std::string text = _fName;
+  int lastSlash = text.find_last_of("/");
+  text = text.substr(lastSlash+1);
+  strcpy(mFileName, text.c_str());
+  return true;
+}
+
+//==============================================================================
+bool FileInfoWorld::saveBinaryFile(const char* _fName,
+                                   simulation::Recording* _record)
+{
+  std::vector<size_t> numDofsForSkels;
+  for (int i = 0; i < _record->getNumSkeletons(); i++)
+    numDofsForSkels.push_back(_record->getNumDofs(i));
+
+  FrameFileWriter writer(_fName, FRAME_FILE_WORLD, numDofsForSkels);
+  if (!writer.isOpen())
+    return false;
+
+  for (int i = 0; i < _record->getNumFrames(); i++)
+    writer.addFrame(_record->getState(i));
+
+  if (!writer.close())
+    return false;
+
+  std::string text = _fName;
+  int lastSlash = text.find_last_of("/");
+  text = text.substr(lastSlash+1);
+  std::strcpy(mFileName, text.c_str());
+  return true;
+}
+
 //==============================================================================
 simulation::Recording* FileInfoWorld::getRecording() const
 {
@@ -62,6 +62,14 @@ public:
   /// \note Down sampling not implemented yet
   bool saveFile(const char* _fileName, simulation::Recording* _record);
 
+  /// \brief Load a file written by saveBinaryFile()
+  bool loadBinaryFile(const char* _fileName);
+
+  /// \brief Save file in the binary frame file format (see FrameFileWriter),
+  /// which loads much faster than the text format and can be read frame by
+  /// frame with FrameFileReader
+  bool saveBinaryFile(const char* _fileName, simulation::Recording* _record);
+
   /// \brief Get recording
   simulation::Recording* getRecording() const;
 
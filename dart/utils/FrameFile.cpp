@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/FrameFile.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dart/common/Console.h"
+
+namespace dart {
+namespace utils {
+
+namespace {
+
+const char FRAME_FILE_MAGIC[8] = {'D', 'A', 'R', 'T', 'F', 'R', 'M', '\0'};
+const char FRAME_FILE_END[8] = {'D', 'A', 'R', 'T', 'E', 'N', 'D', '\0'};
+const uint32_t FRAME_FILE_VERSION = 1;
+const uint32_t FRAME_FILE_BYTE_ORDER = 0x01020304;
+
+/// Size of the fixed part of the header: magic, version, byte order, content,
+/// layout size and frame rate
+const uint64_t HEADER_SIZE = 32;
+
+/// Size of the footer: index offset, number of frames and end marker
+const uint64_t FOOTER_SIZE = 24;
+
+//==============================================================================
+template <typename T>
+void append(std::vector<char>& _buffer, const T& _value)
+{
+  const char* data = reinterpret_cast<const char*>(&_value);
+  _buffer.insert(_buffer.end(), data, data + sizeof(T));
+}
+
+//==============================================================================
+template <typename T>
+T extract(const char* _data)
+{
+  T value;
+  std::memcpy(&value, _data, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+//==============================================================================
+FrameFileWriter::FrameFileWriter(const std::string& _fileName,
+                                 FrameFileContent _content,
+                                 const std::vector<size_t>& _layout,
+                                 double _frameRate,
+                                 size_t _chunkSize)
+  : mFile(_fileName.c_str(), std::ios::binary),
+    mChunkSize(_chunkSize),
+    mOffset(0),
+    mGood(mFile.good())
+{
+  if (!mGood)
+    return;
+
+  std::vector<char> header(FRAME_FILE_MAGIC, FRAME_FILE_MAGIC + 8);
+  append<uint32_t>(header, FRAME_FILE_VERSION);
+  append<uint32_t>(header, FRAME_FILE_BYTE_ORDER);
+  append<uint32_t>(header, _content);
+  append<uint32_t>(header, _layout.size());
+  append<double>(header, _frameRate);
+  for (size_t i = 0; i < _layout.size(); ++i)
+    append<uint64_t>(header, _layout[i]);
+
+  mFile.write(header.data(), header.size());
+  mOffset = header.size();
+  mChunk.reserve(mChunkSize);
+}
+
+//==============================================================================
+FrameFileWriter::~FrameFileWriter()
+{
+  if (mFile.is_open())
+    close();
+}
+
+//==============================================================================
+bool FrameFileWriter::isOpen() const
+{
+  return mFile.is_open() && mGood;
+}
+
+//==============================================================================
+void FrameFileWriter::addFrame(const Eigen::VectorXd& _values)
+{
+  if (!isOpen())
+    return;
+
+  mIndex.push_back(mOffset);
+
+  append<uint64_t>(mChunk, _values.size());
+  const char* data = reinterpret_cast<const char*>(_values.data());
+  mChunk.insert(mChunk.end(), data, data + _values.size() * sizeof(double));
+  mOffset += sizeof(uint64_t) + _values.size() * sizeof(double);
+
+  if (mChunk.size() >= mChunkSize)
+    flush();
+}
+
+//==============================================================================
+size_t FrameFileWriter::getNumFrames() const
+{
+  return mIndex.size();
+}
+
+//==============================================================================
+size_t FrameFileWriter::getChunkSize() const
+{
+  return mChunkSize;
+}
+
+//==============================================================================
+bool FrameFileWriter::close()
+{
+  if (!mFile.is_open())
+    return false;
+
+  flush();
+
+  uint64_t indexOffset = mOffset;
+  uint64_t numFrames = mIndex.size();
+  if (!mIndex.empty())
+  {
+    mFile.write(reinterpret_cast<const char*>(mIndex.data()),
+                mIndex.size() * sizeof(uint64_t));
+  }
+  mFile.write(reinterpret_cast<const char*>(&indexOffset), sizeof(uint64_t));
+  mFile.write(reinterpret_cast<const char*>(&numFrames), sizeof(uint64_t));
+  mFile.write(FRAME_FILE_END, 8);
+
+  mGood = mGood && mFile.good();
+  mFile.close();
+  mIndex.clear();
+
+  return mGood;
+}
+
+//==============================================================================
+void FrameFileWriter::flush()
+{
+  if (mChunk.empty())
+    return;
+
+  mFile.write(mChunk.data(), mChunk.size());
+  mGood = mGood && mFile.good();
+  mChunk.clear();
+}
+
+//==============================================================================
+FrameFileReader::FrameFileReader()
+  : mData(nullptr),
+    mSize(0),
+    mContent(FRAME_FILE_WORLD),
+    mFrameRate(0.0),
+    mFramesEnd(0),
+    mPosition(0)
+{
+}
+
+//==============================================================================
+FrameFileReader::~FrameFileReader()
+{
+  close();
+}
+
+//==============================================================================
+bool FrameFileReader::open(const std::string& _fileName)
+{
+  close();
+
+#ifndef _WIN32
+  int fd = ::open(_fileName.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0)
+    {
+      void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+                        fd, 0);
+      if (data != MAP_FAILED)
+      {
+        mData = static_cast<const char*>(data);
+        mSize = status.st_size;
+      }
+    }
+    ::close(fd);
+  }
+#endif
+
+  if (nullptr == mData)
+  {
+    mFile.open(_fileName.c_str(), std::ios::binary | std::ios::ate);
+    if (!mFile)
+      return false;
+    mSize = static_cast<uint64_t>(mFile.tellg());
+  }
+
+  // Header
+  const char* header = getBytes(0, HEADER_SIZE);
+  if (nullptr == header
+      || std::memcmp(header, FRAME_FILE_MAGIC, 8) != 0
+      || extract<uint32_t>(header + 8) != FRAME_FILE_VERSION
+      || extract<uint32_t>(header + 12) != FRAME_FILE_BYTE_ORDER)
+  {
+    dterr << "[FrameFileReader::open] [" << _fileName << "] is not a frame "
+          << "file of this version and byte order.\n";
+    close();
+    return false;
+  }
+  uint32_t content = extract<uint32_t>(header + 16);
+  uint32_t layoutSize = extract<uint32_t>(header + 20);
+  mFrameRate = extract<double>(header + 24);
+
+  const char* layout = getBytes(HEADER_SIZE, layoutSize * sizeof(uint64_t));
+  if (content > FRAME_FILE_C3D || (layoutSize > 0 && nullptr == layout))
+  {
+    dterr << "[FrameFileReader::open] The header of [" << _fileName
+          << "] is corrupt.\n";
+    close();
+    return false;
+  }
+  mContent = static_cast<FrameFileContent>(content);
+  mLayout.resize(layoutSize);
+  for (size_t i = 0; i < layoutSize; ++i)
+    mLayout[i] = extract<uint64_t>(layout + i * sizeof(uint64_t));
+  uint64_t framesBegin = HEADER_SIZE + layoutSize * sizeof(uint64_t);
+
+  // Footer and index
+  const char* footer = mSize >= framesBegin + FOOTER_SIZE
+      ? getBytes(mSize - FOOTER_SIZE, FOOTER_SIZE) : nullptr;
+  if (nullptr == footer || std::memcmp(footer + 16, FRAME_FILE_END, 8) != 0)
+  {
+    dterr << "[FrameFileReader::open] [" << _fileName << "] is truncated.\n";
+    close();
+    return false;
+  }
+  uint64_t indexOffset = extract<uint64_t>(footer);
+  uint64_t numFrames = extract<uint64_t>(footer + 8);
+  if (indexOffset < framesBegin || indexOffset > mSize - FOOTER_SIZE
+      || (mSize - FOOTER_SIZE - indexOffset) / sizeof(uint64_t) != numFrames
+      || (mSize - FOOTER_SIZE - indexOffset) % sizeof(uint64_t) != 0)
+  {
+    dterr << "[FrameFileReader::open] The index of [" << _fileName
+          << "] is corrupt.\n";
+    close();
+    return false;
+  }
+
+  const char* index = getBytes(indexOffset, numFrames * sizeof(uint64_t));
+  mIndex.resize(numFrames);
+  if (numFrames > 0)
+    std::memcpy(mIndex.data(), index, numFrames * sizeof(uint64_t));
+  mFramesEnd = indexOffset;
+
+  // The frames themselves are only checked when they are read, so that
+  // opening a large file does not touch all of it
+  for (size_t i = 0; i < mIndex.size(); ++i)
+  {
+    if (mIndex[i] < framesBegin
+        || mIndex[i] + sizeof(uint64_t) > mFramesEnd)
+    {
+      dterr << "[FrameFileReader::open] The index of [" << _fileName
+            << "] is corrupt.\n";
+      close();
+      return false;
+    }
+  }
+
+  mPosition = 0;
+  return true;
+}
+
+//==============================================================================
+void FrameFileReader::close()
+{
+#ifndef _WIN32
+  if (mData)
+    munmap(const_cast<char*>(mData), mSize);
+#endif
+  mData = nullptr;
+  mSize = 0;
+
+  if (mFile.is_open())
+    mFile.close();
+  mFile.clear();
+  mBuffer.clear();
+
+  mLayout.clear();
+  mIndex.clear();
+  mFrameRate = 0.0;
+  mFramesEnd = 0;
+  mPosition = 0;
+}
+
+//==============================================================================
+bool FrameFileReader::isOpen() const
+{
+  return mData != nullptr || mFile.is_open();
+}
+
+//==============================================================================
+FrameFileContent FrameFileReader::getContent() const
+{
+  return mContent;
+}
+
+//==============================================================================
+const std::vector<size_t>& FrameFileReader::getLayout() const
+{
+  return mLayout;
+}
+
+//==============================================================================
+double FrameFileReader::getFrameRate() const
+{
+  return mFrameRate;
+}
+
+//==============================================================================
+size_t FrameFileReader::getNumFrames() const
+{
+  return mIndex.size();
+}
+
+//==============================================================================
+size_t FrameFileReader::getFrameSize(size_t _frame) const
+{
+  if (_frame >= mIndex.size())
+    return 0;
+
+  const char* count = getBytes(mIndex[_frame], sizeof(uint64_t));
+  if (nullptr == count)
+    return 0;
+
+  // A corrupt count must not reach past the frames
+  uint64_t size = extract<uint64_t>(count);
+  uint64_t maxSize = (mFramesEnd - mIndex[_frame] - sizeof(uint64_t))
+                     / sizeof(double);
+  return size <= maxSize ? size : 0;
+}
+
+//==============================================================================
+bool FrameFileReader::readFrame(size_t _frame, Eigen::VectorXd& _values)
+{
+  if (_frame >= mIndex.size())
+    return false;
+
+  const char* count = getBytes(mIndex[_frame], sizeof(uint64_t));
+  if (nullptr == count)
+    return false;
+
+  uint64_t size = extract<uint64_t>(count);
+  if (size > (mFramesEnd - mIndex[_frame] - sizeof(uint64_t)) / sizeof(double))
+  {
+    dterr << "[FrameFileReader::readFrame] Frame " << _frame
+          << " is corrupt.\n";
+    return false;
+  }
+
+  const char* data = getBytes(mIndex[_frame] + sizeof(uint64_t),
+                              size * sizeof(double));
+  if (nullptr == data)
+    return false;
+
+  _values.resize(size);
+  if (size > 0)
+    std::memcpy(_values.data(), data, size * sizeof(double));
+
+  return true;
+}
+
+//==============================================================================
+void FrameFileReader::seek(size_t _frame)
+{
+  mPosition = _frame;
+}
+
+//==============================================================================
+bool FrameFileReader::next(Eigen::VectorXd& _values)
+{
+  if (!readFrame(mPosition, _values))
+    return false;
+
+  ++mPosition;
+  return true;
+}
+
+//==============================================================================
+const char* FrameFileReader::getBytes(uint64_t _offset, uint64_t _size) const
+{
+  if (_offset > mSize || _size > mSize - _offset)
+    return nullptr;
+
+  if (mData)
+    return mData + _offset;
+
+  if (!mFile.is_open())
+    return nullptr;
+
+  // Keep the buffer non-empty so that empty reads still return a pointer
+  mBuffer.resize(_size > 0 ? _size : 1);
+  if (_size == 0)
+    return mBuffer.data();
+
+  mFile.clear();
+  mFile.seekg(_offset);
+  if (!mFile.read(mBuffer.data(), _size))
+    return nullptr;
+
+  return mBuffer.data();
+}
+
+}  // namespace utils
+}  // namespace dart
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_UTILS_FRAMEFILE_H_
+#define DART_UTILS_FRAMEFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace dart {
+namespace utils {
+
+/// Kinds of data that a frame file holds
+enum FrameFileContent
+{
+  FRAME_FILE_WORLD,  ///< States of a simulation::Recording (FileInfoWorld)
+  FRAME_FILE_DOF,    ///< Skeleton poses (FileInfoDof)
+  FRAME_FILE_C3D     ///< Marker positions (FileInfoC3D)
+};
+
+/// FrameFileWriter streams frames of double values into a binary frame file.
+///
+/// A frame file starts with a header that holds the content type, the frame
+/// rate and a layout (for example the number of dofs of each skeleton). The
+/// frames follow one after another, each as its number of values followed by
+/// the values in native byte order. An index with the offset of every frame
+/// is appended when the file is closed, so frames can have different sizes
+/// and can still be found in constant time.
+///
+/// Frames are collected into chunks of about getChunkSize() bytes before they
+/// are written, so the writer only holds one chunk and the index in memory.
+class FrameFileWriter
+{
+public:
+  /// Create _fileName and write the header. Check isOpen() for success.
+  FrameFileWriter(const std::string& _fileName, FrameFileContent _content,
+                  const std::vector<size_t>& _layout, double _frameRate = 0.0,
+                  size_t _chunkSize = 1 << 20);
+
+  /// Close the file if it is still open
+  ~FrameFileWriter();
+
+  /// Return true if the file can be written
+  bool isOpen() const;
+
+  /// Append a frame
+  void addFrame(const Eigen::VectorXd& _values);
+
+  /// Get the number of frames added so far
+  size_t getNumFrames() const;
+
+  /// Get the number of bytes that are collected before they are written
+  size_t getChunkSize() const;
+
+  /// Write the remaining frames and the index, and close the file. Returns
+  /// false if any write failed.
+  bool close();
+
+private:
+  /// Write the collected frames to the file
+  void flush();
+
+  /// The file being written
+  std::ofstream mFile;
+
+  /// Frames that have not been written yet
+  std::vector<char> mChunk;
+
+  /// Number of bytes to collect before writing them
+  size_t mChunkSize;
+
+  /// File offset of every frame
+  std::vector<uint64_t> mIndex;
+
+  /// File offset of the end of mChunk
+  uint64_t mOffset;
+
+  /// False once any write failed
+  bool mGood;
+};
+
+/// FrameFileReader gives random and sequential access to the frames of a file
+/// written by FrameFileWriter without loading the whole file.
+///
+/// Where the platform supports it the file is memory mapped, so only the
+/// pages of the frames that are actually read are brought into memory.
+/// Elsewhere each frame is read from the file on request. In both cases only
+/// the header and the frame index are held in memory.
+///
+/// Files written on a machine of a different byte order are rejected.
+class FrameFileReader
+{
+public:
+  /// Constructor
+  FrameFileReader();
+
+  /// Destructor
+  ~FrameFileReader();
+
+  /// Open _fileName and read its header and index. Returns false if the file
+  /// is missing, truncated or not a frame file.
+  bool open(const std::string& _fileName);
+
+  /// Close the file
+  void close();
+
+  /// Return true if a file is open
+  bool isOpen() const;
+
+  /// Get the content type of the file
+  FrameFileContent getContent() const;
+
+  /// Get the layout that was given to the writer
+  const std::vector<size_t>& getLayout() const;
+
+  /// Get the frame rate that was given to the writer
+  double getFrameRate() const;
+
+  /// Get the number of frames
+  size_t getNumFrames() const;
+
+  /// Get the number of values of frame _frame, or zero if it is out of range
+  size_t getFrameSize(size_t _frame) const;
+
+  /// Read frame _frame into _values. Returns false if the frame is out of
+  /// range or can not be read.
+  bool readFrame(size_t _frame, Eigen::VectorXd& _values);
+
+  /// Set the frame that the next call to next() reads
+  void seek(size_t _frame);
+
+  /// Read the frame at the current position into _values and advance to the
+  /// following frame. Returns false after the last frame.
+  bool next(Eigen::VectorXd& _values);
+
+private:
+  /// Get _size bytes starting at _offset, or nullptr if they can not be read
+  const char* getBytes(uint64_t _offset, uint64_t _size) const;
+
+  /// Start of the mapped file, or nullptr if the file is not mapped
+  const char* mData;
+
+  /// Size of the file in bytes
+  uint64_t mSize;
+
+  /// The file, if it could not be mapped
+  mutable std::ifstream mFile;
+
+  /// Bytes last read from mFile
+  mutable std::vector<char> mBuffer;
+
+  /// Content type of the file
+  FrameFileContent mContent;
+
+  /// Layout of the file
+  std::vector<size_t> mLayout;
+
+  /// Frame rate of the file
+  double mFrameRate;
+
+  /// File offset of every frame
+  std::vector<uint64_t> mIndex;
+
+  /// File offset of the end of the last frame
+  uint64_t mFramesEnd;
+
+  /// Frame that next() reads
+  size_t mPosition;
+};
+
+}  // namespace utils
+}  // namespace dart
+
+#endif  // DART_UTILS_FRAMEFILE_H_
@@ -56,6 +56,7 @@
 #include "dart/dynamics/CylinderShape.h"
 #include "dart/dynamics/EllipsoidShape.h"
 #include "dart/dynamics/PlaneShape.h"
+#include "dart/dynamics/MeshCache.h"
 #include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/SoftMeshShape.h"
 #include "dart/dynamics/WeldJoint.h"
@@ -159,6 +160,12 @@ dynamics::Skeleton* SkelParser::readSkeleton(const std::string& _filename)
     return NULL;
   }
 
+  // Load all the meshes up front. They stay cached while the skeleton is built.
+  std::vector<std::string> meshFileNames;
+  readMeshFileNames(skeletonElement, meshFileNames);
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = dynamics::MeshCache::loadAll(meshFileNames);
+
   dynamics::Skeleton* newSkeleton = readSkeleton(skeletonElement);
 
   // Initialize skeleto to be ready for use
@@ -239,6 +246,16 @@ simulation::World* SkelParser::readWorld(tinyxml2::XMLElement* _worldElement) {
     }
   }
 
+  //--------------------------------------------------------------------------
+  // Load the meshes of all the skeletons up front. They stay cached while the
+  // skeletons are built below.
+  std::vector<std::string> meshFileNames;
+  ElementEnumerator meshSkeletonElements(_worldElement, "skeleton");
+  while (meshSkeletonElements.next())
+    readMeshFileNames(meshSkeletonElements.get(), meshFileNames);
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = dynamics::MeshCache::loadAll(meshFileNames);
+
   //--------------------------------------------------------------------------
   // Load soft skeletons
   ElementEnumerator SkeletonElements(_worldElement, "skeleton");
@@ -814,10 +831,10 @@ dynamics::Shape* SkelParser::readShape(tinyxml2::XMLElement* vizEle) {
     std::string           filename     = getValueString(meshEle, "file_name");
     Eigen::Vector3d       scale        = getValueVector3d(meshEle, "scale");
     // TODO(JS): Do we assume that all mesh files place at DART_DATA_PATH?
-    const aiScene* model = dynamics::MeshShape::loadMesh(DART_DATA_PATH +
-                                                         filename);
+    std::string path = DART_DATA_PATH + filename;
+    std::shared_ptr<const aiScene> model = dynamics::MeshCache::load(path);
     if (model) {
-      newShape = new dynamics::MeshShape(scale, model);
+      newShape = new dynamics::MeshShape(scale, model, path);
     } else {
       dterr << "Fail to load model[" << filename << "]." << std::endl;
     }
@@ -841,6 +858,36 @@ dynamics::Shape* SkelParser::readShape(tinyxml2::XMLElement* vizEle) {
   return newShape;
 }
 
+void SkelParser::readMeshFileNames(tinyxml2::XMLElement* _skeletonElement,
+                                   std::vector<std::string>& _fileNames)
+{
+  const char* shapeTypes[] = { "visualization_shape", "collision_shape" };
+
+  ElementEnumerator bodies(_skeletonElement, "body");
+  while (bodies.next())
+  {
+    for (size_t i = 0; i < 2; ++i)
+    {
+      ElementEnumerator shapes(bodies.get(), shapeTypes[i]);
+      while (shapes.next())
+      {
+        tinyxml2::XMLElement* geometryEle
+            = getElement(shapes.get(), "geometry");
+        if (geometryEle == NULL || !hasElement(geometryEle, "mesh"))
+          continue;
+
+        tinyxml2::XMLElement* meshEle = getElement(geometryEle, "mesh");
+        if (!hasElement(meshEle, "file_name"))
+          continue;
+
+        // Must match the path that readShape() passes to MeshCache
+        _fileNames.push_back(DART_DATA_PATH
+                             + getValueString(meshEle, "file_name"));
+      }
+    }
+  }
+}
+
 dynamics::Marker* SkelParser::readMarker(tinyxml2::XMLElement* _markerElement,
                                          dynamics::BodyNode* _bodyNode)
 {
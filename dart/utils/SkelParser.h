@@ -119,6 +119,12 @@ protected:
   ///
   static dynamics::Shape* readShape(tinyxml2::XMLElement* _shapeElement);
 
+  /// Append the paths of all the mesh files that the shapes of
+  /// _skeletonElement refer to, so that they can be loaded before the
+  /// Skeleton is built
+  static void readMeshFileNames(tinyxml2::XMLElement* _skeletonElement,
+                                std::vector<std::string>& _fileNames);
+
   /// Read marker
   static dart::dynamics::Marker* readMarker(
       tinyxml2::XMLElement* _markerElement,
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/utils/SrdfParser.h"
+
+#include <cassert>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <tinyxml2.h>
+
+#include "dart/common/Console.h"
+#include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/Skeleton.h"
+#include "dart/utils/Parser.h"
+
+namespace dart {
+namespace utils {
+
+//==============================================================================
+size_t SrdfParser::readDisabledCollisions(const std::string& _fileName,
+                                          dynamics::Skeleton* _skeleton)
+{
+  assert(_skeleton);
+
+  tinyxml2::XMLDocument srdfFile;
+  try
+  {
+    openXMLFile(srdfFile, _fileName.c_str());
+  }
+  catch(std::exception const& e)
+  {
+    dterr << "[SrdfParser::readDisabledCollisions] LoadFile [" << _fileName
+          << "] Fails: " << e.what() << "\n";
+    return 0;
+  }
+
+  tinyxml2::XMLElement* robotElement = srdfFile.FirstChildElement("robot");
+  if (robotElement == NULL)
+  {
+    dterr << "[SrdfParser::readDisabledCollisions] File [" << _fileName
+          << "] does not contain <robot> as the root element.\n";
+    return 0;
+  }
+
+  size_t numPairs = 0;
+  ElementEnumerator pairs(robotElement, "disable_collisions");
+  while (pairs.next())
+  {
+    if (!hasAttribute(pairs.get(), "link1")
+        || !hasAttribute(pairs.get(), "link2"))
+    {
+      dtwarn << "[SrdfParser::readDisabledCollisions] Skipping "
+             << "<disable_collisions> without link1 and link2 in ["
+             << _fileName << "].\n";
+      continue;
+    }
+
+    const std::string link1 = getAttribute(pairs.get(), "link1");
+    const std::string link2 = getAttribute(pairs.get(), "link2");
+    dynamics::BodyNode* bodyNode1 = _skeleton->getBodyNode(link1);
+    dynamics::BodyNode* bodyNode2 = _skeleton->getBodyNode(link2);
+    if (bodyNode1 == NULL || bodyNode2 == NULL)
+    {
+      dtwarn << "[SrdfParser::readDisabledCollisions] Skeleton ["
+             << _skeleton->getName() << "] has no link ["
+             << (bodyNode1 == NULL ? link1 : link2) << "].\n";
+      continue;
+    }
+
+    _skeleton->disableSelfCollisionPair(bodyNode1, bodyNode2);
+    ++numPairs;
+  }
+
+  return numPairs;
+}
+
+//==============================================================================
+bool SrdfParser::writeDisabledCollisions(const std::string& _fileName,
+                                         const dynamics::Skeleton* _skeleton,
+                                         const std::string& _reason)
+{
+  assert(_skeleton);
+
+  std::ofstream file(_fileName.c_str());
+  if (!file.is_open())
+  {
+    dterr << "[SrdfParser::writeDisabledCollisions] Can't open file ["
+          << _fileName << "] for writing.\n";
+    return false;
+  }
+
+  const std::vector<std::pair<dynamics::BodyNode*, dynamics::BodyNode*> >
+      pairs = _skeleton->getDisabledSelfCollisionPairs();
+
+  file << "<?xml version=\"1.0\" ?>\n";
+  file << "<robot name=\"" << _skeleton->getName() << "\">\n";
+  for (size_t i = 0; i < pairs.size(); ++i)
+  {
+    file << "  <disable_collisions link1=\"" << pairs[i].first->getName()
+         << "\" link2=\"" << pairs[i].second->getName()
+         << "\" reason=\"" << _reason << "\"/>\n";
+  }
+  file << "</robot>\n";
+
+  return file.good();
+}
+
+}  // namespace utils
+}  // namespace dart
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_UTILS_SRDFPARSER_H_
+#define DART_UTILS_SRDFPARSER_H_
+
+#include <cstddef>
+#include <string>
+
+namespace dart {
+namespace dynamics {
+class Skeleton;
+}  // namespace dynamics
+}  // namespace dart
+
+namespace dart {
+namespace utils {
+
+/// SrdfParser reads and writes the pairs of body nodes of a skeleton whose
+/// self collisions are disabled (see Skeleton::disableSelfCollisionPair()).
+///
+/// The pairs are kept in a side file next to the .skel or URDF model, in the
+/// format of the semantic robot description (SRDF):
+///
+/// \code
+/// <robot name="atlas">
+///   <disable_collisions link1="l_uleg" link2="l_lleg" reason="Adjacent"/>
+/// </robot>
+/// \endcode
+///
+/// Links are matched to body nodes by name. Other elements of the file and
+/// the reason of each pair are ignored.
+class SrdfParser
+{
+public:
+  /// Disable the pairs of _fileName on _skeleton. Pairs naming a body node
+  /// that _skeleton does not have are skipped. Return the number of pairs
+  /// that were disabled.
+  static size_t readDisabledCollisions(const std::string& _fileName,
+                                       dynamics::Skeleton* _skeleton);
+
+  /// Write the disabled pairs of _skeleton to _fileName, each with _reason.
+  /// Return false if the file can not be written.
+  static bool writeDisabledCollisions(const std::string& _fileName,
+                                      const dynamics::Skeleton* _skeleton,
+                                      const std::string& _reason = "Never");
+};
+
+}  // namespace utils
+}  // namespace dart
+
+#endif  // DART_UTILS_SRDFPARSER_H_
@@ -7,6 +7,7 @@
 #include "dart/dynamics/BoxShape.h"
 #include "dart/dynamics/CylinderShape.h"
 #include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/MeshCache.h"
 #include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/WeldJoint.h"
 #include "dart/dynamics/PrismaticJoint.h"
@@ -128,6 +129,12 @@ dart::dynamics::Skeleton* SdfParser::readSkeleton(const std::string& _filename)
   std::replace(unixFileName.begin(), unixFileName.end(), '\\' , '/' );
   std::string skelPath = unixFileName.substr(0, unixFileName.rfind("/") + 1);
 
+  // Load all the meshes up front. They stay cached while the skeleton is built.
+  std::vector<std::string> meshFileNames;
+  readMeshFileNames(skelElement, skelPath, meshFileNames);
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = dynamics::MeshCache::loadAll(meshFileNames);
+
   dynamics::Skeleton* newSkeleton = readSkeleton(skelElement, skelPath);
 
   return newSkeleton;
@@ -155,6 +162,16 @@ simulation::World* SdfParser::readWorld(tinyxml2::XMLElement* _worldElement,
         readPhysics(physicsElement, newWorld);
     }
 
+    //--------------------------------------------------------------------------
+    // Load the meshes of all the skeletons up front. They stay cached while
+    // the skeletons are built below.
+    std::vector<std::string> meshFileNames;
+    ElementEnumerator meshSkeletonElements(_worldElement, "model");
+    while (meshSkeletonElements.next())
+      readMeshFileNames(meshSkeletonElements.get(), _skelPath, meshFileNames);
+    std::vector<std::shared_ptr<const aiScene> > meshes
+        = dynamics::MeshCache::loadAll(meshFileNames);
+
     //--------------------------------------------------------------------------
     // Load skeletons
     ElementEnumerator skeletonElements(_worldElement, "model");
@@ -448,9 +465,10 @@ dynamics::Shape* SdfParser::readShape(tinyxml2::XMLElement* _shapelement,
       // TODO(JS): We assume that uri is just file name for the mesh
       std::string           uri     = getValueString(meshEle, "uri");
       Eigen::Vector3d       scale   = getValueVector3d(meshEle, "scale");
-      const aiScene* model = dynamics::MeshShape::loadMesh(_skelPath + uri);
+      std::shared_ptr<const aiScene> model
+          = dynamics::MeshCache::load(_skelPath + uri);
       if (model)
-        newShape = new dynamics::MeshShape(scale, model);
+        newShape = new dynamics::MeshShape(scale, model, _skelPath + uri);
       else
         dterr << "Fail to load model[" << uri << "]." << std::endl;
     }
@@ -470,6 +488,36 @@ dynamics::Shape* SdfParser::readShape(tinyxml2::XMLElement* _shapelement,
     return newShape;
 }
 
+void SdfParser::readMeshFileNames(tinyxml2::XMLElement* _skeletonElement,
+                                  const std::string& _skelPath,
+                                  std::vector<std::string>& _fileNames)
+{
+  const char* shapeTypes[] = { "visual", "collision" };
+
+  ElementEnumerator bodies(_skeletonElement, "link");
+  while (bodies.next())
+  {
+    for (size_t i = 0; i < 2; ++i)
+    {
+      ElementEnumerator shapes(bodies.get(), shapeTypes[i]);
+      while (shapes.next())
+      {
+        tinyxml2::XMLElement* geometryElement
+            = getElement(shapes.get(), "geometry");
+        if (geometryElement == NULL || !hasElement(geometryElement, "mesh"))
+          continue;
+
+        tinyxml2::XMLElement* meshEle = getElement(geometryElement, "mesh");
+        if (!hasElement(meshEle, "uri"))
+          continue;
+
+        // Must match the path that readShape() passes to MeshCache
+        _fileNames.push_back(_skelPath + getValueString(meshEle, "uri"));
+      }
+    }
+  }
+}
+
 dynamics::Joint* SdfParser::readJoint(tinyxml2::XMLElement* _jointElement,
                             const std::vector<SDFBodyNode, Eigen::aligned_allocator<SDFBodyNode> >& _sdfBodyNodes,
                             const Eigen::Isometry3d& _skeletonFrame)
@@ -78,6 +78,14 @@ public:
             tinyxml2::XMLElement* _shapelement,
             const std::string& _skelPath);
 
+    /// \brief Append the paths of all the mesh files that the links of
+    /// _skeletonElement refer to, so that they can be loaded before the
+    /// Skeleton is built
+    static void readMeshFileNames(
+            tinyxml2::XMLElement* _skeletonElement,
+            const std::string& _skelPath,
+            std::vector<std::string>& _fileNames);
+
     /// \brief
     static dynamics::Joint* readJoint(
             tinyxml2::XMLElement* _jointElement,
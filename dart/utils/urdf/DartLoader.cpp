@@ -23,6 +23,7 @@
 #include "dart/dynamics/BoxShape.h"
 #include "dart/dynamics/EllipsoidShape.h"
 #include "dart/dynamics/CylinderShape.h"
+#include "dart/dynamics/MeshCache.h"
 #include "dart/dynamics/MeshShape.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/urdf/urdf_world_parser.h"
@@ -71,6 +72,12 @@ dynamics::Skeleton* DartLoader::parseSkeletonString(
   if(!skeletonModelPtr)
       return nullptr;
 
+  // Load all the meshes up front. They stay cached while the skeleton is built.
+  std::vector<std::string> meshFileNames;
+  readMeshFileNames(skeletonModelPtr->getRoot().get(), meshFileNames);
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = dynamics::MeshCache::loadAll(meshFileNames);
+
   return modelInterfaceToSkeleton(skeletonModelPtr.get());
 }
 
@@ -113,9 +120,29 @@ simulation::World* DartLoader::parseWorldString(
   // Store paths from world to entities
   parseWorldToEntityPaths(_urdfString);
 
+  // Load the meshes of all the models up front. They stay cached while the
+  // skeletons are built below.
+  std::vector<std::string> meshFileNames;
+  for(unsigned int i = 0; i < worldInterface->models.size(); ++i) {
+    const std::string& modelName = worldInterface->models[i].model->getName();
+    std::map<std::string, std::string>::const_iterator path
+        = mWorld_To_Entity_Paths.find(modelName);
+    if(path == mWorld_To_Entity_Paths.end()) {
+      dterr << "[DartLoader::parseWorldString] Could not find the file of "
+            << "model [" << modelName << "]. World is not loaded.\n";
+      return nullptr;
+    }
+
+    mRootToSkelPath = mRootToWorldPath + path->second;
+    readMeshFileNames(worldInterface->models[i].model->getRoot().get(), meshFileNames);
+  }
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = dynamics::MeshCache::loadAll(meshFileNames);
+
   simulation::World* world = new simulation::World();
 
   for(unsigned int i = 0; i < worldInterface->models.size(); ++i) {
+    // Every model was found in mWorld_To_Entity_Paths by the loop above
     mRootToSkelPath = mRootToWorldPath + mWorld_To_Entity_Paths.find(worldInterface->models[i].model->getName())->second;
     dynamics::Skeleton* skeleton = modelInterfaceToSkeleton(worldInterface->models[i].model.get());
 
@@ -284,6 +311,26 @@ dynamics::Skeleton* DartLoader::modelInterfaceToSkeleton(const urdf::ModelInterf
     return skeleton;
 }
 
+/**
+ * @function readMeshFileNames
+ * @brief Collect the full paths of the mesh files of _lk and its descendants
+ */
+void DartLoader::readMeshFileNames(const urdf::Link* _lk, std::vector<std::string>& _fileNames) const {
+  for(unsigned int i = 0; i < _lk->visual_array.size(); i++) {
+    if(urdf::Mesh* mesh = dynamic_cast<urdf::Mesh*>(_lk->visual_array[i]->geometry.get()))
+      _fileNames.push_back(getFullFilePath(mesh->filename));
+  }
+
+  for(unsigned int i = 0; i < _lk->collision_array.size(); i++) {
+    if(urdf::Mesh* mesh = dynamic_cast<urdf::Mesh*>(_lk->collision_array[i]->geometry.get()))
+      _fileNames.push_back(getFullFilePath(mesh->filename));
+  }
+
+  for(unsigned int i = 0; i < _lk->child_links.size(); i++) {
+    readMeshFileNames(_lk->child_links[i].get(), _fileNames);
+  }
+}
+
 void DartLoader::createSkeletonRecursive(dynamics::Skeleton* _skel, const urdf::Link* _lk, dynamics::BodyNode* _parentNode) {
   dynamics::BodyNode* node = createDartNode(_lk);
   dynamics::Joint* joint = createDartJoint(_lk->parent_joint.get());
@@ -464,7 +511,8 @@ dynamics::Shape* DartLoader::createShape(const VisualOrCollision* _vizOrCol)
   else if(urdf::Mesh* mesh = dynamic_cast<urdf::Mesh*>(_vizOrCol->geometry.get()))
   {
     std::string fullPath = getFullFilePath(mesh->filename);
-    const aiScene* model = dynamics::MeshShape::loadMesh( fullPath );
+    std::shared_ptr<const aiScene> model
+        = dynamics::MeshCache::load(fullPath);
     
     if(!model)
     {
@@ -474,7 +522,7 @@ dynamics::Shape* DartLoader::createShape(const VisualOrCollision* _vizOrCol)
     } 
     else
     {
-      shape = new dynamics::MeshShape(Eigen::Vector3d(mesh->scale.x, mesh->scale.y, mesh->scale.z), model);
+      shape = new dynamics::MeshShape(Eigen::Vector3d(mesh->scale.x, mesh->scale.y, mesh->scale.z), model, fullPath);
     }
   }
   // Unknown geometry type
@@ -9,6 +9,7 @@
 #include <Eigen/Geometry>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace urdf {
     class ModelInterface;
@@ -78,6 +79,7 @@ private:
     void parseWorldToEntityPaths(const std::string& _xml_string);
 
     dynamics::Skeleton* modelInterfaceToSkeleton(const urdf::ModelInterface* _model);
+    void readMeshFileNames(const urdf::Link* _lk, std::vector<std::string>& _fileNames) const;
     void createSkeletonRecursive(dynamics::Skeleton* _skel, const urdf::Link* _lk, dynamics::BodyNode* _parent);
 
     template <class VisualOrCollision>
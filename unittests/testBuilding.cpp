@@ -39,7 +39,12 @@
 #include "TestHelpers.h"
 
 #include "dart/math/Geometry.h"
+#include "dart/dynamics/BallJoint.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/FreeJoint.h"
+#include "dart/dynamics/Marker.h"
+#include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/Skeleton.h"
 #include "dart/simulation/World.h"
@@ -130,6 +135,167 @@ TEST(BUILDING, BASIC)
     delete world;
 }
 
+/******************************************************************************/
+TEST(BUILDING, STATE_VIEWS)
+{
+    Skeleton* skel = new Skeleton;
+
+    BodyNode* body1 = new BodyNode("body1");
+    FreeJoint* joint1 = new FreeJoint("joint1");
+    body1->setParentJoint(joint1);
+    skel->addBodyNode(body1);
+
+    BodyNode* body2 = new BodyNode("body2");
+    RevoluteJoint* joint2 = new RevoluteJoint(Eigen::Vector3d::UnitX(),
+                                              "joint2");
+    body2->setParentJoint(joint2);
+    body1->addChildBodyNode(body2);
+    skel->addBodyNode(body2);
+
+    // The state set before init() is kept
+    Eigen::Vector6d q1 = Eigen::Vector6d::Random();
+    joint1->setPositions(q1);
+    joint2->setPosition(0, 0.5);
+    joint2->setVelocity(0, -0.25);
+    skel->init();
+
+    Eigen::VectorXd q(7);
+    q << q1, 0.5;
+    EXPECT_TRUE(equals(Eigen::VectorXd(skel->getPositionsMap()), q));
+    EXPECT_EQ(skel->getVelocitiesMap()[6], -0.25);
+    EXPECT_EQ(skel->getStateMap().size(), 14);
+
+    // The joints view into the buffer of the Skeleton
+    q = Eigen::VectorXd::Random(7);
+    skel->setPositions(q);
+    EXPECT_TRUE(equals(joint1->getPositions(), Eigen::VectorXd(q.head<6>())));
+    EXPECT_EQ(joint2->getPosition(0), q[6]);
+    EXPECT_EQ(skel->getPositionsMap().data(), skel->getStateMap().data());
+
+    // A fixed-size view of the joint follows later changes
+    const auto positions1 = joint1->getPositionsStatic();
+    joint1->setPositions(Eigen::Vector6d::Ones());
+    EXPECT_TRUE(equals(Eigen::VectorXd(positions1),
+                       Eigen::VectorXd(Eigen::Vector6d::Ones())));
+
+    // Writing through a view is noticed at the end of the batch
+    Eigen::Isometry3d T = body2->getTransform();
+    skel->beginStateUpdate();
+    skel->getMutablePositionsMap()[6] += 1.0;
+    skel->getMutableForcesMap().setConstant(2.0);
+    skel->endStateUpdate();
+    EXPECT_EQ(joint2->getPosition(0), q[6] + 1.0);
+    EXPECT_EQ(joint2->getForce(0), 2.0);
+    EXPECT_FALSE(equals(T.matrix(), body2->getTransform().matrix()));
+
+    // Initializing again keeps the state
+    BodyNode* body3 = new BodyNode("body3");
+    RevoluteJoint* joint3 = new RevoluteJoint(Eigen::Vector3d::UnitY(),
+                                              "joint3");
+    joint3->setPosition(0, 0.125);
+    body3->setParentJoint(joint3);
+    body2->addChildBodyNode(body3);
+    skel->addBodyNode(body3);
+    skel->init();
+
+    EXPECT_EQ(skel->getNumDofs(), 8u);
+    EXPECT_EQ(skel->getPosition(6), q[6] + 1.0);
+    EXPECT_EQ(skel->getPosition(7), 0.125);
+
+    delete skel;
+}
+
+/******************************************************************************/
+TEST(BUILDING, CLONE)
+{
+    Skeleton* skel = new Skeleton("original");
+
+    BodyNode* body1 = new BodyNode("body1");
+    FreeJoint* joint1 = new FreeJoint("joint1");
+    body1->setParentJoint(joint1);
+    body1->setMass(2.0);
+    body1->addVisualizationShape(new BoxShape(Eigen::Vector3d(0.1, 0.2, 0.3)));
+    skel->addBodyNode(body1);
+
+    BodyNode* body2 = new BodyNode("body2");
+    RevoluteJoint* joint2 = new RevoluteJoint(Eigen::Vector3d::UnitY(),
+                                              "joint2");
+    Eigen::Isometry3d T = Eigen::Isometry3d::Identity();
+    T.translation() = Eigen::Vector3d(0.0, 0.0, 0.5);
+    joint2->setTransformFromParentBodyNode(T);
+    joint2->setSpringStiffness(0, 3.0);
+    joint2->setPositionUpperLimit(0, 1.5);
+    MeshShape* mesh = new MeshShape(Eigen::Vector3d::Ones(), new aiScene);
+    body2->setParentJoint(joint2);
+    body2->setLocalCOM(Eigen::Vector3d(0.0, 0.0, 0.25));
+    body2->addVisualizationShape(mesh);
+    body2->addCollisionShape(mesh);
+    body2->addMarker(new Marker("marker", Eigen::Vector3d::UnitX(), body2));
+    body1->addChildBodyNode(body2);
+    skel->addBodyNode(body2);
+
+    BodyNode* body3 = new BodyNode("body3");
+    BallJoint* joint3 = new BallJoint("joint3");
+    joint3->setTransformFromParentBodyNode(T);
+    body3->setParentJoint(joint3);
+    body2->addChildBodyNode(body3);
+    skel->addBodyNode(body3);
+
+    skel->init();
+    skel->setPositions(Eigen::VectorXd::Random(skel->getNumDofs()));
+    skel->setVelocities(Eigen::VectorXd::Random(skel->getNumDofs()));
+    skel->setForces(Eigen::VectorXd::Random(skel->getNumDofs()));
+
+    Skeleton* clone = skel->clone();
+
+    EXPECT_EQ(clone->getName(), skel->getName());
+    EXPECT_EQ(clone->getNumBodyNodes(), skel->getNumBodyNodes());
+    EXPECT_EQ(clone->getNumDofs(), skel->getNumDofs());
+    EXPECT_TRUE(equals(clone->getPositions(), skel->getPositions()));
+    EXPECT_TRUE(equals(clone->getVelocities(), skel->getVelocities()));
+    EXPECT_TRUE(equals(clone->getForces(), skel->getForces()));
+    EXPECT_TRUE(equals(clone->getMassMatrix(), skel->getMassMatrix()));
+
+    for (size_t i = 0; i < skel->getNumBodyNodes(); ++i)
+    {
+        BodyNode* body = skel->getBodyNode(i);
+        BodyNode* clonedBody = clone->getBodyNode(i);
+        EXPECT_NE(body, clonedBody);
+        EXPECT_EQ(clonedBody->getName(), body->getName());
+        EXPECT_EQ(clonedBody->getParentJoint()->getName(),
+                  body->getParentJoint()->getName());
+        EXPECT_TRUE(equals(clonedBody->getTransform().matrix(),
+                           body->getTransform().matrix()));
+        EXPECT_TRUE(equals(clonedBody->getBodyVelocity(),
+                           body->getBodyVelocity()));
+    }
+
+    Joint* clonedJoint2 = clone->getJoint("joint2");
+    EXPECT_EQ(clonedJoint2->getSpringStiffness(0), 3.0);
+    EXPECT_EQ(clonedJoint2->getPositionUpperLimit(0), 1.5);
+    EXPECT_EQ(clone->getBodyNode("body2")->getNumMarkers(), 1u);
+
+    // The shapes are copied, but the mesh data is shared
+    BodyNode* clonedBody2 = clone->getBodyNode("body2");
+    MeshShape* clonedMesh
+        = dynamic_cast<MeshShape*>(clonedBody2->getVisualizationShape(0));
+    ASSERT_TRUE(clonedMesh != NULL);
+    EXPECT_NE(clonedMesh, mesh);
+    EXPECT_EQ(clonedMesh->getMesh(), mesh->getMesh());
+    EXPECT_EQ(clonedBody2->getCollisionShape(0), clonedMesh);
+    EXPECT_EQ(mesh->getSharedMesh().use_count(), 2);
+
+    // The copies are independent
+    clone->setPosition(6, clone->getPosition(6) + 1.0);
+    EXPECT_FALSE(equals(clone->getPositions(), skel->getPositions()));
+
+    delete skel;
+    EXPECT_EQ(clonedMesh->getSharedMesh().use_count(), 1);
+    EXPECT_EQ(clone->getNumBodyNodes(), 3u);
+
+    delete clone;
+}
+
 /******************************************************************************/
 int main(int argc, char* argv[])
 {
@@ -45,6 +45,10 @@
 #include "dart/common/common.h"
 #include "dart/math/math.h"
 #include "dart/dynamics/dynamics.h"
+#include "dart/collision/fcl/FCLCollisionDetector.h"
+#include "dart/collision/RangeSensor.h"
+#include "dart/collision/SelfCollisionSampler.h"
+#include "dart/collision/dart/DARTCollide.h"
 //#include "dart/collision/unc/UNCCollisionDetector.h"
 #include "dart/simulation/simulation.h"
 #include "dart/utils/utils.h"
@@ -586,6 +590,775 @@ TEST_F(COLLISION, CollisionOfPrescribedJoints)
   }
 }
 
+//==============================================================================
+size_t countCollidingPairs(collision::CollisionDetector* _detector,
+                           BodyNode* _bodyNode1, BodyNode* _bodyNode2)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < _detector->getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = _detector->getContact(i);
+    if ((contact.bodyNode1 == _bodyNode1 && contact.bodyNode2 == _bodyNode2)
+        || (contact.bodyNode1 == _bodyNode2 && contact.bodyNode2 == _bodyNode1))
+      ++count;
+  }
+  return count;
+}
+
+//==============================================================================
+TEST_F(COLLISION, Filtering)
+{
+  // Overlapping boxes, each in its own skeleton
+  const size_t numBodies = 4;
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::DARTCollisionDetector detector;
+  for (size_t i = 0; i < numBodies; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    body->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skel->setPosition(5, 0.1 * i);
+    skel->computeForwardKinematics(true, false, false);
+    detector.addSkeleton(skel);
+    skels.push_back(skel);
+    bodies.push_back(body);
+  }
+
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[1], bodies[2]), 0u);
+
+  // Category and mask have to match both ways
+  bodies[0]->setCollisionCategory(2u);
+  bodies[1]->setCollisionMask(~2u);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[2]), 0u);
+  bodies[1]->setCollisionMask(0xFFFFFFFFu);
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+
+  // A body without any mask collides with nothing
+  bodies[3]->setCollisionMask(0u);
+  detector.detectCollision(true, true);
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_EQ(countCollidingPairs(&detector, bodies[i], bodies[3]), 0u);
+
+  // Disabled pairs survive the removal of other bodies
+  detector.disablePair(bodies[1], bodies[2]);
+  detector.removeSkeleton(skels[0]);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[1], bodies[2]), 0u);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  detector.enablePair(bodies[1], bodies[2]);
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[1], bodies[2]), 0u);
+
+  // Disabled pairs of a removed body are forgotten
+  detector.addSkeleton(skels[0]);
+  detector.disablePair(bodies[0], bodies[1]);
+  detector.removeSkeleton(skels[0]);
+  detector.addSkeleton(skels[0]);
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+
+  detector.removeAllSkeletons();
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 0u);
+
+  for (size_t i = 0; i < numBodies; ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+TEST_F(COLLISION, FCLBroadphase)
+{
+  // Boxes 0 and 1 overlap, box 2 is far away from both
+  const size_t numBodies = 3;
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::FCLCollisionDetector detector;
+  for (size_t i = 0; i < numBodies; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    body->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skel->setPosition(5, i < 2 ? 0.5 * i : 10.0);
+    detector.addSkeleton(skel);
+    skels.push_back(skel);
+    bodies.push_back(body);
+  }
+
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[2]), 0u);
+  EXPECT_TRUE(bodies[0]->isColliding());
+  EXPECT_FALSE(bodies[2]->isColliding());
+
+  // Moved bodies are refitted in the tree
+  skels[2]->setPosition(5, 0.9);
+  skels[0]->setPosition(5, -10.0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[1], bodies[2]), 0u);
+
+  // Filtering applies to the pairs reported by the broadphase
+  detector.disablePair(bodies[1], bodies[2]);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 0u);
+  detector.enablePair(bodies[1], bodies[2]);
+
+  // Removed bodies leave the tree
+  detector.removeSkeleton(skels[1]);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 0u);
+
+  detector.removeAllSkeletons();
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 0u);
+
+  for (size_t i = 0; i < numBodies; ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+/// Triangle mesh of a box of the given size centered at the origin
+static aiScene* createBoxScene(const Eigen::Vector3d& _size)
+{
+  aiScene* scene = new aiScene;
+  scene->mNumMeshes = 1;
+  scene->mMeshes = new aiMesh*[1];
+  aiMesh* mesh = new aiMesh;
+  scene->mMeshes[0] = mesh;
+
+  mesh->mNumVertices = 8;
+  mesh->mVertices = new aiVector3D[8];
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    mesh->mVertices[i].Set((i & 1) ? 0.5 * _size[0] : -0.5 * _size[0],
+                           (i & 2) ? 0.5 * _size[1] : -0.5 * _size[1],
+                           (i & 4) ? 0.5 * _size[2] : -0.5 * _size[2]);
+  }
+
+  // Two counterclockwise triangles for each side
+  const unsigned int quads[6][4] = {
+    {0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+    {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  mesh->mNumFaces = 12;
+  mesh->mFaces = new aiFace[12];
+  for (unsigned int i = 0; i < 6; ++i)
+  {
+    for (unsigned int j = 0; j < 2; ++j)
+    {
+      aiFace& face = mesh->mFaces[2 * i + j];
+      face.mNumIndices = 3;
+      face.mIndices = new unsigned int[3];
+      face.mIndices[0] = quads[i][0];
+      face.mIndices[1] = quads[i][j + 1];
+      face.mIndices[2] = quads[i][j + 2];
+    }
+  }
+
+  return scene;
+}
+
+//==============================================================================
+TEST_F(COLLISION, ConvexMeshes)
+{
+  // A unit mesh cube resting on a wide box, with a second mesh cube and a
+  // sphere dropped onto it
+  const Eigen::Vector3d sizes[3] = {
+    Eigen::Vector3d(4.0, 4.0, 0.2), Eigen::Vector3d::Ones(),
+    Eigen::Vector3d::Ones()};
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::DARTCollisionDetector detector;
+  EXPECT_FALSE(detector.isConvexMeshCollision());
+  detector.setConvexMeshCollision(true);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    if (i == 0)
+      body->addCollisionShape(new BoxShape(sizes[0]));
+    else if (i < 3)
+      body->addCollisionShape(new MeshShape(Eigen::Vector3d::Ones(),
+                                            createBoxScene(sizes[i])));
+    else
+      body->addCollisionShape(new EllipsoidShape(Eigen::Vector3d::Ones()));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skels.push_back(skel);
+    bodies.push_back(body);
+  }
+
+  // The cube sinks 0.01 into the ground
+  skels[1]->setPosition(5, 0.59);
+  skels[2]->setPosition(5, 10.0);
+  skels[3]->setPosition(5, -10.0);
+  for (size_t i = 0; i < skels.size(); ++i)
+    detector.addSkeleton(skels[i]);
+
+  const MeshShape* mesh
+      = static_cast<const MeshShape*>(bodies[1]->getCollisionShape(0));
+  ASSERT_EQ(mesh->getConvexDecomposition().size(), 1u);
+  EXPECT_EQ(mesh->getConvexDecomposition()[0].getVertices().size(), 8u);
+
+  // MeshShapes with the same mesh data and scale share the decomposition
+  MeshShape sameMesh(Eigen::Vector3d::Ones(), mesh->getSharedMesh());
+  EXPECT_EQ(&sameMesh.getConvexDecomposition(),
+            &mesh->getConvexDecomposition());
+
+  // Each corner of the bottom face is a contact
+  detector.detectCollision(true, true);
+  ASSERT_EQ(detector.getNumContacts(), 4u);
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector.getContact(i);
+    const double sign = (contact.bodyNode1 == bodies[1]) ? 1.0 : -1.0;
+    EXPECT_NEAR(sign * contact.normal[2], 1.0, 1e-6);
+    EXPECT_NEAR(contact.penetrationDepth, 0.01, 1e-6);
+    EXPECT_NEAR(std::abs(contact.point[0]), 0.5, 1e-6);
+    EXPECT_NEAR(std::abs(contact.point[1]), 0.5, 1e-6);
+  }
+
+  // Mesh on mesh, rotated about the vertical axis
+  skels[2]->setPosition(2, 0.3);
+  skels[2]->setPosition(5, 1.54);
+  detector.detectCollision(true, true);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[1], bodies[2]), 0u);
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector.getContact(i);
+    if (contact.bodyNode1 != bodies[2] && contact.bodyNode2 != bodies[2])
+      continue;
+    const double sign = (contact.bodyNode1 == bodies[2]) ? 1.0 : -1.0;
+    EXPECT_NEAR(sign * contact.normal[2], 1.0, 1e-6);
+    EXPECT_NEAR(contact.penetrationDepth, 0.05, 1e-6);
+  }
+
+  // Sphere against the side of the mesh cube
+  skels[2]->setPosition(5, 10.0);
+  skels[3]->setPosition(3, 0.9);
+  skels[3]->setPosition(5, 0.7);
+  detector.detectCollision(true, true);
+  ASSERT_EQ(countCollidingPairs(&detector, bodies[1], bodies[3]), 1u);
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector.getContact(i);
+    if (contact.bodyNode1 != bodies[3] && contact.bodyNode2 != bodies[3])
+      continue;
+    const double sign = (contact.bodyNode1 == bodies[3]) ? 1.0 : -1.0;
+    EXPECT_NEAR(sign * contact.normal[0], 1.0, 1e-4);
+    EXPECT_NEAR(contact.penetrationDepth, 0.1, 1e-4);
+  }
+
+  // Meshes are ignored unless convex mesh collision is on
+  detector.setConvexMeshCollision(false);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[1]), 0u);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[1], bodies[3]), 0u);
+
+  // Each corner of the bottom face below a plane is a contact
+  PlaneShape plane(Eigen::Vector3d::UnitZ(), 0.2);
+  std::vector<collision::Contact> contacts;
+  EXPECT_EQ(collision::collide(mesh, bodies[1]->getTransform(),
+                               &plane, Eigen::Isometry3d::Identity(),
+                               &contacts), 4);
+  for (size_t i = 0; i < contacts.size(); ++i)
+  {
+    EXPECT_NEAR(contacts[i].normal[2], 1.0, 1e-6);
+    EXPECT_NEAR(contacts[i].penetrationDepth, 0.11, 1e-6);
+  }
+
+  detector.removeAllSkeletons();
+  for (size_t i = 0; i < skels.size(); ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+TEST_F(COLLISION, Heightmap)
+{
+  // Terrain sloping up along x with a gradient of 0.1
+  std::vector<float> heights(11 * 11);
+  for (size_t r = 0; r < 11; ++r)
+    for (size_t c = 0; c < 11; ++c)
+      heights[r * 11 + c] = 0.05f * c;
+  HeightmapShape slope(11, 11, heights, Eigen::Vector3d(0.5, 0.5, 1.0));
+  EXPECT_NEAR(slope.getMinHeight(), 0.0, 1e-6);
+  EXPECT_NEAR(slope.getMaxHeight(), 0.5, 1e-6);
+  EXPECT_NEAR(slope.getVertex(0, 0)[0], -2.5, 1e-12);
+  EXPECT_NEAR(slope.getVertex(10, 10)[1], 2.5, 1e-12);
+
+  double height;
+  Eigen::Vector3d normal;
+  ASSERT_TRUE(slope.computeHeight(1.0, 0.3, &height, &normal));
+  EXPECT_NEAR(height, 0.35, 1e-6);
+  EXPECT_TRUE(equals(normal,
+                     Eigen::Vector3d(Eigen::Vector3d(-0.1, 0.0, 1.0)
+                                     .normalized()), 1e-6));
+  EXPECT_FALSE(slope.computeHeight(3.0, 0.0, &height));
+
+  size_t rowBegin, colBegin, rowEnd, colEnd;
+  ASSERT_TRUE(slope.getCellRange(Eigen::Vector2d(-0.2, 0.7),
+                                 Eigen::Vector2d(0.6, 0.8),
+                                 &rowBegin, &colBegin, &rowEnd, &colEnd));
+  EXPECT_EQ(rowBegin, 6u);
+  EXPECT_EQ(rowEnd, 7u);
+  EXPECT_EQ(colBegin, 4u);
+  EXPECT_EQ(colEnd, 7u);
+
+  // A flat terrain with a box, a sphere and a cylinder resting on it
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::DARTCollisionDetector detector;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    if (i == 0)
+      body->addCollisionShape(new HeightmapShape(
+          11, 11, std::vector<float>(11 * 11, 0.0f),
+          Eigen::Vector3d(0.5, 0.5, 1.0)));
+    else if (i == 1)
+      body->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+    else if (i == 2)
+      body->addCollisionShape(new EllipsoidShape(Eigen::Vector3d::Ones()));
+    else
+      body->addCollisionShape(new CylinderShape(0.3, 1.0));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skels.push_back(skel);
+    bodies.push_back(body);
+  }
+
+  skels[1]->setPosition(5, 0.49);
+  skels[2]->setPosition(3, 1.6);
+  skels[2]->setPosition(5, 0.45);
+  skels[3]->setPosition(3, -1.6);
+  skels[3]->setPosition(5, 0.48);
+  for (size_t i = 0; i < skels.size(); ++i)
+    detector.addSkeleton(skels[i]);
+
+  const double depths[4] = {0.0, 0.01, 0.05, 0.02};
+  detector.detectCollision(true, true);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[1]), 4u);
+  EXPECT_EQ(countCollidingPairs(&detector, bodies[0], bodies[2]), 1u);
+  EXPECT_GT(countCollidingPairs(&detector, bodies[0], bodies[3]), 0u);
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector.getContact(i);
+    BodyNode* body = (contact.bodyNode1 == bodies[0]) ? contact.bodyNode2
+                                                      : contact.bodyNode1;
+    const double sign = (contact.bodyNode1 == body) ? 1.0 : -1.0;
+    EXPECT_NEAR(sign * contact.normal[2], 1.0, 1e-6);
+    for (size_t j = 1; j < 4; ++j)
+    {
+      if (body == bodies[j])
+        EXPECT_NEAR(contact.penetrationDepth, depths[j], 1e-6);
+    }
+  }
+
+  // Nothing touches once the bodies are lifted above the terrain
+  for (size_t i = 1; i < skels.size(); ++i)
+    skels[i]->setPosition(5, 1.0);
+  detector.detectCollision(true, true);
+  EXPECT_EQ(detector.getNumContacts(), 0u);
+
+  detector.removeAllSkeletons();
+  for (size_t i = 0; i < skels.size(); ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+TEST_F(COLLISION, RayCast)
+{
+  // A ground plane with a box, a sphere, a cylinder and a mesh cube around
+  // the origin, and a sloped heightmap farther away
+  std::vector<float> heights(11 * 11);
+  for (size_t r = 0; r < 11; ++r)
+    for (size_t c = 0; c < 11; ++c)
+      heights[r * 11 + c] = 0.05f * c;
+
+  const Eigen::Vector3d positions[6] = {
+    Eigen::Vector3d::Zero(), Eigen::Vector3d(2.0, 0.0, 0.5),
+    Eigen::Vector3d(0.0, 2.0, 0.5), Eigen::Vector3d(-2.0, 0.0, 0.5),
+    Eigen::Vector3d(0.0, -2.0, 0.5), Eigen::Vector3d(10.0, 10.0, 0.0)};
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::RayCaster caster;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    if (i == 0)
+      body->addCollisionShape(new PlaneShape(Eigen::Vector3d::UnitZ(), 0.0));
+    else if (i == 1)
+      body->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+    else if (i == 2)
+      body->addCollisionShape(new EllipsoidShape(Eigen::Vector3d::Ones()));
+    else if (i == 3)
+      body->addCollisionShape(new CylinderShape(0.3, 1.0));
+    else if (i == 4)
+      body->addCollisionShape(new MeshShape(
+          Eigen::Vector3d::Ones(), createBoxScene(Eigen::Vector3d::Ones())));
+    else
+      body->addCollisionShape(new HeightmapShape(
+          11, 11, heights, Eigen::Vector3d(0.5, 0.5, 1.0)));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skel->setPositions(
+        (Eigen::VectorXd(6) << Eigen::Vector3d::Zero(), positions[i])
+        .finished());
+    skels.push_back(skel);
+    bodies.push_back(body);
+    caster.addSkeleton(skel);
+  }
+  caster.update();
+
+  const double inf = std::numeric_limits<double>::infinity();
+  const Eigen::Vector3d center(0.0, 0.0, 0.5);
+  std::vector<collision::Ray> rays;
+  rays.push_back({center, Eigen::Vector3d::UnitX(), inf});
+  rays.push_back({center, Eigen::Vector3d::UnitY(), inf});
+  rays.push_back({center, -Eigen::Vector3d::UnitX(), inf});
+  rays.push_back({center, -Eigen::Vector3d::UnitY(), inf});
+  rays.push_back({center, -Eigen::Vector3d::UnitZ(), inf});
+  rays.push_back({Eigen::Vector3d(11.0, 10.3, 5.0), -Eigen::Vector3d::UnitZ(),
+                  inf});
+  rays.push_back({center, Eigen::Vector3d::UnitZ(), inf});
+  rays.push_back({center, Eigen::Vector3d::UnitX(), 1.0});
+
+  const double distances[8] = {1.5, 1.5, 1.7, 1.5, 0.5, 4.65, inf, inf};
+  BodyNode* hitBodies[8] = {bodies[1], bodies[2], bodies[3], bodies[4],
+                            bodies[0], bodies[5], NULL, NULL};
+  const Eigen::Vector3d normals[6] = {
+    -Eigen::Vector3d::UnitX(), -Eigen::Vector3d::UnitY(),
+    Eigen::Vector3d::UnitX(), Eigen::Vector3d::UnitY(),
+    Eigen::Vector3d::UnitZ(), Eigen::Vector3d(-0.1, 0.0, 1.0).normalized()};
+
+  // Serial and parallel batches match single rays
+  for (int parallel = 0; parallel < 2; ++parallel)
+  {
+    caster.setParallel(parallel == 1);
+    std::vector<collision::RayHit> hits;
+    EXPECT_EQ(caster.castRays(rays, &hits), 6u);
+    ASSERT_EQ(hits.size(), rays.size());
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+      collision::RayHit hit;
+      EXPECT_EQ(caster.castRay(rays[i], &hit), hitBodies[i] != NULL);
+      EXPECT_EQ(hit.bodyNode, hits[i].bodyNode);
+      EXPECT_EQ(hits[i].bodyNode, hitBodies[i]);
+      if (i < 6)
+      {
+        EXPECT_NEAR(hits[i].distance, distances[i], 1e-6);
+        EXPECT_TRUE(equals(hits[i].normal, normals[i], 1e-6));
+      }
+      else
+      {
+        EXPECT_EQ(hits[i].distance, inf);
+      }
+    }
+  }
+
+  // The box is no longer seen when its category is masked out
+  bodies[1]->setCollisionCategory(0x2);
+  collision::RayHit hit;
+  EXPECT_FALSE(caster.castRay(rays[0], &hit, ~0x2u));
+  EXPECT_TRUE(caster.castRay(rays[0], &hit, 0x2u));
+
+  // Moving bodies takes effect at the next update
+  skels[1]->setPosition(3, 3.0);
+  caster.update();
+  EXPECT_TRUE(caster.castRay(rays[0], &hit));
+  EXPECT_NEAR(hit.distance, 2.5, 1e-6);
+
+  // A full circle of lidar rays sees the objects around it
+  collision::Lidar lidar(360, 1, 2.0 * DART_PI, 0.0, 10.0);
+  const size_t numHits
+      = lidar.scan(caster, Eigen::Isometry3d(Eigen::Translation3d(center)));
+  EXPECT_GT(numHits, 0u);
+  EXPECT_EQ(numHits, static_cast<size_t>(
+              (lidar.getRanges().array() < inf).count()));
+  EXPECT_NEAR(lidar.getRanges()(0, 180), 2.5, 1e-6);
+  EXPECT_NEAR(lidar.getRanges()(0, 270), 1.5, 1e-6);
+  EXPECT_NEAR(lidar.getRanges()(0, 0), 1.7, 1e-6);
+  EXPECT_NEAR(lidar.getRanges()(0, 90), 1.5, 1e-6);
+
+  // A depth camera looking down on the floor sees a flat depth image
+  collision::DepthCamera camera(32, 24, 0.5, 10.0);
+  Eigen::Isometry3d cameraTransform = Eigen::Isometry3d::Identity();
+  cameraTransform.translation() = Eigen::Vector3d(0.0, 0.0, 3.0);
+  cameraTransform.linear()
+      = Eigen::AngleAxisd(DART_PI, Eigen::Vector3d::UnitX()).matrix();
+  EXPECT_EQ(camera.scan(caster, cameraTransform), 32u * 24u);
+  EXPECT_EQ(camera.getRanges().rows(), 24);
+  EXPECT_EQ(camera.getRanges().cols(), 32);
+  EXPECT_NEAR(camera.getRanges().minCoeff(), 3.0, 1e-9);
+  EXPECT_NEAR(camera.getRanges().maxCoeff(), 3.0, 1e-9);
+
+  caster.removeAllSkeletons();
+  for (size_t i = 0; i < skels.size(); ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+TEST_F(COLLISION, Distance)
+{
+  BoxShape box(Eigen::Vector3d::Ones());
+  EllipsoidShape sphere(Eigen::Vector3d::Ones());
+  PlaneShape plane(Eigen::Vector3d::UnitZ(), 0.0);
+  MeshShape mesh(Eigen::Vector3d::Ones(),
+                 createBoxScene(Eigen::Vector3d::Ones()));
+
+  const Eigen::Isometry3d identity = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d T = Eigen::Isometry3d::Identity();
+  Eigen::Vector3d point0;
+  Eigen::Vector3d point1;
+  std::vector<Eigen::Vector3d> directions;
+
+  // Separated boxes, with the closest points on the facing sides
+  T.translation() = Eigen::Vector3d(3.0, 0.2, 0.0);
+  EXPECT_NEAR(collision::computeDistance(&box, identity, &box, T,
+                                         &point0, &point1, &directions),
+              2.0, 1e-6);
+  EXPECT_NEAR(point0[0], 0.5, 1e-6);
+  EXPECT_NEAR(point1[0], 2.5, 1e-6);
+  ASSERT_EQ(directions.size(), 1u);
+  EXPECT_FALSE(directions[0].isZero());
+
+  // The cached direction warm-starts the next query
+  T.translation() = Eigen::Vector3d(3.1, 0.2, 0.0);
+  EXPECT_NEAR(collision::computeDistance(&box, identity, &box, T,
+                                         &point0, &point1, &directions),
+              2.1, 1e-6);
+
+  // The query stops early beyond the threshold
+  EXPECT_GT(collision::computeDistance(&box, identity, &box, T,
+                                       &point0, &point1, NULL, 0.5),
+            0.5);
+
+  // A small ball above a large, thin box, whose support points are far from
+  // the closest points
+  EllipsoidShape ball(Eigen::Vector3d::Constant(0.1));
+  BoxShape shelf(Eigen::Vector3d(20.0, 20.0, 0.02));
+  directions.clear();
+  const double heights[3] = {0.309, 0.1071, 0.2};
+  for (int i = 0; i < 3; ++i)
+  {
+    T.translation() = Eigen::Vector3d(0.0, 0.0, heights[i]);
+    const double distance = collision::computeDistance(
+          &ball, T, &shelf, identity, &point0, &point1, &directions, 0.2);
+    if (i == 0)
+      EXPECT_GT(distance, 0.2);
+    else
+      EXPECT_NEAR(distance, heights[i] - 0.06, 1e-6);
+  }
+
+  // Penetrating boxes have a negative distance
+  T.translation() = Eigen::Vector3d(0.8, 0.0, 0.0);
+  EXPECT_NEAR(collision::computeDistance(&box, identity, &box, T,
+                                         &point0, &point1),
+              -0.2, 1e-6);
+
+  // Spheres
+  T.translation() = Eigen::Vector3d(0.0, 2.0, 0.0);
+  EXPECT_NEAR(collision::computeDistance(&sphere, identity, &sphere, T,
+                                         &point0, &point1),
+              1.0, 1e-6);
+  EXPECT_TRUE(equals(point0, Eigen::Vector3d(0.0, 0.5, 0.0), 1e-4));
+  EXPECT_TRUE(equals(point1, Eigen::Vector3d(0.0, 1.5, 0.0), 1e-4));
+
+  // A box above the ground plane, in both orders
+  T.translation() = Eigen::Vector3d(0.0, 0.0, 1.0);
+  EXPECT_NEAR(collision::computeDistance(&box, T, &plane, identity,
+                                         &point0, &point1),
+              0.5, 1e-9);
+  EXPECT_NEAR(point1[2], 0.0, 1e-9);
+  EXPECT_NEAR(collision::computeDistance(&plane, identity, &box, T,
+                                         &point0, &point1),
+              0.5, 1e-9);
+  EXPECT_NEAR(point0[2], 0.0, 1e-9);
+
+  // A mesh cube and a box
+  T.translation() = Eigen::Vector3d(0.0, 0.0, 2.0);
+  EXPECT_NEAR(collision::computeDistance(&mesh, identity, &box, T,
+                                         &point0, &point1),
+              1.0, 1e-6);
+
+  // A robot box among a box and a sphere
+  const Eigen::Vector3d positions[3] = {
+    Eigen::Vector3d::Zero(), Eigen::Vector3d(3.0, 0.0, 0.0),
+    Eigen::Vector3d(0.0, 2.5, 0.0)};
+  std::vector<Skeleton*> skels;
+  std::vector<BodyNode*> bodies;
+  collision::DARTCollisionDetector detector;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    Skeleton* skel = new Skeleton;
+    BodyNode* body = new BodyNode;
+    if (i < 2)
+      body->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+    else
+      body->addCollisionShape(new EllipsoidShape(Eigen::Vector3d::Ones()));
+    body->setParentJoint(new FreeJoint);
+    skel->addBodyNode(body);
+    skel->init();
+    skel->setPositions(
+        (Eigen::VectorXd(6) << Eigen::Vector3d::Zero(), positions[i])
+        .finished());
+    skels.push_back(skel);
+    bodies.push_back(body);
+    detector.addSkeleton(skel);
+  }
+
+  collision::DistanceResult result;
+  EXPECT_NEAR(detector.computeDistance(bodies[0], bodies[1], &result), 2.0,
+              1e-6);
+  EXPECT_EQ(result.bodyNode1, bodies[0]);
+  EXPECT_EQ(result.bodyNode2, bodies[1]);
+
+  EXPECT_NEAR(detector.computeDistance(skels[0], &result), 1.5, 1e-6);
+  EXPECT_EQ(result.bodyNode1, bodies[0]);
+  EXPECT_EQ(result.bodyNode2, bodies[2]);
+  EXPECT_EQ(result.shape2, bodies[2]->getCollisionShape(0));
+  EXPECT_NEAR(result.point1[1], 0.5, 1e-4);
+  EXPECT_NEAR(result.point2[1], 2.0, 1e-4);
+  EXPECT_GT(detector.computeDistance(skels[0], &result, 1.0), 1.0);
+
+  // Moving the sphere closer
+  skels[2]->setPosition(4, 1.2);
+  skels[2]->computeForwardKinematics(true, false, false);
+  EXPECT_NEAR(detector.computeDistance(skels[0], &result), 0.2, 1e-6);
+
+  // Bodies that may not collide are left out
+  bodies[2]->setCollisionCategory(0x2);
+  bodies[0]->setCollisionMask(~0x2u);
+  EXPECT_NEAR(detector.computeDistance(skels[0], &result), 2.0, 1e-6);
+  EXPECT_EQ(result.bodyNode2, bodies[1]);
+
+  detector.removeAllSkeletons();
+  for (size_t i = 0; i < skels.size(); ++i)
+    delete skels[i];
+}
+
+//==============================================================================
+TEST_F(COLLISION, SelfCollisionSampler)
+{
+  // A fixed base with a spinning hub, an arm that sweeps around the hub and
+  // sometimes hits the base, and a body welded far away from the others
+  Skeleton* skel = new Skeleton("spinner");
+
+  BodyNode* base = new BodyNode("base");
+  base->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+  base->setParentJoint(new WeldJoint("base"));
+  skel->addBodyNode(base);
+
+  BodyNode* hub = new BodyNode("hub");
+  hub->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+  RevoluteJoint* hubJoint = new RevoluteJoint(Eigen::Vector3d::UnitZ(),
+                                               "hub");
+  Eigen::Isometry3d T = Eigen::Isometry3d::Identity();
+  T.translation() = Eigen::Vector3d(0.8, 0.0, 0.0);
+  hubJoint->setTransformFromParentBodyNode(T);
+  hub->setParentJoint(hubJoint);
+  base->addChildBodyNode(hub);
+  skel->addBodyNode(hub);
+
+  BodyNode* arm = new BodyNode("arm");
+  BoxShape* armShape = new BoxShape(Eigen::Vector3d(1.0, 0.2, 0.2));
+  T.translation() = Eigen::Vector3d(1.5, 0.0, 0.0);
+  armShape->setLocalTransform(T);
+  arm->addCollisionShape(armShape);
+  arm->setParentJoint(new RevoluteJoint(Eigen::Vector3d::UnitZ(), "arm"));
+  hub->addChildBodyNode(arm);
+  skel->addBodyNode(arm);
+
+  BodyNode* remote = new BodyNode("remote");
+  remote->addCollisionShape(new BoxShape(Eigen::Vector3d::Ones()));
+  WeldJoint* remoteJoint = new WeldJoint("remote");
+  T.translation() = Eigen::Vector3d(-10.0, 0.0, 0.0);
+  remoteJoint->setTransformFromParentBodyNode(T);
+  remote->setParentJoint(remoteJoint);
+  base->addChildBodyNode(remote);
+  skel->addBodyNode(remote);
+
+  skel->init();
+  skel->enableSelfCollision(true);
+
+  collision::SelfCollisionSampler sampler(skel);
+  sampler.setNumSamples(500);
+  EXPECT_EQ(sampler.sample(), 6u);
+  EXPECT_EQ(sampler.getNumPairs(collision::SELF_COLLISION_ALWAYS), 1u);
+  EXPECT_EQ(sampler.getNumPairs(collision::SELF_COLLISION_SOMETIMES), 1u);
+  EXPECT_EQ(sampler.getNumPairs(collision::SELF_COLLISION_NEVER), 4u);
+
+  const std::vector<collision::SelfCollisionPair>& pairs = sampler.getPairs();
+  for (size_t i = 0; i < pairs.size(); ++i)
+  {
+    if (pairs[i].type == collision::SELF_COLLISION_ALWAYS)
+    {
+      EXPECT_EQ(pairs[i].bodyNode1, base);
+      EXPECT_EQ(pairs[i].bodyNode2, hub);
+    }
+    else if (pairs[i].type == collision::SELF_COLLISION_SOMETIMES)
+    {
+      EXPECT_EQ(pairs[i].bodyNode1, base);
+      EXPECT_EQ(pairs[i].bodyNode2, arm);
+    }
+  }
+
+  // The result only depends on the seed
+  sampler.setParallel(false);
+  sampler.sample();
+  const size_t numCollisions = sampler.getPairs()[1].numCollisions;
+  sampler.setParallel(true);
+  sampler.sample();
+  EXPECT_EQ(sampler.getPairs()[1].numCollisions, numCollisions);
+
+  EXPECT_EQ(sampler.disablePairs(), 5u);
+  EXPECT_EQ(skel->getDisabledSelfCollisionPairs().size(), 5u);
+  EXPECT_FALSE(skel->isSelfCollisionPairEnabled(hub, base));
+  EXPECT_TRUE(skel->isSelfCollisionPairEnabled(arm, base));
+
+  // Only the arm hitting the base is reported once the others are disabled
+  collision::DARTCollisionDetector detector;
+  detector.addSkeleton(skel);
+  skel->setPositions(Eigen::Vector2d(0.0, DART_PI));
+  EXPECT_TRUE(detector.detectCollision(true, false));
+  for (size_t i = 0; i < detector.getNumContacts(); ++i)
+  {
+    const collision::Contact& contact = detector.getContact(i);
+    EXPECT_TRUE(contact.bodyNode1 == arm || contact.bodyNode2 == arm);
+  }
+
+  // Clones keep the disabled pairs
+  Skeleton* clone = skel->clone();
+  EXPECT_EQ(clone->getDisabledSelfCollisionPairs().size(), 5u);
+  EXPECT_FALSE(clone->isSelfCollisionPairEnabled(clone->getBodyNode("base"),
+                                                 clone->getBodyNode("hub")));
+
+  skel->enableSelfCollisionPair(base, hub);
+  EXPECT_TRUE(skel->isSelfCollisionPairEnabled(base, hub));
+  skel->clearDisabledSelfCollisionPairs();
+  EXPECT_TRUE(skel->getDisabledSelfCollisionPairs().empty());
+
+  detector.removeAllSkeletons();
+  delete clone;
+  delete skel;
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -46,8 +46,13 @@
 #include "dart/math/Geometry.h"
 #include "dart/math/Helpers.h"
 #include "dart/collision/dart/DARTCollisionDetector.h"
+#include "dart/constraint/ConstraintSolver.h"
 #include "dart/dynamics/BodyNode.h"
+#include "dart/dynamics/BoxShape.h"
+#include "dart/dynamics/EllipsoidShape.h"
+#include "dart/dynamics/FreeJoint.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/dynamics/WeldJoint.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
 #include "dart/utils/Paths.h"
@@ -242,6 +247,64 @@ TEST_F(ConstraintTest, SingleContactTest)
   SingleContactTest(getList()[0]);
 }
 
+//==============================================================================
+TEST_F(ConstraintTest, ContinuousCollision)
+{
+  using namespace dart::dynamics;
+  using namespace dart::simulation;
+
+  // A small ball thrown down at a thin shelf, fast enough to pass through it
+  // between two time steps
+  for (int ccd = 0; ccd < 2; ++ccd)
+  {
+    World* world = new World;
+    world->setTimeStep(0.005);
+    world->getConstraintSolver()->setCollisionDetector(
+          new dart::collision::DARTCollisionDetector);
+
+    Skeleton* shelf = new Skeleton("shelf");
+    BodyNode* shelfBody = new BodyNode("shelf");
+    shelfBody->addCollisionShape(
+          new BoxShape(Eigen::Vector3d(2.0, 2.0, 0.02)));
+    shelfBody->setParentJoint(new WeldJoint);
+    shelf->addBodyNode(shelfBody);
+    world->addSkeleton(shelf);
+
+    Skeleton* ball = new Skeleton("ball");
+    BodyNode* ballBody = new BodyNode("ball");
+    ballBody->addCollisionShape(new EllipsoidShape(Eigen::Vector3d::Ones()
+                                                   * 0.1));
+    ballBody->setParentJoint(new FreeJoint);
+    ballBody->setCCDEnabled(ccd == 1);
+    ball->addBodyNode(ballBody);
+    world->addSkeleton(ball);
+
+    Eigen::Vector6d q = Eigen::Vector6d::Zero();
+    Eigen::Vector6d dq = Eigen::Vector6d::Zero();
+    q[5] = 0.5;
+    dq[5] = -40.0;
+    ball->setPositions(q);
+    ball->setVelocities(dq);
+
+    for (int i = 0; i < 200; ++i)
+      world->step();
+
+    const double height = ballBody->getWorldTransform().translation()[2];
+    if (ccd == 0)
+    {
+      EXPECT_LT(height, -0.5);
+    }
+    else
+    {
+      // The ball rests on the shelf
+      EXPECT_NEAR(height, 0.06, 1e-2);
+      EXPECT_NEAR(ball->getVelocities().norm(), 0.0, 1e-1);
+    }
+
+    delete world;
+  }
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
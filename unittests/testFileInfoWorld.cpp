@@ -46,6 +46,7 @@
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
 #include "dart/utils/FileInfoWorld.h"
+#include "dart/utils/FrameFile.h"
 
 using namespace dart;
 using namespace math;
@@ -134,6 +135,106 @@ TEST(FileInfoWorld, Basic)
   }
 }
 
+//==============================================================================
+TEST(FileInfoWorld, Binary)
+{
+  const size_t numFrames = 100;
+  const std::string fileName = "testWorld.bin";
+  FileInfoWorld worldFile;
+
+  // Two skeletons and a changing number of contacts
+  std::vector<int> numDofs;
+  numDofs.push_back(6);
+  numDofs.push_back(2);
+  Recording recording1(numDofs);
+  for (size_t i = 0; i < numFrames; ++i)
+    recording1.addState(Eigen::VectorXd::Random(8 + 6 * (i % 4)));
+
+  EXPECT_TRUE(worldFile.saveBinaryFile(fileName.c_str(), &recording1));
+  EXPECT_TRUE(worldFile.loadBinaryFile(fileName.c_str()));
+  Recording* recording2 = worldFile.getRecording();
+  ASSERT_TRUE(recording2 != nullptr);
+
+  // The binary format is lossless
+  EXPECT_EQ(recording2->getNumFrames(), (int)numFrames);
+  EXPECT_EQ(recording2->getNumSkeletons(), recording1.getNumSkeletons());
+  for (int i = 0; i < recording1.getNumSkeletons(); ++i)
+    EXPECT_EQ(recording2->getNumDofs(i), recording1.getNumDofs(i));
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    EXPECT_EQ(recording2->getNumContacts(i), recording1.getNumContacts(i));
+    EXPECT_TRUE(recording2->getState(i) == recording1.getState(i));
+  }
+
+  // Files of other kinds are rejected
+  FrameFileWriter writer(fileName, FRAME_FILE_DOF, std::vector<size_t>(1, 8));
+  writer.addFrame(Eigen::VectorXd::Zero(8));
+  EXPECT_TRUE(writer.close());
+  EXPECT_FALSE(worldFile.loadBinaryFile(fileName.c_str()));
+  EXPECT_FALSE(worldFile.loadBinaryFile("missing.bin"));
+}
+
+//==============================================================================
+TEST(FrameFile, Access)
+{
+  const std::string fileName = "testFrames.bin";
+  const size_t numFrames = 1000;
+
+  // Frames of different sizes over many small chunks
+  std::vector<Eigen::VectorXd> frames;
+  std::vector<size_t> layout;
+  layout.push_back(3);
+  layout.push_back(5);
+  FrameFileWriter writer(fileName, FRAME_FILE_C3D, layout, 120.0, 256);
+  ASSERT_TRUE(writer.isOpen());
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    frames.push_back(Eigen::VectorXd::Random(i % 7));
+    writer.addFrame(frames.back());
+  }
+  EXPECT_EQ(writer.getNumFrames(), numFrames);
+  EXPECT_TRUE(writer.close());
+
+  FrameFileReader reader;
+  ASSERT_TRUE(reader.open(fileName));
+  EXPECT_EQ(reader.getContent(), FRAME_FILE_C3D);
+  EXPECT_TRUE(reader.getLayout() == layout);
+  EXPECT_EQ(reader.getFrameRate(), 120.0);
+  ASSERT_EQ(reader.getNumFrames(), numFrames);
+
+  // Random access
+  Eigen::VectorXd frame;
+  for (size_t i = 0; i < numFrames; i += 7)
+  {
+    size_t index = numFrames - 1 - i;
+    EXPECT_EQ(reader.getFrameSize(index), (size_t)frames[index].size());
+    EXPECT_TRUE(reader.readFrame(index, frame));
+    EXPECT_TRUE(frame == frames[index]);
+  }
+  EXPECT_FALSE(reader.readFrame(numFrames, frame));
+
+  // Streaming from any frame to the end
+  reader.seek(numFrames - 10);
+  size_t count = 0;
+  while (reader.next(frame))
+  {
+    EXPECT_TRUE(frame == frames[numFrames - 10 + count]);
+    ++count;
+  }
+  EXPECT_EQ(count, 10u);
+  reader.close();
+  EXPECT_FALSE(reader.isOpen());
+
+  // A truncated file is rejected
+  std::ifstream in(fileName.c_str(), std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream(fileName.c_str(), std::ios::binary).write(
+        contents.data(), contents.size() / 2);
+  EXPECT_FALSE(reader.open(fileName));
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
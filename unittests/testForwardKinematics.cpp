@@ -37,6 +37,7 @@
 #include <iostream>
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
+#include "dart/dynamics/CompiledKinematics.h"
 
 std::vector<size_t> twoLinkIndices;
 
@@ -126,6 +127,185 @@ TEST(FORWARD_KINEMATICS, TWO_ROLLS)
   }
 }
 
+//==============================================================================
+Isometry3d randomTransform()
+{
+  Isometry3d T = Isometry3d::Identity();
+  T.rotate(expMapRot(Vector3d::Random()));
+  T.translation() = Vector3d::Random();
+  return T;
+}
+
+//==============================================================================
+Skeleton* createMixedJointRobot()
+{
+  Skeleton* robot = new Skeleton("mixed");
+
+  std::vector<Joint*> joints;
+  joints.push_back(new FreeJoint("free"));
+  joints.push_back(new RevoluteJoint(Vector3d(0.0, 0.6, 0.8), "revolute"));
+  joints.push_back(new PrismaticJoint(Vector3d(1.0, 0.0, 0.0), "prismatic"));
+  joints.push_back(new ScrewJoint(Vector3d(0.0, 0.0, 1.0), 0.3, "screw"));
+  joints.push_back(new BallJoint("ball"));
+  joints.push_back(new WeldJoint("weld"));
+  joints.push_back(new RevoluteJoint(Vector3d(1.0, 0.0, 0.0), "branch"));
+
+  BodyNode* parent = nullptr;
+  for (size_t i = 0; i < joints.size(); ++i)
+  {
+    BodyNode* node = new BodyNode("body" + std::to_string(i));
+    Joint* joint = joints[i];
+    if (i > 0)
+      joint->setTransformFromParentBodyNode(randomTransform());
+    joint->setTransformFromChildBodyNode(randomTransform());
+    node->setParentJoint(joint);
+
+    // The last body branches off the BallJoint body
+    BodyNode* actualParent = (i + 1 == joints.size())
+        ? robot->getBodyNode(3) : parent;
+    if (actualParent)
+      actualParent->addChildBodyNode(node);
+    robot->addBodyNode(node);
+    parent = node;
+  }
+
+  robot->init();
+  return robot;
+}
+
+//==============================================================================
+TEST(FORWARD_KINEMATICS, COMPILED)
+{
+  Skeleton* robot = createMixedJointRobot();
+  CompiledKinematics compiled(robot);
+
+  EXPECT_EQ(compiled.getNumRecords(), robot->getNumBodyNodes());
+  EXPECT_FALSE(compiled.isFullyCompiled());
+
+  const size_t numTests = 50;
+  for (size_t i = 0; i < numTests; ++i)
+  {
+    VectorXd q   = VectorXd::Random(robot->getNumDofs());
+    VectorXd dq  = VectorXd::Random(robot->getNumDofs());
+    VectorXd ddq = VectorXd::Random(robot->getNumDofs());
+
+    // Alternate between explicit vectors and the state of the Skeleton
+    if (i % 2 == 0)
+    {
+      compiled.update(q, dq, ddq);
+      robot->setPositions(q);
+      robot->setVelocities(dq);
+      robot->setAccelerations(ddq);
+    }
+    else
+    {
+      robot->setPositions(q);
+      robot->setVelocities(dq);
+      robot->setAccelerations(ddq);
+      compiled.update();
+    }
+
+    for (size_t j = 0; j < robot->getNumBodyNodes(); ++j)
+    {
+      BodyNode* bodyNode = robot->getBodyNode(j);
+      Matrix4d expectedT = bodyNode->getTransform().matrix();
+      Matrix4d actualT = compiled.getWorldTransform(j).matrix();
+      EXPECT_TRUE(equals(expectedT, actualT, 1e-10));
+
+      Vector6d expectedV = bodyNode->getSpatialVelocity();
+      Vector6d actualV = compiled.getSpatialVelocity(j);
+      EXPECT_TRUE(equals(expectedV, actualV, 1e-10));
+
+      Vector6d expectedA = bodyNode->getSpatialAcceleration();
+      Vector6d actualA = compiled.getSpatialAcceleration(j);
+      EXPECT_TRUE(equals(expectedA, actualA, 1e-10));
+    }
+  }
+
+  delete robot;
+}
+
+//==============================================================================
+TEST(FORWARD_KINEMATICS, COMPILED_CHAIN)
+{
+  Skeleton* robot = createNLinkRobot(6, Vector3d(0.3, 0.3, 1.0), DOF_ROLL,
+                                     true);
+  CompiledKinematics compiled(robot);
+  EXPECT_TRUE(compiled.isFullyCompiled());
+
+  robot->setPositions(VectorXd::Random(robot->getNumDofs()));
+  robot->setVelocities(VectorXd::Random(robot->getNumDofs()));
+  robot->setAccelerations(VectorXd::Random(robot->getNumDofs()));
+  compiled.update();
+
+  for (size_t j = 0; j < robot->getNumBodyNodes(); ++j)
+  {
+    BodyNode* bodyNode = robot->getBodyNode(j);
+    Matrix4d expectedT = bodyNode->getTransform().matrix();
+    Matrix4d actualT = compiled.getWorldTransform(j).matrix();
+    EXPECT_TRUE(equals(expectedT, actualT, 1e-10));
+
+    Vector6d expectedA = bodyNode->getSpatialAcceleration();
+    Vector6d actualA = compiled.getSpatialAcceleration(j);
+    EXPECT_TRUE(equals(expectedA, actualA, 1e-10));
+  }
+
+  delete robot;
+}
+
+//==============================================================================
+TEST(FORWARD_KINEMATICS, BATCHED_STATE_UPDATE)
+{
+  Skeleton* robot = createMixedJointRobot();
+  CompiledKinematics compiled(robot);
+  BodyNode* leaf = robot->getBodyNode(robot->getNumBodyNodes() - 2);
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    VectorXd q  = VectorXd::Random(robot->getNumDofs());
+    VectorXd dq = VectorXd::Random(robot->getNumDofs());
+
+    // Clean all the flags
+    for (size_t j = 0; j < robot->getNumBodyNodes(); ++j)
+    {
+      robot->getBodyNode(j)->getWorldTransform();
+      robot->getBodyNode(j)->getSpatialAcceleration();
+    }
+    EXPECT_FALSE(leaf->needsTransformUpdate());
+
+    robot->beginStateUpdate();
+    for (size_t j = 0; j < robot->getNumDofs(); ++j)
+      robot->getDof(j)->setPosition(q[j]);
+
+    // Nested batches do not notify
+    robot->setVelocities(dq);
+    EXPECT_TRUE(robot->isUpdatingState());
+    EXPECT_FALSE(leaf->needsTransformUpdate());
+    EXPECT_FALSE(leaf->needsVelocityUpdate());
+
+    robot->endStateUpdate();
+    EXPECT_FALSE(robot->isUpdatingState());
+    EXPECT_TRUE(leaf->needsTransformUpdate());
+    EXPECT_TRUE(leaf->needsVelocityUpdate());
+    EXPECT_TRUE(leaf->needsAccelerationUpdate());
+
+    compiled.update();
+    for (size_t j = 0; j < robot->getNumBodyNodes(); ++j)
+    {
+      BodyNode* bodyNode = robot->getBodyNode(j);
+      Matrix4d expectedT = compiled.getWorldTransform(j).matrix();
+      Matrix4d actualT = bodyNode->getTransform().matrix();
+      EXPECT_TRUE(equals(expectedT, actualT, 1e-10));
+
+      Vector6d expectedV = compiled.getSpatialVelocity(j);
+      Vector6d actualV = bodyNode->getSpatialVelocity();
+      EXPECT_TRUE(equals(expectedV, actualV, 1e-10));
+    }
+  }
+
+  delete robot;
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -741,6 +741,16 @@ TEST(FRAMES, CHILDHOOD)
   SimpleFrame F2(&F1, "F2");
 
   EXPECT_TRUE(F1.getNumChildFrames() == 1);
+
+  // Children are listed in the order they were added
+  SimpleFrame F3(&F1, "F3");
+  ASSERT_TRUE(F1.getChildFrameArray().size() == 2);
+  EXPECT_TRUE(F1.getChildFrameArray()[0] == &F2);
+  EXPECT_TRUE(F1.getChildFrameArray()[1] == &F3);
+
+  F2.setParentFrame(Frame::World());
+  ASSERT_TRUE(F1.getChildFrameArray().size() == 1);
+  EXPECT_TRUE(F1.getChildFrameArray()[0] == &F3);
 }
 
 int main(int argc, char* argv[])
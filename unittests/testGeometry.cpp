@@ -38,6 +38,7 @@
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
 
+#include "dart/math/ConvexHull.h"
 #include "dart/math/Geometry.h"
 #include "dart/math/Helpers.h"
 #include "dart/dynamics/BallJoint.h"
@@ -599,6 +600,97 @@ TEST(LIE_GROUP_OPERATORS, ADJOINT_MAPPINGS)
     }
 }
 
+/******************************************************************************/
+TEST(ConvexHull, Cube)
+{
+  // Corners of the unit cube with its center and the centers of its faces,
+  // which are not vertices of the hull
+  std::vector<Eigen::Vector3d> points;
+  for (int i = 0; i < 8; ++i)
+    points.push_back(Eigen::Vector3d(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+  points.push_back(Eigen::Vector3d(0.5, 0.5, 0.5));
+  for (int i = 0; i < 3; ++i)
+  {
+    Eigen::Vector3d center = Eigen::Vector3d::Constant(0.5);
+    center[i] = 1.0;
+    points.push_back(center);
+  }
+
+  ConvexHull hull(points);
+  ASSERT_TRUE(hull.hasVolume());
+  EXPECT_EQ(hull.getVertices().size(), 8u);
+  EXPECT_EQ(hull.getFaces().size(), 12u);
+  EXPECT_NEAR(hull.computeVolume(), 1.0, 1e-12);
+  EXPECT_TRUE(equals(hull.computeCenter(),
+                     Eigen::Vector3d(Eigen::Vector3d::Constant(0.5))));
+
+  // Faces point away from the center
+  for (size_t i = 0; i < hull.getFaces().size(); ++i)
+  {
+    const Eigen::Vector3d& v = hull.getVertices()[hull.getFaces()[i][0]];
+    EXPECT_GT(hull.getFaceNormal(i).dot(v - hull.computeCenter()), 0.0);
+  }
+
+  EXPECT_NEAR(hull.computeSignedDistance(Eigen::Vector3d(0.5, 0.5, 0.4)),
+              -0.4, 1e-12);
+  EXPECT_NEAR(hull.computeSignedDistance(Eigen::Vector3d(0.5, 2.0, 0.5)),
+              1.0, 1e-12);
+  EXPECT_TRUE(equals(hull.getSupportPoint(Eigen::Vector3d(1.0, -1.0, 1.0)),
+                     Eigen::Vector3d(1.0, 0.0, 1.0)));
+
+  // Flat points have no volume but still support queries
+  points.clear();
+  for (int i = 0; i < 4; ++i)
+    points.push_back(Eigen::Vector3d(i & 1, (i >> 1) & 1, 0.0));
+  ConvexHull square(points);
+  EXPECT_FALSE(square.hasVolume());
+  EXPECT_FALSE(square.isEmpty());
+  EXPECT_TRUE(equals(square.getSupportPoint(Eigen::Vector3d(1.0, 1.0, 0.0)),
+                     Eigen::Vector3d(1.0, 1.0, 0.0)));
+}
+
+/******************************************************************************/
+TEST(ConvexHull, Decomposition)
+{
+  // L-shaped prism, which is the union of a 2x1 and a 1x1 box
+  const double outline[6][2] = {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}};
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<Eigen::Vector3i> triangles;
+  for (int z = 0; z < 2; ++z)
+  {
+    for (int i = 0; i < 6; ++i)
+      vertices.push_back(Eigen::Vector3d(outline[i][0], outline[i][1], z));
+  }
+
+  const int cap[4][3] = {{3, 4, 5}, {3, 5, 0}, {3, 0, 1}, {3, 1, 2}};
+  for (int i = 0; i < 4; ++i)
+  {
+    triangles.push_back(Eigen::Vector3i(cap[i][0], cap[i][2], cap[i][1]));
+    triangles.push_back(
+          Eigen::Vector3i(6 + cap[i][0], 6 + cap[i][1], 6 + cap[i][2]));
+  }
+  for (int i = 0; i < 6; ++i)
+  {
+    const int j = (i + 1) % 6;
+    triangles.push_back(Eigen::Vector3i(i, j, 6 + j));
+    triangles.push_back(Eigen::Vector3i(i, 6 + j, 6 + i));
+  }
+
+  // A single hull fills in the notch
+  std::vector<ConvexHull> hulls
+      = computeConvexDecomposition(vertices, triangles, 1);
+  ASSERT_EQ(hulls.size(), 1u);
+  EXPECT_NEAR(hulls[0].computeVolume(), 3.5, 1e-12);
+
+  // Two hulls cover the prism exactly
+  hulls = computeConvexDecomposition(vertices, triangles);
+  ASSERT_EQ(hulls.size(), 2u);
+  double volume = 0.0;
+  for (size_t i = 0; i < hulls.size(); ++i)
+    volume += hulls[i].computeVolume();
+  EXPECT_NEAR(volume, 3.0, 1e-9);
+}
+
 /******************************************************************************/
 int main(int argc, char* argv[])
 {
@@ -39,6 +39,7 @@
 
 #include "dart/config.h"
 #include "dart/math/Helpers.h"
+#include "dart/dynamics/InverseKinematics.h"
 #include "TestHelpers.h"
 
 using namespace Eigen;
@@ -260,6 +261,147 @@ Skeleton* createFreeFloatingTwoLinkRobot(Vector3d dim1,
 //}
 #endif
 
+//==============================================================================
+TEST(InverseKinematics, SolvingPoseTargets)
+{
+  const double TOLERANCE = 1e-6;
+#ifdef BUILD_TYPE_RELEASE
+  const size_t numRandomTests = 100;
+#else
+  const size_t numRandomTests = 10;
+#endif
+
+  const double l1 = 1.5;
+  const double l2 = 1.0;
+  Skeleton* robot = createFreeFloatingTwoLinkRobot(
+                      Vector3d(0.3, 0.3, l1),
+                      Vector3d(0.3, 0.3, l2), DOF_ROLL);
+  VectorXd oldConfig = robot->getPositions();
+
+  BodyNode* body1 = robot->getBodyNode(0);
+  BodyNode* body2 = robot->getBodyNode(1);
+
+  //------------------------- Free joint test ----------------------------------
+  // body1 can reach any transformation through its free joint
+  InverseKinematics ik(robot);
+  ik.setTolerance(1e-8);
+  ik.setMaxIterations(200);
+  ik.addTarget(body1, Isometry3d::Identity());
+  for (size_t i = 0; i < numRandomTests; ++i)
+  {
+    Isometry3d desiredT1 = math::expMap(Vector6d::Random());
+    ik.setTargetTransform(0, desiredT1);
+
+    EXPECT_TRUE(ik.solve(oldConfig));
+    EXPECT_NEAR(math::logMap(body1->getWorldTransform().inverse()
+                             * desiredT1).norm(), 0.0, TOLERANCE);
+  }
+
+  //------------------ Offset target on the second body ------------------------
+  // Targets sampled from random configurations are always reachable
+  ik.clearTargets();
+  ik.addTarget(body2, Isometry3d::Identity(), Vector3d(0.0, 0.0, l2));
+  for (size_t i = 0; i < numRandomTests; ++i)
+  {
+    VectorXd q = VectorXd::Random(robot->getNumDofs());
+    robot->setPositions(q);
+    Isometry3d desiredT2 = body2->getWorldTransform();
+    desiredT2.translation() = body2->getWorldTransform()
+                              * Vector3d(0.0, 0.0, l2);
+    ik.setTargetTransform(0, desiredT2);
+
+    EXPECT_TRUE(ik.solve(oldConfig));
+    EXPECT_NEAR(ik.getError(), 0.0, TOLERANCE);
+    Matrix3d R2 = body2->getWorldTransform().linear();
+    EXPECT_TRUE(equals(R2, Matrix3d(desiredT2.linear()), TOLERANCE));
+  }
+
+  //------------------------- Joint limit test ---------------------------------
+  // Only joint2 is allowed to move, and the target lies outside of its limits
+  Joint* joint2 = body2->getParentJoint();
+  joint2->setPositionLowerLimit(0, DART_RADIAN *  0.0);
+  joint2->setPositionUpperLimit(0, DART_RADIAN * 15.0);
+
+  std::vector<size_t> dofs(1, joint2->getIndexInSkeleton(0));
+  ik.setDofs(dofs);
+  ik.clearTargets();
+  ik.addTarget(body2, Isometry3d::Identity());
+  for (size_t i = 0; i < numRandomTests; ++i)
+  {
+    robot->setPositions(oldConfig);
+    joint2->setPosition(0, math::random(DART_RADIAN * 15.5, DART_PI));
+    ik.setTargetTransform(0, body2->getWorldTransform());
+
+    ik.setRespectLimits(false);
+    EXPECT_TRUE(ik.solve(oldConfig));
+
+    ik.setRespectLimits(true);
+    EXPECT_FALSE(ik.solve(oldConfig));
+    EXPECT_GE(joint2->getPosition(0), DART_RADIAN *  0.0);
+    EXPECT_LE(joint2->getPosition(0), DART_RADIAN * 15.0);
+    EXPECT_NEAR(joint2->getPosition(0), DART_RADIAN * 15.0, 1e-3);
+  }
+
+  delete robot;
+}
+
+//==============================================================================
+TEST(InverseKinematics, SolvingBatches)
+{
+  const double TOLERANCE = 1e-6;
+  const size_t numWorkers = 4;
+  const size_t numProblems = 200;
+
+  std::vector<Skeleton*> workers;
+  for (size_t i = 0; i < numWorkers; ++i)
+  {
+    workers.push_back(createFreeFloatingTwoLinkRobot(
+                        Vector3d(0.3, 0.3, 1.5),
+                        Vector3d(0.3, 0.3, 1.0), DOF_PITCH));
+  }
+
+  Skeleton* robot = workers[0];
+  BodyNode* ee = robot->getBodyNode("ee");
+  VectorXd seed = robot->getPositions();
+
+  // Sample reachable end effector transforms
+  std::vector<Isometry3d> targets;
+  for (size_t i = 0; i < numProblems; ++i)
+  {
+    robot->setPositions(0.5 * VectorXd::Random(robot->getNumDofs()));
+    targets.push_back(ee->getWorldTransform());
+  }
+  robot->setPositions(seed);
+
+  InverseKinematics ik(robot);
+  ik.setTolerance(1e-8);
+  ik.setMaxIterations(200);
+  ik.addTarget(ee, Isometry3d::Identity());
+
+  std::vector<VectorXd> solutions;
+  std::vector<double> errors;
+  EXPECT_EQ(ik.solveBatch(workers, targets, solutions, &errors), numProblems);
+  ASSERT_EQ(solutions.size(), numProblems);
+  ASSERT_EQ(errors.size(), numProblems);
+
+  // The batched solutions must reproduce the targets and match the serial
+  // solver, since every problem starts from the same seed
+  for (size_t i = 0; i < numProblems; ++i)
+  {
+    robot->setPositions(solutions[i]);
+    EXPECT_NEAR(math::logMap(ee->getWorldTransform().inverse()
+                             * targets[i]).norm(), 0.0, TOLERANCE);
+
+    ik.setTargetTransform(0, targets[i]);
+    ik.solve(seed);
+    EXPECT_TRUE(equals(robot->getPositions(), solutions[i], TOLERANCE));
+    EXPECT_NEAR(ik.getError(), errors[i], TOLERANCE);
+  }
+
+  for (size_t i = 0; i < numWorkers; ++i)
+    delete workers[i];
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2015, Georgia Tech Research Corporation
+ * All rights reserved.
+ *
+ * Georgia Tech Graphics Lab and Humanoid Robotics Lab
+ *
+ * Directed by Prof. C. Karen Liu and Prof. Mike Stilman
+ * <karenliu@cc.gatech.edu> <mstilman@cc.gatech.edu>
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <gtest/gtest.h>
+#include "TestHelpers.h"
+
+#include "dart/dynamics/Skeleton.h"
+#include "dart/optimizer/Function.h"
+#include "dart/planning/MultipleShootingProblem.h"
+#include "dart/simulation/World.h"
+
+using namespace dart;
+using namespace dynamics;
+using namespace simulation;
+using namespace planning;
+
+//==============================================================================
+World* createPendulumWorld()
+{
+  World* world = new World;
+  world->setTimeStep(1e-3);
+  world->addSkeleton(createNLinkRobot(2, Eigen::Vector3d(0.1, 0.1, 0.5),
+                                      DOF_ROLL));
+  world->getSkeleton(0)->setPositions(Eigen::Vector2d(0.3, -0.2));
+  return world;
+}
+
+//==============================================================================
+TEST(MultipleShooting, Layout)
+{
+  std::vector<World*> workers(1, createPendulumWorld());
+  MultipleShootingProblem problem(workers, 0, 4, 5);
+
+  const size_t stateDim = problem.getStateDimension();
+  const size_t controlDim = problem.getControlDimension();
+  EXPECT_EQ(stateDim, 4u);
+  EXPECT_EQ(controlDim, 2u);
+  EXPECT_EQ(problem.getDimension(), 5 * stateDim + 4 * controlDim);
+  EXPECT_EQ(problem.getNumEqConstraints(), 4 * stateDim);
+
+  // Every continuity constraint only touches one block of variables
+  for (size_t i = 0; i < problem.getNumEqConstraints(); ++i)
+  {
+    const optimizer::Function* constraint = problem.getEqConstraint(i);
+    EXPECT_FALSE(constraint->isDense());
+    EXPECT_EQ(constraint->getDependentVariables().size(),
+              stateDim + controlDim + 1);
+  }
+
+  // The initial state is fixed
+  Eigen::VectorXd state = workers[0]->getSkeleton(0)->getState();
+  Eigen::VectorXd lower = problem.getLowerBounds().head(stateDim);
+  Eigen::VectorXd upper = problem.getUpperBounds().head(stateDim);
+  EXPECT_TRUE(equals(lower, state));
+  EXPECT_TRUE(equals(upper, state));
+
+  // Rollouts leave the World of the caller as it was
+  problem.rollout(problem.getInitialGuess());
+  EXPECT_TRUE(equals(Eigen::VectorXd(workers[0]->getSkeleton(0)->getState()),
+                     state));
+  EXPECT_EQ(workers[0]->getTime(), 0.0);
+  EXPECT_EQ(workers[0]->getSimFrames(), 0);
+
+  delete workers[0];
+}
+
+//==============================================================================
+TEST(MultipleShooting, MismatchedWorkers)
+{
+  // A worker with as many Skeletons but more DOFs is not used
+  std::vector<World*> workers(1, createPendulumWorld());
+  workers.push_back(new World);
+  workers[1]->addSkeleton(createNLinkRobot(3, Eigen::Vector3d(0.1, 0.1, 0.5),
+                                           DOF_ROLL));
+
+  MultipleShootingProblem problem(workers, 0, 4, 5);
+  std::vector<World*> serialWorkers(1, createPendulumWorld());
+  MultipleShootingProblem serialProblem(serialWorkers, 0, 4, 5);
+
+  Eigen::VectorXd x = problem.getInitialGuess();
+  for (size_t s = 0; s < problem.getNumSegments(); ++s)
+  {
+    EXPECT_TRUE(equals(problem.getSegmentEndState(x, s),
+                       serialProblem.getSegmentEndState(x, s)));
+  }
+
+  for (size_t i = 0; i < workers.size(); ++i)
+    delete workers[i];
+  delete serialWorkers[0];
+}
+
+//==============================================================================
+TEST(MultipleShooting, DefectsAndDerivatives)
+{
+  const size_t numSegments = 4;
+  const size_t numSteps = 5;
+
+  std::vector<World*> workers;
+  for (size_t i = 0; i < 3; ++i)
+    workers.push_back(createPendulumWorld());
+
+  MultipleShootingProblem problem(workers, 0, numSegments, numSteps);
+  const size_t stateDim = problem.getStateDimension();
+  const size_t controlDim = problem.getControlDimension();
+
+  // Build a consistent trajectory from a rollout of random controls
+  Eigen::VectorXd x = problem.getInitialGuess();
+  for (size_t s = 0; s < numSegments; ++s)
+  {
+    x.segment(problem.getControlIndex(s), controlDim)
+        = Eigen::VectorXd::Random(controlDim);
+  }
+  Eigen::MatrixXd states = problem.rollout(x);
+  for (size_t s = 1; s <= numSegments; ++s)
+  {
+    x.segment(problem.getStateIndex(s), stateDim)
+        = states.col(s * numSteps - 1);
+  }
+
+  Eigen::Map<const Eigen::VectorXd> xMap(x.data(), x.size());
+  for (size_t i = 0; i < problem.getNumEqConstraints(); ++i)
+    EXPECT_NEAR(problem.getEqConstraint(i)->eval(xMap), 0.0, 1e-9);
+
+  // A single worker must produce the same segments as several of them
+  std::vector<World*> serialWorkers(1, createPendulumWorld());
+  MultipleShootingProblem serialProblem(serialWorkers, 0,
+                                        numSegments, numSteps);
+  for (size_t s = 0; s < numSegments; ++s)
+  {
+    EXPECT_TRUE(equals(problem.getSegmentEndState(x, s),
+                       serialProblem.getSegmentEndState(x, s), 1e-12));
+  }
+
+  // The segment Jacobians predict the effect of small perturbations
+  Eigen::VectorXd dx = 1e-5 * Eigen::VectorXd::Random(x.size());
+  dx.head(stateDim).setZero();
+  Eigen::VectorXd perturbed = x + dx;
+  for (size_t s = 0; s < numSegments; ++s)
+  {
+    Eigen::VectorXd predicted = problem.getSegmentEndState(x, s)
+        + problem.getStateJacobian(x, s)
+          * dx.segment(problem.getStateIndex(s), stateDim)
+        + problem.getControlJacobian(x, s)
+          * dx.segment(problem.getControlIndex(s), controlDim);
+    Eigen::VectorXd actual = serialProblem.getSegmentEndState(perturbed, s);
+    EXPECT_TRUE(equals(predicted, actual, 1e-8));
+  }
+
+  // The constraint gradients are assembled from the segment Jacobians
+  Eigen::VectorXd grad(x.size());
+  Eigen::Map<Eigen::VectorXd> gradMap(grad.data(), grad.size());
+  problem.getEqConstraint(stateDim + 1)->evalGradient(xMap, gradMap);
+  Eigen::VectorXd expected = problem.getStateJacobian(x, 1).row(1);
+  Eigen::VectorXd actual = grad.segment(problem.getStateIndex(1), stateDim);
+  EXPECT_TRUE(equals(actual, expected));
+  EXPECT_EQ(grad[problem.getStateIndex(2) + 1], -1.0);
+  EXPECT_EQ(grad.head(problem.getStateIndex(1)).norm(), 0.0);
+
+  // The sparse gradient holds the same entries in the order of the dependent
+  // variables
+  optimizer::Function* constraint = problem.getEqConstraint(stateDim + 1);
+  const std::vector<size_t>& vars = constraint->getDependentVariables();
+  Eigen::VectorXd values(vars.size());
+  constraint->evalSparseGradient(
+        xMap, Eigen::Map<Eigen::VectorXd>(values.data(), values.size()));
+  for (size_t i = 0; i < vars.size(); ++i)
+    EXPECT_EQ(values[i], grad[vars[i]]);
+
+  for (size_t i = 0; i < workers.size(); ++i)
+    delete workers[i];
+  delete serialWorkers[0];
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -258,6 +258,70 @@ TEST(NameManagement, SetPattern)
   delete bn2;
 }
 
+//==============================================================================
+TEST(NameManagement, NameHandle)
+{
+  // Handles to equal strings are equal, no matter how they were created
+  dart::common::NameHandle name1("name");
+  dart::common::NameHandle name2(std::string("na") + "me");
+  dart::common::NameHandle other("other");
+  EXPECT_TRUE(name1 == name2);
+  EXPECT_TRUE(name1 != other);
+  EXPECT_EQ(name1.hash(), name2.hash());
+  EXPECT_EQ(name1.str(), "name");
+  EXPECT_TRUE(dart::common::NameHandle().empty());
+  EXPECT_TRUE(dart::common::NameHandle("") == dart::common::NameHandle());
+
+  // Interned names are released with their last handle
+  EXPECT_TRUE(dart::common::NameHandle::find("name") == name1);
+  {
+    dart::common::NameHandle temporary("temporary");
+    dart::common::NameHandle copy(temporary);
+    EXPECT_TRUE(dart::common::NameHandle::find("temporary") == copy);
+  }
+  EXPECT_TRUE(dart::common::NameHandle::find("temporary").empty());
+
+  dart::common::NameManager<BodyNode> test_mgr;
+  BodyNode* bn0 = new BodyNode("name");
+  BodyNode* bn1 = new BodyNode("name");
+
+  test_mgr.issueNewNameAndAdd(bn0->getName(), bn0);
+  test_mgr.issueNewNameAndAdd(bn1->getName(), bn1);
+
+  EXPECT_TRUE(test_mgr.getObject(name1) == bn0);
+  EXPECT_TRUE(test_mgr.getObject(dart::common::NameHandle("name(1)")) == bn1);
+  EXPECT_TRUE(test_mgr.getObject(other) == NULL);
+  EXPECT_TRUE(test_mgr.hasName(name1));
+
+  // Handles follow removals and renames
+  test_mgr.removeName("name");
+  EXPECT_TRUE(test_mgr.getObject(name1) == NULL);
+  EXPECT_FALSE(test_mgr.hasName(name1));
+
+  delete bn0;
+  delete bn1;
+
+  // Skeleton lookups
+  BodyNode* body = new BodyNode("body");
+  Joint* joint = new RevoluteJoint(Eigen::Vector3d::UnitX(), "joint");
+  body->setParentJoint(joint);
+  Skeleton* skel = new Skeleton;
+  skel->addBodyNode(body);
+  skel->init();
+
+  EXPECT_TRUE(skel->getBodyNode(dart::common::NameHandle("body")) == body);
+  EXPECT_TRUE(skel->getJoint(dart::common::NameHandle("joint")) == joint);
+  EXPECT_TRUE(skel->getDof(dart::common::NameHandle("joint"))
+              == joint->getDof(0));
+
+  body->setName("renamed_body");
+  EXPECT_TRUE(skel->getBodyNode(dart::common::NameHandle("body")) == NULL);
+  EXPECT_TRUE(skel->getBodyNode(dart::common::NameHandle("renamed_body"))
+              == body);
+
+  delete skel;
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
@@ -40,6 +40,8 @@
 #include <Eigen/Dense>
 #include "dart/config.h"
 #include "dart/common/Console.h"
+#include "dart/optimizer/AutoDiffFunction.h"
+#include "dart/optimizer/Dual.h"
 #include "dart/optimizer/Function.h"
 #include "dart/optimizer/Problem.h"
 #ifdef HAVE_NLOPT
@@ -114,6 +116,142 @@ private:
   double mB;
 };
 
+//==============================================================================
+/// \brief Same as SampleConstFunc, written once for any scalar type
+struct SampleConstFunctor
+{
+  SampleConstFunctor(double _a = 1.0, double _b = 0.0) : mA(_a), mB(_b) {}
+
+  template <typename Scalar>
+  Scalar operator()(const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& _x) const
+  {
+    const Scalar y = mA * _x[0] + mB;
+    return y * y * y - _x[1];
+  }
+
+  double mA;
+  double mB;
+};
+
+//==============================================================================
+/// \brief Function that only provides its value
+class ValueOnlyFunc : public Function
+{
+public:
+  /// \copydoc Function::eval
+  virtual double eval(Eigen::Map<const Eigen::VectorXd>& _x)
+  {
+    return std::sin(_x[0]) * std::exp(_x[2]) + _x[2] * _x[2];
+  }
+};
+
+//==============================================================================
+TEST(Optimizer, DualNumbers)
+{
+  const double x = 0.7;
+  const Dual d(x, 1.0);
+
+  Dual f = sin(d) * exp(d) / (1.0 + d * d);
+  double expected = (std::cos(x) * std::exp(x) + std::sin(x) * std::exp(x))
+                    / (1.0 + x * x)
+                    - std::sin(x) * std::exp(x) * 2.0 * x
+                    / ((1.0 + x * x) * (1.0 + x * x));
+  EXPECT_NEAR(f.mValue, std::sin(x) * std::exp(x) / (1.0 + x * x), 1e-12);
+  EXPECT_NEAR(f.mDerivative, expected, 1e-12);
+
+  f = sqrt(pow(d, 3.0)) - log(d) + atan2(d, Dual(2.0));
+  expected = 1.5 * std::sqrt(x) - 1.0 / x + 2.0 / (4.0 + x * x);
+  EXPECT_NEAR(f.mDerivative, expected, 1e-12);
+
+  // Eigen expressions work on Duals as well
+  Eigen::Matrix<Dual, 3, 1> v(d, 2.0 * d, Dual(3.0));
+  EXPECT_NEAR(v.squaredNorm().mDerivative, 2.0 * x + 8.0 * x, 1e-12);
+}
+
+//==============================================================================
+TEST(Optimizer, AutomaticDifferentiation)
+{
+  SampleConstFunc analytic(2.0, 1.0);
+  AutoDiffFunction<SampleConstFunctor> autodiff(SampleConstFunctor(2.0, 1.0));
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    Eigen::Vector2d point = Eigen::Vector2d::Random();
+    Eigen::Map<const Eigen::VectorXd> x(point.data(), 2);
+
+    Eigen::Vector2d expected;
+    Eigen::Vector2d actual;
+    analytic.evalGradient(x, Eigen::Map<Eigen::VectorXd>(expected.data(), 2));
+    autodiff.evalGradient(x, Eigen::Map<Eigen::VectorXd>(actual.data(), 2));
+
+    EXPECT_NEAR(autodiff.eval(x), analytic.eval(x), 1e-12);
+    EXPECT_TRUE(expected.isApprox(actual, 1e-12));
+  }
+
+  // Only the dependent variables are differentiated
+  std::vector<size_t> vars(1, 0);
+  autodiff.setDependentVariables(vars);
+  EXPECT_FALSE(autodiff.isDense());
+
+  Eigen::Vector2d point(0.3, 0.4);
+  Eigen::Map<const Eigen::VectorXd> x(point.data(), 2);
+  Eigen::Vector2d grad = Eigen::Vector2d::Constant(42.0);
+  autodiff.evalGradient(x, Eigen::Map<Eigen::VectorXd>(grad.data(), 2));
+  EXPECT_NEAR(grad[0], 3.0 * 2.0 * (2.0 * 0.3 + 1.0) * (2.0 * 0.3 + 1.0),
+              1e-12);
+  EXPECT_EQ(grad[1], 0.0);
+
+  // The sparse gradient only holds the dependent variables
+  double value;
+  autodiff.evalSparseGradient(x, Eigen::Map<Eigen::VectorXd>(&value, 1));
+  EXPECT_EQ(value, grad[0]);
+
+  // The default sparse gradient gathers the dense one
+  SampleConstFunc sparseAnalytic(2.0, 1.0);
+  sparseAnalytic.setDependentVariables(vars);
+  sparseAnalytic.evalSparseGradient(x,
+                                    Eigen::Map<Eigen::VectorXd>(&value, 1));
+  EXPECT_NEAR(value, grad[0], 1e-12);
+}
+
+//==============================================================================
+TEST(Optimizer, FiniteDifferences)
+{
+  ValueOnlyFunc f;
+
+  Eigen::Vector3d point(0.2, -0.5, 0.3);
+  Eigen::Map<const Eigen::VectorXd> x(point.data(), 3);
+  Eigen::Vector3d expected(std::cos(0.2) * std::exp(0.3),
+                           0.0,
+                           std::sin(0.2) * std::exp(0.3) + 2.0 * 0.3);
+
+  Eigen::Vector3d grad;
+  f.evalGradientByFiniteDifference(
+        x, Eigen::Map<Eigen::VectorXd>(grad.data(), 3));
+  EXPECT_TRUE(grad.isApprox(expected, 1e-6));
+
+  // Parallel evaluation gives the same result since eval() is thread-safe
+  Eigen::Vector3d parallelGrad;
+  f.evalGradientByFiniteDifference(
+        x, Eigen::Map<Eigen::VectorXd>(parallelGrad.data(), 3), 1e-6, true);
+  EXPECT_TRUE(parallelGrad.isApprox(grad, 1e-12));
+
+  // Sparse gradients only perturb the dependent variables
+  std::vector<size_t> vars;
+  vars.push_back(2);
+  f.setDependentVariables(vars);
+  f.evalGradientByFiniteDifference(
+        x, Eigen::Map<Eigen::VectorXd>(grad.data(), 3));
+  EXPECT_EQ(grad[0], 0.0);
+  EXPECT_EQ(grad[1], 0.0);
+  EXPECT_NEAR(grad[2], expected[2], 1e-6);
+
+  double value;
+  f.evalSparseGradientByFiniteDifference(
+        x, Eigen::Map<Eigen::VectorXd>(&value, 1));
+  EXPECT_EQ(value, grad[2]);
+}
+
 //==============================================================================
 #ifdef HAVE_NLOPT
 TEST(Optimizer, BasicNlopt)
@@ -34,18 +34,26 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
 
+#include "dart/dynamics/CookedMesh.h"
+#include "dart/dynamics/DegreeOfFreedom.h"
+#include "dart/dynamics/MeshCache.h"
+#include "dart/dynamics/MeshShape.h"
 #include "dart/dynamics/SoftBodyNode.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/PlanarJoint.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/utils/BinaryParser.h"
 #include "dart/utils/Paths.h"
 #include "dart/simulation/World.h"
 #include "dart/simulation/World.h"
 #include "dart/utils/SkelParser.h"
+#include "dart/utils/SrdfParser.h"
 
 using namespace dart;
 using namespace math;
@@ -448,6 +456,310 @@ TEST(Parser, JointDynamicsElements)
   EXPECT_EQ(joint1->getSpringStiffness   (2), 1.0);
 }
 
+//==============================================================================
+TEST(Parser, ParallelMeshLoading)
+{
+  std::vector<std::string> fileNames;
+  fileNames.push_back(DART_DATA_PATH"obj/foot.obj");
+  fileNames.push_back(DART_DATA_PATH"obj/BoxSmall.obj");
+  fileNames.push_back(DART_DATA_PATH"obj/foot.obj");
+  fileNames.push_back(DART_DATA_PATH"obj/missing.obj");
+
+  // Every distinct file is imported once, whatever the number of threads
+  MeshCache::setNumLoadingThreads(4);
+  size_t numImports = MeshCache::getNumImports();
+  std::vector<std::shared_ptr<const aiScene> > meshes
+      = MeshCache::loadAll(fileNames);
+  ASSERT_EQ(meshes.size(), fileNames.size());
+  EXPECT_EQ(MeshCache::getNumImports(), numImports + 3);
+  EXPECT_TRUE(meshes[0] != nullptr);
+  EXPECT_TRUE(meshes[1] != nullptr);
+  EXPECT_EQ(meshes[0], meshes[2]);
+  EXPECT_TRUE(meshes[3] == nullptr);
+  EXPECT_EQ(MeshCache::load(fileNames[1]), meshes[1]);
+
+  // Parsing with several loading threads gives the same world as parsing
+  // serially
+  World* parallelWorld = SkelParser::readWorld(
+                           DART_DATA_PATH"skel/bullet_collision.skel");
+  MeshCache::setNumLoadingThreads(1);
+  World* serialWorld = SkelParser::readWorld(
+                         DART_DATA_PATH"skel/bullet_collision.skel");
+  ASSERT_TRUE(parallelWorld != NULL);
+  ASSERT_TRUE(serialWorld != NULL);
+  compareWorlds(parallelWorld, serialWorld);
+
+  // Nothing can be shared while the cache is disabled
+  MeshCache::setEnabled(false);
+  numImports = MeshCache::getNumImports();
+  meshes = MeshCache::loadAll(fileNames);
+  EXPECT_EQ(MeshCache::getNumImports(), numImports);
+  EXPECT_TRUE(meshes[0] == nullptr);
+  MeshCache::setEnabled(true);
+
+  delete parallelWorld;
+  delete serialWorld;
+}
+
+//==============================================================================
+TEST(Parser, SharedMeshes)
+{
+  World* world1 = SkelParser::readWorld(
+                    DART_DATA_PATH"skel/bullet_collision.skel");
+  EXPECT_TRUE(world1 != NULL);
+  size_t numImports = MeshCache::getNumImports();
+
+  // Every mesh of the file is imported only once
+  World* world2 = SkelParser::readWorld(
+                    DART_DATA_PATH"skel/bullet_collision.skel");
+  EXPECT_TRUE(world2 != NULL);
+  EXPECT_EQ(MeshCache::getNumImports(), numImports);
+
+  BodyNode* body1 = world1->getSkeleton("skeleton_4")->getBodyNode(0);
+  BodyNode* body2 = world2->getSkeleton("skeleton_4")->getBodyNode(0);
+  MeshShape* visual1 = dynamic_cast<MeshShape*>(
+                         body1->getVisualizationShape(0));
+  MeshShape* collision1 = dynamic_cast<MeshShape*>(
+                            body1->getCollisionShape(0));
+  MeshShape* visual2 = dynamic_cast<MeshShape*>(
+                         body2->getVisualizationShape(0));
+  ASSERT_TRUE(visual1 != NULL);
+  ASSERT_TRUE(collision1 != NULL);
+  ASSERT_TRUE(visual2 != NULL);
+  EXPECT_NE(visual1, visual2);
+  EXPECT_EQ(visual1->getMesh(), collision1->getMesh());
+  EXPECT_EQ(visual1->getMesh(), visual2->getMesh());
+  EXPECT_EQ(MeshCache::load(DART_DATA_PATH"obj/foot.obj").get(),
+            visual1->getMesh());
+
+  // The mesh is released together with the last shape that uses it
+  std::weak_ptr<const aiScene> mesh = visual1->getSharedMesh();
+  delete world1;
+  EXPECT_FALSE(mesh.expired());
+  delete world2;
+  EXPECT_TRUE(mesh.expired());
+}
+
+//==============================================================================
+TEST(Parser, CookedMeshes)
+{
+  // Any file can stand in for the source of a cooked mesh
+  std::string sourceFileName = "cooked_mesh_test.obj";
+  std::string cookedFileName = CookedMesh::getCookedFileName(sourceFileName);
+  std::ofstream(sourceFileName.c_str()) << "# Source of a cooked mesh\n";
+
+  aiScene* scene = new aiScene;
+  scene->mNumMeshes = 1;
+  scene->mMeshes = new aiMesh*[1];
+  aiMesh* mesh = new aiMesh;
+  scene->mMeshes[0] = mesh;
+  mesh->mNumVertices = 3;
+  mesh->mVertices = new aiVector3D[3];
+  mesh->mNormals = new aiVector3D[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    mesh->mVertices[i].Set(i, 2.0f * i, 0.5f);
+    mesh->mNormals[i].Set(0.0f, 0.0f, 1.0f);
+  }
+  mesh->mNumFaces = 1;
+  mesh->mFaces = new aiFace[1];
+  mesh->mFaces[0].mNumIndices = 3;
+  mesh->mFaces[0].mIndices = new unsigned int[3];
+  for (size_t i = 0; i < 3; ++i)
+    mesh->mFaces[0].mIndices[i] = 2 - i;
+
+  EXPECT_FALSE(CookedMesh::isUpToDate(cookedFileName, sourceFileName));
+  EXPECT_TRUE(CookedMesh::write(scene, sourceFileName, cookedFileName));
+  EXPECT_TRUE(CookedMesh::isUpToDate(cookedFileName, sourceFileName));
+
+  const aiScene* cooked = CookedMesh::read(cookedFileName, sourceFileName);
+  ASSERT_TRUE(cooked != NULL);
+  ASSERT_EQ(cooked->mNumMeshes, 1u);
+  ASSERT_TRUE(cooked->mRootNode != NULL);
+  EXPECT_EQ(cooked->mRootNode->mNumMeshes, 1u);
+
+  const aiMesh* cookedMesh = cooked->mMeshes[0];
+  ASSERT_EQ(cookedMesh->mNumVertices, 3u);
+  ASSERT_EQ(cookedMesh->mNumFaces, 1u);
+  ASSERT_TRUE(cookedMesh->mNormals != NULL);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    EXPECT_EQ(cookedMesh->mVertices[i].x, mesh->mVertices[i].x);
+    EXPECT_EQ(cookedMesh->mVertices[i].y, mesh->mVertices[i].y);
+    EXPECT_EQ(cookedMesh->mVertices[i].z, mesh->mVertices[i].z);
+    EXPECT_EQ(cookedMesh->mNormals[i].z, mesh->mNormals[i].z);
+    EXPECT_EQ(cookedMesh->mFaces[0].mIndices[i], mesh->mFaces[0].mIndices[i]);
+  }
+
+  // MeshShape::loadMesh prefers the cooked copy
+  const aiScene* loaded = MeshShape::loadMesh(sourceFileName);
+  ASSERT_TRUE(loaded != NULL);
+  EXPECT_EQ(loaded->mNumMeshes, 1u);
+  delete loaded;
+
+  // A file whose counts do not fit in it is rejected before allocating
+  {
+    std::fstream file(cookedFileName.c_str(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(40);
+    const uint32_t numVertices = 0x7fffffff;
+    file.write(reinterpret_cast<const char*>(&numVertices),
+               sizeof(numVertices));
+  }
+  EXPECT_TRUE(CookedMesh::isUpToDate(cookedFileName, sourceFileName));
+  EXPECT_TRUE(CookedMesh::read(cookedFileName, sourceFileName) == NULL);
+  EXPECT_TRUE(CookedMesh::write(scene, sourceFileName, cookedFileName));
+
+  // A cooked file is ignored once its source changes
+  std::ofstream(sourceFileName.c_str(), std::ios::app) << "v 0 0 0\n";
+  EXPECT_FALSE(CookedMesh::isUpToDate(cookedFileName, sourceFileName));
+  EXPECT_TRUE(CookedMesh::read(cookedFileName, sourceFileName) == NULL);
+
+  delete cooked;
+  delete scene;
+  std::remove(sourceFileName.c_str());
+  std::remove(cookedFileName.c_str());
+}
+
+//==============================================================================
+void compareWorlds(World* _world1, World* _world2)
+{
+  EXPECT_EQ(_world1->getTimeStep(), _world2->getTimeStep());
+  EXPECT_TRUE(equals(_world1->getGravity(), _world2->getGravity()));
+  ASSERT_EQ(_world1->getNumSkeletons(), _world2->getNumSkeletons());
+
+  for (size_t i = 0; i < _world1->getNumSkeletons(); ++i)
+  {
+    Skeleton* skel1 = _world1->getSkeleton(i);
+    Skeleton* skel2 = _world2->getSkeleton(i);
+    EXPECT_EQ(skel1->getName(), skel2->getName());
+    EXPECT_EQ(skel1->isMobile(), skel2->isMobile());
+    ASSERT_EQ(skel1->getNumBodyNodes(), skel2->getNumBodyNodes());
+    ASSERT_EQ(skel1->getNumDofs(), skel2->getNumDofs());
+    EXPECT_TRUE(equals(skel1->getPositions(), skel2->getPositions()));
+    EXPECT_TRUE(equals(skel1->getVelocities(), skel2->getVelocities()));
+    EXPECT_TRUE(equals(skel1->getMassMatrix(), skel2->getMassMatrix()));
+
+    for (size_t j = 0; j < skel1->getNumBodyNodes(); ++j)
+    {
+      BodyNode* body1 = skel1->getBodyNode(j);
+      BodyNode* body2 = skel2->getBodyNode(j);
+      EXPECT_EQ(body1->getName(), body2->getName());
+      EXPECT_EQ(body1->getParentJoint()->getName(),
+                body2->getParentJoint()->getName());
+      EXPECT_EQ(body1->isCollidable(), body2->isCollidable());
+      EXPECT_EQ(body1->getCollisionCategory(), body2->getCollisionCategory());
+      EXPECT_EQ(body1->getCollisionMask(), body2->getCollisionMask());
+      EXPECT_EQ(body1->getNumVisualizationShapes(),
+                body2->getNumVisualizationShapes());
+      EXPECT_EQ(body1->getNumCollisionShapes(),
+                body2->getNumCollisionShapes());
+      EXPECT_EQ(body1->getNumMarkers(), body2->getNumMarkers());
+      EXPECT_TRUE(equals(body1->getTransform().matrix(),
+                         body2->getTransform().matrix()));
+
+      Joint* joint1 = body1->getParentJoint();
+      Joint* joint2 = body2->getParentJoint();
+      for (size_t k = 0; k < joint1->getNumDofs(); ++k)
+      {
+        EXPECT_EQ(joint1->getDof(k)->getName(), joint2->getDof(k)->getName());
+        EXPECT_EQ(joint1->getPositionLowerLimit(k),
+                  joint2->getPositionLowerLimit(k));
+        EXPECT_EQ(joint1->getPositionUpperLimit(k),
+                  joint2->getPositionUpperLimit(k));
+        EXPECT_EQ(joint1->getSpringStiffness(k),
+                  joint2->getSpringStiffness(k));
+        EXPECT_EQ(joint1->getDampingCoefficient(k),
+                  joint2->getDampingCoefficient(k));
+      }
+    }
+  }
+}
+
+//==============================================================================
+TEST(Parser, BinaryWorld)
+{
+  std::vector<std::string> fileNames;
+  fileNames.push_back(DART_DATA_PATH"skel/fullbody1.skel");
+  fileNames.push_back(DART_DATA_PATH"skel/softBodies.skel");
+  fileNames.push_back(DART_DATA_PATH"skel/test/planar_joint.skel");
+
+  std::string binaryFileName = "binary_world_test.dartbin";
+  for (size_t i = 0; i < fileNames.size(); ++i)
+  {
+    World* world = SkelParser::readWorld(fileNames[i]);
+    ASSERT_TRUE(world != NULL);
+
+    for (size_t j = 0; j < world->getNumSkeletons(); ++j)
+    {
+      Skeleton* skel = world->getSkeleton(j);
+      skel->setPositions(Eigen::VectorXd::Random(skel->getNumDofs()));
+      skel->setVelocities(Eigen::VectorXd::Random(skel->getNumDofs()));
+    }
+
+    EXPECT_TRUE(BinaryParser::writeWorld(world, binaryFileName));
+    World* binaryWorld = BinaryParser::readWorld(binaryFileName);
+    ASSERT_TRUE(binaryWorld != NULL);
+    compareWorlds(world, binaryWorld);
+
+    delete binaryWorld;
+    delete world;
+  }
+
+  // A Skeleton file can not be read as a World
+  World* world = SkelParser::readWorld(fileNames[0]);
+  EXPECT_TRUE(BinaryParser::writeSkeleton(world->getSkeleton(0),
+                                          binaryFileName));
+  EXPECT_TRUE(BinaryParser::readWorld(binaryFileName) == NULL);
+  Skeleton* skel = BinaryParser::readSkeleton(binaryFileName);
+  ASSERT_TRUE(skel != NULL);
+  EXPECT_EQ(skel->getNumDofs(), world->getSkeleton(0)->getNumDofs());
+
+  delete skel;
+  delete world;
+  std::remove(binaryFileName.c_str());
+}
+
+//==============================================================================
+TEST(Parser, DisabledCollisions)
+{
+  World* world = SkelParser::readWorld(DART_DATA_PATH"skel/fullbody1.skel");
+  ASSERT_TRUE(world != NULL);
+  Skeleton* skel = world->getSkeleton("fullbody1");
+  ASSERT_TRUE(skel != NULL);
+
+  skel->disableSelfCollisionPair(skel->getBodyNode("h_pelvis"),
+                                 skel->getBodyNode("h_shin_left"));
+  skel->disableSelfCollisionPair(skel->getBodyNode("h_heel_left"),
+                                 skel->getBodyNode("h_thigh_left"));
+
+  std::string srdfFileName = "disabled_collisions_test.srdf";
+  EXPECT_TRUE(SrdfParser::writeDisabledCollisions(srdfFileName, skel));
+
+  // The pairs are matched by name on a freshly loaded Skeleton
+  World* otherWorld
+      = SkelParser::readWorld(DART_DATA_PATH"skel/fullbody1.skel");
+  Skeleton* otherSkel = otherWorld->getSkeleton("fullbody1");
+  EXPECT_EQ(SrdfParser::readDisabledCollisions(srdfFileName, otherSkel), 2u);
+  EXPECT_EQ(otherSkel->getDisabledSelfCollisionPairs().size(), 2u);
+  EXPECT_FALSE(otherSkel->isSelfCollisionPairEnabled(
+                 otherSkel->getBodyNode("h_shin_left"),
+                 otherSkel->getBodyNode("h_pelvis")));
+  EXPECT_TRUE(otherSkel->isSelfCollisionPairEnabled(
+                otherSkel->getBodyNode("h_pelvis"),
+                otherSkel->getBodyNode("h_thigh_left")));
+
+  // Pairs of links that the Skeleton does not have are skipped
+  Skeleton* ground = otherWorld->getSkeleton(0);
+  EXPECT_EQ(SrdfParser::readDisabledCollisions(srdfFileName, ground), 0u);
+  EXPECT_EQ(SrdfParser::readDisabledCollisions("missing.srdf", otherSkel),
+            0u);
+
+  delete otherWorld;
+  delete world;
+  std::remove(srdfFileName.c_str());
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
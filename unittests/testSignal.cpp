@@ -328,6 +328,38 @@ TEST(Signal, FrameSignals)
   F3.setParentFrame(&F1);
 }
 
+//==============================================================================
+TEST(Signal, BodyNodeTransformUpdated)
+{
+  Skeleton skel("skel");
+  BodyNode* parent = new BodyNode("parent");
+  BodyNode* child = new BodyNode("child");
+  parent->setParentJoint(new FreeJoint("parentJoint"));
+  child->setParentJoint(new RevoluteJoint(Vector3d::UnitZ(), "childJoint"));
+  parent->addChildBodyNode(child);
+  skel.addBodyNode(parent);
+  skel.addBodyNode(child);
+  skel.init();
+
+  int numUpdates = 0;
+  ScopedConnection connection(child->onTransformUpdated.connect(
+      [&](const Entity*) { numUpdates++; }));
+
+  // Moving the parent moves the child
+  child->getTransform();
+  skel.setPositions(Eigen::VectorXd::Constant(skel.getNumDofs(), 0.1));
+  EXPECT_EQ(numUpdates, 1);
+
+  // The child is only notified again after its transform was brought up to
+  // date
+  skel.setPositions(Eigen::VectorXd::Constant(skel.getNumDofs(), 0.2));
+  EXPECT_EQ(numUpdates, 1);
+
+  child->getTransform();
+  skel.setPositions(Eigen::VectorXd::Constant(skel.getNumDofs(), 0.3));
+  EXPECT_EQ(numUpdates, 2);
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
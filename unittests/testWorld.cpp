@@ -42,6 +42,7 @@
 #include "dart/dynamics/BodyNode.h"
 #include "dart/dynamics/RevoluteJoint.h"
 #include "dart/dynamics/Skeleton.h"
+#include "dart/simulation/ParticleSystem.h"
 #include "dart/simulation/World.h"
 
 using namespace dart;
@@ -154,6 +155,399 @@ TEST(WORLD, ADDING_AND_REMOVING_SKELETONS)
     delete world;
 }
 
+/******************************************************************************/
+TEST(WORLD, QUEUED_SKELETON_CHANGES)
+{
+    World* world = new World;
+
+    std::vector<Skeleton*> skels;
+    for (int i = 0; i < 4; ++i)
+    {
+        skels.push_back(createThreeLinkRobot(Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_X,
+                                             Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_Y,
+                                             Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_Z,
+                                             false, false));
+    }
+    world->addSkeleton(skels[0]);
+    world->addSkeleton(skels[1]);
+    world->addSkeleton(skels[2]);
+    world->step();
+
+    // Queued changes are not visible until the next step
+    world->queueAddSkeleton(skels[3]);
+    world->queueRemoveSkeleton(skels[0]);
+    EXPECT_EQ(world->getNumSkeletons(), 3u);
+    EXPECT_TRUE(world->hasSkeleton(skels[0]));
+    EXPECT_FALSE(world->hasSkeleton(skels[3]));
+
+    world->step();
+    EXPECT_EQ(world->getNumSkeletons(), 3u);
+    EXPECT_FALSE(world->hasSkeleton(skels[0]));
+    EXPECT_TRUE(world->hasSkeleton(skels[3]));
+
+    // The last skeleton took the place of the removed one
+    EXPECT_EQ(world->getSkeleton(0), skels[3]);
+    EXPECT_EQ(world->getSkeleton(skels[3]->getName()), skels[3]);
+
+    // The dof indices and the recording follow the new skeletons
+    for (size_t i = 0; i <= world->getNumSkeletons(); ++i)
+        EXPECT_EQ(world->getIndex(i), static_cast<int>(3*i));
+    world->bake();
+    EXPECT_EQ(world->getRecording()->getNumSkeletons(), 3);
+    EXPECT_EQ(world->getRecording()->getState(0).size(), 9);
+
+    // Removal keeps the other skeletons reachable
+    world->removeSkeleton(skels[3]);
+    EXPECT_EQ(world->getNumSkeletons(), 2u);
+    EXPECT_TRUE(world->hasSkeleton(skels[1]));
+    EXPECT_TRUE(world->hasSkeleton(skels[2]));
+    for (int i = 0; i < 20; ++i)
+        world->step();
+
+    // A skeleton queued twice is added, and deleted with the world, only once
+    for (int i = 0; i < 2; ++i)
+    {
+        skels.push_back(createThreeLinkRobot(Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_X,
+                                             Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_Y,
+                                             Eigen::Vector3d(1.0, 1.0, 1.0),
+                                             DOF_Z,
+                                             false, false));
+    }
+    world->queueAddSkeleton(skels[4]);
+    world->queueAddSkeleton(skels[4]);
+    world->step();
+    EXPECT_EQ(world->getNumSkeletons(), 3u);
+    world->queueAddSkeleton(skels[5]);
+    world->queueAddSkeleton(skels[5]);
+
+    delete world;
+}
+
+/******************************************************************************/
+TEST(WORLD, CLONING)
+{
+    World* world = new World;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Skeleton* skel = createThreeLinkRobot(Eigen::Vector3d(1.0, 1.0, 1.0),
+                                              DOF_X,
+                                              Eigen::Vector3d(1.0, 1.0, 1.0),
+                                              DOF_Y,
+                                              Eigen::Vector3d(1.0, 1.0, 1.0),
+                                              DOF_Z,
+                                              false, false);
+        world->addSkeleton(skel);
+        skel->setPositions(Eigen::VectorXd::Random(skel->getNumDofs()));
+    }
+
+    int nSteps = 20;
+    for (int i = 0; i < nSteps; ++i)
+        world->step();
+
+    World* clone = world->clone();
+    EXPECT_EQ(clone->getNumSkeletons(), world->getNumSkeletons());
+    EXPECT_EQ(clone->getTime(), world->getTime());
+    EXPECT_EQ(clone->getSimFrames(), world->getSimFrames());
+
+    // Both worlds follow the same trajectory
+    for (int i = 0; i < nSteps; ++i)
+    {
+        world->step();
+        clone->step();
+    }
+
+    for (size_t i = 0; i < world->getNumSkeletons(); ++i)
+    {
+        Skeleton* skel = world->getSkeleton(i);
+        Skeleton* clonedSkel = clone->getSkeleton(i);
+        EXPECT_NE(skel, clonedSkel);
+        EXPECT_EQ(clonedSkel->getName(), skel->getName());
+        EXPECT_TRUE(equals(clonedSkel->getPositions(), skel->getPositions()));
+        EXPECT_TRUE(equals(clonedSkel->getVelocities(),
+                           skel->getVelocities()));
+    }
+
+    delete world;
+    delete clone;
+}
+
+/******************************************************************************/
+TEST(WORLD, PARTICLE_CONTACTS)
+{
+    ParticleSystem particles;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        particles.addParticle(Eigen::Vector3d::Random(),
+                              0.05 + 0.05 * math::random(0.0, 1.0),
+                              1.0);
+    }
+
+    // The hash grid finds the same pairs as testing all pairs
+    size_t numContacts = 0;
+    for (size_t i = 0; i < particles.getNumParticles(); ++i)
+    {
+        for (size_t j = i + 1; j < particles.getNumParticles(); ++j)
+        {
+            double radii = particles.getRadius(i) + particles.getRadius(j);
+            double distance = (particles.getPosition(i)
+                               - particles.getPosition(j)).norm();
+            if (distance < 1.1 * radii)
+                ++numContacts;
+        }
+    }
+
+    EXPECT_EQ(particles.detectContacts(std::vector<Skeleton*>()),
+              numContacts);
+    EXPECT_EQ(particles.getNumBodyContacts(), 0u);
+}
+
+/******************************************************************************/
+TEST(WORLD, PARTICLES_ON_GROUND)
+{
+    World* world = new World;
+    world->addSkeleton(createGround(Eigen::Vector3d(10.0, 10.0, 1.0)));
+
+    // Stack of particles above the top of the ground at z = 0.5
+    double radius = 0.05;
+    ParticleSystem* particles = new ParticleSystem;
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int j = 0; j < 5; ++j)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                particles->addParticle(
+                      Eigen::Vector3d(0.11 * i, 0.11 * j, 0.6 + 0.11 * k),
+                      radius, 0.01);
+            }
+        }
+    }
+    world->addParticleSystem(particles);
+    EXPECT_EQ(world->getNumParticleSystems(), 1u);
+
+    for (int i = 0; i < 1000; ++i)
+        world->step();
+
+    for (size_t i = 0; i < particles->getNumParticles(); ++i)
+    {
+        EXPECT_GT(particles->getPosition(i)[2], 0.5 + 0.8 * radius);
+        EXPECT_LT(particles->getVelocity(i).norm(), 0.1);
+    }
+
+    // The clone follows the same trajectory
+    World* clone = world->clone();
+    ASSERT_EQ(clone->getNumParticleSystems(), 1u);
+    for (int i = 0; i < 20; ++i)
+    {
+        world->step();
+        clone->step();
+    }
+
+    ParticleSystem* clonedParticles = clone->getParticleSystem(0);
+    EXPECT_NE(clonedParticles, particles);
+    for (size_t i = 0; i < particles->getNumParticles(); ++i)
+    {
+        EXPECT_TRUE(equals(clonedParticles->getPosition(i),
+                           particles->getPosition(i)));
+    }
+
+    delete world;
+    delete clone;
+}
+
+/******************************************************************************/
+TEST(WORLD, BOX_ON_PARTICLES)
+{
+    World* world = new World;
+    world->addSkeleton(createGround(Eigen::Vector3d(10.0, 10.0, 1.0)));
+
+    // One layer of particles on the ground, and a box falling on them
+    double radius = 0.05;
+    ParticleSystem* particles = new ParticleSystem;
+    for (int i = -4; i <= 4; ++i)
+    {
+        for (int j = -4; j <= 4; ++j)
+        {
+            particles->addParticle(
+                  Eigen::Vector3d(0.1 * i, 0.1 * j, 0.5 + radius),
+                  radius, 0.01);
+        }
+    }
+    world->addParticleSystem(particles);
+
+    Skeleton* box = createBox(Eigen::Vector3d(0.4, 0.4, 0.2),
+                              Eigen::Vector3d(0.0, 0.0, 0.8));
+    world->addSkeleton(box);
+
+    for (int i = 0; i < 1000; ++i)
+        world->step();
+
+    // The box rests on the particles, which it pushes against the ground
+    double z = box->getBodyNode(0)->getTransform().translation()[2];
+    EXPECT_GT(z, 0.5 + 2.0 * radius + 0.1 - 0.2 * radius);
+    EXPECT_LT(z, 0.5 + 2.0 * radius + 0.1 + 0.2 * radius);
+    EXPECT_LT(box->getVelocities().norm(), 0.1);
+    EXPECT_GT(particles->getNumBodyContacts(), 0u);
+
+    for (size_t i = 0; i < particles->getNumParticles(); ++i)
+        EXPECT_GT(particles->getPosition(i)[2], 0.5 + 0.8 * radius);
+
+    delete world;
+}
+
+/******************************************************************************/
+TEST(WORLD, SUB_STEPPING)
+{
+    double timeStep = 0.001;
+    size_t numSubSteps = 10;
+
+    World* world = new World;
+    world->setTimeStep(timeStep);
+    World* fineWorld = new World;
+    fineWorld->setTimeStep(timeStep / numSubSteps);
+    World* coarseWorld = new World;
+    coarseWorld->setTimeStep(timeStep);
+
+    // Two robots without collision shapes, one of them sub-stepped. Each
+    // follows the same trajectory as in a world stepped at its own rate.
+    Skeleton* skels[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        skels[i] = createThreeLinkRobot(Eigen::Vector3d(0.1, 0.1, 1.0), DOF_X,
+                                        Eigen::Vector3d(0.1, 0.1, 1.0), DOF_Y,
+                                        Eigen::Vector3d(0.1, 0.1, 1.0), DOF_Z,
+                                        false, false);
+    }
+
+    Skeleton* fastSkel = skels[0];
+    Skeleton* slowSkel = skels[1];
+    fastSkel->setNumSubSteps(numSubSteps);
+    world->addSkeleton(fastSkel);
+    world->addSkeleton(slowSkel);
+    fineWorld->addSkeleton(skels[2]);
+    coarseWorld->addSkeleton(skels[3]);
+
+    Eigen::VectorXd fastPositions = Eigen::VectorXd::Random(3);
+    Eigen::VectorXd slowPositions = Eigen::VectorXd::Random(3);
+    skels[0]->setPositions(fastPositions);
+    skels[1]->setPositions(slowPositions);
+    skels[2]->setPositions(fastPositions);
+    skels[3]->setPositions(slowPositions);
+
+    EXPECT_EQ(fastSkel->getNumSubSteps(), numSubSteps);
+    EXPECT_EQ(slowSkel->getNumSubSteps(), 1u);
+    EXPECT_DOUBLE_EQ(fastSkel->getTimeStep(), timeStep / numSubSteps);
+    EXPECT_DOUBLE_EQ(slowSkel->getTimeStep(), timeStep);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        world->step();
+        for (size_t j = 0; j < numSubSteps; ++j)
+            fineWorld->step();
+        coarseWorld->step();
+    }
+
+    // Holding the skeletons during the sub-steps leaves their mobility alone
+    EXPECT_TRUE(slowSkel->isMobile());
+    EXPECT_FALSE(slowSkel->isHeld());
+    EXPECT_FALSE(fastSkel->isHeld());
+
+    EXPECT_DOUBLE_EQ(world->getTime(), coarseWorld->getTime());
+    EXPECT_TRUE(equals(fastSkel->getPositions(),
+                       fineWorld->getSkeleton(0)->getPositions()));
+    EXPECT_TRUE(equals(fastSkel->getVelocities(),
+                       fineWorld->getSkeleton(0)->getVelocities()));
+    EXPECT_TRUE(equals(slowSkel->getPositions(),
+                       coarseWorld->getSkeleton(0)->getPositions()));
+    EXPECT_TRUE(equals(slowSkel->getVelocities(),
+                       coarseWorld->getSkeleton(0)->getVelocities()));
+
+    // The clone keeps the number of sub-steps
+    World* clone = world->clone();
+    EXPECT_EQ(clone->getSkeleton(0)->getNumSubSteps(), numSubSteps);
+
+    delete world;
+    delete fineWorld;
+    delete coarseWorld;
+    delete clone;
+}
+
+/******************************************************************************/
+TEST(WORLD, SUB_STEPPED_BOX_ON_GROUND)
+{
+    World* world = new World;
+    world->addSkeleton(createGround(Eigen::Vector3d(10.0, 10.0, 1.0)));
+
+    // Sub-stepped boxes falling on the ground and on a box that is not
+    // sub-stepped
+    Skeleton* slowBox = createBox(Eigen::Vector3d(0.4, 0.4, 0.2),
+                                  Eigen::Vector3d(0.0, 0.0, 0.7));
+    world->addSkeleton(slowBox);
+
+    Skeleton* fastBox = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                                  Eigen::Vector3d(0.0, 0.0, 1.0));
+    fastBox->setNumSubSteps(4);
+    world->addSkeleton(fastBox);
+
+    Skeleton* groundBox = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                                    Eigen::Vector3d(1.0, 0.0, 1.0));
+    groundBox->setNumSubSteps(3);
+    world->addSkeleton(groundBox);
+
+    for (int i = 0; i < 2000; ++i)
+        world->step();
+
+    double z0 = slowBox->getBodyNode(0)->getTransform().translation()[2];
+    double z1 = fastBox->getBodyNode(0)->getTransform().translation()[2];
+    double z2 = groundBox->getBodyNode(0)->getTransform().translation()[2];
+    EXPECT_NEAR(z0, 0.6, 0.01);
+    EXPECT_NEAR(z1, 0.8, 0.01);
+    EXPECT_NEAR(z2, 0.6, 0.01);
+    EXPECT_LT(slowBox->getVelocities().norm(), 0.01);
+    EXPECT_LT(fastBox->getVelocities().norm(), 0.01);
+    EXPECT_LT(groundBox->getVelocities().norm(), 0.01);
+
+    delete world;
+}
+
+/******************************************************************************/
+TEST(WORLD, SUB_STEPPED_PUSH)
+{
+    World* world = new World;
+    world->setGravity(Eigen::Vector3d::Zero());
+
+    // A sub-stepped box hits a box of the same mass that is not sub-stepped
+    Skeleton* fastBox = createBox(Eigen::Vector3d(0.2, 0.2, 0.2));
+    fastBox->setNumSubSteps(10);
+    Eigen::Vector6d velocity = Eigen::Vector6d::Zero();
+    velocity[3] = 1.0;
+    fastBox->setVelocities(velocity);
+    world->addSkeleton(fastBox);
+
+    Skeleton* slowBox = createBox(Eigen::Vector3d(0.2, 0.2, 0.2),
+                                  Eigen::Vector3d(0.25, 0.0, 0.0));
+    world->addSkeleton(slowBox);
+
+    for (int i = 0; i < 200; ++i)
+        world->step();
+
+    // The inelastic impact shares the momentum
+    double v0 = fastBox->getBodyNode(0)->getLinearVelocity()[0];
+    double v1 = slowBox->getBodyNode(0)->getLinearVelocity()[0];
+    EXPECT_NEAR(v0 + v1, 1.0, 0.05);
+    EXPECT_NEAR(v1, 0.5, 0.05);
+    EXPECT_LT(std::abs(v0 - v1), 0.05);
+
+    delete world;
+}
+
 /******************************************************************************/
 int main(int argc, char* argv[])
 {